@@ -0,0 +1,363 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * audio_sync.c
+ * ------------
+ * Offset estimation between the audio activity envelope and a track's
+ * cue timeline (see audio_sync.h).
+ *
+ * Activity is the envelope level in dB above its 10 s moving average,
+ * clamped at zero: speech raises the level over the surrounding room
+ * tone and music, while slow level changes cancel out. Activity and cue
+ * timeline are normalised to zero mean and unit variance, so the
+ * correlation divided by the bin count is close to Pearson's r for
+ * small offsets. The audio spectrum is computed once and reused for
+ * every track: each track costs one forward and one inverse FFT.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "audio_sync.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEBUG_MODULE "audio_sync"
+#include "debug.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Moving-average window of the activity baseline. */
+#define BASELINE_MS 10000
+/* Peaks closer than this to the best one are not sidelobes. */
+#define SIDELOBE_GUARD_MS 1000
+/* Fewer analysed bins than this cannot give a useful estimate. */
+#define MIN_BINS 500
+
+struct AudioSync {
+    int hop_ms;
+    int n;              /* envelope bins */
+    int m;              /* FFT size, power of two >= 2n */
+    double *re, *im;    /* spectrum of the normalised activity */
+};
+
+double audio_sync_sumsq_f32(const float *x, size_t n)
+{
+    float s[8] = {0};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        for (int k = 0; k < 8; k++)
+            s[k] += x[i + k] * x[i + k];
+    double t = 0;
+    for (; i < n; i++)
+        t += (double)x[i] * x[i];
+    for (int k = 0; k < 8; k++)
+        t += s[k];
+    return t;
+}
+
+double audio_sync_sumsq_s16(const int16_t *x, size_t n)
+{
+    const float scale = 1.0f / 32768.0f;
+    float s[8] = {0};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        for (int k = 0; k < 8; k++) {
+            float v = (float)x[i + k] * scale;
+            s[k] += v * v;
+        }
+    double t = 0;
+    for (; i < n; i++) {
+        double v = x[i] * (double)scale;
+        t += v * v;
+    }
+    for (int k = 0; k < 8; k++)
+        t += s[k];
+    return t;
+}
+
+double audio_sync_sumsq_s32(const int32_t *x, size_t n)
+{
+    const float scale = 1.0f / 2147483648.0f;
+    float s[8] = {0};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        for (int k = 0; k < 8; k++) {
+            float v = (float)x[i + k] * scale;
+            s[k] += v * v;
+        }
+    double t = 0;
+    for (; i < n; i++) {
+        double v = x[i] * (double)scale;
+        t += v * v;
+    }
+    for (int k = 0; k < 8; k++)
+        t += s[k];
+    return t;
+}
+
+void audio_sync_envelope_free(AudioEnvelope *env)
+{
+    if (!env)
+        return;
+    free(env->power);
+    env->power = NULL;
+    env->n = 0;
+}
+
+const char *audio_sync_confidence_label(double confidence)
+{
+    return confidence >= 0.5 ? "high" : confidence >= 0.2 ? "medium" : "low";
+}
+
+/* In-place iterative radix-2 FFT; `inverse` conjugates the twiddles
+ * (the caller scales). */
+static void fft(double *re, double *im, int m, int inverse)
+{
+    for (int i = 1, j = 0; i < m; i++) {
+        int bit = m >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (int len = 2; len <= m; len <<= 1) {
+        double ang = (inverse ? 2.0 : -2.0) * M_PI / len;
+        double wr = cos(ang), wi = sin(ang);
+        for (int i = 0; i < m; i += len) {
+            double cr = 1.0, ci = 0.0;
+            for (int k = 0; k < len / 2; k++) {
+                int a = i + k, b = i + k + len / 2;
+                double xr = re[b] * cr - im[b] * ci;
+                double xi = re[b] * ci + im[b] * cr;
+                re[b] = re[a] - xr; im[b] = im[a] - xi;
+                re[a] += xr;        im[a] += xi;
+                double t = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = t;
+            }
+        }
+    }
+}
+
+/* Zero mean, unit variance over the first n values; 0 if constant. */
+static int normalise(double *v, int n)
+{
+    double sum = 0, sq = 0;
+    for (int i = 0; i < n; i++)
+        sum += v[i];
+    double mean = sum / n;
+    for (int i = 0; i < n; i++) {
+        v[i] -= mean;
+        sq += v[i] * v[i];
+    }
+    double sd = sqrt(sq / n);
+    if (sd < 1e-9)
+        return 0;
+    for (int i = 0; i < n; i++)
+        v[i] /= sd;
+    return 1;
+}
+
+AudioSync *audio_sync_create(const AudioEnvelope *env)
+{
+    if (!env || !env->power || env->n < MIN_BINS || env->hop_ms <= 0)
+        return NULL;
+    int n = env->n;
+    int m = 1;
+    while (m < 2 * n)
+        m <<= 1;
+
+    AudioSync *s = calloc(1, sizeof(*s));
+    double *db = malloc((size_t)n * sizeof(*db));
+    double *prefix = malloc(((size_t)n + 1) * sizeof(*prefix));
+    if (s) {
+        s->re = calloc((size_t)m, sizeof(double));
+        s->im = calloc((size_t)m, sizeof(double));
+    }
+    if (!s || !db || !prefix || !s->re || !s->im) {
+        free(db);
+        free(prefix);
+        audio_sync_destroy(s);
+        return NULL;
+    }
+    s->hop_ms = env->hop_ms;
+    s->n = n;
+    s->m = m;
+
+    /* Level in dB, then the level above its moving average. */
+    prefix[0] = 0;
+    for (int i = 0; i < n; i++) {
+        db[i] = 10.0 * log10((double)env->power[i] + 1e-10);
+        prefix[i + 1] = prefix[i] + db[i];
+    }
+    int half = BASELINE_MS / env->hop_ms / 2;
+    for (int i = 0; i < n; i++) {
+        int lo = i - half < 0 ? 0 : i - half;
+        int hi = i + half + 1 > n ? n : i + half + 1;
+        double base = (prefix[hi] - prefix[lo]) / (hi - lo);
+        double a = db[i] - base;
+        s->re[i] = a > 0 ? a : 0;
+    }
+    free(db);
+    free(prefix);
+
+    if (!normalise(s->re, n)) {
+        LOG(1, "Audio envelope is flat; cannot estimate subtitle offsets\n");
+        audio_sync_destroy(s);
+        return NULL;
+    }
+    fft(s->re, s->im, m, 0);
+    return s;
+}
+
+int audio_sync_track(AudioSync *s, const SRTEntry *entries, int count,
+                     int delay_ms, int max_lag_ms, AudioSyncResult *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!s || !entries || count <= 0)
+        return -1;
+    int n = s->n, m = s->m, hop = s->hop_ms;
+
+    double *re = calloc((size_t)m, sizeof(double));
+    double *im = calloc((size_t)m, sizeof(double));
+    if (!re || !im) {
+        free(re);
+        free(im);
+        return -1;
+    }
+
+    /* Cue on/off timeline via a difference array over the bins. */
+    for (int i = 0; i < count; i++) {
+        int64_t b0 = (entries[i].start_ms + delay_ms) / hop;
+        int64_t b1 = (entries[i].end_ms + delay_ms) / hop;
+        if (b1 <= 0 || b0 >= n || b1 <= b0)
+            continue;
+        re[b0 < 0 ? 0 : b0] += 1.0;
+        if (b1 < n)
+            re[b1] -= 1.0;
+        out->cues_used++;
+    }
+    double run = 0;
+    for (int i = 0; i < n; i++) {
+        run += re[i];
+        re[i] = run > 0.5 ? 1.0 : 0.0;
+    }
+    if (!out->cues_used || !normalise(re, n)) {
+        free(re);
+        free(im);
+        return -1;
+    }
+
+    /* r[l] = sum_t A[t] C[t - l] = IFFT(FA * conj(FC))[l] */
+    fft(re, im, m, 0);
+    for (int k = 0; k < m; k++) {
+        double ar = s->re[k], ai = s->im[k];
+        double cr = re[k], ci = -im[k];
+        re[k] = ar * cr - ai * ci;
+        im[k] = ar * ci + ai * cr;
+    }
+    fft(re, im, m, 1);
+    double scale = 1.0 / ((double)m * n);
+
+    int max_lag = max_lag_ms / hop;
+    if (max_lag > n / 2)
+        max_lag = n / 2;
+    int best = 0;
+    double best_v = -INFINITY;
+    for (int l = -max_lag; l <= max_lag; l++) {
+        double v = re[l >= 0 ? l : m + l] * scale;
+        if (v > best_v) {
+            best_v = v;
+            best = l;
+        }
+    }
+    double side = -INFINITY;
+    int guard = SIDELOBE_GUARD_MS / hop;
+    for (int l = -max_lag; l <= max_lag; l++) {
+        if (abs(l - best) <= guard)
+            continue;
+        double v = re[l >= 0 ? l : m + l] * scale;
+        if (v > side)
+            side = v;
+    }
+
+    /* Parabolic interpolation between neighbouring bins. */
+    double frac = 0;
+    if (best > -max_lag && best < max_lag) {
+        double y0 = re[best - 1 >= 0 ? best - 1 : m + best - 1] * scale;
+        double y2 = re[best + 1 >= 0 ? best + 1 : m + best + 1] * scale;
+        double den = y0 - 2 * best_v + y2;
+        if (den < 0)
+            frac = 0.5 * (y0 - y2) / den;
+    }
+    free(re);
+    free(im);
+
+    out->offset_ms = (int)lround((best + frac) * hop);
+    out->peak = best_v;
+    out->sidelobe = side == -INFINITY ? 0 : side;
+    out->confidence = best_v > 0 ? (best_v - out->sidelobe) / best_v : 0;
+    if (out->confidence < 0) out->confidence = 0;
+    if (out->confidence > 1) out->confidence = 1;
+    return 0;
+}
+
+void audio_sync_destroy(AudioSync *s)
+{
+    if (!s)
+        return;
+    free(s->re);
+    free(s->im);
+    free(s);
+}
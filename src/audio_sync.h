@@ -0,0 +1,136 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+#pragma once
+#ifndef AUDIO_SYNC_H
+#define AUDIO_SYNC_H
+
+#include "srt_parser.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file audio_sync.h
+ * @brief Estimate a subtitle track's delay from the programme audio.
+ *
+ * The audio of the first few minutes is decoded and reduced to a power
+ * envelope (mean square per AUDIO_SYNC_HOP_MS bin). Its level above a
+ * slow-moving baseline approximates speech activity, which is
+ * cross-correlated (FFT, zero-padded) with each track's cue on/off
+ * timeline. The correlation peak gives the offset to add to the track's
+ * delay; the gap between the peak and the strongest correlation more
+ * than a second away from it gives the confidence.
+ *
+ * audio_sync_read_envelope() needs FFmpeg (audio_sync_read.c); the
+ * analysis in audio_sync.c does not.
+ */
+
+/** Envelope resolution in milliseconds. */
+#define AUDIO_SYNC_HOP_MS 20
+/** Default amount of audio analysed, in seconds. */
+#define AUDIO_SYNC_DEFAULT_SECONDS 600
+/** Default search range for the offset, in milliseconds. */
+#define AUDIO_SYNC_MAX_LAG_MS 30000
+
+/** Audio power per bin; bin 0 starts at the input's start time. */
+typedef struct {
+    int hop_ms;
+    int n;
+    float *power;           /**< mean square sample value, 0 where no audio */
+} AudioEnvelope;
+
+typedef struct {
+    int offset_ms;          /**< add to the track's delay */
+    double peak;            /**< normalised correlation at the peak */
+    double sidelobe;        /**< best correlation > 1 s away from the peak */
+    double confidence;      /**< 0..1: (peak - sidelobe) / peak */
+    int cues_used;          /**< cues inside the analysed span */
+} AudioSyncResult;
+
+typedef struct AudioSync AudioSync;
+
+/**
+ * Decode up to `seconds` of the best audio stream of `input` into an
+ * envelope with `hop_ms` bins. Returns 0, or -1 (logged) if the input or
+ * its audio cannot be opened or decoded.
+ */
+int audio_sync_read_envelope(const char *input, int seconds, int hop_ms,
+                             AudioEnvelope *env);
+
+/** Free an envelope's samples. */
+void audio_sync_envelope_free(AudioEnvelope *env);
+
+/**
+ * Add the energy of interleaved or single-plane samples to a bin:
+ * returns the sum of squares of `n` values. Kept separate so the decoder
+ * loop stays format-agnostic; the loops are written to vectorise.
+ */
+double audio_sync_sumsq_f32(const float *x, size_t n);
+double audio_sync_sumsq_s16(const int16_t *x, size_t n);
+double audio_sync_sumsq_s32(const int32_t *x, size_t n);
+
+/**
+ * Prepare an envelope for correlation (activity, normalisation, FFT).
+ * The envelope may be freed afterwards. NULL if it is too short or
+ * memory runs out.
+ */
+AudioSync *audio_sync_create(const AudioEnvelope *env);
+
+/**
+ * Correlate one track (cue times plus `delay_ms`) against the audio and
+ * search offsets within ±max_lag_ms. Returns 0, or -1 if the track has
+ * no cues in the analysed span or memory runs out.
+ */
+int audio_sync_track(AudioSync *s, const SRTEntry *entries, int count,
+                     int delay_ms, int max_lag_ms, AudioSyncResult *out);
+
+void audio_sync_destroy(AudioSync *s);
+
+/** "high", "medium" or "low" for a confidence value. */
+const char *audio_sync_confidence_label(double confidence);
+
+#endif /* AUDIO_SYNC_H */
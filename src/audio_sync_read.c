@@ -0,0 +1,299 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * audio_sync_read.c
+ * -----------------
+ * FFmpeg side of audio_sync.h: decode the best audio stream of an input
+ * for the first N seconds and accumulate the mean square sample value
+ * per envelope bin. Other streams are discarded at the demuxer, and
+ * reading stops once the requested span is covered, so only the start
+ * of the file is read.
+ *
+ * Samples are placed by frame timestamp relative to the input's start
+ * time, the origin the muxer uses for cue PTS, so an offset found here
+ * is directly a --delay correction.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "audio_sync.h"
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEBUG_MODULE "audio_sync"
+#include "debug.h"
+
+typedef struct {
+    int hop_ms;
+    int n;
+    double *energy;
+    int64_t *samples;
+    int64_t next_ms;    /* expected start of the next frame */
+    int done;
+} Accum;
+
+static int frame_channels(const AVFrame *f)
+{
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+    return f->ch_layout.nb_channels;
+#else
+    return f->channels;
+#endif
+}
+
+/* Sum of squares of samples [from, to) over all channels. Returns -1 for
+ * sample formats not handled here. */
+static double frame_sumsq(const AVFrame *f, int channels, int from, int to)
+{
+    enum AVSampleFormat fmt = (enum AVSampleFormat)f->format;
+    int planar = av_sample_fmt_is_planar(fmt);
+    int planes = planar ? channels : 1;
+    size_t off = planar ? (size_t)from : (size_t)from * channels;
+    size_t cnt = planar ? (size_t)(to - from) : (size_t)(to - from) * channels;
+    double sum = 0;
+    for (int p = 0; p < planes; p++) {
+        const uint8_t *d = f->extended_data[p];
+        switch (av_get_packed_sample_fmt(fmt)) {
+        case AV_SAMPLE_FMT_FLT:
+            sum += audio_sync_sumsq_f32((const float *)d + off, cnt);
+            break;
+        case AV_SAMPLE_FMT_S16:
+            sum += audio_sync_sumsq_s16((const int16_t *)d + off, cnt);
+            break;
+        case AV_SAMPLE_FMT_S32:
+            sum += audio_sync_sumsq_s32((const int32_t *)d + off, cnt);
+            break;
+        case AV_SAMPLE_FMT_DBL:
+            for (size_t i = 0; i < cnt; i++) {
+                double v = ((const double *)d)[off + i];
+                sum += v * v;
+            }
+            break;
+        case AV_SAMPLE_FMT_U8:
+            for (size_t i = 0; i < cnt; i++) {
+                double v = (d[off + i] - 128) / 128.0;
+                sum += v * v;
+            }
+            break;
+        default:
+            return -1;
+        }
+    }
+    return sum / channels;
+}
+
+static int accumulate(Accum *a, const AVFrame *f, int64_t frame_ms)
+{
+    int channels = frame_channels(f);
+    if (channels <= 0 || f->sample_rate <= 0 || f->nb_samples <= 0)
+        return 0;
+    if (frame_ms == AV_NOPTS_VALUE)
+        frame_ms = a->next_ms;
+    a->next_ms = frame_ms + (int64_t)f->nb_samples * 1000 / f->sample_rate;
+
+    /* Walk the frame bin by bin: each run of samples inside one bin is
+     * summed with the vectorised helpers. */
+    int k = 0;
+    while (k < f->nb_samples) {
+        int64_t t_ms = frame_ms + (int64_t)k * 1000 / f->sample_rate;
+        int64_t bin = t_ms >= 0 ? t_ms / a->hop_ms : -1;
+        if (bin >= a->n) {
+            a->done = 1;
+            break;
+        }
+        int64_t bin_end_ms = (bin + 1) * a->hop_ms;
+        int64_t end = (bin_end_ms - frame_ms) * f->sample_rate / 1000;
+        if (end * 1000 < (bin_end_ms - frame_ms) * f->sample_rate)
+            end++;
+        if (end <= k)
+            end = k + 1;
+        if (end > f->nb_samples)
+            end = f->nb_samples;
+        if (bin >= 0) {
+            double e = frame_sumsq(f, channels, k, (int)end);
+            if (e < 0)
+                return -1;
+            a->energy[bin] += e;
+            a->samples[bin] += end - k;
+        }
+        k = (int)end;
+    }
+    return 0;
+}
+
+static int drain(AVCodecContext *dec, AVFrame *frame, AVRational tb, int64_t origin_ms, Accum *a)
+{
+    int ret;
+    while ((ret = avcodec_receive_frame(dec, frame)) == 0) {
+        int64_t ts = frame->best_effort_timestamp;
+        int64_t ms = ts == AV_NOPTS_VALUE ? AV_NOPTS_VALUE
+                     : av_rescale_q(ts, tb, (AVRational){1, 1000}) - origin_ms;
+        int rc = accumulate(a, frame, ms);
+        av_frame_unref(frame);
+        if (rc < 0) {
+            LOG(0, "Unsupported audio sample format for delay analysis\n");
+            return -1;
+        }
+        if (a->done)
+            return 0;
+    }
+    return (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) ? 0 : ret;
+}
+
+typedef struct {
+    AVFormatContext *fmt;
+    AVCodecContext *dec;
+    AVPacket *pkt;
+    AVFrame *frame;
+    Accum acc;
+} Reader;
+
+/* Open the input and the decoder of its best audio stream; returns the
+ * stream index or -1. */
+static int open_audio(Reader *r, const char *input)
+{
+    if (avformat_open_input(&r->fmt, input, NULL, NULL) < 0) {
+        LOG(0, "Cannot open input file '%s' for audio analysis\n", input);
+        return -1;
+    }
+    if (avformat_find_stream_info(r->fmt, NULL) < 0) {
+        LOG(0, "Cannot read stream info of '%s'\n", input);
+        return -1;
+    }
+    int si = av_find_best_stream(r->fmt, AVMEDIA_TYPE_AUDIO, -1, -1, NULL, 0);
+    if (si < 0) {
+        LOG(0, "No audio stream in '%s'\n", input);
+        return -1;
+    }
+    const AVCodec *codec = avcodec_find_decoder(r->fmt->streams[si]->codecpar->codec_id);
+    if (!codec) {
+        LOG(0, "No decoder for the audio stream of '%s'\n", input);
+        return -1;
+    }
+    r->dec = avcodec_alloc_context3(codec);
+    if (!r->dec || avcodec_parameters_to_context(r->dec, r->fmt->streams[si]->codecpar) < 0 ||
+        avcodec_open2(r->dec, codec, NULL) < 0) {
+        LOG(0, "Cannot open the audio decoder for '%s'\n", input);
+        return -1;
+    }
+    for (unsigned i = 0; i < r->fmt->nb_streams; i++)
+        if ((int)i != si)
+            r->fmt->streams[i]->discard = AVDISCARD_ALL;
+    return si;
+}
+
+static int read_audio(Reader *r, const char *input, AudioEnvelope *env)
+{
+    Accum *a = &r->acc;
+    int si = open_audio(r, input);
+    if (si < 0)
+        return -1;
+
+    a->energy = calloc((size_t)a->n, sizeof(*a->energy));
+    a->samples = calloc((size_t)a->n, sizeof(*a->samples));
+    r->pkt = av_packet_alloc();
+    r->frame = av_frame_alloc();
+    if (!a->energy || !a->samples || !r->pkt || !r->frame) {
+        LOG(0, "Out of memory for audio analysis\n");
+        return -1;
+    }
+
+    AVRational tb = r->fmt->streams[si]->time_base;
+    int64_t origin_ms = r->fmt->start_time != AV_NOPTS_VALUE
+                        ? av_rescale_q(r->fmt->start_time, AV_TIME_BASE_Q, (AVRational){1, 1000})
+                        : 0;
+    int err = 0;
+    while (!a->done && !err && av_read_frame(r->fmt, r->pkt) >= 0) {
+        if (r->pkt->stream_index == si && avcodec_send_packet(r->dec, r->pkt) >= 0)
+            err = drain(r->dec, r->frame, tb, origin_ms, a);
+        av_packet_unref(r->pkt);
+    }
+    if (!a->done && !err && avcodec_send_packet(r->dec, NULL) >= 0)
+        err = drain(r->dec, r->frame, tb, origin_ms, a);
+    if (err < 0)
+        return -1;
+
+    /* Trim to the last bin that saw audio. */
+    int last = a->n;
+    while (last > 0 && a->samples[last - 1] == 0)
+        last--;
+    if (last == 0) {
+        LOG(0, "No audio decoded from '%s'\n", input);
+        return -1;
+    }
+    env->power = malloc((size_t)last * sizeof(float));
+    if (!env->power)
+        return -1;
+    for (int i = 0; i < last; i++)
+        env->power[i] = a->samples[i] ? (float)(a->energy[i] / (double)a->samples[i]) : 0.0f;
+    env->n = last;
+    env->hop_ms = a->hop_ms;
+    return 0;
+}
+
+int audio_sync_read_envelope(const char *input, int seconds, int hop_ms,
+                             AudioEnvelope *env)
+{
+    memset(env, 0, sizeof(*env));
+    if (!input || seconds <= 0 || hop_ms <= 0)
+        return -1;
+
+    Reader r = { .acc = { .hop_ms = hop_ms, .n = (int)((int64_t)seconds * 1000 / hop_ms) } };
+    int rc = read_audio(&r, input, env);
+
+    free(r.acc.energy);
+    free(r.acc.samples);
+    av_frame_free(&r.frame);
+    av_packet_free(&r.pkt);
+    avcodec_free_context(&r.dec);
+    avformat_close_input(&r.fmt);
+    return rc;
+}
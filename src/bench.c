@@ -101,20 +101,30 @@ void bench_add_mux_sub_us(int64_t us) {
     pthread_mutex_unlock(&bench_mutex);
 }
 
-void bench_add_parse_us(int64_t us) {
+void bench_add_mux_stall_us(int64_t us) {
     if (us <= 0) return;
     pthread_mutex_lock(&bench_mutex);
-    bench.t_parse_us += us;
+    bench.t_mux_stall_us += us;
     pthread_mutex_unlock(&bench_mutex);
 }
 
-void bench_add_render_us(int64_t us) {
-    if (us <= 0) return;
+void bench_add_demux(int64_t us, int64_t packets) {
     pthread_mutex_lock(&bench_mutex);
-    bench.t_render_us += us;
+    if (us > 0)
+        bench.t_demux_us += us;
+    if (packets > 0)
+        bench.packets_demuxed += packets;
     pthread_mutex_unlock(&bench_mutex);
 }
 
+void bench_add_parse_us(int64_t us) {
+    bench_stats_add_parse_us(&bench, us);
+}
+
+void bench_add_render_us(int64_t us) {
+    bench_stats_add_render_us(&bench, us);
+}
+
 void bench_inc_cues_encoded(void) {
     pthread_mutex_lock(&bench_mutex);
     if (bench.cues_encoded < INT_MAX)
@@ -143,11 +153,26 @@ void bench_inc_packets_muxed_sub(void) {
 }
 
 void bench_inc_cues_rendered(void) {
+    bench_stats_inc_cues_rendered(&bench);
+}
+
+void bench_inc_cues_fast_path(void) {
     pthread_mutex_lock(&bench_mutex);
-    if (bench.cues_rendered < INT_MAX)
-        bench.cues_rendered++;
+    if (bench.cues_fast_path < INT_MAX)
+        bench.cues_fast_path++;
     else
-        bench.cues_rendered = INT_MAX;
+        bench.cues_fast_path = INT_MAX;
+    pthread_mutex_unlock(&bench_mutex);
+}
+
+void bench_add_depth(int track, int bits, int64_t bytes_saved, int64_t us_saved) {
+    if (track < 0 || track >= BENCH_MAX_TRACKS) return;
+    int slot = bits <= 2 ? 0 : (bits <= 4 ? 1 : 2);
+    pthread_mutex_lock(&bench_mutex);
+    if (bench.depth_cues[track][slot] < INT_MAX)
+        bench.depth_cues[track][slot]++;
+    bench.depth_bytes_saved[track] += bytes_saved;
+    bench.depth_us_saved[track] += us_saved;
     pthread_mutex_unlock(&bench_mutex);
 }
 
@@ -157,6 +182,86 @@ void bench_set_enabled(int enabled) {
     pthread_mutex_unlock(&bench_mutex);
 }
 
+/*
+ * Private accumulators (anything but the global `bench`) only carry the
+ * parse/render counters below, so they are updated with atomics instead
+ * of `bench_mutex`; render workers of different engines then never
+ * contend on a lock. The global keeps the mutex because the bench_add_*
+ * helpers update its other fields under it.
+ */
+void bench_stats_reset(BenchStats *b) {
+    if (!b) b = &bench;
+    if (b != &bench) {
+        __atomic_store_n(&b->t_parse_us, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&b->t_render_us, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&b->cues_rendered, 0, __ATOMIC_RELAXED);
+        return;
+    }
+    pthread_mutex_lock(&bench_mutex);
+    int enabled = b->enabled;
+    *b = (BenchStats){0};
+    b->enabled = enabled;
+    pthread_mutex_unlock(&bench_mutex);
+}
+
+void bench_stats_snapshot(const BenchStats *b, BenchStats *out) {
+    if (!out) return;
+    if (!b) b = &bench;
+    if (b != &bench) {
+        *out = (BenchStats){0};
+        out->enabled = b->enabled;
+        out->t_parse_us = __atomic_load_n(&b->t_parse_us, __ATOMIC_RELAXED);
+        out->t_render_us = __atomic_load_n(&b->t_render_us, __ATOMIC_RELAXED);
+        out->cues_rendered = __atomic_load_n(&b->cues_rendered, __ATOMIC_RELAXED);
+        return;
+    }
+    pthread_mutex_lock(&bench_mutex);
+    *out = *b;
+    pthread_mutex_unlock(&bench_mutex);
+}
+
+void bench_stats_add_parse_us(BenchStats *b, int64_t us) {
+    if (us <= 0) return;
+    if (!b) b = &bench;
+    if (b != &bench) {
+        __atomic_fetch_add(&b->t_parse_us, us, __ATOMIC_RELAXED);
+        return;
+    }
+    pthread_mutex_lock(&bench_mutex);
+    b->t_parse_us += us;
+    pthread_mutex_unlock(&bench_mutex);
+}
+
+void bench_stats_add_render_us(BenchStats *b, int64_t us) {
+    if (us <= 0) return;
+    if (!b) b = &bench;
+    if (b != &bench) {
+        __atomic_fetch_add(&b->t_render_us, us, __ATOMIC_RELAXED);
+        return;
+    }
+    pthread_mutex_lock(&bench_mutex);
+    b->t_render_us += us;
+    pthread_mutex_unlock(&bench_mutex);
+}
+
+void bench_stats_inc_cues_rendered(BenchStats *b) {
+    if (!b) b = &bench;
+    if (b != &bench) {
+        int cur = __atomic_load_n(&b->cues_rendered, __ATOMIC_RELAXED);
+        while (cur < INT_MAX &&
+               !__atomic_compare_exchange_n(&b->cues_rendered, &cur, cur + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+        return;
+    }
+    pthread_mutex_lock(&bench_mutex);
+    if (b->cues_rendered < INT_MAX)
+        b->cues_rendered++;
+    else
+        b->cues_rendered = INT_MAX;
+    pthread_mutex_unlock(&bench_mutex);
+}
+
 
 /*
  * bench_now
@@ -225,6 +330,9 @@ void bench_report(void) {
     /* Print summary header and simple event counters. */
     printf("\n\n--- Benchmark Report ---\n");
     printf("Cues rendered: %d\n", snapshot.cues_rendered);
+    if (snapshot.cues_fast_path > 0 && snapshot.cues_rendered > 0)
+        printf("  of which glyph-atlas fast path: %d (%.1f%%)\n", snapshot.cues_fast_path,
+               100.0 * snapshot.cues_fast_path / snapshot.cues_rendered);
     printf("Cues encoded: %d\n", snapshot.cues_encoded);
     printf("Packets muxed: %d\n", snapshot.packets_muxed);
     if (snapshot.packets_muxed_sub > 0)
@@ -238,4 +346,20 @@ void bench_report(void) {
     printf("Mux time:     %.3f ms\n", snapshot.t_mux_us / 1000.0);
     if (snapshot.packets_muxed_sub > 0)
         printf("  Subtitle mux time: %.3f ms\n", snapshot.t_mux_sub_us / 1000.0);
+    if (snapshot.t_mux_stall_us > 0)
+        printf("Mux stall:    %.3f ms (mux thread blocked on cue render/encode)\n",
+               snapshot.t_mux_stall_us / 1000.0);
+    if (snapshot.packets_demuxed > 0 && snapshot.t_demux_us > 0)
+        printf("Demux loop:   %.3f ms, %lld packets (%.0f packets/s)\n",
+               snapshot.t_demux_us / 1000.0, (long long)snapshot.packets_demuxed,
+               snapshot.packets_demuxed * 1e6 / (double)snapshot.t_demux_us);
+    for (int t = 0; t < BENCH_MAX_TRACKS; t++) {
+        const int *d = snapshot.depth_cues[t];
+        if (d[0] + d[1] + d[2] == 0)
+            continue;
+        printf("Track %d palette depth: %d x 2-bit, %d x 4-bit, %d x 8-bit; "
+               "saved %lld bytes, %.3f ms encode\n",
+               t, d[0], d[1], d[2], (long long)snapshot.depth_bytes_saved[t],
+               snapshot.depth_us_saved[t] / 1000.0);
+    }
 }
@@ -51,6 +51,9 @@
 
 #include <stdint.h>
 
+/** Tracks with their own palette depth counters in BenchStats. */
+#define BENCH_MAX_TRACKS 8
+
 /**
  * @file bench.h
  * @brief Lightweight benchmarking helpers for srt2dvb
@@ -111,6 +114,9 @@ typedef struct {
     /** Number of subtitle cues rendered. */
     int cues_rendered;
 
+    /** Number of rendered cues composited from the glyph atlas. */
+    int cues_fast_path;
+
     /** Number of subtitle cues handed to the encoder. */
     int cues_encoded;
 
@@ -119,6 +125,25 @@ typedef struct {
 
     /** Number of subtitle packets written to the output. */
     int packets_muxed_sub;
+
+    /** Time the mux thread spent waiting for or producing cue payloads
+     *  (render waits, inline renders and inline encodes; microseconds). */
+    int64_t t_mux_stall_us;
+
+    /** Wall time of the demux/mux loop (microseconds). */
+    int64_t t_demux_us;
+
+    /** Number of input packets read by the demux loop. */
+    int64_t packets_demuxed;
+
+    /** Cues encoded per track at each DVB region depth
+     *  (index 0: 2-bit, 1: 4-bit, 2: 8-bit). */
+    int depth_cues[BENCH_MAX_TRACKS][3];
+
+    /** Per-track DVB bytes and encode time (microseconds) saved by the
+     *  adaptive palette depth, measured against a full-depth encode. */
+    int64_t depth_bytes_saved[BENCH_MAX_TRACKS];
+    int64_t depth_us_saved[BENCH_MAX_TRACKS];
 } BenchStats;
 
 /**
@@ -191,12 +216,32 @@ void bench_report(void);
 void bench_add_encode_us(int64_t us);
 void bench_add_mux_us(int64_t us);
 void bench_add_mux_sub_us(int64_t us);
+void bench_add_demux(int64_t us, int64_t packets);
+void bench_add_mux_stall_us(int64_t us);
 void bench_add_parse_us(int64_t us);
 void bench_add_render_us(int64_t us);
 void bench_inc_cues_encoded(void);
 void bench_inc_packets_muxed(void);
 void bench_inc_packets_muxed_sub(void);
 void bench_inc_cues_rendered(void);
+void bench_inc_cues_fast_path(void);
 void bench_set_enabled(int enabled);
 
+/* Record one encoded cue of `track` at region depth `bits` (2, 4 or 8)
+ * together with the bytes and encode time its palette fit saved. */
+void bench_add_depth(int track, int bits, int64_t bytes_saved, int64_t us_saved);
+
+/* Explicit-target variants of the helpers above, which let callers that
+ * own a private accumulator (for example an engine context, see
+ * srt2dvbsub_engine.h) collect statistics without touching the global
+ * `bench`. Passing NULL targets the global accumulator, which is updated
+ * under the internal mutex. Private accumulators are updated with
+ * atomics and take no lock; they only track t_parse_us, t_render_us and
+ * cues_rendered (a snapshot reports the other fields as zero). */
+void bench_stats_reset(BenchStats *b);
+void bench_stats_snapshot(const BenchStats *b, BenchStats *out);
+void bench_stats_add_parse_us(BenchStats *b, int64_t us);
+void bench_stats_add_render_us(BenchStats *b, int64_t us);
+void bench_stats_inc_cues_rendered(BenchStats *b);
+
 #endif
@@ -0,0 +1,237 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * clut_cache.c
+ * ------------
+ * Palette -> YCbCrT conversion cache used by make_subtitle(); see
+ * clut_cache.h.
+ */
+
+#include "clut_cache.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Distinct palettes kept; a run normally has one per palette mode. */
+#define CLUT_CACHE_SLOTS 64
+
+typedef struct {
+    double kr, kb;
+} LumaCoeffs;
+
+static const LumaCoeffs coeffs[2] = {
+    { 0.299, 0.114 },   /* BT.601 */
+    { 0.2126, 0.0722 }, /* BT.709 */
+};
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ClutCacheEntry *slots[CLUT_CACHE_SLOTS];
+static uint32_t slot_hash[CLUT_CACHE_SLOTS];
+static int nslots;
+static long cache_hits, cache_misses, cache_clipped;
+
+int clut_colorimetry_parse(const char *s, ClutColorimetry *out) {
+    if (!s || !out) return -1;
+    if (strcmp(s, "bt601") == 0) *out = CLUT_COLORIMETRY_BT601;
+    else if (strcmp(s, "bt709") == 0) *out = CLUT_COLORIMETRY_BT709;
+    else if (strcmp(s, "auto") == 0) *out = CLUT_COLORIMETRY_AUTO;
+    else return -1;
+    return 0;
+}
+
+const char *clut_colorimetry_name(ClutColorimetry cm) {
+    switch (cm) {
+    case CLUT_COLORIMETRY_BT601: return "bt601";
+    case CLUT_COLORIMETRY_BT709: return "bt709";
+    case CLUT_COLORIMETRY_AUTO: return "auto";
+    }
+    return "unknown";
+}
+
+ClutColorimetry clut_colorimetry_for_video(int matrix, int height) {
+    if (matrix == 1) return CLUT_COLORIMETRY_BT709;
+    if (matrix == 5 || matrix == 6) return CLUT_COLORIMETRY_BT601;
+    return height > 576 ? CLUT_COLORIMETRY_BT709 : CLUT_COLORIMETRY_BT601;
+}
+
+/* Full-range RGB -> studio-range Y, Cb, Cr (unrounded). */
+static void rgb_to_ycbcr(const LumaCoeffs *k, double r, double g, double b,
+                         double *y, double *cb, double *cr) {
+    double kg = 1.0 - k->kr - k->kb;
+    double yn = k->kr * r + kg * g + k->kb * b;
+    *y = 16.0 + yn * 219.0 / 255.0;
+    *cb = 128.0 + (b - yn) / (2.0 * (1.0 - k->kb)) * 224.0 / 255.0;
+    *cr = 128.0 + (r - yn) / (2.0 * (1.0 - k->kr)) * 224.0 / 255.0;
+}
+
+static void ycbcr_to_rgb(const LumaCoeffs *k, double y, double cb, double cr,
+                         double *r, double *g, double *b) {
+    double kg = 1.0 - k->kr - k->kb;
+    double yn = (y - 16.0) * 255.0 / 219.0;
+    double pb = (cb - 128.0) * 255.0 / 224.0;
+    double pr = (cr - 128.0) * 255.0 / 224.0;
+    *r = yn + 2.0 * (1.0 - k->kr) * pr;
+    *b = yn + 2.0 * (1.0 - k->kb) * pb;
+    *g = (yn - k->kr * *r - k->kb * *b) / kg;
+}
+
+/* Components are rounded before the range test, so -0.4 is not clipping. */
+static int out_of_gamut(double v) {
+    return v < -0.5 || v >= 255.5;
+}
+
+static uint8_t clamp_u8(double v) {
+    if (v <= 0.0) return 0;
+    if (v >= 255.0) return 255;
+    return (uint8_t)lrint(v);
+}
+
+static const LumaCoeffs *coeffs_for(ClutColorimetry cm) {
+    return &coeffs[cm == CLUT_COLORIMETRY_BT709 ? 1 : 0];
+}
+
+ClutYCbCrT clut_argb_to_ycbcrt(uint32_t argb, ClutColorimetry cm) {
+    double y, cb, cr;
+    rgb_to_ycbcr(coeffs_for(cm), (argb >> 16) & 0xFF, (argb >> 8) & 0xFF, argb & 0xFF,
+                 &y, &cb, &cr);
+    ClutYCbCrT e = { clamp_u8(y), clamp_u8(cr), clamp_u8(cb), (uint8_t)(255 - (argb >> 24)) };
+    return e;
+}
+
+/* Encoder palette: re-express the target YCbCr in BT.601 RGB so the
+ * encoder's fixed conversion lands on it. Identity for BT.601. Sets
+ * `*clipped` when a component had to be clamped. */
+static uint32_t encoder_argb(uint32_t argb, ClutColorimetry cm, int *clipped) {
+    *clipped = 0;
+    if (cm != CLUT_COLORIMETRY_BT709) return argb;
+    double y, cb, cr, r, g, b;
+    rgb_to_ycbcr(coeffs_for(cm), (argb >> 16) & 0xFF, (argb >> 8) & 0xFF, argb & 0xFF,
+                 &y, &cb, &cr);
+    ycbcr_to_rgb(coeffs_for(CLUT_COLORIMETRY_BT601), y, cb, cr, &r, &g, &b);
+    *clipped = out_of_gamut(r) || out_of_gamut(g) || out_of_gamut(b);
+    return (argb & 0xFF000000u) | (uint32_t)clamp_u8(r) << 16 |
+           (uint32_t)clamp_u8(g) << 8 | clamp_u8(b);
+}
+
+void clut_encoder_palette(const uint32_t *in, int ncolors, ClutColorimetry cm,
+                          uint32_t *out) {
+    int clipped;
+    for (int i = 0; i < ncolors; i++)
+        out[i] = encoder_argb(in[i], cm, &clipped);
+}
+
+static uint32_t palette_hash(const uint32_t *p, int n, ClutColorimetry cm) {
+    uint32_t h = 2166136261u ^ (uint32_t)cm;
+    for (int i = 0; i < n; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h ^ (uint32_t)n;
+}
+
+const ClutCacheEntry *clut_cache_get(const uint32_t *palette, int ncolors,
+                                     ClutColorimetry cm) {
+    if (!palette || ncolors <= 0 || ncolors > 256 || cm == CLUT_COLORIMETRY_AUTO)
+        return NULL;
+    uint32_t h = palette_hash(palette, ncolors, cm);
+    size_t bytes = (size_t)ncolors * sizeof(uint32_t);
+
+    pthread_mutex_lock(&cache_mutex);
+    for (int i = 0; i < nslots; i++) {
+        const ClutCacheEntry *e = slots[i];
+        if (slot_hash[i] == h && e->ncolors == ncolors && e->colorimetry == cm &&
+            memcmp(e->argb, palette, bytes) == 0) {
+            cache_hits++;
+            pthread_mutex_unlock(&cache_mutex);
+            return e;
+        }
+    }
+    ClutCacheEntry *e = NULL;
+    if (nslots < CLUT_CACHE_SLOTS && (e = calloc(1, sizeof(*e))) != NULL) {
+        e->ncolors = ncolors;
+        e->colorimetry = cm;
+        memcpy(e->argb, palette, bytes);
+        for (int i = 0; i < ncolors; i++) {
+            int clipped;
+            e->encoder_argb[i] = encoder_argb(palette[i], cm, &clipped);
+            e->clipped += clipped;
+        }
+        slot_hash[nslots] = h;
+        slots[nslots++] = e;
+        cache_misses++;
+        cache_clipped += e->clipped;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+    return e;
+}
+
+void clut_cache_stats(long *hits, long *misses) {
+    pthread_mutex_lock(&cache_mutex);
+    if (hits) *hits = cache_hits;
+    if (misses) *misses = cache_misses;
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+long clut_cache_clipped(void) {
+    pthread_mutex_lock(&cache_mutex);
+    long n = cache_clipped;
+    pthread_mutex_unlock(&cache_mutex);
+    return n;
+}
+
+void clut_cache_clear(void) {
+    pthread_mutex_lock(&cache_mutex);
+    for (int i = 0; i < nslots; i++) {
+        free(slots[i]);
+        slots[i] = NULL;
+    }
+    nslots = 0;
+    cache_hits = cache_misses = cache_clipped = 0;
+    pthread_mutex_unlock(&cache_mutex);
+}
@@ -0,0 +1,146 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef CLUT_CACHE_H
+#define CLUT_CACHE_H
+
+#include <stdint.h>
+
+/**
+ * @file clut_cache.h
+ * @brief Cached ARGB -> YCbCrT conversion of subtitle palettes.
+ *
+ * DVB CLUT entries are Y, Cr, Cb and T (transparency). libavcodec's
+ * dvbsub encoder converts the ARGB palette of every display set with
+ * BT.601 studio-range coefficients. Our palettes only change with the
+ * palette mode, so the conversion is done once per distinct palette and
+ * kept in a small process-wide cache.
+ *
+ * For BT.709 output the cache also holds an encoder palette: ARGB values
+ * chosen so that the encoder's BT.601 conversion gives the BT.709
+ * YCbCr of the original colours. make_subtitle() substitutes it, which
+ * lets HD streams carry CLUTs in the colorimetry of the video without
+ * patching the encoder.
+ */
+
+/** CLUT colorimetry (--colorimetry). */
+typedef enum {
+    CLUT_COLORIMETRY_BT601 = 0, /**< ITU-R BT.601, the encoder's native conversion */
+    CLUT_COLORIMETRY_BT709,     /**< ITU-R BT.709 */
+    CLUT_COLORIMETRY_AUTO       /**< choose from the video stream (resolved at startup) */
+} ClutColorimetry;
+
+/** One DVB CLUT entry; t = 255 - alpha. */
+typedef struct {
+    uint8_t y, cr, cb, t;
+} ClutYCbCrT;
+
+/** Cached conversion of one palette. Entries live until clut_cache_clear(). */
+typedef struct {
+    int ncolors;
+    ClutColorimetry colorimetry;
+    uint32_t argb[256];          /**< source palette (the cache key) */
+    uint32_t encoder_argb[256];  /**< palette that a BT.601 encoder maps to the
+                                  *   clut_argb_to_ycbcrt() values of `argb` */
+    int clipped;                 /**< colours whose BT.601 RGB fell outside 0..255
+                                  *   and were clamped, so only approximate */
+} ClutCacheEntry;
+
+/**
+ * Parse a --colorimetry value: bt601, bt709 or auto.
+ *
+ * @return 0 on success, -1 if unknown.
+ */
+int clut_colorimetry_parse(const char *s, ClutColorimetry *out);
+
+/** Name of a colorimetry for logs. */
+const char *clut_colorimetry_name(ClutColorimetry cm);
+
+/**
+ * Resolve CLUT_COLORIMETRY_AUTO for a video stream. `matrix` is the
+ * stream's colour matrix: 1 for BT.709, 5/6 for BT.601 (the AVColorSpace
+ * / ISO 23091-2 codes), anything else to fall back to the picture
+ * height (> 576 lines means BT.709).
+ */
+ClutColorimetry clut_colorimetry_for_video(int matrix, int height);
+
+/** Convert one ARGB colour to a studio-range YCbCrT entry. */
+ClutYCbCrT clut_argb_to_ycbcrt(uint32_t argb, ClutColorimetry cm);
+
+/**
+ * Uncached encoder palette conversion (see ClutCacheEntry::encoder_argb),
+ * for palettes that do not fit in the cache. `out` may equal `in`.
+ */
+void clut_encoder_palette(const uint32_t *in, int ncolors, ClutColorimetry cm,
+                          uint32_t *out);
+
+/**
+ * Look up (or build and insert) the conversion of `palette`.
+ *
+ * Thread-safe. The returned entry stays valid until clut_cache_clear().
+ * Returns NULL for invalid arguments or when the cache is full; callers
+ * then use the palette unconverted.
+ */
+const ClutCacheEntry *clut_cache_get(const uint32_t *palette, int ncolors,
+                                     ClutColorimetry cm);
+
+/** Cache statistics: lookups served from the cache and conversions done. */
+void clut_cache_stats(long *hits, long *misses);
+
+/**
+ * Colours clamped to the BT.601 RGB gamut over all cached conversions
+ * (the sum of ClutCacheEntry::clipped). Saturated BT.709 colours such as
+ * pure red have no exact BT.601 RGB equivalent.
+ */
+long clut_cache_clipped(void);
+
+/** Free every cached entry. Not safe while other threads use entries. */
+void clut_cache_clear(void);
+
+#endif /* CLUT_CACHE_H */
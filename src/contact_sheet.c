@@ -0,0 +1,346 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * contact_sheet.c
+ * ---------------
+ * Shelf-packed sprite sheets of rendered cues plus a JSON index; see
+ * contact_sheet.h.
+ */
+
+#include "contact_sheet.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+/* Transparent pixels kept between neighbouring cues so a viewer that
+ * samples with filtering never bleeds one cue into the next. */
+#define SHEET_GAP 2
+
+typedef struct {
+    int y, h; /* top row and height of the shelf */
+    int x;    /* first free column */
+} Shelf;
+
+typedef struct {
+    int w, h, colors;
+} SheetPage;
+
+struct ContactSheet {
+    char dir[PATH_MAX];
+    int track;
+    char lang[8];
+    int cfg_w, cfg_h;
+    PngWriterOptions opt;
+    FILE *json;
+    int cues;          /* entries written to the index */
+    int failed;
+
+    /* page being filled; plane == NULL when none is open */
+    uint8_t *plane;
+    int pw, ph;
+    int used_w, used_h;
+    uint32_t pal[256]; /* pal[0] is the transparent background */
+    int npal;
+    Shelf *shelves;
+    int nshelves, cap_shelves;
+
+    SheetPage *pages;  /* written pages, listed in the index on close */
+    int npages, cap_pages;
+};
+
+/* Join the sheet directory and `name`. Returns -1 if it does not fit. */
+static int sheet_path(const ContactSheet *cs, char *out, size_t len, const char *name) {
+    size_t dl = strlen(cs->dir);
+    int n = snprintf(out, len, "%s%s%s", cs->dir,
+                     (dl > 0 && cs->dir[dl - 1] != '/') ? "/" : "", name);
+    return (n < 0 || (size_t)n >= len) ? -1 : 0;
+}
+
+/* Write `s` as a JSON string literal. Bytes >= 0x80 are passed through,
+ * so valid UTF-8 text stays readable in the index. */
+static void json_put_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (const unsigned char *p = (const unsigned char *)(s ? s : ""); *p; p++) {
+        switch (*p) {
+        case '"':  fputs("\\\"", f); break;
+        case '\\': fputs("\\\\", f); break;
+        case '\n': fputs("\\n", f); break;
+        case '\r': fputs("\\r", f); break;
+        case '\t': fputs("\\t", f); break;
+        default:
+            if (*p < 0x20) fprintf(f, "\\u%04x", *p);
+            else fputc(*p, f);
+        }
+    }
+    fputc('"', f);
+}
+
+ContactSheet *contact_sheet_open(const char *dir, int track, const char *lang,
+                                 int page_w, int page_h,
+                                 const PngWriterOptions *opt) {
+    if (!dir) return NULL;
+    ContactSheet *cs = calloc(1, sizeof(*cs));
+    if (!cs) return NULL;
+    snprintf(cs->dir, sizeof(cs->dir), "%s", dir);
+    snprintf(cs->lang, sizeof(cs->lang), "%s", lang ? lang : "");
+    cs->track = track;
+    cs->cfg_w = page_w > 0 ? page_w : CONTACT_SHEET_DEFAULT_SIZE;
+    cs->cfg_h = page_h > 0 ? page_h : CONTACT_SHEET_DEFAULT_SIZE;
+    cs->opt = opt ? *opt : png_writer_default_options();
+
+    char name[64], path[PATH_MAX];
+    snprintf(name, sizeof(name), "sheet_t%02d.json", track);
+    cs->json = sheet_path(cs, path, sizeof(path), name) == 0 ? fopen(path, "w") : NULL;
+    if (!cs->json) {
+        free(cs);
+        return NULL;
+    }
+    fprintf(cs->json, "{\n  \"track\": %d,\n  \"lang\": ", track);
+    json_put_string(cs->json, cs->lang);
+    fputs(",\n  \"cues\": [", cs->json);
+    return cs;
+}
+
+static int open_page(ContactSheet *cs, int w, int h) {
+    cs->pw = w > cs->cfg_w ? w : cs->cfg_w;
+    cs->ph = h > cs->cfg_h ? h : cs->cfg_h;
+    cs->plane = calloc((size_t)cs->pw * cs->ph, 1);
+    if (!cs->plane) return -1;
+    cs->used_w = cs->used_h = 0;
+    cs->pal[0] = 0;
+    cs->npal = 1;
+    cs->nshelves = 0;
+    return 0;
+}
+
+/* Encode the open page (cropped to its used area) and close it. */
+static int flush_page(ContactSheet *cs) {
+    if (!cs->plane) return 0;
+    int rc = 0;
+    if (cs->used_w > 0 && cs->used_h > 0) {
+        unsigned char *png = NULL;
+        size_t len = 0;
+        char name[64], path[PATH_MAX];
+        snprintf(name, sizeof(name), "sheet_t%02d_p%03d.png", cs->track, cs->npages);
+        rc = sheet_path(cs, path, sizeof(path), name);
+        if (rc == 0)
+            rc = png_encode_indexed(cs->plane, cs->used_w, cs->used_h, cs->pw,
+                                    cs->pal, cs->npal, &cs->opt, &png, &len);
+        if (rc == 0) {
+            FILE *f = fopen(path, "wb");
+            if (!f || fwrite(png, 1, len, f) != len) rc = -1;
+            if (f && fclose(f) != 0) rc = -1;
+        }
+        free(png);
+        if (cs->npages == cs->cap_pages) {
+            int cap = cs->cap_pages ? cs->cap_pages * 2 : 8;
+            SheetPage *np = realloc(cs->pages, (size_t)cap * sizeof(*np));
+            if (!np) rc = -1;
+            else { cs->pages = np; cs->cap_pages = cap; }
+        }
+        if (cs->npages < cs->cap_pages)
+            cs->pages[cs->npages] = (SheetPage){ cs->used_w, cs->used_h, cs->npal };
+        cs->npages++;
+    }
+    free(cs->plane);
+    cs->plane = NULL;
+    if (rc != 0) cs->failed = 1;
+    return rc;
+}
+
+/*
+ * Map each cue palette entry to a page palette slot, appending colours the
+ * page does not have yet. With `force` set, colours that no longer fit go
+ * to the nearest existing entry instead of failing; that only happens for
+ * a cue with more than 255 visible colours on a fresh page.
+ */
+static int map_palette(ContactSheet *cs, const uint32_t *palette, int ncolors,
+                       uint8_t map[256], int force) {
+    int saved = cs->npal;
+    for (int i = 0; i < ncolors; i++) {
+        uint32_t c = palette[i];
+        if ((c >> 24) == 0) { map[i] = 0; continue; }
+        int slot = -1;
+        for (int j = 1; j < cs->npal; j++)
+            if (cs->pal[j] == c) { slot = j; break; }
+        if (slot < 0 && cs->npal < 256) {
+            slot = cs->npal;
+            cs->pal[cs->npal++] = c;
+        }
+        if (slot < 0) {
+            if (!force) { cs->npal = saved; return -1; }
+            long best = -1;
+            for (int j = 1; j < cs->npal; j++) {
+                long d = 0;
+                for (int s = 0; s < 32; s += 8) {
+                    long e = (long)((c >> s) & 0xFF) - (long)((cs->pal[j] >> s) & 0xFF);
+                    d += e * e;
+                }
+                if (best < 0 || d < best) { best = d; slot = j; }
+            }
+        }
+        map[i] = (uint8_t)slot;
+    }
+    return 0;
+}
+
+/* Best-height-fit shelf placement. Returns 0 and the top-left corner, or
+ * -1 if the cue does not fit on the open page. */
+static int place(ContactSheet *cs, int w, int h, int *ox, int *oy) {
+    int best = -1;
+    for (int i = 0; i < cs->nshelves; i++) {
+        const Shelf *s = &cs->shelves[i];
+        if (s->h >= h && s->x + w <= cs->pw &&
+            (best < 0 || s->h < cs->shelves[best].h))
+            best = i;
+    }
+    if (best < 0) {
+        int top = 0;
+        if (cs->nshelves > 0) {
+            const Shelf *last = &cs->shelves[cs->nshelves - 1];
+            top = last->y + last->h + SHEET_GAP;
+        }
+        if (top + h > cs->ph || w > cs->pw) return -1;
+        if (cs->nshelves == cs->cap_shelves) {
+            int cap = cs->cap_shelves ? cs->cap_shelves * 2 : 16;
+            Shelf *ns = realloc(cs->shelves, (size_t)cap * sizeof(*ns));
+            if (!ns) return -1;
+            cs->shelves = ns;
+            cs->cap_shelves = cap;
+        }
+        cs->shelves[cs->nshelves] = (Shelf){ top, h, 0 };
+        best = cs->nshelves++;
+    }
+    Shelf *s = &cs->shelves[best];
+    *ox = s->x;
+    *oy = s->y;
+    s->x += w + SHEET_GAP;
+    return 0;
+}
+
+static void put_entry(ContactSheet *cs, int cue, int page, int x, int y, int w, int h,
+                      int pos_x, int pos_y, int64_t start_ms, int64_t end_ms,
+                      const char *text) {
+    fprintf(cs->json,
+            "%s\n    {\"cue\": %d, \"page\": %d, \"x\": %d, \"y\": %d, \"w\": %d, \"h\": %d, "
+            "\"pos_x\": %d, \"pos_y\": %d, \"start_ms\": %lld, \"end_ms\": %lld, \"text\": ",
+            cs->cues ? "," : "", cue, page, x, y, w, h, pos_x, pos_y,
+            (long long)start_ms, (long long)end_ms);
+    json_put_string(cs->json, text);
+    fputc('}', cs->json);
+    cs->cues++;
+}
+
+int contact_sheet_add(ContactSheet *cs, int cue, int64_t start_ms, int64_t end_ms,
+                      const char *text, const uint8_t *idx, int w, int h,
+                      const uint32_t *palette, int ncolors, int pos_x, int pos_y) {
+    if (!cs) return -1;
+    if (!idx || !palette || w <= 0 || h <= 0 || ncolors <= 0) {
+        put_entry(cs, cue, -1, 0, 0, 0, 0, pos_x, pos_y, start_ms, end_ms, text);
+        return 0;
+    }
+    if (ncolors > 256) ncolors = 256;
+
+    uint8_t map[256];
+    int x = 0, y = 0;
+    int rc = 0;
+    if (!cs->plane || map_palette(cs, palette, ncolors, map, 0) != 0 ||
+        place(cs, w, h, &x, &y) != 0) {
+        /* A colour merged above stays on the outgoing page; harmless. */
+        rc = flush_page(cs);
+        if (open_page(cs, w, h) != 0) {
+            cs->failed = 1;
+            return -1;
+        }
+        map_palette(cs, palette, ncolors, map, 1);
+        if (place(cs, w, h, &x, &y) != 0) {
+            cs->failed = 1;
+            return -1;
+        }
+    }
+
+    for (int r = 0; r < h; r++) {
+        const uint8_t *src = idx + (size_t)r * w;
+        uint8_t *dst = cs->plane + (size_t)(y + r) * cs->pw + x;
+        for (int c = 0; c < w; c++)
+            dst[c] = src[c] < ncolors ? map[src[c]] : 0;
+    }
+    if (x + w > cs->used_w) cs->used_w = x + w;
+    if (y + h > cs->used_h) cs->used_h = y + h;
+
+    put_entry(cs, cue, cs->npages, x, y, w, h, pos_x, pos_y, start_ms, end_ms, text);
+    return rc;
+}
+
+int contact_sheet_close(ContactSheet *cs) {
+    if (!cs) return -1;
+    flush_page(cs);
+    fputs(cs->cues ? "\n  ],\n  \"pages\": [" : "],\n  \"pages\": [", cs->json);
+    for (int i = 0; i < cs->npages && i < cs->cap_pages; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "sheet_t%02d_p%03d.png", cs->track, i);
+        fprintf(cs->json, "%s\n    {\"page\": %d, \"file\": ", i ? "," : "", i);
+        json_put_string(cs->json, name);
+        fprintf(cs->json, ", \"w\": %d, \"h\": %d, \"colors\": %d}",
+                cs->pages[i].w, cs->pages[i].h, cs->pages[i].colors);
+    }
+    fputs(cs->npages ? "\n  ]\n}\n" : "]\n}\n", cs->json);
+    int rc = cs->failed ? -1 : 0;
+    if (ferror(cs->json)) rc = -1;
+    if (fclose(cs->json) != 0) rc = -1;
+    free(cs->shelves);
+    free(cs->pages);
+    free(cs);
+    return rc;
+}
@@ -0,0 +1,115 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef CONTACT_SHEET_H
+#define CONTACT_SHEET_H
+
+#include <stdint.h>
+#include "png_writer.h"
+
+/**
+ * @file contact_sheet.h
+ * @brief Packs rendered cue bitmaps into per-track sprite-sheet PNGs.
+ *
+ * Instead of one PNG per cue, --png-sheet streams each rendered cue into
+ * a shelf packer: a cue goes on the open shelf whose height wastes the
+ * fewest rows, or on a new shelf below the last one. A page is written
+ * when the next cue no longer fits or when the page's merged palette
+ * would exceed 256 colours. Pages are cropped to the used area and
+ * written with the native palette writer as
+ * `<png-dir>/sheet_tNN_pMMM.png`.
+ *
+ * Next to the pages, `<png-dir>/sheet_tNN.json` indexes every cue: its
+ * page and rectangle on the sheet, its position on the video canvas,
+ * its timing and its source text. Cues that rendered to nothing are
+ * listed with page -1 so the index stays complete.
+ */
+
+/** Default page size when --png-sheet-size is not given. */
+#define CONTACT_SHEET_DEFAULT_SIZE 4096
+
+typedef struct ContactSheet ContactSheet;
+
+/**
+ * Open a sheet for one track. The JSON index is created immediately.
+ *
+ * @param dir      Output directory (with or without trailing '/').
+ * @param track    Track number, used in the file names.
+ * @param lang     Track language recorded in the index (may be NULL).
+ * @param page_w   Page width; a cue wider than this gets a page of its own.
+ * @param page_h   Page height; likewise for taller cues.
+ * @param opt      PNG writer settings, or NULL for the defaults.
+ * @return The sheet, or NULL if the index cannot be created.
+ */
+ContactSheet *contact_sheet_open(const char *dir, int track, const char *lang,
+                                 int page_w, int page_h,
+                                 const PngWriterOptions *opt);
+
+/**
+ * Add one rendered cue.
+ *
+ * @param cue       Cue index within the track.
+ * @param idx       Index plane, `h` rows of `w` bytes (may be NULL if empty).
+ * @param palette   `ncolors` ARGB entries; fully transparent entries all
+ *                  map to the sheet background.
+ * @param pos_x     Cue position on the video canvas.
+ * @return 0 on success, -1 if a page could not be written.
+ */
+int contact_sheet_add(ContactSheet *cs, int cue, int64_t start_ms, int64_t end_ms,
+                      const char *text, const uint8_t *idx, int w, int h,
+                      const uint32_t *palette, int ncolors, int pos_x, int pos_y);
+
+/**
+ * Write the last page, finish the JSON index and free the sheet.
+ *
+ * @return 0 if every page and the index were written, -1 otherwise.
+ */
+int contact_sheet_close(ContactSheet *cs);
+
+#endif /* CONTACT_SHEET_H */
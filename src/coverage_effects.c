@@ -0,0 +1,233 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * coverage_effects.c
+ * ------------------
+ * Morphological outline/shadow generation for render_text_pango(); see
+ * coverage_effects.h for the model.
+ */
+
+#include "coverage_effects.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+int render_effects_mode_parse(const char *s, RenderEffectsMode *out) {
+    if (!s || !out) return -1;
+    if (strcmp(s, "cairo") == 0) *out = RENDER_EFFECTS_CAIRO;
+    else if (strcmp(s, "morph") == 0) *out = RENDER_EFFECTS_MORPH;
+    else if (strcmp(s, "auto") == 0) *out = RENDER_EFFECTS_AUTO;
+    else return -1;
+    return 0;
+}
+
+/* One kernel tap: pixel offset and bias (r - distance) * 255. */
+typedef struct {
+    int dx, dy;
+    int bias;
+} DilateTap;
+
+/*
+ * Additive disc kernel. A pixel of coverage c has its edge roughly
+ * (c - 0.5) px beyond its centre, so seen from a pixel at distance d the
+ * stroke reaching r past that edge covers about r + c - d of it; the
+ * dilation keeps the largest such estimate over the disc of radius r + 1.
+ */
+static int build_kernel(double r, DilateTap **out) {
+    int R = (int)ceil(r + 1.0);
+    DilateTap *taps = malloc((size_t)(2 * R + 1) * (2 * R + 1) * sizeof(*taps));
+    if (!taps) return -1;
+    int n = 0;
+    for (int dy = -R; dy <= R; dy++) {
+        for (int dx = -R; dx <= R; dx++) {
+            double bias = r - sqrt((double)(dx * dx + dy * dy));
+            if (bias <= -1.0) continue;
+            taps[n++] = (DilateTap){ dx, dy, (int)lround(bias * 255.0) };
+        }
+    }
+    *out = taps;
+    return n;
+}
+
+int coverage_outline(const uint8_t *cov, int cov_stride, int w, int h,
+                     double radius, uint8_t *out, int out_stride) {
+    if (!cov || !out || w <= 0 || h <= 0 || radius < 0.0) return -1;
+    DilateTap *taps = NULL;
+    int ntaps = build_kernel(radius, &taps);
+    if (ntaps < 0) return -1;
+    uint8_t *inv = malloc((size_t)w * h);
+    uint8_t *din = malloc((size_t)w * h);
+    if (!inv || !din) {
+        free(inv);
+        free(din);
+        free(taps);
+        return -1;
+    }
+    for (int y = 0; y < h; y++) {
+        const uint8_t *s = cov + (size_t)y * cov_stride;
+        uint8_t *o = out + (size_t)y * out_stride;
+        uint8_t *iv = inv + (size_t)y * w;
+        for (int x = 0; x < w; x++)
+            iv[x] = (uint8_t)(255 - s[x]);
+        memset(o, 0, (size_t)w);
+        memset(din + (size_t)y * w, 0, (size_t)w);
+    }
+
+    /* dilate(cov) into out and dilate(~cov) into din, one tap at a time
+     * over the rows that tap can reach. */
+    for (int t = 0; t < ntaps; t++) {
+        const int dx = taps[t].dx, dy = taps[t].dy;
+        const int bias = taps[t].bias;
+        const int y0 = dy < 0 ? -dy : 0, y1 = dy > 0 ? h - dy : h;
+        const int x0 = dx < 0 ? -dx : 0, x1 = dx > 0 ? w - dx : w;
+        for (int y = y0; y < y1; y++) {
+            const uint8_t *s = cov + (size_t)(y + dy) * cov_stride + dx;
+            const uint8_t *si = inv + (size_t)(y + dy) * w + dx;
+            uint8_t *o = out + (size_t)y * out_stride;
+            uint8_t *di = din + (size_t)y * w;
+            for (int x = x0; x < x1; x++) {
+                int a = s[x] ? s[x] + bias : 0;
+                int b = si[x] ? si[x] + bias : 0;
+                a = a < 0 ? 0 : a > 255 ? 255 : a;
+                b = b < 0 ? 0 : b > 255 ? 255 : b;
+                o[x] = (uint8_t)(a > o[x] ? a : o[x]);
+                di[x] = (uint8_t)(b > di[x] ? b : di[x]);
+            }
+        }
+    }
+
+    for (int y = 0; y < h; y++) {
+        uint8_t *o = out + (size_t)y * out_stride;
+        const uint8_t *di = din + (size_t)y * w;
+        for (int x = 0; x < w; x++)
+            o[x] = di[x] < o[x] ? di[x] : o[x];
+    }
+    free(inv);
+    free(din);
+    free(taps);
+    return 0;
+}
+
+void coverage_shift(const uint8_t *src, int src_stride, int w, int h,
+                    int dx, int dy, uint8_t *dst, int dst_stride) {
+    if (!src || !dst || w <= 0 || h <= 0) return;
+    for (int y = 0; y < h; y++) {
+        uint8_t *d = dst + (size_t)y * dst_stride;
+        int sy = y - dy;
+        if (sy < 0 || sy >= h || dx >= w || dx <= -w) {
+            memset(d, 0, (size_t)w);
+            continue;
+        }
+        const uint8_t *s = src + (size_t)sy * src_stride;
+        if (dx >= 0) {
+            memset(d, 0, (size_t)dx);
+            memcpy(d + dx, s, (size_t)(w - dx));
+        } else {
+            memcpy(d, s - dx, (size_t)(w + dx));
+            memset(d + w + dx, 0, (size_t)-dx);
+        }
+    }
+}
+
+/* Premultiplied OVER of straight colour (ca,cr,cg,cb) at coverage cv. */
+static inline uint32_t over(uint32_t d, unsigned cv, unsigned ca, unsigned cr,
+                            unsigned cg, unsigned cb) {
+    unsigned sa = (ca * cv + 127) / 255;
+    if (!sa) return d;
+    unsigned inv = 255 - sa;
+    unsigned da = sa + (((d >> 24) & 0xFF) * inv + 127) / 255;
+    unsigned dr = (cr * sa + 127) / 255 + (((d >> 16) & 0xFF) * inv + 127) / 255;
+    unsigned dg = (cg * sa + 127) / 255 + (((d >> 8) & 0xFF) * inv + 127) / 255;
+    unsigned db = (cb * sa + 127) / 255 + ((d & 0xFF) * inv + 127) / 255;
+    return (da << 24) | (dr << 16) | (dg << 8) | db;
+}
+
+int coverage_effects_compose(const uint8_t *fill, int fill_stride, int w, int h,
+                             double outline_radius, int shadow_dx, int shadow_dy,
+                             uint32_t fill_argb, uint32_t outline_argb, uint32_t shadow_argb,
+                             uint8_t *canvas, int canvas_stride) {
+    if (!fill || !canvas || w <= 0 || h <= 0) return -1;
+    uint8_t *outline = NULL;
+    if (outline_argb >> 24) {
+        outline = malloc((size_t)w * h);
+        if (!outline || coverage_outline(fill, fill_stride, w, h, outline_radius, outline, w) != 0) {
+            free(outline);
+            return -1;
+        }
+    }
+    const unsigned sa = shadow_argb >> 24, sr = (shadow_argb >> 16) & 0xFF;
+    const unsigned sg = (shadow_argb >> 8) & 0xFF, sb = shadow_argb & 0xFF;
+    const unsigned oa = outline_argb >> 24, or_ = (outline_argb >> 16) & 0xFF;
+    const unsigned og = (outline_argb >> 8) & 0xFF, ob = outline_argb & 0xFF;
+    const unsigned fa = fill_argb >> 24, fr = (fill_argb >> 16) & 0xFF;
+    const unsigned fg = (fill_argb >> 8) & 0xFF, fb = fill_argb & 0xFF;
+
+    for (int y = 0; y < h; y++) {
+        uint32_t *d = (uint32_t *)(canvas + (size_t)y * canvas_stride);
+        const uint8_t *f = fill + (size_t)y * fill_stride;
+        const uint8_t *o = outline ? outline + (size_t)y * w : NULL;
+        const int sy = y - shadow_dy;
+        const uint8_t *s = (sa && sy >= 0 && sy < h) ? fill + (size_t)sy * fill_stride : NULL;
+        for (int x = 0; x < w; x++) {
+            uint32_t px = d[x];
+            if (s) {
+                int sx = x - shadow_dx;
+                if (sx >= 0 && sx < w && s[sx])
+                    px = over(px, s[sx], sa, sr, sg, sb);
+            }
+            if (o && o[x])
+                px = over(px, o[x], oa, or_, og, ob);
+            if (fa && f[x])
+                px = over(px, f[x], fa, fr, fg, fb);
+            d[x] = px;
+        }
+    }
+    free(outline);
+    return 0;
+}
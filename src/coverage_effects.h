@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef COVERAGE_EFFECTS_H
+#define COVERAGE_EFFECTS_H
+
+#include <stdint.h>
+
+/**
+ * @file coverage_effects.h
+ * @brief Outline and shadow derived from a single fill coverage mask.
+ *
+ * The Cairo effect pipeline draws every cue three times at SSAA
+ * resolution: the shadow (offset show_layout), the outline
+ * (layout_path + round-join stroke) and the fill. Path stroking
+ * dominates for long or CJK cues. The morphological pipeline instead
+ * rasterises the fill coverage once and derives
+ *
+ *  - the outline as the band within `radius` pixels of the coverage
+ *    edge on either side, i.e. min(dilate(fill), dilate(~fill)) with a
+ *    soft-edged disc, which is what a centred round-join stroke of width
+ *    2*radius covers, and
+ *  - the shadow as the fill coverage shifted by a whole-pixel offset,
+ *
+ * then composites shadow, outline and fill OVER the canvas in one pass.
+ * The dilation runs one kernel offset at a time over whole rows so the
+ * inner loops are plain byte max operations the compiler vectorises.
+ *
+ * Coverage is A8 (0..255, Cairo A8 layout); colours are straight-alpha
+ * 0xAARRGGBB; the canvas is premultiplied ARGB32 in Cairo image layout.
+ */
+
+/** Effect pipeline used by render_text_pango(). */
+typedef enum {
+    RENDER_EFFECTS_CAIRO = 0, /**< shadow/outline/fill drawn by Cairo (default) */
+    RENDER_EFFECTS_MORPH,     /**< outline and shadow derived from the fill mask */
+    RENDER_EFFECTS_AUTO       /**< morph for HD/UHD profiles, Cairo for SD */
+} RenderEffectsMode;
+
+/**
+ * Parse "cairo", "morph" or "auto".
+ *
+ * @return 0 on success, -1 if @p s is not a known mode.
+ */
+int render_effects_mode_parse(const char *s, RenderEffectsMode *out);
+
+/**
+ * Outline coverage: the band within @p radius pixels of the edge of
+ * @p cov, on both sides, with a one-pixel soft falloff. Pixels beyond
+ * the mask bounds count as empty.
+ *
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int coverage_outline(const uint8_t *cov, int cov_stride, int w, int h,
+                     double radius, uint8_t *out, int out_stride);
+
+/**
+ * Copy @p src shifted by (@p dx, @p dy) pixels into @p dst (same size);
+ * uncovered pixels become 0.
+ */
+void coverage_shift(const uint8_t *src, int src_stride, int w, int h,
+                    int dx, int dy, uint8_t *dst, int dst_stride);
+
+/**
+ * Derive outline and shadow from @p fill and composite shadow, outline
+ * and fill OVER @p canvas (w x h, premultiplied ARGB32) in a single
+ * pass. A colour with zero alpha skips its layer.
+ *
+ * @return 0 on success, -1 on invalid arguments or allocation failure
+ *         (the canvas is untouched).
+ */
+int coverage_effects_compose(const uint8_t *fill, int fill_stride, int w, int h,
+                             double outline_radius, int shadow_dx, int shadow_dy,
+                             uint32_t fill_argb, uint32_t outline_argb, uint32_t shadow_argb,
+                             uint8_t *canvas, int canvas_stride);
+
+#endif /* COVERAGE_EFFECTS_H */
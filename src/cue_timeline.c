@@ -0,0 +1,87 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * cue_timeline.c
+ * --------------
+ * Builds the per-track struct-of-arrays timeline consumed by the demux
+ * loop. The three arrays share one allocation so a track's timeline is
+ * a single contiguous block.
+ */
+
+#include "cue_timeline.h"
+#include <stdlib.h>
+#include <string.h>
+
+int cue_timeline_build(CueTimeline *tl, const FrameTiming *ft, SRTEntry *entries, int count,
+                       int64_t delay_ms, int64_t input_start_pts90) {
+    if (!tl) return -1;
+    cue_timeline_free(tl);
+    if (!entries || count <= 0) return 0;
+
+    int64_t *block = malloc(sizeof(int64_t) * 3 * (size_t)count);
+    if (!block) return -1;
+
+    tl->due90 = block;
+    tl->start90 = block + count;
+    tl->end90 = block + 2 * (size_t)count;
+    tl->count = count;
+
+    int changed = frame_timing_apply(ft, entries, count, delay_ms, tl->due90, tl->end90);
+    for (int i = 0; i < count; i++) {
+        tl->start90[i] = input_start_pts90 + tl->due90[i];
+        tl->end90[i] += input_start_pts90;
+    }
+    return changed;
+}
+
+void cue_timeline_free(CueTimeline *tl) {
+    if (!tl) return;
+    free(tl->due90);
+    memset(tl, 0, sizeof(*tl));
+}
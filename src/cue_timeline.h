@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef CUE_TIMELINE_H
+#define CUE_TIMELINE_H
+
+#include <stdint.h>
+#include "srt_parser.h"
+#include "frame_timing.h"
+
+/**
+ * @file cue_timeline.h
+ * @brief Struct-of-arrays cue timeline for the demux hot path.
+ *
+ * The demux loop runs once per input packet and, for each track, only
+ * needs to know whether the next cue is due. Reading that from the
+ * `SRTEntry` array drags text pointers and alignment data through the
+ * cache for every packet. A CueTimeline keeps just the 90 kHz times in
+ * three contiguous arrays (one allocation) so the comparison touches a
+ * single int64_t per track, and cue_timeline_next_due() feeds a global
+ * watermark that lets most packets skip the per-track loop entirely.
+ */
+
+/** Sentinel returned once a track has no cues left. */
+#define CUE_TIMELINE_NONE INT64_MAX
+
+/** Per-track precomputed cue times (90 kHz). */
+typedef struct CueTimeline {
+    int count;        /**< number of cues (mirrors SubTrack.count) */
+    int64_t *due90;   /**< emitted start relative to the input start: compared against packet PTS */
+    int64_t *start90; /**< absolute PTS of the display set */
+    int64_t *end90;   /**< absolute PTS of the clearing display set */
+} CueTimeline;
+
+/**
+ * Build the timeline for `count` cues, running the frame timing stage
+ * (frame_timing_apply()) over `entries` on the way. The snapped 90 kHz
+ * times are stored as-is, so a cue on an x/1001 grid is stamped on its
+ * exact frame boundary rather than on a millisecond rounded from it.
+ * Any previous contents of `tl` are released first.
+ *
+ * @param ft                conversion/snapping settings, or NULL for plain ms timing
+ * @param delay_ms          per-track delay added to every cue
+ * @param input_start_pts90 first PTS of the input (origin of cue time zero)
+ * @return number of cues adjusted by `ft` (>= 0), or -1 on allocation
+ *         failure (tl is left empty, entries untouched).
+ */
+int cue_timeline_build(CueTimeline *tl, const FrameTiming *ft, SRTEntry *entries, int count,
+                       int64_t delay_ms, int64_t input_start_pts90);
+
+/** Release the arrays and reset `tl` to empty. Safe on an empty timeline. */
+void cue_timeline_free(CueTimeline *tl);
+
+/**
+ * Due time of cue `cur`, or CUE_TIMELINE_NONE when `cur` is past the end
+ * or the timeline is empty.
+ */
+static inline int64_t cue_timeline_next_due(const CueTimeline *tl, int cur) {
+    return (tl->due90 && cur >= 0 && cur < tl->count) ? tl->due90[cur] : CUE_TIMELINE_NONE;
+}
+
+#endif /* CUE_TIMELINE_H */
@@ -59,6 +59,42 @@
 /* Global debug/verbosity level. Defined in a single translation unit. */
 extern int debug_level;
 
+/*
+ * SRT2DVB_MAX_LOG_LEVEL
+ * ---------------------
+ * Highest LOG() level compiled in. Calls above it, and LOG_ENABLED()
+ * checks above it, become constant-false and are removed by the compiler
+ * together with their argument evaluation, so --debug cannot enable them.
+ * Set with ./configure --with-max-log-level=N; `make release` uses 1.
+ * Unset means no limit.
+ */
+#ifndef SRT2DVB_MAX_LOG_LEVEL
+#define SRT2DVB_MAX_LOG_LEVEL 99
+#endif
+
+#if defined(__GNUC__)
+#define SRT2DVB_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define SRT2DVB_UNLIKELY(x) (x)
+#endif
+
+/* Runtime half of LOG_ENABLED(); always reads the global level, even in
+ * functions that keep a local copy named debug_level. */
+static inline int srt2dvb_log_on(int level)
+{
+	return debug_level >= level;
+}
+
+/*
+ * LOG_ENABLED(level)
+ * ------------------
+ * True when a LOG(level, ...) call would print. Use it instead of
+ * `if (debug_level > N)` to guard work done only for logging, so the
+ * guard is compiled out with the call and is predicted not taken.
+ */
+#define LOG_ENABLED(level) \
+	((level) <= SRT2DVB_MAX_LOG_LEVEL && SRT2DVB_UNLIKELY(srt2dvb_log_on(level)))
+
 /*
  * LOG macro
  * ---------
@@ -79,6 +115,20 @@ extern int debug_level;
 #endif
 
 #include <stdarg.h>
+#include <stdint.h>
+
+/*
+ * Optional asynchronous backend (log_async.c). The hooks are weak
+ * references so programs and test harnesses that do not link it keep the
+ * direct stderr path; when linked and started, LOG() only formats into a
+ * per-thread ring and a writer thread does the I/O.
+ */
+#if defined(__GNUC__) && defined(__ELF__)
+#define SRT2DVB_LOG_ASYNC 1
+extern int srt2dvb_log_async_submit(int level, const char *module,
+                                    const char *fmt, va_list ap) __attribute__((weak));
+extern void srt2dvb_log_set_context(int track, int cue, int64_t pts90) __attribute__((weak));
+#endif
 
 /* Internal helper: thread-safe write into stderr using stdio locking. */
 static inline void srt2dvb_log_write(int level, const char *module, const char *fmt, ...)
@@ -86,6 +136,18 @@ static inline void srt2dvb_log_write(int level, const char *module, const char *
 	if (debug_level < level) return;
 	va_list ap;
 	va_start(ap, fmt);
+#ifdef SRT2DVB_LOG_ASYNC
+	if (srt2dvb_log_async_submit) {
+		va_list aq;
+		va_copy(aq, ap);
+		int queued = srt2dvb_log_async_submit(level, module, fmt, aq) == 0;
+		va_end(aq);
+		if (queued) {
+			va_end(ap);
+			return;
+		}
+	}
+#endif
 #if defined(__unix__) || defined(__APPLE__)
 	/* POSIX: use flockfile/funlockfile to serialize stdio writes */
 	flockfile(stderr);
@@ -101,6 +163,23 @@ static inline void srt2dvb_log_write(int level, const char *module, const char *
 }
 
 #define LOG(level, fmt, ...) \
-	do { srt2dvb_log_write(level, DEBUG_MODULE, fmt, ##__VA_ARGS__); } while (0)
+	do { \
+		if (LOG_ENABLED(level)) \
+			srt2dvb_log_write(level, DEBUG_MODULE, fmt, ##__VA_ARGS__); \
+	} while (0)
+
+/*
+ * LOG_CONTEXT(track, cue, pts90)
+ * ------------------------------
+ * Tag this thread's subsequent LOG() records with a track index, cue
+ * index and 90 kHz PTS (-1 = none). Only the JSON output of the async
+ * backend shows them; without the backend this is a no-op.
+ */
+#ifdef SRT2DVB_LOG_ASYNC
+#define LOG_CONTEXT(track, cue, pts90) \
+	do { if (srt2dvb_log_set_context) srt2dvb_log_set_context((track), (cue), (pts90)); } while (0)
+#else
+#define LOG_CONTEXT(track, cue, pts90) do { } while (0)
+#endif
 
 #endif /* SRT2DVB_DEBUG_H */
@@ -48,6 +48,7 @@
 
 #define _POSIX_C_SOURCE 200809L
 #include "debug_png.h"
+#include "png_writer.h"
 #include <cairo.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -61,6 +62,82 @@
 #define DEBUG_MODULE "debug_png"
 #include "debug.h"
 
+/* Writer selection; set once at startup via debug_png_set_writer(). */
+static int use_cairo_writer = 0;
+static PngWriterOptions writer_opts = { 6, PNG_FILTER_NONE, 1 };
+
+void debug_png_set_writer(int use_cairo, const PngWriterOptions *opt) {
+    use_cairo_writer = use_cairo ? 1 : 0;
+    writer_opts = opt ? *opt : png_writer_default_options();
+}
+
+/*
+ * ensure_parent_dirs
+ * ------------------
+ * Create each parent directory component of `filename`. Failures are
+ * ignored here; the subsequent write reports them.
+ */
+static void ensure_parent_dirs(const char *filename) {
+    char *dirend = strrchr(filename, '/');
+    if (dirend) {
+        size_t dirlen = dirend - filename;
+        char dirbuf[PATH_MAX];
+        if (dirlen >= sizeof(dirbuf)) dirlen = sizeof(dirbuf)-1;
+        memcpy(dirbuf, filename, dirlen);
+        dirbuf[dirlen] = '\0';
+
+        /*
+         * Build parent directories iteratively. This simple approach
+         * avoids calling an external 'mkdir -p' and works with
+         * relative and absolute paths. Note: we only attempt to create
+         * directories and ignore EEXIST to allow concurrent runs.
+         */
+        char tmp[PATH_MAX];
+        tmp[0] = '\0';
+        for (char *p = dirbuf; *p; p++) {
+            size_t len = strlen(tmp);
+            tmp[len] = *p;
+            tmp[len+1] = '\0';
+            if (*p == '/') {
+                if (mkdir(tmp, 0755) < 0 && errno != EEXIST) {
+                    /* ignore errors here; we'll detect write failure below */
+                }
+            }
+        }
+        /* Final directory create (in case path didn't end with a slash) */
+        if (strlen(tmp) > 0) {
+            if (mkdir(tmp, 0755) < 0 && errno != EEXIST) {
+                /* ignore, will be reported when the write fails */
+            }
+        }
+    }
+}
+
+/*
+ * write_png_native
+ * ----------------
+ * Encode with the native palette writer and write the bytes to
+ * `filename`. Returns NULL on success or a short error description.
+ */
+static const char *write_png_native(const Bitmap *bm, const char *filename) {
+    unsigned char *png = NULL;
+    size_t len = 0;
+    int ncolors = bm->nb_colors > 0 ? bm->nb_colors : 16;
+    if (png_encode_indexed(bm->idxbuf, bm->w, bm->h, bm->w, bm->palette, ncolors,
+                           &writer_opts, &png, &len) != 0)
+        return "PNG encoding failed";
+    const char *err = NULL;
+    FILE *f = fopen(filename, "wb");
+    if (!f) {
+        err = strerror(errno);
+    } else {
+        if (fwrite(png, 1, len, f) != len) err = strerror(errno);
+        if (fclose(f) != 0 && !err) err = strerror(errno);
+    }
+    free(png);
+    return err;
+}
+
 /*
  * save_bitmap_png
  * ----------------
@@ -77,6 +154,9 @@
  *              directories when possible.
  *
  * Behavior and guarantees:
+ *   - By default the native palette writer (png_writer.c) encodes the
+ *     indices directly; debug_png_set_writer() can select the Cairo
+ *     ARGB path instead.
  *   - This helper is intended only for debugging and is non-fatal.
  *   - On success it writes a PNG and prints a one-line status to
  *     stderr. On failure it prints an explanatory message to stderr.
@@ -91,84 +171,54 @@ void save_bitmap_png(const Bitmap *bm, const char *filename) {
      */
     if (!bm || !bm->idxbuf || !bm->palette) return;
 
-    /*
-     * Create a temporary ARGB Cairo image surface sized to the
-     * bitmap dimensions. We'll expand the 16-color palette indices
-     * into full 32-bit ARGB pixels on this surface and then ask
-     * Cairo to write the surface to a PNG file.
-     */
-    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, bm->w, bm->h);
-    if (!surface || cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
-        if (surface) cairo_surface_destroy(surface);
-        return; /* debug helper: bail quietly on surface creation failure */
-    }
-    unsigned char *data = cairo_image_surface_get_data(surface);
-    if (!data) {
-        cairo_surface_destroy(surface);
-        return;
-    }
-    int stride = cairo_image_surface_get_stride(surface);
-
-    /*
-     * Expand palette indices into ARGB pixel values row-by-row. The
-     * bitmap's idxbuf is indexed [y * width + x] and contains palette
-     * entries (0..15). We copy the 32-bit palette word directly into
-     * the Cairo surface memory (native endianness assumed).
-     */
-    for (int y = 0; y < bm->h; y++) {
-        for (int x = 0; x < bm->w; x++) {
-            uint8_t idx = bm->idxbuf[y * bm->w + x];
-            uint32_t argb = bm->palette[idx];
-            /* write as 32-bit pixel using surface stride */
-            *(uint32_t *)(data + y * stride + x * 4) = argb;
+    const char *err = NULL;
+    if (!use_cairo_writer) {
+        ensure_parent_dirs(filename);
+        err = write_png_native(bm, filename);
+    } else {
+        /*
+         * Create a temporary ARGB Cairo image surface sized to the
+         * bitmap dimensions. We'll expand the 16-color palette indices
+         * into full 32-bit ARGB pixels on this surface and then ask
+         * Cairo to write the surface to a PNG file.
+         */
+        cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, bm->w, bm->h);
+        if (!surface || cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+            if (surface) cairo_surface_destroy(surface);
+            return; /* debug helper: bail quietly on surface creation failure */
         }
-    }
-
-    /* Tell Cairo that we modified the surface pixels directly. */
-    cairo_surface_mark_dirty(surface);
-
-    /*
-     * Ensure parent directory exists by attempting to create each
-     * parent path component. We tolerate failures here and rely on
-     * Cairo's write call to report an error if writing ultimately fails.
-     */
-    char *dirend = strrchr(filename, '/');
-    if (dirend) {
-        size_t dirlen = dirend - filename;
-        char dirbuf[PATH_MAX];
-        if (dirlen >= sizeof(dirbuf)) dirlen = sizeof(dirbuf)-1;
-        memcpy(dirbuf, filename, dirlen);
-        dirbuf[dirlen] = '\0';
+        unsigned char *data = cairo_image_surface_get_data(surface);
+        if (!data) {
+            cairo_surface_destroy(surface);
+            return;
+        }
+        int stride = cairo_image_surface_get_stride(surface);
 
         /*
-         * Build parent directories iteratively. This simple approach
-         * avoids calling an external 'mkdir -p' and works with
-         * relative and absolute paths. Note: we only attempt to create
-         * directories and ignore EEXIST to allow concurrent runs.
+         * Expand palette indices into ARGB pixel values row-by-row. The
+         * bitmap's idxbuf is indexed [y * width + x] and contains palette
+         * entries (0..15). We copy the 32-bit palette word directly into
+         * the Cairo surface memory (native endianness assumed).
          */
-        char tmp[PATH_MAX];
-        tmp[0] = '\0';
-        for (char *p = dirbuf; *p; p++) {
-            size_t len = strlen(tmp);
-            tmp[len] = *p;
-            tmp[len+1] = '\0';
-            if (*p == '/') {
-                if (mkdir(tmp, 0755) < 0 && errno != EEXIST) {
-                    /* ignore errors here; we'll detect write failure below */
-                }
+        for (int y = 0; y < bm->h; y++) {
+            for (int x = 0; x < bm->w; x++) {
+                uint8_t idx = bm->idxbuf[y * bm->w + x];
+                uint32_t argb = bm->palette[idx];
+                /* write as 32-bit pixel using surface stride */
+                *(uint32_t *)(data + y * stride + x * 4) = argb;
             }
         }
-        /* Final directory create (in case path didn't end with a slash) */
-        if (strlen(tmp) > 0) {
-            if (mkdir(tmp, 0755) < 0 && errno != EEXIST) {
-                /* ignore, will be reported by cairo if write fails */
-            }
-        }
-    }
 
-    /* Ask Cairo to write the surface to PNG and free the surface. */
-    cairo_status_t status = cairo_surface_write_to_png(surface, filename);
-    cairo_surface_destroy(surface);
+        /* Tell Cairo that we modified the surface pixels directly. */
+        cairo_surface_mark_dirty(surface);
+        ensure_parent_dirs(filename);
+
+        /* Ask Cairo to write the surface to PNG and free the surface. */
+        cairo_status_t status = cairo_surface_write_to_png(surface, filename);
+        cairo_surface_destroy(surface);
+        if (status != CAIRO_STATUS_SUCCESS)
+            err = cairo_status_to_string(status);
+    }
 
     /*
      * Print an informative message to stderr including the full
@@ -181,25 +231,97 @@ void save_bitmap_png(const Bitmap *bm, const char *filename) {
             char *expected_alloc = malloc(need);
             if (expected_alloc) {
                 snprintf(expected_alloc, need, "%s/%s", fullpath, filename);
-                if (status == CAIRO_STATUS_SUCCESS) {
+                if (!err) {
                     LOG(1, "Wrote debug PNG: %s (expected %s)\n", filename, expected_alloc);
                 } else {
-                    const char *s = cairo_status_to_string(status);
-                    LOG(1, "Failed to write PNG %s: %s (expected %s)\n", filename, s, expected_alloc);
+                    LOG(1, "Failed to write PNG %s: %s (expected %s)\n", filename, err, expected_alloc);
                 }
                 free(expected_alloc);
             } else {
                 /* If allocation fails, still print a minimal status string. */
-                if (status == CAIRO_STATUS_SUCCESS)
+                if (!err)
                     LOG(1, "Wrote debug PNG: %s\n", filename);
                 else
-                    LOG(1, "Failed to write PNG %s: %s\n", filename, cairo_status_to_string(status));
+                    LOG(1, "Failed to write PNG %s: %s\n", filename, err);
         }
     } else {
         /* getcwd failed — print the basic status message */
-        if (status == CAIRO_STATUS_SUCCESS)
+        if (!err)
             LOG(1, "Wrote debug PNG: %s\n", filename);
         else
-            LOG(1, "Failed to write PNG %s: %s\n", filename, cairo_status_to_string(status));
+            LOG(1, "Failed to write PNG %s: %s\n", filename, err);
+    }
+}
+/* Growable byte sink for cairo_surface_write_to_png_stream(). */
+typedef struct {
+    unsigned char *data;
+    size_t len;
+    size_t cap;
+} PngMemSink;
+
+static cairo_status_t png_mem_write(void *closure, const unsigned char *buf, unsigned int n) {
+    PngMemSink *sink = closure;
+    if (sink->len + n > sink->cap) {
+        size_t cap = sink->cap ? sink->cap : 4096;
+        while (cap < sink->len + n) cap *= 2;
+        unsigned char *p = realloc(sink->data, cap);
+        if (!p) return CAIRO_STATUS_NO_MEMORY;
+        sink->data = p;
+        sink->cap = cap;
+    }
+    memcpy(sink->data + sink->len, buf, n);
+    sink->len += n;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/*
+ * encode_bitmap_png
+ * -----------------
+ * In-memory variant of save_bitmap_png(): encode the indexed Bitmap as
+ * PNG into a malloc()ed buffer with the same writer. Used by callers
+ * that ship PNG bytes instead of writing files (e.g. the render daemon).
+ *
+ * Returns 0 on success with *out/*out_len set (caller frees *out), or -1
+ * on invalid input or encoder failure.
+ */
+int encode_bitmap_png(const Bitmap *bm, unsigned char **out, size_t *out_len) {
+    if (!out || !out_len) return -1;
+    *out = NULL;
+    *out_len = 0;
+    if (!bm || !bm->idxbuf || !bm->palette || bm->w <= 0 || bm->h <= 0) return -1;
+    if (!use_cairo_writer) {
+        int ncolors = bm->nb_colors > 0 ? bm->nb_colors : 16;
+        return png_encode_indexed(bm->idxbuf, bm->w, bm->h, bm->w, bm->palette, ncolors,
+                                  &writer_opts, out, out_len);
+    }
+
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, bm->w, bm->h);
+    if (!surface || cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+        if (surface) cairo_surface_destroy(surface);
+        return -1;
+    }
+    unsigned char *data = cairo_image_surface_get_data(surface);
+    if (!data) {
+        cairo_surface_destroy(surface);
+        return -1;
+    }
+    int stride = cairo_image_surface_get_stride(surface);
+    for (int y = 0; y < bm->h; y++) {
+        uint32_t *row = (uint32_t *)(data + y * stride);
+        const uint8_t *src = bm->idxbuf + (size_t)y * bm->w;
+        for (int x = 0; x < bm->w; x++)
+            row[x] = bm->palette[src[x]];
+    }
+    cairo_surface_mark_dirty(surface);
+
+    PngMemSink sink = {0};
+    cairo_status_t status = cairo_surface_write_to_png_stream(surface, png_mem_write, &sink);
+    cairo_surface_destroy(surface);
+    if (status != CAIRO_STATUS_SUCCESS) {
+        free(sink.data);
+        return -1;
     }
-}
\ No newline at end of file
+    *out = sink.data;
+    *out_len = sink.len;
+    return 0;
+}
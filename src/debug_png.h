@@ -49,6 +49,7 @@
 #define DEBUG_PNG_H
 
 #include "render_pango.h"
+#include "png_writer.h"
 
 /**
  * @file debug_png.h
@@ -85,10 +86,31 @@
  *                 possible.
  *
  * Behavior:
- *   - Creates an ARGB Cairo surface, expands palette indices into
- *     ARGB pixels, writes the PNG, and prints a status message to
- *     stderr. On failure, an explanatory message is also printed.
+ *   - Encodes a palette PNG straight from the indices (or, with the
+ *     Cairo writer selected, expands to ARGB and lets Cairo write it),
+ *     and prints a status message to stderr. On failure, an
+ *     explanatory message is also printed.
  */
 void save_bitmap_png(const Bitmap *bm, const char *filename);
 
+/**
+ * Encode a rendered Bitmap as PNG into memory.
+ *
+ * @param bm      Bitmap with valid `idxbuf` and `palette`.
+ * @param out     Receives a malloc()ed buffer holding the PNG stream.
+ * @param out_len Receives the size of `*out` in bytes.
+ * @return 0 on success (caller frees `*out`), -1 on failure.
+ */
+int encode_bitmap_png(const Bitmap *bm, unsigned char **out, size_t *out_len);
+
+/**
+ * Select the PNG writer for save_bitmap_png()/encode_bitmap_png().
+ * Call once at startup, before any render threads write PNGs.
+ *
+ * @param use_cairo Non-zero: expand to ARGB and write with Cairo.
+ *                  Zero (default): native palette writer.
+ * @param opt       Native writer settings, or NULL for the defaults.
+ */
+void debug_png_set_writer(int use_cairo, const PngWriterOptions *opt);
+
 #endif
\ No newline at end of file
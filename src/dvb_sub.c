@@ -50,10 +50,12 @@
 #include "dvb_sub.h"
 #include "alloc_utils.h"
 #include "pool_alloc.h"
+#include "clut_cache.h"
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include <limits.h>
+#include <stdatomic.h>
 #include <libavutil/mem.h>
 
 
@@ -131,6 +133,51 @@ void free_subtitle(AVSubtitle **psub) {
     av_freep(psub);
 }
 
+/* Post-quantisation palette fit in make_subtitle(); cleared by
+ * --no-adaptive-depth. */
+static atomic_int adaptive_depth = 1;
+
+void dvb_sub_set_adaptive_depth(int enable) {
+    atomic_store(&adaptive_depth, enable ? 1 : 0);
+}
+
+/* CLUT colorimetry (ClutColorimetry, never AUTO here); set from
+ * --colorimetry once the video stream is known. */
+static atomic_int clut_colorimetry = CLUT_COLORIMETRY_BT601;
+
+void dvb_sub_set_colorimetry(ClutColorimetry cm) {
+    atomic_store(&clut_colorimetry,
+                 cm == CLUT_COLORIMETRY_BT709 ? CLUT_COLORIMETRY_BT709 : CLUT_COLORIMETRY_BT601);
+}
+
+int dvb_sub_depth_bits(int nb_colors) {
+    return nb_colors <= 4 ? 2 : (nb_colors <= 16 ? 4 : 8);
+}
+
+/*
+ * dvb_sub_fit_palette
+ * -------------------
+ * One pass marks the indices present in the plane; used indices are then
+ * numbered in ascending order, which keeps a used background index 0 at
+ * slot 0. The caller applies `remap` while copying the plane.
+ */
+int dvb_sub_fit_palette(const uint8_t *idx, size_t n, const uint32_t *palette,
+                        int nb_colors, uint8_t remap[256], uint32_t out_palette[256]) {
+    uint8_t seen[256] = {0};
+    for (size_t i = 0; i < n; i++)
+        seen[idx[i]] = 1;
+    int used = 0;
+    for (int v = 0; v < 256; v++) {
+        if (!seen[v]) {
+            remap[v] = 0;
+            continue;
+        }
+        remap[v] = (uint8_t)used;
+        out_palette[used++] = (palette && v < nb_colors) ? palette[v] : 0;
+    }
+    return used;
+}
+
 /*
  * make_subtitle
  * -------------
@@ -148,6 +195,10 @@ void free_subtitle(AVSubtitle **psub) {
  *    which encoders interpret as a clear/blank subtitle event.
  */
 AVSubtitle* make_subtitle(Bitmap bm, int64_t start_ms, int64_t end_ms) {
+    return make_subtitle_depth(bm, start_ms, end_ms, atomic_load(&adaptive_depth));
+}
+
+AVSubtitle* make_subtitle_depth(Bitmap bm, int64_t start_ms, int64_t end_ms, int adaptive) {
     /*
      * make_subtitle
      * ------------
@@ -272,7 +323,50 @@ AVSubtitle* make_subtitle(Bitmap bm, int64_t start_ms, int64_t end_ms) {
         free_sub_and_rects(sub);
         return NULL;
     }
-    memcpy(r->data[0], bm.idxbuf, pixel_count);
+
+    /* CLUT colorimetry: for BT.709 substitute the cached encoder palette
+     * (see clut_cache.h); BT.601 is the encoder's own conversion. */
+    const uint32_t *src_palette = bm.palette;
+    uint32_t converted[256];
+    if (atomic_load(&clut_colorimetry) == CLUT_COLORIMETRY_BT709 && bm.palette &&
+        bm.palette_bytes >= (size_t)r->nb_colors * 4u) {
+        const ClutCacheEntry *ce = clut_cache_get(bm.palette, r->nb_colors,
+                                                  CLUT_COLORIMETRY_BT709);
+        if (ce) {
+            src_palette = ce->encoder_argb;
+        } else {
+            clut_encoder_palette(bm.palette, r->nb_colors, CLUT_COLORIMETRY_BT709, converted);
+            src_palette = converted;
+        }
+    }
+
+    /* Adaptive depth: when the cue uses fewer palette entries than it
+     * carries, compact the indices and shrink nb_colors. The dvbsub
+     * encoder picks the region depth and CLUT entry flags from
+     * nb_colors (<=4: 2-bit, <=16: 4-bit, else 8-bit), so a plain
+     * white-on-black cue drops to 2-bit pixel data and a 3-4 entry
+     * CLUT. */
+    uint8_t remap[256];
+    uint32_t fitted[256];
+    int fitted_palette = 0;
+    if (adaptive && bm.palette && bm.palette_bytes >= (size_t)r->nb_colors * 4u) {
+        int used = dvb_sub_fit_palette(bm.idxbuf, pixel_count, src_palette,
+                                       r->nb_colors, remap, fitted);
+        if (used > 0 && used < r->nb_colors) {
+            LOG(4, "palette fit: %d -> %d colours (%d-bit)\n",
+                r->nb_colors, used, dvb_sub_depth_bits(used));
+            r->nb_colors = used;
+            fitted_palette = 1;
+        }
+    }
+    if (fitted_palette) {
+        const uint8_t *src = bm.idxbuf;
+        uint8_t *dst = r->data[0];
+        for (size_t i = 0; i < pixel_count; i++)
+            dst[i] = remap[src[i]];
+    } else {
+        memcpy(r->data[0], bm.idxbuf, pixel_count);
+    }
 
     /*
      * Palette plane: allocate up to AVPALETTE_SIZE bytes and copy the
@@ -289,13 +383,15 @@ AVSubtitle* make_subtitle(Bitmap bm, int64_t start_ms, int64_t end_ms) {
             free_sub_and_rects(sub);
             return NULL;
         }
-        if (bm.palette) {
+        if (fitted_palette) {
+            memcpy(r->data[1], fitted, palette_bytes);
+        } else if (bm.palette) {
             if (bm.palette_bytes < palette_bytes) {
                 LOG(1, "palette too small: have=%zu need=%zu\n", bm.palette_bytes, palette_bytes);
                 free_sub_and_rects(sub);
                 return NULL;
             }
-            memcpy(r->data[1], bm.palette, palette_bytes);
+            memcpy(r->data[1], src_palette, palette_bytes);
         }
     } else {
         r->data[1] = NULL;
@@ -313,4 +409,43 @@ AVSubtitle* make_subtitle(Bitmap bm, int64_t start_ms, int64_t end_ms) {
     sub->end_display_time = (unsigned)dur;
 
     return sub;
-}
\ No newline at end of file
+}
+
+/*
+ * dvb_sub_restamp_versions
+ * ------------------------
+ * Segment layout (ETSI EN 300 743): sync_byte 0x0f, segment_type,
+ * page_id (16), segment_length (16), payload. The version nibble sits in
+ * the high 4 bits of payload byte 1 for page (0x10) and region (0x11)
+ * composition segments and of payload byte 2 for object data (0x13).
+ * CLUT and display definition versions are left untouched; the encoder
+ * does not vary them.
+ */
+int dvb_sub_restamp_versions(uint8_t *buf, int size, int version) {
+    if (!buf || size <= 0) return 0;
+    int pos = 0;
+    int stamped = 0;
+    uint8_t v = (uint8_t)((version & 0x0f) << 4);
+
+    if (size >= 2 && buf[0] == 0x20 && buf[1] == 0x00)
+        pos = 2;
+
+    while (pos + 6 <= size && buf[pos] == 0x0f) {
+        int type = buf[pos + 1];
+        int seg_len = (buf[pos + 4] << 8) | buf[pos + 5];
+        int payload = pos + 6;
+        if (payload + seg_len > size)
+            break;
+        int off = -1;
+        if (type == 0x10 || type == 0x11)
+            off = 1;
+        else if (type == 0x13)
+            off = 2;
+        if (off >= 0 && off < seg_len) {
+            buf[payload + off] = (uint8_t)((buf[payload + off] & 0x0f) | v);
+            stamped++;
+        }
+        pos = payload + seg_len;
+    }
+    return stamped;
+}
@@ -51,6 +51,7 @@
 
 #include <libavcodec/avcodec.h>
 #include "render_pango.h"
+#include "clut_cache.h"
 
 /**
  * @file dvb_sub.h
@@ -89,6 +90,48 @@
  */
 AVSubtitle* make_subtitle(Bitmap bm, int64_t start_ms, int64_t end_ms);
 
+/**
+ * make_subtitle_depth
+ *
+ * @brief make_subtitle() with the adaptive palette depth chosen per call.
+ *
+ * With `adaptive` non-zero the indices actually present in the bitmap are
+ * counted and compacted, and the rect's nb_colors is set to that count so
+ * the encoder emits a 2-bit (<=4 colours), 4-bit (<=16) or 8-bit region
+ * with a CLUT of just those entries. make_subtitle() uses the process-wide
+ * setting from dvb_sub_set_adaptive_depth() (on by default).
+ */
+AVSubtitle* make_subtitle_depth(Bitmap bm, int64_t start_ms, int64_t end_ms, int adaptive);
+
+/** Enable (default) or disable the adaptive depth in make_subtitle(). */
+void dvb_sub_set_adaptive_depth(int enable);
+
+/**
+ * Select the CLUT colorimetry used by make_subtitle(). BT.601 (default)
+ * passes palettes through to the encoder; BT.709 substitutes the cached
+ * encoder palette from clut_cache_get(). AUTO must be resolved first and
+ * is treated as BT.601.
+ */
+void dvb_sub_set_colorimetry(ClutColorimetry cm);
+
+/** DVB region depth in bits (2, 4 or 8) for a CLUT of `nb_colors`. */
+int dvb_sub_depth_bits(int nb_colors);
+
+/**
+ * dvb_sub_fit_palette
+ *
+ * @brief Compact the palette of an index plane to the entries it uses.
+ *
+ * @param idx          Index plane of `n` pixels.
+ * @param palette      Source palette of `nb_colors` ARGB entries (may be NULL).
+ * @param remap        Receives the new index for every used source index.
+ * @param out_palette  Receives the compacted palette; indices at or above
+ *                     `nb_colors` map to transparent entries.
+ * @return Number of distinct indices used, i.e. the compacted size.
+ */
+int dvb_sub_fit_palette(const uint8_t *idx, size_t n, const uint32_t *palette,
+                        int nb_colors, uint8_t remap[256], uint32_t out_palette[256]);
+
 /**
  * free_subtitle
  * 
@@ -109,4 +152,27 @@ AVSubtitle* make_subtitle(Bitmap bm, int64_t start_ms, int64_t end_ms);
  */
 void free_subtitle(AVSubtitle **psub);
 
+/**
+ * dvb_sub_restamp_versions
+ *
+ * @brief Rewrite the version nibbles of an encoded DVB subtitle payload.
+ *
+ * FFmpeg's dvbsub encoder keeps a 4-bit version counter per encoder
+ * context and stamps it into the page, region and object segments. When
+ * payloads for one stream come from several encoder contexts (e.g. one
+ * per render worker) the counters diverge and consecutive display sets
+ * can repeat a version, which receivers treat as "unchanged". The mux
+ * thread therefore re-stamps every payload with the stream's own counter
+ * before writing it.
+ *
+ * Walks the segment chain (optionally prefixed by the 0x20 0x00 PES data
+ * identifier) and stops at the first malformed segment.
+ *
+ * @param buf     Encoded payload, modified in place.
+ * @param size    Payload size in bytes.
+ * @param version Version number to store (only the low 4 bits are used).
+ * @return Number of segments re-stamped.
+ */
+int dvb_sub_restamp_versions(uint8_t *buf, int size, int version);
+
 #endif
\ No newline at end of file
@@ -78,6 +78,7 @@
 #include "bench.h"
 #include "mux_write.h"
 #include "utils.h"
+#include "frame_timing.h"
 
 
 /* Provide a short module name for LOG() */
@@ -1040,9 +1041,9 @@ int main(int argc, char **argv) {
 
                     // Use absolute PTS for subtitles, but apply frame rate scaling
                     if (dst_fps > 0.0 && src_fps > 0.0) {
-                        double scale = src_fps / dst_fps;
-                        pts90 = (int64_t)llround((double)pts90 * scale);
-                        if (debug_level > 0) fprintf(stderr, "Scaled pts90 by %f -> %lld\n", scale, (long long)pts90);
+                        pts90 = frame_rate_convert_ts(pts90, frame_rate_from_double(src_fps),
+                                                      frame_rate_from_double(dst_fps));
+                        if (debug_level > 0) fprintf(stderr, "Scaled pts90 by %f/%f -> %lld\n", src_fps, dst_fps, (long long)pts90);
                     }
                     pts90 += (tracks[ti].effective_delay_ms * 90);
                     if (debug_level > 0) fprintf(stderr, "Encoding immediate event for track %d at pts %lld\n", ti, (long long)pts90);
@@ -1266,9 +1267,9 @@ int main(int argc, char **argv) {
                 }
                 // Use absolute PTS for flush subtitles, but apply frame rate scaling
                 if (dst_fps > 0.0 && src_fps > 0.0) {
-                    double scale = src_fps / dst_fps;
-                    pts90 = (int64_t)llround((double)pts90 * scale);
-                    if (debug_level > 0) fprintf(stderr, "Scaled flush pts90 by %f -> %lld\n", scale, (long long)pts90);
+                    pts90 = frame_rate_convert_ts(pts90, frame_rate_from_double(src_fps),
+                                                  frame_rate_from_double(dst_fps));
+                    if (debug_level > 0) fprintf(stderr, "Scaled flush pts90 by %f/%f -> %lld\n", src_fps, dst_fps, (long long)pts90);
                 }
                 pts90 += (tracks[ti].effective_delay_ms * 90);
             encode_and_write_subtitle(tracks[ti].codec_ctx, out_fmt, &tracks[ti], dvb_sub, pts90, bench_mode, NULL);
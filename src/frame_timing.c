@@ -0,0 +1,201 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * frame_timing.c
+ * --------------
+ * Frame-grid snapping and frame-rate conversion for parsed cues. All
+ * arithmetic is done on 64-bit integers in 90 kHz units so x/1001 rates
+ * accumulate no drift across long programmes.
+ */
+
+#include "frame_timing.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <errno.h>
+
+/* Division rounding towards negative / positive infinity (d > 0). */
+static int64_t floor_div(int64_t n, int64_t d) {
+    int64_t q = n / d;
+    if ((n % d) != 0 && n < 0) q--;
+    return q;
+}
+
+static int64_t ceil_div(int64_t n, int64_t d) {
+    int64_t q = n / d;
+    if ((n % d) != 0 && n > 0) q++;
+    return q;
+}
+
+FrameRate frame_rate_from_double(double fps) {
+    static const struct { double fps; FrameRate fr; } ntsc[] = {
+        { 23.976, { 24000, 1001 } },
+        { 29.97,  { 30000, 1001 } },
+        { 47.952, { 48000, 1001 } },
+        { 59.94,  { 60000, 1001 } },
+        { 119.88, { 120000, 1001 } },
+    };
+    FrameRate fr = { 0, 1 };
+    if (!(fps > 0.0) || fps > 1000.0) return fr;
+    for (size_t i = 0; i < sizeof(ntsc) / sizeof(ntsc[0]); i++) {
+        if (fabs(fps - ntsc[i].fps) < 0.005) return ntsc[i].fr;
+    }
+    if (fabs(fps - floor(fps + 0.5)) < 0.0005) {
+        fr.num = (int)floor(fps + 0.5);
+        return fr;
+    }
+    fr.num = (int)llround(fps * 1000.0);
+    fr.den = 1000;
+    return fr;
+}
+
+int frame_rate_parse(const char *s, FrameRate *out) {
+    if (!s || !*s || !out) return -1;
+    const char *slash = strchr(s, '/');
+    char *end = NULL;
+    if (slash) {
+        errno = 0;
+        long num = strtol(s, &end, 10);
+        if (errno || end != slash || num <= 0 || num > 1000000) return -1;
+        long den = strtol(slash + 1, &end, 10);
+        if (errno || *end || den <= 0 || den > 1000000) return -1;
+        out->num = (int)num;
+        out->den = (int)den;
+        return 0;
+    }
+    errno = 0;
+    double fps = strtod(s, &end);
+    if (errno || end == s || *end) return -1;
+    FrameRate fr = frame_rate_from_double(fps);
+    if (fr.num <= 0) return -1;
+    *out = fr;
+    return 0;
+}
+
+int frame_snap_mode_parse(const char *s, FrameSnapMode *out) {
+    if (!s || !out) return -1;
+    if (strcasecmp(s, "off") == 0) *out = FRAME_SNAP_OFF;
+    else if (strcasecmp(s, "nearest") == 0) *out = FRAME_SNAP_NEAREST;
+    else if (strcasecmp(s, "floor") == 0) *out = FRAME_SNAP_FLOOR;
+    else if (strcasecmp(s, "ceil") == 0) *out = FRAME_SNAP_CEIL;
+    else return -1;
+    return 0;
+}
+
+int frame_rate_conversion_parse(const char *s, FrameRate *src, FrameRate *dst) {
+    if (!s || !src || !dst) return -1;
+    const char *colon = strchr(s, ':');
+    if (!colon || colon == s || !colon[1]) return -1;
+    char left[64];
+    size_t n = (size_t)(colon - s);
+    if (n >= sizeof(left)) return -1;
+    memcpy(left, s, n);
+    left[n] = '\0';
+    if (frame_rate_parse(left, src) != 0) return -1;
+    if (frame_rate_parse(colon + 1, dst) != 0) return -1;
+    return 0;
+}
+
+int64_t frame_rate_convert_ts(int64_t t, FrameRate src, FrameRate dst) {
+    if (src.num <= 0 || src.den <= 0 || dst.num <= 0 || dst.den <= 0) return t;
+    /* t * (src.num/src.den) / (dst.num/dst.den), rounded to nearest */
+    int64_t n = (int64_t)src.num * dst.den;
+    int64_t d = (int64_t)src.den * dst.num;
+    if (n == d) return t;
+    return floor_div(2 * t * n + d, 2 * d);
+}
+
+int64_t frame_timing_snap90(const FrameTiming *ft, int64_t t90) {
+    if (!ft || ft->mode == FRAME_SNAP_OFF || ft->grid.num <= 0 || ft->grid.den <= 0)
+        return t90;
+    const int64_t num = ft->grid.num;
+    const int64_t D = 90000LL * ft->grid.den; /* frame k starts at origin + k*D/num */
+    int64_t N = (t90 - ft->origin90) * num;
+    int64_t k;
+    switch (ft->mode) {
+    case FRAME_SNAP_FLOOR: k = floor_div(N, D); break;
+    case FRAME_SNAP_CEIL:  k = ceil_div(N, D); break;
+    default:               k = floor_div(2 * N + D, 2 * D); break;
+    }
+    return ft->origin90 + ceil_div(k * D, num);
+}
+
+int frame_timing_apply(const FrameTiming *ft, SRTEntry *entries, int count, int64_t delay_ms,
+                       int64_t *start90, int64_t *end90) {
+    if (!entries || count <= 0) return 0;
+    const int convert = ft && ft->conv_src.num > 0 && ft->conv_dst.num > 0;
+    const int snap = ft && ft->mode != FRAME_SNAP_OFF && ft->grid.num > 0 && ft->grid.den > 0;
+
+    const int64_t frame90 = snap ? ceil_div(90000LL * ft->grid.den, ft->grid.num) : 0;
+    int changed = 0;
+    for (int i = 0; i < count; i++) {
+        int64_t s = entries[i].start_ms;
+        int64_t e = entries[i].end_ms;
+        if (convert) {
+            s = frame_rate_convert_ts(s, ft->conv_src, ft->conv_dst);
+            e = frame_rate_convert_ts(e, ft->conv_src, ft->conv_dst);
+        }
+        int64_t s90 = (s + delay_ms) * 90;
+        int64_t e90 = (e + delay_ms) * 90;
+        if (snap) {
+            s90 = frame_timing_snap90(ft, s90);
+            e90 = frame_timing_snap90(ft, e90);
+            if (e90 < s90 + frame90) e90 = s90 + frame90;
+            s = ceil_div(s90, 90) - delay_ms;
+            e = ceil_div(e90, 90) - delay_ms;
+        }
+        if (start90) start90[i] = s90;
+        if (end90) end90[i] = e90;
+        if (s != entries[i].start_ms || e != entries[i].end_ms) changed++;
+        entries[i].start_ms = s;
+        entries[i].end_ms = e;
+    }
+    return changed;
+}
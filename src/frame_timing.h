@@ -0,0 +1,145 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+#pragma once
+#ifndef FRAME_TIMING_H
+#define FRAME_TIMING_H
+
+#include <stdint.h>
+#include "srt_parser.h"
+
+/**
+ * @file frame_timing.h
+ * @brief Frame-grid aware cue timing (snapping and frame-rate conversion).
+ *
+ * SRT cues are millisecond based while the video advances in whole
+ * frames. This module moves cue start/end times onto the video's frame
+ * grid so DVB display sets begin exactly on a frame boundary, and
+ * converts cue timelines between frame rates (e.g. 23.976 <-> 25 fps
+ * PAL speed-up) using exact rational arithmetic.
+ *
+ * The stage runs once per track, right after parsing, as a tight pass
+ * over the entry array. It produces the exact 90 kHz emission time of
+ * each cue, which cue_timeline.h stores so the demux loop compares
+ * against a table instead of multiplying per packet.
+ */
+
+/** Exact frame rate as a rational (e.g. 24000/1001). */
+typedef struct {
+    int num;
+    int den;
+} FrameRate;
+
+/** Rounding used when a cue time falls between two frame boundaries. */
+typedef enum {
+    FRAME_SNAP_OFF = 0,     /**< keep millisecond timing (legacy behaviour) */
+    FRAME_SNAP_NEAREST = 1, /**< closest boundary */
+    FRAME_SNAP_FLOOR = 2,   /**< boundary at or before the cue time */
+    FRAME_SNAP_CEIL = 3     /**< boundary at or after the cue time */
+} FrameSnapMode;
+
+/** Per-track timing stage configuration. */
+typedef struct {
+    FrameRate grid;       /**< video frame rate; num == 0 disables snapping */
+    int64_t origin90;     /**< first frame boundary relative to cue time zero (90 kHz) */
+    FrameSnapMode mode;   /**< snapping rounding mode */
+    FrameRate conv_src;   /**< frame rate the cues were authored for (num == 0: none) */
+    FrameRate conv_dst;   /**< frame rate of the target video */
+} FrameTiming;
+
+/**
+ * Parse "25", "23.976", "29.97" or "24000/1001". Decimal NTSC rates
+ * (23.976, 29.97, 59.94, 47.952, 119.88) map to their exact x/1001 form.
+ *
+ * @return 0 on success, -1 on malformed or non-positive input.
+ */
+int frame_rate_parse(const char *s, FrameRate *out);
+
+/** Convert a floating frame rate using the same NTSC mapping. */
+FrameRate frame_rate_from_double(double fps);
+
+/** Parse "off", "nearest", "floor" or "ceil". Returns 0 on success. */
+int frame_snap_mode_parse(const char *s, FrameSnapMode *out);
+
+/**
+ * Parse a conversion spec "SRC:DST" (e.g. "23.976:25").
+ *
+ * @return 0 on success, -1 on malformed input.
+ */
+int frame_rate_conversion_parse(const char *s, FrameRate *src, FrameRate *dst);
+
+/** Rescale a timestamp from a `src` timeline to a `dst` timeline (t * src/dst). */
+int64_t frame_rate_convert_ts(int64_t t, FrameRate src, FrameRate dst);
+
+/**
+ * Snap a 90 kHz timestamp onto the grid. Boundaries that are not
+ * integral in 90 kHz (x/1001 rates) are rounded up, so a snapped time
+ * never precedes the true frame start.
+ */
+int64_t frame_timing_snap90(const FrameTiming *ft, int64_t t90);
+
+/**
+ * Apply rate conversion and snapping to `entries` in place.
+ *
+ * `delay_ms` is the track delay added at emission time; snapping acts
+ * on the emitted time (start + delay) so the delayed cue lands on the
+ * grid. Every cue keeps at least one frame of duration.
+ *
+ * Snapped boundaries are generally not whole milliseconds (x/1001 rates,
+ * origins that are not a multiple of 90), so the exact emitted times are
+ * written to `start90`/`end90` in 90 kHz ticks relative to cue time zero
+ * (delay included). Those are the values to stamp on packets; the
+ * millisecond fields are only rounded for durations and reports. Either
+ * array may be NULL. With neither conversion nor snapping active they
+ * receive `(ms + delay_ms) * 90`.
+ *
+ * @return number of cues whose start or end changed.
+ */
+int frame_timing_apply(const FrameTiming *ft, SRTEntry *entries, int count, int64_t delay_ms,
+                       int64_t *start90, int64_t *end90);
+
+#endif /* FRAME_TIMING_H */
@@ -0,0 +1,243 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * glyph_atlas.c
+ * -------------
+ * Open-addressing cache of glyph coverage tiles plus the downsample and
+ * OVER-composite helpers used by the render_text_pango() fast path.
+ * Each tile is a single allocation (header + three planes).
+ */
+
+#include "glyph_atlas.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct GlyphAtlas {
+    GlyphTile **slots; /* power-of-two open-addressing table */
+    int cap;
+    int count;
+    int max_tiles;
+    uint64_t hits, misses;
+};
+
+static uint64_t slot_hash(uint64_t key, uint32_t glyph, int phase) {
+    uint64_t h = key ^ ((uint64_t)glyph * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)phase;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+GlyphAtlas *glyph_atlas_create(int max_tiles) {
+    GlyphAtlas *a = calloc(1, sizeof(*a));
+    if (!a) return NULL;
+    a->max_tiles = max_tiles > 0 ? max_tiles : 1024;
+    a->cap = 256;
+    a->slots = calloc((size_t)a->cap, sizeof(GlyphTile *));
+    if (!a->slots) {
+        free(a);
+        return NULL;
+    }
+    return a;
+}
+
+static void free_tiles(GlyphAtlas *a) {
+    for (int i = 0; i < a->cap; i++) {
+        free(a->slots[i]);
+        a->slots[i] = NULL;
+    }
+    a->count = 0;
+}
+
+void glyph_atlas_destroy(GlyphAtlas *a) {
+    if (!a) return;
+    free_tiles(a);
+    free(a->slots);
+    free(a);
+}
+
+static int find_slot(const GlyphAtlas *a, uint64_t key, uint32_t glyph, int phase) {
+    int mask = a->cap - 1;
+    int i = (int)(slot_hash(key, glyph, phase) & (uint64_t)mask);
+    while (a->slots[i]) {
+        const GlyphTile *t = a->slots[i];
+        if (t->key == key && t->glyph == glyph && t->phase == phase)
+            return i;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+const GlyphTile *glyph_atlas_find(GlyphAtlas *a, uint64_t key, uint32_t glyph, int phase) {
+    if (!a) return NULL;
+    GlyphTile *t = a->slots[find_slot(a, key, glyph, phase)];
+    if (t) a->hits++;
+    else a->misses++;
+    return t;
+}
+
+static int grow(GlyphAtlas *a) {
+    int ncap = a->cap * 2;
+    GlyphTile **ns = calloc((size_t)ncap, sizeof(GlyphTile *));
+    if (!ns) return -1;
+    GlyphTile **old = a->slots;
+    int ocap = a->cap;
+    a->slots = ns;
+    a->cap = ncap;
+    for (int i = 0; i < ocap; i++) {
+        if (old[i])
+            a->slots[find_slot(a, old[i]->key, old[i]->glyph, old[i]->phase)] = old[i];
+    }
+    free(old);
+    return 0;
+}
+
+GlyphTile *glyph_atlas_add(GlyphAtlas *a, uint64_t key, uint32_t glyph, int phase,
+                           int w, int h, int ox, int oy) {
+    if (!a || w <= 0 || h <= 0 || w > 4096 || h > 4096) return NULL;
+    if ((a->count + 1) * 2 > a->cap && grow(a) != 0) return NULL;
+    int i = find_slot(a, key, glyph, phase);
+    if (a->slots[i]) return NULL;
+
+    size_t plane = (size_t)w * (size_t)h;
+    GlyphTile *t = calloc(1, sizeof(*t) + plane * GLYPH_PLANE_COUNT);
+    if (!t) return NULL;
+    t->key = key;
+    t->glyph = glyph;
+    t->phase = phase;
+    t->w = w;
+    t->h = h;
+    t->ox = ox;
+    t->oy = oy;
+    uint8_t *base = (uint8_t *)(t + 1);
+    for (int p = 0; p < GLYPH_PLANE_COUNT; p++)
+        t->plane[p] = base + plane * (size_t)p;
+    a->slots[i] = t;
+    a->count++;
+    return t;
+}
+
+void glyph_atlas_trim(GlyphAtlas *a) {
+    if (a && a->count > a->max_tiles)
+        free_tiles(a);
+}
+
+int glyph_atlas_count(const GlyphAtlas *a) {
+    return a ? a->count : 0;
+}
+
+void glyph_atlas_stats(const GlyphAtlas *a, uint64_t *hits, uint64_t *misses) {
+    if (hits) *hits = a ? a->hits : 0;
+    if (misses) *misses = a ? a->misses : 0;
+}
+
+uint64_t glyph_atlas_key_str(uint64_t seed, const char *s) {
+    uint64_t h = seed ? seed : 0xcbf29ce484222325ULL;
+    for (; s && *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+uint64_t glyph_atlas_key_mix(uint64_t seed, uint64_t v) {
+    return slot_hash(seed ^ 0x2545F4914F6CDD1DULL, (uint32_t)v, (int)(v >> 32));
+}
+
+void glyph_coverage_downsample(const uint8_t *src, int src_stride, int ss,
+                               uint8_t *dst, int dst_w, int dst_h) {
+    if (!src || !dst || ss <= 0) return;
+    const int n = ss * ss;
+    for (int y = 0; y < dst_h; y++) {
+        for (int x = 0; x < dst_w; x++) {
+            int sum = 0;
+            const uint8_t *row = src + (size_t)y * ss * src_stride + (size_t)x * ss;
+            for (int sy = 0; sy < ss; sy++, row += src_stride)
+                for (int sx = 0; sx < ss; sx++)
+                    sum += row[sx];
+            dst[(size_t)y * dst_w + x] = (uint8_t)((sum + n / 2) / n);
+        }
+    }
+}
+
+void glyph_tile_composite(uint8_t *canvas, int stride, int cw, int ch,
+                          const GlyphTile *tile, int plane, int x, int y, uint32_t argb) {
+    if (!canvas || !tile || plane < 0 || plane >= GLYPH_PLANE_COUNT) return;
+    const unsigned ca = (argb >> 24) & 0xFF;
+    const unsigned cr = (argb >> 16) & 0xFF;
+    const unsigned cg = (argb >> 8) & 0xFF;
+    const unsigned cb = argb & 0xFF;
+    if (ca == 0) return;
+
+    const int x0 = x + tile->ox, y0 = y + tile->oy;
+    const int tx0 = x0 < 0 ? -x0 : 0;
+    const int ty0 = y0 < 0 ? -y0 : 0;
+    const int tx1 = (x0 + tile->w > cw) ? cw - x0 : tile->w;
+    const int ty1 = (y0 + tile->h > ch) ? ch - y0 : tile->h;
+    const uint8_t *cov = tile->plane[plane];
+
+    for (int ty = ty0; ty < ty1; ty++) {
+        uint32_t *dst = (uint32_t *)(canvas + (size_t)(y0 + ty) * stride) + x0;
+        const uint8_t *c = cov + (size_t)ty * tile->w;
+        for (int tx = tx0; tx < tx1; tx++) {
+            unsigned cv = c[tx];
+            if (!cv) continue;
+            unsigned sa = (ca * cv + 127) / 255;
+            unsigned inv = 255 - sa;
+            uint32_t d = dst[tx];
+            unsigned da = (d >> 24) & 0xFF, dr = (d >> 16) & 0xFF;
+            unsigned dg = (d >> 8) & 0xFF, db = d & 0xFF;
+            da = sa + (da * inv + 127) / 255;
+            dr = (cr * sa + 127) / 255 + (dr * inv + 127) / 255;
+            dg = (cg * sa + 127) / 255 + (dg * inv + 127) / 255;
+            db = (cb * sa + 127) / 255 + (db * inv + 127) / 255;
+            dst[tx] = (da << 24) | (dr << 16) | (dg << 8) | db;
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <stdint.h>
+
+/**
+ * @file glyph_atlas.h
+ * @brief Per-thread cache of pre-rendered glyph coverage tiles.
+ *
+ * The fast path of render_text_pango() rasterises each glyph once per
+ * (font, size, style, SSAA, effect geometry, subpixel phase) into a tile
+ * holding three output-resolution coverage planes (shadow, outline,
+ * fill), already supersampled and downsampled. A cue is then composited
+ * by blitting tiles at the positions Pango computed for its glyphs,
+ * shadow plane of every glyph first, then outlines, then fills, which is
+ * the same layer order the Cairo path draws in.
+ *
+ * This module has no Pango/Cairo dependency: it owns the cache and the
+ * coverage arithmetic; render_pango.c fills missing tiles. An atlas is
+ * not thread-safe and is meant to live in thread-local storage next to
+ * the thread's PangoFontMap.
+ */
+
+/** Subpixel positions per axis; glyph origins are snapped to 1/N px. */
+#define GLYPH_ATLAS_PHASES 4
+
+enum {
+    GLYPH_PLANE_SHADOW = 0,
+    GLYPH_PLANE_OUTLINE,
+    GLYPH_PLANE_FILL,
+    GLYPH_PLANE_COUNT
+};
+
+/** One cached glyph at one subpixel phase. */
+typedef struct GlyphTile {
+    uint64_t key;      /**< font/profile key (see glyph_atlas_key_mix) */
+    uint32_t glyph;    /**< font glyph index */
+    int phase;         /**< phase_x * GLYPH_ATLAS_PHASES + phase_y */
+    int w, h;          /**< tile size in output pixels */
+    int ox, oy;        /**< tile top-left relative to the glyph origin (px) */
+    uint8_t *plane[GLYPH_PLANE_COUNT]; /**< w*h coverage each (0..255) */
+} GlyphTile;
+
+typedef struct GlyphAtlas GlyphAtlas;
+
+/** Create an empty atlas holding at most ~`max_tiles` tiles (see glyph_atlas_trim). */
+GlyphAtlas *glyph_atlas_create(int max_tiles);
+
+/** Free all tiles and the atlas. Safe on NULL. */
+void glyph_atlas_destroy(GlyphAtlas *atlas);
+
+/** Cached tile for (key, glyph, phase), or NULL. Counts a hit or miss. */
+const GlyphTile *glyph_atlas_find(GlyphAtlas *atlas, uint64_t key, uint32_t glyph, int phase);
+
+/**
+ * Insert a new zeroed tile of `w`x`h` pixels for the caller to fill.
+ * Tile pointers stay valid until glyph_atlas_trim()/destroy.
+ *
+ * @return The tile, or NULL on allocation failure or duplicate key.
+ */
+GlyphTile *glyph_atlas_add(GlyphAtlas *atlas, uint64_t key, uint32_t glyph, int phase,
+                           int w, int h, int ox, int oy);
+
+/**
+ * Drop every tile if the atlas holds more than its budget. Call between
+ * cues (never while tile pointers from the current cue are in use).
+ */
+void glyph_atlas_trim(GlyphAtlas *atlas);
+
+/** Number of cached tiles. */
+int glyph_atlas_count(const GlyphAtlas *atlas);
+
+/** Lookup statistics since creation. Either pointer may be NULL. */
+void glyph_atlas_stats(const GlyphAtlas *atlas, uint64_t *hits, uint64_t *misses);
+
+/** FNV-1a over a string, continuing from `seed` (use 0 to start). */
+uint64_t glyph_atlas_key_str(uint64_t seed, const char *s);
+
+/** Mix an integer parameter into a key. */
+uint64_t glyph_atlas_key_mix(uint64_t seed, uint64_t v);
+
+/**
+ * Box-filter an `ss`x supersampled A8 coverage image down to
+ * `dst_w`x`dst_h` (the source must be at least dst*ss in each axis).
+ */
+void glyph_coverage_downsample(const uint8_t *src, int src_stride, int ss,
+                               uint8_t *dst, int dst_w, int dst_h);
+
+/**
+ * Composite one plane of `tile` OVER a premultiplied ARGB32 canvas
+ * (Cairo image layout, native-endian uint32 per pixel) with the glyph
+ * origin at integer pixel (`x`, `y`). `argb` is a straight-alpha colour
+ * 0xAARRGGBB. Pixels outside the canvas are clipped.
+ */
+void glyph_tile_composite(uint8_t *canvas, int stride, int cw, int ch,
+                          const GlyphTile *tile, int plane, int x, int y, uint32_t argb);
+
+#endif /* GLYPH_ATLAS_H */
@@ -0,0 +1,221 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * image_diff.c
+ * ------------
+ * Index, palette and SSIM comparison of palette images; see image_diff.h.
+ */
+
+#include "image_diff.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DIFF_PAD 4
+#define SSIM_WIN 8
+#define SSIM_STEP 4
+#define SSIM_C1 (0.01 * 255 * 0.01 * 255)
+#define SSIM_C2 (0.03 * 255 * 0.03 * 255)
+#define BACKDROP 128
+
+ImageDiffThresholds image_diff_exact_thresholds(void) {
+    ImageDiffThresholds t = { 1.0, 0.0, 0 };
+    return t;
+}
+
+/* ARGB over the mid-grey backdrop, per channel. */
+static void composite(uint32_t argb, int rgb[3]) {
+    int a = (int)(argb >> 24);
+    for (int c = 0; c < 3; c++) {
+        int v = (int)((argb >> (16 - 8 * c)) & 0xFF);
+        rgb[c] = (v * a + BACKDROP * (255 - a) + 127) / 255;
+    }
+}
+
+static double luma(const int rgb[3]) {
+    return 0.299 * rgb[0] + 0.587 * rgb[1] + 0.114 * rgb[2];
+}
+
+/* Mean SSIM over SSIM_WIN windows stepped by SSIM_STEP, the last row and
+ * column of windows flush with the edge; a box smaller than one window
+ * is a single window. */
+static double mean_ssim(const float *x, const float *y, int w, int h) {
+    int ww = w < SSIM_WIN ? w : SSIM_WIN;
+    int wh = h < SSIM_WIN ? h : SSIM_WIN;
+    double sum = 0.0;
+    long windows = 0;
+    for (int ys = 0;; ys += SSIM_STEP) {
+        int y0 = ys + wh > h ? h - wh : ys;
+        for (int xs = 0;; xs += SSIM_STEP) {
+            int x0 = xs + ww > w ? w - ww : xs;
+            double sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+            for (int j = 0; j < wh; j++) {
+                const float *px = x + (size_t)(y0 + j) * w + x0;
+                const float *py = y + (size_t)(y0 + j) * w + x0;
+                for (int i = 0; i < ww; i++) {
+                    sx += px[i];
+                    sy += py[i];
+                    sxx += (double)px[i] * px[i];
+                    syy += (double)py[i] * py[i];
+                    sxy += (double)px[i] * py[i];
+                }
+            }
+            double n = (double)ww * wh;
+            double mx = sx / n, my = sy / n;
+            double vx = sxx / n - mx * mx, vy = syy / n - my * my, cxy = sxy / n - mx * my;
+            sum += ((2 * mx * my + SSIM_C1) * (2 * cxy + SSIM_C2)) /
+                   ((mx * mx + my * my + SSIM_C1) * (vx + vy + SSIM_C2));
+            windows++;
+            if (x0 + ww == w) break;
+        }
+        if (y0 + wh == h) break;
+    }
+    return windows ? sum / windows : 1.0;
+}
+
+int image_diff_indexed(const PngIndexed *ref, const PngIndexed *cand, ImageDiff *out) {
+    if (!out) return -1;
+    memset(out, 0, sizeof(*out));
+    if (!ref || !cand || !ref->idx || !cand->idx) return -1;
+    if (ref->w != cand->w || ref->h != cand->h) {
+        out->size_mismatch = 1;
+        out->ssim = 0.0;
+        out->changed_pct = 100.0;
+        out->max_delta = 255;
+        return 0;
+    }
+    const int w = ref->w, h = ref->h;
+
+    /* Content box: non-transparent pixels of either frame. */
+    int x0 = w, y0 = h, x1 = -1, y1 = -1;
+    for (int y = 0; y < h; y++) {
+        const uint8_t *a = ref->idx + (size_t)y * w, *b = cand->idx + (size_t)y * w;
+        for (int x = 0; x < w; x++) {
+            if ((ref->palette[a[x]] >> 24) == 0 && (cand->palette[b[x]] >> 24) == 0)
+                continue;
+            if (x < x0) x0 = x;
+            if (x > x1) x1 = x;
+            if (y < y0) y0 = y;
+            if (y > y1) y1 = y;
+        }
+    }
+    if (x1 < 0) {
+        /* Both frames fully transparent. */
+        x0 = y0 = 0;
+        x1 = w - 1;
+        y1 = h - 1;
+    } else {
+        x0 = x0 > DIFF_PAD ? x0 - DIFF_PAD : 0;
+        y0 = y0 > DIFF_PAD ? y0 - DIFF_PAD : 0;
+        x1 = x1 + DIFF_PAD < w ? x1 + DIFF_PAD : w - 1;
+        y1 = y1 + DIFF_PAD < h ? y1 + DIFF_PAD : h - 1;
+    }
+    const int bw = x1 - x0 + 1, bh = y1 - y0 + 1;
+
+    float *lx = malloc(sizeof(float) * (size_t)bw * bh);
+    float *ly = malloc(sizeof(float) * (size_t)bw * bh);
+    if (!lx || !ly) {
+        free(lx);
+        free(ly);
+        return -1;
+    }
+
+    /* Colour differences of used indices; outside the box both frames
+     * are transparent, so only index changes there are counted below. */
+    unsigned char used[256] = {0};
+    long changed_outside = 0;
+    for (size_t i = 0; i < (size_t)w * h; i++) {
+        used[ref->idx[i]] = 1;
+        if (ref->idx[i] != cand->idx[i]) {
+            int y = (int)(i / w), x = (int)(i % w);
+            if (x < x0 || x > x1 || y < y0 || y > y1) {
+                changed_outside++;
+                out->changed_by_index[ref->idx[i]]++;
+            }
+        }
+    }
+    for (int i = 0; i < 256; i++)
+        if (used[i] && ref->palette[i] != cand->palette[i])
+            out->palette_changed++;
+
+    for (int y = 0; y < bh; y++) {
+        const uint8_t *a = ref->idx + (size_t)(y0 + y) * w + x0;
+        const uint8_t *b = cand->idx + (size_t)(y0 + y) * w + x0;
+        for (int x = 0; x < bw; x++) {
+            int ca[3], cb[3];
+            composite(ref->palette[a[x]], ca);
+            composite(cand->palette[b[x]], cb);
+            for (int c = 0; c < 3; c++) {
+                int d = abs(ca[c] - cb[c]);
+                if (d > out->max_delta) out->max_delta = d;
+            }
+            lx[(size_t)y * bw + x] = (float)luma(ca);
+            ly[(size_t)y * bw + x] = (float)luma(cb);
+            if (a[x] != b[x]) {
+                out->changed++;
+                out->changed_by_index[a[x]]++;
+            }
+        }
+    }
+    out->changed += changed_outside;
+    out->pixels = (long)bw * bh;
+    out->changed_pct = 100.0 * (double)out->changed / (double)out->pixels;
+    out->ssim = mean_ssim(lx, ly, bw, bh);
+    out->exact = out->changed == 0 && out->palette_changed == 0;
+    free(lx);
+    free(ly);
+    return 0;
+}
+
+int image_diff_passes(const ImageDiff *d, const ImageDiffThresholds *t) {
+    if (!d || d->size_mismatch) return 0;
+    if (d->exact) return 1;
+    if (!t) return 0;
+    return d->ssim >= t->min_ssim && d->changed_pct <= t->max_changed_pct &&
+           d->max_delta <= t->max_delta;
+}
@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef IMAGE_DIFF_H
+#define IMAGE_DIFF_H
+
+#include "png_reader.h"
+
+/**
+ * @file image_diff.h
+ * @brief Compare two rendered cues stored as palette images.
+ *
+ * Backs the golden-image suite (testharness/golden_diff.c). Two frames
+ * of the same size are compared three ways:
+ *  - exact: every pixel has the same index and the colour of every used
+ *    index is the same;
+ *  - per index: how many pixels changed index, broken down by their
+ *    index in the reference (which colour class moved: fill, outline,
+ *    shadow, background box...);
+ *  - perceptual: both frames are composited over mid-grey and a mean
+ *    SSIM (8x8 windows, stride 4) is taken on the luma, along with the
+ *    largest per-channel difference.
+ *
+ * Percentages and SSIM are measured over the content box: the union of
+ * the non-transparent pixels of both frames, padded by 4 px, so a
+ * small cue on a large frame is not drowned out by empty background.
+ */
+
+/** Comparison result. */
+typedef struct {
+    int exact;                  /**< identical indices and used colours */
+    int size_mismatch;          /**< frames differ in size; nothing else is set */
+    long pixels;                /**< pixels in the content box */
+    long changed;               /**< pixels whose index differs */
+    long changed_by_index[256]; /**< `changed`, by reference index */
+    int palette_changed;        /**< used indices whose colour differs */
+    int max_delta;              /**< largest composited channel difference (0..255) */
+    double changed_pct;         /**< 100 * changed / pixels */
+    double ssim;                /**< mean luma SSIM, 1.0 when identical */
+} ImageDiff;
+
+/** Limits a candidate must stay within (see image_diff_passes()). */
+typedef struct {
+    double min_ssim;        /**< lowest acceptable SSIM */
+    double max_changed_pct; /**< highest acceptable share of changed pixels */
+    int max_delta;          /**< highest acceptable channel difference */
+} ImageDiffThresholds;
+
+/** Thresholds that only accept exact matches. */
+ImageDiffThresholds image_diff_exact_thresholds(void);
+
+/**
+ * Compare `cand` against the reference `ref`.
+ *
+ * @return 0 on success (including a size mismatch, reported in `out`),
+ *         -1 on invalid input or allocation failure.
+ */
+int image_diff_indexed(const PngIndexed *ref, const PngIndexed *cand, ImageDiff *out);
+
+/** Non-zero when `d` is exact or within every limit of `t`. */
+int image_diff_passes(const ImageDiff *d, const ImageDiffThresholds *t);
+
+#endif /* IMAGE_DIFF_H */
@@ -0,0 +1,405 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * line_break.c
+ * ------------
+ * Width-aware balanced line breaking with a per-font advance cache; see
+ * line_break.h.
+ */
+
+#include "line_break.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Advances are cached in lazily allocated pages of 256 codepoints. */
+#define LB_PAGE_SHIFT 8
+#define LB_PAGE_SIZE  (1 << LB_PAGE_SHIFT)
+#define LB_NUM_PAGES  (0x110000 >> LB_PAGE_SHIFT)
+
+/* Above this many lines the O(k*n^2) search is not worth it; keep greedy. */
+#define LB_DP_MAX_LINES 16
+
+struct LineBreaker {
+    LineAdvanceFn advance;
+    void *user;
+    void (*free_user)(void *);
+    int32_t max_width;
+    long hits, misses;
+    int32_t *pages[LINE_BREAK_STYLES][LB_NUM_PAGES];
+};
+
+LineBreaker *line_breaker_create(LineAdvanceFn advance, void *user,
+                                 void (*free_user)(void *), int32_t max_width) {
+    if (!advance || max_width <= 0) return NULL;
+    LineBreaker *lb = calloc(1, sizeof(*lb));
+    if (!lb) return NULL;
+    lb->advance = advance;
+    lb->user = user;
+    lb->free_user = free_user;
+    lb->max_width = max_width;
+    return lb;
+}
+
+void line_breaker_destroy(LineBreaker *lb) {
+    if (!lb) return;
+    for (int s = 0; s < LINE_BREAK_STYLES; s++)
+        for (int p = 0; p < LB_NUM_PAGES; p++)
+            free(lb->pages[s][p]);
+    if (lb->free_user) lb->free_user(lb->user);
+    free(lb);
+}
+
+int32_t line_breaker_max_width(const LineBreaker *lb) {
+    return lb ? lb->max_width : 0;
+}
+
+void line_breaker_stats(const LineBreaker *lb, long *hits, long *misses) {
+    if (hits) *hits = lb ? lb->hits : 0;
+    if (misses) *misses = lb ? lb->misses : 0;
+}
+
+/* Cached advance of `cp` in `style`; -1 marks an unmeasured slot. */
+static int32_t cached_advance(LineBreaker *lb, uint32_t cp, int style) {
+    if (cp >= 0x110000) cp = 0xFFFD;
+    style &= LINE_BREAK_STYLES - 1;
+    int32_t **page = &lb->pages[style][cp >> LB_PAGE_SHIFT];
+    if (!*page) {
+        *page = malloc(LB_PAGE_SIZE * sizeof(int32_t));
+        if (!*page) {
+            lb->misses++;
+            int32_t w = lb->advance(lb->user, cp, style);
+            return w > 0 ? w : 0;
+        }
+        for (int i = 0; i < LB_PAGE_SIZE; i++) (*page)[i] = -1;
+    }
+    int32_t *slot = &(*page)[cp & (LB_PAGE_SIZE - 1)];
+    if (*slot >= 0) {
+        lb->hits++;
+        return *slot;
+    }
+    lb->misses++;
+    int32_t w = lb->advance(lb->user, cp, style);
+    *slot = w > 0 ? w : 0;
+    return *slot;
+}
+
+/* Decode one UTF-8 sequence; malformed bytes decode to U+FFFD. */
+static uint32_t utf8_next(const unsigned char *s, size_t len, size_t *used) {
+    unsigned char c = s[0];
+    uint32_t cp;
+    size_t n;
+    if (c < 0x80) { *used = 1; return c; }
+    if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; n = 2; }
+    else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; n = 3; }
+    else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; n = 4; }
+    else { *used = 1; return 0xFFFD; }
+    if (n > len) { *used = 1; return 0xFFFD; }
+    for (size_t i = 1; i < n; i++) {
+        if ((s[i] & 0xC0) != 0x80) { *used = 1; return 0xFFFD; }
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    *used = n;
+    return cp;
+}
+
+/* Apply an HTML tag body (between '<' and '>') to the style bits. */
+static void html_tag_style(const char *t, size_t n, int *style) {
+    int closing = 0;
+    if (n && *t == '/') { closing = 1; t++; n--; }
+    if (n != 1) return;
+    int bit = (t[0] == 'i' || t[0] == 'I') ? LINE_BREAK_ITALIC :
+              (t[0] == 'b' || t[0] == 'B') ? LINE_BREAK_BOLD : 0;
+    if (closing) *style &= ~bit;
+    else *style |= bit;
+}
+
+/* Apply the \iN / \bN overrides of an ASS block (between '{' and '}'). */
+static void ass_block_style(const char *t, size_t n, int *style) {
+    for (size_t i = 0; i + 1 < n; i++) {
+        if (t[i] != '\\' || (t[i + 1] != 'i' && t[i + 1] != 'b')) continue;
+        if (i + 2 >= n || !isdigit((unsigned char)t[i + 2])) continue;
+        int bit = t[i + 1] == 'i' ? LINE_BREAK_ITALIC : LINE_BREAK_BOLD;
+        if (atoi(t + i + 2) != 0) *style |= bit;
+        else *style &= ~bit;
+    }
+}
+
+int32_t line_breaker_text_width(LineBreaker *lb, const char *s, size_t len, int *style) {
+    int st = style ? *style : 0;
+    int32_t w = 0;
+    size_t i = 0;
+    while (i < len) {
+        char c = s[i];
+        if (c == '<' || c == '{') {
+            /* An unterminated '<' or '{' is literal text. */
+            const char *close = memchr(s + i + 1, c == '<' ? '>' : '}', len - i - 1);
+            if (close) {
+                size_t body = (size_t)(close - (s + i + 1));
+                if (c == '<') html_tag_style(s + i + 1, body, &st);
+                else ass_block_style(s + i + 1, body, &st);
+                i += body + 2;
+                continue;
+            }
+        }
+        size_t used;
+        uint32_t cp = utf8_next((const unsigned char *)s + i, len - i, &used);
+        w += cached_advance(lb, cp, st);
+        i += used;
+    }
+    if (style) *style = st;
+    return w;
+}
+
+/* Greedy first fit: the minimum number of lines for a fixed width. */
+static int greedy_breaks(const int32_t *word_w, int n, int32_t space_w,
+                         int32_t max_width, int max_lines, unsigned char *brk) {
+    int lines = 1;
+    int64_t cur = word_w[0];
+    brk[0] = 1;
+    for (int i = 1; i < n; i++) {
+        brk[i] = 0;
+        if (cur + space_w + word_w[i] > max_width && (max_lines <= 0 || lines < max_lines)) {
+            brk[i] = 1;
+            lines++;
+            cur = word_w[i];
+        } else {
+            cur += space_w + word_w[i];
+        }
+    }
+    return lines;
+}
+
+/* Line cost, compared lexicographically: overflow first, then raggedness. */
+typedef struct {
+    int64_t over;
+    double rag;
+} LineCost;
+
+static int cost_less(LineCost a, LineCost b) {
+    return a.over < b.over || (a.over == b.over && a.rag < b.rag);
+}
+
+int line_break_balanced(const int32_t *word_w, int n, int32_t space_w,
+                        int32_t max_width, int max_lines, unsigned char *brk) {
+    if (n <= 0) return 0;
+    int k = greedy_breaks(word_w, n, space_w, max_width, 0, brk);
+    if (max_lines > 0 && k > max_lines) k = max_lines;
+    if (k == 1) {
+        memset(brk, 0, (size_t)n);
+        brk[0] = 1;
+        return 1;
+    }
+    if (k > LB_DP_MAX_LINES || k >= n)
+        return greedy_breaks(word_w, n, space_w, max_width, max_lines, brk);
+
+    /* best[l][j]: cheapest way to set words [0, j) on l lines; from[l][j]
+     * is the first word of the l-th line in that solution. */
+    int64_t *prefix = malloc((size_t)(n + 1) * sizeof(*prefix));
+    LineCost *best = malloc((size_t)(k + 1) * (size_t)(n + 1) * sizeof(*best));
+    int *from = malloc((size_t)(k + 1) * (size_t)(n + 1) * sizeof(*from));
+    if (!prefix || !best || !from) {
+        free(prefix); free(best); free(from);
+        return -1;
+    }
+    prefix[0] = 0;
+    for (int i = 0; i < n; i++) prefix[i + 1] = prefix[i] + word_w[i];
+
+    const LineCost inf = { INT64_MAX, 0.0 };
+#define BEST(l, j) best[(size_t)(l) * (size_t)(n + 1) + (size_t)(j)]
+#define FROM(l, j) from[(size_t)(l) * (size_t)(n + 1) + (size_t)(j)]
+    for (int l = 0; l <= k; l++)
+        for (int j = 0; j <= n; j++) BEST(l, j) = inf;
+    BEST(0, 0) = (LineCost){ 0, 0.0 };
+
+    for (int l = 1; l <= k; l++) {
+        /* l lines need at least l words, and leave one per remaining line */
+        for (int j = l; j <= n - (k - l); j++) {
+            for (int i = l - 1; i < j; i++) {
+                LineCost prev = BEST(l - 1, i);
+                if (prev.over == INT64_MAX) continue;
+                int64_t w = prefix[j] - prefix[i] + (int64_t)(j - i - 1) * space_w;
+                LineCost c = prev;
+                if (w <= max_width) {
+                    double slack = (double)(max_width - w);
+                    c.rag += slack * slack;
+                } else if (j - i > 1) {
+                    /* a lone over-long word is unavoidable, a crowded line is not */
+                    c.over += w - max_width;
+                }
+                if (cost_less(c, BEST(l, j))) {
+                    BEST(l, j) = c;
+                    FROM(l, j) = i;
+                }
+            }
+        }
+    }
+
+    memset(brk, 0, (size_t)n);
+    for (int l = k, j = n; l > 0; l--) {
+        int i = FROM(l, j);
+        brk[i] = 1;
+        j = i;
+    }
+#undef BEST
+#undef FROM
+    free(prefix);
+    free(best);
+    free(from);
+    return k;
+}
+
+/* Growable output buffer for line_breaker_wrap(). */
+typedef struct {
+    char *s;
+    size_t len, cap;
+} LbBuf;
+
+static int buf_put(LbBuf *b, const char *s, size_t n) {
+    if (b->len + n + 1 > b->cap) {
+        size_t nc = (b->len + n + 1) * 2;
+        char *ns = realloc(b->s, nc);
+        if (!ns) return -1;
+        b->s = ns;
+        b->cap = nc;
+    }
+    memcpy(b->s + b->len, s, n);
+    b->len += n;
+    b->s[b->len] = '\0';
+    return 0;
+}
+
+/* Split one source line into words; spaces inside tags do not split. */
+static int split_words(const char *line, size_t len, const char ***starts, size_t **lens) {
+    int n = 0, cap = 0;
+    const char **st = NULL;
+    size_t *ln = NULL;
+    size_t i = 0;
+    while (i < len) {
+        while (i < len && line[i] == ' ') i++;
+        if (i >= len) break;
+        size_t b = i;
+        int in_angle = 0, in_brace = 0;
+        while (i < len) {
+            char c = line[i];
+            if (!in_angle && !in_brace && c == ' ') break;
+            if (c == '<') in_angle = 1;
+            else if (c == '>' && in_angle) in_angle = 0;
+            else if (c == '{') in_brace = 1;
+            else if (c == '}' && in_brace) in_brace = 0;
+            i++;
+        }
+        if (n == cap) {
+            int nc = cap ? cap * 2 : 16;
+            const char **nst = realloc(st, (size_t)nc * sizeof(*st));
+            if (!nst) { free(st); free(ln); return -1; }
+            st = nst;
+            size_t *nln = realloc(ln, (size_t)nc * sizeof(*ln));
+            if (!nln) { free(st); free(ln); return -1; }
+            ln = nln;
+            cap = nc;
+        }
+        st[n] = line + b;
+        ln[n] = i - b;
+        n++;
+    }
+    *starts = st;
+    *lens = ln;
+    return n;
+}
+
+char *line_breaker_wrap(LineBreaker *lb, const char *text, int max_lines) {
+    if (!lb || !text) return NULL;
+    LbBuf out = { NULL, 0, 0 };
+    if (buf_put(&out, "", 0) < 0) return NULL;
+
+    int style = 0;
+    int used_lines = 0;
+    int32_t space_w = cached_advance(lb, ' ', 0);
+    const char *p = text;
+    while (*p) {
+        const char *nl = strchr(p, '\n');
+        size_t len = nl ? (size_t)(nl - p) : strlen(p);
+
+        const char **starts = NULL;
+        size_t *lens = NULL;
+        int n = split_words(p, len, &starts, &lens);
+        if (n < 0) goto fail;
+        if (n > 0) {
+            int32_t *w = malloc((size_t)n * sizeof(*w));
+            unsigned char *brk = malloc((size_t)n);
+            if (!w || !brk) {
+                free(w); free(brk); free(starts); free(lens);
+                goto fail;
+            }
+            for (int i = 0; i < n; i++)
+                w[i] = line_breaker_text_width(lb, starts[i], lens[i], &style);
+
+            int budget = max_lines > 0 ? max_lines - used_lines : 0;
+            if (max_lines > 0 && budget < 1) budget = 1;
+            int k = line_break_balanced(w, n, space_w, lb->max_width, budget, brk);
+            int ok = k > 0;
+            if (ok && used_lines > 0) ok = buf_put(&out, "\n", 1) == 0;
+            for (int i = 0; ok && i < n; i++) {
+                if (i > 0) ok = buf_put(&out, brk[i] ? "\n" : " ", 1) == 0;
+                if (ok) ok = buf_put(&out, starts[i], lens[i]) == 0;
+            }
+            free(w); free(brk); free(starts); free(lens);
+            if (!ok) goto fail;
+            used_lines += k;
+        }
+        if (!nl) break;
+        p = nl + 1;
+    }
+    return out.s;
+
+fail:
+    free(out.s);
+    return NULL;
+}
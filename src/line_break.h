@@ -0,0 +1,137 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef LINE_BREAK_H
+#define LINE_BREAK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file line_break.h
+ * @brief Width-aware, balanced line breaking for subtitle cues.
+ *
+ * normalize_cue_text() used to wrap cues by character count and Pango then
+ * wrapped them again at 80% of the frame width, so the same cue was laid
+ * out twice and a narrow estimate could add a line. A LineBreaker measures
+ * words with the real font instead: glyph advances are fetched once per
+ * (codepoint, style) through a callback and cached, and each source line
+ * is split into the fewest lines that fit, with the break points chosen to
+ * make those lines as even as possible (minimum raggedness).
+ *
+ * The module does not depend on Pango; render_pango.c supplies the
+ * measuring callback.
+ */
+
+/** Style bits tracked through <i>/<b> and {\i1}/{\b1} tags. */
+#define LINE_BREAK_ITALIC 1
+#define LINE_BREAK_BOLD   2
+#define LINE_BREAK_STYLES 4
+
+/**
+ * Advance width of one codepoint in the given style (LINE_BREAK_* bits),
+ * in the caller's units (render_pango.c uses Pango units). Must be >= 0.
+ */
+typedef int32_t (*LineAdvanceFn)(void *user, uint32_t cp, int style);
+
+typedef struct LineBreaker LineBreaker;
+
+/**
+ * Create a breaker for one font and target width.
+ *
+ * @param advance Measuring callback.
+ * @param user Opaque pointer passed to `advance`.
+ * @param free_user Called on `user` by line_breaker_destroy() (may be NULL).
+ * @param max_width Target line width, in the units of `advance`.
+ * @return New breaker, or NULL on bad arguments / allocation failure.
+ */
+LineBreaker *line_breaker_create(LineAdvanceFn advance, void *user,
+                                 void (*free_user)(void *), int32_t max_width);
+
+/** Free a breaker and its advance cache. NULL is a no-op. */
+void line_breaker_destroy(LineBreaker *lb);
+
+/** Target width the breaker was created with. */
+int32_t line_breaker_max_width(const LineBreaker *lb);
+
+/**
+ * Visible width of `len` bytes of UTF-8 markup. Tags are skipped; <i>, <b>
+ * and the ASS \i / \b overrides update `*style`, which carries over
+ * between calls so a word inherits the style of the text before it.
+ */
+int32_t line_breaker_text_width(LineBreaker *lb, const char *s, size_t len, int *style);
+
+/**
+ * Wrap normalised cue text (single spaces, '\n' between source lines).
+ * Explicit newlines are kept; every source line is broken into the fewest
+ * lines that fit, balanced. `max_lines` caps the total line count: once
+ * the budget is used up the remaining text stays on the last line.
+ *
+ * @return malloc()'d string, or NULL on allocation failure.
+ */
+char *line_breaker_wrap(LineBreaker *lb, const char *text, int max_lines);
+
+/**
+ * Balanced breaking of one paragraph of `n` words.
+ *
+ * Finds the minimum number of lines k (capped at `max_lines`, 0 = no cap)
+ * and, among all ways to split the words into k lines, the one with the
+ * smallest sum of squared slack. A word wider than `max_width` gets a
+ * line of its own. On return `brk[i]` is 1 when a line starts at word i
+ * (brk[0] is always 1).
+ *
+ * @return Number of lines, or -1 on allocation failure.
+ */
+int line_break_balanced(const int32_t *word_w, int n, int32_t space_w,
+                        int32_t max_width, int max_lines, unsigned char *brk);
+
+/** Advance cache statistics: lookups served from the cache and callback calls. */
+void line_breaker_stats(const LineBreaker *lb, long *hits, long *misses);
+
+#endif /* LINE_BREAK_H */
@@ -0,0 +1,727 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * log_async.c
+ * -----------
+ * Asynchronous LOG() backend; see log_async.h.
+ *
+ * Each logging thread owns a byte ring of variable-length records. The
+ * thread is the only producer and the writer thread the only consumer,
+ * so a record is published with one release store of the ring's tail and
+ * consumed with one release store of its head. Records never wrap: when
+ * one does not fit before the end of the ring the producer leaves a
+ * marker (or, if not even a header fits, nothing) and starts again at
+ * offset 0; the consumer applies the same rule.
+ *
+ * The writer merges the rings by a global sequence number, so output
+ * follows submission order across threads, formats into a 64 KiB block
+ * and writes that with a single fwrite.
+ */
+
+#include "log_async.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_RING_DEFAULT   (64u * 1024u)
+#define LOG_RING_MIN       4096u
+#define LOG_SCRATCH        1024    /* on-stack format buffer */
+#define LOG_RATE_SLOTS     64      /* per-thread rate-limit table */
+#define LOG_RATE_PROBE     8       /* slots searched for a call site */
+#define LOG_OUTBUF         (64 * 1024)
+#define LOG_WRITER_IDLE_MS 5
+
+/* Record header; the message bytes follow, padded to 8 bytes. */
+typedef struct LogRecord {
+    uint32_t size;      /* header + message + padding; 0 = wrap marker */
+    uint32_t msg_len;
+    uint64_t seq;
+    int64_t ts_us;
+    int64_t pts90;
+    const char *module; /* string literal from DEBUG_MODULE */
+    int32_t level;
+    int32_t track;
+    int32_t cue;
+    int32_t reserved;
+} LogRecord;
+
+/* One call site (format string) in the current one-second window. */
+typedef struct RateSlot {
+    const char *fmt;
+    const char *module;
+    int level;
+    int count;
+    int suppressed;
+    int64_t window_us;
+} RateSlot;
+
+typedef struct LogRing {
+    struct LogRing *_Atomic next;
+    unsigned char *buf;
+    size_t cap;                 /* power of two */
+    _Atomic size_t head;        /* written by the consumer */
+    _Atomic size_t tail;        /* written by the producer */
+    atomic_int orphaned;        /* owning thread has exited */
+    pthread_t owner;
+    int id;
+    RateSlot rate[LOG_RATE_SLOTS];
+} LogRing;
+
+typedef struct OutBuf {
+    char *buf;
+    size_t len;
+    FILE *out;
+} OutBuf;
+
+static struct {
+    pthread_mutex_t lock;       /* ring list, writer state, flush tickets */
+    pthread_cond_t wake;
+    pthread_cond_t drained;
+    pthread_t thread;
+    int running;
+    int closing;
+    int stopping;               /* seen by the writer: drain once more and exit */
+    uint64_t flush_req, flush_done;
+    atomic_int accepting;
+    atomic_int in_flight;
+    atomic_int writer_idle;
+    LogRing *_Atomic rings;
+    atomic_uint gen;            /* bumped when stop frees every ring */
+    int next_id;
+    atomic_uint_fast64_t seq;
+    atomic_uint_fast64_t written;
+    atomic_uint_fast64_t suppressed;
+    LogFormat format;
+    int rate;
+    FILE *out;
+    size_t ring_bytes;
+    OutBuf ob;
+} g = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .drained = PTHREAD_COND_INITIALIZER,
+};
+
+static _Thread_local LogRing *tls_ring;
+static _Thread_local unsigned tls_ring_gen;
+static _Thread_local struct { int track, cue; int64_t pts90; } tls_ctx = { -1, -1, -1 };
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ring_key;
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static size_t record_size(size_t msg_len)
+{
+    return (sizeof(LogRecord) + msg_len + 7) & ~(size_t)7;
+}
+
+/*
+ * Thread exit: the writer frees the ring once it has been drained. The
+ * key may still hold a ring that log_async_stop() already freed, so only
+ * a listed ring owned by this thread is touched.
+ */
+static void ring_orphan(void *p)
+{
+    pthread_mutex_lock(&g.lock);
+    for (LogRing *r = atomic_load(&g.rings); r; r = r->next) {
+        if (r == p && pthread_equal(r->owner, pthread_self())) {
+            atomic_store(&r->orphaned, 1);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g.lock);
+}
+
+static void make_key(void)
+{
+    pthread_key_create(&ring_key, ring_orphan);
+}
+
+static LogRing *get_ring(void)
+{
+    unsigned gen = atomic_load(&g.gen);
+    if (tls_ring && tls_ring_gen == gen)
+        return tls_ring;
+    pthread_once(&key_once, make_key);
+    LogRing *r = calloc(1, sizeof(*r));
+    if (!r)
+        return NULL;
+    r->cap = g.ring_bytes;
+    r->owner = pthread_self();
+    r->buf = malloc(r->cap);
+    if (!r->buf) {
+        free(r);
+        return NULL;
+    }
+    pthread_mutex_lock(&g.lock);
+    r->id = ++g.next_id;
+    r->next = atomic_load(&g.rings);
+    atomic_store(&g.rings, r);
+    pthread_mutex_unlock(&g.lock);
+    pthread_setspecific(ring_key, r);
+    tls_ring = r;
+    tls_ring_gen = gen;
+    return r;
+}
+
+static void wake_writer(void)
+{
+    if (!atomic_load(&g.writer_idle))
+        return;
+    pthread_mutex_lock(&g.lock);
+    pthread_cond_signal(&g.wake);
+    pthread_mutex_unlock(&g.lock);
+}
+
+/* Copy one record into the calling thread's ring, waiting for space. */
+static void ring_push(LogRing *r, int level, const char *module,
+                      const char *msg, size_t len, int64_t ts)
+{
+    size_t need = record_size(len);
+    size_t mask = r->cap - 1;
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    size_t off, to_end;
+    for (;;) {
+        size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        off = tail & mask;
+        to_end = r->cap - off;
+        size_t total = need <= to_end ? need : to_end + need;
+        if (r->cap - (tail - head) >= total)
+            break;
+        wake_writer();
+        sched_yield();
+    }
+    if (need > to_end) {
+        if (to_end >= sizeof(LogRecord))
+            ((LogRecord *)(r->buf + off))->size = 0;
+        tail += to_end;
+        off = 0;
+    }
+    LogRecord *rec = (LogRecord *)(r->buf + off);
+    rec->size = (uint32_t)need;
+    rec->msg_len = (uint32_t)len;
+    rec->seq = atomic_fetch_add_explicit(&g.seq, 1, memory_order_relaxed);
+    rec->ts_us = ts;
+    rec->pts90 = tls_ctx.pts90;
+    rec->module = module;
+    rec->level = level;
+    rec->track = tls_ctx.track;
+    rec->cue = tls_ctx.cue;
+    memcpy(rec + 1, msg, len);
+    atomic_store_explicit(&r->tail, tail + need, memory_order_release);
+
+    /* The writer polls every few ms; only wake it early when the ring is
+     * filling up, so the common case makes no system call. */
+    if (tail + need - atomic_load_explicit(&r->head, memory_order_relaxed) > r->cap / 2)
+        wake_writer();
+}
+
+/* Next record of a ring for the consumer, skipping wrap markers. */
+static const LogRecord *ring_peek(LogRing *r)
+{
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    size_t skipped = head;
+    while (head != tail) {
+        size_t off = head & (r->cap - 1);
+        size_t to_end = r->cap - off;
+        if (to_end < sizeof(LogRecord) || ((const LogRecord *)(r->buf + off))->size == 0) {
+            head += to_end;
+            continue;
+        }
+        if (head != skipped)
+            atomic_store_explicit(&r->head, head, memory_order_release);
+        return (const LogRecord *)(r->buf + off);
+    }
+    if (head != skipped)
+        atomic_store_explicit(&r->head, head, memory_order_release);
+    return NULL;
+}
+
+static void ob_flush(OutBuf *ob)
+{
+    if (ob->len) {
+        fwrite(ob->buf, 1, ob->len, ob->out);
+        ob->len = 0;
+    }
+}
+
+static void ob_put(OutBuf *ob, const char *s, size_t n)
+{
+    if (ob->len + n > LOG_OUTBUF) {
+        ob_flush(ob);
+        if (n > LOG_OUTBUF) {
+            fwrite(s, 1, n, ob->out);
+            return;
+        }
+    }
+    memcpy(ob->buf + ob->len, s, n);
+    ob->len += n;
+}
+
+static void ob_printf(OutBuf *ob, const char *fmt, ...)
+{
+    char tmp[160];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    if (n > 0)
+        ob_put(ob, tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+}
+
+static void ob_json_string(OutBuf *ob, const char *s, size_t n)
+{
+    ob_put(ob, "\"", 1);
+    size_t run = 0;
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        ob_put(ob, s + run, i - run);
+        run = i + 1;
+        switch (c) {
+        case '"':  ob_put(ob, "\\\"", 2); break;
+        case '\\': ob_put(ob, "\\\\", 2); break;
+        case '\n': ob_put(ob, "\\n", 2); break;
+        case '\r': ob_put(ob, "\\r", 2); break;
+        case '\t': ob_put(ob, "\\t", 2); break;
+        default:   ob_printf(ob, "\\u%04x", c); break;
+        }
+    }
+    ob_put(ob, s + run, n - run);
+    ob_put(ob, "\"", 1);
+}
+
+static void format_record(OutBuf *ob, int thread_id, const LogRecord *rec, const char *msg)
+{
+    size_t len = rec->msg_len;
+    if (g.format == LOG_FORMAT_TEXT) {
+        ob_put(ob, "[", 1);
+        ob_put(ob, rec->module, strlen(rec->module));
+        ob_put(ob, "] ", 2);
+        ob_put(ob, msg, len);
+        return;
+    }
+    while (len && (msg[len - 1] == '\n' || msg[len - 1] == '\r'))
+        len--;
+    ob_printf(ob, "{\"ts\":%lld.%06lld,\"seq\":%llu,\"level\":%d,\"module\":",
+              (long long)(rec->ts_us / 1000000), (long long)(rec->ts_us % 1000000),
+              (unsigned long long)rec->seq, rec->level);
+    ob_json_string(ob, rec->module, strlen(rec->module));
+    ob_printf(ob, ",\"thread\":%d", thread_id);
+    if (rec->track >= 0)
+        ob_printf(ob, ",\"track\":%d", rec->track);
+    if (rec->cue >= 0)
+        ob_printf(ob, ",\"cue\":%d", rec->cue);
+    if (rec->pts90 >= 0)
+        ob_printf(ob, ",\"pts\":%lld", (long long)rec->pts90);
+    ob_put(ob, ",\"msg\":", 7);
+    ob_json_string(ob, msg, len);
+    ob_put(ob, "}\n", 2);
+}
+
+/* Free rings of exited threads once they are empty (writer or stopper only). */
+static void reap_orphans(void)
+{
+    pthread_mutex_lock(&g.lock);
+    LogRing *_Atomic *link = &g.rings;
+    LogRing *r;
+    while ((r = atomic_load(link)) != NULL) {
+        if (atomic_load(&r->orphaned) && !ring_peek(r)) {
+            atomic_store(link, r->next);
+            free(r->buf);
+            free(r);
+        } else {
+            link = &r->next;
+        }
+    }
+    pthread_mutex_unlock(&g.lock);
+}
+
+/*
+ * Free every ring, including those of threads that are still running
+ * (stopper only, once no producer can be inside submit). Their stale
+ * thread-local pointers are recognised by the generation count.
+ */
+static void free_all_rings(void)
+{
+    pthread_mutex_lock(&g.lock);
+    LogRing *r = atomic_load(&g.rings);
+    atomic_store(&g.rings, NULL);
+    atomic_fetch_add(&g.gen, 1);
+    pthread_mutex_unlock(&g.lock);
+    while (r) {
+        LogRing *next = r->next;
+        free(r->buf);
+        free(r);
+        r = next;
+    }
+}
+
+/* Write every published record, oldest sequence number first. */
+static void drain(OutBuf *ob)
+{
+    for (;;) {
+        LogRing *best = NULL;
+        const LogRecord *brec = NULL;
+        for (LogRing *r = atomic_load(&g.rings); r; r = r->next) {
+            const LogRecord *rec = ring_peek(r);
+            if (rec && (!brec || rec->seq < brec->seq)) {
+                best = r;
+                brec = rec;
+            }
+        }
+        if (!best)
+            break;
+        format_record(ob, best->id, brec, (const char *)(brec + 1));
+        atomic_fetch_add_explicit(&g.written, 1, memory_order_relaxed);
+        atomic_store_explicit(&best->head,
+                              atomic_load_explicit(&best->head, memory_order_relaxed) + brec->size,
+                              memory_order_release);
+    }
+    ob_flush(ob);
+    fflush(ob->out);
+    reap_orphans();
+}
+
+static void *writer_main(void *arg)
+{
+    OutBuf *ob = arg;
+    pthread_mutex_lock(&g.lock);
+    for (;;) {
+        uint64_t req = g.flush_req;
+        int stopping = g.stopping;
+        pthread_mutex_unlock(&g.lock);
+        drain(ob);
+        pthread_mutex_lock(&g.lock);
+        if (g.flush_done != req) {
+            g.flush_done = req;
+            pthread_cond_broadcast(&g.drained);
+        }
+        if (stopping)
+            break;
+        if (g.flush_req == req && !g.stopping) {
+            struct timespec until;
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_nsec += LOG_WRITER_IDLE_MS * 1000000L;
+            if (until.tv_nsec >= 1000000000L) {
+                until.tv_sec++;
+                until.tv_nsec -= 1000000000L;
+            }
+            atomic_store(&g.writer_idle, 1);
+            pthread_cond_timedwait(&g.wake, &g.lock, &until);
+            atomic_store(&g.writer_idle, 0);
+        }
+    }
+    pthread_mutex_unlock(&g.lock);
+    return NULL;
+}
+
+static int rate_text(char *buf, size_t size, const RateSlot *s)
+{
+    size_t n = strlen(s->fmt);
+    while (n && s->fmt[n - 1] == '\n')
+        n--;
+    if (n > 80)
+        n = 80;
+    return snprintf(buf, size, "(suppressed %d more like: %.*s)\n", s->suppressed, (int)n, s->fmt);
+}
+
+/* Queue the summary line of a slot that dropped messages. */
+static void rate_flush(LogRing *r, RateSlot *s, int64_t now)
+{
+    if (!s->suppressed)
+        return;
+    char line[160];
+    int n = rate_text(line, sizeof(line), s);
+    if (n > 0)
+        ring_push(r, s->level, s->module, line,
+                  (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1, now);
+    s->suppressed = 0;
+}
+
+/*
+ * Slot of call site `fmt`: its own slot, else a free one, else the one
+ * whose window started first, among LOG_RATE_PROBE slots from the hash.
+ * Call sites only share a slot when more than LOG_RATE_PROBE collide.
+ */
+static RateSlot *rate_slot(LogRing *r, const char *fmt)
+{
+    uintptr_t h = (uintptr_t)fmt;
+    h ^= h >> 7;
+    h ^= h >> 13;
+    RateSlot *victim = NULL;
+    for (int i = 0; i < LOG_RATE_PROBE; i++) {
+        RateSlot *s = &r->rate[(h + (uintptr_t)i) & (LOG_RATE_SLOTS - 1)];
+        if (s->fmt == fmt || !s->fmt)
+            return s;
+        if (!victim || s->window_us < victim->window_us)
+            victim = s;
+    }
+    return victim;
+}
+
+/*
+ * Per-call-site limit: at most g.rate messages per format string per
+ * second. When a window closes with messages dropped, one summary line
+ * is queued before the next message from that slot.
+ */
+static int rate_limited(LogRing *r, int level, const char *module, const char *fmt, int64_t now)
+{
+    RateSlot *s = rate_slot(r, fmt);
+    if (s->fmt != fmt || now - s->window_us >= 1000000) {
+        rate_flush(r, s, now);
+        s->fmt = fmt;
+        s->module = module;
+        s->level = level;
+        s->count = 0;
+        s->suppressed = 0;
+        s->window_us = now;
+    }
+    if (++s->count <= g.rate)
+        return 0;
+    s->suppressed++;
+    atomic_fetch_add_explicit(&g.suppressed, 1, memory_order_relaxed);
+    return 1;
+}
+
+int srt2dvb_log_async_submit(int level, const char *module, const char *fmt, va_list ap)
+{
+    if (!atomic_load(&g.accepting))
+        return -1;
+    atomic_fetch_add(&g.in_flight, 1);
+    /* Re-check after announcing ourselves; log_async_stop() clears
+     * accepting first and then waits for in_flight to reach zero. */
+    if (!atomic_load(&g.accepting)) {
+        atomic_fetch_sub(&g.in_flight, 1);
+        return -1;
+    }
+    LogRing *r = get_ring();
+    if (!r) {
+        atomic_fetch_sub(&g.in_flight, 1);
+        return -1;
+    }
+    int64_t now = now_us();
+    if (g.rate > 0 && rate_limited(r, level, module, fmt, now)) {
+        atomic_fetch_sub(&g.in_flight, 1);
+        return 0;
+    }
+
+    char stack[LOG_SCRATCH];
+    char *msg = stack;
+    size_t max_msg = r->cap / 4 - sizeof(LogRecord);
+    va_list aq;
+    va_copy(aq, ap);
+    int n = vsnprintf(stack, sizeof(stack), fmt, aq);
+    va_end(aq);
+    size_t len = n > 0 ? (size_t)n : 0;
+    if (len >= sizeof(stack)) {
+        if (len > max_msg)
+            len = max_msg;
+        char *heap = malloc(len + 1);
+        if (heap) {
+            vsnprintf(heap, len + 1, fmt, ap);
+            msg = heap;
+        } else {
+            len = sizeof(stack) - 1;
+        }
+    }
+    if (len > max_msg)
+        len = max_msg;
+    ring_push(r, level, module, msg, len, now);
+    if (msg != stack)
+        free(msg);
+    atomic_fetch_sub(&g.in_flight, 1);
+    return 0;
+}
+
+void srt2dvb_log_set_context(int track, int cue, int64_t pts90)
+{
+    tls_ctx.track = track;
+    tls_ctx.cue = cue;
+    tls_ctx.pts90 = pts90;
+}
+
+int log_format_parse(const char *s, LogFormat *out)
+{
+    if (!s || !out)
+        return -1;
+    if (strcmp(s, "text") == 0)
+        *out = LOG_FORMAT_TEXT;
+    else if (strcmp(s, "json") == 0)
+        *out = LOG_FORMAT_JSON;
+    else
+        return -1;
+    return 0;
+}
+
+int log_async_start(const LogAsyncConfig *cfg)
+{
+    pthread_mutex_lock(&g.lock);
+    if (g.running) {
+        pthread_mutex_unlock(&g.lock);
+        return -1;
+    }
+    if (!g.ob.buf)
+        g.ob.buf = malloc(LOG_OUTBUF);
+    if (!g.ob.buf) {
+        pthread_mutex_unlock(&g.lock);
+        return -1;
+    }
+    size_t want = cfg && cfg->ring_bytes ? cfg->ring_bytes : LOG_RING_DEFAULT;
+    size_t cap = LOG_RING_MIN;
+    while (cap < want)
+        cap <<= 1;
+    g.ring_bytes = cap;
+    g.format = cfg ? cfg->format : LOG_FORMAT_TEXT;
+    g.rate = cfg && cfg->rate_per_sec > 0 ? cfg->rate_per_sec : 0;
+    g.out = cfg && cfg->out ? cfg->out : stderr;
+    g.ob.out = g.out;
+    g.ob.len = 0;
+    g.stopping = 0;
+    g.closing = 0;
+    g.flush_req = g.flush_done = 0;
+    atomic_store(&g.written, 0);
+    atomic_store(&g.suppressed, 0);
+    if (pthread_create(&g.thread, NULL, writer_main, &g.ob) != 0) {
+        pthread_mutex_unlock(&g.lock);
+        return -1;
+    }
+    g.running = 1;
+    atomic_store(&g.accepting, 1);
+    pthread_mutex_unlock(&g.lock);
+    return 0;
+}
+
+void log_async_flush(void)
+{
+    pthread_mutex_lock(&g.lock);
+    if (g.running && !g.stopping) {
+        uint64_t ticket = ++g.flush_req;
+        pthread_cond_signal(&g.wake);
+        while (g.flush_done < ticket && !g.stopping)
+            pthread_cond_wait(&g.drained, &g.lock);
+    }
+    pthread_mutex_unlock(&g.lock);
+}
+
+void log_async_stop(void)
+{
+    pthread_mutex_lock(&g.lock);
+    if (!g.running || g.closing) {
+        pthread_mutex_unlock(&g.lock);
+        return;
+    }
+    g.closing = 1;
+    atomic_store(&g.accepting, 0);
+    pthread_mutex_unlock(&g.lock);
+
+    /* Producers blocked on a full ring still have a live writer. */
+    while (atomic_load(&g.in_flight) > 0)
+        sched_yield();
+
+    pthread_mutex_lock(&g.lock);
+    g.stopping = 1;
+    pthread_cond_signal(&g.wake);
+    pthread_cond_broadcast(&g.drained);
+    pthread_mutex_unlock(&g.lock);
+    pthread_join(g.thread, NULL);
+
+    /* Nobody produces any more: report what the rate limit still holds. */
+    for (LogRing *r = atomic_load(&g.rings); r; r = r->next) {
+        for (int i = 0; i < LOG_RATE_SLOTS; i++) {
+            RateSlot *s = &r->rate[i];
+            if (s->suppressed) {
+                char line[160];
+                int n = rate_text(line, sizeof(line), s);
+                LogRecord rec = {
+                    .msg_len = n > 0 ? (uint32_t)((size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1) : 0,
+                    .seq = atomic_fetch_add(&g.seq, 1),
+                    .ts_us = now_us(),
+                    .pts90 = -1,
+                    .module = s->module,
+                    .level = s->level,
+                    .track = -1,
+                    .cue = -1,
+                };
+                format_record(&g.ob, r->id, &rec, line);
+            }
+            memset(s, 0, sizeof(*s));
+        }
+    }
+    ob_flush(&g.ob);
+    fflush(g.out);
+    free_all_rings();
+
+    pthread_mutex_lock(&g.lock);
+    g.running = 0;
+    pthread_mutex_unlock(&g.lock);
+}
+
+int log_async_active(void)
+{
+    return atomic_load(&g.accepting);
+}
+
+void log_async_stats(uint64_t *written, uint64_t *suppressed)
+{
+    if (written)
+        *written = atomic_load(&g.written);
+    if (suppressed)
+        *suppressed = atomic_load(&g.suppressed);
+}
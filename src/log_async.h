@@ -0,0 +1,126 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef LOG_ASYNC_H
+#define LOG_ASYNC_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file log_async.h
+ * @brief Asynchronous LOG() backend: per-thread rings and a writer thread.
+ *
+ * Without a backend, LOG() formats straight into stderr under the stdio
+ * lock, so debug runs serialise the demux loop and the render workers on
+ * that lock and lines from different threads can interleave. Once
+ * log_async_start() has run, LOG() instead formats the message into a ring
+ * buffer owned by the calling thread (single producer, single consumer,
+ * no locks on the hot path) and a background thread merges the rings in
+ * submission order and writes them out in large blocks.
+ *
+ * Records carry the level, module, thread and the thread's current
+ * track/cue/PTS context (see LOG_CONTEXT() in debug.h), which the JSON
+ * lines format emits as fields. A per-call-site rate limit collapses
+ * repetitive messages into one "suppressed" line per second.
+ *
+ * A producer whose ring is full waits for the writer, so no message is
+ * dropped except by the rate limit.
+ */
+
+/** Output format of the writer thread. */
+typedef enum {
+    LOG_FORMAT_TEXT = 0,    /**< "[module] message", as the direct path prints */
+    LOG_FORMAT_JSON = 1     /**< one JSON object per line */
+} LogFormat;
+
+typedef struct LogAsyncConfig {
+    LogFormat format;
+    int rate_per_sec;   /**< messages per second per call site, 0 = unlimited */
+    FILE *out;          /**< destination, NULL = stderr */
+    size_t ring_bytes;  /**< per-thread ring size, 0 = default (64 KiB) */
+} LogAsyncConfig;
+
+/** Parse "text" or "json". Returns 0 on success, -1 otherwise. */
+int log_format_parse(const char *s, LogFormat *out);
+
+/**
+ * Start the writer thread and route LOG() through it. Returns 0 on
+ * success, -1 if already running or the thread could not be started.
+ */
+int log_async_start(const LogAsyncConfig *cfg);
+
+/** Block until every message submitted so far has been written. */
+void log_async_flush(void);
+
+/**
+ * Write out pending messages and suppression counts, stop the writer and
+ * return LOG() to direct stderr writes. Every thread's ring is freed,
+ * including those of threads still running; they get a new one if the
+ * backend is started again. Safe to call when not running.
+ */
+void log_async_stop(void);
+
+/** Non-zero while the backend is accepting messages. */
+int log_async_active(void);
+
+/** Messages written and messages dropped by the rate limit since start. */
+void log_async_stats(uint64_t *written, uint64_t *suppressed);
+
+/*
+ * Entry points used by debug.h. submit returns 0 when the message was
+ * taken (queued or rate limited) and -1 when the backend is not running,
+ * in which case the caller writes it directly. Context values < 0 mean
+ * "not set".
+ */
+int srt2dvb_log_async_submit(int level, const char *module, const char *fmt, va_list ap);
+void srt2dvb_log_set_context(int track, int cue, int64_t pts90);
+
+#endif /* LOG_ASYNC_H */
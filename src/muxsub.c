@@ -51,8 +51,8 @@
  *
  * Helper to encode an AVSubtitle using the provided encoder context and
  * write the resulting packet into the output format context. This file
- * provides a single exported helper `encode_and_write_subtitle` used by
- * the main program flow. The implementation documents buffer ownership,
+ * provides `encode_and_write_subtitle` used by the main program flow and
+ * `write_subtitle_payload` for bytes already encoded by render workers. The implementation documents buffer ownership,
  * bench timing updates and conditional debug logging.
  */
 
@@ -63,8 +63,10 @@
 #include <libavutil/avutil.h>
 #include <libavutil/mem.h>
 #include "subtrack.h"
+#include "muxsub.h"
 #include "bench.h"
 #include "mux_write.h"
+#include "dvb_sub.h"
 /* Provide a short module name for LOG() */
 #define DEBUG_MODULE "muxsub"
 #include "debug.h"
@@ -78,8 +80,6 @@ extern int debug_level;
 #define SUB_BUF_SIZE 65536
 /* Maximum buffer size we'll grow to automatically (1 MiB). */
 #define MAX_SUB_BUF_SIZE (1<<20)
-/* Number of times the encoder must fill the buffer before we auto-grow. */
-#define FULL_COUNT_THRESHOLD 2
 
 /*
 * encode_and_write_subtitle
@@ -145,8 +145,24 @@ void encode_and_write_subtitle(AVCodecContext *ctx,
 
     /* Encode and optionally measure encode time for bench stats. */
     int64_t t_enc = bench_now();
-    int size = avcodec_encode_subtitle(ctx, tmpbuf, SUB_BUF_SIZE, sub);
-    
+    int size = avcodec_encode_subtitle(ctx, tmpbuf, (int)track->enc_tmpbuf_size, sub);
+    /* A full (or rejected) buffer may mean truncation: grow and retry the
+     * same cue, as the render workers do (sub_encode.c). Otherwise a large
+     * cue would be dropped here but muxed when a worker encodes it, and
+     * the output would depend on --render-threads. */
+    while ((size < 0 || (size_t)size >= track->enc_tmpbuf_size) &&
+           track->enc_tmpbuf_size < MAX_SUB_BUF_SIZE) {
+        size_t new_size = track->enc_tmpbuf_size * 2;
+        if (new_size > MAX_SUB_BUF_SIZE) new_size = MAX_SUB_BUF_SIZE;
+        uint8_t *newbuf = av_realloc(track->enc_tmpbuf, new_size);
+        if (!newbuf) break;
+        track->enc_tmpbuf = tmpbuf = newbuf;
+        track->enc_tmpbuf_size = new_size;
+        LOG(2, "grew per-track encode buffer to %zu bytes for stream %d\n",
+            new_size, track->stream->index);
+        size = avcodec_encode_subtitle(ctx, tmpbuf, (int)new_size, sub);
+    }
+
     /*
      * If debugging is enabled (debug_level > 0), this statement logs the return value
      * of the avcodec_encode_subtitle function to stderr, prefixed with "[muxsub]".
@@ -176,33 +192,41 @@ void encode_and_write_subtitle(AVCodecContext *ctx,
     if (bench_mode)
         bench_inc_cues_encoded();
 
-    /* If the encoder returned exactly the provided buffer size there is a
-     * risk the output was truncated. Log this at debug level to help tune
-     * SUB_BUF_SIZE if necessary. */
+    /* Still full at the size cap: the payload may be truncated. */
     if ((size_t)size >= track->enc_tmpbuf_size) {
-        /* Encoder filled the buffer (or reported equal): increment counter
-         * and consider growing the buffer after a few occurrences. */
         track->enc_tmpbuf_full_count++;
-        LOG(2, "encoder filled buffer (%zu bytes) [stream=%d pts=%lld] count=%d\n",
+        LOG(1, "encoder filled the %zu-byte buffer, payload may be truncated [stream=%d pts=%lld] count=%d\n",
             track->enc_tmpbuf_size, track->stream->index, (long long)pts90, track->enc_tmpbuf_full_count);
-        if (track->enc_tmpbuf_full_count >= FULL_COUNT_THRESHOLD && track->enc_tmpbuf_size < MAX_SUB_BUF_SIZE) {
-            size_t new_size = track->enc_tmpbuf_size * 2;
-            if (new_size > MAX_SUB_BUF_SIZE) new_size = MAX_SUB_BUF_SIZE;
-            uint8_t *newbuf = av_realloc(track->enc_tmpbuf, new_size);
-            if (newbuf) {
-                track->enc_tmpbuf = newbuf;
-                track->enc_tmpbuf_size = new_size;
-                LOG(1, "increased per-track encode buffer to %zu bytes for stream %d\n", new_size, track->stream->index);
-            } else {
-                LOG(1, "failed to grow per-track encode buffer to %zu bytes for stream %d\n", new_size, track->stream->index);
-            }
-            track->enc_tmpbuf_full_count = 0;
-        }
-    } else {
-        /* Reset counter when output fits comfortably. */
-        track->enc_tmpbuf_full_count = 0;
     }
-    
+
+    /* The buffer may have been grown (and moved) above. */
+    write_subtitle_payload(out_fmt, track, track->enc_tmpbuf, size, pts90, bench_mode, dbg_png);
+}
+
+/*
+* write_subtitle_payload
+* ----------------------
+* Wrap already-encoded subtitle bytes into an AVPacket, re-stamp the DVB
+* version fields with the track's own counter, enforce per-track PTS
+* monotonicity and write the packet into `out_fmt`. This is the only
+* work the mux thread does for cues encoded by render workers.
+*
+* Ownership summary:
+*  - The caller retains ownership of `data`; the bytes are copied.
+*/
+void write_subtitle_payload(AVFormatContext *out_fmt,
+                            SubTrack *track,
+                            const uint8_t *data,
+                            int size,
+                            int64_t pts90,
+                            int bench_mode,
+                            const char *dbg_png)
+{
+    if (!out_fmt || !track || !track->stream || !data || size <= 0) {
+        LOG(1, "Invalid subtitle payload write request\n");
+        return;
+    }
+
     /**
      * Allocates an AVPacket structure and returns a pointer to it.
      * The AVPacket is used to store compressed data (such as audio or video frames)
@@ -215,7 +239,7 @@ void encode_and_write_subtitle(AVCodecContext *ctx,
     
     /**
      * Checks if the packet pointer 'pkt' is NULL.
-     * If 'pkt' is NULL, frees the memory allocated for 'tmpbuf' and returns from the function.
+     * If 'pkt' is NULL, logs and returns from the function.
      * This prevents further processing when there is no valid packet and ensures proper memory cleanup.
      */
     if (!pkt) {
@@ -239,10 +263,15 @@ void encode_and_write_subtitle(AVCodecContext *ctx,
     }
 
     /*
-     * Copies 'size' bytes from the temporary buffer 'tmpbuf' into the packet's data buffer 'pkt->data'.
-     * This operation overwrites the contents of 'pkt->data' with the data from 'tmpbuf'.
+     * Copies 'size' bytes from the caller's payload 'data' into the packet's data buffer 'pkt->data'.
+     * This operation overwrites the contents of 'pkt->data' with the encoded bytes.
      */
-    memcpy(pkt->data, tmpbuf, size);
+    memcpy(pkt->data, data, size);
+
+    /* Keep DVB page/region/object versions advancing per stream no matter
+     * which encoder context produced the bytes. */
+    dvb_sub_restamp_versions(pkt->data, size, track->dvb_version);
+    track->dvb_version = (track->dvb_version + 1) & 0x0f;
     
     /* Attach packet to the track's stream; caller must ensure track->stream. */
     pkt->stream_index = track->stream->index;
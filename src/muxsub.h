@@ -85,4 +85,18 @@ void encode_and_write_subtitle(AVCodecContext *ctx,
                                       int bench_mode,
                                       const char *dbg_png);
 
+/**
+ * Write already-encoded DVB subtitle bytes (e.g. produced by a render
+ * worker) as a packet on `track`'s stream. The DVB version fields are
+ * re-stamped with the track's counter and PTS monotonicity is enforced
+ * exactly as in encode_and_write_subtitle(). The caller keeps `data`.
+ */
+void write_subtitle_payload(AVFormatContext *out_fmt,
+                            SubTrack *track,
+                            const uint8_t *data,
+                            int size,
+                            int64_t pts90,
+                            int bench_mode,
+                            const char *dbg_png);
+
 #endif
\ No newline at end of file
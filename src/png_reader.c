@@ -0,0 +1,219 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * png_reader.c
+ * ------------
+ * Palette PNG decoder for the golden-image tools; see png_reader.h.
+ */
+
+#include "png_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+/* Larger images are not subtitle frames; refuse them rather than
+ * allocating whatever a corrupt header asks for. */
+#define PNG_READER_MAX_DIM 16384
+
+static uint32_t be32(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline unsigned paeth(unsigned a, unsigned b, unsigned c) {
+    int p = (int)a + (int)b - (int)c;
+    int pa = abs(p - (int)a), pb = abs(p - (int)b), pc = abs(p - (int)c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+/* Undo filter `type` on row[0..n) in place (prior row `prev`, NULL for
+ * the first). One byte is the left neighbour for every depth <= 8. */
+static int unfilter_row(int type, uint8_t *row, const uint8_t *prev, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        unsigned a = i ? row[i - 1] : 0;
+        unsigned b = prev ? prev[i] : 0;
+        unsigned c = (i && prev) ? prev[i - 1] : 0;
+        switch (type) {
+        case 0: return 0;
+        case 1: row[i] = (uint8_t)(row[i] + a); break;
+        case 2: row[i] = (uint8_t)(row[i] + b); break;
+        case 3: row[i] = (uint8_t)(row[i] + ((a + b) >> 1)); break;
+        case 4: row[i] = (uint8_t)(row[i] + paeth(a, b, c)); break;
+        default: return -1;
+        }
+    }
+    return type >= 0 && type <= 4 ? 0 : -1;
+}
+
+void png_indexed_free(PngIndexed *img) {
+    if (!img) return;
+    free(img->idx);
+    memset(img, 0, sizeof(*img));
+}
+
+int png_decode_indexed(const unsigned char *data, size_t len, PngIndexed *out) {
+    static const unsigned char sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    if (!out) return -1;
+    memset(out, 0, sizeof(*out));
+    if (!data || len < 8 || memcmp(data, sig, 8) != 0) return -1;
+
+    int w = 0, h = 0, depth = 0, have_ihdr = 0, have_iend = 0;
+    unsigned char *z = NULL;
+    size_t zlen = 0, zcap = 0;
+    size_t pos = 8;
+    while (pos + 12 <= len && !have_iend) {
+        uint32_t n = be32(data + pos);
+        const unsigned char *type = data + pos + 4;
+        const unsigned char *body = data + pos + 8;
+        if (n > len - pos - 12) break;
+        uLong crc = crc32(crc32(0L, Z_NULL, 0), type, (uInt)(4 + n));
+        if (crc != be32(body + n)) break;
+
+        if (memcmp(type, "IHDR", 4) == 0 && n == 13) {
+            w = (int)be32(body);
+            h = (int)be32(body + 4);
+            depth = body[8];
+            /* palette colour type, deflate, adaptive filtering, no interlace */
+            if (body[9] != 3 || body[10] != 0 || body[11] != 0 || body[12] != 0) break;
+            if (depth != 1 && depth != 2 && depth != 4 && depth != 8) break;
+            if (w <= 0 || h <= 0 || w > PNG_READER_MAX_DIM || h > PNG_READER_MAX_DIM) break;
+            have_ihdr = 1;
+        } else if (memcmp(type, "PLTE", 4) == 0 && n % 3 == 0 && n / 3 <= 256) {
+            out->ncolors = (int)(n / 3);
+            for (int i = 0; i < out->ncolors; i++)
+                out->palette[i] = 0xFF000000u | ((uint32_t)body[3 * i] << 16) |
+                                  ((uint32_t)body[3 * i + 1] << 8) | body[3 * i + 2];
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            for (uint32_t i = 0; i < n && i < (uint32_t)out->ncolors; i++)
+                out->palette[i] = (out->palette[i] & 0x00FFFFFFu) | ((uint32_t)body[i] << 24);
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            if (zlen + n > zcap) {
+                size_t cap = zcap ? zcap : 4096;
+                while (cap < zlen + n) cap *= 2;
+                unsigned char *nz = realloc(z, cap);
+                if (!nz) break;
+                z = nz;
+                zcap = cap;
+            }
+            memcpy(z + zlen, body, n);
+            zlen += n;
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            have_iend = 1;
+        }
+        pos += 12 + (size_t)n;
+    }
+    if (!have_ihdr || !have_iend || out->ncolors == 0 || !z) {
+        free(z);
+        memset(out, 0, sizeof(*out));
+        return -1;
+    }
+
+    const int ppb = 8 / depth;
+    const size_t packed_len = ((size_t)w + ppb - 1) / ppb;
+    const size_t row_len = packed_len + 1;
+    uLongf raw_len = (uLongf)(row_len * (size_t)h);
+    uint8_t *raw = malloc(raw_len);
+    out->idx = malloc((size_t)w * (size_t)h);
+    int rc = (raw && out->idx) ? 0 : -1;
+    if (rc == 0) {
+        uLongf got = raw_len;
+        rc = (uncompress(raw, &got, z, (uLong)zlen) == Z_OK && got == raw_len) ? 0 : -1;
+    }
+    free(z);
+
+    const uint8_t *prev = NULL;
+    for (int y = 0; y < h && rc == 0; y++) {
+        uint8_t *row = raw + (size_t)y * row_len;
+        rc = unfilter_row(row[0], row + 1, prev, packed_len);
+        prev = row + 1;
+        uint8_t *dst = out->idx + (size_t)y * w;
+        const unsigned mask = (1u << depth) - 1;
+        for (int x = 0; x < w && rc == 0; x++) {
+            unsigned byte = row[1 + x / ppb];
+            unsigned v = (byte >> (8 - depth * (x % ppb + 1))) & mask;
+            if (v >= (unsigned)out->ncolors) rc = -1;
+            dst[x] = (uint8_t)v;
+        }
+    }
+    free(raw);
+    if (rc != 0) {
+        png_indexed_free(out);
+        return -1;
+    }
+    out->w = w;
+    out->h = h;
+    return 0;
+}
+
+int png_read_indexed_file(const char *path, PngIndexed *out) {
+    if (out) memset(out, 0, sizeof(*out));
+    FILE *f = path ? fopen(path, "rb") : NULL;
+    if (!f) return -1;
+    unsigned char *buf = NULL;
+    size_t len = 0, cap = 0;
+    int rc = 0;
+    for (;;) {
+        if (len == cap) {
+            size_t ncap = cap ? cap * 2 : 65536;
+            unsigned char *nb = realloc(buf, ncap);
+            if (!nb) { rc = -1; break; }
+            buf = nb;
+            cap = ncap;
+        }
+        size_t got = fread(buf + len, 1, cap - len, f);
+        len += got;
+        if (got == 0) break;
+    }
+    if (ferror(f)) rc = -1;
+    fclose(f);
+    if (rc == 0) rc = png_decode_indexed(buf, len, out);
+    free(buf);
+    return rc;
+}
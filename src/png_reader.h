@@ -0,0 +1,89 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef PNG_READER_H
+#define PNG_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file png_reader.h
+ * @brief Palette PNG decoder, the counterpart of png_writer.h.
+ *
+ * Reads colour type 3 (palette) PNGs back into a one-byte-per-pixel
+ * index plane and an ARGB palette (PLTE colours, tRNS alpha). Bit depths
+ * 1, 2, 4 and 8 and all five row filters are accepted; interlaced and
+ * non-palette images are rejected. Used by the golden-image tools in
+ * testharness/ to compare rendered cues by index, not by RGB.
+ */
+
+/** Decoded palette image. Release with png_indexed_free(). */
+typedef struct {
+    int w, h;
+    uint8_t *idx;          /**< w*h indices, row-major, no padding */
+    uint32_t palette[256]; /**< ARGB (straight alpha); entries past ncolors are 0 */
+    int ncolors;           /**< PLTE entries */
+} PngIndexed;
+
+/**
+ * Decode a palette PNG held in memory.
+ *
+ * @return 0 on success, -1 on malformed/unsupported input or allocation
+ *         failure (`out` is then left empty).
+ */
+int png_decode_indexed(const unsigned char *data, size_t len, PngIndexed *out);
+
+/** png_decode_indexed() on the contents of `path`. */
+int png_read_indexed_file(const char *path, PngIndexed *out);
+
+/** Free the index plane and reset `img`. Safe on an empty image. */
+void png_indexed_free(PngIndexed *img);
+
+#endif /* PNG_READER_H */
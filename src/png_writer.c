@@ -0,0 +1,373 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * png_writer.c
+ * ------------
+ * Palette PNG encoder used by debug_png.c; see png_writer.h.
+ */
+
+#include "png_writer.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+/* Rows per parallel deflate band are at least this many, so tiny cues
+ * never pay for thread start-up. */
+#define PNG_MIN_BAND_ROWS 64
+#define PNG_MAX_THREADS 16
+
+PngWriterOptions png_writer_default_options(void) {
+    PngWriterOptions o = { 6, PNG_FILTER_NONE, 1 };
+    return o;
+}
+
+int png_filter_parse(const char *s, PngFilterStrategy *out) {
+    if (!s || !out) return -1;
+    if (strcmp(s, "none") == 0) *out = PNG_FILTER_NONE;
+    else if (strcmp(s, "sub") == 0) *out = PNG_FILTER_SUB;
+    else if (strcmp(s, "up") == 0) *out = PNG_FILTER_UP;
+    else if (strcmp(s, "paeth") == 0) *out = PNG_FILTER_PAETH;
+    else if (strcmp(s, "adaptive") == 0) *out = PNG_FILTER_ADAPTIVE;
+    else return -1;
+    return 0;
+}
+
+/* Growable output buffer. */
+typedef struct {
+    unsigned char *data;
+    size_t len, cap;
+    int failed;
+} PngBuf;
+
+static void buf_put(PngBuf *b, const void *p, size_t n) {
+    if (b->failed) return;
+    if (b->len + n > b->cap) {
+        size_t cap = b->cap ? b->cap : 1024;
+        while (cap < b->len + n) cap *= 2;
+        unsigned char *d = realloc(b->data, cap);
+        if (!d) { b->failed = 1; return; }
+        b->data = d;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->len, p, n);
+    b->len += n;
+}
+
+static void buf_reserve(PngBuf *b, size_t cap) {
+    if (b->failed || cap <= b->cap) return;
+    unsigned char *d = realloc(b->data, cap);
+    if (!d) { b->failed = 1; return; }
+    b->data = d;
+    b->cap = cap;
+}
+
+static void buf_be32(PngBuf *b, uint32_t v) {
+    unsigned char x[4] = { (unsigned char)(v >> 24), (unsigned char)(v >> 16),
+                           (unsigned char)(v >> 8), (unsigned char)v };
+    buf_put(b, x, 4);
+}
+
+static void put_chunk(PngBuf *b, const char type[4], const unsigned char *data, size_t n) {
+    buf_be32(b, (uint32_t)n);
+    buf_put(b, type, 4);
+    if (n) buf_put(b, data, n);
+    uLong crc = crc32(0L, (const Bytef *)type, 4);
+    if (n) crc = crc32(crc, data, (uInt)n);
+    buf_be32(b, (uint32_t)crc);
+}
+
+static inline unsigned paeth(unsigned a, unsigned b, unsigned c) {
+    int p = (int)a + (int)b - (int)c;
+    int pa = abs(p - (int)a), pb = abs(p - (int)b), pc = abs(p - (int)c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+/* Apply filter `type` to `row` (prior row `prev`, NULL for the first)
+ * into out[1..n]; out[0] receives the type. Filters work on bytes, with
+ * a one-byte left neighbour for every bit depth <= 8. */
+static void filter_row(int type, const uint8_t *row, const uint8_t *prev, size_t n, uint8_t *out) {
+    out[0] = (uint8_t)type;
+    uint8_t *o = out + 1;
+    if (type == 0) {
+        memcpy(o, row, n);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        unsigned a = i ? row[i - 1] : 0;
+        unsigned b = prev ? prev[i] : 0;
+        unsigned c = (i && prev) ? prev[i - 1] : 0;
+        switch (type) {
+        case 1: o[i] = (uint8_t)(row[i] - a); break;
+        case 2: o[i] = (uint8_t)(row[i] - b); break;
+        case 4: o[i] = (uint8_t)(row[i] - paeth(a, b, c)); break;
+        default: o[i] = row[i]; break;
+        }
+    }
+}
+
+/* Sum of bytes read as signed values: the usual heuristic for picking
+ * the filter that leaves the smallest residuals. */
+static unsigned long residual_cost(const uint8_t *f, size_t n) {
+    unsigned long s = 0;
+    for (size_t i = 0; i < n; i++)
+        s += f[i] < 128 ? f[i] : 256 - f[i];
+    return s;
+}
+
+typedef struct {
+    const uint8_t *in;  /* filtered rows for this band */
+    size_t in_len;
+    int level;
+    int last;           /* finish the stream (else sync-flush) */
+    unsigned char *out; /* raw deflate segment */
+    size_t out_len;
+    int rc;
+} DeflateBand;
+
+static void *deflate_band(void *arg) {
+    DeflateBand *b = arg;
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    b->rc = -1;
+    if (deflateInit2(&zs, b->level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return NULL;
+    size_t cap = deflateBound(&zs, (uLong)b->in_len) + 16;
+    b->out = malloc(cap);
+    if (b->out) {
+        zs.next_in = (Bytef *)b->in;
+        zs.avail_in = (uInt)b->in_len;
+        zs.next_out = b->out;
+        zs.avail_out = (uInt)cap;
+        int zr = deflate(&zs, b->last ? Z_FINISH : Z_SYNC_FLUSH);
+        if ((b->last && zr == Z_STREAM_END) || (!b->last && zr == Z_OK && zs.avail_in == 0)) {
+            b->out_len = cap - zs.avail_out;
+            b->rc = 0;
+        }
+    }
+    deflateEnd(&zs);
+    return NULL;
+}
+
+/* zlib stream over `filtered`: header, raw deflate of each row band
+ * (bands compressed in parallel when nbands > 1), Adler-32 trailer. */
+static int compress_bands(const uint8_t *filtered, size_t row_len, int h, int level,
+                          int nbands, PngBuf *z) {
+    DeflateBand bands[PNG_MAX_THREADS];
+    pthread_t tids[PNG_MAX_THREADS];
+    int started[PNG_MAX_THREADS] = {0};
+    int rows_per = (h + nbands - 1) / nbands;
+    int n = 0;
+    for (int y = 0; y < h; y += rows_per, n++) {
+        int rows = (y + rows_per > h) ? h - y : rows_per;
+        bands[n] = (DeflateBand){ filtered + (size_t)y * row_len, (size_t)rows * row_len,
+                                  level, y + rows >= h, NULL, 0, -1 };
+    }
+    for (int i = 1; i < n; i++)
+        started[i] = pthread_create(&tids[i], NULL, deflate_band, &bands[i]) == 0;
+    deflate_band(&bands[0]);
+    for (int i = 1; i < n; i++) {
+        if (started[i]) pthread_join(tids[i], NULL);
+        else deflate_band(&bands[i]); /* no thread: do it inline */
+    }
+
+    int rc = 0;
+    /* CMF/FLG: deflate, 32K window; FLEVEL mirrors the level. */
+    unsigned flevel = level <= 1 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    unsigned cmf = 0x78, flg = flevel << 6;
+    flg += 31 - ((cmf << 8) + flg) % 31;
+    unsigned char hdr[2] = { (unsigned char)cmf, (unsigned char)flg };
+    size_t total = 6;
+    for (int i = 0; i < n; i++)
+        total += bands[i].out_len;
+    buf_reserve(z, total);
+    buf_put(z, hdr, 2);
+    for (int i = 0; i < n; i++) {
+        if (bands[i].rc != 0) rc = -1;
+        else buf_put(z, bands[i].out, bands[i].out_len);
+        free(bands[i].out);
+    }
+    buf_be32(z, (uint32_t)adler32(adler32(0L, Z_NULL, 0), filtered, (uInt)((size_t)h * row_len)));
+    return (rc == 0 && !z->failed) ? 0 : -1;
+}
+
+int png_encode_indexed(const uint8_t *idx, int w, int h, int stride,
+                       const uint32_t *palette, int ncolors,
+                       const PngWriterOptions *opt,
+                       unsigned char **out, size_t *out_len) {
+    if (!out || !out_len) return -1;
+    *out = NULL;
+    *out_len = 0;
+    if (!idx || !palette || w <= 0 || h <= 0 || stride < w || ncolors < 1 || ncolors > 256)
+        return -1;
+    PngWriterOptions o = opt ? *opt : png_writer_default_options();
+    if (o.level < 0 || o.level > 9) o.level = 6;
+
+    const int depth = ncolors <= 2 ? 1 : ncolors <= 4 ? 2 : ncolors <= 16 ? 4 : 8;
+    const int ppb = 8 / depth; /* pixels per byte */
+    const size_t packed_len = ((size_t)w + ppb - 1) / ppb;
+    const size_t row_len = packed_len + 1;
+    if ((size_t)h > (SIZE_MAX / 2) / row_len) return -1;
+
+    uint8_t *rows = malloc(packed_len * 2);       /* current + previous packed row */
+    uint8_t *filtered = malloc(row_len * (size_t)h);
+    uint8_t *trial = o.filter == PNG_FILTER_ADAPTIVE ? malloc(row_len) : NULL;
+    if (!rows || !filtered || (o.filter == PNG_FILTER_ADAPTIVE && !trial)) {
+        free(rows); free(filtered); free(trial);
+        return -1;
+    }
+
+    int bad_index = 0;
+    uint8_t *cur = rows, *prev = NULL;
+    for (int y = 0; y < h; y++) {
+        const uint8_t *src = idx + (size_t)y * stride;
+        if (depth == 8) {
+            memcpy(cur, src, (size_t)w);
+            for (int x = 0; x < w; x++)
+                bad_index |= src[x] >= ncolors;
+        } else if (depth == 4) {
+            for (int x = 0; x + 1 < w; x += 2) {
+                bad_index |= (src[x] >= ncolors) | (src[x + 1] >= ncolors);
+                cur[x >> 1] = (uint8_t)((src[x] << 4) | (src[x + 1] & 0x0F));
+            }
+            if (w & 1) {
+                bad_index |= src[w - 1] >= ncolors;
+                cur[packed_len - 1] = (uint8_t)(src[w - 1] << 4);
+            }
+        } else {
+            /* Pack ppb pixels per byte, most significant first. */
+            for (size_t i = 0; i < packed_len; i++) {
+                unsigned byte = 0;
+                int x0 = (int)i * ppb;
+                for (int k = 0; k < ppb; k++) {
+                    unsigned v = x0 + k < w ? src[x0 + k] : 0;
+                    bad_index |= v >= (unsigned)ncolors;
+                    byte = (byte << depth) | (v & ((1u << depth) - 1));
+                }
+                cur[i] = (uint8_t)byte;
+            }
+        }
+        uint8_t *dst = filtered + (size_t)y * row_len;
+        if (o.filter == PNG_FILTER_ADAPTIVE) {
+            static const int types[] = { 0, 1, 2, 4 };
+            unsigned long best = ~0UL;
+            for (int t = 0; t < 4; t++) {
+                filter_row(types[t], cur, prev, packed_len, trial);
+                unsigned long cost = residual_cost(trial + 1, packed_len);
+                if (cost < best) {
+                    best = cost;
+                    memcpy(dst, trial, row_len);
+                }
+            }
+        } else {
+            static const int type_of[] = { 0, 1, 2, 4 };
+            filter_row(type_of[o.filter >= 0 && o.filter <= PNG_FILTER_PAETH ? o.filter : 0],
+                       cur, prev, packed_len, dst);
+        }
+        prev = cur;
+        cur = (cur == rows) ? rows + packed_len : rows;
+    }
+    free(rows);
+    free(trial);
+    if (bad_index) {
+        free(filtered);
+        return -1;
+    }
+
+    int nbands = 1;
+    if (o.threads > 1) {
+        nbands = h / PNG_MIN_BAND_ROWS;
+        if (nbands > o.threads) nbands = o.threads;
+        if (nbands > PNG_MAX_THREADS) nbands = PNG_MAX_THREADS;
+        if (nbands < 1) nbands = 1;
+    }
+    PngBuf z = {0};
+    int rc = compress_bands(filtered, row_len, h, o.level, nbands, &z);
+    free(filtered);
+    if (rc != 0) {
+        free(z.data);
+        return -1;
+    }
+
+    PngBuf b = {0};
+    buf_reserve(&b, z.len + 8 + 25 + 12 + 256 * 4 + 12 * 3);
+    static const unsigned char sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    buf_put(&b, sig, sizeof(sig));
+    unsigned char ihdr[13] = {
+        (unsigned char)(w >> 24), (unsigned char)(w >> 16), (unsigned char)(w >> 8), (unsigned char)w,
+        (unsigned char)(h >> 24), (unsigned char)(h >> 16), (unsigned char)(h >> 8), (unsigned char)h,
+        (unsigned char)depth, 3 /* palette */, 0, 0, 0
+    };
+    put_chunk(&b, "IHDR", ihdr, sizeof(ihdr));
+
+    unsigned char plte[256 * 3], trns[256];
+    int ntrns = 0;
+    for (int i = 0; i < ncolors; i++) {
+        uint32_t c = palette[i];
+        plte[i * 3 + 0] = (unsigned char)(c >> 16);
+        plte[i * 3 + 1] = (unsigned char)(c >> 8);
+        plte[i * 3 + 2] = (unsigned char)c;
+        trns[i] = (unsigned char)(c >> 24);
+        if (trns[i] != 0xFF) ntrns = i + 1; /* trailing opaque entries may be omitted */
+    }
+    put_chunk(&b, "PLTE", plte, (size_t)ncolors * 3);
+    if (ntrns) put_chunk(&b, "tRNS", trns, (size_t)ntrns);
+    put_chunk(&b, "IDAT", z.data, z.len);
+    put_chunk(&b, "IEND", NULL, 0);
+    free(z.data);
+
+    if (b.failed) {
+        free(b.data);
+        return -1;
+    }
+    *out = b.data;
+    *out_len = b.len;
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file png_writer.h
+ * @brief Native palette PNG encoder for indexed subtitle bitmaps.
+ *
+ * Writes colour type 3 (palette) PNGs straight from a one-byte-per-pixel
+ * index plane and an ARGB palette: PLTE carries the colours, tRNS the
+ * per-entry alpha, and pixels are packed at the smallest bit depth that
+ * holds the palette (4 bits for the usual 16 colours). This avoids
+ * expanding to ARGB32 and deflating four times the data, which is what
+ * the Cairo PNG path does.
+ *
+ * Compression is tunable: zlib level, PNG row filter strategy, and an
+ * optional band-parallel deflate where each band of rows is compressed
+ * on its own thread as a raw deflate segment ending in a sync flush, and
+ * the segments are concatenated into one zlib stream. Parallel output
+ * is slightly larger (no shared dictionary across band edges) but
+ * decodes identically.
+ */
+
+/** PNG row filter strategy. */
+typedef enum {
+    PNG_FILTER_NONE = 0, /**< filter type 0 on every row (best for palette images) */
+    PNG_FILTER_SUB,      /**< type 1 on every row */
+    PNG_FILTER_UP,       /**< type 2 on every row */
+    PNG_FILTER_PAETH,    /**< type 4 on every row */
+    PNG_FILTER_ADAPTIVE  /**< per row, the type with the smallest absolute sum */
+} PngFilterStrategy;
+
+/** Encoder settings. Zero-initialised means level 0 (stored); use
+ *  png_writer_default_options() for the defaults. */
+typedef struct {
+    int level;   /**< zlib level 0..9 */
+    int filter;  /**< PngFilterStrategy */
+    int threads; /**< >1 enables band-parallel deflate */
+} PngWriterOptions;
+
+/** Defaults: level 6, no filtering, single-threaded. */
+PngWriterOptions png_writer_default_options(void);
+
+/**
+ * Parse a --png-filter value: none, sub, up, paeth or adaptive.
+ *
+ * @return 0 on success, -1 if unknown.
+ */
+int png_filter_parse(const char *s, PngFilterStrategy *out);
+
+/**
+ * Encode an indexed image as a palette PNG into memory.
+ *
+ * @param idx       Index plane, `h` rows of `stride` bytes (first `w` used).
+ * @param palette   `ncolors` ARGB entries (straight alpha, host order).
+ * @param ncolors   1..256; every index in the image must be below it.
+ * @param opt       Settings, or NULL for the defaults.
+ * @param out       Receives a malloc()ed PNG stream (caller frees).
+ * @param out_len   Receives its size.
+ * @return 0 on success, -1 on invalid input or allocation/zlib failure.
+ */
+int png_encode_indexed(const uint8_t *idx, int w, int h, int stride,
+                       const uint32_t *palette, int ncolors,
+                       const PngWriterOptions *opt,
+                       unsigned char **out, size_t *out_len);
+
+#endif /* PNG_WRITER_H */
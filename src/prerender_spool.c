@@ -0,0 +1,341 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * prerender_spool.c
+ * -----------------
+ * Spool file writer/reader for --prerender. Payloads are streamed to the
+ * file with pwrite() as the pre-render pass collects them; the index is
+ * kept on the heap (24 bytes per cue) until prerender_spool_finish()
+ * appends it and maps the whole file read-only.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+#include "prerender_spool.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DEBUG_MODULE "spool"
+#include "debug.h"
+
+/* Upper bound on tracks accepted from a spool file header. */
+#define SPOOL_MAX_TRACKS 1024
+
+typedef struct SpoolHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t ntracks;
+    uint64_t nentries;
+    uint64_t index_offset;
+    uint64_t key;
+} SpoolHeader;
+
+struct PrerenderSpool {
+    int fd;               /* -1 once finished/mapped */
+    int ntracks;
+    uint64_t key;
+    uint64_t *track_base; /* first entry of each track; [ntracks] = nentries */
+    uint64_t nentries;
+    SpoolEntry *entries;  /* heap while writing, into the mapping after finish */
+    int entries_on_heap;
+    uint64_t write_off;
+    uint64_t payload_bytes;
+    uint8_t *map;
+    size_t map_len;
+    int finished;
+};
+
+static uint64_t align8(uint64_t v) { return (v + 7) & ~(uint64_t)7; }
+
+static int write_full(int fd, const void *buf, size_t len, uint64_t off) {
+    const uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, (off_t)off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        off += (uint64_t)n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static size_t counts_bytes(int ntracks) {
+    return (size_t)align8(sizeof(uint32_t) * (uint64_t)ntracks);
+}
+
+PrerenderSpool *prerender_spool_create(const char *path, int ntracks, const int *cue_counts,
+                                       uint64_t key) {
+    if (ntracks <= 0 || ntracks > SPOOL_MAX_TRACKS || !cue_counts) return NULL;
+
+    PrerenderSpool *sp = calloc(1, sizeof(*sp));
+    if (!sp) return NULL;
+    sp->fd = -1;
+    sp->ntracks = ntracks;
+    sp->key = key;
+    sp->track_base = calloc((size_t)ntracks + 1, sizeof(uint64_t));
+    if (!sp->track_base) goto fail;
+    for (int t = 0; t < ntracks; t++) {
+        int c = cue_counts[t] > 0 ? cue_counts[t] : 0;
+        sp->track_base[t + 1] = sp->track_base[t] + (uint64_t)c;
+    }
+    sp->nentries = sp->track_base[ntracks];
+    sp->entries = calloc(sp->nentries ? sp->nentries : 1, sizeof(SpoolEntry));
+    if (!sp->entries) goto fail;
+    sp->entries_on_heap = 1;
+
+    if (path) {
+        sp->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (sp->fd < 0) {
+            LOG(0, "cannot create spool '%s': %s\n", path, strerror(errno));
+            goto fail;
+        }
+    } else {
+        const char *tmpdir = getenv("TMPDIR");
+        char tmpl[4096];
+        snprintf(tmpl, sizeof(tmpl), "%s/srt2dvbsub-spool-XXXXXX",
+                 (tmpdir && *tmpdir) ? tmpdir : "/tmp");
+        sp->fd = mkstemp(tmpl);
+        if (sp->fd < 0) {
+            LOG(0, "cannot create temporary spool in '%s': %s\n",
+                (tmpdir && *tmpdir) ? tmpdir : "/tmp", strerror(errno));
+            goto fail;
+        }
+        unlink(tmpl);
+    }
+    sp->write_off = sizeof(SpoolHeader);
+    return sp;
+
+fail:
+    prerender_spool_close(sp);
+    return NULL;
+}
+
+int prerender_spool_append(PrerenderSpool *sp, int track, int cue, int64_t pts90,
+                           const uint8_t *data, int size) {
+    if (!sp || sp->finished || sp->fd < 0 || !data || size <= 0) return -1;
+    if (track < 0 || track >= sp->ntracks) return -1;
+    if (cue < 0 || (uint64_t)cue >= sp->track_base[track + 1] - sp->track_base[track]) return -1;
+
+    SpoolEntry *e = &sp->entries[sp->track_base[track] + (uint64_t)cue];
+    if (e->size) return -1;
+    if (write_full(sp->fd, data, (size_t)size, sp->write_off) != 0) {
+        LOG(0, "spool write failed: %s\n", strerror(errno));
+        return -1;
+    }
+    e->pts90 = pts90;
+    e->offset = sp->write_off;
+    e->size = (uint32_t)size;
+    sp->write_off += (uint64_t)size;
+    sp->payload_bytes += (uint64_t)size;
+    return 0;
+}
+
+int prerender_spool_finish(PrerenderSpool *sp) {
+    if (!sp || sp->finished || sp->fd < 0) return -1;
+
+    uint64_t index_off = align8(sp->write_off);
+    size_t cbytes = counts_bytes(sp->ntracks);
+    uint32_t *counts = calloc(1, cbytes ? cbytes : 1);
+    if (!counts) return -1;
+    for (int t = 0; t < sp->ntracks; t++)
+        counts[t] = (uint32_t)(sp->track_base[t + 1] - sp->track_base[t]);
+
+    SpoolHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, PRERENDER_SPOOL_MAGIC, sizeof(h.magic));
+    h.version = PRERENDER_SPOOL_VERSION;
+    h.ntracks = (uint32_t)sp->ntracks;
+    h.nentries = sp->nentries;
+    h.index_offset = index_off;
+    h.key = sp->key;
+
+    size_t ebytes = (size_t)sp->nentries * sizeof(SpoolEntry);
+    int rc = write_full(sp->fd, counts, cbytes, index_off);
+    if (rc == 0 && ebytes)
+        rc = write_full(sp->fd, sp->entries, ebytes, index_off + cbytes);
+    if (rc == 0)
+        rc = write_full(sp->fd, &h, sizeof(h), 0);
+    free(counts);
+    if (rc != 0) {
+        LOG(0, "spool index write failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    size_t len = (size_t)(index_off + cbytes + ebytes);
+    void *map = mmap(NULL, len, PROT_READ, MAP_SHARED, sp->fd, 0);
+    if (map == MAP_FAILED) {
+        LOG(0, "spool mmap failed: %s\n", strerror(errno));
+        return -1;
+    }
+    /* Payloads are read strictly in PTS order per track. */
+    posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+
+    free(sp->entries);
+    sp->entries_on_heap = 0;
+    sp->map = map;
+    sp->map_len = len;
+    sp->entries = (SpoolEntry *)(sp->map + index_off + cbytes);
+    close(sp->fd);
+    sp->fd = -1;
+    sp->finished = 1;
+    return 0;
+}
+
+PrerenderSpool *prerender_spool_open(const char *path) {
+    if (!path) return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(SpoolHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size_t len = (size_t)st.st_size;
+    uint8_t *map = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    PrerenderSpool *sp = calloc(1, sizeof(*sp));
+    if (!sp) {
+        munmap(map, len);
+        return NULL;
+    }
+    sp->fd = -1;
+    sp->map = map;
+    sp->map_len = len;
+
+    SpoolHeader h;
+    memcpy(&h, map, sizeof(h));
+    if (memcmp(h.magic, PRERENDER_SPOOL_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != PRERENDER_SPOOL_VERSION ||
+        h.ntracks == 0 || h.ntracks > SPOOL_MAX_TRACKS ||
+        (h.index_offset & 7) != 0 || h.index_offset < sizeof(SpoolHeader))
+        goto bad;
+
+    sp->ntracks = (int)h.ntracks;
+    sp->key = h.key;
+    size_t cbytes = counts_bytes(sp->ntracks);
+    if (h.index_offset > len || len - h.index_offset < cbytes ||
+        h.nentries > (len - h.index_offset - cbytes) / sizeof(SpoolEntry))
+        goto bad;
+
+    sp->track_base = calloc((size_t)sp->ntracks + 1, sizeof(uint64_t));
+    if (!sp->track_base) goto bad;
+    const uint32_t *counts = (const uint32_t *)(map + h.index_offset);
+    for (int t = 0; t < sp->ntracks; t++)
+        sp->track_base[t + 1] = sp->track_base[t] + counts[t];
+    if (sp->track_base[sp->ntracks] != h.nentries) goto bad;
+
+    sp->nentries = h.nentries;
+    sp->entries = (SpoolEntry *)(map + h.index_offset + cbytes);
+    for (uint64_t i = 0; i < sp->nentries; i++) {
+        const SpoolEntry *e = &sp->entries[i];
+        if (e->size && (e->offset < sizeof(SpoolHeader) || e->offset > h.index_offset ||
+                        e->size > h.index_offset - e->offset))
+            goto bad;
+        sp->payload_bytes += e->size;
+    }
+    sp->write_off = h.index_offset;
+    sp->finished = 1;
+    return sp;
+
+bad:
+    LOG(1, "'%s' is not a valid spool file\n", path);
+    prerender_spool_close(sp);
+    return NULL;
+}
+
+int prerender_spool_get(const PrerenderSpool *sp, int track, int cue, int64_t pts90,
+                        const uint8_t **data, int *size) {
+    if (!sp || !sp->finished || track < 0 || track >= sp->ntracks || cue < 0)
+        return 0;
+    uint64_t i = sp->track_base[track] + (uint64_t)cue;
+    if (i >= sp->track_base[track + 1]) return 0;
+    const SpoolEntry *e = &sp->entries[i];
+    if (!e->size || e->pts90 != pts90) return 0;
+    if (data) *data = sp->map + e->offset;
+    if (size) *size = (int)e->size;
+    return 1;
+}
+
+uint64_t prerender_spool_key(const PrerenderSpool *sp) {
+    return sp ? sp->key : 0;
+}
+
+int prerender_spool_track_count(const PrerenderSpool *sp) {
+    return sp ? sp->ntracks : 0;
+}
+
+int prerender_spool_cue_count(const PrerenderSpool *sp, int track) {
+    if (!sp || track < 0 || track >= sp->ntracks) return 0;
+    return (int)(sp->track_base[track + 1] - sp->track_base[track]);
+}
+
+uint64_t prerender_spool_payload_bytes(const PrerenderSpool *sp) {
+    return sp ? sp->payload_bytes : 0;
+}
+
+void prerender_spool_close(PrerenderSpool *sp) {
+    if (!sp) return;
+    if (sp->map) munmap(sp->map, sp->map_len);
+    if (sp->entries_on_heap) free(sp->entries);
+    if (sp->fd >= 0) close(sp->fd);
+    free(sp->track_base);
+    free(sp);
+}
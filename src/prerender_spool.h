@@ -0,0 +1,158 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef PRERENDER_SPOOL_H
+#define PRERENDER_SPOOL_H
+
+#include <stdint.h>
+
+/**
+ * @file prerender_spool.h
+ * @brief Memory-mapped spool of pre-encoded DVB subtitle payloads.
+ *
+ * With --prerender every cue of every track is rendered and DVB-encoded
+ * by the render pool before demuxing starts. The payloads are appended
+ * to a spool file as they complete, and once the spool is finished the
+ * file is mapped read-only so the demux loop can splice each payload
+ * straight into the output without holding the whole set on the heap.
+ *
+ * File layout (host byte order):
+ * @code
+ *   header   : "S2DSPOOL" | u32 version | u32 ntracks | u64 nentries | u64 index_offset | u64 key
+ *   payloads : encoded DVB display sets, back to back
+ *   index    : u32 cue_count[ntracks] (padded to 8) | SpoolEntry[nentries]
+ * @endcode
+ * Entries are dense per track (track 0 cues, then track 1 cues, ...),
+ * so a lookup is a single array access. A zero-size entry marks a cue
+ * that was not pre-encoded; the caller falls back to the live path.
+ *
+ * `key` is a caller-chosen fingerprint of everything that shaped the
+ * payloads (options, cue text, canvas). A kept spool is only reused by a
+ * later run whose key matches; see prerender_spool_key().
+ *
+ * A spool is written by one thread (the pre-render collector) and is
+ * read-only once finished.
+ */
+
+#define PRERENDER_SPOOL_MAGIC "S2DSPOOL"
+#define PRERENDER_SPOOL_VERSION 2
+
+/** One index record. */
+typedef struct SpoolEntry {
+    int64_t pts90;   /**< absolute PTS the payload was encoded for */
+    uint64_t offset; /**< byte offset of the payload in the file */
+    uint32_t size;   /**< payload size; 0 = not pre-encoded */
+    uint32_t flags;  /**< reserved, 0 */
+} SpoolEntry;
+
+typedef struct PrerenderSpool PrerenderSpool;
+
+/**
+ * Create a spool for `ntracks` tracks with `cue_counts[t]` cues each.
+ *
+ * @param path File to write. NULL creates an anonymous spool in $TMPDIR
+ *             (or /tmp) that is unlinked immediately and vanishes on close.
+ * @param key  Fingerprint stored in the header (see prerender_spool_key()).
+ * @return New spool in write mode, or NULL on error (logged).
+ */
+PrerenderSpool *prerender_spool_create(const char *path, int ntracks, const int *cue_counts,
+                                       uint64_t key);
+
+/**
+ * Append the payload for cue `cue` of `track`. The bytes are copied to
+ * the file; the caller keeps `data`. Each cue may be written once.
+ *
+ * @return 0 on success, -1 on invalid slot or I/O error.
+ */
+int prerender_spool_append(PrerenderSpool *sp, int track, int cue, int64_t pts90,
+                           const uint8_t *data, int size);
+
+/**
+ * Write the index and header and map the file read-only. After this
+ * call only lookups are allowed.
+ *
+ * @return 0 on success, -1 on I/O or mmap failure.
+ */
+int prerender_spool_finish(PrerenderSpool *sp);
+
+/**
+ * Map an existing spool file read-only (e.g. one kept with
+ * --prerender-spool PATH).
+ *
+ * @return Finished spool, or NULL if the file is missing or malformed.
+ */
+PrerenderSpool *prerender_spool_open(const char *path);
+
+/**
+ * Look up the payload for cue `cue` of `track`. The returned pointer
+ * aliases the mapping and stays valid until prerender_spool_close().
+ *
+ * @param pts90 Expected PTS; a payload stamped for a different PTS is
+ *              treated as missing so a stale spool never misplaces cues.
+ * @return 1 if found, 0 if absent (or the spool is not finished).
+ */
+int prerender_spool_get(const PrerenderSpool *sp, int track, int cue, int64_t pts90,
+                        const uint8_t **data, int *size);
+
+/** Fingerprint the spool was created with, 0 for NULL. */
+uint64_t prerender_spool_key(const PrerenderSpool *sp);
+
+/** Number of tracks in the spool, 0 for NULL. */
+int prerender_spool_track_count(const PrerenderSpool *sp);
+
+/** Number of cues in `track`, or 0 when out of range. */
+int prerender_spool_cue_count(const PrerenderSpool *sp, int track);
+
+/** Total payload bytes written to the spool. */
+uint64_t prerender_spool_payload_bytes(const PrerenderSpool *sp);
+
+/** Unmap and close the spool. Safe on NULL. */
+void prerender_spool_close(PrerenderSpool *sp);
+
+#endif /* PRERENDER_SPOOL_H */
@@ -65,6 +65,7 @@
 
 #define _POSIX_C_SOURCE 200809L
 #include "qc.h"
+#include "qc_report.h"
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
@@ -111,154 +112,229 @@ void qc_reset_counts(void) {
 }
 
 /*
- * Logs a QC (quality control) message to the specified file or stderr.
+ * Records one QC finding.
  *
  * Parameters:
  *   qc        - Pointer to the QC file (FILE*). If NULL, logs to stderr.
- *   level     - String indicating the log level (e.g., "ERROR", "WARNING").
- *   color     - ANSI color code string for colored output (used in debug mode).
- *   filename  - Name of the file associated with the log message.
- *   cue_idx   - Index of the cue related to the log message.
- *   msg       - The log message to be written.
+ *   check     - Which check fired; selects label, severity and message.
+ *   filename  - Name of the file associated with the finding.
+ *   cue_idx   - Index of the cue related to the finding.
+ *   cur       - The cue (for its timing in structured reports).
+ *   value     - Measured value for checks whose message carries one.
+ *   limit     - Threshold for checks whose message carries one.
  *
  * Behavior:
- *   - Writes the log message to the QC file if provided, otherwise to stderr.
- *   - In debug mode, also outputs a colored log message using LOG macro.
- *   - If the log level is "ERROR", increments the global error counter for batch QC reporting.
+ *   - With a report installed (qc_set_report), appends a record to it;
+ *     the report writes records out in blocks.
+ *   - Otherwise writes "file: cue N LABEL: message" to the QC file if
+ *     provided, or to stderr.
+ *   - In debug mode, also outputs a colored line using the LOG macro.
+ *   - ERROR findings increment the global error counter for batch QC reporting.
  */
-static void log_qc(FILE *qc, const char *level, const char *color,
-                   const char *filename, int cue_idx, const char *msg) {
-    /* Write plain line to qc file when present, otherwise to stderr. */
-    if (qc) {
-        fprintf(qc, "%s: cue %d %s: %s\n", filename, cue_idx, level, msg);
-        if (debug_level > 0) {
-            LOG(1, "%s%s: cue %d %s: %s%s\n", color, filename, cue_idx, level, msg, COL_RST);
-        }
+static void log_qc(FILE *qc, QCCheckId check, const char *filename, int cue_idx,
+                   const SRTEntry *cur, int value, int limit) {
+    QCFinding f = {
+        .file = filename,
+        .cue = cue_idx,
+        .check = check,
+        .value = value,
+        .limit = limit,
+        .start_ms = cur->start_ms,
+        .end_ms = cur->end_ms,
+    };
+    QCReport *report = qc_get_report();
+    const char *label = qc_check_label(check);
+    QCSeverity sev = qc_check_severity(check);
+
+    if (report && qc_report_add(report, &f) == 0) {
+        /* buffered */
     } else {
-        fprintf(stderr, "%s: cue %d %s: %s\n", filename, cue_idx, level, msg);
+        char msg[128];
+        qc_finding_message(&f, msg, sizeof(msg));
+        fprintf(qc ? qc : stderr, "%s: cue %d %s: %s\n", filename, cue_idx, label, msg);
+    }
+    if ((qc || report) && LOG_ENABLED(1)) {
+        const char *color = (sev == QC_SEV_ERROR || check == QC_CHECK_OVERLAP) ? COL_RED
+                            : sev == QC_SEV_WARN ? COL_YEL : COL_CYN;
+        char msg[128];
+        qc_finding_message(&f, msg, sizeof(msg));
+        LOG(1, "%s%s: cue %d %s: %s%s\n", color, filename, cue_idx, label, msg, COL_RST);
     }
 
-    /* If this line is an ERROR, increment the global error counter so
-     * callers running batch QC can report a summary. */
-    if (level && strcmp(level, "ERROR") == 0) {
+    /* Count ERROR findings so callers running batch QC can report a summary. */
+    if (sev == QC_SEV_ERROR) {
         atomic_fetch_add_explicit(&qc_error_count, 1, memory_order_relaxed);
     }
 }
 
 /*
- * qc_check_entry
- * --------------
- * Run a battery of heuristic quality-control checks on a single SRT entry
- * and emit one-line messages describing warnings/errors found. This
- * function intentionally keeps checks conservative and non-fatal; it only
- * reports issues to aid downstream processing and human inspection.
+ * Run-time order of the checks is the QCCheckId order, so emitting set
+ * bits from low to high reproduces the historic line order.
  */
-void qc_check_entry(const char *filename, int cue_idx,
-                    const SRTEntry *cur, const SRTEntry *prev, FILE *qc) {
-    /*
-     * 1) Overlap: current start before previous end indicates overlapping
-     *    cues which can confuse renderers or lead to ambiguous presentation.
-     */
-    if (prev && cur->start_ms < prev->end_ms) {
-        log_qc(qc, "OVERLAP", COL_RED, filename, cue_idx,
-               "overlaps previous cue");
+void qc_emit_flags(FILE *qc, const char *filename, int cue_idx,
+                   const SRTEntry *cur, unsigned flags, int maxlen, int lines) {
+    for (int c = 0; flags && c < QC_CHECK_COUNT; c++) {
+        if (!(flags & QC_BIT(c)))
+            continue;
+        flags &= ~QC_BIT(c);
+        int value = 0, limit = 0;
+        switch ((QCCheckId)c) {
+        case QC_CHECK_LINE_LENGTH: value = maxlen; limit = qc_line_threshold(); break;
+        case QC_CHECK_LINE_COUNT:  value = lines;  limit = 3;   break;
+        case QC_CHECK_VERBOSE:     limit = 200; break;
+        default: break;
+        }
+        log_qc(qc, (QCCheckId)c, filename, cue_idx, cur, value, limit);
     }
+}
 
-    /*
-     * 2) end <= start: invalid or zero-length cues are treated as errors
-     *    because renderers assume positive durations.
-     */
-    if (cur->end_ms <= cur->start_ms) {
-        log_qc(qc, "ERROR", COL_RED, filename, cue_idx,
-               "end <= start timestamp");
-    }
+/*
+ * Line-length threshold matching the wrapping used by the parser: SD vs
+ * HD rules, chosen from the global video dimensions.
+ */
+int qc_line_threshold(void) {
+    int is_hd = (video_w > 720 || video_h > 576);
+    return is_hd ? QC_MAX_CHARS_HD : QC_MAX_CHARS_SD;
+}
 
-    /*
-     * 3) Very short cues (<250ms): warn because these often indicate
-     *    formatting/timing issues; not considered fatal.
-     */
-    if ((cur->end_ms - cur->start_ms) < 250) {
-        log_qc(qc, "WARN", COL_YEL, filename, cue_idx,
-               "duration too short (<250ms)");
+/*
+ * qc_timing_flags
+ * ---------------
+ * Timing checks 1-4 over a whole track. Written branch-free over plain
+ * arrays so the compiler vectorises both loops.
+ */
+void qc_timing_flags(const int64_t *restrict start, const int64_t *restrict end,
+                     int n, uint16_t *restrict flags) {
+    for (int i = 0; i < n; i++) {
+        int64_t d = end[i] - start[i];
+        flags[i] = (uint16_t)(((unsigned)(d <= 0) << QC_CHECK_BAD_TIMING) |
+                              ((unsigned)(d < 250) << QC_CHECK_SHORT) |
+                              ((unsigned)(d > 10000) << QC_CHECK_LONG));
     }
+    for (int i = 1; i < n; i++)
+        flags[i] |= (uint16_t)((unsigned)(start[i] < end[i - 1]) << QC_CHECK_OVERLAP);
+}
 
-    /* 4) Very long cues (>10s) */
-    if ((cur->end_ms - cur->start_ms) > 10000) {
-        log_qc(qc, "WARN", COL_YEL, filename, cue_idx,
-               "duration unusually long (>10s)");
-    }
+/* "span>", "i>", "b>" or "u>" after a "</". */
+static int is_closing_tag(const char *s) {
+    return !strncmp(s, "span>", 5) || !strncmp(s, "i>", 2) ||
+           !strncmp(s, "b>", 2) || !strncmp(s, "u>", 2);
+}
+
+/*
+ * qc_text_flags
+ * -------------
+ * Text checks 5-10 on one cue's (tag-stripped) text. Returns the QC_BIT()
+ * mask of checks that fire and the longest line / line count used in
+ * their messages.
+ */
+unsigned qc_text_flags(const char *text, int *maxlen_out, int *lines_out) {
+    unsigned flags = 0;
 
     /* 5) Character-per-line check: compute the maximum run-length on any
      * line to detect lines that will wrap poorly when rendered. We operate
      * on UTF-8 codepoints (not bytes) so multi-byte glyphs count as a
      * single visible character. The threshold is chosen to match the
-     * wrapping behavior used in the parser (SD vs HD rules). */
-    const unsigned char *t = (const unsigned char *)cur->text;
-    int maxlen = 0, curlen = 0, lines = 1;
-    while (t && *t) {
-        if (*t == '\n') {
+     * wrapping behavior used in the parser (SD vs HD rules). The same
+     * scan notes control characters (7), the byte length (8, 9) and
+     * closing tags (10), so the text is read once. */
+    const unsigned char *t = (const unsigned char *)text;
+    int maxlen = 0, curlen = 0, lines = 1, ctrl = 0, closing = 0;
+    const unsigned char *p = t;
+    while (p && *p) {
+        /* Printable ASCII other than '<' is by far the common case. */
+        if (*p >= 0x20 && *p < 0x80 && *p != '<') {
+            curlen++;
+            p++;
+            continue;
+        }
+        if (*p == '\n') {
             if (curlen > maxlen) maxlen = curlen;
             curlen = 0;
             lines++;
-            t++;
+            p++;
             /* Check if this is the last character - if so, don't count the trailing newline */
-            if (!*t) lines--;
+            if (!*p) lines--;
             continue;
         }
         int adv = 1;
-        if ((*t & 0x80) == 0) adv = 1;
-        else if ((*t & 0xE0) == 0xC0) adv = 2;
-        else if ((*t & 0xF0) == 0xE0) adv = 3;
-        else if ((*t & 0xF8) == 0xF0) adv = 4;
+        if ((*p & 0x80) == 0) adv = 1;
+        else if ((*p & 0xE0) == 0xC0) adv = 2;
+        else if ((*p & 0xF0) == 0xE0) adv = 3;
+        else if ((*p & 0xF8) == 0xF0) adv = 4;
         else adv = 1;
-        /* Count one visible character and advance by UTF-8 sequence length */
+        /* Count one visible character and advance by UTF-8 sequence
+         * length, stopping at a truncated sequence's terminator. */
         curlen++;
-        t += adv;
+        while (adv-- && *p) {
+            if (*p < 0x20 && *p != '\n' && *p != '\t') ctrl = 1;
+            else if (*p == '<' && p[1] == '/' && !closing)
+                closing = is_closing_tag((const char *)p + 2);
+            p++;
+        }
     }
     if (curlen > maxlen) maxlen = curlen;
+    size_t len = p ? (size_t)(p - t) : 0;
 
-    int is_hd = (video_w > 720 || video_h > 576);
-    int threshold = is_hd ? QC_MAX_CHARS_HD : QC_MAX_CHARS_SD;
-    if (maxlen > threshold) {
-        char msg[128];
-        snprintf(msg, sizeof(msg), "line exceeds %d chars (%d)", threshold, maxlen);
-        log_qc(qc, "WARN", COL_YEL, filename, cue_idx, msg);
-    }
+    if (maxlen > qc_line_threshold()) flags |= QC_BIT(QC_CHECK_LINE_LENGTH);
 
     /* 6) Too many lines (>3) */
-    if (lines > 3) {
-        char msg[128];
-        snprintf(msg, sizeof(msg), "too many lines (%d)", lines);
-        log_qc(qc, "WARN", COL_YEL, filename, cue_idx, msg);
-    }
+    if (lines > 3) flags |= QC_BIT(QC_CHECK_LINE_COUNT);
 
     /* 7) Control characters detection */
-    if (cur->text) {
-        for (t = (const unsigned char *)cur->text; *t; t++) {
-            if (*t < 0x20 && *t != '\n' && *t != '\t') {
-                log_qc(qc, "WARN", COL_YEL, filename, cue_idx,
-                       "contains control characters");
-                break;
-            }
-        }
-    }
+    if (ctrl) flags |= QC_BIT(QC_CHECK_CONTROL_CHARS);
 
     /* 8) Empty text */
-    if (!cur->text || strlen(cur->text) == 0) {
-        log_qc(qc, "WARN", COL_YEL, filename, cue_idx,
-               "empty cue text");
-    }
+    if (len == 0) flags |= QC_BIT(QC_CHECK_EMPTY);
 
     /* 9) Excessively long text (>200 chars) */
-    if (cur->text && strlen(cur->text) > 200) {
-        log_qc(qc, "WARN", COL_YEL, filename, cue_idx,
-               "cue too verbose (>200 chars)");
-    }
+    if (len > 200) flags |= QC_BIT(QC_CHECK_VERBOSE);
 
     /* 10) Informational: closing tags detected (parser normalized them). */
-    if (cur->text && (strstr(cur->text, "</span>") || strstr(cur->text, "</i>") ||
-        strstr(cur->text, "</b>") || strstr(cur->text, "</u>"))) {
-        log_qc(qc, "INFO", COL_CYN, filename, cue_idx,
-               "markup normalized/auto-closed");
-    }
-}
\ No newline at end of file
+    if (closing) flags |= QC_BIT(QC_CHECK_MARKUP);
+
+    if (maxlen_out) *maxlen_out = maxlen;
+    if (lines_out) *lines_out = lines;
+    return flags;
+}
+
+/*
+ * qc_check_entry
+ * --------------
+ * Run a battery of heuristic quality-control checks on a single SRT entry
+ * and emit one-line messages describing warnings/errors found. This
+ * function intentionally keeps checks conservative and non-fatal; it only
+ * reports issues to aid downstream processing and human inspection.
+ */
+void qc_check_entry(const char *filename, int cue_idx,
+                    const SRTEntry *cur, const SRTEntry *prev, FILE *qc) {
+    unsigned flags = 0;
+    int64_t d = cur->end_ms - cur->start_ms;
+
+    /*
+     * 1) Overlap: current start before previous end indicates overlapping
+     *    cues which can confuse renderers or lead to ambiguous presentation.
+     */
+    if (prev && cur->start_ms < prev->end_ms) flags |= QC_BIT(QC_CHECK_OVERLAP);
+
+    /*
+     * 2) end <= start: invalid or zero-length cues are treated as errors
+     *    because renderers assume positive durations.
+     */
+    if (d <= 0) flags |= QC_BIT(QC_CHECK_BAD_TIMING);
+
+    /*
+     * 3) Very short cues (<250ms): warn because these often indicate
+     *    formatting/timing issues; not considered fatal.
+     */
+    if (d < 250) flags |= QC_BIT(QC_CHECK_SHORT);
+
+    /* 4) Very long cues (>10s) */
+    if (d > 10000) flags |= QC_BIT(QC_CHECK_LONG);
+
+    /* 5-10) Text checks */
+    int maxlen = 0, lines = 0;
+    flags |= qc_text_flags(cur->text, &maxlen, &lines);
+
+    qc_emit_flags(qc, filename, cue_idx, cur, flags, maxlen, lines);
+}
@@ -50,6 +50,8 @@
 #define QC_H
 
 #include "srt_parser.h"
+#include "qc_report.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdatomic.h>
 
@@ -60,7 +62,9 @@
  * Provide a compact set of heuristics and checks to detect common issues in
  * SRT files (overlaps, bad durations, overly long lines, control characters,
  * etc.). Results are emitted as one-line QC messages either to the provided
- * `qc` FILE* or to stderr when `qc` is NULL.
+ * `qc` FILE* or to stderr when `qc` is NULL. When a report is installed with
+ * qc_set_report() (see qc_report.h) findings are added to it instead and
+ * `qc` is ignored.
  *
  * Example:
  * @code
@@ -80,6 +84,34 @@ void qc_check_entry(const char *filename, int index,
                     const SRTEntry *entry, const SRTEntry *prev,
                     FILE *qc);
 
+/** Bit of a QCCheckId in the masks below. */
+#define QC_BIT(check) (1u << (check))
+
+/**
+ * Timing checks (overlap, end <= start, short, long) for a whole track
+ * held as contiguous start/end arrays. Writes one QC_BIT() mask per cue
+ * into `flags`; cue i is compared with cue i-1 for overlap.
+ */
+void qc_timing_flags(const int64_t *restrict start, const int64_t *restrict end,
+                     int n, uint16_t *restrict flags);
+
+/**
+ * Text checks (line length, line count, control characters, empty,
+ * verbose, closing tags) on one cue's tag-stripped text. Returns the
+ * QC_BIT() mask and stores the longest line (code points) and line count.
+ */
+unsigned qc_text_flags(const char *text, int *maxlen, int *lines);
+
+/**
+ * Emit the findings in `flags` for one cue, in check order, exactly as
+ * qc_check_entry() would (report, FILE* or stderr; error counter).
+ */
+void qc_emit_flags(FILE *qc, const char *filename, int cue_idx,
+                   const SRTEntry *cur, unsigned flags, int maxlen, int lines);
+
+/** Line-length limit for the current video size (SD 37, HD 67). */
+int qc_line_threshold(void);
+
 /**
  * Global counter of QC-level ERROR messages emitted by qc_check_entry().
  * Call qc_reset_counts() to reset to zero before a batch run.
@@ -0,0 +1,187 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * qc_batch.c
+ * ----------
+ * Batch form of the per-cue QC checks in qc.c. Timing is copied into
+ * struct-of-arrays form and checked in one vectorisable pass; the text
+ * pass (strip tags, measure lines, scan for control characters and
+ * closing tags) dominates and is split into contiguous cue ranges, one
+ * per worker. Emission stays serial and in cue order so reports and the
+ * qc_error_count total match the per-cue path exactly.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "qc_batch.h"
+#include "qc.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEBUG_MODULE "qc"
+#include "debug.h"
+
+/* Below this many cues the text pass runs on the calling thread. */
+#define QC_BATCH_MIN_PARALLEL 2048
+
+typedef struct {
+    uint16_t flags;
+    int maxlen;
+    int lines;
+} QCTextResult;
+
+typedef struct {
+    const SRTEntry *entries;
+    QCTextResult *out;
+    int lo, hi;
+} QCTextRange;
+
+static void text_pass(const SRTEntry *entries, QCTextResult *out, int lo, int hi)
+{
+    for (int i = lo; i < hi; i++) {
+        /* The parser checks tag-stripped text. strip_tags() only removes
+         * <...> and {...} runs, so text without either is checked in
+         * place; the raw text is also used if stripping cannot allocate. */
+        const char *raw = entries[i].text;
+        char *plain = raw && strpbrk(raw, "<{") ? strip_tags(raw) : NULL;
+        const char *text = plain ? plain : raw;
+        out[i].flags = (uint16_t)qc_text_flags(text, &out[i].maxlen, &out[i].lines);
+        free(plain);
+    }
+}
+
+static void *text_worker(void *arg)
+{
+    QCTextRange *r = arg;
+    text_pass(r->entries, r->out, r->lo, r->hi);
+    return NULL;
+}
+
+/* Per-cue fallback when the batch arrays cannot be allocated. */
+static int check_serial(const char *filename, const SRTEntry *entries, int n, FILE *qc)
+{
+    int rc = 0;
+    for (int i = 0; i < n; i++) {
+        SRTEntry tmp = entries[i];
+        char *plain = tmp.text ? strip_tags(tmp.text) : NULL;
+        if (tmp.text && !plain) {
+            rc = -1;
+            continue;
+        }
+        tmp.text = plain;
+        qc_check_entry(filename, i, &tmp, i > 0 ? &entries[i - 1] : NULL, qc);
+        free(plain);
+    }
+    if (rc)
+        LOG(1, "Out of memory during QC of '%s'; some cues were not checked\n", filename);
+    return rc;
+}
+
+int qc_check_track(const char *filename, const SRTEntry *entries, int n,
+                   FILE *qc, int threads)
+{
+    if (!entries || n <= 0)
+        return 0;
+
+    int64_t *start = malloc((size_t)n * sizeof(*start));
+    int64_t *end = malloc((size_t)n * sizeof(*end));
+    uint16_t *tflags = malloc((size_t)n * sizeof(*tflags));
+    QCTextResult *text = malloc((size_t)n * sizeof(*text));
+    if (!start || !end || !tflags || !text) {
+        free(start); free(end); free(tflags); free(text);
+        return check_serial(filename, entries, n, qc);
+    }
+
+    /* Timing: gather into SoA, then one pass over the arrays. */
+    for (int i = 0; i < n; i++) {
+        start[i] = entries[i].start_ms;
+        end[i] = entries[i].end_ms;
+    }
+    qc_timing_flags(start, end, n, tflags);
+    free(start);
+    free(end);
+
+    /* Text: contiguous ranges per worker; ranges that fail to start run
+     * on this thread. */
+    if (threads > n / (QC_BATCH_MIN_PARALLEL / 2))
+        threads = n / (QC_BATCH_MIN_PARALLEL / 2);
+    if (n < QC_BATCH_MIN_PARALLEL || threads <= 1) {
+        text_pass(entries, text, 0, n);
+    } else {
+        pthread_t tids[threads];
+        QCTextRange ranges[threads];
+        int started[threads];
+        for (int w = 0; w < threads; w++) {
+            ranges[w] = (QCTextRange){ entries, text,
+                                       (int)((int64_t)n * w / threads),
+                                       (int)((int64_t)n * (w + 1) / threads) };
+            started[w] = (w > 0 &&
+                          pthread_create(&tids[w], NULL, text_worker, &ranges[w]) == 0);
+        }
+        for (int w = 0; w < threads; w++)
+            if (!started[w])
+                text_pass(entries, text, ranges[w].lo, ranges[w].hi);
+        for (int w = 1; w < threads; w++)
+            if (started[w])
+                pthread_join(tids[w], NULL);
+    }
+
+    /* Emit in cue order; most cues have no findings. */
+    for (int i = 0; i < n; i++) {
+        unsigned flags = (unsigned)tflags[i] | text[i].flags;
+        if (flags)
+            qc_emit_flags(qc, filename, i, &entries[i], flags,
+                          text[i].maxlen, text[i].lines);
+    }
+
+    free(tflags);
+    free(text);
+    return 0;
+}
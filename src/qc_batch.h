@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+#pragma once
+#ifndef QC_BATCH_H
+#define QC_BATCH_H
+
+#include "srt_parser.h"
+#include <stdio.h>
+
+/**
+ * @file qc_batch.h
+ * @brief Whole-track QC: the qc_check_entry() checks run as batch passes.
+ *
+ * Instead of checking each cue as it is parsed, a parsed track is checked
+ * in two passes: the timing checks run branch-free over contiguous
+ * start/end arrays (see qc_timing_flags()), and the text checks run on
+ * the tag-stripped cue texts split across worker threads. Findings are
+ * then emitted in cue order, so the output is identical to calling
+ * qc_check_entry() on each cue after stripping its tags, as the parser
+ * does.
+ *
+ * Parse with SRTParserConfig.defer_qc set to skip the per-cue checks,
+ * then call qc_check_track() on the result.
+ */
+
+/**
+ * Run all QC checks over a parsed track.
+ *
+ * @param filename Name used in findings.
+ * @param entries  Parsed cues (markup is stripped before the text checks).
+ * @param n        Number of cues.
+ * @param qc       FILE* for findings when no report is installed (NULL = stderr).
+ * @param threads  Worker threads for the text pass (<= 1 runs inline).
+ * @return 0 on success, -1 if memory ran out and some cues were not
+ *         checked (the batch arrays fall back to per-cue checks first).
+ */
+int qc_check_track(const char *filename, const SRTEntry *entries, int n,
+                   FILE *qc, int threads);
+
+#endif /* QC_BATCH_H */
@@ -0,0 +1,495 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * qc_cross.c
+ * ----------
+ * Cross-track timing consistency (see qc_cross.h). Each track is reduced
+ * once to its delayed cue starts in sorted order; every pair is then
+ * aligned in three passes over those arrays:
+ *   1. vote all start differences within the window into 40 ms bins and
+ *      take the strongest (3-bin smoothed) bin as the coarse offset;
+ *   2. refine it to the median difference of each cue's nearest partner
+ *      near that bin, with the median absolute deviation as spread;
+ *   3. merge both start lists with the offset applied, pairing starts
+ *      within the tolerance, and collect runs of unmatched cues.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "qc_cross.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DEBUG_MODULE "qc_cross"
+#include "debug.h"
+
+#define BIN_MS 40
+#define NBINS (2 * QC_CROSS_WINDOW_MS / BIN_MS + 1)
+/* Nearest partners further than this from the coarse offset are ignored
+ * when refining it. */
+#define REFINE_MS 500
+/* Matching tolerance bounds. */
+#define TOL_MIN_MS 120
+#define TOL_MAX_MS 1000
+/* Matches needed before an offset is trusted. */
+#define MIN_MATCHES 10
+
+/* A track's cues sorted by delayed start. */
+typedef struct {
+    int n;
+    int *order;         /* file index of the k-th cue by start */
+    int64_t *start;     /* delayed start of the k-th cue */
+    int64_t *end;       /* delayed end of the k-th cue */
+} SortedTrack;
+
+typedef struct {
+    const QCCrossTrack *tracks;
+    const SortedTrack *sorted;
+    QCCrossPair *pairs;
+    int npairs;
+    atomic_int next;
+    atomic_int failed;
+} CrossJobs;
+
+typedef struct {
+    int64_t start;
+    int index;
+} StartKey;
+
+static int cmp_start_key(const void *pa, const void *pb)
+{
+    const StartKey *x = pa, *y = pb;
+    if (x->start != y->start)
+        return x->start < y->start ? -1 : 1;
+    return x->index - y->index;
+}
+
+static int cmp_i64(const void *pa, const void *pb)
+{
+    int64_t x = *(const int64_t *)pa, y = *(const int64_t *)pb;
+    return (x > y) - (x < y);
+}
+
+static int64_t median_i64(int64_t *v, int n)
+{
+    qsort(v, (size_t)n, sizeof(*v), cmp_i64);
+    return (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+/* First k with s[k] >= key. */
+static int lower_bound(const int64_t *s, int n, int64_t key)
+{
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (s[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static int sort_track(const QCCrossTrack *t, SortedTrack *s)
+{
+    s->n = t->count > 0 ? t->count : 0;
+    size_t n = (size_t)(s->n ? s->n : 1);
+    s->order = malloc(n * sizeof(*s->order));
+    s->start = malloc(n * sizeof(*s->start));
+    s->end = malloc(n * sizeof(*s->end));
+    StartKey *keys = malloc(n * sizeof(*keys));
+    if (!s->order || !s->start || !s->end || !keys) {
+        free(keys);
+        return -1;
+    }
+    for (int i = 0; i < s->n; i++)
+        keys[i] = (StartKey){ t->entries[i].start_ms + t->delay_ms, i };
+    qsort(keys, (size_t)s->n, sizeof(*keys), cmp_start_key);
+    for (int k = 0; k < s->n; k++) {
+        s->order[k] = keys[k].index;
+        s->start[k] = keys[k].start;
+        s->end[k] = t->entries[keys[k].index].end_ms + t->delay_ms;
+    }
+    free(keys);
+    return 0;
+}
+
+static void free_sorted(SortedTrack *s)
+{
+    free(s->order);
+    free(s->start);
+    free(s->end);
+}
+
+/* Coarse offset: strongest smoothed bin of all differences b - a within
+ * the window. Returns 0 if no cue has a partner in range. */
+static int coarse_offset(const SortedTrack *a, const SortedTrack *b, int64_t *out)
+{
+    static const int64_t W = QC_CROSS_WINDOW_MS;
+    int *bins = calloc(NBINS, sizeof(*bins));
+    if (!bins)
+        return -1;
+    long votes = 0;
+    for (int i = 0; i < a->n; i++) {
+        for (int j = lower_bound(b->start, b->n, a->start[i] - W);
+             j < b->n && b->start[j] <= a->start[i] + W; j++) {
+            bins[(b->start[j] - a->start[i] + W + BIN_MS / 2) / BIN_MS]++;
+            votes++;
+        }
+    }
+    int best = -1;
+    long best_score = 0;
+    for (int k = 0; k < NBINS; k++) {
+        long score = bins[k] + (k > 0 ? bins[k - 1] : 0) + (k + 1 < NBINS ? bins[k + 1] : 0);
+        int64_t c = (int64_t)k * BIN_MS - W;
+        /* prefer the smaller offset on ties */
+        if (score > best_score ||
+            (score == best_score && best >= 0 &&
+             llabs(c) < llabs((int64_t)best * BIN_MS - W))) {
+            best = k;
+            best_score = score;
+        }
+    }
+    free(bins);
+    if (!votes || best < 0)
+        return 0;
+    *out = (int64_t)best * BIN_MS - W;
+    return 1;
+}
+
+static int add_region(QCCrossPair *p, int track, const SortedTrack *s, int k0, int k1)
+{
+    QCCrossRegion *r = realloc(p->regions, (size_t)(p->nregions + 1) * sizeof(*r));
+    if (!r)
+        return -1;
+    p->regions = r;
+    int first = s->order[k0], last = s->order[k0];
+    int64_t end = s->end[k0];
+    for (int k = k0; k <= k1; k++) {
+        if (s->order[k] < first) first = s->order[k];
+        if (s->order[k] > last) last = s->order[k];
+        if (s->end[k] > end) end = s->end[k];
+    }
+    r[p->nregions++] = (QCCrossRegion){ track, first, last, s->start[k0], end };
+    return 0;
+}
+
+/* Runs of QC_CROSS_MIN_RUN or more unmatched cues become regions. */
+static int collect_regions(QCCrossPair *p, int track, const SortedTrack *s,
+                           const unsigned char *matched)
+{
+    int run = 0;
+    for (int k = 0; k <= s->n; k++) {
+        if (k < s->n && !matched[k]) {
+            run++;
+            continue;
+        }
+        if (run >= QC_CROSS_MIN_RUN && add_region(p, track, s, k - run, k - 1) != 0)
+            return -1;
+        run = 0;
+    }
+    return 0;
+}
+
+static int analyze_pair(const SortedTrack *a, const SortedTrack *b, QCCrossPair *p)
+{
+    int64_t coarse = 0;
+    int rc = coarse_offset(a, b, &coarse);
+    if (rc < 0)
+        return -1;
+
+    /* Refine: nearest partner of each a-cue around the coarse offset. */
+    int64_t *d = malloc((size_t)(a->n ? a->n : 1) * sizeof(*d));
+    unsigned char *ma = calloc((size_t)(a->n ? a->n : 1), 1);
+    unsigned char *mb = calloc((size_t)(b->n ? b->n : 1), 1);
+    if (!d || !ma || !mb) {
+        free(d); free(ma); free(mb);
+        return -1;
+    }
+    int nd = 0;
+    for (int i = 0; rc && i < a->n; i++) {
+        int64_t want = a->start[i] + coarse;
+        int j = lower_bound(b->start, b->n, want);
+        int64_t best = INT64_MAX;
+        if (j < b->n) best = b->start[j] - a->start[i];
+        if (j > 0 && (best == INT64_MAX ||
+                      llabs(b->start[j - 1] - want) < llabs(b->start[j] - want)))
+            best = b->start[j - 1] - a->start[i];
+        if (best != INT64_MAX && llabs(best - coarse) <= REFINE_MS)
+            d[nd++] = best;
+    }
+    if (nd > 0) {
+        p->offset_ms = median_i64(d, nd);
+        for (int k = 0; k < nd; k++)
+            d[k] = llabs(d[k] - p->offset_ms);
+        p->spread_ms = median_i64(d, nd);
+    }
+    free(d);
+
+    int64_t tol = 3 * p->spread_ms + BIN_MS;
+    p->tolerance_ms = tol < TOL_MIN_MS ? TOL_MIN_MS : tol > TOL_MAX_MS ? TOL_MAX_MS : tol;
+
+    /* Merge both start lists with the offset applied. The drift is the
+     * least-squares slope of the matched differences over time. */
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    int i = 0, j = 0;
+    while (i < a->n && j < b->n) {
+        int64_t diff = b->start[j] - (a->start[i] + p->offset_ms);
+        if (llabs(diff) <= p->tolerance_ms) {
+            double x = (double)(a->start[i] - a->start[0]) / 3600000.0;
+            double y = (double)(b->start[j] - a->start[i]);
+            sx += x; sy += y; sxx += x * x; sxy += x * y;
+            ma[i++] = 1;
+            mb[j++] = 1;
+            p->matched++;
+        } else if (diff < 0) {
+            j++;
+        } else {
+            i++;
+        }
+    }
+    p->unmatched_a = a->n - p->matched;
+    p->unmatched_b = b->n - p->matched;
+    if (p->matched >= 2) {
+        double den = p->matched * sxx - sx * sx;
+        if (den > 1e-12)
+            p->drift_ms_per_hour = (p->matched * sxy - sx * sy) / den;
+        double hours = (double)(a->start[a->n - 1] - a->start[0]) / 3600000.0;
+        p->drifting = fabs(p->drift_ms_per_hour * hours) > (double)p->tolerance_ms;
+    }
+    int smaller = a->n < b->n ? a->n : b->n;
+    p->reliable = p->matched >= MIN_MATCHES && 2 * p->matched >= smaller;
+
+    rc = collect_regions(p, p->a, a, ma);
+    if (rc == 0)
+        rc = collect_regions(p, p->b, b, mb);
+    free(ma);
+    free(mb);
+    return rc;
+}
+
+static void *pair_worker(void *arg)
+{
+    CrossJobs *jobs = arg;
+    for (;;) {
+        int k = atomic_fetch_add(&jobs->next, 1);
+        if (k >= jobs->npairs)
+            break;
+        QCCrossPair *p = &jobs->pairs[k];
+        if (analyze_pair(&jobs->sorted[p->a], &jobs->sorted[p->b], p) != 0)
+            atomic_store(&jobs->failed, 1);
+    }
+    return NULL;
+}
+
+int qc_cross_analyze(const QCCrossTrack *tracks, int ntracks, int threads,
+                     QCCrossResult *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!tracks || ntracks < 2)
+        return 0;
+
+    SortedTrack *sorted = calloc((size_t)ntracks, sizeof(*sorted));
+    int npairs = ntracks * (ntracks - 1) / 2;
+    out->pairs = calloc((size_t)npairs, sizeof(*out->pairs));
+    out->suggested_delay_ms = calloc((size_t)ntracks, sizeof(int));
+    out->adjust = calloc((size_t)ntracks, 1);
+    int failed = !sorted || !out->pairs || !out->suggested_delay_ms || !out->adjust;
+    for (int t = 0; !failed && t < ntracks; t++)
+        failed = sort_track(&tracks[t], &sorted[t]) != 0;
+
+    if (!failed) {
+        out->ntracks = ntracks;
+        out->npairs = npairs;
+        int k = 0;
+        for (int a = 0; a < ntracks; a++)
+            for (int b = a + 1; b < ntracks; b++) {
+                out->pairs[k].a = a;
+                out->pairs[k].b = b;
+                k++;
+            }
+
+        CrossJobs jobs = { .tracks = tracks, .sorted = sorted,
+                           .pairs = out->pairs, .npairs = npairs };
+        atomic_init(&jobs.next, 0);
+        atomic_init(&jobs.failed, 0);
+        if (threads > npairs)
+            threads = npairs;
+        if (threads < 1)
+            threads = 1;
+        pthread_t tids[threads];
+        int started = 0;
+        for (int w = 1; w < threads; w++) {
+            if (pthread_create(&tids[started], NULL, pair_worker, &jobs) != 0)
+                break;
+            started++;
+        }
+        pair_worker(&jobs);
+        for (int w = 0; w < started; w++)
+            pthread_join(tids[w], NULL);
+        failed = atomic_load(&jobs.failed);
+    }
+
+    if (sorted) {
+        for (int t = 0; t < ntracks; t++)
+            free_sorted(&sorted[t]);
+        free(sorted);
+    }
+    if (failed) {
+        LOG(1, "Out of memory during cross-track QC\n");
+        qc_cross_free(out);
+        return -1;
+    }
+
+    /* Pairs (0, t) come first, at index t - 1. */
+    out->suggested_delay_ms[0] = tracks[0].delay_ms;
+    for (int t = 1; t < ntracks; t++) {
+        const QCCrossPair *p = &out->pairs[t - 1];
+        out->suggested_delay_ms[t] = tracks[t].delay_ms;
+        if (p->reliable && !p->drifting && llabs(p->offset_ms) >= QC_CROSS_MIN_OFFSET_MS) {
+            out->suggested_delay_ms[t] = tracks[t].delay_ms - (int)p->offset_ms;
+            out->adjust[t] = 1;
+        }
+    }
+    return 0;
+}
+
+/* Hours are clamped so the result always fits QC_CROSS_TIME_LEN bytes. */
+#define QC_CROSS_TIME_LEN 24
+#define QC_CROSS_MAX_HOURS 999999LL
+
+static void fmt_time(int64_t ms, char buf[QC_CROSS_TIME_LEN])
+{
+    const char *sign = ms < 0 ? "-" : "";
+    if (ms < 0)
+        ms = ms == INT64_MIN ? INT64_MAX : -ms;
+    if (ms / 3600000 > QC_CROSS_MAX_HOURS)
+        ms = QC_CROSS_MAX_HOURS * 3600000 + 3599999;
+    snprintf(buf, QC_CROSS_TIME_LEN, "%s%02lld:%02lld:%02lld.%03lld", sign,
+             (long long)(ms / 3600000), (long long)(ms / 60000 % 60),
+             (long long)(ms / 1000 % 60), (long long)(ms % 1000));
+}
+
+void qc_cross_print(const QCCrossResult *res, const QCCrossTrack *tracks, FILE *out)
+{
+    if (!res || !tracks || !out || res->ntracks < 2)
+        return;
+
+    fprintf(out, "\n=== Cross-Track QC (%d tracks, reference: Track 0 %s) ===\n",
+            res->ntracks, tracks[0].name ? tracks[0].name : "");
+    fprintf(out, "Pair    matched  unmatched(a/b)   offset   spread       drift\n");
+    for (int k = 0; k < res->npairs; k++) {
+        const QCCrossPair *p = &res->pairs[k];
+        fprintf(out, "%2d-%-2d  %8d  %7d/%-7d  %+6lldms  %5lldms  %+8.1fms/h%s\n",
+                p->a, p->b, p->matched, p->unmatched_a, p->unmatched_b,
+                (long long)p->offset_ms, (long long)p->spread_ms,
+                p->drift_ms_per_hour,
+                !p->reliable ? "  (too few matches)" : p->drifting ? "  (drifting)" : "");
+    }
+
+    int any = 0;
+    for (int k = 0; k < res->npairs; k++) {
+        const QCCrossPair *p = &res->pairs[k];
+        for (int r = 0; r < p->nregions; r++) {
+            const QCCrossRegion *g = &p->regions[r];
+            int other = g->track == p->a ? p->b : p->a;
+            char t0[QC_CROSS_TIME_LEN], t1[QC_CROSS_TIME_LEN];
+            fmt_time(g->start_ms, t0);
+            fmt_time(g->end_ms, t1);
+            if (!any++)
+                fprintf(out, "\nUnmatched regions:\n");
+            fprintf(out, "  Track %d %s: cues %d-%d (%s - %s) have no counterpart in Track %d\n",
+                    g->track, tracks[g->track].name ? tracks[g->track].name : "",
+                    g->first_cue, g->last_cue, t0, t1, other);
+        }
+    }
+
+    for (int t = 1; t < res->ntracks; t++) {
+        if (res->pairs[t - 1].reliable && res->pairs[t - 1].drifting)
+            fprintf(out, "\nTrack %d %s drifts against Track 0 (%+.0f ms/h): check its frame rate"
+                    " (--fps-convert); a constant delay cannot fix it.\n", t,
+                    tracks[t].name ? tracks[t].name : "", res->pairs[t - 1].drift_ms_per_hour);
+    }
+
+    int adjust = 0;
+    for (int t = 1; t < res->ntracks; t++)
+        adjust |= res->adjust[t];
+    if (!adjust) {
+        fprintf(out, "\nNo systematic offsets against Track 0.\n");
+        return;
+    }
+    fprintf(out, "\nSuggested delays (effective_delay_ms):\n");
+    for (int t = 1; t < res->ntracks; t++) {
+        if (!res->adjust[t])
+            continue;
+        fprintf(out, "  Track %d %s: %d ms -> %d ms\n", t,
+                tracks[t].name ? tracks[t].name : "",
+                tracks[t].delay_ms, res->suggested_delay_ms[t]);
+    }
+    fprintf(out, "  --delay ");
+    for (int t = 0; t < res->ntracks; t++)
+        fprintf(out, "%s%d", t ? "," : "", res->suggested_delay_ms[t]);
+    fprintf(out, "\n");
+}
+
+void qc_cross_free(QCCrossResult *res)
+{
+    if (!res)
+        return;
+    if (res->pairs) {
+        for (int k = 0; k < res->npairs; k++)
+            free(res->pairs[k].regions);
+    }
+    free(res->pairs);
+    free(res->suggested_delay_ms);
+    free(res->adjust);
+    memset(res, 0, sizeof(*res));
+}
@@ -0,0 +1,138 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+#pragma once
+#ifndef QC_CROSS_H
+#define QC_CROSS_H
+
+#include "srt_parser.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file qc_cross.h
+ * @brief Cross-track timing consistency checks (--qc-cross).
+ *
+ * Translations of one programme should share a cue rhythm. Every pair of
+ * tracks is aligned on cue start times (with each track's delay applied)
+ * to find:
+ *  - a systematic offset: the mode of all start differences within
+ *    ±QC_CROSS_WINDOW_MS, refined to the median of the differences near
+ *    it, with its spread (median absolute deviation) and linear drift;
+ *  - matched cues: a merge over the sorted starts of both tracks with the
+ *    offset applied, pairing starts within a tolerance derived from the
+ *    spread;
+ *  - unmatched regions: runs of at least QC_CROSS_MIN_RUN consecutive
+ *    cues in one track with no counterpart in the other (missing or
+ *    shifted blocks).
+ * Sorting and the windowed search make each pair O(n log n). Pairs are
+ * independent and are analysed on worker threads.
+ *
+ * Track 0 is the reference: each other track whose offset against it is
+ * significant gets a suggested effective delay (its delay minus the
+ * offset). Drifting tracks get none; a constant delay cannot fix a
+ * frame-rate mismatch.
+ */
+
+/** Start differences beyond this are not considered the same cue. */
+#define QC_CROSS_WINDOW_MS 10000
+/** Offsets below this (one 25 fps frame) are not reported as systematic. */
+#define QC_CROSS_MIN_OFFSET_MS 40
+/** Shortest run of unmatched cues reported as a region. */
+#define QC_CROSS_MIN_RUN 3
+
+/** One track as parsed (see parse_srt_with_stats) plus its mux delay. */
+typedef struct {
+    const char *name;
+    const SRTEntry *entries;
+    int count;
+    int delay_ms;               /**< effective_delay_ms it would be muxed with */
+} QCCrossTrack;
+
+/** Consecutive cues of one track without a counterpart. */
+typedef struct {
+    int track;                  /**< index into the track array */
+    int first_cue, last_cue;    /**< cue indices in file order */
+    int64_t start_ms, end_ms;   /**< delayed time span */
+} QCCrossRegion;
+
+typedef struct {
+    int a, b;                   /**< track indices, a < b */
+    int matched;
+    int unmatched_a, unmatched_b;
+    int64_t offset_ms;          /**< b starts later than a by this much */
+    int64_t spread_ms;          /**< median |difference - offset| of matches */
+    int64_t tolerance_ms;       /**< matching tolerance used */
+    double drift_ms_per_hour;   /**< slope of the difference over time */
+    int drifting;               /**< drift over the track exceeds the tolerance */
+    int reliable;               /**< enough matches to trust the offset */
+    QCCrossRegion *regions;
+    int nregions;
+} QCCrossPair;
+
+typedef struct {
+    int ntracks;
+    QCCrossPair *pairs;         /**< all a < b pairs, a-major order */
+    int npairs;
+    int *suggested_delay_ms;    /**< per track; track 0 keeps its delay */
+    unsigned char *adjust;      /**< per track: suggestion differs from delay */
+} QCCrossResult;
+
+/**
+ * Analyse all track pairs on up to `threads` worker threads.
+ * Returns 0, or -1 on allocation failure (`out` is then empty).
+ */
+int qc_cross_analyze(const QCCrossTrack *tracks, int ntracks, int threads,
+                     QCCrossResult *out);
+
+/** Pair table, unmatched regions and delay suggestions as text. */
+void qc_cross_print(const QCCrossResult *res, const QCCrossTrack *tracks, FILE *out);
+
+/** Release the arrays of a result. */
+void qc_cross_free(QCCrossResult *res);
+
+#endif /* QC_CROSS_H */
@@ -0,0 +1,501 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * qc_report.c
+ * -----------
+ * Buffered QC report backend; see qc_report.h.
+ *
+ * Findings are fixed-size records with an interned filename, so adding
+ * one is an append under a mutex. Every QC_REPORT_BLOCK findings (and on
+ * flush/finish) the pending records are formatted into a 256 KiB output
+ * block that is written with a single fwrite whenever it fills.
+ */
+
+#include "qc_report.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define QC_REPORT_BLOCK 4096            /* findings formatted per batch */
+#define QC_REPORT_BUF   (256 * 1024)    /* output block size */
+
+typedef struct QCCheckInfo {
+    const char *name;       /* stable id: CSV/JSON "check", SARIF ruleId */
+    const char *label;      /* plain-text level label */
+    QCSeverity severity;
+    const char *rule;       /* SARIF rule description */
+} QCCheckInfo;
+
+static const QCCheckInfo check_info[QC_CHECK_COUNT] = {
+    [QC_CHECK_OVERLAP]       = { "overlap",           "OVERLAP", QC_SEV_WARN,  "Cue starts before the previous cue ends" },
+    [QC_CHECK_BAD_TIMING]    = { "bad_timing",        "ERROR",   QC_SEV_ERROR, "Cue end is not after its start" },
+    [QC_CHECK_SHORT]         = { "short_duration",    "WARN",    QC_SEV_WARN,  "Cue shorter than 250 ms" },
+    [QC_CHECK_LONG]          = { "long_duration",     "WARN",    QC_SEV_WARN,  "Cue longer than 10 s" },
+    [QC_CHECK_LINE_LENGTH]   = { "line_length",       "WARN",    QC_SEV_WARN,  "Line longer than the SD/HD character limit" },
+    [QC_CHECK_LINE_COUNT]    = { "line_count",        "WARN",    QC_SEV_WARN,  "More than 3 lines" },
+    [QC_CHECK_CONTROL_CHARS] = { "control_chars",     "WARN",    QC_SEV_WARN,  "Control characters in cue text" },
+    [QC_CHECK_EMPTY]         = { "empty_text",        "WARN",    QC_SEV_WARN,  "Empty cue text" },
+    [QC_CHECK_VERBOSE]       = { "verbose",           "WARN",    QC_SEV_WARN,  "Cue text longer than 200 characters" },
+    [QC_CHECK_MARKUP]        = { "markup_normalized", "INFO",    QC_SEV_INFO,  "Closing tags were normalised" },
+};
+
+static const char *const sev_name[] = { "info", "warn", "error" };
+static const char *const sarif_level[] = { "note", "warning", "error" };
+
+struct QCReport {
+    pthread_mutex_t lock;
+    QCReportFormat format;
+    FILE *out;
+    QCFinding *recs;
+    size_t nrecs, cap_recs;
+    char **files;
+    size_t nfiles, cap_files;
+    const char *last_src;       /* caller's pointer of the last interned name */
+    const char *last_file;
+    long counts[QC_CHECK_COUNT];
+    long total;
+    char *buf;
+    size_t len;
+    int started;                /* header written */
+    int finished;
+    int failed;
+    int sarif_results;          /* results written so far (comma placement) */
+};
+
+static _Atomic(QCReport *) current_report;
+
+int qc_report_format_parse(const char *s, QCReportFormat *out)
+{
+    static const char *const names[] = { "text", "csv", "jsonl", "sarif" };
+    if (!s || !out)
+        return -1;
+    for (int i = 0; i < 4; i++) {
+        if (strcmp(s, names[i]) == 0) {
+            *out = (QCReportFormat)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *qc_check_name(QCCheckId check)
+{
+    return (unsigned)check < QC_CHECK_COUNT ? check_info[check].name : "unknown";
+}
+
+QCSeverity qc_check_severity(QCCheckId check)
+{
+    return (unsigned)check < QC_CHECK_COUNT ? check_info[check].severity : QC_SEV_WARN;
+}
+
+const char *qc_check_label(QCCheckId check)
+{
+    return (unsigned)check < QC_CHECK_COUNT ? check_info[check].label : "WARN";
+}
+
+int qc_finding_message(const QCFinding *f, char *buf, size_t size)
+{
+    switch (f->check) {
+    case QC_CHECK_OVERLAP:       return snprintf(buf, size, "overlaps previous cue");
+    case QC_CHECK_BAD_TIMING:    return snprintf(buf, size, "end <= start timestamp");
+    case QC_CHECK_SHORT:         return snprintf(buf, size, "duration too short (<250ms)");
+    case QC_CHECK_LONG:          return snprintf(buf, size, "duration unusually long (>10s)");
+    case QC_CHECK_LINE_LENGTH:   return snprintf(buf, size, "line exceeds %d chars (%d)", f->limit, f->value);
+    case QC_CHECK_LINE_COUNT:    return snprintf(buf, size, "too many lines (%d)", f->value);
+    case QC_CHECK_CONTROL_CHARS: return snprintf(buf, size, "contains control characters");
+    case QC_CHECK_EMPTY:         return snprintf(buf, size, "empty cue text");
+    case QC_CHECK_VERBOSE:       return snprintf(buf, size, "cue too verbose (>200 chars)");
+    case QC_CHECK_MARKUP:        return snprintf(buf, size, "markup normalized/auto-closed");
+    default:                     return snprintf(buf, size, "unknown check");
+    }
+}
+
+/* ---- output block ---- */
+
+static void out_flush(QCReport *r)
+{
+    if (r->len) {
+        if (fwrite(r->buf, 1, r->len, r->out) != r->len)
+            r->failed = 1;
+        r->len = 0;
+    }
+}
+
+static void out_put(QCReport *r, const char *s, size_t n)
+{
+    if (r->len + n > QC_REPORT_BUF) {
+        out_flush(r);
+        if (n > QC_REPORT_BUF) {
+            if (fwrite(s, 1, n, r->out) != n)
+                r->failed = 1;
+            return;
+        }
+    }
+    memcpy(r->buf + r->len, s, n);
+    r->len += n;
+}
+
+static void out_str(QCReport *r, const char *s)
+{
+    out_put(r, s, strlen(s));
+}
+
+static void out_fmt(QCReport *r, const char *fmt, ...)
+{
+    char tmp[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    if (n > 0)
+        out_put(r, tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+}
+
+static void out_json(QCReport *r, const char *s)
+{
+    out_put(r, "\"", 1);
+    const char *run = s;
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        out_put(r, run, (size_t)(s - run));
+        run = s + 1;
+        if (c == '"' || c == '\\') {
+            char esc[2] = { '\\', (char)c };
+            out_put(r, esc, 2);
+        } else {
+            out_fmt(r, "\\u%04x", c);
+        }
+    }
+    out_put(r, run, (size_t)(s - run));
+    out_put(r, "\"", 1);
+}
+
+static void out_csv(QCReport *r, const char *s)
+{
+    if (!strpbrk(s, ",\"\r\n")) {
+        out_str(r, s);
+        return;
+    }
+    out_put(r, "\"", 1);
+    for (const char *q; (q = strchr(s, '"')) != NULL; s = q + 1) {
+        out_put(r, s, (size_t)(q - s));
+        out_put(r, "\"\"", 2);
+    }
+    out_str(r, s);
+    out_put(r, "\"", 1);
+}
+
+/* artifactLocation.uri: percent-encode everything but unreserved and '/'. */
+static void out_uri(QCReport *r, const char *s)
+{
+    out_put(r, "\"", 1);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '_' || c == '.' || c == '~' || c == '/')
+            out_put(r, (const char *)s, 1);
+        else
+            out_fmt(r, "%%%02X", c);
+    }
+    out_put(r, "\"", 1);
+}
+
+static void write_header(QCReport *r)
+{
+    r->started = 1;
+    if (r->format == QC_REPORT_CSV) {
+        out_str(r, "file,cue,severity,check,start_ms,end_ms,message\n");
+    } else if (r->format == QC_REPORT_SARIF) {
+        out_str(r, "{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+                   "\"version\":\"2.1.0\",\"runs\":[{\"tool\":{\"driver\":{"
+                   "\"name\":\"srt2dvbsub\",\"rules\":[");
+        for (int i = 0; i < QC_CHECK_COUNT; i++) {
+            out_str(r, i ? ",{\"id\":" : "{\"id\":");
+            out_json(r, check_info[i].name);
+            out_str(r, ",\"shortDescription\":{\"text\":");
+            out_json(r, check_info[i].rule);
+            out_fmt(r, "},\"defaultConfiguration\":{\"level\":\"%s\"}}",
+                    sarif_level[check_info[i].severity]);
+        }
+        out_str(r, "]}},\"results\":[");
+    }
+}
+
+static void write_finding(QCReport *r, const QCFinding *f)
+{
+    char msg[128];
+    qc_finding_message(f, msg, sizeof(msg));
+    const QCCheckInfo *ci = &check_info[f->check];
+    switch (r->format) {
+    case QC_REPORT_TEXT:
+        out_str(r, f->file);
+        out_fmt(r, ": cue %d %s: %s\n", f->cue, ci->label, msg);
+        break;
+    case QC_REPORT_CSV:
+        out_csv(r, f->file);
+        out_fmt(r, ",%d,%s,%s,%lld,%lld,", f->cue, sev_name[ci->severity], ci->name,
+                (long long)f->start_ms, (long long)f->end_ms);
+        out_csv(r, msg);
+        out_put(r, "\n", 1);
+        break;
+    case QC_REPORT_JSONL:
+        out_str(r, "{\"file\":");
+        out_json(r, f->file);
+        out_fmt(r, ",\"cue\":%d,\"severity\":\"%s\",\"check\":\"%s\",\"start_ms\":%lld,\"end_ms\":%lld,\"message\":",
+                f->cue, sev_name[ci->severity], ci->name,
+                (long long)f->start_ms, (long long)f->end_ms);
+        out_json(r, msg);
+        out_str(r, "}\n");
+        break;
+    case QC_REPORT_SARIF:
+        out_str(r, r->sarif_results++ ? ",{\"ruleId\":" : "{\"ruleId\":");
+        out_json(r, ci->name);
+        out_fmt(r, ",\"ruleIndex\":%d,\"level\":\"%s\",\"message\":{\"text\":",
+                (int)f->check, sarif_level[ci->severity]);
+        out_json(r, msg);
+        out_str(r, "},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":");
+        out_uri(r, f->file);
+        out_fmt(r, "}},\"logicalLocations\":[{\"name\":\"cue %d\",\"kind\":\"element\"}]}],"
+                   "\"properties\":{\"cue\":%d,\"startMs\":%lld,\"endMs\":%lld}}",
+                f->cue, f->cue, (long long)f->start_ms, (long long)f->end_ms);
+        break;
+    }
+}
+
+/* Format all pending findings (lock held). */
+static void write_pending(QCReport *r)
+{
+    if (!r->started)
+        write_header(r);
+    for (size_t i = 0; i < r->nrecs; i++)
+        write_finding(r, &r->recs[i]);
+    r->nrecs = 0;
+}
+
+/* ---- public API ---- */
+
+QCReport *qc_report_create(QCReportFormat format, FILE *out)
+{
+    if (!out || (unsigned)format > QC_REPORT_SARIF)
+        return NULL;
+    QCReport *r = calloc(1, sizeof(*r));
+    if (!r)
+        return NULL;
+    r->buf = malloc(QC_REPORT_BUF);
+    if (!r->buf) {
+        free(r);
+        return NULL;
+    }
+    pthread_mutex_init(&r->lock, NULL);
+    r->format = format;
+    r->out = out;
+    return r;
+}
+
+static const char *intern_file(QCReport *r, const char *file)
+{
+    if (!file)
+        file = "";
+    if (r->last_src == file && r->last_file && strcmp(r->last_file, file) == 0)
+        return r->last_file;
+    for (size_t i = 0; i < r->nfiles; i++) {
+        if (strcmp(r->files[i], file) == 0) {
+            r->last_src = file;
+            return r->last_file = r->files[i];
+        }
+    }
+    if (r->nfiles == r->cap_files) {
+        size_t cap = r->cap_files ? r->cap_files * 2 : 8;
+        char **nf = realloc(r->files, cap * sizeof(*nf));
+        if (!nf)
+            return NULL;
+        r->files = nf;
+        r->cap_files = cap;
+    }
+    char *dup = strdup(file);
+    if (!dup)
+        return NULL;
+    r->files[r->nfiles++] = dup;
+    r->last_src = file;
+    return r->last_file = dup;
+}
+
+int qc_report_add(QCReport *r, const QCFinding *f)
+{
+    if (!r || !f || (unsigned)f->check >= QC_CHECK_COUNT)
+        return -1;
+    int rc = 0;
+    pthread_mutex_lock(&r->lock);
+    const char *file = r->finished ? NULL : intern_file(r, f->file);
+    if (!file)
+        rc = -1;
+    else if (r->nrecs == QC_REPORT_BLOCK)
+        write_pending(r);   /* the table never grows past one block */
+    if (file && r->nrecs == r->cap_recs) {
+        size_t cap = r->cap_recs ? r->cap_recs * 2 : 256;
+        QCFinding *nr = realloc(r->recs, cap * sizeof(*nr));
+        if (!nr)
+            rc = -1;
+        else {
+            r->recs = nr;
+            r->cap_recs = cap;
+        }
+    }
+    if (file && rc == 0) {
+        QCFinding *dst = &r->recs[r->nrecs++];
+        *dst = *f;
+        dst->file = file;
+        r->counts[f->check]++;
+        r->total++;
+    }
+    pthread_mutex_unlock(&r->lock);
+    return rc;
+}
+
+int qc_report_flush(QCReport *r)
+{
+    if (!r)
+        return -1;
+    pthread_mutex_lock(&r->lock);
+    if (!r->finished) {
+        write_pending(r);
+        out_flush(r);
+        if (fflush(r->out) != 0)
+            r->failed = 1;
+    }
+    int rc = r->failed ? -1 : 0;
+    pthread_mutex_unlock(&r->lock);
+    return rc;
+}
+
+int qc_report_finish(QCReport *r)
+{
+    if (!r)
+        return -1;
+    pthread_mutex_lock(&r->lock);
+    if (!r->finished) {
+        write_pending(r);
+        if (r->format == QC_REPORT_SARIF)
+            out_str(r, "]}]}\n");
+        out_flush(r);
+        if (fflush(r->out) != 0)
+            r->failed = 1;
+        r->finished = 1;
+    }
+    int rc = r->failed ? -1 : 0;
+    pthread_mutex_unlock(&r->lock);
+    return rc;
+}
+
+long qc_report_count(const QCReport *r, QCCheckId check)
+{
+    if (!r || (unsigned)check >= QC_CHECK_COUNT)
+        return 0;
+    pthread_mutex_lock((pthread_mutex_t *)&r->lock);
+    long n = r->counts[check];
+    pthread_mutex_unlock((pthread_mutex_t *)&r->lock);
+    return n;
+}
+
+long qc_report_total(const QCReport *r)
+{
+    if (!r)
+        return 0;
+    pthread_mutex_lock((pthread_mutex_t *)&r->lock);
+    long n = r->total;
+    pthread_mutex_unlock((pthread_mutex_t *)&r->lock);
+    return n;
+}
+
+void qc_report_summary(const QCReport *r, FILE *out)
+{
+    if (!r || !out)
+        return;
+    fprintf(out, "QC Findings by Check:\n");
+    long total = 0;
+    for (int i = 0; i < QC_CHECK_COUNT; i++) {
+        long n = qc_report_count(r, (QCCheckId)i);
+        if (!n)
+            continue;
+        fprintf(out, "  %-18s %-5s %8ld\n", check_info[i].name,
+                sev_name[check_info[i].severity], n);
+        total += n;
+    }
+    fprintf(out, "  %-18s %-5s %8ld\n", "TOTAL", "", total);
+}
+
+void qc_report_destroy(QCReport *r)
+{
+    if (!r)
+        return;
+    qc_report_finish(r);
+    QCReport *expected = r;
+    atomic_compare_exchange_strong(&current_report, &expected, NULL);
+    for (size_t i = 0; i < r->nfiles; i++)
+        free(r->files[i]);
+    free(r->files);
+    free(r->recs);
+    free(r->buf);
+    pthread_mutex_destroy(&r->lock);
+    free(r);
+}
+
+void qc_set_report(QCReport *r)
+{
+    atomic_store(&current_report, r);
+}
+
+QCReport *qc_get_report(void)
+{
+    return atomic_load(&current_report);
+}
@@ -0,0 +1,168 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef QC_REPORT_H
+#define QC_REPORT_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file qc_report.h
+ * @brief Buffered, structured output for QC findings.
+ *
+ * qc_check_entry() used to fprintf() each finding as it was found. With a
+ * report installed (qc_set_report()) findings are instead appended to an
+ * in-memory table as fixed-size records (file, cue, check id, severity,
+ * timing and the measured value). The table is formatted and written out
+ * in large blocks as plain text (the historic qc_log.txt lines), CSV,
+ * JSON lines or a SARIF 2.1.0 log, and per-check counters are kept for a
+ * summary table.
+ */
+
+/** Severity of a finding. */
+typedef enum {
+    QC_SEV_INFO = 0,
+    QC_SEV_WARN,
+    QC_SEV_ERROR
+} QCSeverity;
+
+/** Checks performed by qc_check_entry(), in the order it runs them. */
+typedef enum {
+    QC_CHECK_OVERLAP = 0,       /**< start before the previous cue's end */
+    QC_CHECK_BAD_TIMING,        /**< end <= start */
+    QC_CHECK_SHORT,             /**< duration < 250 ms */
+    QC_CHECK_LONG,              /**< duration > 10 s */
+    QC_CHECK_LINE_LENGTH,       /**< a line longer than the SD/HD limit */
+    QC_CHECK_LINE_COUNT,        /**< more than 3 lines */
+    QC_CHECK_CONTROL_CHARS,     /**< control characters in the text */
+    QC_CHECK_EMPTY,             /**< empty text */
+    QC_CHECK_VERBOSE,           /**< more than 200 characters */
+    QC_CHECK_MARKUP,            /**< closing tags were normalised */
+    QC_CHECK_COUNT
+} QCCheckId;
+
+typedef enum {
+    QC_REPORT_TEXT = 0,         /**< "file: cue N LABEL: message" */
+    QC_REPORT_CSV,
+    QC_REPORT_JSONL,
+    QC_REPORT_SARIF
+} QCReportFormat;
+
+/** One finding. `value`/`limit` fill the check's message (e.g. line length). */
+typedef struct QCFinding {
+    const char *file;           /**< interned by the report */
+    int cue;
+    QCCheckId check;
+    int value;
+    int limit;
+    int64_t start_ms;
+    int64_t end_ms;
+} QCFinding;
+
+typedef struct QCReport QCReport;
+
+/** Parse "text", "csv", "jsonl" or "sarif". Returns 0 on success, -1 otherwise. */
+int qc_report_format_parse(const char *s, QCReportFormat *out);
+
+/** Stable identifier of a check ("overlap", "short_duration", ...). */
+const char *qc_check_name(QCCheckId check);
+
+/** Severity of a check. */
+QCSeverity qc_check_severity(QCCheckId check);
+
+/**
+ * Label used by the plain-text format ("OVERLAP", "ERROR", "WARN",
+ * "INFO"), as written by earlier releases.
+ */
+const char *qc_check_label(QCCheckId check);
+
+/** Format the human-readable message of a finding into buf. */
+int qc_finding_message(const QCFinding *f, char *buf, size_t size);
+
+/**
+ * Create a report writing to `out` (not closed by the report). Records
+ * are buffered and written in blocks. Returns NULL on allocation failure.
+ */
+QCReport *qc_report_create(QCReportFormat format, FILE *out);
+
+/** Append a finding. Thread-safe. Returns 0, or -1 on allocation failure. */
+int qc_report_add(QCReport *r, const QCFinding *f);
+
+/** Write all buffered findings. SARIF keeps its document open. */
+int qc_report_flush(QCReport *r);
+
+/**
+ * Write the remaining findings and close the document (SARIF). Further
+ * findings are rejected. Returns 0, or -1 if a write failed.
+ */
+int qc_report_finish(QCReport *r);
+
+/** Number of findings recorded for a check (all files). */
+long qc_report_count(const QCReport *r, QCCheckId check);
+
+/** Total number of findings recorded. */
+long qc_report_total(const QCReport *r);
+
+/** Print the per-check counter table. */
+void qc_report_summary(const QCReport *r, FILE *out);
+
+/** Finish (if not done) and free the report. */
+void qc_report_destroy(QCReport *r);
+
+/**
+ * Install `r` as the destination of qc_check_entry() findings, or NULL
+ * to return to per-finding writes to the caller's FILE* / stderr.
+ */
+void qc_set_report(QCReport *r);
+
+/** Currently installed report, or NULL. */
+QCReport *qc_get_report(void);
+
+#endif /* QC_REPORT_H */
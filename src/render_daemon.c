@@ -0,0 +1,544 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * render_daemon.c
+ * ---------------
+ * UNIX-socket render service (see render_daemon.h for the protocol).
+ *
+ * Structure:
+ *  - one listening thread (the caller of render_daemon_run) accepting
+ *    connections and enforcing the max_clients limit;
+ *  - one detached thread per connection that parses pipelined requests,
+ *    submits them as a batch to the daemon's private RenderPool and
+ *    writes responses back in request order;
+ *  - a private RenderPool (render_pool_create) so the daemon never
+ *    shares queue keys with the encoder's process-wide pool.
+ *
+ * Connection threads poll the stop flag every POLL_MS so SIGINT/SIGTERM
+ * drains the daemon without waiting for clients to disconnect. A thread
+ * blocked sending to a client that stopped reading would never get
+ * there, so on stop the listener also shuts down every live client
+ * socket, which fails the pending send.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "render_daemon.h"
+#include "render_pool.h"
+#include "render_pango.h"
+#include "utils.h"
+#include "debug_png.h"
+#include "bench.h"
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include <libavutil/mem.h>
+
+#define DEBUG_MODULE "render_daemon"
+#include "debug.h"
+
+#define POLL_MS 200
+#define MAX_REQUEST_LINE (256 * 1024)
+
+typedef struct Conn Conn;
+
+/* Shared daemon state handed to every connection thread. `live` holds
+ * the open connections (max_clients slots) under `live_mtx`, so the
+ * listener can shut their sockets down on stop. */
+typedef struct {
+    const RenderDaemonConfig *cfg;
+    RenderPool *pool;
+    volatile sig_atomic_t *stop;
+    atomic_int active;
+    int max_batch;
+    pthread_mutex_t live_mtx;
+    Conn **live;
+    int live_slots;
+} Daemon;
+
+struct Conn {
+    Daemon *d;
+    int fd;
+    int id;
+    int slot;
+};
+
+/* One parsed request. String fields point into the connection buffer,
+ * which stays untouched until the whole batch has been answered. */
+typedef struct {
+    int ping;
+    const char *error;
+    char *text;
+    int w, h, size, pos, png;
+    const char *font, *style, *fg, *outline, *shadow, *bg, *palette;
+    int seq;
+    int queued;
+    Bitmap bm;
+    int64_t render_us;  /* render call only, measured where it ran */
+    int64_t queue_us;   /* wait for a pool worker (0 when rendered inline) */
+} DaemonRequest;
+
+static int send_all(int fd, const void *buf, size_t len) {
+    const unsigned char *p = buf;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* Unescape \n, \t and \\ in place. */
+static void unescape_text(char *s) {
+    char *w = s;
+    for (char *r = s; *r; r++) {
+        if (*r == '\\' && r[1]) {
+            r++;
+            if (*r == 'n') *w++ = '\n';
+            else if (*r == 't') *w++ = '\t';
+            else *w++ = *r;
+        } else {
+            *w++ = *r;
+        }
+    }
+    *w = '\0';
+}
+
+static int parse_int_field(const char *v, int lo, int hi, int *out) {
+    char *end = NULL;
+    errno = 0;
+    long val = strtol(v, &end, 10);
+    if (errno || end == v || *end || val < lo || val > hi) return -1;
+    *out = (int)val;
+    return 0;
+}
+
+/* Parse one request line in place; sets req->error on failure. */
+static void parse_request(const RenderDaemonConfig *cfg, char *line, DaemonRequest *req) {
+    memset(req, 0, sizeof(*req));
+    req->w = cfg->video_w > 0 ? cfg->video_w : 720;
+    req->h = cfg->video_h > 0 ? cfg->video_h : 576;
+    req->size = cfg->fontsize;
+    req->pos = (int)cfg->pos.position;
+    req->font = cfg->font;
+    req->style = cfg->fontstyle;
+    req->fg = cfg->fgcolor;
+    req->outline = cfg->outlinecolor;
+    req->shadow = cfg->shadowcolor;
+    req->bg = cfg->bgcolor;
+    req->palette = cfg->palette_mode;
+
+    if (strcmp(line, "PING") == 0) {
+        req->ping = 1;
+        return;
+    }
+
+    char *save = NULL;
+    for (char *tok = strtok_r(line, "\t", &save); tok; tok = strtok_r(NULL, "\t", &save)) {
+        char *eq = strchr(tok, '=');
+        if (!eq) { req->error = "malformed field (expected key=value)"; return; }
+        *eq = '\0';
+        const char *k = tok;
+        char *v = eq + 1;
+        if (strcmp(k, "text") == 0) { unescape_text(v); req->text = v; }
+        else if (strcmp(k, "w") == 0) { if (parse_int_field(v, 16, 8192, &req->w)) { req->error = "invalid w"; return; } }
+        else if (strcmp(k, "h") == 0) { if (parse_int_field(v, 16, 8192, &req->h)) { req->error = "invalid h"; return; } }
+        else if (strcmp(k, "size") == 0) { if (parse_int_field(v, 0, 512, &req->size)) { req->error = "invalid size"; return; } }
+        else if (strcmp(k, "pos") == 0) { if (parse_int_field(v, 1, 9, &req->pos)) { req->error = "invalid pos"; return; } }
+        else if (strcmp(k, "fmt") == 0) {
+            if (strcmp(v, "png") == 0) req->png = 1;
+            else if (strcmp(v, "idx") == 0) req->png = 0;
+            else { req->error = "invalid fmt (idx|png)"; return; }
+        }
+        else if (strcmp(k, "font") == 0) req->font = v;
+        else if (strcmp(k, "style") == 0) req->style = v;
+        else if (strcmp(k, "fg") == 0) req->fg = v;
+        else if (strcmp(k, "outline") == 0) req->outline = v;
+        else if (strcmp(k, "shadow") == 0) req->shadow = v;
+        else if (strcmp(k, "bg") == 0) req->bg = v;
+        else if (strcmp(k, "palette") == 0) req->palette = v;
+        else { req->error = "unknown key"; return; }
+    }
+    if (!req->text) req->error = "missing text";
+}
+
+/* Start rendering `req`: queue it on the pool, or render inline when the
+ * pool has no workers or its queue is full. */
+static void start_request(Conn *c, DaemonRequest *req) {
+    const RenderDaemonConfig *cfg = c->d->cfg;
+    SubtitlePositionConfig pos = cfg->pos;
+    pos.position = (SubtitlePosition)req->pos;
+
+    char *markup = srt_to_pango_markup(req->text);
+    if (!markup) { req->error = "out of memory"; return; }
+    /* An inline {\anN} overrides the requested position. */
+    SubtitlePositionConfig *inline_pos = extract_ass_alignment(markup);
+    if (inline_pos) {
+        pos = *inline_pos;
+        free(inline_pos);
+    }
+    if (render_pool_ctx_submit_async(c->d->pool, c->id, req->seq, markup,
+                                     req->w, req->h, req->size, req->font, req->style,
+                                     req->fg, req->outline, req->shadow, req->bg,
+                                     0, 0.0, &pos, req->palette) == 0) {
+        req->queued = 1;
+    } else {
+        int64_t t0 = bench_now();
+        req->bm = render_pool_ctx_render_sync(c->d->pool, markup,
+                                              req->w, req->h, req->size, req->font, req->style,
+                                              req->fg, req->outline, req->shadow, req->bg,
+                                              &pos, req->palette);
+        req->render_us = bench_now() - t0;
+    }
+    free(markup);
+}
+
+static int send_response(int fd, DaemonRequest *req) {
+    char hdr[256];
+    if (req->ping)
+        return send_all(fd, "PONG\n", 5);
+    if (req->error) {
+        int n = snprintf(hdr, sizeof(hdr), "ERR %s\n", req->error);
+        return send_all(fd, hdr, (size_t)n);
+    }
+
+    const Bitmap *bm = &req->bm;
+    int empty = (bm->w <= 0 || bm->h <= 0 || !bm->idxbuf || !bm->palette);
+    unsigned char *payload = NULL;
+    size_t payload_len = 0;
+
+    if (!empty && req->png) {
+        if (encode_bitmap_png(bm, &payload, &payload_len) != 0) {
+            int n = snprintf(hdr, sizeof(hdr), "ERR png encode failed\n");
+            return send_all(fd, hdr, (size_t)n);
+        }
+    } else if (!empty) {
+        size_t pal_bytes = (size_t)bm->nb_colors * 4;
+        size_t pix = (size_t)bm->w * (size_t)bm->h;
+        payload_len = pal_bytes + pix;
+        payload = malloc(payload_len);
+        if (!payload) {
+            int n = snprintf(hdr, sizeof(hdr), "ERR out of memory\n");
+            return send_all(fd, hdr, (size_t)n);
+        }
+        for (int i = 0; i < bm->nb_colors; i++) {
+            uint32_t argb = bm->palette[i];
+            payload[i * 4 + 0] = (unsigned char)(argb & 0xFF);
+            payload[i * 4 + 1] = (unsigned char)((argb >> 8) & 0xFF);
+            payload[i * 4 + 2] = (unsigned char)((argb >> 16) & 0xFF);
+            payload[i * 4 + 3] = (unsigned char)((argb >> 24) & 0xFF);
+        }
+        memcpy(payload + pal_bytes, bm->idxbuf, pix);
+    }
+
+    int n = snprintf(hdr, sizeof(hdr),
+                     "OK fmt=%s w=%d h=%d x=%d y=%d colors=%d bytes=%zu render_us=%lld queue_us=%lld\n",
+                     req->png ? "png" : "idx",
+                     empty ? 0 : bm->w, empty ? 0 : bm->h,
+                     empty ? 0 : bm->x, empty ? 0 : bm->y,
+                     empty ? 0 : bm->nb_colors,
+                     payload_len, (long long)req->render_us, (long long)req->queue_us);
+    int rc = send_all(fd, hdr, (size_t)n);
+    if (rc == 0 && payload_len)
+        rc = send_all(fd, payload, payload_len);
+    free(payload);
+    return rc;
+}
+
+/* Render and answer a batch of complete request lines. */
+static int handle_batch(Conn *c, char **lines, int nlines, int *seq) {
+    DaemonRequest *reqs = calloc((size_t)nlines, sizeof(*reqs));
+    if (!reqs) return -1;
+
+    for (int i = 0; i < nlines; i++) {
+        parse_request(c->d->cfg, lines[i], &reqs[i]);
+        reqs[i].seq = (*seq)++;
+        if (*seq < 0) *seq = 0;
+        if (!reqs[i].ping && !reqs[i].error)
+            start_request(c, &reqs[i]);
+    }
+
+    int rc = 0;
+    for (int i = 0; i < nlines; i++) {
+        DaemonRequest *req = &reqs[i];
+        if (req->queued) {
+            RenderJobTiming timing;
+            if (render_pool_ctx_wait_timed(c->d->pool, c->id, req->seq, &req->bm,
+                                           NULL, &timing) == 1) {
+                req->render_us = timing.render_us;
+                req->queue_us = timing.queue_us;
+            } else {
+                req->error = "render job lost";
+            }
+        }
+        if (rc == 0)
+            rc = send_response(c->fd, req);
+        av_free(req->bm.idxbuf);
+        av_free(req->bm.palette);
+    }
+    free(reqs);
+    return rc;
+}
+
+static void *conn_thread(void *arg) {
+    Conn *c = arg;
+    Daemon *d = c->d;
+    size_t cap = 64 * 1024, len = 0;
+    char *buf = malloc(cap);
+    char **lines = calloc((size_t)d->max_batch, sizeof(char *));
+    int seq = 0;
+
+    while (buf && lines && !*d->stop) {
+        struct pollfd pfd = { .fd = c->fd, .events = POLLIN };
+        int pr = poll(&pfd, 1, POLL_MS);
+        if (pr < 0 && errno != EINTR) break;
+        if (pr <= 0) continue;
+
+        if (len + 1 >= cap) {
+            if (cap >= MAX_REQUEST_LINE) {
+                send_all(c->fd, "ERR request too long\n", 21);
+                break;
+            }
+            char *nb = realloc(buf, cap * 2);
+            if (!nb) break;
+            buf = nb;
+            cap *= 2;
+        }
+        ssize_t n = recv(c->fd, buf + len, cap - len - 1, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        len += (size_t)n;
+
+        /* Split off complete lines and answer them in batches. */
+        size_t consumed = 0;
+        int failed = 0;
+        while (!failed) {
+            int nlines = 0;
+            size_t off = consumed;
+            while (nlines < d->max_batch) {
+                char *nl = memchr(buf + off, '\n', len - off);
+                if (!nl) break;
+                *nl = '\0';
+                if (nl > buf + off && nl[-1] == '\r') nl[-1] = '\0';
+                lines[nlines++] = buf + off;
+                off = (size_t)(nl - buf) + 1;
+            }
+            if (nlines == 0) break;
+            if (handle_batch(c, lines, nlines, &seq) != 0) failed = 1;
+            consumed = off;
+        }
+        if (failed) break;
+        if (consumed) {
+            memmove(buf, buf + consumed, len - consumed);
+            len -= consumed;
+        }
+    }
+
+    free(lines);
+    free(buf);
+    /* Leave the live table before closing so the listener never shuts
+     * down a descriptor number that has been reused. */
+    pthread_mutex_lock(&d->live_mtx);
+    d->live[c->slot] = NULL;
+    pthread_mutex_unlock(&d->live_mtx);
+    close(c->fd);
+    atomic_fetch_sub(&d->active, 1);
+    LOG(2, "connection %d closed\n", c->id);
+    free(c);
+    return NULL;
+}
+
+static int open_listener(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        LOG(0, "Socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    /* Replace a stale socket from a previous run, but never a regular file. */
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            LOG(0, "Refusing to replace non-socket path %s\n", path);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        LOG(0, "socket() failed: %s\n", strerror(errno));
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        LOG(0, "Cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int render_daemon_run(const RenderDaemonConfig *cfg, volatile sig_atomic_t *stop_requested) {
+    if (!cfg || !cfg->socket_path || !stop_requested) return 1;
+
+    Daemon d;
+    memset(&d, 0, sizeof(d));
+    d.cfg = cfg;
+    d.stop = stop_requested;
+    d.max_batch = cfg->max_batch > 0 ? cfg->max_batch : 16;
+    atomic_store(&d.active, 0);
+    int max_clients = cfg->max_clients > 0 ? cfg->max_clients : 8;
+
+    d.live = calloc((size_t)max_clients, sizeof(*d.live));
+    if (!d.live) {
+        LOG(0, "Out of memory starting render daemon\n");
+        return 1;
+    }
+    d.live_slots = max_clients;
+    pthread_mutex_init(&d.live_mtx, NULL);
+
+    d.pool = render_pool_create(cfg->render_threads, NULL);
+    if (!d.pool) {
+        LOG(0, "Failed to start render pool for daemon\n");
+        pthread_mutex_destroy(&d.live_mtx);
+        free(d.live);
+        return 1;
+    }
+
+    int lfd = open_listener(cfg->socket_path);
+    if (lfd < 0) {
+        render_pool_destroy(d.pool);
+        pthread_mutex_destroy(&d.live_mtx);
+        free(d.live);
+        return 1;
+    }
+    LOG(1, "Render daemon listening on %s (threads=%d clients=%d batch=%d)\n",
+        cfg->socket_path, cfg->render_threads, max_clients, d.max_batch);
+
+    int next_id = 0;
+    while (!*stop_requested) {
+        struct pollfd pfd = { .fd = lfd, .events = POLLIN };
+        int pr = poll(&pfd, 1, POLL_MS);
+        if (pr <= 0) continue;
+        int cfd = accept(lfd, NULL, NULL);
+        if (cfd < 0) continue;
+
+        if (atomic_load(&d.active) >= max_clients) {
+            send_all(cfd, "ERR busy\n", 9);
+            close(cfd);
+            continue;
+        }
+        Conn *c = malloc(sizeof(*c));
+        if (!c) { close(cfd); continue; }
+        c->d = &d;
+        c->fd = cfd;
+        c->id = next_id++;
+        if (next_id < 0) next_id = 0;
+
+        /* active < max_clients, so a slot is free; only this thread fills them. */
+        pthread_mutex_lock(&d.live_mtx);
+        c->slot = 0;
+        while (d.live[c->slot]) c->slot++;
+        d.live[c->slot] = c;
+        pthread_mutex_unlock(&d.live_mtx);
+
+        atomic_fetch_add(&d.active, 1);
+        pthread_t th;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&th, &attr, conn_thread, c) != 0) {
+            pthread_mutex_lock(&d.live_mtx);
+            d.live[c->slot] = NULL;
+            pthread_mutex_unlock(&d.live_mtx);
+            atomic_fetch_sub(&d.active, 1);
+            send_all(cfd, "ERR busy\n", 9);
+            close(cfd);
+            free(c);
+        }
+        pthread_attr_destroy(&attr);
+    }
+
+    close(lfd);
+    unlink(cfg->socket_path);
+    /* Idle connection threads notice the stop flag within POLL_MS; one
+     * blocked in send() to a client that stopped reading does not, so
+     * shut every live socket down to fail its send and recv. */
+    pthread_mutex_lock(&d.live_mtx);
+    for (int i = 0; i < d.live_slots; i++) {
+        if (d.live[i])
+            shutdown(d.live[i]->fd, SHUT_RDWR);
+    }
+    pthread_mutex_unlock(&d.live_mtx);
+    while (atomic_load(&d.active) > 0) {
+        struct timespec ts = { 0, POLL_MS * 1000000L / 4 };
+        nanosleep(&ts, NULL);
+    }
+    render_pool_destroy(d.pool);
+    pthread_mutex_destroy(&d.live_mtx);
+    free(d.live);
+    LOG(1, "Render daemon stopped\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+#pragma once
+#ifndef RENDER_DAEMON_H
+#define RENDER_DAEMON_H
+
+#include <signal.h>
+#include "runtime_opts.h"
+
+/**
+ * @file render_daemon.h
+ * @brief Render-only service mode: a long-lived process that renders
+ * single cues on request over a UNIX domain socket.
+ *
+ * Tools that only need DVB-ready bitmaps for individual cues (preview
+ * UIs, QC front ends) connect to the daemon instead of spawning
+ * `srt2dvbsub --png-only` per request. The daemon keeps fontconfig, the
+ * Pango fontmap and its render pool warm, so a request only pays for the
+ * raster work itself.
+ *
+ * Wire protocol (one request per line, UTF-8):
+ *
+ *   text=Hello\nWorld<TAB>w=1920<TAB>h=1080<TAB>fmt=png
+ *
+ * Fields are TAB-separated key=value pairs. `text` is required; in its
+ * value `\n`, `\t` and `\\` are unescaped. Optional keys: w, h, size,
+ * font, style, fg, outline, shadow, bg, palette, pos (1..9, see
+ * SubtitlePosition) and fmt (`idx` or `png`, default `idx`). Omitted
+ * keys fall back to the daemon's command line style. The line `PING`
+ * is answered with `PONG`.
+ *
+ * Each request produces, in order:
+ *
+ *   OK fmt=<idx|png> w=<W> h=<H> x=<X> y=<Y> colors=<N> bytes=<B> render_us=<U> queue_us=<Q>\n
+ *   <B payload bytes>
+ *
+ * `render_us` is the render call alone, timed on the thread that ran it;
+ * `queue_us` is how long the request waited for a pool worker (0 when it
+ * was rendered inline because the pool had no workers or a full queue).
+ *
+ * or `ERR <message>\n`. For fmt=idx the payload is N little-endian
+ * ARGB palette words followed by W*H palette indices; for fmt=png it is
+ * a PNG stream. An empty cue yields w=h=0 and no payload.
+ *
+ * Batching: requests pipelined on one connection are parsed together
+ * (up to `max_batch`) and submitted to the render pool at once, so a
+ * client can keep all workers busy over a single socket. Responses keep
+ * request order. At most `max_clients` connections are served
+ * concurrently; extra connections receive `ERR busy` and are closed.
+ */
+
+/** Default style and limits for the daemon. String fields are borrowed. */
+typedef struct {
+    const char *socket_path;   /**< filesystem path of the listening socket */
+    int max_clients;           /**< concurrent connections (<= 0: 8) */
+    int max_batch;             /**< pipelined requests per batch (<= 0: 16) */
+    int render_threads;        /**< worker threads of the daemon's pool */
+    int video_w;               /**< default canvas width */
+    int video_h;               /**< default canvas height */
+    int fontsize;              /**< default font size (0 = dynamic) */
+    const char *font;
+    const char *fontstyle;
+    const char *fgcolor;
+    const char *outlinecolor;
+    const char *shadowcolor;
+    const char *bgcolor;
+    const char *palette_mode;
+    SubtitlePositionConfig pos; /**< default placement and margins */
+} RenderDaemonConfig;
+
+/**
+ * Serve render requests until `*stop_requested` becomes non-zero.
+ *
+ * @return 0 on clean shutdown, 1 if the socket could not be set up.
+ */
+int render_daemon_run(const RenderDaemonConfig *cfg, volatile sig_atomic_t *stop_requested);
+
+#endif
@@ -51,6 +51,9 @@
 #include "palette.h"
 #include "debug.h"
 #include "utils.h"
+#include "glyph_atlas.h"
+#include "coverage_effects.h"
+#include "bench.h"
 #include <cairo.h>
 #include <pango/pangocairo.h>
 #include <stdlib.h>
@@ -126,6 +129,35 @@ static PangoFontMap *get_thread_pango_fontmap(void) {
     return fm;
 }
 
+/* Per-thread glyph atlas for the plain-text fast path. Tiles are keyed
+ * on font descriptions, so they stay valid across fontmap re-creation. */
+#define GLYPH_ATLAS_MAX_TILES 2048
+static pthread_key_t glyph_atlas_key;
+static pthread_once_t glyph_atlas_key_once = PTHREAD_ONCE_INIT;
+
+static void glyph_atlas_destructor(void *v) {
+    glyph_atlas_destroy((GlyphAtlas *)v);
+}
+
+static void make_glyph_atlas_key(void) {
+    int rc = pthread_key_create(&glyph_atlas_key, glyph_atlas_destructor);
+    if (rc != 0)
+        fprintf(stderr, "render_pango: pthread_key_create (atlas) failed: %d\n", rc);
+}
+
+static GlyphAtlas *get_thread_glyph_atlas(void) {
+    pthread_once(&glyph_atlas_key_once, make_glyph_atlas_key);
+    GlyphAtlas *atlas = (GlyphAtlas *)pthread_getspecific(glyph_atlas_key);
+    if (!atlas) {
+        atlas = glyph_atlas_create(GLYPH_ATLAS_MAX_TILES);
+        if (atlas && pthread_setspecific(glyph_atlas_key, atlas) != 0) {
+            glyph_atlas_destroy(atlas);
+            atlas = NULL;
+        }
+    }
+    return atlas;
+}
+
 /*
  * render_pango_cleanup
  * ---------------------
@@ -140,6 +172,12 @@ void render_pango_cleanup(void) {
         pthread_setspecific(pango_fontmap_key, NULL);
         g_object_unref((GObject*)fm);
     }
+    pthread_once(&glyph_atlas_key_once, make_glyph_atlas_key);
+    GlyphAtlas *atlas = (GlyphAtlas *)pthread_getspecific(glyph_atlas_key);
+    if (atlas) {
+        pthread_setspecific(glyph_atlas_key, NULL);
+        glyph_atlas_destroy(atlas);
+    }
 }
 
 /* Safety helpers for guarded allocations and multiplication checks. */
@@ -181,6 +219,12 @@ static atomic_int dbg_ssaa_override = 0; /* >0 forces a specific supersample fac
 static atomic_int dbg_no_unsharp = 0;    /* disable unsharp sharpening when non-zero */
 void render_pango_set_ssaa_override(int ssaa) { atomic_store(&dbg_ssaa_override, ssaa); }
 void render_pango_set_no_unsharp(int no) { atomic_store(&dbg_no_unsharp, no); }
+static atomic_int dbg_glyph_atlas = 0; /* composite eligible cues from glyph tiles */
+void render_pango_set_glyph_atlas(int on) { atomic_store(&dbg_glyph_atlas, on); }
+static atomic_int dbg_effects_mode = RENDER_EFFECTS_CAIRO; /* RenderEffectsMode */
+void render_pango_set_effects_mode(int mode) { atomic_store(&dbg_effects_mode, mode); }
+static atomic_int dbg_prebroken = 0; /* cue text arrives wrapped by line_break.c */
+void render_pango_set_prebroken(int prebroken) { atomic_store(&dbg_prebroken, prebroken); }
 
 /* Palette presets */
 /*
@@ -438,6 +482,9 @@ char* srt_to_pango_markup(const char *srt_text) {
     if (!buf) return alloc_empty_string();
     char *out = buf;
     const char *p = srt_text;
+    /* Set once no '>' follows, so a run of unclosed "<font " openers is
+     * copied through without rescanning the rest of the text each time. */
+    int no_gt = 0;
     while (*p) {
         size_t used = (size_t)(out - buf);
         if (used + 16 >= maxlen) break; /* keep some slack for worst-case writes */
@@ -493,7 +540,8 @@ char* srt_to_pango_markup(const char *srt_text) {
         }
         else if (strncasecmp(p, "<font ", 6) == 0) {
             /* Convert <font color="#RRGGBB"> or <font color="#RRGGBBAA"> to <span foreground="..."> */
-            const char *end = strchr(p, '>');
+            const char *end = no_gt ? NULL : strchr(p, '>');
+            if (!end) no_gt = 1;
             if (end) {
                 char tmp[256];
                 size_t tlen = (size_t)(end - p + 1);
@@ -581,8 +629,6 @@ char* srt_to_pango_markup(const char *srt_text) {
  *  - dummy: Dummy Cairo surface to destroy
  *  - layout_real: Real Pango layout to unref
  *  - ctx_real: Real Pango context to unref
- *  - cr: Real Cairo context to destroy
- *  - surface_ss: Supersampled Cairo surface to destroy
  *  - surface: Final Cairo surface to destroy
  */
 static void cleanup_render_resources(bool success, Bitmap *bm,
@@ -596,8 +642,6 @@ static void cleanup_render_resources(bool success, Bitmap *bm,
                                      cairo_surface_t *dummy,
                                      PangoLayout *layout_real,
                                      PangoContext *ctx_real,
-                                     cairo_t *cr,
-                                     cairo_surface_t *surface_ss,
                                      cairo_surface_t *surface)
 {
     if (success) {
@@ -670,7 +714,6 @@ static void cleanup_render_resources(bool success, Bitmap *bm,
     
     /* Destroy Cairo contexts first (they reference surfaces) */
     if (cr_dummy) cairo_destroy(cr_dummy);
-    if (cr) cairo_destroy(cr);
     
     /* Destroy Pango layouts and contexts next */
     if (layout_dummy) g_object_unref(layout_dummy);
@@ -683,80 +726,42 @@ static void cleanup_render_resources(bool success, Bitmap *bm,
     
     /* Destroy Cairo surfaces last (all contexts referencing them are already destroyed) */
     if (dummy) cairo_surface_destroy(dummy);
-    if (surface_ss) cairo_surface_destroy(surface_ss);
     if (surface) cairo_surface_destroy(surface);
 }
 
 /*
- * render_text_pango
- * -----------------
- * Render the provided Pango markup into an indexed Bitmap suitable for
- * the DVB/AVSubtitle pipeline. High-level steps:
- *  1. Resolve font size (adaptive if fontsize<=0).
- *  2. Create a supersampled Cairo surface and render the Pango layout at
- *     higher resolution to improve edge quality.
- *  3. Optionally blur/sharpen the supersampled surface and downsample.
- *  4. Convert ARGB pixels to indexed palette using error-diffusion
- *     dithering plus cleanup passes to remove speckles and short runs.
- *
- * The returned Bitmap contains allocated `idxbuf` and `palette` which
- * the caller must free when no longer needed.
+ * make_render_font_options
+ * ------------------------
+ * Font options shared by the layout context and every Cairo context
+ * that draws it. For HD/UHD with stronger supersampling we prefer to
+ * disable hinting/metrics so glyph shapes remain smooth and rely on
+ * SSAA for crisp edges. Caller destroys the result.
  */
-Bitmap render_text_pango(const char *markup,
-                          int disp_w, int disp_h,
-                          int fontsize, const char *fontfam,
-                          const char *fontstyle,
-                          const char *fgcolor,
-                          const char *outlinecolor,
-                          const char *shadowcolor,
-                          const char *bgcolor,
-                          SubtitlePositionConfig *pos_config,
-                          const char *palette_mode) {
-    Bitmap bm={0};
-    
-    LOG(3, "DEBUG render_text_pango: bgcolor=%s\n", bgcolor ? bgcolor : "(null)");
-
-    /* Local resource pointers: initialize to NULL so cleanup is safe on any
-     * early-failure path. */
-    PangoFontMap *thread_fm = NULL;
-    PangoFontDescription *desc = NULL;
-    PangoContext *ctx_dummy = NULL;
-    PangoLayout *layout_dummy = NULL;
-    cairo_surface_t *dummy = NULL;
-    cairo_t *cr_dummy = NULL;
-    PangoContext *ctx_real = NULL;
-    PangoLayout *layout_real = NULL;
-    cairo_surface_t *surface_ss = NULL;
-    cairo_t *cr = NULL;
-    cairo_surface_t *surface = NULL;
-
-    /* Ensure we have a single process-wide PangoFontMap to avoid creating
-     * multiple internal fontconfig allocations across repeated renders.
-     * We create contexts from this map per-render and unref them. */
-    /* Ensure a per-thread fontmap exists (created on first use). */
-    thread_fm = get_thread_pango_fontmap();
-    if (!thread_fm) return bm; /* can't proceed without a fontmap */
-
-    /* Defensive: refuse to attempt rendering for absurd display sizes that
-     * are almost certainly a caller error or test of failure paths. This
-     * avoids creating huge Cairo surfaces or layouts when disp_w/h are
-     * unreasonably large (e.g., user-provided test harness values). */
-    if ((size_t)disp_w > RENDER_PANGO_SAFE_MAX_DIM || (size_t)disp_h > RENDER_PANGO_SAFE_MAX_DIM) {
-        /* return empty bitmap (idxbuf==NULL) to indicate we couldn't allocate */
-        return bm;
+static cairo_font_options_t *make_render_font_options(int ss)
+{
+    cairo_font_options_t *fopt = cairo_font_options_create();
+    if (ss >= 3) {
+        cairo_font_options_set_hint_style(fopt, CAIRO_HINT_STYLE_NONE);
+        cairo_font_options_set_hint_metrics(fopt, CAIRO_HINT_METRICS_OFF);
+    } else {
+        cairo_font_options_set_hint_style(fopt, CAIRO_HINT_STYLE_FULL);
+        cairo_font_options_set_hint_metrics(fopt, CAIRO_HINT_METRICS_DEFAULT);
     }
+    return fopt;
+}
 
-    /* --- Font size selection ---
-     * If caller passed a positive fontsize (CLI --fontsize), respect it.
-     * Otherwise compute a dynamic font size based on display height using
-     * targeted ranges for SD, HD and UHD:
-     *  SD:  ~18..22
-     *  HD:  ~40..48
-     *  UHD: ~80..88 */
-    
-    LOG(2, "render_text_pango: Input fontfam='%s' fontstyle='%s' fontsize=%d disp_h=%d\n",
-        fontfam ? fontfam : "(null)", fontstyle ? fontstyle : "(null)", fontsize, disp_h);
-    
+/*
+ * resolve_fontsize
+ * ----------------
+ * If caller passed a positive fontsize (CLI --fontsize), respect it.
+ * Otherwise compute a dynamic font size based on display height using
+ * targeted ranges for SD, HD and UHD:
+ *  SD:  ~18..22
+ *  HD:  ~40..48
+ *  UHD: ~80..88
+ */
+static int resolve_fontsize(int fontsize, int disp_h)
+{
     if (fontsize > 0) {
         /* respect caller-provided fontsize (no upper clamp) */
     } else {
@@ -788,8 +793,20 @@ Bitmap render_text_pango(const char *markup,
         fontsize = f;
         LOG(2, "render_text_pango: Adaptive fontsize calculated: %d\n", fontsize);
     }
+    return fontsize;
+}
 
-    /* Create common font description */
+/*
+ * make_font_description
+ * ---------------------
+ * "<family> <style>" at an absolute pixel size, falling back to the
+ * family alone and then to a bare description. Caller frees.
+ */
+static PangoFontDescription *make_font_description(const char *fontfam,
+                                                   const char *fontstyle,
+                                                   int fontsize)
+{
+    PangoFontDescription *desc = NULL;
     const char *base_family = (fontfam && *fontfam) ? fontfam : "Open Sans";
     char *desc_string = NULL;
     if (fontstyle && *fontstyle) {
@@ -800,269 +817,434 @@ Bitmap render_text_pango(const char *markup,
     }
     if (desc_string)
         desc = pango_font_description_from_string(desc_string);
+    free(desc_string);
     if (!desc)
         desc = pango_font_description_from_string(base_family);
     if (!desc) {
         desc = pango_font_description_new();
-        if (!desc) {
-            cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                    desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                    layout_real, ctx_real, cr, surface_ss, surface);
-            return bm;
-        }
+        if (!desc) return NULL;
         pango_font_description_set_family(desc, base_family);
     }
     pango_font_description_set_absolute_size(desc, fontsize * PANGO_SCALE);
-    
-    LOG(2, "render_text_pango: Resolved font='%s' style='%s' size=%d (base_family resolved to '%s')\n",
-        base_family, (fontstyle && *fontstyle) ? fontstyle : "(default)", fontsize, base_family);
-    
-    free(desc_string);
+    return desc;
+}
 
-    /* --- Check for ASS alignment override in markup ({\an<digit>}) ---
-     * Must use a mutable copy since extract_ass_alignment modifies the string.
-     * This also removes the {\an<digit>} tag from the markup before rendering. */
-    char *markup_copy = malloc(strlen(markup) + 1);
-    if (!markup_copy) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+/*
+ * make_measure_font_options
+ * -------------------------
+ * Font options of the measurement layout: unhinted for SD, fully hinted
+ * above. Caller destroys the result.
+ */
+static cairo_font_options_t *make_measure_font_options(int disp_h)
+{
+    cairo_font_options_t *fopt = cairo_font_options_create();
+    if (disp_h <= 576) {
+        cairo_font_options_set_hint_style(fopt, CAIRO_HINT_STYLE_NONE);
+        cairo_font_options_set_hint_metrics(fopt, CAIRO_HINT_METRICS_OFF);
+    } else {
+        cairo_font_options_set_hint_style(fopt, CAIRO_HINT_STYLE_FULL);
+        cairo_font_options_set_hint_metrics(fopt, CAIRO_HINT_METRICS_DEFAULT);
     }
-    strcpy(markup_copy, markup);
-    
-    SubtitlePositionConfig *ass_config = extract_ass_alignment(markup_copy);
-    
-    /* Use the cleaned markup (with ASS tag removed) for further processing */
-    const char *final_markup = markup_copy;
-    const int has_inline_foreground = (strstr(final_markup, "foreground=\"") != NULL);
+    return fopt;
+}
 
-    /* --- Dummy layout for measurement --- */
-    dummy = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-    if (!dummy || cairo_surface_status(dummy) != CAIRO_STATUS_SUCCESS) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+/*
+ * effect_geometry
+ * ---------------
+ * Outline stroke width and shadow offset, in layout (1x pixel) units.
+ */
+static void effect_geometry(int fontsize, int ss, int disp_h, double *stroke_w, double *shadow_off)
+{
+    /* Shadow offset in user-space units; a prior change multiplied by
+     * `ss` here which double-applied the cairo_scale() and produced an
+     * overly large shadow translate. Keep a small minimum of 1.0 user
+     * unit so very small fonts still get a visible shadow. */
+    *shadow_off = (fontsize * 0.04);
+    if (*shadow_off < 1.0) *shadow_off = 1.0; /* at least 1 user unit */
+
+    /* Make stroke width proportional to fontsize, but scale it down slightly
+     * for higher SSAA so strokes don't appear overly thick after downsampling. */
+    *stroke_w = 0.4 + (fontsize * 0.018);
+    /* For very large displays we thin the stroke a bit when SSAA is high
+     * to avoid overly chunky outlines after downsampling. For SD we keep
+     * the stroke thicker to prevent small glyph features from being eaten. */
+    if (ss >= 4 && disp_h > 576) *stroke_w *= 0.70; /* thinner at 4x for HD/UHD */
+}
+
+/*
+ * effects_use_morph
+ * -----------------
+ * Whether this cue derives outline and shadow from its fill coverage
+ * (see coverage_effects.h) instead of stroking with Cairo. In auto mode
+ * the HD/UHD profiles, where SSAA surfaces and stroke cost are largest,
+ * use the morphological pipeline and SD keeps Cairo.
+ */
+static int effects_use_morph(int disp_h)
+{
+    switch (atomic_load(&dbg_effects_mode)) {
+    case RENDER_EFFECTS_MORPH: return 1;
+    case RENDER_EFFECTS_AUTO:  return disp_h > 576;
+    default:                   return 0;
     }
-    cr_dummy = cairo_create(dummy);
-    if (!cr_dummy || cairo_status(cr_dummy) != CAIRO_STATUS_SUCCESS) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+}
+
+/*
+ * markup_is_atlas_eligible
+ * ------------------------
+ * True when the markup is plain text or uses only the italic span that
+ * srt_to_pango_markup() emits for <i>. Such cues differ from each other
+ * only in font face, so every glyph can come from the atlas.
+ */
+static int markup_is_atlas_eligible(const char *m)
+{
+    static const char italic_open[] = "<span style=\"italic\">";
+    static const char span_close[] = "</span>";
+    while ((m = strchr(m, '<')) != NULL) {
+        if (strncmp(m, italic_open, sizeof(italic_open) - 1) == 0)
+            m += sizeof(italic_open) - 1;
+        else if (strncmp(m, span_close, sizeof(span_close) - 1) == 0)
+            m += sizeof(span_close) - 1;
+        else
+            return 0;
     }
-    ctx_dummy = pango_font_map_create_context(thread_fm);
-    if (!ctx_dummy) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+    return 1;
+}
+
+static uint32_t rgba_to_argb(const double c[4])
+{
+    uint32_t a = (uint32_t)lround(fmin(1.0, fmax(0.0, c[3])) * 255.0);
+    uint32_t r = (uint32_t)lround(fmin(1.0, fmax(0.0, c[0])) * 255.0);
+    uint32_t g = (uint32_t)lround(fmin(1.0, fmax(0.0, c[1])) * 255.0);
+    uint32_t b = (uint32_t)lround(fmin(1.0, fmax(0.0, c[2])) * 255.0);
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+/*
+ * rasterise_glyph_tile
+ * --------------------
+ * Atlas miss: draw one glyph's shadow, outline and fill at `ss`x into
+ * an A8 scratch surface, exactly as the Cairo path would draw them, and
+ * box-downsample each into the new tile's coverage planes. The glyph
+ * origin sits at the tile's subpixel phase.
+ */
+static const GlyphTile *rasterise_glyph_tile(GlyphAtlas *atlas, PangoFont *font, uint64_t key,
+                                             PangoGlyph glyph, int phase, int ss,
+                                             double stroke_w, double shadow_off, int morph)
+{
+    PangoRectangle ink;
+    pango_font_get_glyph_extents(font, glyph, &ink, NULL);
+    double fx = (double)(phase / GLYPH_ATLAS_PHASES) / GLYPH_ATLAS_PHASES;
+    double fy = (double)(phase % GLYPH_ATLAS_PHASES) / GLYPH_ATLAS_PHASES;
+    double grow = stroke_w / 2.0 + 1.0;
+    int x0 = (int)floor((double)ink.x / PANGO_SCALE + fx - grow);
+    int y0 = (int)floor((double)ink.y / PANGO_SCALE + fy - grow);
+    int x1 = (int)ceil((double)(ink.x + ink.width) / PANGO_SCALE + fx + grow + shadow_off);
+    int y1 = (int)ceil((double)(ink.y + ink.height) / PANGO_SCALE + fy + grow + shadow_off);
+
+    if (ink.width <= 0 || ink.height <= 0) /* blank glyphs keep an all-zero tile */
+        return glyph_atlas_add(atlas, key, glyph, phase, x1 - x0, y1 - y0, x0, y0);
+
+    /* Scratch resources first, so a failure never leaves a blank tile
+     * cached under this glyph's key. */
+    const int sw = (x1 - x0) * ss, sh = (y1 - y0) * ss;
+    cairo_surface_t *cs = cairo_image_surface_create(CAIRO_FORMAT_A8, sw, sh);
+    cairo_t *cr = (cs && cairo_surface_status(cs) == CAIRO_STATUS_SUCCESS) ? cairo_create(cs) : NULL;
+    PangoGlyphString *gs = pango_glyph_string_new();
+    uint8_t *derived = morph ? malloc((size_t)sw * sh) : NULL;
+    GlyphTile *t = NULL;
+    if (cr && cairo_status(cr) == CAIRO_STATUS_SUCCESS && gs && (!morph || derived))
+        t = glyph_atlas_add(atlas, key, glyph, phase, x1 - x0, y1 - y0, x0, y0);
+    if (!t) {
+        free(derived);
+        if (gs) pango_glyph_string_free(gs);
+        if (cr) cairo_destroy(cr);
+        if (cs) cairo_surface_destroy(cs);
+        return NULL; /* caller falls back to the Cairo path for this cue */
     }
-    
-    /* Apply same font options to dummy context for consistent measurement */
-    cairo_font_options_t *fopt_dummy = cairo_font_options_create();
-    if (disp_h <= 576) {
-        cairo_font_options_set_hint_style(fopt_dummy, CAIRO_HINT_STYLE_NONE);
-        cairo_font_options_set_hint_metrics(fopt_dummy, CAIRO_HINT_METRICS_OFF);
-    } else {
-        cairo_font_options_set_hint_style(fopt_dummy, CAIRO_HINT_STYLE_FULL);
-        cairo_font_options_set_hint_metrics(fopt_dummy, CAIRO_HINT_METRICS_DEFAULT);
+    pango_glyph_string_set_size(gs, 1);
+    memset(&gs->glyphs[0], 0, sizeof(gs->glyphs[0]));
+    gs->glyphs[0].glyph = glyph;
+    gs->glyphs[0].attr.is_cluster_start = 1;
+    gs->log_clusters[0] = 0;
+
+    cairo_set_antialias(cr, CAIRO_ANTIALIAS_BEST);
+    cairo_font_options_t *fopt = make_render_font_options(ss);
+    cairo_set_font_options(cr, fopt);
+    cairo_font_options_destroy(fopt);
+    cairo_scale(cr, (double)ss, (double)ss);
+    cairo_translate(cr, fx - x0, fy - y0);
+
+    unsigned char *data = cairo_image_surface_get_data(cs);
+    int stride = cairo_image_surface_get_stride(cs);
+    if (morph) {
+        /* One fill raster; outline and shadow planes are derived from it. */
+        cairo_set_source_rgba(cr, 0, 0, 0, 1);
+        pango_cairo_show_glyph_string(cr, font, gs);
+        cairo_surface_flush(cs);
+        glyph_coverage_downsample(data, stride, ss, t->plane[GLYPH_PLANE_FILL], t->w, t->h);
+        if (coverage_outline(data, stride, sw, sh, stroke_w / 2.0 * ss, derived, sw) == 0)
+            glyph_coverage_downsample(derived, sw, ss, t->plane[GLYPH_PLANE_OUTLINE], t->w, t->h);
+        int shift = (int)lround(shadow_off * ss);
+        coverage_shift(data, stride, sw, sh, shift, shift, derived, sw);
+        glyph_coverage_downsample(derived, sw, ss, t->plane[GLYPH_PLANE_SHADOW], t->w, t->h);
     }
-    pango_cairo_context_set_font_options(ctx_dummy, fopt_dummy);
-    cairo_set_font_options(cr_dummy, fopt_dummy);
-    cairo_font_options_destroy(fopt_dummy);
-    
-    layout_dummy = pango_layout_new(ctx_dummy);
-    if (!layout_dummy) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+    for (int p = 0; p < GLYPH_PLANE_COUNT && !morph; p++) {
+        cairo_save(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+        cairo_paint(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+        cairo_set_source_rgba(cr, 0, 0, 0, 1);
+        if (p == GLYPH_PLANE_SHADOW) {
+            cairo_translate(cr, shadow_off, shadow_off);
+            pango_cairo_show_glyph_string(cr, font, gs);
+        } else if (p == GLYPH_PLANE_OUTLINE) {
+            cairo_set_line_width(cr, stroke_w);
+            cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+            pango_cairo_glyph_string_path(cr, font, gs);
+            cairo_stroke(cr);
+        } else {
+            pango_cairo_show_glyph_string(cr, font, gs);
+        }
+        cairo_restore(cr);
+        cairo_surface_flush(cs);
+        glyph_coverage_downsample(data, stride, ss, t->plane[p], t->w, t->h);
     }
-    pango_layout_set_font_description(layout_dummy, desc);
-    pango_layout_set_width(layout_dummy, disp_w * 0.8 * PANGO_SCALE);
-    pango_layout_set_wrap(layout_dummy, PANGO_WRAP_WORD_CHAR);
-    /* Alignment will be set after final_config is determined (see below) */
-    pango_layout_set_markup(layout_dummy, final_markup, -1);
 
-    int lw, lh;
+    free(derived);
+    pango_glyph_string_free(gs);
+    cairo_destroy(cr);
+    cairo_surface_destroy(cs);
+    return t;
+}
 
-    pango_layout_get_pixel_size(layout_dummy, &lw, &lh);
-    
-    /* Platform-specific line height adjustment
-     * macOS Pango/Cairo font metrics differ from Linux, resulting in different line heights.
-     * Apply a correction factor to normalize rendering across platforms. */
-    #ifdef __APPLE__
-        /* macOS tends to report larger line heights; scale down slightly for consistency */
-        lh = (int)(lh * 0.95);
-    #endif
-    
-    /* For centered text, create a layout with width matching the actual text width
-     * so center alignment works properly without extra padding on the sides */
-    int layout_width_for_real = lw;
+typedef struct {
+    const GlyphTile *tile;
+    int x, y; /* glyph origin in output pixels */
+} AtlasPlacement;
 
-    /* --- Placement in full frame ---
-     * Use 9-position grid positioning from config. Default to bottom-center if no config provided.
-     */
-    SubtitlePositionConfig default_config = {
-        .position = SUB_POS_BOT_CENTER,
-        .margin_top = 3.5,
-        .margin_left = 3.5,
-        .margin_bottom = 3.5,
-        .margin_right = 3.5
-    };
-    
-    SubtitlePositionConfig *final_config = ass_config ? ass_config : (pos_config ? pos_config : &default_config);
+/*
+ * render_layout_atlas
+ * -------------------
+ * Glyph-atlas path: walk the layout's glyph runs, fetch (or rasterise)
+ * a tile per glyph at its Pango position snapped to 1/GLYPH_ATLAS_PHASES
+ * px, then composite every shadow, then every outline, then every fill
+ * into a new w x h ARGB32 surface. Returns NULL (nothing drawn) when a
+ * glyph is missing from its font or a tile cannot be built, so the
+ * caller can use the Cairo path instead.
+ */
+static cairo_surface_t *render_layout_atlas(PangoLayout *layout, int w, int h, int pad, int ss,
+                                            double stroke_w, double shadow_off, int morph, int draw_shadow,
+                                            const double fill[4], const double outline[4],
+                                            const double shadow[4])
+{
+    GlyphAtlas *atlas = get_thread_glyph_atlas();
+    if (!atlas) return NULL;
+    glyph_atlas_trim(atlas);
+
+    uint64_t profile = glyph_atlas_key_mix(0, (uint64_t)ss);
+    profile = glyph_atlas_key_mix(profile, (uint64_t)llround(stroke_w * 1024.0));
+    profile = glyph_atlas_key_mix(profile, (uint64_t)llround(shadow_off * 1024.0));
+    profile = glyph_atlas_key_mix(profile, (uint64_t)morph);
+
+    PangoLayoutIter *it = pango_layout_get_iter(layout);
+    if (!it) return NULL;
+    AtlasPlacement *pl = NULL;
+    int npl = 0, cap = 0, ok = 1;
+    PangoFont *last_font = NULL;
+    uint64_t font_key = 0;
+    do {
+        PangoLayoutRun *run = pango_layout_iter_get_run_readonly(it);
+        if (!run) continue; /* end of line */
+        PangoRectangle logical;
+        pango_layout_iter_get_run_extents(it, NULL, &logical);
+        int baseline = pango_layout_iter_get_baseline(it);
+        PangoFont *font = run->item->analysis.font;
+        if (font != last_font) {
+            PangoFontDescription *fd = pango_font_describe(font);
+            char *fds = fd ? pango_font_description_to_string(fd) : NULL;
+            font_key = glyph_atlas_key_str(profile, fds ? fds : "");
+            g_free(fds);
+            if (fd) pango_font_description_free(fd);
+            last_font = font;
+        }
+        int x = logical.x;
+        for (int i = 0; i < run->glyphs->num_glyphs && ok; i++) {
+            const PangoGlyphInfo *gi = &run->glyphs->glyphs[i];
+            int gx = x + gi->geometry.x_offset;
+            int gy = baseline + gi->geometry.y_offset;
+            x += gi->geometry.width;
+            if (gi->glyph == PANGO_GLYPH_EMPTY) continue;
+            if (gi->glyph & PANGO_GLYPH_UNKNOWN_FLAG) { ok = 0; break; }
+
+            long qx = lround((pad + (double)gx / PANGO_SCALE) * GLYPH_ATLAS_PHASES);
+            long qy = lround((pad + (double)gy / PANGO_SCALE) * GLYPH_ATLAS_PHASES);
+            int ix = (int)floor((double)qx / GLYPH_ATLAS_PHASES);
+            int iy = (int)floor((double)qy / GLYPH_ATLAS_PHASES);
+            int phase = (int)(qx - (long)ix * GLYPH_ATLAS_PHASES) * GLYPH_ATLAS_PHASES +
+                        (int)(qy - (long)iy * GLYPH_ATLAS_PHASES);
+
+            const GlyphTile *t = glyph_atlas_find(atlas, font_key, gi->glyph, phase);
+            if (!t)
+                t = rasterise_glyph_tile(atlas, font, font_key, gi->glyph, phase, ss,
+                                         stroke_w, shadow_off, morph);
+            if (!t) { ok = 0; break; }
+            if (npl == cap) {
+                int ncap = cap ? cap * 2 : 64;
+                AtlasPlacement *np = realloc(pl, (size_t)ncap * sizeof(*pl));
+                if (!np) { ok = 0; break; }
+                pl = np;
+                cap = ncap;
+            }
+            pl[npl++] = (AtlasPlacement){ t, ix, iy };
+        }
+    } while (ok && pango_layout_iter_next_run(it));
+    pango_layout_iter_free(it);
 
-    /* Determine text alignment within bounding box based on horizontal position */
-    PangoAlignment text_alignment = PANGO_ALIGN_CENTER;
-    switch (final_config->position) {
-        case SUB_POS_TOP_LEFT:
-        case SUB_POS_MID_LEFT:
-        case SUB_POS_BOT_LEFT:
-            text_alignment = PANGO_ALIGN_LEFT;
-            break;
-        case SUB_POS_TOP_RIGHT:
-        case SUB_POS_MID_RIGHT:
-        case SUB_POS_BOT_RIGHT:
-            text_alignment = PANGO_ALIGN_RIGHT;
-            break;
-        case SUB_POS_TOP_CENTER:
-        case SUB_POS_MID_CENTER:
-        case SUB_POS_BOT_CENTER:
-        default:
-            text_alignment = PANGO_ALIGN_CENTER;
-            break;
+    cairo_surface_t *surface = NULL;
+    if (ok)
+        surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+    if (surface && cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS) {
+        cairo_surface_flush(surface);
+        unsigned char *data = cairo_image_surface_get_data(surface);
+        int stride = cairo_image_surface_get_stride(surface);
+        const uint32_t colors[GLYPH_PLANE_COUNT] = {
+            [GLYPH_PLANE_SHADOW] = draw_shadow ? rgba_to_argb(shadow) : 0,
+            [GLYPH_PLANE_OUTLINE] = rgba_to_argb(outline),
+            [GLYPH_PLANE_FILL] = rgba_to_argb(fill),
+        };
+        for (int p = 0; p < GLYPH_PLANE_COUNT; p++)
+            for (int i = 0; i < npl; i++)
+                glyph_tile_composite(data, stride, w, h, pl[i].tile, p, pl[i].x, pl[i].y, colors[p]);
+        cairo_surface_mark_dirty(surface);
+    } else if (surface) {
+        cairo_surface_destroy(surface);
+        surface = NULL;
     }
-    
-    /* Now apply alignment to layout_dummy (was deferred earlier) */
-    pango_layout_set_alignment(layout_dummy, text_alignment);
+    free(pl);
+    return surface;
+}
 
-    /* --- Adaptive supersampled rendering surface ---
-     * Choose supersample factor based on display height.
-     * SD gets a higher SSAA to avoid blockiness. For HD/UHD we also
-     * increase SSAA to keep glyph edges smooth at larger sizes.
-     * These choices balance quality vs CPU/memory; users can override
-     * with the ssaa_override runtime knob. */
-    int ss;
-    if (disp_h <= 576) {
-    ss = 2; /* SD: increase supersample to further reduce blockiness on low res */
-    } else if (disp_h <= 1080) {
-    ss = 3; /* HD: bump to 3x to improve edge fidelity compared to previous 2x */
-    } else if (disp_h <= 2160) {
-    ss = 4; /* 4k/2160p target: use 4x for best quality on UHD */
-    } else {
-    ss = 4; /* very large displays: cap at 4x */
+/*
+ * draw_effects_morph
+ * ------------------
+ * Morphological effect pipeline: rasterise the layout's fill coverage
+ * once into an A8 surface the size of `surface_ss`, then derive outline
+ * and shadow from it and composite all three layers onto `surface_ss`
+ * in one pass. Returns 0 on success, -1 (nothing drawn) on failure.
+ */
+static int draw_effects_morph(PangoLayout *layout_real, cairo_surface_t *surface_ss,
+                              int ss, int pad, double stroke_w, double shadow_off,
+                              int draw_shadow, const double fill[4],
+                              const double outline[4], const double shadow[4])
+{
+    int ss_w = cairo_image_surface_get_width(surface_ss);
+    int ss_h = cairo_image_surface_get_height(surface_ss);
+    cairo_surface_t *mask = cairo_image_surface_create(CAIRO_FORMAT_A8, ss_w, ss_h);
+    if (!mask || cairo_surface_status(mask) != CAIRO_STATUS_SUCCESS) {
+        if (mask) cairo_surface_destroy(mask);
+        return -1;
     }
-    if (atomic_load(&dbg_ssaa_override) > 0) ss = atomic_load(&dbg_ssaa_override);
-    /* pad to accommodate strokes when upscaled; scale with fontsize so
-     * UHD/large text get enough room and strokes don't clip. */
-    int pad = 8;
-    if (fontsize > 48) pad = (int)ceil(fontsize * 0.25);
+    cairo_t *cm = cairo_create(mask);
+    if (!cm || cairo_status(cm) != CAIRO_STATUS_SUCCESS) {
+        if (cm) cairo_destroy(cm);
+        cairo_surface_destroy(mask);
+        return -1;
+    }
+    cairo_set_antialias(cm, CAIRO_ANTIALIAS_BEST);
+    cairo_scale(cm, (double)ss, (double)ss);
+    cairo_font_options_t *fopt = make_render_font_options(ss);
+    cairo_set_font_options(cm, fopt);
+    cairo_font_options_destroy(fopt);
+    cairo_translate(cm, (double)pad, (double)pad);
+    cairo_set_source_rgba(cm, 0, 0, 0, 1);
+    pango_cairo_show_layout(cm, layout_real);
+    cairo_destroy(cm);
+    cairo_surface_flush(mask);
+    cairo_surface_flush(surface_ss);
+
+    int shift = (int)lround(shadow_off * ss);
+    int rc = coverage_effects_compose(cairo_image_surface_get_data(mask),
+                                      cairo_image_surface_get_stride(mask), ss_w, ss_h,
+                                      stroke_w / 2.0 * ss, shift, shift,
+                                      rgba_to_argb(fill), rgba_to_argb(outline),
+                                      draw_shadow ? rgba_to_argb(shadow) : 0,
+                                      cairo_image_surface_get_data(surface_ss),
+                                      cairo_image_surface_get_stride(surface_ss));
+    cairo_surface_destroy(mask);
+    if (rc == 0)
+        cairo_surface_mark_dirty(surface_ss);
+    return rc;
+}
+
+/*
+ * render_layout_supersampled
+ * --------------------------
+ * Cairo path: draw shadow, outline and fill of `layout_real` into an
+ * `ss`x supersampled surface (with Cairo, or from one fill mask when
+ * `morph` is set), smooth it and downscale into a new
+ * (lw+2*pad) x (lh+2*pad) ARGB32 surface. Colours are straight RGBA in
+ * [0,1]. Returns the 1x surface (caller destroys it) or NULL on failure.
+ */
+static cairo_surface_t *render_layout_supersampled(PangoLayout *layout_real,
+                                                   int lw, int lh, int pad, int ss, int disp_h,
+                                                   double stroke_w, double shadow_off, int morph,
+                                                   int draw_shadow,
+                                                   const double fill[4], const double outline[4],
+                                                   const double shadow[4])
+{
+    cairo_surface_t *surface_ss = NULL;
+    cairo_t *cr = NULL;
+    cairo_surface_t *surface = NULL;
+    int w = lw+2*pad;
+    int h = lh+2*pad;
     int ss_w = (lw + 2*pad) * ss;
     int ss_h = (lh + 2*pad) * ss;
     surface_ss = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ss_w, ss_h);
     if (!surface_ss || cairo_surface_status(surface_ss) != CAIRO_STATUS_SUCCESS) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+        goto fail;
     }
     cr = cairo_create(surface_ss);
     if (!cr || cairo_status(cr) != CAIRO_STATUS_SUCCESS) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+        goto fail;
     }
     cairo_set_antialias(cr, CAIRO_ANTIALIAS_BEST);
     cairo_scale(cr, (double)ss, (double)ss);  /* draw at larger resolution then downscale */
-
-    ctx_real = pango_font_map_create_context(thread_fm);
-    if (!ctx_real) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
-    }
-    /* For HD/UHD with stronger supersampling we prefer to disable
-     * hinting/metrics so glyph shapes remain smooth and rely on SSAA
-     * for crisp edges. Apply cairo font options to both Cairo and Pango
-     * contexts when ss is high. */
-    cairo_font_options_t *fopt = cairo_font_options_create();
-    if (ss >= 3) {
-        cairo_font_options_set_hint_style(fopt, CAIRO_HINT_STYLE_NONE);
-        cairo_font_options_set_hint_metrics(fopt, CAIRO_HINT_METRICS_OFF);
-    } else {
-        cairo_font_options_set_hint_style(fopt, CAIRO_HINT_STYLE_FULL);
-        cairo_font_options_set_hint_metrics(fopt, CAIRO_HINT_METRICS_DEFAULT);
-    }
-    pango_cairo_context_set_font_options(ctx_real, fopt);
+    cairo_font_options_t *fopt = make_render_font_options(ss);
     cairo_set_font_options(cr, fopt);
     cairo_font_options_destroy(fopt);
-    layout_real = pango_layout_new(ctx_real);
-    if (!layout_real) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
-    }
-    pango_layout_set_font_description(layout_real, desc);
-    pango_layout_set_width(layout_real, layout_width_for_real * PANGO_SCALE);
-    pango_layout_set_wrap(layout_real, PANGO_WRAP_WORD_CHAR);
-    pango_layout_set_alignment(layout_real, text_alignment);
-    pango_layout_set_markup(layout_real, final_markup, -1);
-
-    double fr,fg,fb,fa, or_,og,ob,oa, sr,sg,sb,sa;
-    parse_hex_color(fgcolor, &fr,&fg,&fb,&fa);
-    parse_hex_color(outlinecolor, &or_,&og,&ob,&oa);
-    parse_hex_color(shadowcolor, &sr,&sg,&sb,&sa);
 
     /* Translate to center text within the padded bounding box */
     cairo_translate(cr, (double)pad, (double)pad);
 
-    // Shadow first: make the offset proportional to supersample / fontsize
-    if (shadowcolor) {
-        /* Compute shadow offset in user-space units; a prior change
-         * multiplied by `ss` here which double-applied the earlier
-         * cairo_scale() and produced an overly large shadow translate.
-         * Keep a small minimum of 1.0 user unit so very small fonts
-         * still get a visible shadow. The CTM (scale) already maps
-         * this to device pixels. */
-        double shadow_off = (fontsize * 0.04);
-        if (shadow_off < 1.0) shadow_off = 1.0; /* at least 1 user unit */
+    if (morph && draw_effects_morph(layout_real, surface_ss, ss, pad, stroke_w, shadow_off,
+                                    draw_shadow, fill, outline, shadow) == 0)
+        goto drawn;
+
+    // Shadow first, offset by effect_geometry()'s user-space distance
+    if (draw_shadow) {
         cairo_save(cr);
         cairo_translate(cr, shadow_off, shadow_off);
-        cairo_set_source_rgba(cr, sr, sg, sb, sa);
+        cairo_set_source_rgba(cr, shadow[0], shadow[1], shadow[2], shadow[3]);
         pango_cairo_show_layout(cr, layout_real);
         cairo_restore(cr);
-    }
-
-    // Outline: stroke path. Make stroke width proportional to fontsize so
-    // it scales better across SD/HD; shrink slightly for high supersample
-    // so outlines don't become visually too thick when downsampled.
-    cairo_save(cr);
-    /* Make stroke width proportional to fontsize, but scale it down slightly
-     * for higher SSAA so strokes don't appear overly thick after downsampling. */
-    double stroke_w = 0.4 + (fontsize * 0.018);
-    /* For very large displays we thin the stroke a bit when SSAA is high
-     * to avoid overly chunky outlines after downsampling. For SD we keep
-     * the stroke thicker to prevent small glyph features from being eaten. */
-    if (ss >= 4 && disp_h > 576) stroke_w *= 0.70; /* thinner at 4x for HD/UHD */
+    }
+
+    // Outline: stroke path (width from effect_geometry())
+    cairo_save(cr);
     cairo_set_line_width(cr, stroke_w);
     cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
     pango_cairo_layout_path(cr, layout_real);
-    cairo_set_source_rgba(cr, or_, og, ob, oa);
+    cairo_set_source_rgba(cr, outline[0], outline[1], outline[2], outline[3]);
     cairo_stroke(cr);
     cairo_restore(cr);
 
     // Foreground fill
     cairo_save(cr);
-    cairo_set_source_rgba(cr, fr, fg, fb, fa);
+    cairo_set_source_rgba(cr, fill[0], fill[1], fill[2], fill[3]);
     pango_cairo_show_layout(cr, layout_real);
     cairo_restore(cr);
 
+drawn:
     /* --- Downscale to target surface (1×) ---
      * Optionally apply a mild separable blur on the supersampled surface to
      * reduce remaining high-frequency aliasing before downsampling. For
@@ -1080,10 +1262,7 @@ Bitmap render_text_pango(const char *markup,
         if (disp_h <= 1080) {
             unsigned char *ss_data_ls = cairo_image_surface_get_data(surface_ss);
             if (!ss_data_ls) {
-                cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                        desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                        layout_real, ctx_real, cr, surface_ss, surface);
-                return bm;
+                goto fail;
             }
             int ss_stride_ls = cairo_image_surface_get_stride(surface_ss);
             int sw_ls = ss_w, sh_ls = ss_h;
@@ -1172,10 +1351,7 @@ Bitmap render_text_pango(const char *markup,
         }
     unsigned char *ss_data = cairo_image_surface_get_data(surface_ss);
     if (!ss_data) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+        goto fail;
     }
     int ss_stride = cairo_image_surface_get_stride(surface_ss);
         int sw = ss_w, sh = ss_h;
@@ -1288,14 +1464,9 @@ Bitmap render_text_pango(const char *markup,
             cairo_surface_mark_dirty(surface_ss);
         }
     }
-    int w = lw+2*pad;
-    int h = lh+2*pad;
     surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
     if (!surface || cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
-        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
-                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
-        return bm;
+        goto fail;
     }
     
     /* Composite the downsampled text without background fill */
@@ -1311,11 +1482,285 @@ Bitmap render_text_pango(const char *markup,
         if (cr_down) cairo_destroy(cr_down);
     }
 
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface_ss);
+    return surface;
+
+fail:
+    if (cr) cairo_destroy(cr);
+    if (surface_ss) cairo_surface_destroy(surface_ss);
+    if (surface) cairo_surface_destroy(surface);
+    return NULL;
+}
+
+/*
+ * render_text_pango
+ * -----------------
+ * Render the provided Pango markup into an indexed Bitmap suitable for
+ * the DVB/AVSubtitle pipeline. High-level steps:
+ *  1. Resolve font size (adaptive if fontsize<=0).
+ *  2. Create a supersampled Cairo surface and render the Pango layout at
+ *     higher resolution to improve edge quality.
+ *  3. Optionally blur/sharpen the supersampled surface and downsample.
+ *  4. Convert ARGB pixels to indexed palette using error-diffusion
+ *     dithering plus cleanup passes to remove speckles and short runs.
+ *
+ * The returned Bitmap contains allocated `idxbuf` and `palette` which
+ * the caller must free when no longer needed.
+ */
+Bitmap render_text_pango(const char *markup,
+                          int disp_w, int disp_h,
+                          int fontsize, const char *fontfam,
+                          const char *fontstyle,
+                          const char *fgcolor,
+                          const char *outlinecolor,
+                          const char *shadowcolor,
+                          const char *bgcolor,
+                          SubtitlePositionConfig *pos_config,
+                          const char *palette_mode) {
+    Bitmap bm={0};
+    
+    LOG(3, "DEBUG render_text_pango: bgcolor=%s\n", bgcolor ? bgcolor : "(null)");
+
+    /* Local resource pointers: initialize to NULL so cleanup is safe on any
+     * early-failure path. */
+    PangoFontMap *thread_fm = NULL;
+    PangoFontDescription *desc = NULL;
+    PangoContext *ctx_dummy = NULL;
+    PangoLayout *layout_dummy = NULL;
+    cairo_surface_t *dummy = NULL;
+    cairo_t *cr_dummy = NULL;
+    PangoContext *ctx_real = NULL;
+    PangoLayout *layout_real = NULL;
+    cairo_surface_t *surface = NULL;
+
+    /* Ensure we have a single process-wide PangoFontMap to avoid creating
+     * multiple internal fontconfig allocations across repeated renders.
+     * We create contexts from this map per-render and unref them. */
+    /* Ensure a per-thread fontmap exists (created on first use). */
+    thread_fm = get_thread_pango_fontmap();
+    if (!thread_fm) return bm; /* can't proceed without a fontmap */
+
+    /* Defensive: refuse to attempt rendering for absurd display sizes that
+     * are almost certainly a caller error or test of failure paths. This
+     * avoids creating huge Cairo surfaces or layouts when disp_w/h are
+     * unreasonably large (e.g., user-provided test harness values). */
+    if ((size_t)disp_w > RENDER_PANGO_SAFE_MAX_DIM || (size_t)disp_h > RENDER_PANGO_SAFE_MAX_DIM) {
+        /* return empty bitmap (idxbuf==NULL) to indicate we couldn't allocate */
+        return bm;
+    }
+
+    LOG(2, "render_text_pango: Input fontfam='%s' fontstyle='%s' fontsize=%d disp_h=%d\n",
+        fontfam ? fontfam : "(null)", fontstyle ? fontstyle : "(null)", fontsize, disp_h);
+    
+    fontsize = resolve_fontsize(fontsize, disp_h);
+
+    /* Create common font description */
+    const char *base_family = (fontfam && *fontfam) ? fontfam : "Open Sans";
+    desc = make_font_description(fontfam, fontstyle, fontsize);
+    if (!desc) {
+        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
+                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
+                                layout_real, ctx_real, surface);
+        return bm;
+    }
+    
+    LOG(2, "render_text_pango: Resolved font='%s' style='%s' size=%d (base_family resolved to '%s')\n",
+        base_family, (fontstyle && *fontstyle) ? fontstyle : "(default)", fontsize, base_family);
+
+    /* The markup is used as given: {\an<digit>} overrides are resolved by
+     * the parser (SRTEntry.alignment) and arrive through pos_config. */
+    const char *final_markup = markup ? markup : "";
+    const int has_inline_foreground = (strstr(final_markup, "foreground=\"") != NULL);
+
+    /* --- Dummy layout for measurement --- */
+    dummy = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+    if (!dummy || cairo_surface_status(dummy) != CAIRO_STATUS_SUCCESS) {
+        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
+                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
+                                layout_real, ctx_real, surface);
+        return bm;
+    }
+    cr_dummy = cairo_create(dummy);
+    if (!cr_dummy || cairo_status(cr_dummy) != CAIRO_STATUS_SUCCESS) {
+        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
+                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
+                                layout_real, ctx_real, surface);
+        return bm;
+    }
+    ctx_dummy = pango_font_map_create_context(thread_fm);
+    if (!ctx_dummy) {
+        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
+                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
+                                layout_real, ctx_real, surface);
+        return bm;
+    }
+    
+    /* Apply same font options to dummy context for consistent measurement */
+    cairo_font_options_t *fopt_dummy = make_measure_font_options(disp_h);
+    pango_cairo_context_set_font_options(ctx_dummy, fopt_dummy);
+    cairo_set_font_options(cr_dummy, fopt_dummy);
+    cairo_font_options_destroy(fopt_dummy);
+    
+    layout_dummy = pango_layout_new(ctx_dummy);
+    if (!layout_dummy) {
+        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
+                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
+                                layout_real, ctx_real, surface);
+        return bm;
+    }
+    pango_layout_set_font_description(layout_dummy, desc);
+    /* Pre-broken cues keep their lines; the full-frame width only catches
+     * a single word too wide to display. */
+    const int prebroken = atomic_load(&dbg_prebroken);
+    pango_layout_set_width(layout_dummy, disp_w * (prebroken ? 1.0 : 0.8) * PANGO_SCALE);
+    pango_layout_set_wrap(layout_dummy, PANGO_WRAP_WORD_CHAR);
+    /* Alignment will be set after final_config is determined (see below) */
+    pango_layout_set_markup(layout_dummy, final_markup, -1);
+
+    int lw, lh;
+
+    pango_layout_get_pixel_size(layout_dummy, &lw, &lh);
+    
+    /* Platform-specific line height adjustment
+     * macOS Pango/Cairo font metrics differ from Linux, resulting in different line heights.
+     * Apply a correction factor to normalize rendering across platforms. */
+    #ifdef __APPLE__
+        /* macOS tends to report larger line heights; scale down slightly for consistency */
+        lh = (int)(lh * 0.95);
+    #endif
+    
+    /* For centered text, create a layout with width matching the actual text width
+     * so center alignment works properly without extra padding on the sides */
+    int layout_width_for_real = lw;
+
+    /* --- Placement in full frame ---
+     * Use 9-position grid positioning from config. Default to bottom-center if no config provided.
+     */
+    SubtitlePositionConfig default_config = {
+        .position = SUB_POS_BOT_CENTER,
+        .margin_top = 3.5,
+        .margin_left = 3.5,
+        .margin_bottom = 3.5,
+        .margin_right = 3.5
+    };
+    
+    SubtitlePositionConfig *final_config = pos_config ? pos_config : &default_config;
+
+    /* Determine text alignment within bounding box based on horizontal position */
+    PangoAlignment text_alignment = PANGO_ALIGN_CENTER;
+    switch (final_config->position) {
+        case SUB_POS_TOP_LEFT:
+        case SUB_POS_MID_LEFT:
+        case SUB_POS_BOT_LEFT:
+            text_alignment = PANGO_ALIGN_LEFT;
+            break;
+        case SUB_POS_TOP_RIGHT:
+        case SUB_POS_MID_RIGHT:
+        case SUB_POS_BOT_RIGHT:
+            text_alignment = PANGO_ALIGN_RIGHT;
+            break;
+        case SUB_POS_TOP_CENTER:
+        case SUB_POS_MID_CENTER:
+        case SUB_POS_BOT_CENTER:
+        default:
+            text_alignment = PANGO_ALIGN_CENTER;
+            break;
+    }
+    
+    /* Now apply alignment to layout_dummy (was deferred earlier) */
+    pango_layout_set_alignment(layout_dummy, text_alignment);
+
+    /* --- Adaptive supersampled rendering surface ---
+     * Choose supersample factor based on display height.
+     * SD gets a higher SSAA to avoid blockiness. For HD/UHD we also
+     * increase SSAA to keep glyph edges smooth at larger sizes.
+     * These choices balance quality vs CPU/memory; users can override
+     * with the ssaa_override runtime knob. */
+    int ss;
+    if (disp_h <= 576) {
+    ss = 2; /* SD: increase supersample to further reduce blockiness on low res */
+    } else if (disp_h <= 1080) {
+    ss = 3; /* HD: bump to 3x to improve edge fidelity compared to previous 2x */
+    } else if (disp_h <= 2160) {
+    ss = 4; /* 4k/2160p target: use 4x for best quality on UHD */
+    } else {
+    ss = 4; /* very large displays: cap at 4x */
+    }
+    if (atomic_load(&dbg_ssaa_override) > 0) ss = atomic_load(&dbg_ssaa_override);
+    /* pad to accommodate strokes when upscaled; scale with fontsize so
+     * UHD/large text get enough room and strokes don't clip. */
+    int pad = 8;
+    if (fontsize > 48) pad = (int)ceil(fontsize * 0.25);
+    ctx_real = pango_font_map_create_context(thread_fm);
+    if (!ctx_real) {
+        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
+                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
+                                layout_real, ctx_real, surface);
+        return bm;
+    }
+    /* For HD/UHD with stronger supersampling we prefer to disable
+     * hinting/metrics so glyph shapes remain smooth and rely on SSAA
+     * for crisp edges. Apply cairo font options to both Cairo and Pango
+     * contexts when ss is high. */
+    cairo_font_options_t *fopt = make_render_font_options(ss);
+    pango_cairo_context_set_font_options(ctx_real, fopt);
+    cairo_font_options_destroy(fopt);
+    layout_real = pango_layout_new(ctx_real);
+    if (!layout_real) {
+        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
+                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
+                                layout_real, ctx_real, surface);
+        return bm;
+    }
+    pango_layout_set_font_description(layout_real, desc);
+    if (prebroken && !pango_layout_is_wrapped(layout_dummy))
+        pango_layout_set_width(layout_real, -1); /* measured lines, no re-wrap */
+    else
+        pango_layout_set_width(layout_real, layout_width_for_real * PANGO_SCALE);
+    pango_layout_set_wrap(layout_real, PANGO_WRAP_WORD_CHAR);
+    pango_layout_set_alignment(layout_real, text_alignment);
+    pango_layout_set_markup(layout_real, final_markup, -1);
+
+    double fr,fg,fb,fa, or_,og,ob,oa, sr,sg,sb,sa;
+    parse_hex_color(fgcolor, &fr,&fg,&fb,&fa);
+    parse_hex_color(outlinecolor, &or_,&og,&ob,&oa);
+    parse_hex_color(shadowcolor, &sr,&sg,&sb,&sa);
+
+    const double fill_rgba[4] = {fr, fg, fb, fa};
+    const double outline_rgba[4] = {or_, og, ob, oa};
+    const double shadow_rgba[4] = {sr, sg, sb, sa};
+    double stroke_w, shadow_off;
+    effect_geometry(fontsize, ss, disp_h, &stroke_w, &shadow_off);
+    int morph = effects_use_morph(disp_h);
+    int w = lw+2*pad;
+    int h = lh+2*pad;
+
+    /* With --glyph-atlas, plain (or italic-only) cues are composited from
+     * cached glyph tiles; other markup, or a cue the atlas cannot handle,
+     * takes the full Cairo path. */
+    if (atomic_load(&dbg_glyph_atlas) && markup_is_atlas_eligible(final_markup)) {
+        surface = render_layout_atlas(layout_real, w, h, pad, ss, stroke_w, shadow_off, morph,
+                                      shadowcolor != NULL, fill_rgba, outline_rgba, shadow_rgba);
+        if (surface)
+            bench_inc_cues_fast_path();
+    }
+    if (!surface)
+        surface = render_layout_supersampled(layout_real, lw, lh, pad, ss, disp_h,
+                                             stroke_w, shadow_off, morph, shadowcolor != NULL,
+                                             fill_rgba, outline_rgba, shadow_rgba);
+    if (!surface) {
+        cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
+                                desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
+                                layout_real, ctx_real, surface);
+        return bm;
+    }
+
     unsigned char *data = cairo_image_surface_get_data(surface);
     if (!data) {
         cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
                                 desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
+                                layout_real, ctx_real, surface);
         return bm;
     }
 
@@ -1584,7 +2029,7 @@ Bitmap render_text_pango(const char *markup,
         /* skip heavy allocation and return an empty bitmap */
         cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
                                 desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                                layout_real, ctx_real, cr, surface_ss, surface);
+                                layout_real, ctx_real, surface);
         return bm;
     }
 
@@ -1633,7 +2078,7 @@ Bitmap render_text_pango(const char *markup,
     free_bitmap_buffers(&bm);
     cleanup_render_resources(false, &bm, 0, 0, 0, 0, NULL,
                             desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                            layout_real, ctx_real, cr, surface_ss, surface);
+                            layout_real, ctx_real, surface);
     return bm;
     }
 
@@ -2014,15 +2459,90 @@ Bitmap render_text_pango(const char *markup,
     /* Mark successful completion and cleanup all resources */
     cleanup_render_resources(true, &bm, w, h, disp_w, disp_h, final_config,
                             desc, layout_dummy, ctx_dummy, cr_dummy, dummy,
-                            layout_real, ctx_real, cr, surface_ss, surface);
-    
-    /* Free ASS alignment config if it was allocated, and the markup copy */
-    if (ass_config) free(ass_config);
-    free(markup_copy);
+                            layout_real, ctx_real, surface);
     
     return bm;
 }
 
+/* Measuring state behind render_pango_line_breaker_create(): one layout
+ * per LINE_BREAK_* style combination. */
+typedef struct {
+    PangoContext *ctx;
+    PangoLayout *layout[LINE_BREAK_STYLES];
+} PangoMeasure;
+
+static void pango_measure_free(void *user)
+{
+    PangoMeasure *m = user;
+    if (!m) return;
+    for (int i = 0; i < LINE_BREAK_STYLES; i++)
+        if (m->layout[i]) g_object_unref(m->layout[i]);
+    if (m->ctx) g_object_unref(m->ctx);
+    free(m);
+}
+
+/* LineAdvanceFn: logical width of one character, in Pango units. */
+static int32_t pango_measure_advance(void *user, uint32_t cp, int style)
+{
+    PangoMeasure *m = user;
+    char utf8[8];
+    int n = g_unichar_to_utf8((gunichar)cp, utf8);
+    PangoRectangle logical;
+    pango_layout_set_text(m->layout[style], utf8, n);
+    pango_layout_get_extents(m->layout[style], NULL, &logical);
+    return logical.width;
+}
+
+LineBreaker *render_pango_line_breaker_create(const char *fontfam, const char *fontstyle,
+                                              int fontsize, int disp_w, int disp_h)
+{
+    if (disp_w <= 0 || disp_h <= 0 ||
+        (size_t)disp_w > RENDER_PANGO_SAFE_MAX_DIM || (size_t)disp_h > RENDER_PANGO_SAFE_MAX_DIM)
+        return NULL;
+    PangoFontMap *fm = get_thread_pango_fontmap();
+    if (!fm) return NULL;
+
+    fontsize = resolve_fontsize(fontsize, disp_h);
+    PangoFontDescription *desc = make_font_description(fontfam, fontstyle, fontsize);
+    if (!desc) return NULL;
+
+    PangoMeasure *m = calloc(1, sizeof(*m));
+    if (!m) {
+        pango_font_description_free(desc);
+        return NULL;
+    }
+    m->ctx = pango_font_map_create_context(fm);
+    if (!m->ctx) goto fail;
+    /* same options as the measurement layout in render_text_pango() */
+    cairo_font_options_t *fopt = make_measure_font_options(disp_h);
+    pango_cairo_context_set_font_options(m->ctx, fopt);
+    cairo_font_options_destroy(fopt);
+
+    for (int st = 0; st < LINE_BREAK_STYLES; st++) {
+        PangoFontDescription *d = pango_font_description_copy(desc);
+        if (!d) goto fail;
+        if (st & LINE_BREAK_ITALIC) pango_font_description_set_style(d, PANGO_STYLE_ITALIC);
+        if (st & LINE_BREAK_BOLD) pango_font_description_set_weight(d, PANGO_WEIGHT_BOLD);
+        m->layout[st] = pango_layout_new(m->ctx);
+        if (m->layout[st]) pango_layout_set_font_description(m->layout[st], d);
+        pango_font_description_free(d);
+        if (!m->layout[st]) goto fail;
+    }
+    pango_font_description_free(desc);
+
+    /* 80% wrap width of the renderer, less 3% for kerning and shaping that
+     * per-character advances do not see. */
+    int32_t max_width = (int32_t)(disp_w * 0.8 * 0.97 * PANGO_SCALE);
+    LineBreaker *lb = line_breaker_create(pango_measure_advance, m, pango_measure_free, max_width);
+    if (!lb) pango_measure_free(m);
+    return lb;
+
+fail:
+    pango_font_description_free(desc);
+    pango_measure_free(m);
+    return NULL;
+}
+
 void parse_hex_color(const char *hex, double *r, double *g, double *b, double *a) {
     /*
      * Parses hex color strings in two formats:
@@ -53,6 +53,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "runtime_opts.h"
+#include "line_break.h"
 
 /**
  * @file render_pango.h
@@ -168,6 +169,42 @@ void render_pango_set_ssaa_override(int ssaa);
  */
 void render_pango_set_no_unsharp(int no_unsharp);
 
+/**
+ * Enable the glyph-atlas fast path when non-zero: plain and italic-only
+ * cues are composited from cached glyph tiles. Off by default, because
+ * the tiles skip the supersampled path's blur passes and so are close to,
+ * but not identical with, the Cairo output.
+ */
+void render_pango_set_glyph_atlas(int glyph_atlas);
+
+/**
+ * Select the shadow/outline pipeline (a RenderEffectsMode from
+ * coverage_effects.h): Cairo drawing, morphological derivation from the
+ * fill mask, or auto (morphological for HD/UHD only).
+ */
+void render_pango_set_effects_mode(int mode);
+
+/**
+ * Tell the renderer that cue text was already wrapped at parse time by a
+ * breaker from render_pango_line_breaker_create(). Layouts then keep the
+ * given lines and only wrap a line that is wider than the whole frame.
+ */
+void render_pango_set_prebroken(int prebroken);
+
+/**
+ * Create a LineBreaker that measures with the font render_text_pango()
+ * would use for the same family, style, size and display (fontsize <= 0
+ * selects the adaptive size). The target width is the renderer's 80%
+ * wrap width less a small margin for kerning and shaping.
+ *
+ * Advances are measured in the calling thread; destroy the breaker with
+ * line_breaker_destroy() in the same thread.
+ *
+ * @return New breaker, or NULL if the font could not be set up.
+ */
+LineBreaker *render_pango_line_breaker_create(const char *fontfam, const char *fontstyle,
+                                              int fontsize, int disp_w, int disp_h);
+
 /**
  * Validate and resolve font family and style.
  *
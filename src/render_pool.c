@@ -51,6 +51,7 @@
 #include "render_pango.h"
 #include "utils.h"
 #include "bench.h"
+#include "debug.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -83,7 +84,7 @@
  * This section documents the internal concurrency rules the module
  * relies on. Keep these in mind when changing the implementation.
  *
- * 1) Global list/queue lock (`job_mtx`)
+ * 1) Per-pool list/queue lock (`job_mtx`, one per RenderPool instance)
  *    - Protects: `job_head`, `job_tail`, `all_jobs` and the linked-list
  *      structure that connects RenderJob containers. Any modification
  *      (add/remove) to those lists must be done while holding `job_mtx`.
@@ -146,12 +147,15 @@
  * RenderJob
  * ---------
  * Represents a single rendering task submitted to the pool. Fields:
- *  - markup: duplicated UTF-8 Pango markup string owned by the job.
+ *  - markup: UTF-8 Pango markup string.
  *  - disp_w/disp_h: target display dimensions.
- *  - fontsize/fontfam: font controls (strings duplicated and owned).
- *  - fgcolor/outlinecolor/shadowcolor: color strings (duplicated).
+ *  - fontsize/fontfam: font controls.
+ *  - fgcolor/outlinecolor/shadowcolor: color strings.
  *  - align_code: alignment hint forwarded to renderer.
- *  - palette_mode: textual palette hint (duplicated).
+ *  - palette_mode: textual palette hint.
+ *  - strings: single block holding copies of all of the above strings for
+ *            the copying entry points, NULL when they are borrowed from
+ *            the caller (render_pool_ctx_submit_ref and synchronous jobs).
  *  - result: Bitmap produced by render_text_pango(); ownership is
  *            transferred to the caller when the job is retrieved. The
  *            pool frees these buffers with av_free() when discarding jobs.
@@ -161,26 +165,36 @@
  *  - queue_next: pointer used for the FIFO worker queue (protected by job_mtx).
  *  - all_next: pointer used for the keyed all_jobs list (protected by job_mtx).
  *  - track_id / cue_index: integer key identifying the job for lookup.
+ *  - encode / duration_ms: when set, the worker also runs the pool's
+ *            encode hook on the result and stores the bytes in `payload`
+ *            (av_malloc'd, ownership transferred with the Bitmap).
  *
  * Concurrency/ownership notes:
- *  - The pool duplicates all input strings; callers may free their
- *    originals immediately after submission.
+ *  - render_pool_ctx_submit_async/_encoded copy all input strings, so
+ *    callers may free their originals immediately after submission.
+ *    render_pool_ctx_submit_ref borrows them: they must outlive the job.
  *  - The worker writes the `result` and sets `done` while holding the
  *    per-job done_mtx; callers waiting on that job read under the same
  *    mutex/cond pair.
  */
 typedef struct RenderJob {
-    char *markup;
+    const char *markup;
     int disp_w, disp_h;
     int fontsize;
-    char *fontfam;
-    char *fontstyle;
-    char *fgcolor, *outlinecolor, *shadowcolor, *bgcolor;
+    const char *fontfam;
+    const char *fontstyle;
+    const char *fgcolor, *outlinecolor, *shadowcolor, *bgcolor;
     int align_code;
     double sub_position_pct;
-    char *palette_mode;
+    const char *palette_mode;
+    char *strings;
     SubtitlePositionConfig pos_config;  /* positioning config (position + margins) */
     Bitmap result;
+    int encode;
+    int64_t duration_ms;
+    RenderPayload payload;
+    int64_t t_queued;   /* bench_now() at submission */
+    RenderJobTiming timing; /* filled by the worker with the result */
     atomic_int done;
     pthread_cond_t done_cond;
     pthread_mutex_t done_mtx;
@@ -197,8 +211,47 @@ typedef struct RenderJob {
     atomic_int waiters;  /* number of threads waiting on this job (sync callers) */
 } RenderJob;
 
-/* For async support we keep jobs in a simple linked list keyed by track+cue */
-static RenderJob *all_jobs = NULL; /* head of all submitted jobs */
+/*
+ * RenderPool
+ * ----------
+ * All queue state for one pool instance. The legacy render_pool_* API
+ * operates on a single process-wide `default_pool`; engine contexts
+ * (see srt2dvbsub_engine.h) create private instances through
+ * render_pool_create() so several encodes can run in one process
+ * without sharing queues, workers or bench counters.
+ *
+ *  - all_jobs:   keyed list of async jobs (track+cue), protected by job_mtx.
+ *  - job_head/job_tail: FIFO worker queue, protected by job_mtx.
+ *  - running:    worker loop flag, updated under job_mtx.
+ *  - pool_active: atomic "accepting submissions" flag.
+ *  - bench:      accumulator for render timings (NULL = global `bench`).
+ *  - encode_fn/encode_release/encode_opaque: optional post-render encode
+ *                hook, read by workers under job_mtx.
+ */
+struct RenderPool {
+    RenderJob *all_jobs; /* head of all submitted jobs */
+    RenderJob *job_head;
+    RenderJob *job_tail;
+    pthread_mutex_t job_mtx;
+    pthread_cond_t job_cond;
+    pthread_t *workers;
+    int worker_count;
+    int running;
+    /* pool_active == 1 when the pool is ready to accept jobs. Use atomics
+     * for quick checks without taking job_mtx. */
+    atomic_int pool_active;
+    BenchStats *bench;
+    int heap_allocated; /* non-zero when created via render_pool_create() */
+    RenderEncodeFn encode_fn;
+    RenderEncodeReleaseFn encode_release;
+    void *encode_opaque;
+};
+
+/* Process-wide pool backing the legacy render_pool_* entry points. */
+static RenderPool default_pool = {
+    .job_mtx = PTHREAD_MUTEX_INITIALIZER,
+    .job_cond = PTHREAD_COND_INITIALIZER,
+};
 
 /*
  * find_job
@@ -210,10 +263,8 @@ static RenderJob *all_jobs = NULL; /* head of all submitted jobs */
  *
  * @return pointer to RenderJob or NULL if not found.
  */
-/* keep helper available for future use; silence unused warning on some compilers */
-static RenderJob *find_job(int track_id, int cue_index) __attribute__((unused));
-static RenderJob *find_job(int track_id, int cue_index) {
-    RenderJob *j = all_jobs;
+static RenderJob *find_job(RenderPool *pool, int track_id, int cue_index) {
+    RenderJob *j = pool->all_jobs;
     while (j) {
         if (j->track_id == track_id && j->cue_index == cue_index) return j;
         j = j->all_next;
@@ -221,24 +272,13 @@ static RenderJob *find_job(int track_id, int cue_index) {
     return NULL;
 }
 
-static RenderJob *job_head = NULL;
-static RenderJob *job_tail = NULL;
-static pthread_mutex_t job_mtx = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t job_cond = PTHREAD_COND_INITIALIZER;
-static pthread_t *workers = NULL;
-static int worker_count = 0;
-static int running = 0;
-/* pool_active == 1 when the pool is ready to accept jobs. Use atomics
- * for quick checks without taking job_mtx. */
-static atomic_int pool_active;
-
 /* Helper: remove a job from the all_jobs list.
  * MUST be called with job_mtx held. If the job is not found this is a no-op. */
-static void remove_from_all_jobs_locked(RenderJob *target) {
-    RenderJob *prev = NULL, *cur = all_jobs;
+static void remove_from_all_jobs_locked(RenderPool *pool, RenderJob *target) {
+    RenderJob *prev = NULL, *cur = pool->all_jobs;
     while (cur) {
         if (cur == target) {
-            if (prev) prev->all_next = cur->all_next; else all_jobs = cur->all_next;
+            if (prev) prev->all_next = cur->all_next; else pool->all_jobs = cur->all_next;
             return;
         }
         prev = cur; cur = cur->all_next;
@@ -250,16 +290,10 @@ static void remove_from_all_jobs_locked(RenderJob *target) {
  * some initialization steps failed; checks init flags before destroying. */
 static void cleanup_job_container(RenderJob *j, int free_container) {
     if (!j) return;
-    if (j->markup) free(j->markup);
-    if (j->fontfam) free(j->fontfam);
-    if (j->fontstyle) free(j->fontstyle);
-    if (j->fgcolor) free(j->fgcolor);
-    if (j->outlinecolor) free(j->outlinecolor);
-    if (j->shadowcolor) free(j->shadowcolor);
-    if (j->bgcolor) free(j->bgcolor);
-    if (j->palette_mode) free(j->palette_mode);
+    free(j->strings);
     if (j->result.idxbuf) av_free(j->result.idxbuf);
     if (j->result.palette) av_free(j->result.palette);
+    if (j->payload.data) av_free(j->payload.data);
     if (j->done_cond_init) pthread_cond_destroy(&j->done_cond);
     if (j->done_mtx_init) pthread_mutex_destroy(&j->done_mtx);
     if (free_container) free(j);
@@ -274,10 +308,31 @@ static void steal_job_result(RenderJob *j, Bitmap *out) {
     j->result.palette = NULL;
 }
 
-/* Helper: initialize all string fields of a RenderJob. Duplicates all
- * input strings (or NULL for optional fields) and validates allocations.
- * On success returns 0. On failure cleans up partial allocations and returns -1.
- * Caller must NOT call cleanup_job_container on failure; this helper handles it. */
+/* Helper: move the encoded payload out of the container. With a NULL
+ * `out` the payload stays in the container and cleanup frees it. */
+static void steal_job_payload(RenderJob *j, RenderPayload *out) {
+    if (!j || !out) return;
+    *out = j->payload;
+    j->payload.data = NULL;
+    j->payload.size = 0;
+}
+
+/* Helper: copy `src` into the job's string block at `*cursor` (NULL stays
+ * NULL). */
+static const char *put_job_string(char **cursor, const char *src) {
+    if (!src) return NULL;
+    size_t n = strlen(src) + 1;
+    char *dst = *cursor;
+    memcpy(dst, src, n);
+    *cursor += n;
+    return dst;
+}
+
+/* Helper: initialize all string fields of a RenderJob. With `borrow` set
+ * the caller's pointers are stored as-is (markup NULL becomes ""), so
+ * they must stay valid until the job is retrieved or freed. Otherwise all
+ * strings are copied into one allocation owned by the job. On success
+ * returns 0. On failure returns -1; the caller cleans up the container. */
 static int init_job_strings(RenderJob *job, 
                            const char *markup,
                            const char *fontfam,
@@ -286,72 +341,99 @@ static int init_job_strings(RenderJob *job,
                            const char *outlinecolor,
                            const char *shadowcolor,
                            const char *bgcolor,
-                           const char *palette_mode)
+                           const char *palette_mode,
+                           int borrow)
 {
     if (!job) return -1;
-    
-    /* Duplicate all strings; markup is mandatory (use empty string if NULL) */
-    job->markup = strdup(markup ? markup : "");
-    job->fontfam = fontfam ? strdup(fontfam) : NULL;
-    job->fontstyle = fontstyle ? strdup(fontstyle) : NULL;
-    job->fgcolor = fgcolor ? strdup(fgcolor) : NULL;
-    job->outlinecolor = outlinecolor ? strdup(outlinecolor) : NULL;
-    job->shadowcolor = shadowcolor ? strdup(shadowcolor) : NULL;
-    job->bgcolor = bgcolor ? strdup(bgcolor) : NULL;
-    job->palette_mode = palette_mode ? strdup(palette_mode) : NULL;
-    
-    /* Validate allocations: markup is always required, others conditional */
-    if (!job->markup || (fontfam && !job->fontfam) || (fontstyle && !job->fontstyle) ||
-        (fgcolor && !job->fgcolor) || (outlinecolor && !job->outlinecolor) || 
-        (shadowcolor && !job->shadowcolor) || (bgcolor && !job->bgcolor) || (palette_mode && !job->palette_mode)) {
-        return -1;
+    if (!markup) markup = "";
+
+    if (borrow) {
+        job->markup = markup;
+        job->fontfam = fontfam;
+        job->fontstyle = fontstyle;
+        job->fgcolor = fgcolor;
+        job->outlinecolor = outlinecolor;
+        job->shadowcolor = shadowcolor;
+        job->bgcolor = bgcolor;
+        job->palette_mode = palette_mode;
+        return 0;
     }
-    
+
+    const char *src[8] = { markup, fontfam, fontstyle, fgcolor, outlinecolor,
+                           shadowcolor, bgcolor, palette_mode };
+    size_t total = 0;
+    for (int i = 0; i < 8; i++)
+        if (src[i]) total += strlen(src[i]) + 1;
+    job->strings = malloc(total);
+    if (!job->strings) return -1;
+
+    char *cursor = job->strings;
+    job->markup = put_job_string(&cursor, markup);
+    job->fontfam = put_job_string(&cursor, fontfam);
+    job->fontstyle = put_job_string(&cursor, fontstyle);
+    job->fgcolor = put_job_string(&cursor, fgcolor);
+    job->outlinecolor = put_job_string(&cursor, outlinecolor);
+    job->shadowcolor = put_job_string(&cursor, shadowcolor);
+    job->bgcolor = put_job_string(&cursor, bgcolor);
+    job->palette_mode = put_job_string(&cursor, palette_mode);
     return 0;
 }
 
+/* Helper: resolve the bench accumulator a pool reports into. */
+static BenchStats *pool_bench(const RenderPool *pool) {
+    return pool->bench ? pool->bench : &bench;
+}
+
 /*
  * worker_thread
  * -------------
  * Background worker that processes RenderJob entries from the FIFO
- * queue. Behavior:
+ * queue of the pool passed in `arg`. Behavior:
  *  - Blocks on `job_cond` when the queue is empty.
  *  - Dequeues one job at a time and calls render_text_pango() outside
- *    the global lock to allow concurrent processing.
+ *    the pool lock to allow concurrent processing.
+ *  - For jobs submitted with an encode request, runs the pool's encode
+ *    hook on the bitmap (still outside the lock) so the caller receives
+ *    ready-to-mux bytes. The hook keeps per-worker state in
+ *    `encode_state`, released when the worker exits.
  *  - Stores the result in job->result and signals job->done_cond.
  *
  * The thread exits when `running` is cleared and the queue is empty.
  */
 static void *worker_thread(void *arg) {
-    /* Worker loop: wait for jobs on the global queue, process them, and
+    /* Worker loop: wait for jobs on the pool queue, process them, and
      * notify any waiters. The worker exits when `running` is cleared and
      * the queue is empty. */
-    (void)arg;
+    RenderPool *pool = arg;
+    void *encode_state = NULL;
+    RenderEncodeFn encode_fn = NULL;
     while (1) {
-        /* Dequeue a single job under the global job_mtx. We use a simple
+        /* Dequeue a single job under the pool's job_mtx. We use a simple
          * FIFO queue head/tail. */
-        pthread_mutex_lock(&job_mtx);
-        while (running && job_head == NULL) pthread_cond_wait(&job_cond, &job_mtx);
-        if (!running && job_head == NULL) {
+        pthread_mutex_lock(&pool->job_mtx);
+        while (pool->running && pool->job_head == NULL) pthread_cond_wait(&pool->job_cond, &pool->job_mtx);
+        if (!pool->running && pool->job_head == NULL) {
             /* pool is shutting down and no jobs remain */
-            pthread_mutex_unlock(&job_mtx);
+            pthread_mutex_unlock(&pool->job_mtx);
             break;
         }
-        RenderJob *job = job_head;
+        RenderJob *job = pool->job_head;
         if (job) {
-            job_head = job->queue_next;
-            if (!job_head) job_tail = NULL;
+            pool->job_head = job->queue_next;
+            if (!pool->job_head) pool->job_tail = NULL;
             /* unlink from queue; job remains in all_jobs list for keyed lookup */
         }
-        pthread_mutex_unlock(&job_mtx);
+        encode_fn = pool->encode_fn;
+        void *encode_opaque = pool->encode_opaque;
+        pthread_mutex_unlock(&pool->job_mtx);
         if (!job) continue;
 
         /* Perform the CPU/GPU-agnostic render (Pango/Cairo path). This may be
-         * moderately expensive so we do it outside the global mutex to avoid
+         * moderately expensive so we do it outside the pool mutex to avoid
          * blocking submission or other workers. */
-        int64_t render_start = 0;
-        if (bench.enabled)
-            render_start = bench_now();
+        BenchStats *bs = pool_bench(pool);
+        LOG_CONTEXT(job->track_id, job->cue_index, -1);
+        int64_t render_start = bench_now();
         Bitmap bm = render_text_pango(job->markup,
                                       job->disp_w, job->disp_h,
                                       job->fontsize, job->fontfam,
@@ -359,35 +441,59 @@ static void *worker_thread(void *arg) {
                                       job->fgcolor, job->outlinecolor, job->shadowcolor,
                                       job->bgcolor,
                                       &job->pos_config, job->palette_mode);
-        if (bench.enabled && render_start)
+        RenderJobTiming timing = {
+            .queue_us = render_start - job->t_queued,
+            .render_us = bench_now() - render_start,
+        };
+        if (bs->enabled)
         {
-            bench_add_render_us(bench_now() - render_start);
-            bench_inc_cues_rendered();
+            bench_stats_add_render_us(bs, timing.render_us);
+            bench_stats_inc_cues_rendered(bs);
         }
 
+        RenderPayload payload = {0};
+        if (job->encode && encode_fn) {
+            if (encode_fn(encode_opaque, &encode_state, job->track_id, &bm,
+                          job->duration_ms, &payload) != 0) {
+                /* caller falls back to encoding on its own thread */
+                payload.data = NULL;
+                payload.size = 0;
+            }
+        }
+        LOG_CONTEXT(-1, -1, -1);
+
         /* Store result and notify waiters. Each job has its own mutex/cond
-         * so callers waiting on a specific job don't contend on the global
+         * so callers waiting on a specific job don't contend on the pool
          * job_mtx. */
         pthread_mutex_lock(&job->done_mtx);
         job->result = bm;
+        job->payload = payload;
+        job->timing = timing;
         atomic_store(&job->done, 1);
         pthread_cond_signal(&job->done_cond);
         pthread_mutex_unlock(&job->done_mtx);
     }
+    if (encode_state) {
+        pthread_mutex_lock(&pool->job_mtx);
+        RenderEncodeReleaseFn release = pool->encode_release;
+        void *encode_opaque = pool->encode_opaque;
+        pthread_mutex_unlock(&pool->job_mtx);
+        if (release) release(encode_opaque, encode_state);
+    }
     return NULL;
 }
 
 /*
- * render_pool_init
- * ----------------
- * Start `nthreads` worker threads. If nthreads <= 0 the pool remains
- * disabled and synchronous rendering is used. Returns 0 on success and
- * -1 on allocation or thread creation failure.
+ * pool_start
+ * ----------
+ * Start `nthreads` worker threads on `pool`. Shared by render_pool_init()
+ * and render_pool_create(). Returns 0 on success and -1 on allocation or
+ * thread creation failure.
  *
  * Note: Enforces a hard upper bound on thread count to prevent system
  * oversubscription or resource exhaustion. Maximum of 256 threads.
  */
-int render_pool_init(int nthreads) {
+static int pool_start(RenderPool *pool, int nthreads) {
     if (nthreads <= 0) return 0;
     
     /* Guard against excessive thread counts */
@@ -400,49 +506,51 @@ int render_pool_init(int nthreads) {
     if (!new_workers) return -1;
     /* make pool appear running to worker threads, but only mark active
      * (pool_active) after successful thread creation */
-    running = 1;
+    pool->running = 1;
     int created = 0;
     for (int i = 0; i < nthreads; i++) {
-        if (pthread_create(&new_workers[i], NULL, worker_thread, NULL) != 0) {
+        if (pthread_create(&new_workers[i], NULL, worker_thread, pool) != 0) {
             /* cleanup any threads we managed to start */
-            running = 0;
+            pthread_mutex_lock(&pool->job_mtx);
+            pool->running = 0;
+            pthread_cond_broadcast(&pool->job_cond);
+            pthread_mutex_unlock(&pool->job_mtx);
             for (int j = 0; j < created; j++) pthread_join(new_workers[j], NULL);
             free(new_workers);
             return -1;
         }
         created++;
     }
-    /* publish created workers to globals */
-    workers = new_workers;
-    worker_count = created;
-    atomic_store(&pool_active, 1);
+    /* publish created workers to the pool */
+    pool->workers = new_workers;
+    pool->worker_count = created;
+    atomic_store(&pool->pool_active, 1);
     return 0;
 }
 
 /*
- * render_pool_shutdown
- * --------------------
+ * pool_stop
+ * ---------
  * Gracefully stop worker threads, wait for them to exit, and free all
- * outstanding job resources. Any pending job results are freed as part
- * of shutdown; callers should retrieve results prior to calling this if
- * they need them.
+ * outstanding job resources of `pool`. Shared by render_pool_shutdown()
+ * and render_pool_destroy().
  */
-void render_pool_shutdown(void) {
-    if (!atomic_load(&pool_active)) return;
+static void pool_stop(RenderPool *pool) {
+    if (!atomic_load(&pool->pool_active)) return;
     /* mark pool inactive immediately so new submissions fail fast */
-    atomic_store(&pool_active, 0);
-    pthread_mutex_lock(&job_mtx);
-    running = 0;
-    pthread_cond_broadcast(&job_cond);
-    pthread_mutex_unlock(&job_mtx);
-    for (int i = 0; i < worker_count; i++) pthread_join(workers[i], NULL);
-    free(workers); workers = NULL; worker_count = 0;
+    atomic_store(&pool->pool_active, 0);
+    pthread_mutex_lock(&pool->job_mtx);
+    pool->running = 0;
+    pthread_cond_broadcast(&pool->job_cond);
+    pthread_mutex_unlock(&pool->job_mtx);
+    for (int i = 0; i < pool->worker_count; i++) pthread_join(pool->workers[i], NULL);
+    free(pool->workers); pool->workers = NULL; pool->worker_count = 0;
 
     /* Free any remaining queued jobs (both queue and all_jobs lists).
      * Jobs may contain duplicated strings and a Bitmap result which must
      * be released. We use av_free for buffers allocated by libavutil. */
-    pthread_mutex_lock(&job_mtx);
-    RenderJob *j = job_head;
+    pthread_mutex_lock(&pool->job_mtx);
+    RenderJob *j = pool->job_head;
     while (j) {
         RenderJob *next = j->queue_next;
         /* mark as freed to avoid later double-free when iterating all_jobs */
@@ -452,60 +560,139 @@ void render_pool_shutdown(void) {
          * list but do not destroy its cond/mutex or free it here. */
         if (atomic_load(&j->waiters) > 0) {
             j->freed = 1;
-            remove_from_all_jobs_locked(j);
+            remove_from_all_jobs_locked(pool, j);
             /* leave container allocated for the waiter to free */
         } else {
             j->freed = 1;
             /* remove from all_jobs list now that we're freeing it */
-            remove_from_all_jobs_locked(j);
+            remove_from_all_jobs_locked(pool, j);
             /* cleanup fields and free the container */
             cleanup_job_container(j, 1);
         }
         j = next;
     }
-    job_head = job_tail = NULL;
+    pool->job_head = pool->job_tail = NULL;
 
     /* Free any remaining jobs referenced in all_jobs list that weren't
      * part of the queue. We iterate independently to avoid double-freeing
      * jobs that were already freed from the queue above. */
-    j = all_jobs;
+    j = pool->all_jobs;
     while (j) {
         RenderJob *next = j->all_next;
         /* skip jobs already freed when clearing the queue above */
         if (j->freed) { j = next; continue; }
+        /* a render_pool_ctx_wait() caller owns the container now */
+        if (atomic_load(&j->waiters) > 0) { j->freed = 1; j = next; continue; }
         cleanup_job_container(j, 1);
         j = next;
     }
-    all_jobs = NULL;
-    pthread_mutex_unlock(&job_mtx);
+    pool->all_jobs = NULL;
+    pthread_mutex_unlock(&pool->job_mtx);
 }
 
 /*
- * render_pool_render_sync
- * -----------------------
- * Enqueue a transient job and block until it completes. This helper is
- * convenient for callers that want to use the pool but prefer a blocking
- * call. For short-lived synchronous usage prefer this over directly
- * calling render_text_pango because it shares worker threads and queue
- * scheduling.
+ * render_pool_init
+ * ----------------
+ * Start `nthreads` worker threads on the process-wide default pool. If
+ * nthreads <= 0 the pool remains disabled and synchronous rendering is
+ * used. Returns 0 on success and -1 on allocation or thread creation
+ * failure.
+ */
+int render_pool_init(int nthreads) {
+    return pool_start(&default_pool, nthreads);
+}
+
+/*
+ * render_pool_shutdown
+ * --------------------
+ * Stop the process-wide default pool. Any pending job results are freed
+ * as part of shutdown; callers should retrieve results prior to calling
+ * this if they need them.
+ */
+void render_pool_shutdown(void) {
+    pool_stop(&default_pool);
+}
+
+/*
+ * render_pool_create
+ * ------------------
+ * Allocate and start a private pool instance. Render timings are
+ * accumulated into `bench_out` (NULL selects the global `bench`). With
+ * nthreads <= 0 a valid but inactive pool is returned, so callers get
+ * synchronous rendering through the same handle. Returns NULL on
+ * allocation or thread creation failure.
+ */
+RenderPool *render_pool_create(int nthreads, BenchStats *bench_out) {
+    RenderPool *pool = calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+    if (pthread_mutex_init(&pool->job_mtx, NULL) != 0) { free(pool); return NULL; }
+    if (pthread_cond_init(&pool->job_cond, NULL) != 0) {
+        pthread_mutex_destroy(&pool->job_mtx);
+        free(pool);
+        return NULL;
+    }
+    atomic_store(&pool->pool_active, 0);
+    pool->bench = bench_out;
+    pool->heap_allocated = 1;
+    if (pool_start(pool, nthreads) != 0) {
+        pthread_cond_destroy(&pool->job_cond);
+        pthread_mutex_destroy(&pool->job_mtx);
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+/*
+ * render_pool_destroy
+ * -------------------
+ * Stop a pool created by render_pool_create() and release it. Passing
+ * NULL or the default pool is a no-op for the release step.
+ */
+void render_pool_destroy(RenderPool *pool) {
+    if (!pool) return;
+    pool_stop(pool);
+    if (!pool->heap_allocated) return;
+    pthread_cond_destroy(&pool->job_cond);
+    pthread_mutex_destroy(&pool->job_mtx);
+    free(pool);
+}
+
+/*
+ * render_pool_ctx_render_sync
+ * ---------------------------
+ * Enqueue a transient job on `pool` and block until it completes. This
+ * helper is convenient for callers that want to use the pool but prefer
+ * a blocking call. For short-lived synchronous usage prefer this over
+ * directly calling render_text_pango because it shares worker threads
+ * and queue scheduling.
  *
  * Returns a Bitmap (ownership transferred to caller). On allocation
  * failure an empty Bitmap (w==0) is returned.
  */
-Bitmap render_pool_render_sync(const char *markup,
-                                int disp_w, int disp_h,
-                                int fontsize, const char *fontfam,
-                                const char *fontstyle,
-                                const char *fgcolor, const char *outlinecolor,
-                                const char *shadowcolor, const char *bgcolor,
-                                SubtitlePositionConfig *pos_config,
-                                const char *palette_mode)
+Bitmap render_pool_ctx_render_sync(RenderPool *pool,
+                                   const char *markup,
+                                   int disp_w, int disp_h,
+                                   int fontsize, const char *fontfam,
+                                   const char *fontstyle,
+                                   const char *fgcolor, const char *outlinecolor,
+                                   const char *shadowcolor, const char *bgcolor,
+                                   SubtitlePositionConfig *pos_config,
+                                   const char *palette_mode)
 {
     Bitmap empty = {0};
+    if (!pool) pool = &default_pool;
     /* If the pool isn't active, just call the renderer synchronously to
      * keep callers working without a pool. */
-    if (!atomic_load(&pool_active)) {
-        return render_text_pango(markup, disp_w, disp_h, fontsize, fontfam, fontstyle, fgcolor, outlinecolor, shadowcolor, bgcolor, pos_config, palette_mode);
+    if (!atomic_load(&pool->pool_active)) {
+        BenchStats *bs = pool_bench(pool);
+        int64_t render_start = (pool->bench && bs->enabled) ? bench_now() : 0;
+        Bitmap bm = render_text_pango(markup, disp_w, disp_h, fontsize, fontfam, fontstyle, fgcolor, outlinecolor, shadowcolor, bgcolor, pos_config, palette_mode);
+        if (render_start) {
+            bench_stats_add_render_us(bs, bench_now() - render_start);
+            bench_stats_inc_cues_rendered(bs);
+        }
+        return bm;
     }
 
     /* Build a transient job structure which we will wait on. We don't add
@@ -514,9 +701,10 @@ Bitmap render_pool_render_sync(const char *markup,
     RenderJob *job = calloc(1, sizeof(RenderJob));
     if (!job) return empty;
     
-    /* Initialize string fields; on failure clean up and return */
+    /* The caller blocks until the job is done, so its strings can be
+     * borrowed instead of copied. */
     if (init_job_strings(job, markup, fontfam, fontstyle, fgcolor, 
-                        outlinecolor, shadowcolor, bgcolor, palette_mode) != 0) {
+                        outlinecolor, shadowcolor, bgcolor, palette_mode, 1) != 0) {
         cleanup_job_container(job, 1);
         return empty;
     }
@@ -546,14 +734,14 @@ Bitmap render_pool_render_sync(const char *markup,
     atomic_store(&job->waiters, 0);
 
     /* Enqueue the job and wake a worker */
-    pthread_mutex_lock(&job_mtx);
+    pthread_mutex_lock(&pool->job_mtx);
     job->queue_next = NULL;
-    if (job_tail) job_tail->queue_next = job; else job_head = job;
-    job_tail = job;
+    if (pool->job_tail) pool->job_tail->queue_next = job; else pool->job_head = job;
+    pool->job_tail = job;
     /* mark that a waiter will block on this transient job */
     atomic_fetch_add(&job->waiters, 1);
-    pthread_cond_signal(&job_cond);
-    pthread_mutex_unlock(&job_mtx);
+    pthread_cond_signal(&pool->job_cond);
+    pthread_mutex_unlock(&pool->job_mtx);
 
     /* wait for completion on the job's own cond var */
     pthread_mutex_lock(&job->done_mtx);
@@ -572,49 +760,73 @@ Bitmap render_pool_render_sync(const char *markup,
 }
 
 /*
- * render_pool_submit_async
- * ------------------------
- * Submit a render job identified by (track_id, cue_index). The pool
- * duplicates string parameters and owns them until the job is retrieved
- * or the pool is shut down. Returns 0 on success and -1 on failure.
+ * render_pool_render_sync
+ * -----------------------
+ * Legacy entry point: render_pool_ctx_render_sync() on the default pool.
+ */
+Bitmap render_pool_render_sync(const char *markup,
+                                int disp_w, int disp_h,
+                                int fontsize, const char *fontfam,
+                                const char *fontstyle,
+                                const char *fgcolor, const char *outlinecolor,
+                                const char *shadowcolor, const char *bgcolor,
+                                SubtitlePositionConfig *pos_config,
+                                const char *palette_mode)
+{
+    return render_pool_ctx_render_sync(&default_pool, markup, disp_w, disp_h,
+                                       fontsize, fontfam, fontstyle,
+                                       fgcolor, outlinecolor, shadowcolor, bgcolor,
+                                       pos_config, palette_mode);
+}
+
+/*
+ * pool_submit / render_pool_ctx_submit_async
+ * ------------------------------------------
+ * Submit a render job identified by (track_id, cue_index) to `pool`. The
+ * pool duplicates string parameters and owns them until the job is
+ * retrieved or the pool is shut down; with `borrow` set it keeps the
+ * caller's pointers instead. Returns 0 on success and -1 on failure.
  *
  * Note: Enforces a maximum queue depth to prevent unbounded memory growth.
  * If the queue reaches maximum size, returns -1 to force synchronous
  * rendering fallback.
  */
-int render_pool_submit_async(int track_id, int cue_index,
-                             const char *markup,
-                             int disp_w, int disp_h,
-                             int fontsize, const char *fontfam,
-                             const char *fontstyle,
-                             const char *fgcolor, const char *outlinecolor,
-                             const char *shadowcolor, const char *bgcolor, int align_code,
-                             double sub_position_pct,
-                             SubtitlePositionConfig *pos_config,
-                             const char *palette_mode)
+static int pool_submit(RenderPool *pool,
+                       int track_id, int cue_index,
+                       const char *markup,
+                       int disp_w, int disp_h,
+                       int fontsize, const char *fontfam,
+                       const char *fontstyle,
+                       const char *fgcolor, const char *outlinecolor,
+                       const char *shadowcolor, const char *bgcolor, int align_code,
+                       double sub_position_pct,
+                       const SubtitlePositionConfig *pos_config,
+                       const char *palette_mode,
+                       int encode, int64_t duration_ms, int borrow)
 {
+    if (!pool) pool = &default_pool;
     /* If no pool exists, fail fast to let callers fall back if desired. */
-    if (!atomic_load(&pool_active)) return -1;
+    if (!atomic_load(&pool->pool_active)) return -1;
     
     /* Guard against unbounded queue growth by enforcing max queue depth */
     const int MAX_QUEUE_DEPTH = 1024;
-    pthread_mutex_lock(&job_mtx);
+    pthread_mutex_lock(&pool->job_mtx);
     int queue_depth = 0;
-    for (struct RenderJob *j = job_head; j != NULL; j = j->queue_next) {
+    for (struct RenderJob *j = pool->job_head; j != NULL; j = j->queue_next) {
         queue_depth++;
         if (queue_depth >= MAX_QUEUE_DEPTH) {
-            pthread_mutex_unlock(&job_mtx);
+            pthread_mutex_unlock(&pool->job_mtx);
             return -1;  /* Queue full; caller should fall back to sync rendering */
         }
     }
-    pthread_mutex_unlock(&job_mtx);
+    pthread_mutex_unlock(&pool->job_mtx);
     
     RenderJob *job = calloc(1, sizeof(RenderJob));
     if (!job) return -1;
     
     /* Initialize string fields; on failure clean up and return */
     if (init_job_strings(job, markup, fontfam, fontstyle, fgcolor,
-                        outlinecolor, shadowcolor, bgcolor, palette_mode) != 0) {
+                        outlinecolor, shadowcolor, bgcolor, palette_mode, borrow) != 0) {
         cleanup_job_container(job, 1);
         return -1;
     }
@@ -625,6 +837,8 @@ int render_pool_submit_async(int track_id, int cue_index,
     job->fontsize = fontsize;
     job->align_code = align_code;
     job->sub_position_pct = sub_position_pct;
+    job->encode = encode;
+    job->duration_ms = duration_ms;
     /* Copy positioning config if provided */
     if (pos_config) {
         job->pos_config = *pos_config;
@@ -645,48 +859,246 @@ int render_pool_submit_async(int track_id, int cue_index,
     job->done_mtx_init = 1;
     atomic_store(&job->waiters, 0);
 
-    pthread_mutex_lock(&job_mtx);
+    pthread_mutex_lock(&pool->job_mtx);
     /* enqueue for workers (FIFO) */
     job->queue_next = NULL;
-    if (job_tail) job_tail->queue_next = job; else job_head = job;
-    job_tail = job;
+    if (pool->job_tail) pool->job_tail->queue_next = job; else pool->job_head = job;
+    pool->job_tail = job;
     /* add to all_jobs list for keyed lookup (LIFO insert is fine here) */
-    job->all_next = all_jobs; all_jobs = job;
+    job->all_next = pool->all_jobs; pool->all_jobs = job;
     job->track_id = track_id;
     job->cue_index = cue_index;
-    pthread_cond_signal(&job_cond);
-    pthread_mutex_unlock(&job_mtx);
+    job->t_queued = bench_now();
+    pthread_cond_signal(&pool->job_cond);
+    pthread_mutex_unlock(&pool->job_mtx);
     return 0;
 }
 
+int render_pool_ctx_submit_async(RenderPool *pool,
+                                 int track_id, int cue_index,
+                                 const char *markup,
+                                 int disp_w, int disp_h,
+                                 int fontsize, const char *fontfam,
+                                 const char *fontstyle,
+                                 const char *fgcolor, const char *outlinecolor,
+                                 const char *shadowcolor, const char *bgcolor, int align_code,
+                                 double sub_position_pct,
+                                 SubtitlePositionConfig *pos_config,
+                                 const char *palette_mode)
+{
+    return pool_submit(pool, track_id, cue_index, markup, disp_w, disp_h,
+                       fontsize, fontfam, fontstyle,
+                       fgcolor, outlinecolor, shadowcolor, bgcolor,
+                       align_code, sub_position_pct, pos_config, palette_mode,
+                       0, 0, 0);
+}
+
 /*
- * render_pool_try_get
- * -------------------
- * Attempt to retrieve a completed job matching (track_id, cue_index).
- * If the job is complete, transfer ownership of the Bitmap into `out`
- * and return 1. If the job exists but is still running return 0. If no
- * job exists with that key return -1.
+ * render_pool_ctx_submit_encoded
+ * ------------------------------
+ * Like render_pool_ctx_submit_async() but also asks the worker to run
+ * the pool's encode hook on the rendered bitmap. `duration_ms` is passed
+ * to the hook (display duration of the cue). Without a hook installed
+ * the job behaves like a plain async render.
  */
-int render_pool_try_get(int track_id, int cue_index, Bitmap *out) {
+int render_pool_ctx_submit_encoded(RenderPool *pool,
+                                   int track_id, int cue_index,
+                                   const char *markup,
+                                   int disp_w, int disp_h,
+                                   int fontsize, const char *fontfam,
+                                   const char *fontstyle,
+                                   const char *fgcolor, const char *outlinecolor,
+                                   const char *shadowcolor, const char *bgcolor, int align_code,
+                                   double sub_position_pct,
+                                   SubtitlePositionConfig *pos_config,
+                                   const char *palette_mode,
+                                   int64_t duration_ms)
+{
+    return pool_submit(pool, track_id, cue_index, markup, disp_w, disp_h,
+                       fontsize, fontfam, fontstyle,
+                       fgcolor, outlinecolor, shadowcolor, bgcolor,
+                       align_code, sub_position_pct, pos_config, palette_mode,
+                       1, duration_ms, 0);
+}
+
+/*
+ * render_pool_ctx_submit_ref
+ * --------------------------
+ * Zero-copy submission: the job keeps the caller's markup and style
+ * pointers, which must stay valid until the job is retrieved or the pool
+ * is shut down. `encode` selects the worker encode hook as in
+ * render_pool_ctx_submit_encoded().
+ */
+int render_pool_ctx_submit_ref(RenderPool *pool,
+                               int track_id, int cue_index,
+                               const char *markup,
+                               int disp_w, int disp_h,
+                               int fontsize, const char *fontfam,
+                               const char *fontstyle,
+                               const char *fgcolor, const char *outlinecolor,
+                               const char *shadowcolor, const char *bgcolor, int align_code,
+                               double sub_position_pct,
+                               const SubtitlePositionConfig *pos_config,
+                               const char *palette_mode,
+                               int encode, int64_t duration_ms)
+{
+    return pool_submit(pool, track_id, cue_index, markup, disp_w, disp_h,
+                       fontsize, fontfam, fontstyle,
+                       fgcolor, outlinecolor, shadowcolor, bgcolor,
+                       align_code, sub_position_pct, pos_config, palette_mode,
+                       encode, duration_ms, 1);
+}
+
+/*
+ * render_pool_ctx_set_encoder
+ * ---------------------------
+ * Install (or clear, with fn == NULL) the post-render encode hook of
+ * `pool`. May be called while workers run; each worker picks up the
+ * hook on its next dequeue.
+ */
+void render_pool_ctx_set_encoder(RenderPool *pool, RenderEncodeFn fn,
+                                 RenderEncodeReleaseFn release, void *opaque)
+{
+    if (!pool) pool = &default_pool;
+    pthread_mutex_lock(&pool->job_mtx);
+    pool->encode_fn = fn;
+    pool->encode_release = release;
+    pool->encode_opaque = opaque;
+    pthread_mutex_unlock(&pool->job_mtx);
+}
+
+/*
+ * render_pool_submit_async
+ * ------------------------
+ * Legacy entry point: render_pool_ctx_submit_async() on the default pool.
+ */
+int render_pool_submit_async(int track_id, int cue_index,
+                             const char *markup,
+                             int disp_w, int disp_h,
+                             int fontsize, const char *fontfam,
+                             const char *fontstyle,
+                             const char *fgcolor, const char *outlinecolor,
+                             const char *shadowcolor, const char *bgcolor, int align_code,
+                             double sub_position_pct,
+                             SubtitlePositionConfig *pos_config,
+                             const char *palette_mode)
+{
+    return render_pool_ctx_submit_async(&default_pool, track_id, cue_index, markup,
+                                        disp_w, disp_h, fontsize, fontfam, fontstyle,
+                                        fgcolor, outlinecolor, shadowcolor, bgcolor,
+                                        align_code, sub_position_pct, pos_config,
+                                        palette_mode);
+}
+
+/*
+ * render_pool_ctx_try_get
+ * -----------------------
+ * Attempt to retrieve a completed job matching (track_id, cue_index) from
+ * `pool`. If the job is complete, transfer ownership of the Bitmap into
+ * `out` and return 1. If the job exists but is still running return 0.
+ * If no job exists with that key return -1.
+ */
+int render_pool_ctx_try_get(RenderPool *pool, int track_id, int cue_index, Bitmap *out) {
+    return render_pool_ctx_try_get_payload(pool, track_id, cue_index, out, NULL);
+}
+
+/*
+ * render_pool_ctx_try_get_payload
+ * -------------------------------
+ * render_pool_ctx_try_get() that also moves the encoded payload (if the
+ * job produced one) into `payload`. A NULL `payload` discards it.
+ */
+int render_pool_ctx_try_get_payload(RenderPool *pool, int track_id, int cue_index,
+                                    Bitmap *out, RenderPayload *payload) {
     RenderJob *prev = NULL, *j = NULL;
-    pthread_mutex_lock(&job_mtx);
-    j = all_jobs;
+    if (!pool) pool = &default_pool;
+    pthread_mutex_lock(&pool->job_mtx);
+    j = pool->all_jobs;
     while (j) {
         if (j->track_id == track_id && j->cue_index == cue_index) {
             if (atomic_load(&j->done) == 0) {
-                pthread_mutex_unlock(&job_mtx);
+                pthread_mutex_unlock(&pool->job_mtx);
                 return 0; /* job exists but not finished */
             }
             /* remove j from all_jobs list */
-            if (prev) prev->all_next = j->all_next; else all_jobs = j->all_next;
-            pthread_mutex_unlock(&job_mtx);
+            if (prev) prev->all_next = j->all_next; else pool->all_jobs = j->all_next;
+            pthread_mutex_unlock(&pool->job_mtx);
             /* transfer result to caller and free job container safely */
             steal_job_result(j, out);
+            steal_job_payload(j, payload);
             cleanup_job_container(j, 1);
             return 1;
         }
         prev = j; j = j->all_next;
     }
-    pthread_mutex_unlock(&job_mtx);
+    pthread_mutex_unlock(&pool->job_mtx);
     return -1; /* no job found */
 }
+
+/*
+ * render_pool_try_get
+ * -------------------
+ * Legacy entry point: render_pool_ctx_try_get() on the default pool.
+ */
+int render_pool_try_get(int track_id, int cue_index, Bitmap *out) {
+    return render_pool_ctx_try_get(&default_pool, track_id, cue_index, out);
+}
+
+/*
+ * render_pool_ctx_wait
+ * --------------------
+ * Blocking counterpart of render_pool_ctx_try_get(): wait on the job's
+ * own cond var until (track_id, cue_index) is done, then transfer the
+ * Bitmap into `out`. Returns 1 on success and -1 if no such job exists.
+ *
+ * The waiter count keeps shutdown from freeing the container while we
+ * sleep; workers drain the queue before exiting, so the job always
+ * completes. The pool itself must outlive the call.
+ */
+int render_pool_ctx_wait(RenderPool *pool, int track_id, int cue_index, Bitmap *out) {
+    return render_pool_ctx_wait_timed(pool, track_id, cue_index, out, NULL, NULL);
+}
+
+/*
+ * render_pool_ctx_wait_payload
+ * ----------------------------
+ * Blocking counterpart of render_pool_ctx_try_get_payload().
+ */
+int render_pool_ctx_wait_payload(RenderPool *pool, int track_id, int cue_index,
+                                 Bitmap *out, RenderPayload *payload) {
+    return render_pool_ctx_wait_timed(pool, track_id, cue_index, out, payload, NULL);
+}
+
+/*
+ * render_pool_ctx_wait_timed
+ * --------------------------
+ * render_pool_ctx_wait_payload() that also reports how long the job sat
+ * in the queue and how long the worker spent rendering it.
+ */
+int render_pool_ctx_wait_timed(RenderPool *pool, int track_id, int cue_index,
+                               Bitmap *out, RenderPayload *payload,
+                               RenderJobTiming *timing) {
+    if (!pool) pool = &default_pool;
+    pthread_mutex_lock(&pool->job_mtx);
+    RenderJob *j = find_job(pool, track_id, cue_index);
+    if (!j) {
+        pthread_mutex_unlock(&pool->job_mtx);
+        return -1;
+    }
+    atomic_fetch_add(&j->waiters, 1);
+    pthread_mutex_unlock(&pool->job_mtx);
+
+    pthread_mutex_lock(&j->done_mtx);
+    while (atomic_load(&j->done) == 0) pthread_cond_wait(&j->done_cond, &j->done_mtx);
+    pthread_mutex_unlock(&j->done_mtx);
+
+    pthread_mutex_lock(&pool->job_mtx);
+    remove_from_all_jobs_locked(pool, j);
+    pthread_mutex_unlock(&pool->job_mtx);
+    steal_job_result(j, out);
+    steal_job_payload(j, payload);
+    if (timing) *timing = j->timing;
+    atomic_fetch_sub(&j->waiters, 1);
+    cleanup_job_container(j, 1);
+    return 1;
+}
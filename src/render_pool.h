@@ -52,6 +52,7 @@
 #include <pthread.h>
 #include "render_pango.h"
 #include "runtime_opts.h"
+#include "bench.h"
 
 /*
  * @file render_pool.h
@@ -66,7 +67,9 @@
  *
  * Thread-safety and ownership:
  *  - The pool copies string arguments when enqueuing, so callers may free
- *    their buffers after submission.
+ *    their buffers after submission. The exceptions are synchronous
+ *    renders (the caller's strings are used while it waits) and
+ *    render_pool_ctx_submit_ref(), which borrows them.
  *  - Returned `Bitmap` objects transfer ownership of `idxbuf` and `palette`
  *    to the caller; the caller must free them (av_free is used internally).
  *
@@ -184,4 +187,140 @@ int render_pool_submit_async(int track_id, int cue_index,
  */
 int render_pool_try_get(int track_id, int cue_index, Bitmap *out);
 
+/*
+ * Instance API
+ * ------------
+ * The functions above operate on a single process-wide pool. Callers
+ * that need several independent pools in one process (for example the
+ * engine contexts in srt2dvbsub_engine.h) create private instances with
+ * render_pool_create() and use the *_ctx_* variants below. Each instance
+ * owns its own queue, workers and locks; the locking rules documented at
+ * the top of this header apply per instance. Passing a NULL pool to the
+ * *_ctx_* functions selects the process-wide pool.
+ */
+typedef struct RenderPool RenderPool;
+
+/*
+ * Create a private pool with `nthreads` workers. Render timings are
+ * accumulated into `bench_out` (NULL selects the global `bench`). With
+ * nthreads <= 0 the pool renders synchronously. Returns NULL on failure.
+ */
+RenderPool *render_pool_create(int nthreads, BenchStats *bench_out);
+
+/*
+ * Stop the workers of a pool created with render_pool_create(), free any
+ * outstanding jobs and release the pool itself.
+ */
+void render_pool_destroy(RenderPool *pool);
+
+Bitmap render_pool_ctx_render_sync(RenderPool *pool,
+                                   const char *markup,
+                                   int disp_w, int disp_h,
+                                   int fontsize, const char *fontfam,
+                                   const char *fontstyle,
+                                   const char *fgcolor, const char *outlinecolor,
+                                   const char *shadowcolor, const char *bgcolor,
+                                   SubtitlePositionConfig *pos_config,
+                                   const char *palette_mode);
+
+int render_pool_ctx_submit_async(RenderPool *pool,
+                                 int track_id, int cue_index,
+                                 const char *markup, int disp_w, int disp_h, int fontsize,
+                                 const char *fontfam, const char *fontstyle,
+                                 const char *fgcolor, const char *outlinecolor,
+                                 const char *shadowcolor, const char *bgcolor, int align_code,
+                                 double sub_position_pct,
+                                 SubtitlePositionConfig *pos_config,
+                                 const char *palette_mode);
+
+int render_pool_ctx_try_get(RenderPool *pool, int track_id, int cue_index, Bitmap *out);
+
+/*
+ * Block until the job keyed by (track_id, cue_index) completes and move
+ * its Bitmap into `*out`. Returns 1 on success, -1 if no such job was
+ * submitted. The pool must not be destroyed while a caller is waiting.
+ */
+int render_pool_ctx_wait(RenderPool *pool, int track_id, int cue_index, Bitmap *out);
+
+/*
+ * Worker-side encoding
+ * --------------------
+ * A pool can carry an encode hook that workers run right after
+ * rendering, so the bytes handed back to the caller are ready to mux and
+ * the (often large) RLE/bitstream encode stays off the caller's thread.
+ * The hook receives a per-worker state slot (initially NULL) that it may
+ * fill lazily, e.g. with per-track encoder contexts; `release` is called
+ * with that state when the worker exits. The hook returns 0 and fills
+ * `out` (av_malloc'd) on success, non-zero to leave the job un-encoded.
+ */
+typedef struct {
+    uint8_t *data; /* av_malloc'd encoded bytes (NULL when not encoded) */
+    int size;
+} RenderPayload;
+
+typedef int (*RenderEncodeFn)(void *opaque, void **worker_state, int track_id,
+                              const Bitmap *bm, int64_t duration_ms,
+                              RenderPayload *out);
+typedef void (*RenderEncodeReleaseFn)(void *opaque, void *worker_state);
+
+void render_pool_ctx_set_encoder(RenderPool *pool, RenderEncodeFn fn,
+                                 RenderEncodeReleaseFn release, void *opaque);
+
+int render_pool_ctx_submit_encoded(RenderPool *pool,
+                                   int track_id, int cue_index,
+                                   const char *markup, int disp_w, int disp_h, int fontsize,
+                                   const char *fontfam, const char *fontstyle,
+                                   const char *fgcolor, const char *outlinecolor,
+                                   const char *shadowcolor, const char *bgcolor, int align_code,
+                                   double sub_position_pct,
+                                   SubtitlePositionConfig *pos_config,
+                                   const char *palette_mode,
+                                   int64_t duration_ms);
+
+/*
+ * Zero-copy variant of render_pool_ctx_submit_async/_encoded: the job
+ * stores the markup and style string pointers as given instead of
+ * copying them, so they must stay valid until the job has been retrieved
+ * or the pool shut down (e.g. markup owned by the track for the whole
+ * run). `encode` requests the worker encode hook with `duration_ms`.
+ */
+int render_pool_ctx_submit_ref(RenderPool *pool,
+                               int track_id, int cue_index,
+                               const char *markup, int disp_w, int disp_h, int fontsize,
+                               const char *fontfam, const char *fontstyle,
+                               const char *fgcolor, const char *outlinecolor,
+                               const char *shadowcolor, const char *bgcolor, int align_code,
+                               double sub_position_pct,
+                               const SubtitlePositionConfig *pos_config,
+                               const char *palette_mode,
+                               int encode, int64_t duration_ms);
+
+/*
+ * Variants of try_get/wait that also move the job's encoded payload into
+ * `payload` (ownership transferred; free with av_free). `payload->data`
+ * is NULL when the job was not encoded. A NULL `payload` discards it.
+ */
+int render_pool_ctx_try_get_payload(RenderPool *pool, int track_id, int cue_index,
+                                    Bitmap *out, RenderPayload *payload);
+int render_pool_ctx_wait_payload(RenderPool *pool, int track_id, int cue_index,
+                                 Bitmap *out, RenderPayload *payload);
+
+/*
+ * Per-job timings measured by the worker (microseconds): `queue_us` from
+ * submission until a worker picked the job up, `render_us` for the
+ * render call alone (excluding any worker encode).
+ */
+typedef struct {
+    int64_t queue_us;
+    int64_t render_us;
+} RenderJobTiming;
+
+/*
+ * render_pool_ctx_wait_payload() that also copies the job's timings into
+ * `timing` (may be NULL).
+ */
+int render_pool_ctx_wait_timed(RenderPool *pool, int track_id, int cue_index,
+                               Bitmap *out, RenderPayload *payload,
+                               RenderJobTiming *timing);
+
 #endif
@@ -84,6 +84,36 @@ int ssaa_override = 4; /* default to 4x supersampling for smoother edges */
  * platforms where the unsharp kernel causes unacceptable haloing. */
 int no_unsharp = 0;
 
+/* Enable the glyph-atlas fast path when non-zero; by default every cue
+ * takes the supersampled Cairo path. */
+int glyph_atlas = 0;
+
+/* Keep every cue at its rendered palette size when non-zero instead of
+ * fitting the DVB region depth (2/4/8-bit) to the colours it uses. */
+int no_adaptive_depth = 0;
+
+/* Wrap SRT cues by character count when non-zero instead of by measured
+ * width with balanced line breaks. */
+int no_line_balance = 0;
+
+/* Shadow/outline pipeline (RenderEffectsMode): 0 = Cairo, 1 = morph,
+ * 2 = auto. */
+int effects_mode = 0;
+
+/* DVB CLUT colorimetry (ClutColorimetry): 0 = BT.601, 1 = BT.709,
+ * 2 = auto (from the input video stream). */
+int colorimetry = 0;
+
+/* Write LOG() output from the logging thread when non-zero instead of
+ * through the per-thread rings and background writer. */
+int log_sync = 0;
+
+/* Async log format (LogFormat): 0 = text, 1 = JSON lines. */
+int log_format = 0;
+
+/* Async log rate limit per call site, in messages per second (0 = off). */
+int log_rate = 100;
+
 /* Global variable to control the verbosity of debug output.
  * A higher value increases the amount of debug information printed.
  * Default is 0 (no debug output).
@@ -129,6 +159,20 @@ int64_t ts_bitrate = 0;
  * When enabled, no MPEG-TS file is produced; only PNG images are saved. */
 int png_only = 0;
 
+/* PNG writer settings: zlib level (0-9), PngFilterStrategy, deflate
+ * threads, and whether to use the Cairo ARGB writer instead of the
+ * native palette writer. */
+int png_level = 6;
+int png_filter = 0;
+int png_threads = 1;
+int png_cairo = 0;
+
+/* Contact-sheet preview output: pack cues into per-track sheet pages of
+ * at most png_sheet_w x png_sheet_h pixels plus a JSON index. */
+int png_sheet = 0;
+int png_sheet_w = 4096;
+int png_sheet_h = 4096;
+
 /* Subtitle positioning specification: comma-separated per-track positioning configs.
  * Format: "position[,margins];position[,margins];..."
  * Example: "bottom-center,5.0;top-left,3.0,2.0"
@@ -146,3 +190,37 @@ SubtitlePositionConfig sub_pos_configs[8] = {
         .margin_right = 2.0
     }
 };
+
+/* Socket path for --render-daemon; NULL means normal encode mode. */
+char *render_daemon_socket = NULL;
+
+/* Concurrent connection limit for the render daemon (--daemon-clients). */
+int render_daemon_clients = 8;
+
+/* Frame-grid snapping for cue times (FrameSnapMode); 0 = off. */
+int frame_snap_mode = 0;
+
+/* Optional "SRC:DST" cue frame-rate conversion (--fps-convert). */
+char *fps_convert_spec = NULL;
+
+/* Two-pass pre-render into a spool before remuxing (--prerender). */
+int prerender_mode = 0;
+
+/* Spool file kept after --prerender; NULL uses an unlinked temp file. */
+char *prerender_spool_path = NULL;
+
+/* --qc-only report format (QCReportFormat); 0 = text. */
+int qc_format = 0;
+
+/* --qc-only report file; NULL writes qc_log.txt. */
+char *qc_report_path = NULL;
+
+/* --qc-only cross-track timing comparison; off by default. */
+int qc_cross = 0;
+
+/* --auto-delay analysis mode and the audio span it reads (seconds). */
+int auto_delay = 0;
+int auto_delay_seconds = 600;
+
+/* --deterministic: bit-exact encoder/muxer setup; off by default. */
+int deterministic = 0;
@@ -99,6 +99,78 @@ extern int ssaa_override;
  */
 extern int no_unsharp;
 
+/**
+ * @brief Global flag to enable the glyph-atlas render fast path.
+ *
+ * When non-zero, plain and italic-only cues are composited from cached
+ * glyph tiles instead of being drawn with the full supersampled Cairo
+ * path. Off by default (see render_pango_set_glyph_atlas()). Set via
+ * --glyph-atlas.
+ */
+extern int glyph_atlas;
+
+/**
+ * @brief Global flag to disable the adaptive DVB palette depth.
+ *
+ * By default make_subtitle() compacts each cue's palette to the indices
+ * it uses, so cues with at most 4 colours are encoded as 2-bit regions.
+ * When non-zero, the rendered 16-entry palette (4-bit) is always sent.
+ * Set via --no-adaptive-depth.
+ */
+extern int no_adaptive_depth;
+
+/**
+ * @brief Global flag to disable width-aware balanced line breaking.
+ *
+ * By default SRT cues are wrapped at parse time using glyph advances of
+ * the render font, splitting each line into the fewest lines that fit and
+ * evening out their widths; Pango then keeps those lines. When non-zero,
+ * the character-count wrapping is used and Pango re-wraps at 80% width.
+ * Set via --no-line-balance.
+ */
+extern int no_line_balance;
+
+/**
+ * @brief Shadow/outline effect pipeline (RenderEffectsMode).
+ *
+ * 0 = Cairo (default), 1 = morphological outline/shadow derived from a
+ * single fill mask, 2 = auto (morphological for HD/UHD render profiles).
+ * Set via --effects.
+ */
+extern int effects_mode;
+
+/**
+ * @brief DVB CLUT colorimetry (ClutColorimetry).
+ *
+ * 0 = BT.601 (default, the dvbsub encoder's own conversion), 1 = BT.709,
+ * 2 = auto: follow the input video's colour matrix, or its height when
+ * the matrix is unspecified (> 576 lines means BT.709). Set via
+ * --colorimetry.
+ */
+extern int colorimetry;
+
+/**
+ * @brief Write LOG() output directly instead of through the async backend.
+ *
+ * With --debug > 0, log messages are queued on per-thread ring buffers and
+ * written by a background thread (see log_async.h). When non-zero, every
+ * message is written to stderr by the thread that logs it.
+ * Set via --log-sync.
+ */
+extern int log_sync;
+
+/**
+ * @brief Async log output format (LogFormat): 0 = text, 1 = JSON lines.
+ * Set via --log-format.
+ */
+extern int log_format;
+
+/**
+ * @brief Async log rate limit: messages per second per call site, 0 = off.
+ * Set via --log-rate.
+ */
+extern int log_rate;
+
 /**
  * @brief Global variable to control the level of debug output.
  *
@@ -207,6 +279,31 @@ extern int64_t ts_bitrate;
  */
 extern int png_only;
 
+/**
+ * @brief PNG writer settings (--png-level, --png-filter, --png-threads,
+ *        --png-cairo).
+ *
+ * By default debug/preview PNGs are written as palette PNGs by the
+ * native writer (png_writer.c) at zlib level 6 with no row filtering.
+ * png_filter holds a PngFilterStrategy; png_threads > 1 deflates row
+ * bands in parallel; png_cairo selects the older Cairo ARGB writer.
+ */
+extern int png_level;
+extern int png_filter;
+extern int png_threads;
+extern int png_cairo;
+
+/**
+ * @brief Contact-sheet preview output (--png-sheet, --png-sheet-size).
+ *
+ * When png_sheet is set, preview PNGs are packed per track into sheet
+ * pages of at most png_sheet_w x png_sheet_h pixels with a JSON index
+ * (contact_sheet.c) instead of one file per cue.
+ */
+extern int png_sheet;
+extern int png_sheet_w;
+extern int png_sheet_h;
+
 /**
  * @brief Canvas positioning enumeration for subtitle placement.
  *
@@ -259,4 +356,90 @@ extern char *sub_position_spec;
  */
 extern SubtitlePositionConfig sub_pos_configs[8];
 
+/**
+ * @brief UNIX socket path for render-only daemon mode.
+ *
+ * When non-NULL (set via --render-daemon PATH), srt2dvbsub skips the
+ * encode pipeline and serves cue render requests on this socket until
+ * interrupted. See render_daemon.h for the wire protocol.
+ */
+extern char *render_daemon_socket;
+
+/**
+ * @brief Maximum number of concurrently served daemon connections.
+ *
+ * Set via --daemon-clients N. Connections beyond this limit receive an
+ * `ERR busy` reply and are closed.
+ */
+extern int render_daemon_clients;
+
+/**
+ * @brief Frame-grid snapping mode for cue timing (FrameSnapMode value).
+ *
+ * Set via --frame-snap off|nearest|floor|ceil. 0 (off) keeps the legacy
+ * millisecond timing. See frame_timing.h.
+ */
+extern int frame_snap_mode;
+
+/**
+ * @brief Cue frame-rate conversion spec "SRC:DST" (e.g. "23.976:25").
+ *
+ * NULL disables conversion. Set via --fps-convert.
+ */
+extern char *fps_convert_spec;
+
+/**
+ * @brief Non-zero to render and encode every cue before remuxing.
+ *
+ * Set via --prerender (or implied by --prerender-spool). The payloads go
+ * to a memory-mapped spool (see prerender_spool.h) that the demux loop
+ * splices from. Requires the Pango renderer and TS output.
+ */
+extern int prerender_mode;
+
+/**
+ * @brief Path of the --prerender spool file, kept after the run.
+ *
+ * An existing spool at this path is reused when it was made with the
+ * same options and cues. NULL (default) uses an anonymous temporary file
+ * in $TMPDIR.
+ */
+extern char *prerender_spool_path;
+
+/**
+ * @brief --qc-only report format (QCReportFormat): 0 = text, 1 = CSV,
+ * 2 = JSON lines, 3 = SARIF. Set via --qc-format.
+ */
+extern int qc_format;
+
+/**
+ * @brief --qc-only report path. NULL (default) writes qc_log.txt.
+ * Set via --qc-report.
+ */
+extern char *qc_report_path;
+
+/**
+ * @brief --qc-only also compares timing across tracks (qc_cross.h) when
+ * set. Set via --qc-cross.
+ */
+extern int qc_cross;
+
+/**
+ * @brief Estimate per-track delays from the input's audio instead of
+ * muxing. Set via --auto-delay.
+ */
+extern int auto_delay;
+
+/**
+ * @brief Seconds of audio analysed by --auto-delay (default 600).
+ * Set via --auto-delay-window.
+ */
+extern int auto_delay_seconds;
+
+/**
+ * @brief Non-zero for reproducible output: the subtitle PIDs come out
+ * byte-identical for any --render-threads value. Set via --deterministic.
+ */
+extern int deterministic;
+
 #endif /* SRT2DVB_RUNTIME_OPTS_H */
@@ -84,7 +84,12 @@
 #include "render_pool.h"
 #include "dvb_sub.h"
 #include "qc.h"
+#include "qc_report.h"
+#include "qc_batch.h"
+#include "qc_cross.h"
+#include "audio_sync.h"
 #include "bench.h"
+#include "log_async.h"
 #include "debug_png.h"
 #include "runtime_opts.h"
 #include "muxsub.h"
@@ -101,6 +106,15 @@
 #include "render_params.h"
 #include "png_path.h"
 #include "batch_encode.h"
+#include "render_daemon.h"
+#include "frame_timing.h"
+#include "cue_timeline.h"
+#include "sub_encode.h"
+#include "prerender_spool.h"
+#include "stream_class.h"
+#include "coverage_effects.h"
+#include "contact_sheet.h"
+#include "clut_cache.h"
 
 /*
  * srt2dvbsub.c
@@ -183,6 +197,7 @@ typedef struct OverwriteTarget {
  *   bench_mode          Benchmark mode flag.
  *   debug_level         Debug verbosity level.
  *   render_threads      Number of rendering threads.
+ *   sheets              Per-track contact sheets (--png-sheet), opened lazily.
  */
 struct MainCtx {
     SubTrack *tracks;    /* pointer to tracks array */
@@ -220,6 +235,16 @@ struct MainCtx {
     char *overwrite_langs;
     OverwriteTarget overwrite_targets[MAX_OVERWRITE_TARGETS];
     int overwrite_target_count;
+    int video_index;            /* first video stream in in_fmt, -1 if none */
+    int video_fps_num;          /* detected video frame rate (0 = unknown) */
+    int video_fps_den;
+    int64_t video_start_pts90;  /* first video PTS (90 kHz), AV_NOPTS_VALUE if unknown */
+    SubEncodeConfig sub_encode_cfg; /* per-track canvas for render-worker encoding */
+    SubEncodeBench depth_bench; /* --bench palette-depth encoders for inline encodes */
+    ContactSheet *sheets[8];    /* --png-sheet: one sheet per track, NULL until first cue */
+    LineBreaker *line_breaker;  /* parse-time SRT wrapping; freed once tracks are parsed */
+    int argc;                   /* command line, part of the --prerender spool key */
+    char **argv;
 };
 
 static void ctx_cleanup(struct MainCtx *ctx);
@@ -449,6 +474,32 @@ static int cli_parse(int argc, char **argv,
         {"png-only", no_argument, 0, 1025},
         {"overwrite", required_argument, 0, 1032},
         {"no-preserve-pids", no_argument, 0, 1031},
+        {"render-daemon", required_argument, 0, 1033},
+        {"daemon-clients", required_argument, 0, 1034},
+        {"frame-snap", required_argument, 0, 1035},
+        {"fps-convert", required_argument, 0, 1036},
+        {"prerender", no_argument, 0, 1037},
+        {"prerender-spool", required_argument, 0, 1038},
+        {"glyph-atlas", no_argument, 0, 1039},
+        {"effects", required_argument, 0, 1030},
+        {"png-level", required_argument, 0, 1040},
+        {"png-filter", required_argument, 0, 1041},
+        {"png-threads", required_argument, 0, 1042},
+        {"png-cairo", no_argument, 0, 1043},
+        {"png-sheet", no_argument, 0, 1044},
+        {"png-sheet-size", required_argument, 0, 1045},
+        {"no-adaptive-depth", no_argument, 0, 1046},
+        {"colorimetry", required_argument, 0, 1047},
+        {"no-line-balance", no_argument, 0, 1048},
+        {"log-sync", no_argument, 0, 1049},
+        {"log-format", required_argument, 0, 1050},
+        {"log-rate", required_argument, 0, 1051},
+        {"qc-format", required_argument, 0, 1052},
+        {"qc-report", required_argument, 0, 1053},
+        {"qc-cross", no_argument, 0, 1054},
+        {"auto-delay", no_argument, 0, 1055},
+        {"auto-delay-window", required_argument, 0, 1056},
+        {"deterministic", no_argument, 0, 1057},
         {"license", no_argument, 0, 1017},
         {"help", no_argument, 0, 'h'},
         {"?", no_argument, 0, '?'},
@@ -886,6 +937,203 @@ static int cli_parse(int argc, char **argv,
                 LOG(1, "Disabled PID preservation; libav will assign output PIDs (unless --pid overrides)\n");
             }
             break;
+        case 1033:
+            if (validate_path_length(optarg, "daemon socket") != 0)
+                return 1;
+            if (replace_strdup((const char **)&render_daemon_socket, optarg) != 0) {
+                LOG(0, "Out of memory while setting daemon socket path\n");
+                return 1;
+            }
+            break;
+        case 1034:
+        {
+            char *endptr = NULL;
+            long n = strtol(optarg, &endptr, 10);
+            if (endptr == optarg || *endptr != '\0' || n < 1 || n > 1024) {
+                LOG(0, "Invalid --daemon-clients value '%s' (expected 1..1024)\n", optarg);
+                return 1;
+            }
+            render_daemon_clients = (int)n;
+            break;
+        }
+        case 1035:
+        {
+            FrameSnapMode mode;
+            if (frame_snap_mode_parse(optarg, &mode) != 0) {
+                LOG(0, "Invalid --frame-snap value '%s' (expected off|nearest|floor|ceil)\n", optarg);
+                return 1;
+            }
+            frame_snap_mode = (int)mode;
+            break;
+        }
+        case 1036:
+        {
+            FrameRate src, dst;
+            if (frame_rate_conversion_parse(optarg, &src, &dst) != 0) {
+                LOG(0, "Invalid --fps-convert value '%s' (expected SRC:DST, e.g. 23.976:25)\n", optarg);
+                return 1;
+            }
+            if (replace_strdup((const char **)&fps_convert_spec, optarg) != 0) {
+                LOG(0, "Out of memory while setting --fps-convert\n");
+                return 1;
+            }
+            break;
+        }
+        case 1037:
+            prerender_mode = 1;
+            break;
+        case 1038:
+            if (validate_path_length(optarg, "spool path") != 0)
+                return 1;
+            if (replace_strdup((const char **)&prerender_spool_path, optarg) != 0) {
+                LOG(0, "Out of memory while setting --prerender-spool\n");
+                return 1;
+            }
+            prerender_mode = 1;
+            break;
+        case 1039:
+            glyph_atlas = 1;
+            break;
+        case 1046:
+            no_adaptive_depth = 1;
+            break;
+        case 1048:
+            no_line_balance = 1;
+            break;
+        case 1049:
+            log_sync = 1;
+            break;
+        case 1050:
+        {
+            LogFormat lf;
+            if (log_format_parse(optarg, &lf) != 0) {
+                LOG(0, "Invalid --log-format value '%s' (expected text|json)\n", optarg);
+                return 1;
+            }
+            log_format = (int)lf;
+            break;
+        }
+        case 1052:
+        {
+            QCReportFormat qf;
+            if (qc_report_format_parse(optarg, &qf) != 0) {
+                LOG(0, "Invalid --qc-format value '%s' (expected text|csv|jsonl|sarif)\n", optarg);
+                return 1;
+            }
+            qc_format = (int)qf;
+            break;
+        }
+        case 1054:
+            qc_cross = 1;
+            break;
+        case 1055:
+            auto_delay = 1;
+            break;
+        case 1056:
+        {
+            char *end = NULL;
+            long v = strtol(optarg, &end, 10);
+            if (!end || *end != '\0' || v < 30 || v > 7200) {
+                LOG(0, "Invalid --auto-delay-window value '%s' (expected 30..7200 seconds)\n", optarg);
+                return 1;
+            }
+            auto_delay_seconds = (int)v;
+            break;
+        }
+        case 1057:
+            deterministic = 1;
+            break;
+        case 1053:
+            if (validate_path_length(optarg, "QC report path") != 0)
+                return 1;
+            if (replace_strdup((const char **)&qc_report_path, optarg) != 0) {
+                LOG(0, "Out of memory while setting --qc-report\n");
+                return 1;
+            }
+            break;
+        case 1051:
+        {
+            char *end = NULL;
+            long v = strtol(optarg, &end, 10);
+            if (!end || *end || v < 0 || v > 1000000) {
+                LOG(0, "Invalid --log-rate value '%s' (expected messages per second, 0 = unlimited)\n", optarg);
+                return 1;
+            }
+            log_rate = (int)v;
+            break;
+        }
+        case 1047:
+        {
+            ClutColorimetry cm;
+            if (clut_colorimetry_parse(optarg, &cm) != 0) {
+                LOG(0, "Invalid --colorimetry value '%s' (expected bt601|bt709|auto)\n", optarg);
+                return 1;
+            }
+            colorimetry = (int)cm;
+            break;
+        }
+        case 1030:
+        {
+            RenderEffectsMode mode;
+            if (render_effects_mode_parse(optarg, &mode) != 0) {
+                LOG(0, "Invalid --effects value '%s' (expected cairo|morph|auto)\n", optarg);
+                return 1;
+            }
+            effects_mode = (int)mode;
+            break;
+        }
+        case 1040:
+        {
+            char *end = NULL;
+            long v = strtol(optarg, &end, 10);
+            if (!end || *end || v < 0 || v > 9) {
+                LOG(0, "Invalid --png-level value '%s' (expected 0-9)\n", optarg);
+                return 1;
+            }
+            png_level = (int)v;
+            break;
+        }
+        case 1041:
+        {
+            PngFilterStrategy f;
+            if (png_filter_parse(optarg, &f) != 0) {
+                LOG(0, "Invalid --png-filter value '%s' (expected none|sub|up|paeth|adaptive)\n", optarg);
+                return 1;
+            }
+            png_filter = (int)f;
+            break;
+        }
+        case 1042:
+        {
+            char *end = NULL;
+            long v = strtol(optarg, &end, 10);
+            if (!end || *end || v < 0 || v > 16) {
+                LOG(0, "Invalid --png-threads value '%s' (expected 0-16, 0=auto)\n", optarg);
+                return 1;
+            }
+            png_threads = v == 0 ? get_cpu_count() : (int)v;
+            break;
+        }
+        case 1043:
+            png_cairo = 1;
+            break;
+        case 1044:
+            png_sheet = 1;
+            break;
+        case 1045:
+        {
+            int sw = 0, sh = 0;
+            char tail = 0;
+            if (sscanf(optarg, "%dx%d%c", &sw, &sh, &tail) != 2 ||
+                sw < 64 || sh < 64 || sw > 16384 || sh > 16384) {
+                LOG(0, "Invalid --png-sheet-size value '%s' (expected WxH, 64-16384)\n", optarg);
+                return 1;
+            }
+            png_sheet_w = sw;
+            png_sheet_h = sh;
+            png_sheet = 1;
+            break;
+        }
         case 1017:
             print_license();
             return 0;
@@ -918,12 +1166,22 @@ static int cli_parse(int argc, char **argv,
         }
     }
 
+    /* Render daemon mode takes its work from the socket; no files are needed. */
+    if (render_daemon_socket)
+        return -1;
+
     /* In QC-only or PNG-only mode, input/output files are not needed; only SRT and languages */
     if (*qc_only || png_only) {
         if (!*srt_list || !*lang_list) {
             print_usage();
             return 1;
         }
+    } else if (auto_delay) {
+        /* Delay analysis reads the input's audio; nothing is written. */
+        if (!*input || !*srt_list || !*lang_list) {
+            print_usage();
+            return 1;
+        }
     } else {
         /* Normal encoding mode requires all four: input, output, srt_list, lang_list */
         if (!*input || !*output || !*srt_list || !*lang_list) {
@@ -1055,6 +1313,31 @@ static int ctx_init(struct MainCtx *ctx,
             first_audio_index = i;
     }
 
+    if (colorimetry == CLUT_COLORIMETRY_AUTO) {
+        int matrix = video_index >= 0 ? in_fmt->streams[video_index]->codecpar->color_space : -1;
+        ClutColorimetry cm = clut_colorimetry_for_video(matrix, *video_h);
+        dvb_sub_set_colorimetry(cm);
+        LOG(1, "CLUT colorimetry: %s (video matrix=%d height=%d)\n",
+            clut_colorimetry_name(cm), matrix, *video_h);
+    }
+
+    ctx->video_index = video_index;
+    ctx->video_fps_num = 0;
+    ctx->video_fps_den = 1;
+    ctx->video_start_pts90 = AV_NOPTS_VALUE;
+    if (video_index >= 0) {
+        AVStream *vst = in_fmt->streams[video_index];
+        AVRational fr = vst->avg_frame_rate;
+        if (fr.num <= 0 || fr.den <= 0)
+            fr = vst->r_frame_rate;
+        if (fr.num > 0 && fr.den > 0) {
+            ctx->video_fps_num = fr.num;
+            ctx->video_fps_den = fr.den;
+        }
+        if (vst->start_time != AV_NOPTS_VALUE)
+            ctx->video_start_pts90 = av_rescale_q(vst->start_time, vst->time_base, (AVRational){1, 90000});
+    }
+
     if (in_fmt->start_time != AV_NOPTS_VALUE) {
         *input_start_pts90_out = av_rescale_q(in_fmt->start_time, AV_TIME_BASE_Q, (AVRational){1, 90000});
     } else if (video_index >= 0 && in_fmt->streams[video_index]->start_time != AV_NOPTS_VALUE) {
@@ -1067,6 +1350,8 @@ static int ctx_init(struct MainCtx *ctx,
     if (debug_level > 0) {
         LOG(1, "input_start_pts90=%lld (video_index=%d)\n", (long long)*input_start_pts90_out, video_index);
         LOG(1, "Discovered video size: %dx%d\n", *video_w, *video_h);
+        if (ctx->video_fps_num > 0)
+            LOG(1, "Discovered video frame rate: %d/%d\n", ctx->video_fps_num, ctx->video_fps_den);
     }
 
     AVFormatContext *out_fmt = NULL;
@@ -1443,7 +1728,7 @@ static int apply_custom_pids(const SubTrack tracks[], int ntracks,
  *   qc               - Quality control file handle for parser output
  *   cli_fontsize     - Font size for ASS rendering
  *   cli_font         - Font name for ASS rendering
- *   cli_font_style   - Font style for ASS rendering (processed during render)
+ *   cli_font_style   - Font style (measured SRT line breaking; applied during render)
  *   cli_fgcolor      - Foreground color for ASS rendering
  *   cli_outlinecolor - Outline color for ASS rendering
  *   cli_shadowcolor  - Shadow color for ASS rendering
@@ -1476,7 +1761,6 @@ static int ctx_parse_tracks(struct MainCtx *ctx,
                                  int enc_threads)
 {
     int ret = 0;
-    (void)cli_font_style; /* current parsing path forwards style later during render */
     while (tok && tok_lang && *ntracks < 8) {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
@@ -1553,7 +1837,20 @@ static int ctx_parse_tracks(struct MainCtx *ctx,
                 .warn_on_short_duration = 1,
                 .warn_on_long_duration = 1
             };
-            
+
+            /* Wrap cues by measured width with the font the Pango renderer
+             * uses, so layouts keep the parsed lines. */
+            if (!no_line_balance && !ctx->line_breaker) {
+                ctx->line_breaker = render_pango_line_breaker_create(cli_font, cli_font_style, cli_fontsize,
+                                                                     video_w > 0 ? video_w : 1920,
+                                                                     video_h > 0 ? video_h : 1080);
+                if (ctx->line_breaker)
+                    render_pango_set_prebroken(1);
+                else
+                    LOG(1, "Warning: measured line breaking unavailable; wrapping cues by character count\n");
+            }
+            cfg.line_breaker = ctx->line_breaker;
+
             int64_t t0 = bench_now();
             int count = parse_srt_cfg(tok, &tracks[*ntracks].entries, qc, &cfg);
             if (bench_mode) {
@@ -1737,7 +2034,13 @@ static int ctx_parse_tracks(struct MainCtx *ctx,
         tracks[*ntracks].codec_ctx->width = video_w;
         tracks[*ntracks].codec_ctx->height = video_h;
 
-        if (enc_threads <= 0)
+        if (deterministic)
+        {
+            /* Same setup as the render workers' encoders (sub_encode.c). */
+            tracks[*ntracks].codec_ctx->thread_count = 1;
+            tracks[*ntracks].codec_ctx->flags |= AV_CODEC_FLAG_BITEXACT;
+        }
+        else if (enc_threads <= 0)
             tracks[*ntracks].codec_ctx->thread_count = get_cpu_count();
         else
             tracks[*ntracks].codec_ctx->thread_count = enc_threads;
@@ -1768,11 +2071,467 @@ static int ctx_parse_tracks(struct MainCtx *ctx,
         tok = strtok_r(NULL, ",", save_srt);
         tok_lang = strtok_r(NULL, ",", save_lang);
     }
+    if (ctx->line_breaker) {
+        long hits = 0, misses = 0;
+        line_breaker_stats(ctx->line_breaker, &hits, &misses);
+        LOG(2, "Line breaking: %ld cached advances, %ld measured\n", hits, misses);
+        line_breaker_destroy(ctx->line_breaker);
+        ctx->line_breaker = NULL;
+    }
+    return 0;
+}
+
+/*
+ * ctx_apply_frame_timing
+ *
+ * Frame-accurate timing stage, run once after all tracks are parsed.
+ * Applies the optional --fps-convert rescale and --frame-snap grid
+ * snapping while building each track's CueTimeline, which keeps the
+ * snapped times in 90 kHz ticks for the demux loop (entries get rounded
+ * milliseconds for durations only). When the video
+ * frame rate is unknown (png-only mode) only the conversion applies.
+ *
+ * Returns 0 on success, -1 on allocation failure.
+ */
+static int ctx_apply_frame_timing(struct MainCtx *ctx, SubTrack tracks[], int ntracks,
+                                  int64_t input_start_pts90)
+{
+    FrameTiming ft;
+    memset(&ft, 0, sizeof(ft));
+    ft.mode = (FrameSnapMode)frame_snap_mode;
+    if (ft.mode != FRAME_SNAP_OFF && ctx->video_fps_num > 0) {
+        ft.grid.num = ctx->video_fps_num;
+        ft.grid.den = ctx->video_fps_den;
+        if (ctx->video_start_pts90 != AV_NOPTS_VALUE)
+            ft.origin90 = ctx->video_start_pts90 - input_start_pts90;
+    } else if (ft.mode != FRAME_SNAP_OFF) {
+        LOG(1, "--frame-snap requested but video frame rate is unknown; snapping disabled\n");
+    }
+    if (fps_convert_spec &&
+        frame_rate_conversion_parse(fps_convert_spec, &ft.conv_src, &ft.conv_dst) != 0) {
+        ft.conv_src.num = 0;
+    }
+
+    for (int t = 0; t < ntracks; t++) {
+        if (tracks[t].count <= 0)
+            continue;
+        int changed = cue_timeline_build(&tracks[t].timeline, &ft, tracks[t].entries,
+                                         tracks[t].count, tracks[t].effective_delay_ms,
+                                         input_start_pts90);
+        if (changed < 0) {
+            LOG(0, "Out of memory building cue timeline for track %d\n", t);
+            return -1;
+        }
+        if (changed > 0 && ctx->debug_level > 0)
+            LOG(1, "Frame timing: adjusted %d of %d cues on track %d (%s)\n",
+                changed, tracks[t].count, t, tracks[t].filename);
+    }
     return 0;
 }
 
+/*
+ * ctx_build_stream_classes
+ *
+ * Classify every input stream (see stream_class.h) and precompute its
+ * 90 kHz rescale factor. Overwrite targets are resolved by then.
+ * When the input has a video stream it is the only clock; otherwise
+ * every non-dropped stream keeps driving the scheduler as before.
+ * Returns a malloc'd array of in_fmt->nb_streams entries or NULL.
+ */
+static StreamClass *ctx_build_stream_classes(const struct MainCtx *ctx)
+{
+    const AVFormatContext *in_fmt = ctx->in_fmt;
+    StreamClass *sc = calloc(in_fmt->nb_streams ? in_fmt->nb_streams : 1, sizeof(*sc));
+    if (!sc)
+        return NULL;
+
+    for (unsigned i = 0; i < in_fmt->nb_streams; i++) {
+        const AVStream *st = in_fmt->streams[i];
+        StreamClassKind kind;
+        if (is_overwrite_stream(ctx, (int)i))
+            kind = STREAM_CLASS_DROP;
+        else if (ctx->video_index < 0 || (int)i == ctx->video_index)
+            kind = STREAM_CLASS_CLOCK;
+        else
+            kind = STREAM_CLASS_PASS;
+        stream_class_init(&sc[i], kind, st->time_base.num, st->time_base.den);
+        if (ctx->debug_level > 1)
+            LOG(2, "[demux] stream %u class=%s tb=%d/%d\n", i, stream_class_name(kind),
+                st->time_base.num, st->time_base.den);
+    }
+    return sc;
+}
+
+/*
+ * ctx_mux_input_packet
+ *
+ * Write a demuxed input packet to the mirrored output stream. The caller
+ * still owns `pkt` and must unref it. No-op in PNG-only mode.
+ */
+static void ctx_mux_input_packet(struct MainCtx *ctx, AVPacket *pkt, int bench_mode)
+{
+    if (png_only)
+        return;
+    AVStream *out_st = ctx->out_fmt->streams[pkt->stream_index];
+    if (!out_st) {
+        LOG(2, "output stream %d is NULL, skipping packet\n", pkt->stream_index);
+        return;
+    }
+    pkt->stream_index = out_st->index;
+
+    int64_t t5 = bench_now();
+    int mux_ret = safe_av_interleaved_write_frame(ctx->out_fmt, pkt);
+    if (bench_mode)
+    {
+        int64_t delta_mux = bench_now() - t5;
+        bench_add_mux_us(delta_mux);
+        if (mux_ret >= 0)
+            bench_inc_packets_muxed();
+    }
+}
+
+/*
+ * tracks_next_due90
+ *
+ * Global "next event" watermark for the demux loop: the smallest due
+ * time of any track's next cue, or CUE_TIMELINE_NONE once every track is
+ * exhausted. A track with pending cues but no timeline yields INT64_MIN
+ * so the loop falls back to checking it on every packet.
+ */
+static int64_t tracks_next_due90(const SubTrack tracks[], int ntracks)
+{
+    int64_t next = CUE_TIMELINE_NONE;
+    for (int t = 0; t < ntracks; t++) {
+        int64_t due;
+        if (tracks[t].timeline.due90)
+            due = cue_timeline_next_due(&tracks[t].timeline, tracks[t].cur_sub);
+        else
+            due = (tracks[t].cur_sub < tracks[t].count) ? INT64_MIN : CUE_TIMELINE_NONE;
+        if (due < next)
+            next = due;
+    }
+    return next;
+}
+
+/*
+ * track_cue_markup
+ *
+ * Pango markup for cue `i`, converted once and cached on the track so the
+ * prefetch window, the consumer and the render jobs all share one string.
+ * Returns NULL when the conversion fails (rendered as an empty cue).
+ */
+static const char *track_cue_markup(SubTrack *track, int i)
+{
+    if (!track->markup) {
+        track->markup = calloc((size_t)track->count, sizeof(*track->markup));
+        if (!track->markup)
+            return NULL;
+    }
+    if (!track->markup[i])
+        track->markup[i] = srt_to_pango_markup(track->entries[i].text);
+    return track->markup[i];
+}
+
+/*
+ * cue_pos_config
+ *
+ * Position for a cue: its parse-time {\anX} alignment when it has one,
+ * otherwise the track's configured placement. `tmp` holds the former.
+ */
+static SubtitlePositionConfig *cue_pos_config(const SRTEntry *e, int t,
+                                              SubtitlePositionConfig *tmp)
+{
+    if (e->alignment_tag && ass_alignment_apply(e->alignment, tmp) == 0)
+        return tmp;
+    return &sub_pos_configs[t];
+}
+
+/*
+ * ctx_prefetch_cue
+ *
+ * Queue cue `qi` of track `t` on the render pool. With `encode` set the
+ * worker also produces the DVB payload (see sub_encode.h). Out-of-range
+ * cues are ignored; submission failures are left for the consumer to
+ * handle with a synchronous render.
+ */
+static void ctx_prefetch_cue(struct MainCtx *ctx, SubTrack tracks[], int t, int qi,
+                             int render_w, int render_h, int cli_fontsize,
+                             double sub_position_pct, int encode)
+{
+    if (qi < 0 || qi >= tracks[t].count)
+        return;
+    const SRTEntry *e = &tracks[t].entries[qi];
+    int align = e->alignment;
+    if (align >= 7 && align <= 9)
+        align -= 6; /* 7->1,8->2,9->3 */
+    SubtitlePositionConfig cue_pos;
+    /* Markup and style strings outlive the pool, so the job borrows them. */
+    render_pool_ctx_submit_ref(NULL, t, qi, track_cue_markup(&tracks[t], qi),
+                               render_w, render_h,
+                               cli_fontsize, ctx->cli_font,
+                               ctx->cli_font_style,
+                               ctx->cli_fgcolor, ctx->cli_outlinecolor,
+                               ctx->cli_shadowcolor, ctx->cli_bgcolor,
+                               align, sub_position_pct,
+                               cue_pos_config(e, t, &cue_pos),
+                               ctx->palette_mode,
+                               encode, e->end_ms - e->start_ms);
+}
+
+/* Absolute display PTS of cue `i`, as stamped on its DVB packet. */
+static int64_t track_cue_start90(const SubTrack *track, int i, int64_t input_start_pts90)
+{
+    return track->timeline.start90
+               ? track->timeline.start90[i]
+               : input_start_pts90 + (track->entries[i].start_ms + track->effective_delay_ms) * 90;
+}
+
+/* FNV-1a over `len` bytes, continuing from `h`. */
+static uint64_t spool_key_mix(uint64_t h, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ p[i]) * 1099511628211ULL;
+    return h;
+}
+
+/*
+ * ctx_spool_key
+ *
+ * Fingerprint of a --prerender run: the command line (fonts, colours,
+ * palette, positions, ...), each track's canvas and every cue's text,
+ * alignment and timing. A kept spool is reused only when this matches.
+ * The output path is left out so a spool can be remuxed into a new file.
+ */
+static uint64_t ctx_spool_key(const struct MainCtx *ctx, SubTrack tracks[], int ntracks,
+                              const int *render_w, const int *render_h,
+                              int64_t input_start_pts90)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (int i = 0; i < ctx->argc; i++)
+    {
+        const char *a = ctx->argv[i];
+        if (!a)
+            continue;
+        if (strcmp(a, "-o") == 0 || strcmp(a, "--output") == 0)
+        {
+            i++;
+            continue;
+        }
+        if (strncmp(a, "-o", 2) == 0 || strncmp(a, "--output=", 9) == 0)
+            continue;
+        h = spool_key_mix(h, a, strlen(a) + 1);
+    }
+    for (int t = 0; t < ntracks && t < 8; t++)
+    {
+        int dims[3] = { tracks[t].count, render_w[t], render_h[t] };
+        h = spool_key_mix(h, dims, sizeof(dims));
+        for (int i = 0; i < tracks[t].count; i++)
+        {
+            const SRTEntry *e = &tracks[t].entries[i];
+            int64_t cue[3] = { track_cue_start90(&tracks[t], i, input_start_pts90),
+                               e->end_ms, e->alignment_tag ? e->alignment : 0 };
+            h = spool_key_mix(h, cue, sizeof(cue));
+            if (e->text)
+                h = spool_key_mix(h, e->text, strlen(e->text) + 1);
+        }
+    }
+    return h;
+}
+
+/*
+ * ctx_reuse_spool
+ *
+ * Map a spool kept by an earlier run with --prerender-spool PATH and keep
+ * it when its key and track layout match this run. Returns NULL when
+ * there is nothing usable (the caller then renders a fresh spool).
+ */
+static PrerenderSpool *ctx_reuse_spool(SubTrack tracks[], int ntracks, uint64_t key)
+{
+    if (!prerender_spool_path || access(prerender_spool_path, R_OK) != 0)
+        return NULL;
+    PrerenderSpool *spool = prerender_spool_open(prerender_spool_path);
+    int match = spool && prerender_spool_key(spool) == key &&
+                prerender_spool_track_count(spool) == ntracks;
+    for (int t = 0; match && t < ntracks; t++)
+        match = prerender_spool_cue_count(spool, t) == tracks[t].count;
+    if (!match)
+    {
+        if (spool)
+            LOG(1, "spool %s was made with other settings or cues; pre-rendering again\n",
+                prerender_spool_path);
+        prerender_spool_close(spool);
+        return NULL;
+    }
+    LOG(1, "reusing pre-rendered spool %s (%llu bytes)\n", prerender_spool_path,
+        (unsigned long long)prerender_spool_payload_bytes(spool));
+    return spool;
+}
+
+/*
+ * ctx_prerender_spool
+ *
+ * First pass of --prerender: fan every cue of every track out over the
+ * render pool (render + DVB encode in the workers) and append the
+ * payloads to a spool in index order, keeping `window` jobs queued
+ * ahead of the one being collected. The finished spool is mapped
+ * read-only for the remux pass. Cues that fail to render or encode are
+ * simply absent from the spool and take the live path later. A spool
+ * kept with --prerender-spool by an identical earlier run is reused
+ * instead (see ctx_spool_key()).
+ *
+ * Returns the mapped spool, or NULL on error (logged; the caller then
+ * runs the normal single-pass loop).
+ */
+static PrerenderSpool *ctx_prerender_spool(struct MainCtx *ctx, SubTrack tracks[], int ntracks,
+                                           int video_w, int video_h, int cli_fontsize,
+                                           double sub_position_pct, int64_t input_start_pts90)
+{
+    int counts[8] = {0};
+    int render_w[8], render_h[8];
+    long total = 0;
+    for (int t = 0; t < ntracks && t < 8; t++)
+    {
+        counts[t] = tracks[t].count;
+        total += tracks[t].count;
+        render_w[t] = video_w > 0 ? video_w : 1920;
+        render_h[t] = video_h > 0 ? video_h : 1080;
+        if (tracks[t].codec_ctx && tracks[t].codec_ctx->width > 0)
+            render_w[t] = tracks[t].codec_ctx->width;
+        if (tracks[t].codec_ctx && tracks[t].codec_ctx->height > 0)
+            render_h[t] = tracks[t].codec_ctx->height;
+    }
+
+    uint64_t key = ctx_spool_key(ctx, tracks, ntracks, render_w, render_h, input_start_pts90);
+    PrerenderSpool *spool = ctx_reuse_spool(tracks, ntracks, key);
+    if (spool)
+        return spool;
+    spool = prerender_spool_create(prerender_spool_path, ntracks, counts, key);
+    if (!spool)
+        return NULL;
 
+    int64_t t0 = bench_now();
+    int window = ctx->render_threads * 4;
+    if (window < 8)
+        window = 8;
+    if (window > 512)
+        window = 512; /* render pool queue holds 1024 jobs */
+
+    /* Submission cursor (sub_t, sub_q) runs up to `window` cues ahead of
+     * the collection cursor (t, qi); both walk tracks in index order. */
+    int sub_t = 0, sub_q = 0, inflight = 0;
+    long spooled = 0;
+    for (int t = 0; t < ntracks && !stop_requested; t++)
+    {
+        for (int qi = 0; qi < tracks[t].count && !stop_requested; qi++)
+        {
+            while (inflight < window && sub_t < ntracks)
+            {
+                if (sub_q >= tracks[sub_t].count)
+                {
+                    sub_t++;
+                    sub_q = 0;
+                    continue;
+                }
+                ctx_prefetch_cue(ctx, tracks, sub_t, sub_q, render_w[sub_t], render_h[sub_t],
+                                 cli_fontsize, sub_position_pct, 1);
+                sub_q++;
+                inflight++;
+            }
 
+            Bitmap bm = {0};
+            RenderPayload payload = {0};
+            if (render_pool_ctx_wait_payload(NULL, t, qi, &bm, &payload) == 1 && payload.data)
+            {
+                int64_t pts90 = track_cue_start90(&tracks[t], qi, input_start_pts90);
+                if (prerender_spool_append(spool, t, qi, pts90, payload.data, payload.size) == 0)
+                    spooled++;
+            }
+            inflight--;
+            if (payload.data)
+                av_free(payload.data);
+            if (bm.idxbuf)
+                av_free(bm.idxbuf);
+            if (bm.palette)
+                av_free(bm.palette);
+        }
+    }
+
+    if (stop_requested || prerender_spool_finish(spool) != 0)
+    {
+        prerender_spool_close(spool);
+        return NULL;
+    }
+
+    int64_t elapsed = bench_now() - t0;
+    if (ctx->bench_mode)
+    {
+        bench_add_render_us(elapsed);
+        for (long i = 0; i < spooled; i++)
+            bench_inc_cues_rendered();
+    }
+    LOG(1, "pre-rendered %ld/%ld cues into %s (%llu bytes) in %.3f s\n",
+        spooled, total, prerender_spool_path ? prerender_spool_path : "temporary spool",
+        (unsigned long long)prerender_spool_payload_bytes(spool), elapsed / 1e6);
+    return spool;
+}
+
+/*
+ * ctx_save_cue_png
+ *
+ * Save one rendered cue for preview: appended to the track's contact
+ * sheet with --png-sheet, otherwise written as its own PNG. `pngfn`
+ * receives the per-cue file name, or stays empty for sheets.
+ */
+static void ctx_save_cue_png(struct MainCtx *ctx, SubTrack tracks[], int t,
+                             const Bitmap *bm, const char *tag,
+                             char *pngfn, size_t pngfn_len)
+{
+    const SRTEntry *e = &tracks[t].entries[tracks[t].cur_sub];
+    if (png_sheet && t >= 0 && t < (int)(sizeof(ctx->sheets) / sizeof(ctx->sheets[0]))) {
+        if (!ctx->sheets[t]) {
+            ctx->sheets[t] = contact_sheet_open(get_png_output_dir(), t, tracks[t].lang,
+                                                png_sheet_w, png_sheet_h,
+                                                &(PngWriterOptions){ png_level, png_filter, png_threads });
+            if (!ctx->sheets[t]) {
+                LOG(0, "[%s] cannot create contact sheet index for track %d in %s\n",
+                    tag, t, get_png_output_dir());
+                png_sheet = 0;
+                return;
+            }
+        }
+        if (contact_sheet_add(ctx->sheets[t], tracks[t].cur_sub,
+                              e->start_ms + tracks[t].effective_delay_ms,
+                              e->end_ms + tracks[t].effective_delay_ms, e->text,
+                              bm->idxbuf, bm->w, bm->h, bm->palette,
+                              bm->nb_colors > 0 ? bm->nb_colors : 16, bm->x, bm->y) != 0)
+            LOG(0, "[%s] failed to write contact sheet page for track %d\n", tag, t);
+        return;
+    }
+    if (make_png_filename(pngfn, pngfn_len, __srt_png_seq++, t, tracks[t].cur_sub) == 0) {
+        save_bitmap_png(bm, pngfn);
+        if (ctx->debug_level > 1) {
+            LOG(2, "[%s] SRT bitmap saved: %s (x=%d y=%d w=%d h=%d)\n",
+                tag, pngfn, bm->x, bm->y, bm->w, bm->h);
+        }
+    }
+}
+
+/*
+ * ctx_close_sheets
+ *
+ * Write the last page and JSON index of every open contact sheet.
+ */
+static void ctx_close_sheets(struct MainCtx *ctx)
+{
+    for (size_t t = 0; t < sizeof(ctx->sheets) / sizeof(ctx->sheets[0]); t++) {
+        if (!ctx->sheets[t])
+            continue;
+        if (contact_sheet_close(ctx->sheets[t]) != 0)
+            LOG(0, "Failed to finish contact sheet for track %zu in %s\n", t, get_png_output_dir());
+        ctx->sheets[t] = NULL;
+    }
+}
 
 /*
  * ctx_demux_mux_loop
@@ -1828,11 +2587,56 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
             total_duration_pts90 = dur90;
     }
 
+    /* Earliest due time across all tracks. Packets whose PTS is below it
+     * cannot trigger any cue, so the per-track loop is skipped. Tracks
+     * without a built timeline force the loop on every packet. */
+    int64_t next_due90 = tracks_next_due90(tracks, ntracks);
+
+    StreamClass *stream_classes = ctx_build_stream_classes(ctx);
+    if (!stream_classes) {
+        LOG(0, "Out of memory building stream class table\n");
+        return -1;
+    }
+    unsigned nb_stream_classes = in_fmt->nb_streams;
+    int64_t demux_t0 = bench_now();
+
+    /* Let render workers encode the DVB payload too, so the mux thread
+     * only stamps PTS and writes (libass frames are still encoded here). */
+    int worker_encode = (render_threads > 0 && !png_only && !use_ass);
+    if (worker_encode)
+    {
+        memset(&ctx->sub_encode_cfg, 0, sizeof(ctx->sub_encode_cfg));
+        for (int t = 0; t < ntracks && t < SUB_ENCODE_MAX_TRACKS; t++)
+        {
+            if (tracks[t].codec_ctx)
+            {
+                ctx->sub_encode_cfg.width[t] = tracks[t].codec_ctx->width;
+                ctx->sub_encode_cfg.height[t] = tracks[t].codec_ctx->height;
+            }
+        }
+        ctx->sub_encode_cfg.bench_mode = bench_mode;
+        ctx->sub_encode_cfg.bitexact = deterministic;
+        render_pool_ctx_set_encoder(NULL, sub_encode_worker_hook, sub_encode_worker_release,
+                                    &ctx->sub_encode_cfg);
+    }
+
+    /* --prerender: render and encode every cue up front, then splice the
+     * payloads from the mapped spool while remuxing. */
+    PrerenderSpool *spool = NULL;
+    if (prerender_mode)
+    {
+        if (worker_encode)
+            spool = ctx_prerender_spool(ctx, tracks, ntracks, video_w, video_h,
+                                        cli_fontsize, sub_position_pct, input_start_pts90);
+        else
+            LOG(1, "--prerender needs render workers and the Pango renderer; using the single-pass loop\n");
+    }
+
     while (av_read_frame(in_fmt, pkt) >= 0)
     {
         if (stop_requested)
         {
-            if (debug_level > 0)
+            if (LOG_ENABLED(1))
                 LOG(1, "stop requested (signal), breaking demux loop\n");
             av_packet_unref(pkt);
             break;
@@ -1853,15 +2657,26 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
             continue;
         }
 
-        if (is_overwrite_stream(ctx, pkt->stream_index)) {
-            if (debug_level > 1) {
+        /* Streams added after probing have no class entry and take the
+         * full clock path, matching the previous behaviour. */
+        const StreamClass *sc = ((unsigned)pkt->stream_index < nb_stream_classes)
+                                    ? &stream_classes[pkt->stream_index]
+                                    : NULL;
+        if (sc && sc->kind == STREAM_CLASS_DROP) {
+            if (LOG_ENABLED(2)) {
                 LOG(2, "[overwrite] dropping original packet from stream %d\n", pkt->stream_index);
             }
             av_packet_unref(pkt);
             continue;
         }
+        if (sc && sc->kind == STREAM_CLASS_PASS) {
+            ctx_mux_input_packet(ctx, pkt, bench_mode);
+            av_packet_unref(pkt);
+            continue;
+        }
 
-        int64_t cur90 = (pkt->pts == AV_NOPTS_VALUE) ? AV_NOPTS_VALUE : av_rescale_q(pkt->pts, in_fmt->streams[pkt->stream_index]->time_base, (AVRational){1, 90000});
+        int64_t cur90 = sc ? stream_class_to90(sc, pkt->pts)
+                           : ((pkt->pts == AV_NOPTS_VALUE) ? AV_NOPTS_VALUE : av_rescale_q(pkt->pts, in_fmt->streams[pkt->stream_index]->time_base, (AVRational){1, 90000}));
         if (cur90 != AV_NOPTS_VALUE)
             last_valid_cur90 = cur90;
         int64_t cmp90 = (cur90 != AV_NOPTS_VALUE) ? cur90 : last_valid_cur90;
@@ -1874,11 +2689,11 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                          input_start_pts90, last_valid_cur90, 1 /* use_pkt_count */);
         }
 
-        for (int t = 0; t < ntracks; t++)
+        for (int t = 0; t < ntracks && (LOG_ENABLED(3) || cmp90 >= next_due90); t++)
         {
-            if (debug_level > 2) {
+            if (LOG_ENABLED(3)) {
                 if (tracks[t].cur_sub < tracks[t].count) {
-                    int64_t next_pts90 = input_start_pts90 + ((tracks[t].entries[tracks[t].cur_sub].start_ms + tracks[t].effective_delay_ms) * 90);
+                    int64_t next_pts90 = track_cue_start90(&tracks[t], tracks[t].cur_sub, input_start_pts90);
                     LOG(3, "[diag] cur90=%lld next_cue_pts90=%lld (track=%d cur_sub=%d)\n", (long long)cur90, (long long)next_pts90, t, tracks[t].cur_sub);
                 } else {
                     LOG(3, "[diag] no more cues for track %d (cur_sub=%d count=%d)\n", t, tracks[t].cur_sub, tracks[t].count);
@@ -1886,14 +2701,35 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
             }
 
             while (tracks[t].cur_sub < tracks[t].count &&
-                   (((tracks[t].entries[tracks[t].cur_sub].start_ms +
-                      tracks[t].effective_delay_ms) *
-                     90)) <= cmp90)
+                   (tracks[t].timeline.due90
+                        ? tracks[t].timeline.due90[tracks[t].cur_sub]
+                        : ((tracks[t].entries[tracks[t].cur_sub].start_ms +
+                            tracks[t].effective_delay_ms) *
+                           90)) <= cmp90)
             {
                 Bitmap bm = {0};
-                if (!use_ass)
+                RenderPayload payload = {0};
+                const uint8_t *enc_data = NULL;
+                int enc_size = 0;
+                int64_t stall_t0 = bench_mode ? bench_now() : 0;
+                LOG_CONTEXT(t, tracks[t].cur_sub,
+                            track_cue_start90(&tracks[t], tracks[t].cur_sub, input_start_pts90));
+                int from_spool = spool &&
+                                 prerender_spool_get(spool, t, tracks[t].cur_sub,
+                                                     track_cue_start90(&tracks[t], tracks[t].cur_sub,
+                                                                       input_start_pts90),
+                                                     &enc_data, &enc_size);
+                if (from_spool)
                 {
-                    char *markup = srt_to_pango_markup(tracks[t].entries[tracks[t].cur_sub].text);
+                    if (LOG_ENABLED(2))
+                        LOG(2, "[spool] track=%d cue=%d spliced %d bytes\n", t, tracks[t].cur_sub, enc_size);
+                }
+                else if (!use_ass)
+                {
+                    const char *markup = track_cue_markup(&tracks[t], tracks[t].cur_sub);
+                    SubtitlePositionConfig cue_pos;
+                    SubtitlePositionConfig *pos = cue_pos_config(&tracks[t].entries[tracks[t].cur_sub],
+                                                                 t, &cue_pos);
                     int64_t t1 = bench_now();
                     int render_w = video_w > 0 ? video_w : 1920;
                     int render_h = video_h > 0 ? video_h : 1080;
@@ -1909,11 +2745,11 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                     if (!use_ass && cue_align >= 7 && cue_align <= 9)
                     {
                         used_align = cue_align - 6; /* 7->1,8->2,9->3 */
-                        if (debug_level > 0)
+                        if (LOG_ENABLED(1))
                             LOG(1, "[main-debug] remapping cue align %d -> %d for DVB render\n",
                                 cue_align, used_align);
                     }
-                    if (debug_level > 0)
+                    if (LOG_ENABLED(1))
                     {
                         LOG(1,
                             "about to render cue %d: render_w=%d render_h=%d codec_w=%d codec_h=%d video_w=%d video_h=%d align=%d used_align=%d\n",
@@ -1924,64 +2760,44 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                             video_w, video_h,
                             cue_align, used_align);
                     }
-                    if ((video_w <= 0 || video_h <= 0) && debug_level > 0)
+                    if ((video_w <= 0 || video_h <= 0) && LOG_ENABLED(1))
                     {
                         LOG(1, "Warning: video size unknown, using fallback %dx%d for rendering\n", render_w, render_h);
                     }
                     if (render_threads > 0)
                     {
+                        const int PREFETCH_WINDOW = 8;
+                        int cur = tracks[t].cur_sub;
                         Bitmap tmpb = {0};
-                        int got = render_pool_try_get(t, tracks[t].cur_sub, &tmpb);
-                        if (got == 1)
+                        int got = render_pool_ctx_try_get_payload(NULL, t, cur, &tmpb, &payload);
+                        if (got == -1)
                         {
-                            bm = tmpb; /* use the async result */
+                            for (int pi = 0; pi < PREFETCH_WINDOW; ++pi)
+                                ctx_prefetch_cue(ctx, tracks, t, cur + pi, render_w, render_h,
+                                                 cli_fontsize, sub_position_pct, worker_encode);
                         }
-                        else if (got == 0)
+                        /* An in-flight job is cheaper to wait for than to
+                         * render a second time. */
+                        if (got != 1)
+                            got = render_pool_ctx_wait_payload(NULL, t, cur, &tmpb, &payload);
+                        if (got == 1)
                         {
-                            bm = render_pool_render_sync(markup,
-                                                         render_w, render_h,
-                                                         cli_fontsize, cli_font,
-                                                         cli_font_style,
-                                                         cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
-                                                         &sub_pos_configs[t],
-                                                         palette_mode);
+                            bm = tmpb; /* use the async result */
                         }
                         else
                         {
-                            const int PREFETCH_WINDOW = 8;
-                            for (int pi = 0; pi < PREFETCH_WINDOW; ++pi)
-                            {
-                                int qi = tracks[t].cur_sub + pi;
-                                if (qi >= tracks[t].count)
-                                    break;
-                                char *pm = srt_to_pango_markup(tracks[t].entries[qi].text);
-                                render_pool_submit_async(t, qi,
-                                                         pm,
+                            /* submission failed (queue full or pool down) */
+                            bm = render_pool_render_sync(markup,
                                                          render_w, render_h,
                                                          cli_fontsize, cli_font,
                                                          cli_font_style,
                                                          cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
-                                                         used_align,
-                                                         sub_position_pct,
-                                                         &sub_pos_configs[t],
+                                                         pos,
                                                          palette_mode);
-                                free(pm);
-                            }
-                            if (render_pool_try_get(t, tracks[t].cur_sub, &tmpb) == 1)
-                            {
-                                bm = tmpb;
-                            }
-                            else
-                            {
-                                bm = render_pool_render_sync(markup,
-                                                             render_w, render_h,
-                                                             cli_fontsize, cli_font,
-                                                             cli_font_style,
-                                                             cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
-                                                             &sub_pos_configs[t],
-                                                             palette_mode);
-                            }
                         }
+                        /* Slide the prefetch window by one cue. */
+                        ctx_prefetch_cue(ctx, tracks, t, cur + PREFETCH_WINDOW, render_w, render_h,
+                                         cli_fontsize, sub_position_pct, worker_encode);
                     }
                     else
                     {
@@ -1990,7 +2806,7 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                                                cli_fontsize, cli_font,
                                                cli_font_style,
                                                cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
-                                               &sub_pos_configs[t],
+                                               pos,
                                                palette_mode);
                     }
                     if (bench_mode)
@@ -1999,7 +2815,6 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                         bench_add_render_us(delta);
                         bench_inc_cues_rendered();
                     }
-                    free(markup);
                 }
 #ifdef HAVE_LIBASS
                 else
@@ -2016,47 +2831,70 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                     }
                 }
 #endif
+                if (payload.data)
+                {
+                    enc_data = payload.data;
+                    enc_size = payload.size;
+                }
+                if (bench_mode)
+                    bench_add_mux_stall_us(bench_now() - stall_t0);
 
                 int track_delay_ms = tracks[t].effective_delay_ms;
                 char pngfn[PATH_MAX] = "";
-                if (png_only || debug_level > 1)
+                if ((png_only || debug_level > 1) && !from_spool)
                 {
-                    if (make_png_filename(pngfn, sizeof(pngfn), __srt_png_seq++, t, tracks[t].cur_sub) == 0) {
-                        save_bitmap_png(&bm, pngfn);
-                        if (debug_level > 1) {
-                            LOG(2, "[png] SRT bitmap saved: %s (x=%d y=%d w=%d h=%d)\n", pngfn, bm.x, bm.y, bm.w, bm.h);
-                        }
-                    }
-                    if (debug_level > 1) {
+                    ctx_save_cue_png(ctx, tracks, t, &bm, "png", pngfn, sizeof(pngfn));
+                    if (LOG_ENABLED(2)) {
                         if (tracks[t].cur_sub < tracks[t].count && tracks[t].entries[tracks[t].cur_sub].text) {
                             LOG(2, "[png] cue idx=%d text='%s'\n", tracks[t].cur_sub, tracks[t].entries[tracks[t].cur_sub].text);
                         }
                     }
                 }
-                if (debug_level > 0) {
+                if (LOG_ENABLED(1)) {
                     int64_t dbg_start_ms = tracks[t].entries[tracks[t].cur_sub].start_ms;
                     LOG(1, "rendered track=%d cue=%d start_ms=%d (delay=%d)\n", t, tracks[t].cur_sub, (int)dbg_start_ms, tracks[t].effective_delay_ms);
                 }
 
-                AVSubtitle *sub = make_subtitle(bm,
-                                                tracks[t].entries[tracks[t].cur_sub].start_ms,
-                                                tracks[t].entries[tracks[t].cur_sub].end_ms);
-                if (sub)
+                /* Cues encoded by a render worker skip the AVSubtitle
+                 * round trip; the mux thread only stamps PTS and writes. */
+                AVSubtitle *sub = enc_data ? NULL
+                                               : make_subtitle(bm,
+                                                               tracks[t].entries[tracks[t].cur_sub].start_ms,
+                                                               tracks[t].entries[tracks[t].cur_sub].end_ms);
+                int cue_dur_ms = (int)(tracks[t].entries[tracks[t].cur_sub].end_ms -
+                                       tracks[t].entries[tracks[t].cur_sub].start_ms);
+                if (sub || enc_data)
                 {
-                    sub->start_display_time = 0;
-                    sub->end_display_time =
-                        (tracks[t].entries[tracks[t].cur_sub].end_ms -
-                         tracks[t].entries[tracks[t].cur_sub].start_ms);
-
-                    int64_t pts90 = input_start_pts90 + ((tracks[t].entries[tracks[t].cur_sub].start_ms +
-                                                          track_delay_ms) *
-                                                         90);
-                    if (debug_level > 0) {
+                    if (sub)
+                    {
+                        sub->start_display_time = 0;
+                        sub->end_display_time = cue_dur_ms;
+                    }
+
+                    int64_t pts90 = tracks[t].timeline.start90
+                                        ? tracks[t].timeline.start90[tracks[t].cur_sub]
+                                        : input_start_pts90 + ((tracks[t].entries[tracks[t].cur_sub].start_ms +
+                                                                track_delay_ms) *
+                                                               90);
+                    if (LOG_ENABLED(1)) {
                         LOG(1, "[dbg] encoding track=%d cue=%d pts90=%lld (ms=%lld)\n", t, tracks[t].cur_sub, (long long)pts90, (long long)(pts90/90));
                     }
 
                     /* Skip DVB subtitle encoding in PNG-only mode */
-                    if (!png_only) {
+                    if (!png_only && enc_data) {
+                        write_subtitle_payload(out_fmt,
+                                               &tracks[t],
+                                               enc_data,
+                                               enc_size,
+                                               pts90,
+                                               bench_mode,
+                                               (debug_level > 1 ? pngfn : NULL));
+                    } else if (!png_only) {
+                        if (bench_mode && tracks[t].codec_ctx)
+                            sub_encode_bench_depth(&ctx->depth_bench, t, &bm, sub,
+                                                   tracks[t].codec_ctx->width,
+                                                   tracks[t].codec_ctx->height);
+                        int64_t t_inline = bench_mode ? bench_now() : 0;
                         encode_and_write_subtitle(tracks[t].codec_ctx,
                                                   out_fmt,
                                                   &tracks[t],
@@ -2064,16 +2902,18 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                                                   pts90,
                                                   bench_mode,
                                                   (debug_level > 1 ? pngfn : NULL));
+                        if (bench_mode)
+                            bench_add_mux_stall_us(bench_now() - t_inline);
                     }
 
                     subs_emitted++;
-                    if (debug_level > 1)
+                    if (LOG_ENABLED(2))
                     {
                         LOG(2, "[subs] Cue %d on %s: PTS=%lld ms, dur=%d ms, delay=%d ms\n",
                                tracks[t].cur_sub,
                                tracks[t].filename,
                                (long long)(pts90 / 90),
-                               sub->end_display_time,
+                               cue_dur_ms,
                                track_delay_ms);
                     }
 
@@ -2084,14 +2924,19 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                                  input_start_pts90, last_valid_cur90, 0 /* no pkt_count */);
 
 
-                    avsubtitle_free(sub);
-                    av_free(sub);
+                    if (sub)
+                    {
+                        avsubtitle_free(sub);
+                        av_free(sub);
+                    }
 
                     if (bm.idxbuf)
                         av_free(bm.idxbuf);
                     if (bm.palette)
                         av_free(bm.palette);
                 }
+                if (payload.data)
+                    av_free(payload.data);
 
                 AVSubtitle *clr = av_mallocz(sizeof(*clr));
                 if (clr)
@@ -2101,9 +2946,12 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                     clr->end_display_time = 1; /* minimal duration */
                     clr->num_rects = 0;
 
-                    int64_t clr_pts90 = input_start_pts90 + ((tracks[t].entries[tracks[t].cur_sub].end_ms +
-                                                              track_delay_ms) *
-                                                             90);
+                    int64_t clr_pts90 = tracks[t].timeline.end90
+                                            ? tracks[t].timeline.end90[tracks[t].cur_sub]
+                                            : input_start_pts90 + ((tracks[t].entries[tracks[t].cur_sub].end_ms +
+                                                                    track_delay_ms) *
+                                                                   90);
+                    LOG_CONTEXT(t, tracks[t].cur_sub, clr_pts90);
 
                     /* Skip DVB subtitle encoding in PNG-only mode */
                     if (!png_only) {
@@ -2116,7 +2964,7 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                                                   NULL);
                     }
 
-                    if (debug_level > 0)
+                    if (LOG_ENABLED(1))
                     {
                         LOG(1, "[subs] CLEAR cue %d on %s @ %lld ms\n",
                             tracks[t].cur_sub,
@@ -2129,35 +2977,25 @@ static int ctx_demux_mux_loop(struct MainCtx *ctx, SubTrack tracks[], int ntrack
                 }
 
                 tracks[t].cur_sub++;
+                LOG_CONTEXT(-1, -1, -1);
             }
         }
 
-        if (pkt->stream_index >= 0 && pkt->stream_index < (int)in_fmt->nb_streams)
+        /* Refresh the watermark only after a packet reached it: cursors
+         * only move inside the loop above. */
+        if (cmp90 >= next_due90)
         {
-            /* Skip writing packets to output file if PNG-only mode is enabled */
-            if (!png_only)
-            {
-                AVStream *out_st = out_fmt->streams[pkt->stream_index];
-                if (!out_st) {
-                    LOG(2, "output stream %d is NULL, skipping packet\n", pkt->stream_index);
-                    av_packet_unref(pkt);
-                    continue;
-                }
-                pkt->stream_index = out_st->index;
-
-                int64_t t5 = bench_now();
-                int mux_ret = safe_av_interleaved_write_frame(out_fmt, pkt);
-                if (bench_mode)
-                {
-                    int64_t delta_mux = bench_now() - t5;
-                    bench_add_mux_us(delta_mux);
-                    if (mux_ret >= 0)
-                        bench_inc_packets_muxed();
-                }
-            }
+            next_due90 = tracks_next_due90(tracks, ntracks);
         }
+
+        if (pkt->stream_index >= 0 && pkt->stream_index < (int)in_fmt->nb_streams)
+            ctx_mux_input_packet(ctx, pkt, bench_mode);
         av_packet_unref(pkt);
     }
+    free(stream_classes);
+    prerender_spool_close(spool);
+    if (bench_mode)
+        bench_add_demux(bench_now() - demux_t0, pkt_count);
 
     /* Force final progress update at 100% completion before exiting demux loop */
     if (debug_level == 0)
@@ -2204,7 +3042,10 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
         while (tracks[t].cur_sub < tracks[t].count) {
             Bitmap bm = {0};
             if (!use_ass) {
-                char *markup = srt_to_pango_markup(tracks[t].entries[tracks[t].cur_sub].text);
+                const char *markup = track_cue_markup(&tracks[t], tracks[t].cur_sub);
+                SubtitlePositionConfig cue_pos;
+                SubtitlePositionConfig *pos = cue_pos_config(&tracks[t].entries[tracks[t].cur_sub],
+                                                             t, &cue_pos);
                 int64_t t1 = bench_now();
                 int render_w = video_w > 0 ? video_w : 1920;
                 int render_h = video_h > 0 ? video_h : 1080;
@@ -2218,11 +3059,11 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
                 int used_align = cue_align;
                 if (!use_ass && cue_align >= 7 && cue_align <= 9) {
                     used_align = cue_align - 6; /* 7->1,8->2,9->3 */
-                    if (debug_level > 0)
+                    if (LOG_ENABLED(1))
                         LOG(1, "[png-only] remapping cue align %d -> %d for DVB render\n",
                             cue_align, used_align);
                 }
-                if (debug_level > 0) {
+                if (LOG_ENABLED(1)) {
                     LOG(1,
                         "[png-only] render cue %d: render_w=%d render_h=%d codec_w=%d codec_h=%d video_w=%d video_h=%d align=%d used_align=%d\n",
                         tracks[t].cur_sub,
@@ -2232,7 +3073,7 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
                         video_w, video_h,
                         cue_align, used_align);
                 }
-                if ((video_w <= 0 || video_h <= 0) && debug_level > 0) {
+                if ((video_w <= 0 || video_h <= 0) && LOG_ENABLED(1)) {
                     LOG(1, "[png-only] Warning: video size unknown, using fallback %dx%d for rendering\n",
                         render_w, render_h);
                 }
@@ -2247,7 +3088,7 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
                                                      cli_fontsize, cli_font,
                                                      cli_font_style,
                                                      cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
-                                                     &sub_pos_configs[t],
+                                                     pos,
                                                      palette_mode);
                     } else {
                         const int PREFETCH_WINDOW = 8;
@@ -2255,18 +3096,17 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
                             int qi = tracks[t].cur_sub + pi;
                             if (qi >= tracks[t].count)
                                 break;
-                            char *pm = srt_to_pango_markup(tracks[t].entries[qi].text);
-                            render_pool_submit_async(t, qi,
-                                                     pm,
-                                                     render_w, render_h,
-                                                     cli_fontsize, cli_font,
-                                                     cli_font_style,
-                                                     cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
-                                                     used_align,
-                                                     sub_position_pct,
-                                                     &sub_pos_configs[t],
-                                                     palette_mode);
-                            free(pm);
+                            SubtitlePositionConfig q_pos;
+                            render_pool_ctx_submit_ref(NULL, t, qi,
+                                                       track_cue_markup(&tracks[t], qi),
+                                                       render_w, render_h,
+                                                       cli_fontsize, cli_font,
+                                                       cli_font_style,
+                                                       cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
+                                                       used_align,
+                                                       sub_position_pct,
+                                                       cue_pos_config(&tracks[t].entries[qi], t, &q_pos),
+                                                       palette_mode, 0, 0);
                         }
                         if (render_pool_try_get(t, tracks[t].cur_sub, &tmpb) == 1) {
                             bm = tmpb;
@@ -2276,7 +3116,7 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
                                                          cli_fontsize, cli_font,
                                                          cli_font_style,
                                                          cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
-                                                         &sub_pos_configs[t],
+                                                         pos,
                                                          palette_mode);
                         }
                     }
@@ -2286,7 +3126,7 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
                                            cli_fontsize, cli_font,
                                            cli_font_style,
                                            cli_fgcolor, cli_outlinecolor, cli_shadowcolor, cli_bgcolor,
-                                           &sub_pos_configs[t],
+                                           pos,
                                            palette_mode);
                 }
                 if (bench_mode) {
@@ -2294,7 +3134,6 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
                     bench_add_render_us(delta);
                     bench_inc_cues_rendered();
                 }
-                free(markup);
             }
 #ifdef HAVE_LIBASS
             else {
@@ -2311,14 +3150,8 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
 #endif
 
             char pngfn[PATH_MAX] = "";
-            if (make_png_filename(pngfn, sizeof(pngfn), __srt_png_seq++, t, tracks[t].cur_sub) == 0) {
-                save_bitmap_png(&bm, pngfn);
-                if (debug_level > 1) {
-                    LOG(2, "[png-only] SRT bitmap saved: %s (x=%d y=%d w=%d h=%d)\n",
-                        pngfn, bm.x, bm.y, bm.w, bm.h);
-                }
-            }
-            if (debug_level > 1 && tracks[t].entries[tracks[t].cur_sub].text) {
+            ctx_save_cue_png(ctx, tracks, t, &bm, "png-only", pngfn, sizeof(pngfn));
+            if (LOG_ENABLED(2) && tracks[t].entries[tracks[t].cur_sub].text) {
                 LOG(2, "[png-only] cue idx=%d text='%s'\n",
                     tracks[t].cur_sub, tracks[t].entries[tracks[t].cur_sub].text);
             }
@@ -2340,7 +3173,9 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
  *
  * This function parses and validates one or more SRT files, reporting summary statistics
  * such as the number of cues and errors per file. It does not produce output media, but
- * instead logs QC results to both stdout and a file ("qc_log.txt"). The function supports
+ * instead logs QC results to both stdout and a report file ("qc_log.txt" unless
+ * --qc-report is given) in the --qc-format layout. Findings are collected in a
+ * QCReport and written in blocks; a per-check table follows the summary. The function supports
  * benchmarking and debug output, and handles resource management for all allocated memory.
  *
  * Parameters:
@@ -2351,6 +3186,8 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
  *   hi          - Flag indicating whether to mark cues as hearing-impaired.
  *   bench_mode  - Flag to enable benchmarking of parsing operations.
  *   debug_level - Debug verbosity level.
+ *   subtitle_delay_ms - Delay for tracks not covered by the --delay list
+ *                 (used by the --qc-cross delay suggestions).
  *
  * Returns:
  *   0 on success, 1 on error (e.g., invalid arguments, allocation failure, file open error).
@@ -2363,6 +3200,8 @@ static int ctx_png_only_render_all(struct MainCtx *ctx, SubTrack tracks[], int n
  *       - Logs per-file statistics.
  *       - Frees all allocated subtitle entry text.
  *   - Prints and logs a summary of all tracks and totals.
+ *   - With --qc-cross, keeps every track's cues and compares the tracks'
+ *     timing pairwise (qc_cross.h), suggesting per-track delays.
  *   - Cleans up all allocated resources.
  *   - Reports benchmark results if enabled.
  */
@@ -2372,7 +3211,8 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
                        int forced,
                        int hi,
                        int bench_mode,
-                       int debug_level)
+                       int debug_level,
+                       int subtitle_delay_ms)
 {
     /*
      * Checks if any of the required pointers (ctx, srt_list, lang_list) are NULL.
@@ -2382,21 +3222,27 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
         return 1;
 
     /**
-     * Opens a file named "qc_log.txt" in write mode and assigns the file pointer to 'qc'.
-     * This file is intended for logging quality control information.
-     * If the file cannot be opened, 'qc' will be set to NULL.
-     */
-    FILE *qc = fopen("qc_log.txt", "w");
-
-    /**
-     * Checks if the 'qc' pointer is NULL. If it is, logs an error message to "qc_log.txt"
-     * using perror and returns 1 to indicate failure.
+     * Opens the QC report file (qc_log.txt by default) in write mode and assigns the
+     * file pointer to 'qc'. If the file cannot be opened, reports the error via
+     * perror and returns 1 to indicate failure.
      */
+    const char *qc_path = qc_report_path ? qc_report_path : "qc_log.txt";
+    FILE *qc = fopen(qc_path, "w");
     if (!qc)
     {
-        perror("qc_log.txt");
+        perror(qc_path);
+        return 1;
+    }
+
+    /* Findings from the parser's qc_check_entry() calls go to the report. */
+    QCReport *report = qc_report_create((QCReportFormat)qc_format, qc);
+    if (!report)
+    {
+        LOG(1, "Out of memory creating QC report\n");
+        fclose(qc);
         return 1;
     }
+    qc_set_report(report);
     /*
      * Assigns the value of 'qc' to the 'qc' member of the 'ctx' structure.
      * This sets up the context with the provided 'qc' value for further processing.
@@ -2404,6 +3250,8 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
     ctx->qc = qc;
 
 #define RETURN_QC(code) do { \
+        qc_set_report(NULL); \
+        qc_report_destroy(report); \
         if (qc) { fclose(qc); qc = NULL; ctx->qc = NULL; } \
         return (code); \
     } while (0)
@@ -2492,6 +3340,28 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
         RETURN_QC(1);
     }
 
+    /* --qc-cross keeps each track's cues, with the delay it would be
+     * muxed with, for the pairwise comparison after the per-file pass. */
+    QCCrossTrack *cross = NULL;
+    if (qc_cross && nfiles >= 2)
+    {
+        int *delay_vals = NULL;
+        int delay_count = 0;
+        char delay_err[256] = {0};
+        if (ctx->subtitle_delay_list &&
+            parse_delay_list(ctx->subtitle_delay_list, &delay_vals, &delay_count, delay_err) != 0)
+        {
+            LOG(1, "QC: ignoring --delay list for cross-track QC: %s\n", delay_err);
+            delay_count = 0;
+        }
+        cross = calloc(nfiles, sizeof(*cross));
+        if (!cross)
+            LOG(1, "Out of memory allocating cross-track QC table; skipping it\n");
+        for (size_t i = 0; cross && i < nfiles; ++i)
+            cross[i].delay_ms = (i < (size_t)delay_count) ? delay_vals[i] : subtitle_delay_ms;
+        free(delay_vals);
+    }
+
     for (size_t i = 0; i < nfiles; ++i)
     {
         qc_reset_counts();
@@ -2508,13 +3378,16 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
             .auto_fix_duplicates = 1,
             .auto_fix_encoding = 1,
             .warn_on_short_duration = 1,
-            .warn_on_long_duration = 1
+            .warn_on_long_duration = 1,
+            .defer_qc = 1
         };
         
         SRTParserStats stats = {0};
         
         int64_t t0 = bench_now();
         int count = parse_srt_with_stats(fnames[i], &entries, qc, &cfg, &stats);
+        if (count > 0)
+            qc_check_track(fnames[i], entries, count, qc, get_cpu_count());
         if (bench_mode) {
             int64_t delta_parse = bench_now() - t0;
             bench_add_parse_us(delta_parse);
@@ -2546,9 +3419,18 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
         }
         printf("\n");
 
-        for (int j = 0; j < count; j++)
-            free(entries[j].text);
-        free(entries);
+        if (cross)
+        {
+            cross[i].name = fnames[i];
+            cross[i].entries = entries;
+            cross[i].count = count;
+        }
+        else
+        {
+            for (int j = 0; j < count; j++)
+                free(entries[j].text);
+            free(entries);
+        }
         free(langs[i]);
     }
 
@@ -2574,7 +3456,13 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
     printf("  TOTAL: %-*s  cues=%6d  errors=%4d\n",
            max_name_len, "", total_cues, total_errors);
 
-    if (qc)
+    qc_report_finish(report);
+    printf("\n");
+    qc_report_summary(report, stdout);
+
+    /* The plain-text report keeps its trailing summary; structured
+     * formats must stay parseable. */
+    if (qc && qc_format == QC_REPORT_TEXT)
     {
         fprintf(qc, "SRT Quick-Check Summary:\n");
         for (size_t i = 0; i < nfiles; ++i)
@@ -2586,6 +3474,26 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
         fprintf(qc, "TOTAL: cues=%d errors=%d\n", total_cues, total_errors);
     }
 
+    if (cross)
+    {
+        QCCrossResult xres;
+        if (qc_cross_analyze(cross, (int)nfiles, get_cpu_count(), &xres) == 0)
+        {
+            qc_cross_print(&xres, cross, stdout);
+            if (qc && qc_format == QC_REPORT_TEXT)
+                qc_cross_print(&xres, cross, qc);
+            qc_cross_free(&xres);
+        }
+        for (size_t i = 0; i < nfiles; ++i)
+        {
+            SRTEntry *entries = (SRTEntry *)cross[i].entries;
+            for (int j = 0; j < cross[i].count; j++)
+                free(entries[j].text);
+            free(entries);
+        }
+        free(cross);
+    }
+
     for (size_t i = 0; i < nfiles; ++i)
         free(summaries[i].filename);
     free(summaries);
@@ -2597,6 +3505,102 @@ static int ctx_run_qc_only(struct MainCtx *ctx,
 #undef RETURN_QC
 }
 
+/*
+ * ctx_run_auto_delay
+ *
+ * --auto-delay: estimate each SRT track's delay from the input's audio
+ * (audio_sync.h). Decodes the first --auto-delay-window seconds of the
+ * best audio stream once, then correlates every track's cue timeline
+ * (with its current --delay applied) against it and prints the offset,
+ * confidence and a suggested --delay list. Tracks with low confidence
+ * keep their current delay in the suggestion. Nothing is muxed.
+ *
+ * Returns 0 on success, 1 if the audio cannot be analysed.
+ */
+static int ctx_run_auto_delay(struct MainCtx *ctx, const char *input,
+                              const char *srt_list, int subtitle_delay_ms)
+{
+    AudioEnvelope env;
+    int64_t t0 = bench_now();
+    if (audio_sync_read_envelope(input, auto_delay_seconds, AUDIO_SYNC_HOP_MS, &env) != 0)
+        return 1;
+    AudioSync *sync = audio_sync_create(&env);
+    int analysed_s = env.n * env.hop_ms / 1000;
+    audio_sync_envelope_free(&env);
+    if (!sync) {
+        LOG(0, "Not enough audio in '%s' to estimate subtitle delays\n", input);
+        return 1;
+    }
+    LOG(1, "Audio envelope: %d s decoded in %lld ms\n", analysed_s,
+        (long long)((bench_now() - t0) / 1000));
+
+    int *delay_vals = NULL;
+    int delay_count = 0;
+    char delay_err[256] = {0};
+    if (ctx->subtitle_delay_list &&
+        parse_delay_list(ctx->subtitle_delay_list, &delay_vals, &delay_count, delay_err) != 0) {
+        LOG(0, "Subtitle delay list parsing error: %s\n", delay_err);
+        audio_sync_destroy(sync);
+        return 1;
+    }
+
+    char *srt_copy = strdup(srt_list);
+    if (!srt_copy) {
+        free(delay_vals);
+        audio_sync_destroy(sync);
+        return 1;
+    }
+
+    printf("=== Subtitle delay from audio (first %d s, %d ms resolution) ===\n",
+           analysed_s, AUDIO_SYNC_HOP_MS);
+    char suggestion[512] = "";
+    size_t used = 0;
+    int ntracks = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(srt_copy, ",", &save); tok; tok = strtok_r(NULL, ",", &save), ntracks++) {
+        int delay = ntracks < delay_count ? delay_vals[ntracks] : subtitle_delay_ms;
+        int suggested = delay;
+
+        SRTParserConfig cfg = {
+            .video_w = video_w,
+            .video_h = video_h,
+            .validation_level = SRT_VALIDATE_AUTO_FIX,
+            .auto_fix_duplicates = 1,
+            .auto_fix_encoding = 1,
+            .defer_qc = 1
+        };
+        SRTEntry *entries = NULL;
+        int count = parse_srt_with_stats(tok, &entries, NULL, &cfg, NULL);
+        AudioSyncResult res;
+        if (count <= 0) {
+            printf("  Track %d %s: cannot parse\n", ntracks, tok);
+        } else if (audio_sync_track(sync, entries, count, delay, AUDIO_SYNC_MAX_LAG_MS, &res) != 0) {
+            printf("  Track %d %s: no cues in the analysed audio\n", ntracks, tok);
+        } else {
+            const char *label = audio_sync_confidence_label(res.confidence);
+            if (res.confidence >= 0.2)
+                suggested = delay + res.offset_ms;
+            printf("  Track %d %s: offset %+d ms (peak %.2f, confidence %.2f %s, %d cues); delay %d ms -> %d ms\n",
+                   ntracks, tok, res.offset_ms, res.peak, res.confidence, label,
+                   res.cues_used, delay, suggested);
+        }
+        for (int j = 0; j < count; j++)
+            free(entries[j].text);
+        free(entries);
+
+        int w = snprintf(suggestion + used, sizeof(suggestion) - used, "%s%d",
+                         ntracks ? "," : "", suggested);
+        if (w > 0 && (size_t)w < sizeof(suggestion) - used)
+            used += (size_t)w;
+    }
+    printf("  --delay %s\n", suggestion);
+
+    free(srt_copy);
+    free(delay_vals);
+    audio_sync_destroy(sync);
+    return 0;
+}
+
 /**
  * ctx_cleanup - Cleans up and releases all resources associated with the given MainCtx structure.
  *
@@ -2618,7 +3622,19 @@ static void ctx_cleanup(struct MainCtx *ctx)
     if (!ctx) return;
     /* Always stop render infrastructure so worker threads and TLS state are released. */
     render_pool_shutdown();
+    /* The breaker holds Pango objects of this thread's fontmap. */
+    line_breaker_destroy(ctx->line_breaker);
+    ctx->line_breaker = NULL;
     render_pango_cleanup();
+    ctx_close_sheets(ctx);
+    if (ctx->debug_level > 0) {
+        long clut_hits = 0, clut_misses = 0;
+        clut_cache_stats(&clut_hits, &clut_misses);
+        if (clut_hits + clut_misses > 0)
+            LOG(1, "CLUT cache: %ld hits, %ld conversions, %ld colours clamped to BT.601 RGB\n",
+                clut_hits, clut_misses, clut_cache_clipped());
+    }
+    clut_cache_clear();
 
     /* Stop workers and free codec contexts per-track */
     if (ctx->tracks) {
@@ -2626,6 +3642,7 @@ static void ctx_cleanup(struct MainCtx *ctx)
             if (ctx->tracks[t].codec_ctx)
                 avcodec_free_context(&ctx->tracks[t].codec_ctx);
         }
+        sub_encode_bench_release(&ctx->depth_bench);
 
         for (int t = 0; t < ctx->ntracks; t++) {
             if (ctx->tracks[t].lang) {
@@ -2646,12 +3663,19 @@ static void ctx_cleanup(struct MainCtx *ctx)
                 free(ctx->tracks[t].entries);
                 ctx->tracks[t].entries = NULL;
             }
+            if (ctx->tracks[t].markup) {
+                for (int j = 0; j < ctx->tracks[t].count; j++)
+                    free(ctx->tracks[t].markup[j]);
+                free(ctx->tracks[t].markup);
+                ctx->tracks[t].markup = NULL;
+            }
 #ifdef HAVE_LIBASS
             if (ctx->tracks[t].ass_track) {
                 render_ass_free_track(ctx->tracks[t].ass_track);
                 ctx->tracks[t].ass_track = NULL;
             }
 #endif
+            cue_timeline_free(&ctx->tracks[t].timeline);
             if (ctx->tracks[t].enc_tmpbuf) {
                 av_free(ctx->tracks[t].enc_tmpbuf);
                 ctx->tracks[t].enc_tmpbuf = NULL;
@@ -2739,6 +3763,18 @@ static void ctx_cleanup(struct MainCtx *ctx)
         free(ctx->service_provider);
         ctx->service_provider = NULL;
     }
+    if (fps_convert_spec) {
+        free(fps_convert_spec);
+        fps_convert_spec = NULL;
+    }
+    if (prerender_spool_path) {
+        free(prerender_spool_path);
+        prerender_spool_path = NULL;
+    }
+    if (qc_report_path) {
+        free(qc_report_path);
+        qc_report_path = NULL;
+    }
 
     if (ctx->out_fmt) {
         if (ctx->out_fmt->pb)
@@ -2997,6 +4033,8 @@ int srt2dvbsub_run_cli(int argc, char **argv)
      * ctx_cleanup(&ctx) without leaking previously allocated strings.
      */
     struct MainCtx ctx = {0};
+    ctx.argc = argc;
+    ctx.argv = argv;
     ctx.palette_mode = palette_mode;
     ctx.cli_font = cli_font;
     ctx.cli_font_style = cli_font_style;
@@ -3123,11 +4161,37 @@ int srt2dvbsub_run_cli(int argc, char **argv)
      *   Pango renderer. Larger values improve edge quality at the cost of CPU.
      * - no_unsharp: disable the final unsharp pass which may eat into
      *   small glyphs on low-resolution videos; exposed for debugging.
+     * - glyph_atlas: composite plain cues from cached glyph tiles
+     *   instead of drawing every cue with the Cairo path.
+     * - effects_mode: stroke outlines with Cairo or derive outline and
+     *   shadow from the fill mask.
+     * - no_adaptive_depth: send every cue with its full rendered palette
+     *   instead of the smallest DVB depth that holds its colours.
+     * - colorimetry: CLUT conversion matrix (BT.601 or BT.709).
      */
     if (ssaa_override > 0)
         render_pango_set_ssaa_override(ssaa_override);
     if (no_unsharp)
         render_pango_set_no_unsharp(1);
+    if (glyph_atlas)
+        render_pango_set_glyph_atlas(1);
+    render_pango_set_effects_mode(effects_mode);
+    if (no_adaptive_depth)
+        dvb_sub_set_adaptive_depth(0);
+    /* AUTO is resolved against the video stream in ctx_init(). */
+    dvb_sub_set_colorimetry((ClutColorimetry)colorimetry);
+    debug_png_set_writer(png_cairo, &(PngWriterOptions){ png_level, png_filter, png_threads });
+
+    /* Debug runs log through per-thread rings and a writer thread so the
+     * demux loop and render workers do not serialise on stderr. Registered
+     * before render_pool_shutdown so the workers' last messages are
+     * written when atexit handlers run in reverse order. */
+    if (debug_level > 0 && !log_sync)
+    {
+        LogAsyncConfig lcfg = { .format = (LogFormat)log_format, .rate_per_sec = log_rate };
+        if (log_async_start(&lcfg) == 0)
+            atexit(log_async_stop);
+    }
 
     /* Initialize the asynchronous render pool when the user requests
      * multiple render workers. The render pool provides two modes:
@@ -3149,7 +4213,12 @@ int srt2dvbsub_run_cli(int argc, char **argv)
      * - On initialization failure, render_pool_shutdown() is NOT registered,
      *   and render_threads is set to 0 (sync-only mode).
      */
-    if (render_threads > 0)
+    /* --prerender fans every cue out over the render pool; without an
+     * explicit --render-threads use one worker per core. */
+    if (prerender_mode && render_threads <= 0 && !png_only)
+        render_threads = get_cpu_count();
+
+    if (render_threads > 0 && !render_daemon_socket)
     {
         if (render_pool_init(render_threads) != 0)
         {
@@ -3178,6 +4247,32 @@ int srt2dvbsub_run_cli(int argc, char **argv)
     ctx.debug_level = debug_level;
     ctx.render_threads = render_threads;
 
+    /* Render-only service mode: serve cue renders from a warm renderer
+     * until SIGINT/SIGTERM. The daemon owns a private render pool. */
+    if (render_daemon_socket)
+    {
+        RenderDaemonConfig dcfg = {
+            .socket_path = render_daemon_socket,
+            .max_clients = render_daemon_clients,
+            .render_threads = render_threads,
+            .video_w = video_w,
+            .video_h = video_h,
+            .fontsize = cli_fontsize,
+            .font = ctx.cli_font,
+            .fontstyle = ctx.cli_font_style,
+            .fgcolor = ctx.cli_fgcolor,
+            .outlinecolor = ctx.cli_outlinecolor,
+            .shadowcolor = ctx.cli_shadowcolor,
+            .bgcolor = ctx.cli_bgcolor,
+            .palette_mode = ctx.palette_mode,
+            .pos = sub_pos_configs[0],
+        };
+        int daemon_ret = render_daemon_run(&dcfg, &stop_requested);
+        free(render_daemon_socket);
+        render_daemon_socket = NULL;
+        return finalize_main(&ctx, ctx_cleaned, daemon_ret);
+    }
+
     /* Create a dedicated directory for PNG debug dumps when debug mode is
      * enabled. We tolerate EEXIST for idempotency across multiple runs. On
      * restricted filesystems we warn but continue (PNG emission is optional).
@@ -3196,10 +4291,17 @@ int srt2dvbsub_run_cli(int argc, char **argv)
 
     if (qc_only)
     {
-        int qc_ret = ctx_run_qc_only(&ctx, srt_list, lang_list, 0, 0, bench_mode, debug_level);
+        int qc_ret = ctx_run_qc_only(&ctx, srt_list, lang_list, 0, 0, bench_mode, debug_level,
+                                     subtitle_delay_ms);
         return finalize_main(&ctx, ctx_cleaned, qc_ret);
     }
 
+    if (auto_delay)
+    {
+        int ad_ret = ctx_run_auto_delay(&ctx, input, srt_list, subtitle_delay_ms);
+        return finalize_main(&ctx, ctx_cleaned, ad_ret);
+    }
+
     /* PNG-only preview flow without input/output TS */
     if (png_only && (!input || !output))
     {
@@ -3297,6 +4399,11 @@ int srt2dvbsub_run_cli(int argc, char **argv)
             ctx_cleaned = true;
             return ret;
         }
+        if (ctx_apply_frame_timing(&ctx, tracks, ntracks, 0) != 0) {
+            ctx_cleanup(&ctx);
+            ctx_cleaned = true;
+            return 1;
+        }
 
 #ifdef HAVE_LIBASS
         if (use_ass) {
@@ -3401,6 +4508,11 @@ int srt2dvbsub_run_cli(int argc, char **argv)
         ctx_cleaned = true;
         return ret;
     }
+    if (ctx_apply_frame_timing(&ctx, tracks, ntracks, input_start_pts90) != 0) {
+        ctx_cleanup(&ctx);
+        ctx_cleaned = true;
+        return 1;
+    }
 
 #ifdef HAVE_LIBASS
     if (use_ass) {
@@ -3511,6 +4623,11 @@ int srt2dvbsub_run_cli(int argc, char **argv)
     av_dict_set(&mux_opts, "copyts", "1", 0);
     av_dict_set(&mux_opts, "start_at_zero", "1", 0);
 
+    /* --deterministic: keep library version strings and other
+     * build-specific fields out of the container. */
+    if (deterministic)
+        out_fmt->flags |= AVFMT_FLAG_BITEXACT;
+
     /* Determine muxrate based on requested mode */
     int64_t final_mux_rate = 0;
     if (ts_bitrate_mode == TS_BITRATE_MODE_FIXED) {
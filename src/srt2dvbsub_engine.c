@@ -0,0 +1,295 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * srt2dvbsub_engine.c
+ * -------------------
+ * Context-based front door to the subtitle pipeline (libsrt2dvbsub).
+ * The option snapshot, a private RenderPool and a private BenchStats
+ * live in the S2DEngine object. This file reads no CLI globals from
+ * runtime_opts.c; the process-wide state the parser and renderer still
+ * share is listed in srt2dvbsub_engine.h.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "srt2dvbsub_engine.h"
+#include "render_pool.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <libavutil/mem.h>
+
+struct S2DEngine {
+    S2DEngineOptions opts;   /* string fields point at the owned copies below */
+    char *font;
+    char *fontstyle;
+    char *fgcolor;
+    char *outlinecolor;
+    char *shadowcolor;
+    char *bgcolor;
+    char *palette_mode;
+    RenderPool *pool;
+    BenchStats bench;
+};
+
+static void *eng_alloc(const S2DAllocator *a, size_t size) {
+    if (a->alloc) return a->alloc(a->opaque, size);
+    return malloc(size);
+}
+
+static void eng_release(const S2DAllocator *a, void *ptr) {
+    if (!ptr) return;
+    if (a->release) a->release(a->opaque, ptr);
+    else free(ptr);
+}
+
+/* strdup() that keeps NULL as NULL; sets *failed on allocation failure. */
+static char *dup_opt(const char *s, int *failed) {
+    if (!s) return NULL;
+    char *d = strdup(s);
+    if (!d) *failed = 1;
+    return d;
+}
+
+void s2d_engine_options_init(S2DEngineOptions *opts) {
+    if (!opts) return;
+    memset(opts, 0, sizeof(*opts));
+    opts->render_threads = 0;
+    opts->video_w = 720;
+    opts->video_h = 480;
+    opts->font = "Open Sans";
+    opts->fgcolor = "#FFFFFF";
+    opts->outlinecolor = "#000000";
+    opts->shadowcolor = "#64000000";
+    opts->palette_mode = "broadcast";
+    opts->pos.position = SUB_POS_BOT_CENTER;
+    opts->pos.margin_top = 3.5;
+    opts->pos.margin_left = 3.5;
+    opts->pos.margin_bottom = 3.5;
+    opts->pos.margin_right = 3.5;
+    opts->parser.video_w = opts->video_w;
+    opts->parser.video_h = opts->video_h;
+    opts->parser.validation_level = SRT_VALIDATE_AUTO_FIX;
+    opts->parser.max_line_length = 200;
+    opts->parser.max_line_count = 5;
+    opts->parser.auto_fix_duplicates = 1;
+    opts->parser.auto_fix_encoding = 1;
+    opts->parser.warn_on_short_duration = 1;
+    opts->parser.warn_on_long_duration = 1;
+}
+
+static void engine_free_strings(S2DEngine *eng) {
+    free(eng->font);
+    free(eng->fontstyle);
+    free(eng->fgcolor);
+    free(eng->outlinecolor);
+    free(eng->shadowcolor);
+    free(eng->bgcolor);
+    free(eng->palette_mode);
+}
+
+S2DEngine *s2d_engine_create(const S2DEngineOptions *opts) {
+    S2DEngineOptions defaults;
+    if (!opts) {
+        s2d_engine_options_init(&defaults);
+        opts = &defaults;
+    }
+
+    S2DEngine *eng = eng_alloc(&opts->allocator, sizeof(*eng));
+    if (!eng) return NULL;
+    memset(eng, 0, sizeof(*eng));
+    eng->opts = *opts;
+
+    int failed = 0;
+    eng->font = dup_opt(opts->font, &failed);
+    eng->fontstyle = dup_opt(opts->fontstyle, &failed);
+    eng->fgcolor = dup_opt(opts->fgcolor, &failed);
+    eng->outlinecolor = dup_opt(opts->outlinecolor, &failed);
+    eng->shadowcolor = dup_opt(opts->shadowcolor, &failed);
+    eng->bgcolor = dup_opt(opts->bgcolor, &failed);
+    eng->palette_mode = dup_opt(opts->palette_mode, &failed);
+    if (failed) {
+        engine_free_strings(eng);
+        eng_release(&opts->allocator, eng);
+        return NULL;
+    }
+    eng->opts.font = eng->font;
+    eng->opts.fontstyle = eng->fontstyle;
+    eng->opts.fgcolor = eng->fgcolor;
+    eng->opts.outlinecolor = eng->outlinecolor;
+    eng->opts.shadowcolor = eng->shadowcolor;
+    eng->opts.bgcolor = eng->bgcolor;
+    eng->opts.palette_mode = eng->palette_mode;
+    /* The parser wraps against the engine's display size, not the globals. */
+    eng->opts.parser.use_ass = opts->use_ass;
+    eng->opts.parser.video_w = opts->video_w;
+    eng->opts.parser.video_h = opts->video_h;
+
+    bench_stats_reset(&eng->bench);
+    eng->bench.enabled = opts->bench_enabled ? 1 : 0;
+
+    eng->pool = render_pool_create(opts->render_threads, &eng->bench);
+    if (!eng->pool) {
+        engine_free_strings(eng);
+        eng_release(&opts->allocator, eng);
+        return NULL;
+    }
+    return eng;
+}
+
+void s2d_engine_destroy(S2DEngine *eng) {
+    if (!eng) return;
+    render_pool_destroy(eng->pool);
+    engine_free_strings(eng);
+    S2DAllocator a = eng->opts.allocator;
+    eng_release(&a, eng);
+}
+
+int s2d_engine_parse_srt(S2DEngine *eng, const char *path,
+                         SRTEntry **entries_out, FILE *qc) {
+    if (!eng || !path || !entries_out) return -1;
+    int64_t t0 = eng->bench.enabled ? bench_now() : 0;
+    int n = parse_srt_cfg(path, entries_out, qc, &eng->opts.parser);
+    if (t0)
+        bench_stats_add_parse_us(&eng->bench, bench_now() - t0);
+    return n;
+}
+
+void s2d_engine_free_entries(SRTEntry *entries, int count) {
+    if (!entries) return;
+    for (int i = 0; i < count; i++) free(entries[i].text);
+    free(entries);
+}
+
+/* Position of one cue: the engine default, overridden by a {\anN} tag
+ * still inline in the text or by the alignment the parser extracted. */
+static SubtitlePositionConfig engine_cue_pos(const S2DEngine *eng, char *markup,
+                                             int ass_align) {
+    SubtitlePositionConfig pos = eng->opts.pos;
+    SubtitlePositionConfig *inline_pos = extract_ass_alignment(markup);
+    if (inline_pos) {
+        pos = *inline_pos;
+        free(inline_pos);
+    } else {
+        ass_alignment_apply(ass_align, &pos);
+    }
+    return pos;
+}
+
+static Bitmap engine_render(S2DEngine *eng, const char *cue_text, int ass_align) {
+    Bitmap empty = {0};
+    if (!eng || !cue_text) return empty;
+    char *markup = srt_to_pango_markup(cue_text);
+    if (!markup) return empty;
+    SubtitlePositionConfig pos = engine_cue_pos(eng, markup, ass_align);
+    Bitmap bm = render_pool_ctx_render_sync(eng->pool, markup,
+                                            eng->opts.video_w, eng->opts.video_h,
+                                            eng->opts.fontsize, eng->opts.font,
+                                            eng->opts.fontstyle,
+                                            eng->opts.fgcolor, eng->opts.outlinecolor,
+                                            eng->opts.shadowcolor, eng->opts.bgcolor,
+                                            &pos, eng->opts.palette_mode);
+    free(markup);
+    return bm;
+}
+
+static int engine_submit(S2DEngine *eng, int track_id, int cue_index,
+                         const char *cue_text, int ass_align) {
+    if (!eng || !cue_text) return -1;
+    char *markup = srt_to_pango_markup(cue_text);
+    if (!markup) return -1;
+    SubtitlePositionConfig pos = engine_cue_pos(eng, markup, ass_align);
+    int rc = render_pool_ctx_submit_async(eng->pool, track_id, cue_index, markup,
+                                          eng->opts.video_w, eng->opts.video_h,
+                                          eng->opts.fontsize, eng->opts.font,
+                                          eng->opts.fontstyle,
+                                          eng->opts.fgcolor, eng->opts.outlinecolor,
+                                          eng->opts.shadowcolor, eng->opts.bgcolor,
+                                          0, 0.0, &pos, eng->opts.palette_mode);
+    free(markup);
+    return rc;
+}
+
+Bitmap s2d_engine_render_cue(S2DEngine *eng, const char *cue_text) {
+    return engine_render(eng, cue_text, 0);
+}
+
+int s2d_engine_submit_cue(S2DEngine *eng, int track_id, int cue_index,
+                          const char *cue_text) {
+    return engine_submit(eng, track_id, cue_index, cue_text, 0);
+}
+
+Bitmap s2d_engine_render_entry(S2DEngine *eng, const SRTEntry *entry) {
+    Bitmap empty = {0};
+    if (!entry) return empty;
+    return engine_render(eng, entry->text, entry->alignment_tag ? entry->alignment : 0);
+}
+
+int s2d_engine_submit_entry(S2DEngine *eng, int track_id, int cue_index,
+                            const SRTEntry *entry) {
+    if (!entry) return -1;
+    return engine_submit(eng, track_id, cue_index, entry->text, entry->alignment_tag ? entry->alignment : 0);
+}
+
+int s2d_engine_try_get(S2DEngine *eng, int track_id, int cue_index, Bitmap *out) {
+    if (!eng || !out) return -1;
+    return render_pool_ctx_try_get(eng->pool, track_id, cue_index, out);
+}
+
+void s2d_engine_free_bitmap(Bitmap *bm) {
+    if (!bm) return;
+    av_free(bm->idxbuf);
+    av_free(bm->palette);
+    bm->idxbuf = NULL;
+    bm->palette = NULL;
+}
+
+void s2d_engine_bench(const S2DEngine *eng, BenchStats *out) {
+    if (!eng || !out) return;
+    bench_stats_snapshot(&eng->bench, out);
+}
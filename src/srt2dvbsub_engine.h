@@ -0,0 +1,213 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+#pragma once
+#ifndef SRT2DVBSUB_ENGINE_H
+#define SRT2DVBSUB_ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "srt_parser.h"
+#include "render_pango.h"
+#include "bench.h"
+
+/**
+ * @file srt2dvbsub_engine.h
+ * @brief Engine API (libsrt2dvbsub).
+ *
+ * The command line tools keep their configuration in process globals
+ * (runtime_opts.h, the default render pool, the global `bench`). This
+ * header exposes an explicit context object instead so that several
+ * independent subtitle jobs can run inside one process, each with its
+ * own options, render pool, bench accumulator and allocator.
+ *
+ * Held by each engine:
+ *  - options:   copied at creation time (display size, fonts, colours,
+ *               placement, palette and parser settings).
+ *  - render:    a private RenderPool (see render_pool.h).
+ *  - bench:     a private BenchStats updated lock-free by the engine's
+ *               workers (parse/render time and cue count only).
+ *  - allocator: used for engine-owned objects (the context itself).
+ *               Bitmaps keep the libavutil allocator used by the
+ *               renderer; release them with s2d_engine_free_bitmap().
+ *
+ * Shared by every engine in the process (the library also carries the
+ * CLI's runtime_opts.c, so these are ordinary globals):
+ *  - `debug_level`, read by the parser and renderer for diagnostics.
+ *  - the renderer tuning knobs set through render_pango_set_*() and
+ *    `ssaa_override` (SSAA factor, unsharp, glyph atlas, effects mode,
+ *    pre-broken lines). Engines never change them; a host that does
+ *    changes them for all engines at once.
+ *  - fontconfig, and the per-thread Pango font maps and glyph-atlas
+ *    caches of whichever threads render.
+ *
+ * Functions taking an engine may be called concurrently on different
+ * engines. A single engine may be shared between threads for the render
+ * calls; create/destroy must not race with other calls on the same
+ * engine.
+ */
+
+/**
+ * @brief Pluggable allocator for engine-owned memory.
+ *
+ * Leave both callbacks NULL to use malloc()/free().
+ */
+typedef struct {
+    void *(*alloc)(void *opaque, size_t size);
+    void (*release)(void *opaque, void *ptr);
+    void *opaque;
+} S2DAllocator;
+
+/**
+ * @brief Per-engine configuration.
+ *
+ * Initialise with s2d_engine_options_init() and override fields as
+ * needed. String fields are borrowed for the duration of
+ * s2d_engine_create() only; the engine keeps private copies.
+ */
+typedef struct {
+    int render_threads;          /**< worker threads (0 = render synchronously) */
+    int video_w;                 /**< display width used for rendering/wrapping */
+    int video_h;                 /**< display height used for rendering/wrapping */
+    int use_ass;                 /**< keep ASS markup in parsed cue text */
+    int fontsize;                /**< font size in px (0 = renderer default) */
+    const char *font;            /**< font family (NULL = renderer default) */
+    const char *fontstyle;       /**< font style (NULL = regular) */
+    const char *fgcolor;         /**< text colour (#RRGGBB) */
+    const char *outlinecolor;    /**< outline colour */
+    const char *shadowcolor;     /**< shadow colour */
+    const char *bgcolor;         /**< background box colour (NULL = none) */
+    const char *palette_mode;    /**< palette name, see palette.h */
+    SubtitlePositionConfig pos;  /**< default cue placement */
+    SRTParserConfig parser;      /**< SRT parser settings */
+    int bench_enabled;           /**< collect timings into the engine bench */
+    S2DAllocator allocator;      /**< allocator for engine-owned objects */
+} S2DEngineOptions;
+
+/** @brief Opaque engine context. */
+typedef struct S2DEngine S2DEngine;
+
+/**
+ * @brief Fill `opts` with the same defaults the CLI uses.
+ */
+void s2d_engine_options_init(S2DEngineOptions *opts);
+
+/**
+ * @brief Create an engine from `opts` (NULL = defaults).
+ *
+ * @return new engine, or NULL on allocation/thread creation failure.
+ */
+S2DEngine *s2d_engine_create(const S2DEngineOptions *opts);
+
+/**
+ * @brief Stop the engine's workers and release all engine resources.
+ */
+void s2d_engine_destroy(S2DEngine *eng);
+
+/**
+ * @brief Parse an SRT file with the engine's parser configuration.
+ *
+ * @param qc optional QC log stream (may be NULL)
+ * @return number of cues (>= 0) or -1 on error. Free the entries with
+ *         s2d_engine_free_entries().
+ */
+int s2d_engine_parse_srt(S2DEngine *eng, const char *path,
+                         SRTEntry **entries_out, FILE *qc);
+
+/**
+ * @brief Release an entry array returned by s2d_engine_parse_srt().
+ */
+void s2d_engine_free_entries(SRTEntry *entries, int count);
+
+/**
+ * @brief Render one cue's text (SRT markup, optional {\anN}) synchronously.
+ *
+ * @return Bitmap owned by the caller (w == 0 on failure).
+ */
+Bitmap s2d_engine_render_cue(S2DEngine *eng, const char *cue_text);
+
+/**
+ * @brief Queue a cue for asynchronous rendering keyed by (track, cue).
+ *
+ * @return 0 on success, -1 if the engine has no workers or on failure.
+ */
+int s2d_engine_submit_cue(S2DEngine *eng, int track_id, int cue_index,
+                          const char *cue_text);
+
+/**
+ * @brief Render a parsed entry. The parser moves a cue's {\anN} tag into
+ * SRTEntry.alignment, so entries from s2d_engine_parse_srt() should be
+ * rendered with these rather than by passing their text alone.
+ */
+Bitmap s2d_engine_render_entry(S2DEngine *eng, const SRTEntry *entry);
+
+/**
+ * @brief Queue a parsed entry for asynchronous rendering (see
+ * s2d_engine_render_entry and s2d_engine_submit_cue).
+ */
+int s2d_engine_submit_entry(S2DEngine *eng, int track_id, int cue_index,
+                            const SRTEntry *entry);
+
+/**
+ * @brief Fetch an asynchronously rendered cue.
+ *
+ * @return 1 when `out` was filled, 0 while pending, -1 if unknown.
+ */
+int s2d_engine_try_get(S2DEngine *eng, int track_id, int cue_index, Bitmap *out);
+
+/**
+ * @brief Release the buffers of a Bitmap returned by the engine.
+ */
+void s2d_engine_free_bitmap(Bitmap *bm);
+
+/**
+ * @brief Copy the engine's bench accumulators into `out`.
+ */
+void s2d_engine_bench(const S2DEngine *eng, BenchStats *out);
+
+#endif /* SRT2DVBSUB_ENGINE_H */
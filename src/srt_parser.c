@@ -134,18 +134,23 @@ static int u8_len(const char *s) {
 static int visible_len(const char *s) {
     if (!s) return 0;
     int count = 0;
+    /* Once a closing '>' or '}' is known to be missing from the rest of the
+     * string, later openers are literal without rescanning (linear time). */
+    int no_gt = 0, no_brace = 0;
     const unsigned char *p = (const unsigned char *)s;
     while (*p) {
         /* Skip HTML tags: <...> */
-        if (*p == '<') {
+        if (*p == '<' && !no_gt) {
             const unsigned char *q = (const unsigned char *)strchr((const char *)p, '>');
             if (q) { p = q + 1; continue; }
+            no_gt = 1;
         }
         /* Skip ASS/Pango tags: {...}
          * This includes ASS alignment {\an<digit>}, color tags, style tags, etc. */
-        if (*p == '{') {
+        if (*p == '{' && !no_brace) {
             const unsigned char *q = (const unsigned char *)strchr((const char *)p, '}');
             if (q) { p = q + 1; continue; }
+            no_brace = 1;
         }
         /* Handle UTF-8 multibyte sequences */
         if ((*p & 0x80) == 0) {
@@ -183,9 +188,11 @@ static void normalize_cue_text_cleanup(char **buf, char **out, char **tmp) {
  * allocated string which the caller must free.
  *
  * The routine uses UTF-8 codepoint counting via u8_len so wrapping is
- * character-aware for non-ASCII languages.
+ * character-aware for non-ASCII languages. When a LineBreaker is given
+ * the joined text is instead wrapped by rendered width with balanced
+ * line breaks, so the renderer receives lines that already fit.
  */
-static char* normalize_cue_text(const char *raw, int is_hd) {
+static char* normalize_cue_text(const char *raw, int is_hd, LineBreaker *lb) {
     int max_lines = MAX_LINES_SD;
     int max_chars = is_hd ? MAX_CHARS_HD : MAX_CHARS_SD;
 
@@ -283,6 +290,12 @@ static char* normalize_cue_text(const char *raw, int is_hd) {
         free(plain);
     }
 
+    if (lb && !whole_cue_is_symbol) {
+        char *wrapped = line_breaker_wrap(lb, buf, max_lines);
+        normalize_cue_text_cleanup(&buf, &out, &tmp);
+        return wrapped;
+    }
+
     int line_len = 0, lines = 1;
 
     /* Process line by line, respecting embedded newlines */
@@ -459,14 +472,49 @@ static void rstrip(char *s) {
 }
 
 
+/*
+ * Alignment code of a cue from its raw text: the digit of the first
+ * "{\an" when it is 1..9, otherwise 2 (bottom centre). `*tagged` is set
+ * when the code came from the tag.
+ */
+static int raw_ass_alignment(const char *textbuf, int *tagged) {
+    const char *tag = strstr(textbuf, "{\\an");
+    *tagged = 0;
+    if (tag && strlen(tag) >= 5) {
+        int code = tag[4] - '0';
+        if (code >= 1 && code <= 9) {
+            *tagged = 1;
+            return code;
+        }
+    }
+    return 2;
+}
+
+/*
+ * Remove the first {\an<digit>} tag from normalized SRT text in place, so
+ * the renderer gets markup it can use without copying (the position is
+ * carried by SRTEntry.alignment instead).
+ */
+static void strip_ass_alignment(char *text) {
+    char *tag = strstr(text, "{\\an");
+    if (!tag || tag[4] < '0' || tag[4] > '9' || tag[5] != '}') return;
+    memmove(tag, tag + 6, strlen(tag + 6) + 1);
+}
+
 /*
  * Parse an ASS color override tag like "{\c&HBBGGRR&}" or "{\1c&H...&}"
  * and produce a Pango/CSS '#RRGGBB' color string in `out`.
  */
 static void parse_ass_color(const char *tag, char *out, size_t outsz) {
     unsigned int b=0,g=0,r=0;
-    if (sscanf(tag, "{\\c&H%02X%02X%02X&}", &b,&g,&r) == 3 ||
-        sscanf(tag, "{\\1c&H%02X%02X%02X&}", &b,&g,&r) == 3) {
+    /* sscanf() measures its whole input, so scan a copy of just the tag
+     * rather than the rest of the cue. */
+    char t[24];
+    size_t n = strnlen(tag, sizeof(t) - 1);
+    memcpy(t, tag, n);
+    t[n] = '\0';
+    if (sscanf(t, "{\\c&H%02X%02X%02X&}", &b,&g,&r) == 3 ||
+        sscanf(t, "{\\1c&H%02X%02X%02X&}", &b,&g,&r) == 3) {
         snprintf(out, outsz, "#%02X%02X%02X", r,g,b);
     } else {
         /* Use snprintf to ensure NUL-termination and avoid strncpy pitfalls */
@@ -475,29 +523,32 @@ static void parse_ass_color(const char *tag, char *out, size_t outsz) {
 }
 
 /*
- * Dynamically append `s` to a resizable buffer `*bufp` with capacity `*cap` and
- * current length `*lenp`. On success returns 0, on allocation failure returns -1.
- * The buffer is NUL-terminated and may be realloc'd; caller must update stored
- * pointers. This helper provides bounds-checked, growing-appends used by
- * tag/html normalization routines.
+ * Copy `n` bytes of `s` to `out` and return the new end. The tag
+ * converters size their output once up front, so appends need no
+ * bounds checks or reallocation.
  */
-static int dyn_append(char **bufp, size_t *cap, size_t *lenp, const char *s) {
-    if (!bufp || !cap || !lenp || !s) return -1;
-    size_t sl = strlen(s);
-    size_t cur = *lenp;
-    /* Ensure capacity for cur + sl + NUL */
-    if (cur + sl + 1 > *cap) {
-        size_t nc = *cap ? (*cap * 2 + sl + 16) : (sl + 16);
-        while (cur + sl + 1 > nc) nc = nc * 2 + 16;
-        char *nt = realloc(*bufp, nc);
-        if (!nt) return -1;
-        *bufp = nt;
-        *cap = nc;
-    }
-    memcpy((*bufp) + cur, s, sl);
-    (*bufp)[cur + sl] = '\0';
-    *lenp = cur + sl;
-    return 0;
+static char *emit(char *out, const char *s, size_t n) {
+    memcpy(out, s, n);
+    return out + n;
+}
+
+/*
+ * Memo for "first `ch` at or after x" lookups whose starting points never
+ * move backwards. A lookup that falls inside the range the previous scan
+ * covered reuses its answer (including "not found"), so each byte is
+ * scanned at most once per memo and a run of unterminated tags stays
+ * linear. Zero-initialise before use.
+ */
+typedef struct {
+    const char *from; /* start of the last scan, NULL before the first */
+    const char *at;   /* its result, NULL when `ch` does not occur */
+} NextChar;
+
+static const char *next_char(NextChar *m, const char *x, char ch) {
+    if (m->from && x >= m->from && (!m->at || x <= m->at)) return m->at;
+    m->from = x;
+    m->at = strchr(x, ch);
+    return m->at;
 }
 
 /* Centralized logging helper for this file. Levels: 0=always, 1=info, 2=debug.
@@ -763,35 +814,55 @@ static int process_cue_id(int cue_id, int *last_id,
 }
 
 /*
- * Replace ASS non-breaking space escape ("\h") with a normal space. 
+ * Replace ASS non-breaking space escapes ("\h") with a normal space, in
+ * place and in one pass.
  */
 static void replace_ass_h(char *text) {
-    if (!text) return;
-    char *p = text;
-    while ((p = strstr(p, "\\h")) != NULL) {
-        *p = ' ';                    // remove '\'
-        memmove(p+1, p+2, strlen(p+2)+1); // shift left to drop 'h'
-        p++;                         // continue after the inserted space
+    char *w = text ? strstr(text, "\\h") : NULL;
+    if (!w) return;
+    const char *r = w;
+    while (*r) {
+        if (r[0] == '\\' && r[1] == 'h') { *w++ = ' '; r += 2; }
+        else *w++ = *r++;
     }
+    *w = '\0';
 }
 
 
 /*
- * Remove ASS non-breaking space escape sequences completely. 
+ * Remove ASS non-breaking space escapes ("\h") completely, in place and in
+ * one pass.
  */
 static void remove_ass_h(char *text) {
-    if (!text) return;
-    char *p = text;
-    while ((p = strstr(p, "\\h")) != NULL) {
-        memmove(p, p + 2, strlen(p + 2) + 1); // shift left by 2 to drop "\h"
+    char *w = text ? strstr(text, "\\h") : NULL;
+    if (!w) return;
+    const char *r = w;
+    while (*r) {
+        if (r[0] == '\\' && r[1] == 'h') r += 2;
+        else *w++ = *r++;
     }
+    *w = '\0';
 }
 
+/* Closing tags on the normalize_tags() stack; compared by address. */
+static const char TAG_CLOSE_I[] = "</i>";
+static const char TAG_CLOSE_B[] = "</b>";
+static const char TAG_CLOSE_U[] = "</u>";
+static const char TAG_CLOSE_SPAN[] = "</span>";
+
 /*
- * Clean up resources allocated in normalize_tags on error.
+ * Close the innermost open tag whose closer is `closer`, together with
+ * every tag opened inside it, so the markup stays properly nested. Does
+ * nothing when no such tag is open.
  */
-static void normalize_tags_cleanup(char **tmp) {
-    if (tmp && *tmp) { free(*tmp); *tmp = NULL; }
+static char *close_tag(char *out, const char **stack, int *sp, const char *closer) {
+    int j = *sp - 1;
+    while (j >= 0 && stack[j] != closer) j--;
+    while (j >= 0 && *sp > j) {
+        const char *c = stack[--*sp];
+        out = emit(out, c, strlen(c));
+    }
+    return out;
 }
 
 /*
@@ -799,174 +870,97 @@ static void normalize_tags_cleanup(char **tmp) {
  * string is newly allocated and must be freed by the caller. This is a
  * lightweight translator intended for basic styling (bold/italic/underline,
  * color, font face). Complex ASS features like transforms are ignored.
+ *
+ * One forward pass: plain text is copied in runs up to the next '{', and
+ * each override is matched on its first letters. A closing override closes
+ * its tag and any opened inside it; tags beyond MAX_TAG_STACK deep are
+ * dropped. The output is allocated once: the costliest input is an
+ * unterminated colour override, where the '{' alone yields a span, its
+ * closer and a literal '{' (35 bytes) and the four following bytes are
+ * copied, so eight bytes per input byte always suffice.
  */
 static char* normalize_tags(const char *in) {
     if (!in) return NULL;
-    size_t cap = strlen(in)*6 + 256;
-    char *tmp = malloc(cap);
-    if (!tmp) return NULL;
-    tmp[0] = '\0';
-    size_t tmp_len = 0;
+    size_t len = strlen(in);
+    char *out = malloc(len * 8 + 1);
+    if (!out) return NULL;
+    char *o = out;
 
     const char *stack[MAX_TAG_STACK];
     int sp = 0;
+    NextChar brace = {0};
 
     const char *p = in;
     while (*p) {
-        if (!strncmp(p, "{\\i1}", 5)) {
-            if (dyn_append(&tmp, &cap, &tmp_len, "<i>") < 0) {
-                normalize_tags_cleanup(&tmp);
-                return NULL;
-            }
-            stack[sp++] = "</i>";
-            if (sp >= MAX_TAG_STACK) sp = MAX_TAG_STACK-1;
-            p += 5;
-        }
-        else if (!strncmp(p, "{\\i0}", 5)) {
-            for (int j=sp-1; j>=0; j--) {
-                if (strcmp(stack[j], "</i>")==0) {
-                    if (dyn_append(&tmp, &cap, &tmp_len, stack[j]) < 0) {
-                        normalize_tags_cleanup(&tmp);
-                        return NULL;
-                    }
-                    sp = j;
-                    break;
-                }
-            }
-            p += 5;
-        }
-        else if (!strncmp(p, "{\\b1}", 5)) {
-            if (dyn_append(&tmp, &cap, &tmp_len, "<b>") < 0) {
-                normalize_tags_cleanup(&tmp);
-                return NULL;
-            }
-            stack[sp++] = "</b>";
-            if (sp >= MAX_TAG_STACK) sp = MAX_TAG_STACK-1;
-            p += 5;
-        }
-        else if (!strncmp(p, "{\\b0}", 5)) {
-            for (int j=sp-1; j>=0; j--) {
-                if (strcmp(stack[j], "</b>")==0) {
-                    if (dyn_append(&tmp, &cap, &tmp_len, stack[j]) < 0) {
-                        normalize_tags_cleanup(&tmp);
-                        return NULL;
-                    }
-                    sp = j;
-                    break;
-                }
-            }
-            p += 5;
-        }
-        else if (!strncmp(p, "{\\u1}", 5)) {
-            if (dyn_append(&tmp, &cap, &tmp_len, "<u>") < 0) {
-                normalize_tags_cleanup(&tmp);
-                return NULL;
-            }
-            stack[sp++] = "</u>";
-            if (sp >= MAX_TAG_STACK) sp = MAX_TAG_STACK-1;
-            p += 5;
+        if (p[0] != '{' || p[1] != '\\') {
+            const char *q = strchr(p + 1, '{');
+            size_t n = q ? (size_t)(q - p) : strlen(p);
+            o = emit(o, p, n);
+            p += n;
+            continue;
         }
-        else if (!strncmp(p, "{\\u0}", 5)) {
-            for (int j=sp-1; j>=0; j--) {
-                if (strcmp(stack[j], "</u>")==0) {
-                    if (dyn_append(&tmp, &cap, &tmp_len, stack[j]) < 0) {
-                        normalize_tags_cleanup(&tmp);
-                        return NULL;
-                    }
-                    sp = j;
-                    break;
-                }
+        const char *t = p + 2; /* override name */
+        if ((t[0] == 'i' || t[0] == 'b' || t[0] == 'u') &&
+            (t[1] == '0' || t[1] == '1') && t[2] == '}') {
+            const char *closer = t[0] == 'i' ? TAG_CLOSE_I : t[0] == 'b' ? TAG_CLOSE_B : TAG_CLOSE_U;
+            if (t[1] == '0') {
+                o = close_tag(o, stack, &sp, closer);
+            } else if (sp < MAX_TAG_STACK) {
+                char open[4] = { '<', t[0], '>', '\0' };
+                o = emit(o, open, 3);
+                stack[sp++] = closer;
             }
             p += 5;
         }
-        else if (!strncmp(p, "{\\c&H", 5) || !strncmp(p, "{\\1c&H", 6)) {
-            for (int j=sp-1; j>=0; j--) {
-                if (strncmp(stack[j], "</span>", 7)==0) {
-                    if (dyn_append(&tmp, &cap, &tmp_len, stack[j]) < 0) {
-                        normalize_tags_cleanup(&tmp);
-                        return NULL;
-                    }
-                    sp = j;
-                    break;
-                }
-            }
-            char color[16];
-            parse_ass_color(p, color, sizeof(color));
-            char span[64];
-            snprintf(span, sizeof(span), "<span foreground=\"%s\">", color);
-            if (dyn_append(&tmp, &cap, &tmp_len, span) < 0) {
-                normalize_tags_cleanup(&tmp);
-                return NULL;
-            }
-            stack[sp++] = "</span>";
-            if (sp >= MAX_TAG_STACK) sp = MAX_TAG_STACK-1;
-            const char *q = strchr(p, '}');
-            if (q) p = q+1;
-            else {
-                if (dyn_append(&tmp, &cap, &tmp_len, "{") < 0) {
-                    normalize_tags_cleanup(&tmp);
-                    return NULL;
-                }
-                p++;
-            }
-        }
-        else if (!strncmp(p, "{\\fn", 4)) {
-            for (int j=sp-1; j>=0; j--) {
-                if (strncmp(stack[j], "</span>", 7)==0) {
-                    if (dyn_append(&tmp, &cap, &tmp_len, stack[j]) < 0) {
-                        normalize_tags_cleanup(&tmp);
-                        return NULL;
-                    }
-                    sp = j;
-                    break;
-                }
-            }
-            const char *q = strchr(p, '}');
+        else if (!strncmp(t, "c&H", 3) || !strncmp(t, "1c&H", 4)) {
+            o = close_tag(o, stack, &sp, TAG_CLOSE_SPAN);
+            if (sp < MAX_TAG_STACK) {
+                char color[16];
+                parse_ass_color(p, color, sizeof(color));
+                char span[64];
+                int n = snprintf(span, sizeof(span), "<span foreground=\"%s\">", color);
+                o = emit(o, span, (size_t)n);
+                stack[sp++] = TAG_CLOSE_SPAN;
+            }
+            const char *q = next_char(&brace, p, '}');
+            if (q) p = q + 1;
+            else { *o++ = '{'; p++; }
+        }
+        else if (!strncmp(t, "fn", 2)) {
+            o = close_tag(o, stack, &sp, TAG_CLOSE_SPAN);
+            const char *q = next_char(&brace, p, '}');
             if (q) {
-                char fontname[128];
-                size_t len = (size_t)(q - (p+3));
-                if (len >= sizeof(fontname)) len = sizeof(fontname)-1;
-                memcpy(fontname, p+3, len);
-                fontname[len] = 0;
-                char span[256];
-                snprintf(span, sizeof(span), "<span font=\"%s\">", fontname);
-                if (dyn_append(&tmp, &cap, &tmp_len, span) < 0) {
-                    normalize_tags_cleanup(&tmp);
-                    return NULL;
+                size_t n = (size_t)(q - (t + 2));
+                if (n > 127) n = 127;
+                if (sp < MAX_TAG_STACK) {
+                    o = emit(o, "<span font=\"", 12);
+                    o = emit(o, t + 2, n);
+                    o = emit(o, "\">", 2);
+                    stack[sp++] = TAG_CLOSE_SPAN;
                 }
-                stack[sp++] = "</span>";
-                if (sp >= MAX_TAG_STACK) sp = MAX_TAG_STACK-1;
-                p = q+1;
+                p = q + 1;
             } else {
+                *o++ = '{';
                 p++;
             }
         }
-        else if (!strncmp(p, "{\\pos", 5) || !strncmp(p, "{\\move", 6) ||
-                 !strncmp(p, "{\\fad", 5) || !strncmp(p, "{\\org", 5)) {
-            const char *q = strchr(p, '}');
-            if (q) p = q+1;
-            else { if (dyn_append(&tmp, &cap, &tmp_len, "{") < 0) {
-                normalize_tags_cleanup(&tmp);
-                return NULL;
-            } p++; }
+        else if (!strncmp(t, "pos", 3) || !strncmp(t, "move", 4) ||
+                 !strncmp(t, "fad", 3) || !strncmp(t, "org", 3)) {
+            const char *q = next_char(&brace, p, '}');
+            if (q) p = q + 1;
+            else { *o++ = '{'; p++; }
         }
         else {
-            char one[2] = { *p++, '\0' };
-            if (dyn_append(&tmp, &cap, &tmp_len, one) < 0) {
-                normalize_tags_cleanup(&tmp);
-                return NULL;
-            }
+            *o++ = *p++;
         }
     }
 
-    for (int j=sp-1; j>=0; j--) {
-        if (dyn_append(&tmp, &cap, &tmp_len, stack[j]) < 0) {
-            normalize_tags_cleanup(&tmp);
-            return NULL;
-        }
+    while (sp > 0) {
+        const char *c = stack[--sp];
+        o = emit(o, c, strlen(c));
     }
-
-    return tmp;
+    *o = '\0';
+    return out;
 }
 
 /*
@@ -983,7 +977,8 @@ static char* normalize_tags(const char *in) {
  * wrappers call this with either global values or explicit config.
  */
 static int parse_srt_internal(const char *filename, SRTEntry **entries_out, FILE *qc,
-                              int use_ass_local, int video_w_local, int video_h_local) {
+                              int use_ass_local, int video_w_local, int video_h_local,
+                              LineBreaker *line_breaker) {
     extern int debug_level;
     
     FILE *f = fopen(filename, "r");
@@ -1047,12 +1042,16 @@ static int parse_srt_internal(const char *filename, SRTEntry **entries_out, FILE
         }
 
         char textbuf[8192] = {0};
+        size_t text_len = 0;
         while (fgets(line, sizeof(line), f)) {
             rstrip(line);
-            if (strlen(line) == 0) break;
-            if (strlen(textbuf)+strlen(line)+2 < sizeof(textbuf)) {
-                strcat(textbuf, line);
-                strcat(textbuf, "\n");
+            size_t line_len = strlen(line);
+            if (line_len == 0) break;
+            if (text_len + line_len + 2 < sizeof(textbuf)) {
+                memcpy(textbuf + text_len, line, line_len);
+                text_len += line_len;
+                textbuf[text_len++] = '\n';
+                textbuf[text_len] = '\0';
             }
         }
 
@@ -1090,7 +1089,7 @@ static int parse_srt_internal(const char *filename, SRTEntry **entries_out, FILE
             }
             replace_ass_h(norm);
         } else {
-            norm = normalize_cue_text(textbuf, is_hd);
+            norm = normalize_cue_text(textbuf, is_hd, line_breaker);
             if (!norm) {
                 if (debug_level > 0) sp_log(1, "allocation failed normalizing cue text for cue %d in '%s'\n", (int)n, filename);
                 for (size_t i = 0; i < n; i++) free((*entries_out)[i].text);
@@ -1102,6 +1101,7 @@ static int parse_srt_internal(const char *filename, SRTEntry **entries_out, FILE
             remove_ass_h(norm);
             /* Strip any trailing newlines/CR that might have been added during normalization */
             rstrip(norm);
+            strip_ass_alignment(norm);
     }
 
         (*entries_out)[n].start_ms = start;
@@ -1136,13 +1136,7 @@ static int parse_srt_internal(const char *filename, SRTEntry **entries_out, FILE
                 norm);
         }
 
-        int align = 2;
-        const char *tag = strstr(textbuf, "{\\an");
-        if (tag && strlen(tag) >= 5) {
-            int code = tag[4]-'0';
-            if (code >=1 && code <=9) align = code;
-        }
-        (*entries_out)[n].alignment = align;
+        (*entries_out)[n].alignment = raw_ass_alignment(textbuf, &(*entries_out)[n].alignment_tag);
 
     /* Use stripped text (no HTML/ASS tags) for QC length checks */
         char *plain = strip_tags((*entries_out)[n].text);
@@ -1182,14 +1176,15 @@ static int parse_srt_internal(const char *filename, SRTEntry **entries_out, FILE
 
 /* Backwards-compatible wrapper that reads configuration from globals. */
 int parse_srt(const char *filename, SRTEntry **entries_out, FILE *qc) {
-    return parse_srt_internal(filename, entries_out, qc, use_ass, video_w, video_h);
+    return parse_srt_internal(filename, entries_out, qc, use_ass, video_w, video_h, NULL);
 }
 
 /* Public API accepting explicit configuration. If cfg is NULL, fallback
  * to using global variables to preserve compatibility.
  */
 int parse_srt_cfg(const char *filename, SRTEntry **entries_out, FILE *qc, const SRTParserConfig *cfg) {
-    if (cfg) return parse_srt_internal(filename, entries_out, qc, cfg->use_ass, cfg->video_w, cfg->video_h);
+    if (cfg) return parse_srt_internal(filename, entries_out, qc, cfg->use_ass, cfg->video_w, cfg->video_h,
+                                       cfg->line_breaker);
     return parse_srt(filename, entries_out, qc);
 }
 
@@ -1308,17 +1303,21 @@ int parse_srt_with_stats(const char *filename, SRTEntry **entries_out, FILE *qc,
         }
 
         char textbuf[8192] = {0};
+        size_t text_len = 0;
         while (fgets(line, sizeof(line), f)) {
             rstrip(line);
-            if (strlen(line) == 0) break;
-            if (strlen(textbuf)+strlen(line)+2 < sizeof(textbuf)) {
-                strcat(textbuf, line);
-                strcat(textbuf, "\n");
+            size_t line_len = strlen(line);
+            if (line_len == 0) break;
+            if (text_len + line_len + 2 < sizeof(textbuf)) {
+                memcpy(textbuf + text_len, line, line_len);
+                text_len += line_len;
+                textbuf[text_len++] = '\n';
+                textbuf[text_len] = '\0';
             }
         }
         
         /* Check for empty text */
-        if (strlen(textbuf) == 0) {
+        if (text_len == 0) {
             if (stats_out) {
                 stats_out->skipped_cues++;
                 stats_out->validation_warnings++;
@@ -1363,7 +1362,7 @@ int parse_srt_with_stats(const char *filename, SRTEntry **entries_out, FILE *qc,
             }
             replace_ass_h(norm);
         } else {
-            norm = normalize_cue_text(textbuf_sanitized, is_hd);
+            norm = normalize_cue_text(textbuf_sanitized, is_hd, cfg->line_breaker);
             if (!norm) {
                 if (stats_out) stats_out->skipped_cues++;
                 free(textbuf_sanitized);
@@ -1371,6 +1370,7 @@ int parse_srt_with_stats(const char *filename, SRTEntry **entries_out, FILE *qc,
             }
             remove_ass_h(norm);
             rstrip(norm);
+            strip_ass_alignment(norm);
         }
 
         if (textbuf_sanitized != textbuf) {
@@ -1435,13 +1435,15 @@ int parse_srt_with_stats(const char *filename, SRTEntry **entries_out, FILE *qc,
             }
         }
 
-        int align = 2;
-        const char *tag = strstr(textbuf, "{\\an");
-        if (tag && strlen(tag) >= 5) {
-            int code = tag[4]-'0';
-            if (code >= 1 && code <= 9) align = code;
+        (*entries_out)[n].alignment = raw_ass_alignment(textbuf, &(*entries_out)[n].alignment_tag);
+
+        /* With defer_qc the caller checks the whole track afterwards
+         * (qc_check_track); the stripped text is then only needed for
+         * the verbose cue log below. */
+        if (cfg->defer_qc && debug_level <= 1) {
+            n++;
+            continue;
         }
-        (*entries_out)[n].alignment = align;
 
         char *plain = strip_tags((*entries_out)[n].text);
         if (!plain) {
@@ -1452,8 +1454,9 @@ int parse_srt_with_stats(const char *filename, SRTEntry **entries_out, FILE *qc,
         SRTEntry tmp = (*entries_out)[n];
         tmp.text = plain;
 
-        qc_check_entry(filename, (int)n, &tmp,
-                       (n > 0 ? &(*entries_out)[n-1] : NULL), qc);
+        if (!cfg->defer_qc)
+            qc_check_entry(filename, (int)n, &tmp,
+                           (n > 0 ? &(*entries_out)[n-1] : NULL), qc);
 
         if (debug_level > 1) {
             sp_log(2, "Cue %d: %lld → %lld ms (%lld ms) | text='%s'\n",
@@ -1492,124 +1495,76 @@ int parse_srt_with_stats(const char *filename, SRTEntry **entries_out, FILE *qc,
     return (int)n;
 }
 
-/*
- * Clean up resources allocated in srt_html_to_ass on error.
- */
-static void srt_html_to_ass_cleanup(char **out) {
-    if (out && *out) { free(*out); *out = NULL; }
-}
-
 /* 
  * Convert minimal HTML tags (<i>, <b>, <font color>) into ASS overrides.
  * The caller frees the returned string. 
+ *
+ * One forward pass: text is copied in runs up to the next '<' or line
+ * break, and the attribute quotes of <font> tags are found through
+ * NextChar memos, so unterminated tags do not rescan the cue. No
+ * conversion more than doubles its input ("\n" becomes "\N", "<i>"
+ * becomes "{\i1}"; <font> tags shrink), so the output is allocated once.
  */
 char* srt_html_to_ass(const char *in) {
     if (!in) return NULL;
-    size_t cap = strlen(in) * 8 + 128;
-    char *out = malloc(cap);
+    size_t len = strlen(in);
+    char *out = malloc(len * 2 + 1);
     if (!out) return NULL;
-    out[0] = '\0';
-    size_t out_len = 0;
+    char *o = out;
+    NextChar open_quote = {0}, close_quote = {0};
     const char *p = in;
     while (*p) {
-        if (!strncasecmp(p,"<i>",3)) {
-            if (dyn_append(&out,&cap,&out_len,"{\\i1}") < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
-            }
-            p+=3;
-        }
-        else if (!strncasecmp(p,"</i>",4)) {
-            if (dyn_append(&out,&cap,&out_len,"{\\i0}") < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
-            }
-            p+=4;
-        }
-        else if (!strncasecmp(p,"<b>",3)) {
-            if (dyn_append(&out,&cap,&out_len,"{\\b1}") < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
-            }
-            p+=3;
+        if (*p == '\n') { o = emit(o, "\\N", 2); p++; continue; }
+        if (*p == '\r') { p++; continue; }
+        if (*p != '<') {
+            size_t n = strcspn(p, "<\n\r");
+            o = emit(o, p, n);
+            p += n;
+            continue;
         }
-        else if (!strncasecmp(p,"</b>",4)) {
-            if (dyn_append(&out,&cap,&out_len,"{\\b0}") < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
-            }
-            p+=4;
-        }
-        else if (!strncasecmp(p,"<font color=",12)) {
-            const char *q = strchr(p,'"'); if (!q) { p++; continue; }
-            const char *r = strchr(q+1,'"'); if (!r) { p++; continue; }
-            char color[16];
-            size_t color_len = (size_t)(r - (q+1));
-            if (color_len >= sizeof(color)) color_len = sizeof(color) - 1;
-            memcpy(color, q+1, color_len);
-            color[color_len] = 0;
-            unsigned rr=255,gg=255,bb=255;
-            unsigned aa=255;
-            size_t clen = strlen(color);
-            if (color[0]=='#' && clen==7) {
-                sscanf(color+1,"%02x%02x%02x",&rr,&gg,&bb);
-            } else if (color[0]=='#' && clen==9) {
-                sscanf(color+1,"%02x%02x%02x%02x",&rr,&gg,&bb,&aa);
-            }
-            char tag[96];
-            if (clen==9) {
-                unsigned ass_a = 255 - (aa & 0xFF); /* ASS alpha: 00 opaque, FF transparent */
-                snprintf(tag,sizeof(tag),"{\\1c&H%02X%02X%02X&\\1a&H%02X&}",rr,gg,bb,ass_a);
-            } else {
-                snprintf(tag,sizeof(tag),"{\\1c&H%02X%02X%02X&}",rr,gg,bb);
-            }
-            if (dyn_append(&out,&cap,&out_len,tag) < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
-            }
-            p = r+2; // skip ">"
-        }
-        else if (!strncasecmp(p,"<font face=",11)) {
-            const char *q = strchr(p,'"'); if (!q) { p++; continue; }
-            const char *r = strchr(q+1,'"'); if (!r) { p++; continue; }
-            char face[64];
-            size_t face_len = (size_t)(r - (q+1));
-            if (face_len >= sizeof(face)) face_len = sizeof(face) - 1;
-            memcpy(face, q+1, face_len);
-            face[face_len] = 0;
+        if (!strncasecmp(p,"<i>",3)) { o = emit(o, "{\\i1}", 5); p+=3; }
+        else if (!strncasecmp(p,"</i>",4)) { o = emit(o, "{\\i0}", 5); p+=4; }
+        else if (!strncasecmp(p,"<b>",3)) { o = emit(o, "{\\b1}", 5); p+=3; }
+        else if (!strncasecmp(p,"</b>",4)) { o = emit(o, "{\\b0}", 5); p+=4; }
+        else if (!strncasecmp(p,"</font>",7)) { o = emit(o, "{\\r}", 4); p+=7; }
+        else if (!strncasecmp(p,"<font color=",12) || !strncasecmp(p,"<font face=",11)) {
+            int is_color = (p[6] == 'c' || p[6] == 'C');
+            const char *q = next_char(&open_quote, p, '"');
+            const char *r = q ? next_char(&close_quote, q + 1, '"') : NULL;
+            if (!r) { p++; continue; }
             char tag[128];
-            snprintf(tag,sizeof(tag),"{\\fn%s}",face);
-            if (dyn_append(&out,&cap,&out_len,tag) < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
-            }
-            p = r+2; // skip ">"
-        }
-        else if (!strncasecmp(p,"</font>",7)) {
-            if (dyn_append(&out,&cap,&out_len,"{\\r}") < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
-            }
-            p+=7;
-        }
-        else if (*p == '\n') {
-            if (dyn_append(&out,&cap,&out_len,"\\N") < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
+            size_t vlen = (size_t)(r - (q+1));
+            if (is_color) {
+                char color[16];
+                if (vlen >= sizeof(color)) vlen = sizeof(color) - 1;
+                memcpy(color, q+1, vlen);
+                color[vlen] = 0;
+                unsigned rr=255,gg=255,bb=255;
+                unsigned aa=255;
+                if (color[0]=='#' && vlen==7) {
+                    sscanf(color+1,"%02x%02x%02x",&rr,&gg,&bb);
+                } else if (color[0]=='#' && vlen==9) {
+                    sscanf(color+1,"%02x%02x%02x%02x",&rr,&gg,&bb,&aa);
+                }
+                if (vlen==9) {
+                    unsigned ass_a = 255 - (aa & 0xFF); /* ASS alpha: 00 opaque, FF transparent */
+                    snprintf(tag,sizeof(tag),"{\\1c&H%02X%02X%02X&\\1a&H%02X&}",rr,gg,bb,ass_a);
+                } else {
+                    snprintf(tag,sizeof(tag),"{\\1c&H%02X%02X%02X&}",rr,gg,bb);
+                }
+            } else {
+                if (vlen > 63) vlen = 63;
+                snprintf(tag,sizeof(tag),"{\\fn%.*s}",(int)vlen,q+1);
             }
-            p++;
-        }
-        else if (*p == '\r') {
-            p++;
+            o = emit(o, tag, strlen(tag));
+            p = r + 1;
+            if (*p == '>') p++; // skip ">" (absent when the tag is cut off)
         }
         else {
-            char one[2] = { *p++, '\0' };
-            if (dyn_append(&out,&cap,&out_len,one) < 0) {
-                srt_html_to_ass_cleanup(&out);
-                return NULL;
-            }
+            *o++ = *p++;
         }
     }
+    *o = '\0';
     return out;
 }
 
@@ -1628,22 +1583,27 @@ char* strip_tags(const char *in) {
     char *out = malloc(in_len + 1);
     if (!out) return NULL;
     size_t j = 0;
+    /* Set once the rest of the input has no closing '}' / '>', so runs of
+     * unclosed openers are copied without rescanning to the end each time. */
+    int no_brace = 0, no_gt = 0;
     for (size_t i = 0; i < in_len; i++) {
-        if (in[i] == '{') {
+        if (in[i] == '{' && !no_brace) {
             const char *q = strchr(in + i, '}');
             if (q) {
                 /* skip the tag including closing brace */
                 i = (size_t)(q - in);
             } else {
                 /* no closing brace — treat '{' as literal */
+                no_brace = 1;
                 out[j++] = in[i];
             }
         }
-        else if (in[i] == '<') {
+        else if (in[i] == '<' && !no_gt) {
             const char *q = strchr(in + i, '>');
             if (q) {
                 i = (size_t)(q - in);
             } else {
+                no_gt = 1;
                 out[j++] = in[i];
             }
         }
@@ -54,6 +54,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include "line_break.h"
 
 /*
  * @file srt_parser.h
@@ -78,7 +79,9 @@ typedef struct {
     int64_t start_ms; /**< start time in milliseconds */
     int64_t end_ms;   /**< end time in milliseconds */
     char *text;       /**< UTF-8 markup text (caller frees) */
-    int alignment;    /**< alignment code parsed from {\anX} (1..9) */
+    int alignment;    /**< alignment code parsed from {\anX} (1..9), 2 when the cue has none */
+    int alignment_tag; /**< non-zero when `alignment` came from an {\anX} tag. For
+                        *   non-ASS cues that tag is removed from `text`. */
 } SRTEntry;
 
 /*
@@ -119,6 +122,14 @@ typedef struct {
     int auto_fix_encoding;    /* Auto-sanitize invalid UTF-8 (1=yes, 0=no) */
     int warn_on_short_duration;  /* Warn if cue duration < 100ms */
     int warn_on_long_duration;   /* Warn if cue duration > 30 seconds */
+
+    /* Width-aware balanced wrapping with the render font (NULL = wrap by
+     * character count). Not owned by the parser. */
+    LineBreaker *line_breaker;
+
+    /* Skip the per-cue QC checks (parse_srt_with_stats only); the caller
+     * runs qc_check_track() on the parsed track instead. */
+    int defer_qc;
 } SRTParserConfig;
 
 /*
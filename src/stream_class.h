@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef STREAM_CLASS_H
+#define STREAM_CLASS_H
+
+#include <stdint.h>
+
+/**
+ * @file stream_class.h
+ * @brief Per-stream packet classes for the demux loop.
+ *
+ * The demux loop classifies every input stream once, before reading
+ * packets. Only clock streams advance the cue scheduler. Passthrough
+ * streams (audio, data) are handed straight to the muxer, and
+ * overwritten subtitle streams are dropped. Each entry also carries the
+ * stream's time base reduced against 90 kHz, so a clock packet's PTS is
+ * a single multiply for the common time bases (1/90000, 1/1000, ...).
+ *
+ * Kept free of libav types so testharness/demux_class_bench.c can time
+ * the dispatch without FFmpeg.
+ */
+
+/** Timestamp sentinel; same value as AV_NOPTS_VALUE. */
+#define STREAM_CLASS_NOPTS INT64_MIN
+
+typedef enum {
+    STREAM_CLASS_DROP = 0,  /**< overwritten subtitle stream: discard */
+    STREAM_CLASS_PASS = 1,  /**< audio/data/other: mux without timing work */
+    STREAM_CLASS_CLOCK = 2  /**< drives cue emission (video, or all when none) */
+} StreamClassKind;
+
+typedef struct {
+    int kind;          /**< StreamClassKind */
+    int64_t mul90;     /**< time base * 90000 as mul90 / div90, reduced */
+    int64_t div90;     /**< 1 for time bases that divide 1/90000 exactly */
+} StreamClass;
+
+/**
+ * Fill `sc` for a stream of time base `tb_num`/`tb_den`. A non-positive
+ * time base is treated as 1/90000.
+ */
+void stream_class_init(StreamClass *sc, StreamClassKind kind, int tb_num, int tb_den);
+
+/** Short name of a class for logs ("drop", "pass", "clock"). */
+const char *stream_class_name(int kind);
+
+/**
+ * Rescale `ts` from the stream time base to 90 kHz, rounding halves away
+ * from zero like av_rescale_q(). STREAM_CLASS_NOPTS passes through.
+ */
+static inline int64_t stream_class_to90(const StreamClass *sc, int64_t ts)
+{
+    if (ts == STREAM_CLASS_NOPTS)
+        return STREAM_CLASS_NOPTS;
+    if (sc->div90 == 1)
+        return ts * sc->mul90;
+    __int128 p = (__int128)(ts < 0 ? -ts : ts) * sc->mul90 + sc->div90 / 2;
+    int64_t r = (int64_t)(p / sc->div90);
+    return ts < 0 ? -r : r;
+}
+
+#endif /* STREAM_CLASS_H */
@@ -0,0 +1,228 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * sub_encode.c
+ * ------------
+ * Per-worker DVB subtitle encoding for the render pool. The worker state
+ * holds one opened AVCodecContext per track plus a reusable output
+ * buffer that grows on demand, mirroring the per-track buffer policy of
+ * muxsub.c.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/mem.h>
+#include "sub_encode.h"
+#include "dvb_sub.h"
+#include "bench.h"
+
+#define DEBUG_MODULE "sub_encode"
+#include "debug.h"
+
+#define SUB_ENCODE_BUF_SIZE 65536
+#define SUB_ENCODE_MAX_BUF_SIZE (1 << 20)
+
+typedef struct {
+    AVCodecContext *enc[SUB_ENCODE_MAX_TRACKS];
+    uint8_t *buf;
+    int buf_size;
+    SubEncodeBench bench;
+} SubEncodeWorker;
+
+/* Open a dvbsub encoder matching the track's main encoder setup. */
+static AVCodecContext *open_track_encoder(int width, int height, int bitexact) {
+    const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_DVB_SUBTITLE);
+    if (!codec) return NULL;
+    AVCodecContext *c = avcodec_alloc_context3(codec);
+    if (!c) return NULL;
+    c->time_base = (AVRational){1, 90000};
+    c->width = width;
+    c->height = height;
+    if (bitexact)
+        c->flags |= AV_CODEC_FLAG_BITEXACT;
+    if (avcodec_open2(c, codec, NULL) < 0) {
+        avcodec_free_context(&c);
+        return NULL;
+    }
+    return c;
+}
+
+int sub_encode_worker_hook(void *opaque, void **worker_state, int track_id,
+                           const Bitmap *bm, int64_t duration_ms,
+                           RenderPayload *out) {
+    const SubEncodeConfig *cfg = opaque;
+    if (!cfg || !worker_state || !bm || !out) return -1;
+    if (track_id < 0 || track_id >= SUB_ENCODE_MAX_TRACKS) return -1;
+
+    SubEncodeWorker *w = *worker_state;
+    if (!w) {
+        w = calloc(1, sizeof(*w));
+        if (!w) return -1;
+        *worker_state = w;
+    }
+    if (!w->enc[track_id]) {
+        w->enc[track_id] = open_track_encoder(cfg->width[track_id], cfg->height[track_id],
+                                              cfg->bitexact);
+        if (!w->enc[track_id]) {
+            LOG(1, "cannot open worker dvbsub encoder for track %d\n", track_id);
+            return -1;
+        }
+    }
+    if (!w->buf) {
+        w->buf = av_malloc(SUB_ENCODE_BUF_SIZE);
+        if (!w->buf) return -1;
+        w->buf_size = SUB_ENCODE_BUF_SIZE;
+    }
+
+    AVSubtitle *sub = make_subtitle(*bm, 0, duration_ms);
+    if (!sub) return -1;
+    sub->start_display_time = 0;
+
+    int64_t t_enc = bench_now();
+    int size = avcodec_encode_subtitle(w->enc[track_id], w->buf, w->buf_size, sub);
+    /* A full (or rejected) buffer may mean truncation: grow and retry. */
+    while ((size < 0 || size >= w->buf_size) && w->buf_size < SUB_ENCODE_MAX_BUF_SIZE) {
+        int new_size = w->buf_size * 2;
+        uint8_t *nb = av_realloc(w->buf, new_size);
+        if (!nb) break;
+        w->buf = nb;
+        w->buf_size = new_size;
+        size = avcodec_encode_subtitle(w->enc[track_id], w->buf, w->buf_size, sub);
+    }
+    if (cfg->bench_mode) {
+        bench_add_encode_us(bench_now() - t_enc);
+        sub_encode_bench_depth(&w->bench, track_id, bm, sub,
+                               cfg->width[track_id], cfg->height[track_id]);
+    }
+    avsubtitle_free(sub);
+    av_free(sub);
+
+    if (size <= 0) {
+        LOG(2, "worker encoder produced no bytes (size=%d) [track=%d]\n", size, track_id);
+        return -1;
+    }
+    out->data = av_malloc(size);
+    if (!out->data) return -1;
+    memcpy(out->data, w->buf, size);
+    out->size = size;
+    if (cfg->bench_mode)
+        bench_inc_cues_encoded();
+    return 0;
+}
+
+/* Encode into a scratch buffer; returns the size and the encode time. */
+static int timed_encode(AVCodecContext *c, uint8_t *buf, int buf_size,
+                        const AVSubtitle *sub, int64_t *us) {
+    int64_t t0 = bench_now();
+    int size = avcodec_encode_subtitle(c, buf, buf_size, sub);
+    *us = bench_now() - t0;
+    return size;
+}
+
+void sub_encode_bench_depth(SubEncodeBench *b, int track_id, const Bitmap *bm,
+                            const AVSubtitle *sub, int width, int height) {
+    if (!bm || !sub || sub->num_rects < 1 || !sub->rects || !sub->rects[0])
+        return;
+    int bits = dvb_sub_depth_bits(sub->rects[0]->nb_colors);
+    AVSubtitle *full = make_subtitle_depth(*bm, 0, sub->end_display_time, 0);
+    if (!b || track_id < 0 || track_id >= SUB_ENCODE_MAX_TRACKS ||
+        !full || full->num_rects < 1 ||
+        full->rects[0]->nb_colors == sub->rects[0]->nb_colors) {
+        bench_add_depth(track_id, bits, 0, 0);
+        if (full) free_subtitle(&full);
+        return;
+    }
+    if (!b->buf)
+        b->buf = av_malloc(SUB_ENCODE_MAX_BUF_SIZE);
+    if (!b->enc[track_id] && b->buf) {
+        b->enc[track_id] = open_track_encoder(width, height, 0);
+        /* Untimed warm-up, so the first timed encode is not charged
+         * for the context's cold start. */
+        if (b->enc[track_id])
+            avcodec_encode_subtitle(b->enc[track_id], b->buf, SUB_ENCODE_MAX_BUF_SIZE, full);
+    }
+    AVCodecContext *c = b->enc[track_id];
+    if (c && b->buf) {
+        int64_t us_fit = 0, us_full = 0;
+        int fit_size, full_size;
+        /* Alternate the order so neither depth always runs second on
+         * caches the other one warmed. */
+        if (b->runs++ & 1) {
+            full_size = timed_encode(c, b->buf, SUB_ENCODE_MAX_BUF_SIZE, full, &us_full);
+            fit_size = timed_encode(c, b->buf, SUB_ENCODE_MAX_BUF_SIZE, sub, &us_fit);
+        } else {
+            fit_size = timed_encode(c, b->buf, SUB_ENCODE_MAX_BUF_SIZE, sub, &us_fit);
+            full_size = timed_encode(c, b->buf, SUB_ENCODE_MAX_BUF_SIZE, full, &us_full);
+        }
+        if (fit_size > 0 && full_size > 0)
+            bench_add_depth(track_id, bits, full_size - fit_size, us_full - us_fit);
+    }
+    free_subtitle(&full);
+}
+
+void sub_encode_bench_release(SubEncodeBench *b) {
+    if (!b) return;
+    for (int i = 0; i < SUB_ENCODE_MAX_TRACKS; i++)
+        avcodec_free_context(&b->enc[i]);
+    av_freep(&b->buf);
+    b->runs = 0;
+}
+
+void sub_encode_worker_release(void *opaque, void *worker_state) {
+    (void)opaque;
+    SubEncodeWorker *w = worker_state;
+    if (!w) return;
+    for (int i = 0; i < SUB_ENCODE_MAX_TRACKS; i++)
+        avcodec_free_context(&w->enc[i]);
+    av_free(w->buf);
+    sub_encode_bench_release(&w->bench);
+    free(w);
+}
@@ -0,0 +1,112 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef SUB_ENCODE_H
+#define SUB_ENCODE_H
+
+#include <stdint.h>
+#include <libavcodec/avcodec.h>
+#include "render_pool.h"
+
+/**
+ * @file sub_encode.h
+ * @brief DVB subtitle encode hook run inside render pool workers.
+ *
+ * Installed with render_pool_ctx_set_encoder(), this hook turns each
+ * rendered Bitmap into DVB subtitle bytes on the worker thread, so the
+ * mux thread only stamps PTS and writes. Every worker lazily opens its
+ * own dvbsub encoder context per track (libavcodec contexts are not
+ * shareable across threads); the mux side re-stamps DVB version fields
+ * so payloads from different workers form one consistent stream.
+ */
+
+#define SUB_ENCODE_MAX_TRACKS 8
+
+/** Encoder canvas per track, filled by the caller before submitting jobs. */
+typedef struct {
+    int width[SUB_ENCODE_MAX_TRACKS];
+    int height[SUB_ENCODE_MAX_TRACKS];
+    int bench_mode; /**< non-zero: account encode time/counters in `bench` */
+    int bitexact;   /**< non-zero: open encoders with AV_CODEC_FLAG_BITEXACT */
+} SubEncodeConfig;
+
+/** RenderEncodeFn: `opaque` is a SubEncodeConfig that outlives the pool. */
+int sub_encode_worker_hook(void *opaque, void **worker_state, int track_id,
+                           const Bitmap *bm, int64_t duration_ms,
+                           RenderPayload *out);
+
+/** RenderEncodeReleaseFn: free a worker's encoder contexts. */
+void sub_encode_worker_release(void *opaque, void *worker_state);
+
+/**
+ * Comparison encoders for sub_encode_bench_depth(): one per track plus a
+ * scratch buffer, opened on first use and kept for later cues. Start it
+ * zeroed, use it from one thread only and free it with
+ * sub_encode_bench_release().
+ */
+typedef struct {
+    AVCodecContext *enc[SUB_ENCODE_MAX_TRACKS];
+    uint8_t *buf;
+    unsigned runs; /**< comparisons so far; odd runs encode full depth first */
+} SubEncodeBench;
+
+/**
+ * --bench accounting for the adaptive palette depth. Records the region
+ * depth of `sub` (built from `bm` by make_subtitle()) and, when its
+ * palette was fitted, encodes it and a full-depth copy of `bm` on the
+ * track's comparison encoder in `b` to measure the bytes and encode time
+ * saved. Only the bench run pays for the extra encodes.
+ */
+void sub_encode_bench_depth(SubEncodeBench *b, int track_id, const Bitmap *bm,
+                            const AVSubtitle *sub, int width, int height);
+
+/** Free the comparison encoders and buffer; `b` can be reused after. */
+void sub_encode_bench_release(SubEncodeBench *b);
+
+#endif /* SUB_ENCODE_H */
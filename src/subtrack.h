@@ -54,6 +54,7 @@
 #include <libavcodec/avcodec.h>
 #include "srt_parser.h"
 #include "render_ass.h"
+#include "cue_timeline.h"
 
 /*
  * @file subtrack.h
@@ -73,6 +74,8 @@
  *  - `entries` is a malloc'd array returned by the SRT parser; the
  *    SubTrack owner is responsible for freeing each entry->text and the
  *    array itself when the track is torn down.
+ *  - `markup` caches the Pango markup of each cue, built on first use and
+ *    freed with the entries; render jobs borrow these strings.
  *  - `stream` and `codec_ctx` are owned by the muxer/encoder subsystem
  *    and should not be free()'d by callers of SubTrack unless explicitly
  *    transferred.
@@ -80,6 +83,7 @@
 typedef struct SubTrack {
     SRTEntry *entries;      /**< Parsed cue array (caller frees entries[i].text and array) */
     int count;              /**< Number of parsed cues in `entries` */
+    char **markup;          /**< Per-cue Pango markup, lazily built (owned; NULL until first render) */
     int cur_sub;            /**< Index of the currently active/next cue */
     AVStream *stream;       /**< AVStream used for this subtitle track (muxer-owned) */
     AVCodecContext *codec_ctx; /**< Per-track encoder context (muxer-owned) */
@@ -92,6 +96,11 @@ typedef struct SubTrack {
     int hi;                 /**< High-priority flag (internal use) */
     int64_t last_pts;       /**< Last emitted PTS for this track (for monotonicity) */
     int effective_delay_ms; /**< Per-track delay applied to cue timing in ms */
+    /* Contiguous per-cue due/start/end times (90 kHz), built once after
+     * the frame timing stage so the demux loop compares packet PTS against
+     * a flat array instead of the entry structs. Empty when not built; the
+     * loop then computes the values inline. Owned. */
+    CueTimeline timeline;
     /* Per-track temporary buffer reused when encoding subtitles. This
      * avoids repeated av_malloc/av_free churn for every encoded cue.
      * Allocated lazily by encode_and_write_subtitle and intentionally
@@ -99,10 +108,12 @@ typedef struct SubTrack {
     uint8_t *enc_tmpbuf;
     /* Size of the allocated enc_tmpbuf in bytes (0 when not allocated). */
     size_t enc_tmpbuf_size;
-    /* Count of consecutive times the encoder filled the buffer completely.
-     * When this exceeds a small threshold we will increase the buffer size
-     * automatically to reduce truncation. */
+    /* Count of cues that still filled the buffer after it was grown to
+     * its 1 MiB cap (possibly truncated payloads). */
     int enc_tmpbuf_full_count;
+    /* DVB page/region/object version stamped into the next payload
+     * written for this track (4 bits, see dvb_sub_restamp_versions). */
+    int dvb_version;
 } SubTrack;
 
 #endif 
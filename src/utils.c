@@ -227,7 +227,14 @@ void print_help(void)
     printf("      --list-fonts            (unavailable: rebuild with Fontconfig support)\n");
 #endif
     printf("      --delay MS[,MS2,...]    Global or per-track subtitle delay in milliseconds (comma-separated list)\n");
+    printf("      --frame-snap MODE       Snap cue times to the video frame grid (off|nearest|floor|ceil, default off)\n");
+    printf("      --fps-convert SRC:DST   Rescale cue times authored for SRC fps to DST fps (e.g. 23.976:25)\n");
     printf("      --qc-only               Run srt file quality checks only (no mux)\n");
+    printf("      --qc-format FMT         QC report format (text|csv|jsonl|sarif, default text)\n");
+    printf("      --qc-report FILE        QC report path (default qc_log.txt)\n");
+    printf("      --qc-cross              With --qc-only, compare cue timing across tracks and suggest delays\n");
+    printf("      --auto-delay            Estimate each track's --delay from the input audio (no output written)\n");
+    printf("      --auto-delay-window S   Seconds of audio analysed by --auto-delay (default 600)\n");
     printf("      --palette MODE          Palette mode (ebu-broadcast|broadcast|greyscale)\n");
     printf("\nFont options:\n");
     printf("      --font FONTNAME         Set font family (default is DejaVu Sans)\n");
@@ -247,10 +254,27 @@ void print_help(void)
     printf("\nRendering options:\n");
     printf("      --ssaa N                Force supersample factor (1..24) (default 4)\n");
     printf("      --no-unsharp            Disable the final unsharp pass to speed rendering\n");
+    printf("      --glyph-atlas           Composite plain cues from cached glyphs (faster, near-identical)\n");
+    printf("      --no-adaptive-depth     Always encode 4-bit regions (disable 2/8-bit palette fitting)\n");
+    printf("      --no-line-balance       Wrap cues by character count (disable measured, balanced line breaks)\n");
+    printf("      --colorimetry MODE      CLUT colour matrix: bt601, bt709 or auto (match video) (default bt601)\n");
+    printf("      --effects MODE          Outline/shadow pipeline: cairo, morph or auto (HD/UHD morph) (default cairo)\n");
     printf("      --png-dir DIR           Custom directory for debug PNG output (default: pngs/)\n");
     printf("      --png-only              Output PNG files only (no MPEG-TS generation)\n");
+    printf("      --png-level N           zlib level for PNG output (0-9, default 6)\n");
+    printf("      --png-filter MODE       PNG row filter: none, sub, up, paeth, adaptive (default none)\n");
+    printf("      --png-threads N         Deflate PNG row bands in parallel (0=auto, default 1)\n");
+    printf("      --png-cairo             Write PNGs with Cairo (ARGB) instead of the palette writer\n");
+    printf("      --png-sheet             Pack preview PNGs into per-track contact sheets + JSON index\n");
+    printf("      --png-sheet-size WxH    Contact sheet page size (default 4096x4096)\n");
     printf("      --enc-threads N         Encoder thread count (0=auto)\n");
     printf("      --render-threads N      Parallel render workers (0=single-thread)\n");    
+    printf("      --render-daemon SOCK    Serve cue render requests on a UNIX socket (no input/output files)\n");
+    printf("      --daemon-clients N      Max concurrent daemon connections (default 8)\n");
+    printf("      --prerender             Render and encode all cues before remuxing (two-pass, uses all cores)\n");
+    printf("      --prerender-spool FILE  Keep the --prerender payload spool in FILE and reuse it when\n"
+           "                              options and cues match (implies --prerender)\n");
+    printf("      --deterministic         Bit-exact subtitle PIDs for any --render-threads (see testharness/ts_sub_hash.c)\n");
     printf("\nMPEG-TS options:\n");    
     printf("      --pid PID[,PID2,...]    Custom PIDs for subtitle tracks (single value=auto-increment)\n");
     printf("      --overwrite LANGS       Replace existing DVB subtitle track(s) for LANGS (comma-separated or 'all')\n");
@@ -269,6 +293,9 @@ void print_help(void)
     printf("\nOther options):\n");
     printf("      --bench                 Enable micro-bench timing output\n");
     printf("      --debug N               Set debug verbosity (0=quiet,1=errors,2=verbose)\n");
+    printf("      --log-sync              Write debug output from each thread directly (no background writer)\n");
+    printf("      --log-format FMT        Debug log format: text (default) or json (one object per line)\n");
+    printf("      --log-rate N            Max messages/s per log call site, 0=unlimited (default: 100)\n");
     printf("      --license               Show license information and exit\n");
     printf("  -h, --help, -?              Show this help and exit\n\n");
     printf("Accepted ISO 639-2 language codes:\n");
@@ -899,6 +926,39 @@ int parse_subtitle_positions(const char *spec_str, SubtitlePositionConfig *confi
     return 0;
 }
 
+/**
+ * Apply an ASS keypad alignment to a position config; see utils.h.
+ */
+int ass_alignment_apply(int ass_align, SubtitlePositionConfig *pos)
+{
+    if (!pos) return -1;
+
+    /* Convert ASS keypad number (1-9) to SubtitlePosition enum
+     * ASS: 7=TL, 8=TC, 9=TR, 4=ML, 5=MC, 6=MR, 1=BL, 2=BC, 3=BR
+     * Our enum: 1=TL, 2=TC, 3=TR, 4=ML, 5=MC, 6=MR, 7=BL, 8=BC, 9=BR
+     */
+    SubtitlePosition position;
+    switch (ass_align) {
+        case 7: position = SUB_POS_TOP_LEFT; break;
+        case 8: position = SUB_POS_TOP_CENTER; break;
+        case 9: position = SUB_POS_TOP_RIGHT; break;
+        case 4: position = SUB_POS_MID_LEFT; break;
+        case 5: position = SUB_POS_MID_CENTER; break;
+        case 6: position = SUB_POS_MID_RIGHT; break;
+        case 1: position = SUB_POS_BOT_LEFT; break;
+        case 2: position = SUB_POS_BOT_CENTER; break;
+        case 3: position = SUB_POS_BOT_RIGHT; break;
+        default:
+            return -1;
+    }
+    pos->position = position;
+    pos->margin_top = 3.5;
+    pos->margin_left = 3.5;
+    pos->margin_bottom = 3.5;
+    pos->margin_right = 3.5;
+    return 0;
+}
+
 /**
  * Extract ASS/SSA alignment number from Pango markup and remove the tag.
  *
@@ -939,31 +999,9 @@ SubtitlePositionConfig* extract_ass_alignment(char *markup)
     /* Allocate config and convert ASS alignment to SubtitlePosition */
     SubtitlePositionConfig *config = malloc(sizeof(SubtitlePositionConfig));
     if (!config) return NULL;
-    
-    /* Initialize with defaults */
-    config->margin_top = 3.5;
-    config->margin_left = 3.5;
-    config->margin_bottom = 3.5;
-    config->margin_right = 3.5;
-    
-    /* Convert ASS keypad number (1-9) to SubtitlePosition enum
-     * ASS: 7=TL, 8=TC, 9=TR, 4=ML, 5=MC, 6=MR, 1=BL, 2=BC, 3=BR
-     * Our enum: 1=TL, 2=TC, 3=TR, 4=ML, 5=MC, 6=MR, 7=BL, 8=BC, 9=BR
-     * Direct mapping: SubtitlePosition = ass_align
-     */
-    switch (ass_align) {
-        case 7: config->position = SUB_POS_TOP_LEFT; break;
-        case 8: config->position = SUB_POS_TOP_CENTER; break;
-        case 9: config->position = SUB_POS_TOP_RIGHT; break;
-        case 4: config->position = SUB_POS_MID_LEFT; break;
-        case 5: config->position = SUB_POS_MID_CENTER; break;
-        case 6: config->position = SUB_POS_MID_RIGHT; break;
-        case 1: config->position = SUB_POS_BOT_LEFT; break;
-        case 2: config->position = SUB_POS_BOT_CENTER; break;
-        case 3: config->position = SUB_POS_BOT_RIGHT; break;
-        default:
-            free(config);
-            return NULL;  /* Invalid alignment value */
+    if (ass_alignment_apply(ass_align, config) != 0) {
+        free(config);
+        return NULL;  /* Invalid alignment value */
     }
     
     LOG(3, "DEBUG: Extracted ASS alignment \\an%d and removed tag from markup -> position %d\n", ass_align, config->position);
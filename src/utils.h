@@ -228,4 +228,14 @@ int parse_subtitle_positions(const char *spec_str, SubtitlePositionConfig *confi
  */
 SubtitlePositionConfig* extract_ass_alignment(char *markup);
 
+/**
+ * Apply an ASS keypad alignment (1-9, see extract_ass_alignment) to `pos`:
+ * the position is set and the margins reset to the 3.5% defaults used for
+ * {\an<digit>} overrides. Used with SRTEntry.alignment, which the parser
+ * fills at parse time so markup reaches the renderer without the tag.
+ *
+ * @return 0 when applied, -1 (pos untouched) for 0 or an invalid value
+ */
+int ass_alignment_apply(int ass_align, SubtitlePositionConfig *pos);
+
 #endif
@@ -0,0 +1,63 @@
+#!/usr/bin/env bash
+#
+# check_deterministic.sh
+# Encode the same input with --deterministic at --render-threads 0, 1 and
+# N (plus a --prerender run) and check with ts_sub_hash that the subtitle
+# PIDs come out byte-identical. Run it before and after a performance
+# change (new kernels, caches, pools) to catch any change in output.
+#
+# Usage: testharness/check_deterministic.sh [-n N] [-k DIR] -- SRT2DVBSUB_ARGS...
+#   SRT2DVBSUB_ARGS are the usual --input/--srt/--languages/... options,
+#   without --output and --render-threads.
+#   -n N    worker count for the threaded runs (default: number of CPUs)
+#   -k DIR  keep the encoded files in DIR instead of a temporary directory
+#
+# Environment: SRT2DVBSUB (default ./srt2dvbsub), TS_SUB_HASH (default
+# ./ts_sub_hash, built by `make ts_sub_hash`). `make check-deterministic`
+# runs this over the fixture in testharness/deterministic.
+#
+# Exit status: 0 identical, 1 mismatch, 2 usage or encode failure.
+
+SRT2DVBSUB=${SRT2DVBSUB:-./srt2dvbsub}
+TS_SUB_HASH=${TS_SUB_HASH:-./ts_sub_hash}
+threads=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)
+keep=
+
+usage() {
+    echo "usage: $0 [-n N] [-k DIR] -- SRT2DVBSUB_ARGS..." >&2
+    exit 2
+}
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) threads=$2; shift 2 ;;
+        -k) keep=$2; shift 2 ;;
+        --) shift; break ;;
+        *) usage ;;
+    esac
+done
+[ $# -gt 0 ] || usage
+
+if [ -n "$keep" ]; then
+    dir=$keep
+    mkdir -p "$dir" || exit 2
+else
+    dir=$(mktemp -d) || exit 2
+    trap 'rm -rf "$dir"' EXIT
+fi
+
+runs=("0" "1" "$threads" "$threads --prerender")
+outs=()
+for run in "${runs[@]}"; do
+    read -r -a extra <<<"$run"
+    out="$dir/threads-${run// /}.ts"
+    if ! "$SRT2DVBSUB" --deterministic "$@" --render-threads "${extra[@]}" \
+            --output "$out" >"$dir/log.txt" 2>&1; then
+        echo "encode failed (--render-threads $run):" >&2
+        cat "$dir/log.txt" >&2
+        exit 2
+    fi
+    outs+=("$out")
+done
+
+"$TS_SUB_HASH" "${outs[@]}"
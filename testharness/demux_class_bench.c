@@ -0,0 +1,284 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * demux_class_bench.c
+ * Per-packet dispatch cost of the demux loop before and after the stream
+ * class table (src/stream_class.h), on a synthetic packet sequence shaped
+ * like a high-bitrate UHD broadcast TS as libavformat demuxes it:
+ *
+ *   1 HEVC video PES stream   50 packets/s  (clock)
+ *   6 AC-3/E-AC-3 streams     31.25 packets/s each
+ *   2 teletext/data streams   25 packets/s each
+ *   2 DVB subtitle streams    ~1 packet/s each (overwritten: dropped)
+ *
+ * All TS streams have a 1/90000 time base; PTS values start past 2^31 as
+ * in real captures (the 33-bit PTS wraps every 26.5 hours), which is the
+ * case av_rescale_q() handles with two 64-bit divisions.
+ *
+ * "before" is the loop as it was: overwrite-target scan, generic rescale,
+ * progress mask and next-due watermark compare on every packet. "after"
+ * is one table lookup, with the rescale and scheduler work only for the
+ * clock stream. Muxing is a counter in both, so the figures are the demux
+ * loop's own overhead; on real input av_interleaved_write_frame() adds a
+ * few microseconds per packet on top of either (see --bench output).
+ *
+ * Build:
+ *   gcc -std=gnu11 -O2 -Isrc testharness/demux_class_bench.c \
+ *       src/stream_class.c -o demux_class_bench
+ * Run:
+ *   ./demux_class_bench [seconds reps]     (default 3600 5)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/stream_class.h"
+
+#define NSTREAMS 11
+#define NTRACKS 4
+#define MAX_TARGETS 8
+
+typedef struct {
+    int stream;
+    int64_t pts;
+} Pkt;
+
+typedef struct {
+    int used;
+    int in_stream_index;
+} Target;
+
+typedef struct {
+    int64_t *due90;
+    int count, cur;
+} Track;
+
+/* Per-packet state shared by both loops. */
+typedef struct {
+    Target targets[MAX_TARGETS];
+    int ntargets;
+    int tb_num[NSTREAMS], tb_den[NSTREAMS];
+    Track tracks[NTRACKS];
+    int64_t next_due90;
+    long muxed, dropped, emitted, progress;
+} Loop;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* a * b / c rounded to nearest, as av_rescale_q() computes it for
+ * timestamps above INT_MAX: split on c to keep the product in range. */
+static int64_t rescale_generic(int64_t a, int64_t b, int64_t c) {
+    int64_t r = c / 2;
+    if (a < 0) return -rescale_generic(-a, b, c);
+    if (a <= INT32_MAX) return (a * b + r) / c;
+    return a / c * b + (a % c * b + r) / c;
+}
+
+static int is_overwrite(const Loop *l, int stream) {
+    for (int i = 0; i < l->ntargets; i++)
+        if (l->targets[i].used && l->targets[i].in_stream_index == stream)
+            return 1;
+    return 0;
+}
+
+static void reset(Loop *l) {
+    l->muxed = l->dropped = l->emitted = l->progress = 0;
+    l->next_due90 = INT64_MAX;
+    for (int t = 0; t < NTRACKS; t++) {
+        l->tracks[t].cur = 0;
+        if (l->tracks[t].count && l->tracks[t].due90[0] < l->next_due90)
+            l->next_due90 = l->tracks[t].due90[0];
+    }
+}
+
+/* Advance every track past cmp90; the cue work itself is not timed. */
+static void schedule(Loop *l, int64_t cmp90) {
+    int64_t next = INT64_MAX;
+    for (int t = 0; t < NTRACKS; t++) {
+        Track *tr = &l->tracks[t];
+        while (tr->cur < tr->count && tr->due90[tr->cur] <= cmp90) {
+            tr->cur++;
+            l->emitted++;
+        }
+        if (tr->cur < tr->count && tr->due90[tr->cur] < next)
+            next = tr->due90[tr->cur];
+    }
+    l->next_due90 = next;
+}
+
+__attribute__((noinline)) static void loop_before(Loop *l, const Pkt *p, long n) {
+    int64_t last = 0;
+    for (long i = 0; i < n; i++) {
+        if (is_overwrite(l, p[i].stream)) {
+            l->dropped++;
+            continue;
+        }
+        int s = p[i].stream;
+        int64_t cur90 = rescale_generic(p[i].pts, (int64_t)l->tb_num[s] * 90000, l->tb_den[s]);
+        last = cur90;
+        if (((i + 1) & 0x3FF) == 0)
+            l->progress++;
+        if (last >= l->next_due90)
+            schedule(l, last);
+        l->muxed++;
+    }
+}
+
+__attribute__((noinline)) static void loop_after(Loop *l, const StreamClass *sc, const Pkt *p,
+                                                 long n) {
+    int64_t last = 0;
+    for (long i = 0; i < n; i++) {
+        const StreamClass *c = &sc[p[i].stream];
+        if (c->kind == STREAM_CLASS_DROP) {
+            l->dropped++;
+            continue;
+        }
+        if (c->kind == STREAM_CLASS_PASS) {
+            l->muxed++;
+            continue;
+        }
+        last = stream_class_to90(c, p[i].pts);
+        if (((i + 1) & 0x3FF) == 0)
+            l->progress++;
+        if (last >= l->next_due90)
+            schedule(l, last);
+        l->muxed++;
+    }
+}
+
+int main(int argc, char **argv) {
+    int seconds = 3600, reps = 5;
+    if (argc >= 3) {
+        seconds = atoi(argv[1]);
+        reps = atoi(argv[2]);
+    }
+    if (seconds <= 0 || reps <= 0) return 2;
+
+    /* packets per 20 ms slot (one video frame at 50p), in 1/100 packets */
+    static const int rate_x100[NSTREAMS] = { 100, 63, 63, 63, 63, 63, 63, 50, 50, 2, 2 };
+    const int64_t pts0 = 3000000000LL; /* past INT32_MAX, as in real captures */
+    long cap = (long)seconds * 50 * 6 + 16, n = 0;
+    Pkt *pk = malloc((size_t)cap * sizeof(*pk));
+    if (!pk) return 1;
+    int acc[NSTREAMS] = {0};
+    for (long slot = 0; slot < (long)seconds * 50 && n < cap; slot++) {
+        for (int s = 0; s < NSTREAMS && n < cap; s++) {
+            acc[s] += rate_x100[s];
+            while (acc[s] >= 100 && n < cap) {
+                acc[s] -= 100;
+                /* audio runs ~0.5 s ahead of video in a typical mux */
+                int64_t lead = (s >= 1 && s <= 6) ? 45000 : 0;
+                pk[n].stream = s;
+                pk[n].pts = pts0 + slot * 1800 + lead + (s * 37) % 1800;
+                n++;
+            }
+        }
+    }
+
+    Loop l = {0};
+    l.targets[0] = (Target){ 1, 9 };
+    l.targets[1] = (Target){ 1, 10 };
+    l.ntargets = 2;
+    for (int s = 0; s < NSTREAMS; s++) {
+        l.tb_num[s] = 1;
+        l.tb_den[s] = 90000;
+    }
+    for (int t = 0; t < NTRACKS; t++) {
+        Track *tr = &l.tracks[t];
+        tr->count = seconds / 3;
+        tr->due90 = malloc((size_t)(tr->count ? tr->count : 1) * sizeof(int64_t));
+        if (!tr->due90) return 1;
+        for (int i = 0; i < tr->count; i++)
+            tr->due90[i] = pts0 + (int64_t)i * 270000 + t * 9000 + 90000;
+    }
+    StreamClass sc[NSTREAMS];
+    for (int s = 0; s < NSTREAMS; s++)
+        stream_class_init(&sc[s], is_overwrite(&l, s) ? STREAM_CLASS_DROP
+                                  : s == 0 ? STREAM_CLASS_CLOCK : STREAM_CLASS_PASS,
+                          l.tb_num[s], l.tb_den[s]);
+
+    double best_before = 1e30, best_after = 1e30;
+    long em_before = 0, em_after = 0, mux_before = 0, mux_after = 0;
+    for (int r = 0; r < reps; r++) {
+        reset(&l);
+        double t0 = now_sec();
+        loop_before(&l, pk, n);
+        double dt = now_sec() - t0;
+        if (dt < best_before) best_before = dt;
+        em_before = l.emitted;
+        mux_before = l.muxed;
+
+        reset(&l);
+        t0 = now_sec();
+        loop_after(&l, sc, pk, n);
+        dt = now_sec() - t0;
+        if (dt < best_after) best_after = dt;
+        em_after = l.emitted;
+        mux_after = l.muxed;
+    }
+
+    printf("%ld packets (%d s of UHD TS, %.0f%% non-clock), best of %d:\n", n, seconds,
+           100.0 * (double)(n - (long)seconds * 50) / (double)n, reps);
+    printf("  before: %8.2f ms  %7.1f Mpkt/s  %5.2f ns/pkt\n", best_before * 1e3,
+           n / best_before / 1e6, best_before * 1e9 / n);
+    printf("  after:  %8.2f ms  %7.1f Mpkt/s  %5.2f ns/pkt  (%.2fx)\n", best_after * 1e3,
+           n / best_after / 1e6, best_after * 1e9 / n, best_before / best_after);
+    printf("  cues emitted %ld/%ld, packets muxed %ld/%ld\n", em_before, em_after,
+           mux_before, mux_after);
+
+    for (int t = 0; t < NTRACKS; t++) free(l.tracks[t].due90);
+    free(pk);
+    return em_before == em_after && mux_before == mux_after ? 0 : 1;
+}
@@ -0,0 +1,311 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#pragma once
+#ifndef FUZZ_DRIVER_H
+#define FUZZ_DRIVER_H
+
+/**
+ * @file fuzz_driver.h
+ * @brief Shared entry points and time guards for the fuzz_*.c harnesses.
+ *
+ * Each harness defines `static void fuzz_one(const uint8_t *data, size_t size)`
+ * and then includes this header, which provides:
+ *
+ *  - LLVMFuzzerTestOneInput(), so the harness links with clang's
+ *    -fsanitize=fuzzer (build with -DFUZZ_LIBFUZZER to drop main());
+ *  - a standalone main() that replays files or directories, or one input
+ *    from stdin when given no arguments (the AFL/afl-gcc mode);
+ *  - a per-input budget: an input that takes longer than
+ *    FUZZ_BUDGET_FIXED_US plus FUZZ_BUDGET_NS_PER_BYTE per input byte
+ *    aborts under a fuzzer, so it is kept as a crash, and is reported as
+ *    SLOW by the replay driver. The FUZZ_NS_PER_BYTE environment variable
+ *    overrides the per-byte budget (0 turns it off);
+ *  - with -g, a scaling guard: each input is tiled to FUZZ_GUARD_BASE
+ *    bytes (or kept whole when longer) and to FUZZ_GUARD_SCALE times that,
+ *    both are timed, and the input is reported as super-linear when the
+ *    larger run takes more than FUZZ_GUARD_SLACK times longer than linear
+ *    growth allows. The ratio does not depend on the machine's speed, so
+ *    the slow-input corpus in testharness/fuzz_slow can be checked anywhere.
+ *
+ * Exit status of the replay driver: 0 when every input passed, 1 when one
+ * was over budget or flagged by the scaling guard, 2 on I/O errors.
+ */
+
+#include <dirent.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define FUZZ_BUDGET_FIXED_US    20000
+#define FUZZ_BUDGET_NS_PER_BYTE 2000
+#define FUZZ_GUARD_BASE         4096
+#define FUZZ_GUARD_SCALE        16
+#define FUZZ_GUARD_SLACK        3.0
+
+static void fuzz_one(const uint8_t *data, size_t size);
+
+static int64_t fuzz_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int64_t fuzz_budget_ns(size_t size) {
+    static int64_t per_byte = -1;
+    if (per_byte < 0) {
+        const char *env = getenv("FUZZ_NS_PER_BYTE");
+        per_byte = env ? strtoll(env, NULL, 10) : FUZZ_BUDGET_NS_PER_BYTE;
+        if (per_byte < 0) per_byte = 0;
+    }
+    if (per_byte == 0) return 0;
+    return (int64_t)FUZZ_BUDGET_FIXED_US * 1000 + per_byte * (int64_t)size;
+}
+
+/* NUL-terminated copy of a fuzz input for the string converters. */
+static inline char *fuzz_cstr(const uint8_t *data, size_t size) {
+    char *s = malloc(size + 1);
+    if (!s) return NULL;
+    memcpy(s, data, size);
+    s[size] = '\0';
+    return s;
+}
+
+/* Set by the replay driver: report over-budget inputs instead of aborting. */
+static int fuzz_replaying;
+static int fuzz_over_budget;
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    int64_t budget = fuzz_budget_ns(size);
+    int64_t t0 = fuzz_now_ns();
+    fuzz_one(data, size);
+    int64_t dt = fuzz_now_ns() - t0;
+    if (budget > 0 && dt > budget) {
+        fprintf(stderr, "fuzz: %zu-byte input took %.1f ms (budget %.1f ms)\n",
+                size, dt / 1e6, budget / 1e6);
+        if (!fuzz_replaying) abort();
+        fuzz_over_budget = 1;
+    }
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+/* `data` repeated (and truncated) to exactly `n` bytes. */
+static uint8_t *fuzz_tile(const uint8_t *data, size_t size, size_t n) {
+    uint8_t *buf = malloc(n ? n : 1);
+    if (!buf) return NULL;
+    for (size_t off = 0; off < n; off += size)
+        memcpy(buf + off, data, n - off < size ? n - off : size);
+    return buf;
+}
+
+/* Best of three timings of `reps` calls on `buf`. */
+static int64_t fuzz_time(const uint8_t *buf, size_t n, int reps) {
+    int64_t best = INT64_MAX;
+    for (int k = 0; k < 3; k++) {
+        int64_t t0 = fuzz_now_ns();
+        for (int r = 0; r < reps; r++)
+            fuzz_one(buf, n);
+        int64_t dt = fuzz_now_ns() - t0;
+        if (dt < best) best = dt;
+    }
+    return best;
+}
+
+/* Scaling guard for one input; returns 1 when it grows super-linearly. */
+static int fuzz_guard(const char *name, const uint8_t *data, size_t size) {
+    if (size == 0) return 0;
+    size_t small_n = size > FUZZ_GUARD_BASE ? size : FUZZ_GUARD_BASE;
+    size_t large_n = small_n * FUZZ_GUARD_SCALE;
+    uint8_t *small = fuzz_tile(data, size, small_n);
+    uint8_t *large = fuzz_tile(data, size, large_n);
+    if (!small || !large) {
+        free(small);
+        free(large);
+        return 0;
+    }
+    /* Enough repetitions for the small run to take a couple of ms. */
+    int reps = 1;
+    while (reps < (1 << 16) && fuzz_time(small, small_n, reps) < 2000000)
+        reps *= 2;
+    int64_t ts = fuzz_time(small, small_n, reps);
+    int64_t tl = fuzz_time(large, large_n, reps);
+    free(small);
+    free(large);
+    double ratio = ts > 0 ? (double)tl / (double)ts : 0.0;
+    int slow = ratio > FUZZ_GUARD_SCALE * FUZZ_GUARD_SLACK;
+    printf("%s: x%d input -> x%.1f time (%.1f ns/byte) -- %s\n", name, FUZZ_GUARD_SCALE,
+           ratio, (double)tl / reps / (double)large_n, slow ? "SUPER-LINEAR" : "ok");
+    return slow;
+}
+
+static int fuzz_read_file(const char *path, uint8_t **data, size_t *size) {
+    FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    size_t cap = 4096, n = 0;
+    uint8_t *buf = malloc(cap);
+    while (buf) {
+        n += fread(buf + n, 1, cap - n, f);
+        if (n < cap) break;
+        uint8_t *nb = realloc(buf, cap * 2);
+        if (!nb) {
+            free(buf);
+            buf = NULL;
+            break;
+        }
+        buf = nb;
+        cap *= 2;
+    }
+    if (f != stdin) fclose(f);
+    if (!buf) return -1;
+    *data = buf;
+    *size = n;
+    return 0;
+}
+
+/* Replay one file; returns 0 ok, 1 flagged, 2 I/O error. */
+static int fuzz_replay_file(const char *path, int guard) {
+    uint8_t *data = NULL;
+    size_t size = 0;
+    if (fuzz_read_file(path, &data, &size) != 0) return 2;
+    fuzz_over_budget = 0;
+    LLVMFuzzerTestOneInput(data, size);
+    int rc = fuzz_over_budget;
+    if (fuzz_over_budget) printf("%s: over the time budget -- SLOW\n", path);
+    if (guard && fuzz_guard(path, data, size)) rc = 1;
+    free(data);
+    return rc;
+}
+
+static int fuzz_cmp_names(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/* Replay every regular file in `dir` in name order. */
+static int fuzz_replay_dir(const char *dir, int guard, int *count) {
+    DIR *d = opendir(dir);
+    if (!d) {
+        perror(dir);
+        return 2;
+    }
+    char **names = NULL;
+    size_t n = 0, cap = 0;
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        if (e->d_name[0] == '.') continue;
+        if (n == cap) {
+            size_t nc = cap ? cap * 2 : 64;
+            char **nn = realloc(names, nc * sizeof(*names));
+            if (!nn) break;
+            names = nn;
+            cap = nc;
+        }
+        names[n++] = strdup(e->d_name);
+    }
+    closedir(d);
+    if (n) qsort(names, n, sizeof(*names), fuzz_cmp_names);
+    int worst = 0;
+    for (size_t i = 0; i < n; i++) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        int rc = fuzz_replay_file(path, guard);
+        if (rc > worst) worst = rc;
+        (*count)++;
+        free(names[i]);
+    }
+    free(names);
+    return worst;
+}
+
+int main(int argc, char **argv) {
+    int argi = 1, guard = 0;
+    fuzz_replaying = 1;
+#ifdef __GLIBC__
+    /* Keep the scaling guard's large buffers on the heap: a fresh mmap per
+     * call adds page-fault time only above the threshold, which would show
+     * up as super-linear growth between the two sizes. */
+    mallopt(M_MMAP_THRESHOLD, 64 << 20);
+    mallopt(M_TRIM_THRESHOLD, 128 << 20);
+#endif
+    if (argi < argc && strcmp(argv[argi], "-g") == 0) {
+        guard = 1;
+        argi++;
+    }
+    if (argi == argc)
+        return fuzz_replay_file("-", guard);
+
+    int worst = 0, count = 0;
+    for (; argi < argc; argi++) {
+        struct stat st;
+        int rc;
+        if (stat(argv[argi], &st) == 0 && S_ISDIR(st.st_mode)) {
+            rc = fuzz_replay_dir(argv[argi], guard, &count);
+        } else {
+            rc = fuzz_replay_file(argv[argi], guard);
+            count++;
+        }
+        if (rc > worst) worst = rc;
+    }
+    printf("%s: %d inputs replayed%s\n", argv[0], count,
+           worst == 1 ? ", slow inputs found" : worst ? ", with errors" : "");
+    return worst;
+}
+
+#endif /* FUZZ_LIBFUZZER */
+
+#endif /* FUZZ_DRIVER_H */
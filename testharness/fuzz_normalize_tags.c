@@ -0,0 +1,77 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * fuzz_normalize_tags.c
+ * Fuzz harness for normalize_tags(), the static ASS-override to Pango
+ * translator in src/srt_parser.c. The parser source is included directly
+ * so the harness can reach the static function; do not also link
+ * srt_parser.c. See fuzz_driver.h for the entry points and time guards.
+ *
+ * Build (replay driver; add -g -fsanitize=address,undefined when fuzzing):
+ *   gcc -std=gnu11 -O2 -Isrc testharness/fuzz_normalize_tags.c src/qc.c \
+ *       src/qc_report.c src/line_break.c -o fuzz_normalize_tags
+ * libFuzzer: as fuzz_strip_tags.c, with -DFUZZ_LIBFUZZER.
+ */
+
+#include "../src/srt_parser.c"
+
+/* Globals normally provided by runtime_opts.c. */
+int use_ass = 0;
+int video_w = 1280;
+int video_h = 720;
+int debug_level = 0;
+
+#include "fuzz_driver.h"
+
+static void fuzz_one(const uint8_t *data, size_t size) {
+    char *in = fuzz_cstr(data, size);
+    if (!in) return;
+    free(normalize_tags(in));
+    free(in);
+}
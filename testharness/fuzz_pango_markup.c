@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * fuzz_pango_markup.c
+ * Fuzz harness for srt_to_pango_markup() (src/render_pango.c). Only the
+ * converter runs; nothing is rendered. See fuzz_driver.h for the
+ * libFuzzer/AFL entry points and the time guards.
+ *
+ * Build (replay driver; add -g -fsanitize=address,undefined when fuzzing):
+ *   gcc -std=gnu11 -O2 -Isrc $(pkg-config --cflags pangocairo fontconfig) \
+ *       testharness/fuzz_pango_markup.c src/render_pango.c src/glyph_atlas.c \
+ *       src/coverage_effects.c src/line_break.c src/runtime_opts.c src/utils.c \
+ *       src/dvb_lang.c src/bench.c \
+ *       $(pkg-config --libs pangocairo fontconfig) -lm -lpthread \
+ *       -o fuzz_pango_markup
+ * libFuzzer: as above with clang, -fsanitize=fuzzer,address -DFUZZ_LIBFUZZER.
+ */
+
+#include "render_pango.h"
+#include "fuzz_driver.h"
+
+static void fuzz_one(const uint8_t *data, size_t size) {
+    char *in = fuzz_cstr(data, size);
+    if (!in) return;
+    free(srt_to_pango_markup(in));
+    free(in);
+}
@@ -0,0 +1,126 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * fuzz_parse_srt.c
+ * Fuzz harness for the SRT file parser (parse_srt_cfg() with and without
+ * ASS passthrough, and parse_srt_with_stats() with UTF-8 repair). The
+ * input is written to a private temporary file because the parser reads
+ * from a path. See fuzz_driver.h for the entry points and time guards.
+ *
+ * Build (replay driver; add -g -fsanitize=address,undefined when fuzzing):
+ *   gcc -std=gnu11 -O2 -Isrc testharness/fuzz_parse_srt.c src/srt_parser.c \
+ *       src/qc.c src/qc_report.c src/line_break.c -o fuzz_parse_srt
+ * libFuzzer: as fuzz_strip_tags.c, with -DFUZZ_LIBFUZZER.
+ */
+
+#include <unistd.h>
+
+#include "srt_parser.h"
+
+/* Globals normally provided by runtime_opts.c. */
+int use_ass = 0;
+int video_w = 1280;
+int video_h = 720;
+int debug_level = 0;
+
+#include "fuzz_driver.h"
+
+static char fuzz_path[256];
+static FILE *qc_sink;
+
+static void remove_tmp(void) {
+    unlink(fuzz_path);
+}
+
+static void free_entries(SRTEntry *entries, int n) {
+    for (int i = 0; i < n; i++)
+        free(entries[i].text);
+    free(entries);
+}
+
+static void fuzz_one(const uint8_t *data, size_t size) {
+    if (!fuzz_path[0]) {
+        const char *dir = getenv("TMPDIR");
+        snprintf(fuzz_path, sizeof(fuzz_path), "%s/fuzz_parse_srt.XXXXXX", dir ? dir : "/tmp");
+        int fd = mkstemp(fuzz_path);
+        if (fd < 0) abort();
+        close(fd);
+        atexit(remove_tmp);
+        /* QC findings are written, but not kept. */
+        qc_sink = fopen("/dev/null", "w");
+    }
+    FILE *f = fopen(fuzz_path, "wb");
+    if (!f) abort();
+    fwrite(data, 1, size, f);
+    fclose(f);
+
+    SRTParserConfig cfg = {0};
+    cfg.video_w = 720;
+    cfg.video_h = 576;
+    for (int ass = 0; ass <= 1; ass++) {
+        SRTEntry *entries = NULL;
+        cfg.use_ass = ass;
+        int n = parse_srt_cfg(fuzz_path, &entries, qc_sink, &cfg);
+        if (n > 0) free_entries(entries, n);
+        else free(entries);
+    }
+
+    SRTParserStats stats;
+    SRTEntry *entries = NULL;
+    cfg.use_ass = 0;
+    cfg.video_w = 1920;
+    cfg.video_h = 1080;
+    cfg.validation_level = SRT_VALIDATE_AUTO_FIX;
+    cfg.auto_fix_duplicates = 1;
+    cfg.auto_fix_encoding = 1;
+    cfg.defer_qc = 1;
+    int n = parse_srt_with_stats(fuzz_path, &entries, qc_sink, &cfg, &stats);
+    if (n > 0) free_entries(entries, n);
+    else free(entries);
+}
@@ -0,0 +1,259 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * golden_diff.c
+ * Compare two sets of golden-image PNGs (golden_render output) cue by
+ * cue and report, for each: exact match, or the share of pixels whose
+ * palette index changed with a breakdown by reference index, the mean
+ * SSIM of the composited frames and the largest channel difference
+ * (see src/image_diff.h). A cue fails when it is outside the limits of
+ * the selected kernel in the thresholds file; without -k only exact
+ * matches pass. The summary ends with the worst SSIM, changed share and
+ * delta over the inexact cues, in thresholds-file order, so a kernel's
+ * limits can be set from a measured run.
+ *
+ * Usage: golden_diff [-t THRESHOLDS] [-k KERNEL] REF CAND
+ *   REF and CAND are directories (every REF/NAME.png is compared with
+ *   CAND/NAME.png) or two PNG files. Exit status 0 when every cue
+ *   passes, 1 when one fails or is missing, 2 on usage or I/O errors.
+ *
+ * Build:
+ *   gcc -std=gnu11 -Isrc testharness/golden_diff.c src/image_diff.c \
+ *       src/png_reader.c -lz -o golden_diff
+ */
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "png_reader.h"
+#include "image_diff.h"
+
+#define MAX_NAMES 4096
+
+/* Worst values over the inexact cues of a run. */
+typedef struct {
+    int n;
+    double min_ssim;
+    double max_changed_pct;
+    int max_delta;
+} WorstCase;
+
+static void worst_add(WorstCase *w, const ImageDiff *d) {
+    if (w->n == 0 || d->ssim < w->min_ssim) w->min_ssim = d->ssim;
+    if (w->n == 0 || d->changed_pct > w->max_changed_pct) w->max_changed_pct = d->changed_pct;
+    if (w->n == 0 || d->max_delta > w->max_delta) w->max_delta = d->max_delta;
+    w->n++;
+}
+
+/* Look up `kernel` in a thresholds file ("name min_ssim max_pct max_delta"). */
+static int load_thresholds(const char *path, const char *kernel, ImageDiffThresholds *t) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    char line[512];
+    int found = 0;
+    while (!found && fgets(line, sizeof(line), f)) {
+        char name[128];
+        ImageDiffThresholds v;
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%127s %lf %lf %d", name, &v.min_ssim, &v.max_changed_pct, &v.max_delta) == 4 &&
+            strcmp(name, kernel) == 0) {
+            *t = v;
+            found = 1;
+        }
+    }
+    fclose(f);
+    if (!found)
+        fprintf(stderr, "%s: no thresholds for kernel '%s'\n", path, kernel);
+    return found ? 0 : -1;
+}
+
+static int is_dir(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static int cmp_names(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/* Sorted *.png names in `dir`; returns the count or -1. */
+static int list_pngs(const char *dir, char **names, int max) {
+    DIR *d = opendir(dir);
+    if (!d) {
+        perror(dir);
+        return -1;
+    }
+    int n = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) && n < max) {
+        size_t len = strlen(e->d_name);
+        if (len > 4 && strcmp(e->d_name + len - 4, ".png") == 0)
+            names[n++] = strdup(e->d_name);
+    }
+    closedir(d);
+    qsort(names, (size_t)n, sizeof(names[0]), cmp_names);
+    return n;
+}
+
+/* Compare one pair; prints a report line. 1 = pass, 0 = fail, -1 = error. */
+static int compare_one(const char *label, const char *ref_path, const char *cand_path,
+                       const ImageDiffThresholds *t, int *exact, WorstCase *worst) {
+    PngIndexed ref, cand;
+    if (png_read_indexed_file(ref_path, &ref) != 0) {
+        printf("%s: cannot read reference %s\n", label, ref_path);
+        return -1;
+    }
+    if (png_read_indexed_file(cand_path, &cand) != 0) {
+        printf("%s: missing or unreadable %s -- FAIL\n", label, cand_path);
+        png_indexed_free(&ref);
+        return 0;
+    }
+    ImageDiff d;
+    int rc = image_diff_indexed(&ref, &cand, &d);
+    png_indexed_free(&ref);
+    png_indexed_free(&cand);
+    if (rc != 0) {
+        printf("%s: comparison failed\n", label);
+        return -1;
+    }
+    *exact = d.exact;
+    if (d.size_mismatch) {
+        printf("%s: frame size differs -- FAIL\n", label);
+        return 0;
+    }
+    if (d.exact) {
+        printf("%s: exact\n", label);
+        return 1;
+    }
+    int pass = image_diff_passes(&d, t);
+    worst_add(worst, &d);
+    printf("%s: %.3f%% changed (", label, d.changed_pct);
+    int shown = 0;
+    for (int i = 0; i < 256; i++) {
+        if (!d.changed_by_index[i]) continue;
+        printf("%sidx %d: %ld", shown ? ", " : "", i, d.changed_by_index[i]);
+        shown++;
+    }
+    if (d.palette_changed)
+        printf("%s%d palette entries", shown ? "; " : "", d.palette_changed);
+    printf(") ssim %.5f max delta %d -- %s\n", d.ssim, d.max_delta, pass ? "ok" : "FAIL");
+    return pass;
+}
+
+int main(int argc, char **argv) {
+    const char *thresholds = NULL, *kernel = NULL;
+    int argi = 1;
+    while (argi + 1 < argc && argv[argi][0] == '-') {
+        if (strcmp(argv[argi], "-t") == 0)
+            thresholds = argv[argi + 1];
+        else if (strcmp(argv[argi], "-k") == 0)
+            kernel = argv[argi + 1];
+        else
+            break;
+        argi += 2;
+    }
+    if (argc - argi != 2 || (kernel && !thresholds)) {
+        fprintf(stderr, "usage: %s [-t THRESHOLDS -k KERNEL] REF CAND\n", argv[0]);
+        return 2;
+    }
+    ImageDiffThresholds t = image_diff_exact_thresholds();
+    if (kernel && load_thresholds(thresholds, kernel, &t) != 0)
+        return 2;
+    const char *ref = argv[argi], *cand = argv[argi + 1];
+
+    int total = 0, exact = 0, within = 0, failed = 0, errors = 0;
+    WorstCase worst = {0};
+    if (!is_dir(ref)) {
+        int ex = 0;
+        int rc = compare_one(cand, ref, cand, &t, &ex, &worst);
+        total = 1;
+        exact = ex;
+        within = rc == 1 && !ex;
+        failed = rc == 0;
+        errors = rc < 0;
+    } else {
+        char **names = calloc(MAX_NAMES, sizeof(char *));
+        int n = names ? list_pngs(ref, names, MAX_NAMES) : -1;
+        if (n <= 0) {
+            fprintf(stderr, "%s: no reference images\n", ref);
+            free(names);
+            return 2;
+        }
+        for (int i = 0; i < n; i++) {
+            char rp[4096], cp[4096], label[256];
+            snprintf(rp, sizeof(rp), "%s/%s", ref, names[i]);
+            snprintf(cp, sizeof(cp), "%s/%s", cand, names[i]);
+            snprintf(label, sizeof(label), "%.*s", (int)strlen(names[i]) - 4, names[i]);
+            int ex = 0;
+            int rc = compare_one(label, rp, cp, &t, &ex, &worst);
+            total++;
+            if (rc < 0) errors++;
+            else if (rc == 0) failed++;
+            else if (ex) exact++;
+            else within++;
+            free(names[i]);
+        }
+        free(names);
+    }
+    printf("golden_diff%s%s%s: %d cues, %d exact, %d within limits, %d failed%s\n",
+           kernel ? " [" : "", kernel ? kernel : "", kernel ? "]" : "",
+           total, exact, within, failed + errors, errors ? " (read errors)" : "");
+    if (worst.n)
+        printf("golden_diff: worst of %d inexact: ssim %.5f changed %.3f%% max delta %d\n",
+               worst.n, worst.min_ssim, worst.max_changed_pct, worst.max_delta);
+    if (errors) return 2;
+    return failed ? 1 : 0;
+}
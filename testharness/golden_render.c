@@ -0,0 +1,333 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * golden_render.c
+ * Render the golden-image corpus (testharness/golden/corpus.txt) to one
+ * palette PNG per cue. Each PNG is the full display frame with the cue
+ * bitmap placed where the muxer would put it, so position changes are
+ * caught as well as pixel changes. golden_diff compares two such sets.
+ *
+ * A kernel selects the renderer configuration:
+ *   default    shipped settings (currently the same as reference)
+ *   reference  every optional fast path off (no glyph atlas, Cairo effects)
+ *   atlas      reference with the glyph-atlas fast path (--glyph-atlas)
+ *   morph      reference with morphological outline/shadow (--effects morph)
+ * New optimisations add their switch here and a threshold line to
+ * golden/thresholds.conf, then are compared against `reference`.
+ *
+ * Every run also writes OUTDIR/versions.txt: the Pango, Cairo and
+ * fontconfig versions and the font file each DejaVu family resolves to.
+ * The committed reference set (golden/ref, rendered from golden/pinned.txt
+ * with FONTCONFIG_FILE=golden/fonts.conf) carries it, so a mismatch
+ * can be traced to a library or font change. With GOLDEN_PINNED_FONTS=1
+ * the run fails unless every DejaVu family resolves to a DejaVu file.
+ *
+ * Usage: golden_render [-k KERNEL] CORPUS OUTDIR
+ * `make check-render` runs it for every kernel; see Makefile.am.
+ *
+ * Build (normally via make check-render):
+ *   gcc -std=gnu11 -Isrc $(pkg-config --cflags pangocairo fontconfig) \
+ *       testharness/golden_render.c src/render_pango.c src/glyph_atlas.c \
+ *       src/coverage_effects.c src/line_break.c src/runtime_opts.c \
+ *       src/utils.c src/dvb_lang.c src/bench.c src/png_writer.c \
+ *       $(pkg-config --libs pangocairo fontconfig) -lz -lm -lpthread \
+ *       -o golden_render
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <cairo.h>
+#include <fontconfig/fontconfig.h>
+#include <pango/pango.h>
+
+#include "render_pango.h"
+#include "coverage_effects.h"
+#include "png_writer.h"
+
+#define MAX_LINE 4096
+#define MAX_FIELDS 9
+
+typedef struct {
+    const char *name;
+    int glyph_atlas;
+    int effects_mode;
+} GoldenKernel;
+
+static const GoldenKernel kernels[] = {
+    { "default", 0, RENDER_EFFECTS_CAIRO },
+    { "reference", 0, RENDER_EFFECTS_CAIRO },
+    { "atlas", 1, RENDER_EFFECTS_CAIRO },
+    { "morph", 0, RENDER_EFFECTS_MORPH },
+};
+
+/* Trim leading/trailing blanks in place. */
+static char *trim(char *s) {
+    while (*s == ' ' || *s == '\t') s++;
+    size_t n = strlen(s);
+    while (n && (s[n - 1] == ' ' || s[n - 1] == '\t' || s[n - 1] == '\n' || s[n - 1] == '\r'))
+        s[--n] = '\0';
+    return s;
+}
+
+/* "\n" escapes become line breaks, in place. */
+static void unescape(char *s) {
+    char *o = s;
+    for (; *s; s++) {
+        if (s[0] == '\\' && s[1] == 'n') {
+            *o++ = '\n';
+            s++;
+        } else {
+            *o++ = *s;
+        }
+    }
+    *o = '\0';
+}
+
+/* Split `line` on '|' into at most MAX_FIELDS trimmed fields; the last
+ * field keeps any further '|' (cue text may contain one). */
+static int split_fields(char *line, char *f[MAX_FIELDS]) {
+    int n = 0;
+    char *p = line;
+    while (n < MAX_FIELDS - 1) {
+        char *bar = strchr(p, '|');
+        if (!bar) break;
+        *bar = '\0';
+        f[n++] = trim(p);
+        p = bar + 1;
+    }
+    f[n++] = trim(p);
+    return n;
+}
+
+static const char *opt_field(const char *s) {
+    return strcmp(s, "-") == 0 ? NULL : s;
+}
+
+/* Place the cue bitmap on a transparent w x h frame and write it. */
+static int write_frame(const char *path, const Bitmap *bm, int w, int h) {
+    static const uint32_t empty_palette[1] = { 0 };
+    uint8_t *frame = calloc((size_t)w * h, 1);
+    if (!frame) return -1;
+    const uint32_t *palette = empty_palette;
+    int ncolors = 1;
+    if (bm->idxbuf && bm->palette && bm->nb_colors > 0) {
+        palette = bm->palette;
+        ncolors = bm->nb_colors;
+        if (palette[0] >> 24)
+            fprintf(stderr, "%s: palette index 0 is not transparent\n", path);
+        for (int y = 0; y < bm->h; y++) {
+            int fy = bm->y + y;
+            if (fy < 0 || fy >= h) continue;
+            for (int x = 0; x < bm->w; x++) {
+                int fx = bm->x + x;
+                if (fx >= 0 && fx < w)
+                    frame[(size_t)fy * w + fx] = bm->idxbuf[(size_t)y * bm->w + x];
+            }
+        }
+    }
+    unsigned char *png = NULL;
+    size_t len = 0;
+    PngWriterOptions opt = png_writer_default_options();
+    opt.level = 9;
+    int rc = png_encode_indexed(frame, w, h, w, palette, ncolors, &opt, &png, &len);
+    free(frame);
+    if (rc != 0) return -1;
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        free(png);
+        return -1;
+    }
+    rc = fwrite(png, 1, len, f) == len ? 0 : -1;
+    if (fclose(f) != 0) rc = -1;
+    free(png);
+    return rc;
+}
+
+/* Write OUTDIR/versions.txt (see the file comment). Returns -1 when
+ * `require_pinned` is set and a DejaVu family falls back to another font. */
+static int write_versions(const char *outdir, int require_pinned) {
+    static const char *const families[] = { "DejaVu Sans", "DejaVu Serif", "DejaVu Sans Mono" };
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/versions.txt", outdir);
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    int fc = FcGetVersion();
+    fprintf(f, "pango %s\ncairo %s\nfontconfig %d.%d.%d\n", pango_version_string(),
+            cairo_version_string(), fc / 10000, fc / 100 % 100, fc % 100);
+    int rc = 0;
+    for (size_t i = 0; i < sizeof(families) / sizeof(families[0]); i++) {
+        FcPattern *pat = FcNameParse((const FcChar8 *)families[i]);
+        FcPattern *match = NULL;
+        FcChar8 *file = NULL, *family = NULL;
+        if (pat) {
+            FcResult res;
+            FcConfigSubstitute(NULL, pat, FcMatchPattern);
+            FcDefaultSubstitute(pat);
+            match = FcFontMatch(NULL, pat, &res);
+        }
+        if (match) {
+            FcPatternGetString(match, FC_FILE, 0, &file);
+            FcPatternGetString(match, FC_FAMILY, 0, &family);
+        }
+        const char *base = file ? strrchr((const char *)file, '/') : NULL;
+        fprintf(f, "font %s: %s\n", families[i], base ? base + 1 : "(none)");
+        if (require_pinned && (!family || strcmp((const char *)family, families[i]) != 0)) {
+            fprintf(stderr, "golden_render: pinned font '%s' not found (got %s)\n", families[i],
+                    family ? (const char *)family : "nothing");
+            rc = -1;
+        }
+        if (match) FcPatternDestroy(match);
+        if (pat) FcPatternDestroy(pat);
+    }
+    if (fclose(f) != 0) rc = -1;
+    return rc;
+}
+
+static int render_case(char *f[MAX_FIELDS], const char *outdir) {
+    int w = 0, h = 0, size = atoi(f[4]), pos = atoi(f[5]);
+    if (sscanf(f[1], "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0 || w > 8192 || h > 8192) {
+        fprintf(stderr, "%s: bad resolution '%s'\n", f[0], f[1]);
+        return -1;
+    }
+    if (pos < SUB_POS_TOP_LEFT || pos > SUB_POS_BOT_RIGHT) {
+        fprintf(stderr, "%s: bad position '%s'\n", f[0], f[5]);
+        return -1;
+    }
+    SubtitlePositionConfig pc = sub_pos_configs[0];
+    pc.position = (SubtitlePosition)pos;
+
+    unescape(f[8]);
+    char *markup = srt_to_pango_markup(f[8]);
+    if (!markup) return -1;
+    Bitmap bm = render_text_pango(markup, w, h, size, opt_field(f[2]), opt_field(f[3]),
+                                  "#FFFFFF", "#000000", "#64000000", opt_field(f[7]),
+                                  &pc, f[6]);
+    free(markup);
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s.png", outdir, f[0]);
+    int rc = write_frame(path, &bm, w, h);
+    if (rc != 0)
+        fprintf(stderr, "%s: cannot write %s\n", f[0], path);
+    else if (!bm.idxbuf)
+        fprintf(stderr, "%s: renderer returned no bitmap (empty frame written)\n", f[0]);
+    free(bm.idxbuf);
+    free(bm.palette);
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    const char *kernel = "default";
+    int argi = 1;
+    if (argc > 2 && strcmp(argv[1], "-k") == 0) {
+        kernel = argv[2];
+        argi = 3;
+    }
+    if (argc - argi != 2) {
+        fprintf(stderr, "usage: %s [-k default|reference|atlas|morph] CORPUS OUTDIR\n", argv[0]);
+        return 2;
+    }
+    const GoldenKernel *k = NULL;
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++)
+        if (strcmp(kernels[i].name, kernel) == 0)
+            k = &kernels[i];
+    if (!k) {
+        fprintf(stderr, "unknown kernel '%s'\n", kernel);
+        return 2;
+    }
+    const char *corpus = argv[argi], *outdir = argv[argi + 1];
+    if (mkdir(outdir, 0755) != 0 && errno != EEXIST) {
+        perror(outdir);
+        return 2;
+    }
+    FILE *in = fopen(corpus, "r");
+    if (!in) {
+        perror(corpus);
+        return 2;
+    }
+
+    const char *pinned = getenv("GOLDEN_PINNED_FONTS");
+    if (write_versions(outdir, pinned && strcmp(pinned, "1") == 0) != 0) {
+        fclose(in);
+        return 2;
+    }
+
+    render_pango_set_glyph_atlas(k->glyph_atlas);
+    render_pango_set_effects_mode(k->effects_mode);
+
+    char line[MAX_LINE];
+    int lineno = 0, rendered = 0, failed = 0;
+    while (fgets(line, sizeof(line), in)) {
+        lineno++;
+        char *s = trim(line);
+        if (*s == '\0' || *s == '#') continue;
+        char *f[MAX_FIELDS];
+        if (split_fields(s, f) != MAX_FIELDS) {
+            fprintf(stderr, "%s:%d: expected %d fields\n", corpus, lineno, MAX_FIELDS);
+            failed++;
+            continue;
+        }
+        if (render_case(f, outdir) == 0)
+            rendered++;
+        else
+            failed++;
+    }
+    fclose(in);
+    render_pango_cleanup();
+    printf("golden_render: %d cues rendered with kernel '%s' into %s%s\n",
+           rendered, k->name, outdir, failed ? " (with errors)" : "");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEBUG_MODULE "bench"
+#include "../src/debug.h"
+
+int debug_level = 0;
+
+/*
+ * Cost of LOG() sites left in per-cue and per-pixel code at --debug 0.
+ * The quantisation loop mirrors render_text_pango's ARGB -> index pass,
+ * with its LOG(3) inside the pixel loop, plus the per-cue LOG(2)/LOG(3)
+ * calls of the render and demux paths. Build it twice and compare:
+ *
+ * Build:
+ *   gcc -std=gnu11 -O3 -Isrc testharness/log_level_bench.c -o log_bench_all
+ *   gcc -std=gnu11 -O3 -DSRT2DVB_MAX_LOG_LEVEL=1 -Isrc \
+ *       testharness/log_level_bench.c -o log_bench_max1
+ * Run:
+ *   ./log_bench_all [width height cues]     (default 1920 200 2000)
+ */
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void quantise(const uint32_t *argb, uint8_t *idx, int w, int h, uint8_t bg_idx) {
+    for (int yy = 0; yy < h; yy++) {
+        int bg_pixel_count = 0;
+        for (int xx = 0; xx < w; xx++) {
+            uint32_t px = argb[(size_t)yy * w + xx];
+            uint8_t a = (px >> 24) & 0xFF;
+            if (a < 16) {
+                bg_pixel_count++;
+                if (bg_pixel_count <= 5)
+                    LOG(3, "DEBUG: Row %d: bg index %d for transparent pixel at x=%d\n", yy, bg_idx, xx);
+                idx[(size_t)yy * w + xx] = bg_idx;
+                continue;
+            }
+            idx[(size_t)yy * w + xx] = (uint8_t)(1 + ((px >> 8) & 0x7));
+        }
+        LOG(3, "DEBUG: Row %d had %d background pixels\n", yy, bg_pixel_count);
+    }
+}
+
+int main(int argc, char **argv) {
+    int w = 1920, h = 200, cues = 2000;
+    if (argc >= 4) { w = atoi(argv[1]); h = atoi(argv[2]); cues = atoi(argv[3]); }
+    size_t n = (size_t)w * h;
+    uint32_t *argb = malloc(n * sizeof(*argb));
+    uint8_t *idx = malloc(n);
+    if (!argb || !idx) return 1;
+    unsigned seed = 1;
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        argb[i] = (seed >> 20) % 4 ? 0 : (0xFF000000u | (seed & 0xFFFFFF));
+    }
+
+    unsigned long sum = 0;
+    double t0 = now_sec();
+    for (int c = 0; c < cues; c++) {
+        LOG(2, "render_text_pango: Input fontfam='%s' fontsize=%d disp_h=%d\n", "Open Sans", 48, h);
+        LOG(3, "DEBUG render_text_pango: bgcolor=%s\n", "(null)");
+        quantise(argb, idx, w, h, (uint8_t)(c & 15));
+        LOG(2, "DEBUG cleanup: Final bitmap position: x=%d y=%d w=%d h=%d\n", 0, 0, w, h);
+        if (LOG_ENABLED(2))
+            LOG(2, "[subs] Cue %d: PTS=%lld ms\n", c, (long long)c * 40);
+        sum += idx[(size_t)c % n];
+    }
+    double dt = now_sec() - t0;
+    printf("max level %d: %d cues %dx%d: %.1f us/cue (checksum %lu)\n",
+           SRT2DVB_MAX_LOG_LEVEL, cues, w, h, dt * 1e6 / cues, sum);
+    free(argb);
+    free(idx);
+    return 0;
+}
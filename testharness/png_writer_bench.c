@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <cairo.h>
+#include "../src/png_writer.h"
+
+/*
+ * PNG writer benchmark: encode a batch of subtitle-sized indexed bitmaps
+ * with the Cairo path used before (expand to ARGB32, then
+ * cairo_surface_write_to_png_stream) and with the native palette writer
+ * at several levels, filters and thread counts. Prints time per cue and
+ * average PNG size.
+ *
+ * Build:
+ *   gcc -std=gnu11 -O2 -Isrc testharness/png_writer_bench.c src/png_writer.c \
+ *       $(pkg-config --cflags --libs cairo zlib) -lpthread -o png_writer_bench
+ * Run:
+ *   ./png_writer_bench [width height cues]     (default 1920 200 200)
+ */
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Two lines of "glyphs": outline ring, fill, anti-aliased edge shades,
+ * transparent elsewhere -- roughly what the renderer produces. */
+static void make_cue(uint8_t *idx, int w, int h, unsigned seed) {
+    memset(idx, 0, (size_t)w * h);
+    int line_h = h / 2;
+    for (int line = 0; line < 2; line++) {
+        int x = 40 + (int)(seed % 60);
+        while (x < w - 80) {
+            seed = seed * 1103515245u + 12345u;
+            int gw = 18 + (int)((seed >> 16) % 30);
+            int gh = line_h - 30 - (int)((seed >> 8) % 20);
+            int y0 = line * line_h + (line_h - gh);
+            for (int y = y0; y < y0 + gh && y < h; y++)
+                for (int xx = x; xx < x + gw; xx++) {
+                    int edge = (y - y0 < 3 || y0 + gh - y <= 3 || xx - x < 3 || x + gw - xx <= 3);
+                    idx[(size_t)y * w + xx] = edge ? (uint8_t)(8 + ((xx + y) & 3)) : 1;
+                }
+            x += gw + 6 + (int)((seed >> 4) % 10);
+            if ((seed >> 12) % 7 == 0) x += 30; /* word gap */
+        }
+    }
+}
+
+typedef struct { unsigned char *data; size_t len, cap; } Sink;
+
+static cairo_status_t sink_write(void *closure, const unsigned char *buf, unsigned int n) {
+    Sink *s = closure;
+    if (s->len + n > s->cap) {
+        size_t cap = s->cap ? s->cap * 2 : 65536;
+        while (cap < s->len + n) cap *= 2;
+        unsigned char *p = realloc(s->data, cap);
+        if (!p) return CAIRO_STATUS_NO_MEMORY;
+        s->data = p;
+        s->cap = cap;
+    }
+    memcpy(s->data + s->len, buf, n);
+    s->len += n;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static size_t encode_cairo(const uint8_t *idx, int w, int h, const uint32_t *pal) {
+    cairo_surface_t *s = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+    unsigned char *data = cairo_image_surface_get_data(s);
+    int stride = cairo_image_surface_get_stride(s);
+    for (int y = 0; y < h; y++) {
+        uint32_t *row = (uint32_t *)(data + (size_t)y * stride);
+        for (int x = 0; x < w; x++)
+            row[x] = pal[idx[(size_t)y * w + x]];
+    }
+    cairo_surface_mark_dirty(s);
+    Sink sink = {0};
+    cairo_surface_write_to_png_stream(s, sink_write, &sink);
+    cairo_surface_destroy(s);
+    free(sink.data);
+    return sink.len;
+}
+
+int main(int argc, char **argv) {
+    int w = 1920, h = 200, cues = 200;
+    if (argc >= 4) { w = atoi(argv[1]); h = atoi(argv[2]); cues = atoi(argv[3]); }
+    if (w <= 0 || h <= 0 || cues <= 0) { fprintf(stderr, "bad arguments\n"); return 1; }
+
+    uint8_t *idx = malloc((size_t)w * h * cues);
+    if (!idx) { fprintf(stderr, "alloc failed\n"); return 1; }
+    for (int i = 0; i < cues; i++)
+        make_cue(idx + (size_t)i * w * h, w, h, (unsigned)i * 7919u + 1u);
+    uint32_t pal[16] = { 0x00000000, 0xFFFFFFFF, 0xFFFFFF00, 0xFF00FFFF, 0xFF00FF00, 0xFFFF00FF,
+                         0xFFFF0000, 0xFF000000, 0xFF7F7F7F, 0xFF7F7F00, 0xFF007F7F, 0xFF007F00,
+                         0xFF7F007F, 0xFF7F0000, 0xFF00007F, 0x80000000 };
+
+    printf("%d cues of %dx%d\n", cues, w, h);
+    double t0 = now_sec();
+    size_t bytes = 0;
+    for (int i = 0; i < cues; i++)
+        bytes += encode_cairo(idx + (size_t)i * w * h, w, h, pal);
+    double t1 = now_sec();
+    double cairo_ms = (t1 - t0) * 1e3 / cues;
+    printf("%-28s %8.3f ms/cue %9zu bytes/cue\n", "cairo ARGB32", cairo_ms, bytes / cues);
+
+    static const struct { const char *name; PngWriterOptions o; } runs[] = {
+        { "native level 1",                 { 1, PNG_FILTER_NONE, 1 } },
+        { "native level 6",                 { 6, PNG_FILTER_NONE, 1 } },
+        { "native level 9",                 { 9, PNG_FILTER_NONE, 1 } },
+        { "native level 6 adaptive",        { 6, PNG_FILTER_ADAPTIVE, 1 } },
+        { "native level 6, 4 threads",      { 6, PNG_FILTER_NONE, 4 } },
+        { "native level 9, 4 threads",      { 9, PNG_FILTER_NONE, 4 } },
+    };
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        bytes = 0;
+        t0 = now_sec();
+        for (int i = 0; i < cues; i++) {
+            unsigned char *png = NULL;
+            size_t len = 0;
+            if (png_encode_indexed(idx + (size_t)i * w * h, w, h, w, pal, 16, &runs[r].o, &png, &len) != 0) {
+                fprintf(stderr, "encode failed\n");
+                return 1;
+            }
+            bytes += len;
+            free(png);
+        }
+        t1 = now_sec();
+        double ms = (t1 - t0) * 1e3 / cues;
+        printf("%-28s %8.3f ms/cue %9zu bytes/cue  (%.1fx vs cairo)\n",
+               runs[r].name, ms, bytes / cues, cairo_ms / ms);
+    }
+    free(idx);
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/qc.h"
+#include "../src/qc_batch.h"
+#include "../src/qc_report.h"
+
+int debug_level = 0;
+int video_w = 1920;
+int video_h = 1080;
+int use_ass = 0;
+
+/*
+ * Per-cue QC (the parser's strip_tags + qc_check_entry per cue) against
+ * qc_check_track() on a large synthetic corpus. Findings go to a JSONL
+ * report on /dev/null in both runs so only the checks are compared; the
+ * finding totals are printed as a cross-check.
+ *
+ * Build:
+ *   gcc -std=gnu11 -O2 -Isrc testharness/qc_batch_bench.c src/qc_batch.c \
+ *       src/qc.c src/qc_report.c src/srt_parser.c src/line_break.c \
+ *       -lpthread -o qc_batch_bench
+ * Run:
+ *   ./qc_batch_bench [cues threads]     (default 1000000 4)
+ */
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static const char *texts[] = {
+    "Where are you going?",
+    "<i>I told you already.</i>\nTo the station.",
+    "- Did you hear that?\n- Hear what?",
+    "<font color=\"#ffff00\">[door slams]</font>",
+    "Ich habe es dir doch schon gesagt,\nwir fahren morgen früh los.",
+    "This line has been written to be much longer than any broadcast limit allows.",
+};
+
+int main(int argc, char **argv) {
+    int n = 1000000, threads = 4;
+    if (argc >= 3) { n = atoi(argv[1]); threads = atoi(argv[2]); }
+    SRTEntry *e = calloc((size_t)n, sizeof(*e));
+    if (!e) return 1;
+    unsigned seed = 1;
+    int64_t t = 0;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = seed >> 8;
+        int64_t gap = 1500 + r % 2500;
+        e[i].start_ms = r % 97 ? t : t - 900;               /* ~1% overlaps */
+        e[i].end_ms = t + 200 + (r >> 4) % (gap - 250);      /* ~2% short */
+        e[i].text = (char *)texts[(r >> 12) % (sizeof(texts) / sizeof(texts[0]))];
+        t += gap;
+    }
+
+    FILE *sink = fopen("/dev/null", "w");
+    QCReport *r = qc_report_create(QC_REPORT_JSONL, sink);
+    qc_set_report(r);
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++) {
+        SRTEntry tmp = e[i];
+        tmp.text = strip_tags(e[i].text);
+        qc_check_entry("bench.srt", i, &tmp, i > 0 ? &e[i - 1] : NULL, NULL);
+        free(tmp.text);
+    }
+    double per_cue = now_sec() - t0;
+    qc_report_finish(r);
+    long findings_a = qc_report_total(r);
+    qc_report_destroy(r);
+
+    r = qc_report_create(QC_REPORT_JSONL, sink);
+    qc_set_report(r);
+    t0 = now_sec();
+    qc_check_track("bench.srt", e, n, NULL, 1);
+    double batch1 = now_sec() - t0;
+    qc_report_finish(r);
+    long findings_b = qc_report_total(r);
+    qc_report_destroy(r);
+
+    r = qc_report_create(QC_REPORT_JSONL, sink);
+    qc_set_report(r);
+    t0 = now_sec();
+    qc_check_track("bench.srt", e, n, NULL, threads);
+    double batchn = now_sec() - t0;
+    qc_report_finish(r);
+    long findings_c = qc_report_total(r);
+    qc_set_report(NULL);
+    qc_report_destroy(r);
+    fclose(sink);
+
+    printf("%d cues: per-cue %.1f ms, batch 1 thread %.1f ms, batch %d threads %.1f ms"
+           " (findings %ld/%ld/%ld)\n",
+           n, per_cue * 1e3, batch1 * 1e3, threads, batchn * 1e3,
+           findings_a, findings_b, findings_c);
+    free(e);
+    return findings_a == findings_b && findings_b == findings_c ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include "../src/render_pool.h"
+#include "../src/bench.h"
+
+/*
+ * Worker-side encode hook: jobs submitted with render_pool_ctx_submit_encoded()
+ * must come back with the hook's payload, plain async jobs must not, each
+ * worker's private state must be released exactly once at shutdown, and a
+ * payload left in an abandoned job must be freed by the pool. Borrowed
+ * (render_pool_ctx_submit_ref) jobs behave like encoded ones.
+ *
+ * Build (libavutil headers only; the renderer and av_free are stubbed):
+ *   gcc -std=gnu11 -Isrc testharness/render_pool_encode_test.c \
+ *       src/render_pool.c src/bench.c -lpthread -o rp_encode
+ */
+
+/* Stub renderer: encode the markup length in the bitmap width. */
+Bitmap render_text_pango(const char *markup,
+                         int disp_w, int disp_h,
+                         int fontsize, const char *fontfam,
+                         const char *fontstyle,
+                         const char *fgcolor, const char *outlinecolor,
+                         const char *shadowcolor, const char *bgcolor,
+                         SubtitlePositionConfig *pos_config,
+                         const char *palette_mode) {
+    (void)disp_w; (void)disp_h; (void)fontsize; (void)fontfam; (void)fontstyle;
+    (void)fgcolor; (void)outlinecolor; (void)shadowcolor; (void)bgcolor;
+    (void)pos_config; (void)palette_mode;
+    usleep(500);
+    Bitmap b = {0};
+    b.w = markup ? (int)strlen(markup) : 0;
+    return b;
+}
+
+/* libavutil stand-in for the buffers the pool frees on shutdown. */
+void av_free(void *p) { free(p); }
+
+static atomic_int states_created;
+static atomic_int states_released;
+
+/* Stub encoder: payload = "<track>:<width>:<duration>", per-worker state
+ * counts the cues this worker encoded. */
+static int stub_encode(void *opaque, void **worker_state, int track_id,
+                       const Bitmap *bm, int64_t duration_ms, RenderPayload *out) {
+    assert(opaque == (void *)&states_created);
+    if (!*worker_state) {
+        *worker_state = calloc(1, sizeof(int));
+        atomic_fetch_add(&states_created, 1);
+    }
+    (*(int *)*worker_state)++;
+    char tmp[64];
+    int n = snprintf(tmp, sizeof(tmp), "%d:%d:%lld", track_id, bm->w, (long long)duration_ms);
+    out->data = malloc((size_t)n);
+    memcpy(out->data, tmp, (size_t)n);
+    out->size = n;
+    return 0;
+}
+
+static void stub_release(void *opaque, void *worker_state) {
+    (void)opaque;
+    free(worker_state);
+    atomic_fetch_add(&states_released, 1);
+}
+
+int main(void) {
+    RenderPool *pool = render_pool_create(3, NULL);
+    assert(pool);
+    render_pool_ctx_set_encoder(pool, stub_encode, stub_release, &states_created);
+
+    for (int i = 0; i < 8; i++)
+        assert(render_pool_ctx_submit_encoded(pool, 1, i, "abcd", 720, 576, 0, NULL, NULL,
+                                              NULL, NULL, NULL, NULL, 2, 0.0, NULL, NULL,
+                                              1000 + i) == 0);
+    assert(render_pool_ctx_submit_async(pool, 2, 0, "xy", 720, 576, 0, NULL, NULL,
+                                        NULL, NULL, NULL, NULL, 2, 0.0, NULL, NULL) == 0);
+
+    for (int i = 0; i < 8; i++) {
+        Bitmap bm = {0};
+        RenderPayload pl = {0};
+        assert(render_pool_ctx_wait_payload(pool, 1, i, &bm, &pl) == 1);
+        char want[64];
+        int n = snprintf(want, sizeof(want), "1:4:%d", 1000 + i);
+        assert(bm.w == 4);
+        assert(pl.data && pl.size == n && memcmp(pl.data, want, (size_t)n) == 0);
+        free(pl.data);
+    }
+
+    /* plain async job: no payload even though a hook is installed */
+    Bitmap bm = {0};
+    RenderPayload pl = {0};
+    assert(render_pool_ctx_wait_payload(pool, 2, 0, &bm, &pl) == 1);
+    assert(bm.w == 2 && pl.data == NULL && pl.size == 0);
+
+    /* borrowed submission: the job renders the caller's buffer as-is */
+    static const char borrowed[] = "borrowed";
+    assert(render_pool_ctx_submit_ref(pool, 4, 0, borrowed, 720, 576, 0, NULL, NULL,
+                                      NULL, NULL, NULL, NULL, 2, 0.0, NULL, NULL,
+                                      1, 7) == 0);
+    assert(render_pool_ctx_wait_payload(pool, 4, 0, &bm, &pl) == 1);
+    assert(bm.w == 8 && pl.data && pl.size == 5 && memcmp(pl.data, "4:8:7", 5) == 0);
+    free(pl.data);
+
+    /* abandoned encoded job: the pool frees its payload on destroy */
+    assert(render_pool_ctx_submit_encoded(pool, 3, 0, "zz", 720, 576, 0, NULL, NULL,
+                                          NULL, NULL, NULL, NULL, 2, 0.0, NULL, NULL,
+                                          40) == 0);
+
+    render_pool_destroy(pool);
+    assert(atomic_load(&states_created) >= 1);
+    assert(atomic_load(&states_created) == atomic_load(&states_released));
+    printf("render_pool_encode_test: all checks passed\n");
+    return 0;
+}
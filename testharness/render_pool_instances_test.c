@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include "../src/render_pool.h"
+#include "../src/bench.h"
+
+/*
+ * Two private RenderPool instances must not share queues or bench
+ * counters: the same (track, cue) key is submitted to both pools and each
+ * result must come back from the pool it was submitted to.
+ *
+ * Build (libavutil headers only; the renderer and av_free are stubbed):
+ *   gcc -std=gnu11 -Isrc testharness/render_pool_instances_test.c \
+ *       src/render_pool.c src/bench.c -lpthread -o rp_instances
+ */
+
+/* Stub renderer: encode the markup length in the bitmap width. */
+Bitmap render_text_pango(const char *markup,
+                         int disp_w, int disp_h,
+                         int fontsize, const char *fontfam,
+                         const char *fontstyle,
+                         const char *fgcolor, const char *outlinecolor,
+                         const char *shadowcolor, const char *bgcolor,
+                         SubtitlePositionConfig *pos_config,
+                         const char *palette_mode) {
+    (void)disp_w; (void)disp_h; (void)fontsize; (void)fontfam; (void)fontstyle;
+    (void)fgcolor; (void)outlinecolor; (void)shadowcolor; (void)bgcolor;
+    (void)pos_config; (void)palette_mode;
+    usleep(1000);
+    Bitmap b = {0};
+    b.w = markup ? (int)strlen(markup) : 0;
+    return b;
+}
+
+/* libavutil stand-in for the buffers the pool frees on shutdown. */
+void av_free(void *p) { free(p); }
+
+static Bitmap wait_result(RenderPool *pool, int track, int cue) {
+    Bitmap out = {0};
+    for (int tries = 0; tries < 5000; tries++) {
+        int r = render_pool_ctx_try_get(pool, track, cue, &out);
+        if (r == 1) return out;
+        assert(r == 0);
+        usleep(1000);
+    }
+    fprintf(stderr, "FAIL: job (%d,%d) never completed\n", track, cue);
+    exit(1);
+}
+
+int main(void) {
+    BenchStats ba = {0}, bb = {0};
+    ba.enabled = 1;
+    bb.enabled = 1;
+
+    RenderPool *pa = render_pool_create(2, &ba);
+    RenderPool *pb = render_pool_create(3, &bb);
+    assert(pa && pb);
+
+    /* identical keys, different payloads */
+    assert(render_pool_ctx_submit_async(pa, 0, 7, "aa", 720, 576, 0, NULL, NULL,
+                                        NULL, NULL, NULL, NULL, 2, 0.0, NULL, NULL) == 0);
+    assert(render_pool_ctx_submit_async(pb, 0, 7, "bbbbbb", 720, 576, 0, NULL, NULL,
+                                        NULL, NULL, NULL, NULL, 2, 0.0, NULL, NULL) == 0);
+    for (int i = 0; i < 5; i++)
+        assert(render_pool_ctx_submit_async(pb, 1, i, "x", 720, 576, 0, NULL, NULL,
+                                            NULL, NULL, NULL, NULL, 2, 0.0, NULL, NULL) == 0);
+
+    Bitmap ra = wait_result(pa, 0, 7);
+    Bitmap rb = wait_result(pb, 0, 7);
+    assert(ra.w == 2);
+    assert(rb.w == 6);
+    for (int i = 0; i < 5; i++) (void)wait_result(pb, 1, i);
+
+    /* key is gone once retrieved, and was never visible in the other pool */
+    Bitmap none;
+    assert(render_pool_ctx_try_get(pa, 0, 7, &none) == -1);
+    assert(render_pool_ctx_try_get(pa, 1, 0, &none) == -1);
+
+    Bitmap sync = render_pool_ctx_render_sync(pa, "sync", 720, 576, 0, NULL, NULL,
+                                              NULL, NULL, NULL, NULL, NULL, NULL);
+    assert(sync.w == 4);
+
+    BenchStats sa, sb, sg;
+    bench_stats_snapshot(&ba, &sa);
+    bench_stats_snapshot(&bb, &sb);
+    bench_stats_snapshot(NULL, &sg);
+    assert(sa.cues_rendered == 2);
+    assert(sb.cues_rendered == 6);
+    assert(sg.cues_rendered == 0);
+
+    /* wait_timed splits queue wait from the worker's render time: the
+     * third job on a one-worker pool waits for two 1 ms renders first */
+    BenchStats bc = {0};
+    RenderPool *pc = render_pool_create(1, &bc);
+    assert(pc);
+    for (int i = 0; i < 3; i++)
+        assert(render_pool_ctx_submit_async(pc, 0, i, "t", 720, 576, 0, NULL, NULL,
+                                            NULL, NULL, NULL, NULL, 2, 0.0, NULL, NULL) == 0);
+    RenderJobTiming tm;
+    Bitmap rt;
+    assert(render_pool_ctx_wait_timed(pc, 0, 2, &rt, NULL, &tm) == 1);
+    assert(rt.w == 1);
+    assert(tm.render_us >= 1000);
+    assert(tm.queue_us >= 1500);
+    (void)wait_result(pc, 0, 0);
+    (void)wait_result(pc, 0, 1);
+    render_pool_destroy(pc);
+
+    render_pool_destroy(pa);
+    render_pool_destroy(pb);
+    printf("render_pool_instances_test: all checks passed\n");
+    return 0;
+}
@@ -40,6 +40,25 @@ static int test_srt_html_to_ass(void) {
     return 0;
 }
 
+static int test_unclosed_and_truncated_tags(void) {
+    /* Unclosed openers stay literal; text after a closed tag is kept. */
+    char *out = strip_tags("a<b>c{d<e{f");
+    if (!out) return 1;
+    ASSERT_MSG(strcmp(out, "ac{d<e{f") == 0, "strip_tags keeps unclosed openers literal");
+    free(out);
+
+    /* A <font> tag cut off after its attribute must not read past the end. */
+    out = srt_html_to_ass("x<font color=\"#00FF00\"");
+    if (!out) return 1;
+    ASSERT_MSG(strcmp(out, "x{\\1c&H00FF00&}") == 0, "srt_html_to_ass handles a truncated <font> tag");
+    free(out);
+    out = srt_html_to_ass("<font face=\"Serif\">y");
+    if (!out) return 1;
+    ASSERT_MSG(strcmp(out, "{\\fnSerif}y") == 0, "srt_html_to_ass skips the closing '>' of <font face>");
+    free(out);
+    return 0;
+}
+
 static int write_sample_srt(const char *path) {
     FILE *f = fopen(path, "w");
     if (!f) return -1;
@@ -92,14 +111,69 @@ static int test_parse_srt_wrapper(void) {
     return 0;
 }
 
+static int test_parse_alignment(void) {
+    /* {\anX} is resolved at parse time and removed from the cue text. */
+    const char *path = "./test_sample3.srt";
+    FILE *f = fopen(path, "w");
+    if (!f) { fprintf(stderr, "FAIL: unable to write sample srt: %s\n", strerror(errno)); return 1; }
+    fprintf(f, "1\n00:00:00,000 --> 00:00:01,000\n{\\an8}Top line\n\n");
+    fprintf(f, "2\n00:00:01,100 --> 00:00:02,100\nPlain\n\n");
+    fprintf(f, "3\n00:00:02,200 --> 00:00:03,200\n<i>{\\an7}Left</i> {\\an9}\n\n");
+    fprintf(f, "4\n00:00:03,300 --> 00:00:04,300\n{\\an0}Zero\n\n");
+    fclose(f);
+
+    SRTEntry *entries = NULL;
+    SRTParserConfig cfg = { .use_ass = 0, .video_w = 1280, .video_h = 720 };
+    int n = parse_srt_cfg(path, &entries, NULL, &cfg);
+    ASSERT_MSG(n == 4, "alignment sample parses 4 entries");
+    ASSERT_MSG(entries[0].alignment == 8, "first entry alignment == 8");
+    ASSERT_MSG(entries[0].alignment_tag, "first entry alignment is tagged");
+    ASSERT_MSG(strstr(entries[0].text, "\\an") == NULL, "alignment tag removed from text");
+    ASSERT_MSG(strstr(entries[0].text, "Top line") != NULL, "text after tag preserved");
+    ASSERT_MSG(entries[1].alignment == 2, "untagged entry alignment defaults to 2");
+    ASSERT_MSG(!entries[1].alignment_tag, "untagged entry has no alignment tag");
+    ASSERT_MSG(entries[2].alignment == 7 && entries[2].alignment_tag, "first tag in raw text wins");
+    ASSERT_MSG(entries[3].alignment == 2 && !entries[3].alignment_tag, "{\\an0} keeps default 2");
+
+    for (int i = 0; i < n; i++) free(entries[i].text);
+    free(entries);
+    remove(path);
+    return 0;
+}
+
+static int test_ass_hard_spaces(void) {
+    const char *path = "./test_hard_spaces.srt";
+    FILE *f = fopen(path, "w");
+    if (!f) return 1;
+    fprintf(f, "1\n00:00:00,000 --> 00:00:01,000\nA\\hB\\h\\hC\\\\h\n\n");
+    fclose(f);
+
+    /* Converted cues drop "\h"; ASS passthrough turns it into a space. */
+    for (int ass = 0; ass <= 1; ass++) {
+        SRTEntry *entries = NULL;
+        SRTParserConfig cfg = { .use_ass = ass, .video_w = 1280, .video_h = 720 };
+        int n = parse_srt_cfg(path, &entries, NULL, &cfg);
+        ASSERT_MSG(n == 1, "hard-space cue parsed");
+        ASSERT_MSG(strcmp(entries[0].text, ass ? "A B  C\\ \n" : "ABC\\") == 0,
+                   ass ? "\\h replaced by spaces with --ass" : "\\h removed without --ass");
+        free(entries[0].text);
+        free(entries);
+    }
+    remove(path);
+    return 0;
+}
+
 int main(void) {
     int rc = 0;
     fprintf(stderr, "Running srt_parser test harness...\n");
 
     rc |= test_strip_tags();
     rc |= test_srt_html_to_ass();
+    rc |= test_unclosed_and_truncated_tags();
     rc |= test_parse_srt_cfg();
     rc |= test_parse_srt_wrapper();
+    rc |= test_parse_alignment();
+    rc |= test_ass_hard_spaces();
 
     if (rc == 0) fprintf(stderr, "ALL TESTS PASSED\n");
     else fprintf(stderr, "SOME TESTS FAILED (code=%d)\n", rc);
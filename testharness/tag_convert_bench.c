@@ -0,0 +1,176 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The parser source is included to reach its static converters. */
+#include "../src/srt_parser.c"
+
+int debug_level = 0;
+int video_w = 1920;
+int video_h = 1080;
+int use_ass = 0;
+
+/*
+ * Worst-case inputs for the cue text converters: normalize_tags,
+ * srt_html_to_ass, strip_tags and the in-place \h rewriters. Each case is
+ * timed at N bytes and at 16N bytes; with linear converters the ns/byte
+ * columns match, while a quadratic one grows about 16-fold. The in-place
+ * rewriters are timed on a fresh copy of the input each run, so their
+ * figures include one memcpy.
+ *
+ * Build:
+ *   gcc -std=gnu11 -O2 -Isrc testharness/tag_convert_bench.c src/qc.c \
+ *       src/qc_report.c src/line_break.c -o tag_convert_bench
+ * Run:
+ *   ./tag_convert_bench [bytes]     (default 65536)
+ */
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    const char *name;
+    const char *unit; /* repeated to the target size */
+    const char *tail; /* appended once */
+} BenchCase;
+
+static const BenchCase cases[] = {
+    { "ass overrides",      "{\\i1}x{\\b1}y{\\c&H00FF00&}z{\\i0}{\\b0}", "" },
+    { "unterminated colour","{\\c&H",                                    "" },
+    { "unterminated font",  "{\\fn",                                     "}" },
+    { "html tags",          "<i>a</i><b>b</b><font color=\"#FF0000\">c</font>\n", "" },
+    { "unquoted font",      "<font color=",                              "\"" },
+    { "\\h escapes",        "\\h",                                       "" },
+    { "plain text",         "word ",                                     "" },
+};
+
+enum { F_NORMALIZE, F_HTML_TO_ASS, F_STRIP, F_REPLACE_H, F_REMOVE_H, F_COUNT };
+static const char *fn_names[F_COUNT] = {
+    "normalize_tags", "srt_html_to_ass", "strip_tags", "replace_ass_h", "remove_ass_h"
+};
+
+static char *make_input(const BenchCase *c, size_t bytes) {
+    size_t ul = strlen(c->unit), tl = strlen(c->tail);
+    size_t reps = bytes / ul ? bytes / ul : 1;
+    char *s = malloc(reps * ul + tl + 1);
+    if (!s) return NULL;
+    for (size_t i = 0; i < reps; i++)
+        memcpy(s + i * ul, c->unit, ul);
+    memcpy(s + reps * ul, c->tail, tl + 1);
+    return s;
+}
+
+/* Best of three runs of `fn` on `in`, in ns per input byte. */
+static double time_fn(int fn, const char *in, char *scratch) {
+    size_t len = strlen(in);
+    double best = 1e30;
+    for (int k = 0; k < 3; k++) {
+        double t0 = now_sec();
+        char *out = NULL;
+        switch (fn) {
+        case F_NORMALIZE:   out = normalize_tags(in); break;
+        case F_HTML_TO_ASS: out = srt_html_to_ass(in); break;
+        case F_STRIP:       out = strip_tags(in); break;
+        case F_REPLACE_H:   memcpy(scratch, in, len + 1); replace_ass_h(scratch); break;
+        case F_REMOVE_H:    memcpy(scratch, in, len + 1); remove_ass_h(scratch); break;
+        }
+        double dt = now_sec() - t0;
+        free(out);
+        if (dt < best) best = dt;
+    }
+    return best * 1e9 / (double)len;
+}
+
+/* Expected output of the converters on small inputs. */
+static void check(char *out, const char *want) {
+    assert(out && strcmp(out, want) == 0);
+    free(out);
+}
+
+int main(int argc, char **argv) {
+    size_t bytes = argc > 1 ? strtoul(argv[1], NULL, 10) : 65536;
+    if (bytes < 64) bytes = 64;
+
+    check(normalize_tags("{\\i1}{\\b1}x{\\i0}y"), "<i><b>x</b></i>y");
+    check(normalize_tags("{\\fnArial}x{\\pos(1,2)}"), "<span font=\"Arial\">x</span>");
+    check(normalize_tags("{\\c&H0000FF&x"), "<span foreground=\"#FF0000\">{\\c&H0000FF&x</span>");
+    check(srt_html_to_ass("<I>a</i>\r\n<font color=\"#112233\">b</font>"),
+          "{\\i1}a{\\i0}\\N{\\1c&H112233&}b{\\r}");
+    char h[] = "a\\hb\\\\h";
+    replace_ass_h(h);
+    assert(strcmp(h, "a b\\ ") == 0);
+
+    char *scratch = malloc(bytes * 16 + 64);
+    if (!scratch) return 1;
+    printf("%-20s %-16s %12s %12s\n", "input", "converter", "ns/B @N", "ns/B @16N");
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        char *small = make_input(&cases[c], bytes);
+        char *large = make_input(&cases[c], bytes * 16);
+        if (!small || !large) return 1;
+        for (int fn = 0; fn < F_COUNT; fn++) {
+            double a = time_fn(fn, small, scratch);
+            double b = time_fn(fn, large, scratch);
+            printf("%-20s %-16s %12.2f %12.2f%s\n", cases[c].name, fn_names[fn], a, b,
+                   b > a * 4.0 && b > 1.0 ? "  super-linear" : "");
+        }
+        free(small);
+        free(large);
+    }
+    free(scratch);
+    printf("tag_convert_bench: N = %zu bytes\n", bytes);
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_audio_sync.c
+ * Checks the audio/subtitle offset estimate on synthetic envelopes:
+ * speech bursts following the cues late or early by a known amount,
+ * over a fluctuating music/noise bed, are found to within one bin with
+ * high confidence; the track's existing delay is taken into account;
+ * cues unrelated to the audio give low confidence; and the vectorised
+ * sum-of-squares helpers agree with a plain loop.
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_audio_sync.c src/audio_sync.c \
+ *        -lm -o test_audio_sync
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "audio_sync.h"
+
+int debug_level = 0;
+
+#define SECONDS 600
+
+static unsigned rng = 1;
+static double frand(void)
+{
+    rng = rng * 1103515245u + 12345u;
+    return ((rng >> 8) & 0xFFFF) / 65536.0;
+}
+
+static SRTEntry *make_cues(unsigned seed, int *count)
+{
+    rng = seed;
+    SRTEntry *e = calloc(1000, sizeof(*e));
+    int n = 0;
+    int64_t t = 2000;
+    while (t < SECONDS * 1000 - 5000 && n < 1000) {
+        int64_t dur = 1000 + (int64_t)(frand() * 3000);
+        e[n].start_ms = t;
+        e[n].end_ms = t + dur;
+        e[n].text = "x";
+        n++;
+        t += dur + 200 + (int64_t)(frand() * 4000);
+    }
+    *count = n;
+    return e;
+}
+
+/* Speech where the cues (moved by shift_ms) are, over a noisy bed. */
+static void make_audio(const SRTEntry *e, int n, int shift_ms, AudioEnvelope *env)
+{
+    env->hop_ms = AUDIO_SYNC_HOP_MS;
+    env->n = SECONDS * 1000 / AUDIO_SYNC_HOP_MS;
+    env->power = calloc((size_t)env->n, sizeof(float));
+    rng = 77;
+    for (int i = 0; i < env->n; i++) {
+        double music = 0.002 * (1.5 + sin(i * 0.003));
+        env->power[i] = (float)(music * (0.5 + frand()));
+    }
+    for (int c = 0; c < n; c++) {
+        int64_t s = (e[c].start_ms + shift_ms + (int)(frand() * 200) - 100) / AUDIO_SYNC_HOP_MS;
+        int64_t t = (e[c].end_ms + shift_ms + (int)(frand() * 200) - 100) / AUDIO_SYNC_HOP_MS;
+        for (int64_t i = s; i < t; i++) {
+            if (i < 0 || i >= env->n)
+                continue;
+            double syll = 0.5 + 0.5 * sin(i * 0.9);   /* syllable rhythm */
+            env->power[i] += (float)(0.05 * syll * (0.3 + frand()));
+        }
+    }
+}
+
+static void check_offset(int shift_ms, int delay_ms)
+{
+    int n;
+    SRTEntry *e = make_cues(5, &n);
+    AudioEnvelope env;
+    make_audio(e, n, shift_ms, &env);
+    AudioSync *s = audio_sync_create(&env);
+    assert(s);
+    audio_sync_envelope_free(&env);
+
+    AudioSyncResult r;
+    assert(audio_sync_track(s, e, n, delay_ms, AUDIO_SYNC_MAX_LAG_MS, &r) == 0);
+    assert(abs(r.offset_ms - (shift_ms - delay_ms)) <= AUDIO_SYNC_HOP_MS);
+    assert(r.cues_used == n);
+    assert(r.peak > 0.3 && r.confidence >= 0.5);
+    assert(audio_sync_confidence_label(r.confidence)[0] == 'h');
+
+    /* A track unrelated to this audio. */
+    int m;
+    SRTEntry *other = make_cues(999, &m);
+    AudioSyncResult u;
+    assert(audio_sync_track(s, other, m, 0, AUDIO_SYNC_MAX_LAG_MS, &u) == 0);
+    assert(u.confidence < 0.2 && u.peak < r.peak / 2);
+
+    audio_sync_destroy(s);
+    free(other);
+    free(e);
+}
+
+static void check_sumsq(void)
+{
+    float f[37];
+    int16_t s16[37];
+    int32_t s32[37];
+    double want_f = 0, want_16 = 0, want_32 = 0;
+    for (int i = 0; i < 37; i++) {
+        f[i] = (float)sin(i);
+        s16[i] = (int16_t)(f[i] * 32767);
+        s32[i] = (int32_t)(f[i] * 2147483647.0);
+        want_f += (double)f[i] * f[i];
+        want_16 += (s16[i] / 32768.0) * (s16[i] / 32768.0);
+        want_32 += (s32[i] / 2147483648.0) * (s32[i] / 2147483648.0);
+    }
+    assert(fabs(audio_sync_sumsq_f32(f, 37) - want_f) < 1e-4);
+    assert(fabs(audio_sync_sumsq_s16(s16, 37) - want_16) < 1e-4);
+    assert(fabs(audio_sync_sumsq_s32(s32, 37) - want_32) < 1e-4);
+}
+
+int main(void)
+{
+    check_sumsq();
+    check_offset(1500, 0);
+    check_offset(1500, 1000);
+    check_offset(-2340, 0);
+    check_offset(0, 0);
+
+    /* Too little audio is rejected rather than guessed. */
+    AudioEnvelope tiny = { AUDIO_SYNC_HOP_MS, 10, calloc(10, sizeof(float)) };
+    assert(audio_sync_create(&tiny) == NULL);
+    audio_sync_envelope_free(&tiny);
+    printf("test_audio_sync: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_clut_cache.c
+ * Checks the cached CLUT conversion: BT.601 entries agree with the
+ * integer conversion libavcodec's dvbsub encoder applies, BT.709 encoder
+ * palettes land on the BT.709 values after that same conversion, repeated
+ * lookups of one palette hit the cache, and --colorimetry parsing and
+ * auto resolution behave as documented.
+ *
+ * Build: gcc -std=gnu11 -Wall -Isrc testharness/test_clut_cache.c \
+ *        src/clut_cache.c -lm -lpthread -o test_clut_cache
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "clut_cache.h"
+
+/* libavutil/colorspace.h CCIR macros, as used by the dvbsub encoder. */
+#define SCALEBITS 10
+#define ONE_HALF (1 << (SCALEBITS - 1))
+#define FIX(x) ((int)((x) * (1 << SCALEBITS) + 0.5))
+#define RGB_TO_Y_CCIR(r, g, b) \
+    ((FIX(0.29900 * 219.0 / 255.0) * (r) + FIX(0.58700 * 219.0 / 255.0) * (g) + \
+      FIX(0.11400 * 219.0 / 255.0) * (b) + (ONE_HALF + (16 << SCALEBITS))) >> SCALEBITS)
+#define RGB_TO_U_CCIR(r1, g1, b1) \
+    (((-FIX(0.16874 * 224.0 / 255.0) * (r1) - FIX(0.33126 * 224.0 / 255.0) * (g1) + \
+       FIX(0.50000 * 224.0 / 255.0) * (b1) + ONE_HALF - 1) >> SCALEBITS) + 128)
+#define RGB_TO_V_CCIR(r1, g1, b1) \
+    (((FIX(0.50000 * 224.0 / 255.0) * (r1) - FIX(0.41869 * 224.0 / 255.0) * (g1) - \
+       FIX(0.08131 * 224.0 / 255.0) * (b1) + ONE_HALF - 1) >> SCALEBITS) + 128)
+
+static void encoder_ycbcr(uint32_t c, int *y, int *cb, int *cr) {
+    int r = (c >> 16) & 0xFF, g = (c >> 8) & 0xFF, b = c & 0xFF;
+    *y = RGB_TO_Y_CCIR(r, g, b);
+    *cb = RGB_TO_U_CCIR(r, g, b);
+    *cr = RGB_TO_V_CCIR(r, g, b);
+}
+
+int main(void) {
+    uint32_t pal[16];
+    srand(3);
+    pal[0] = 0;
+    for (int i = 1; i < 16; i++)
+        pal[i] = 0xFF000000u | ((uint32_t)rand() & 0xFFFFFF);
+    pal[1] = 0xFFFFFFFFu;
+    pal[2] = 0xFF000000u;
+    pal[3] = 0x80FFFF00u;
+
+    /* BT.601: matches the encoder to within rounding, identity palette */
+    const ClutCacheEntry *e601 = clut_cache_get(pal, 16, CLUT_COLORIMETRY_BT601);
+    assert(e601 && e601->ncolors == 16);
+    ClutYCbCrT y601[16], y709[16];
+    for (int i = 0; i < 16; i++) {
+        y601[i] = clut_argb_to_ycbcrt(pal[i], CLUT_COLORIMETRY_BT601);
+        y709[i] = clut_argb_to_ycbcrt(pal[i], CLUT_COLORIMETRY_BT709);
+        int y, cb, cr;
+        encoder_ycbcr(pal[i], &y, &cb, &cr);
+        assert(abs(y601[i].y - y) <= 1);
+        assert(abs(y601[i].cb - cb) <= 1);
+        assert(abs(y601[i].cr - cr) <= 1);
+        assert(y601[i].t == 255 - (pal[i] >> 24));
+        assert(e601->encoder_argb[i] == pal[i]);
+    }
+    assert(y601[1].y == 235 && y601[2].y == 16);
+    assert(e601->clipped == 0);
+
+    /* BT.709: the encoder's BT.601 conversion of the substituted palette
+     * gives the BT.709 values (a couple of codes of slack for the double
+     * rounding through 8-bit RGB). Saturated colours whose BT.601 RGB
+     * falls outside 0..255 are clipped and only approximate. */
+    const ClutCacheEntry *e709 = clut_cache_get(pal, 16, CLUT_COLORIMETRY_BT709);
+    assert(e709 && e709 != e601);
+    int differs = 0, exact = 0;
+    for (int i = 0; i < 16; i++) {
+        uint32_t c = e709->encoder_argb[i];
+        assert((c >> 24) == (pal[i] >> 24));
+        differs |= y709[i].cb != y601[i].cb;
+        int clipped = 0;
+        for (int s = 0; s < 24; s += 8) {
+            unsigned v = (c >> s) & 0xFF;
+            clipped |= v == 0 || v == 255;
+        }
+        if (clipped)
+            continue;
+        int y, cb, cr;
+        encoder_ycbcr(c, &y, &cb, &cr);
+        assert(abs(y709[i].y - y) <= 2);
+        assert(abs(y709[i].cb - cb) <= 2);
+        assert(abs(y709[i].cr - cr) <= 2);
+        exact++;
+    }
+    assert(differs && exact >= 8);
+    /* greys are the same in both matrices */
+    assert(e709->encoder_argb[1] == pal[1] && e709->encoder_argb[2] == pal[2]);
+
+    /* Pure red in BT.709 needs G of about -27 in BT.601 RGB: clamped to 0
+     * and counted, so the encoder's CLUT entry is only approximate. */
+    uint32_t red = 0xFFFF0000u;
+    const ClutCacheEntry *er = clut_cache_get(&red, 1, CLUT_COLORIMETRY_BT709);
+    assert(er && er->clipped == 1);
+    assert(((er->encoder_argb[0] >> 8) & 0xFF) == 0);
+    long clipped_before = clut_cache_clipped();
+    assert(clipped_before >= 1 && clipped_before >= e709->clipped + 1);
+    const ClutCacheEntry *er601 = clut_cache_get(&red, 1, CLUT_COLORIMETRY_BT601);
+    assert(er601 && er601->clipped == 0 && er601->encoder_argb[0] == red);
+
+    uint32_t direct[16];
+    clut_encoder_palette(pal, 16, CLUT_COLORIMETRY_BT709, direct);
+    for (int i = 0; i < 16; i++)
+        assert(direct[i] == e709->encoder_argb[i]);
+
+    /* cache: same palette -> same entry; a changed entry -> new entry */
+    long hits = 0, misses = 0;
+    for (int k = 0; k < 100; k++)
+        assert(clut_cache_get(pal, 16, CLUT_COLORIMETRY_BT709) == e709);
+    clut_cache_stats(&hits, &misses);
+    assert(hits == 100 && misses == 4);
+    pal[5] ^= 1;
+    assert(clut_cache_get(pal, 16, CLUT_COLORIMETRY_BT709) != e709);
+    assert(clut_cache_get(pal, 16, CLUT_COLORIMETRY_AUTO) == NULL);
+    clut_cache_clear();
+    clut_cache_stats(&hits, &misses);
+    assert(hits == 0 && misses == 0 && clut_cache_clipped() == 0);
+
+    ClutColorimetry cm;
+    assert(clut_colorimetry_parse("bt709", &cm) == 0 && cm == CLUT_COLORIMETRY_BT709);
+    assert(clut_colorimetry_parse("auto", &cm) == 0 && cm == CLUT_COLORIMETRY_AUTO);
+    assert(clut_colorimetry_parse("rec2020", &cm) == -1);
+    assert(clut_colorimetry_for_video(1, 576) == CLUT_COLORIMETRY_BT709);
+    assert(clut_colorimetry_for_video(5, 1080) == CLUT_COLORIMETRY_BT601);
+    assert(clut_colorimetry_for_video(2, 1080) == CLUT_COLORIMETRY_BT709);
+    assert(clut_colorimetry_for_video(-1, 576) == CLUT_COLORIMETRY_BT601);
+
+    printf("test_clut_cache: all checks passed\n");
+    return 0;
+}
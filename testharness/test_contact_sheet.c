@@ -0,0 +1,280 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "../src/contact_sheet.h"
+
+/*
+ * Contact sheets: cues are packed without overlap, every cue appears in
+ * the JSON index with its timing and escaped text, pages split when space
+ * or the merged palette runs out, and decoding a page at the indexed
+ * rectangle gives back each cue's colours.
+ *
+ * Build:
+ *   gcc -std=gnu11 -Wall -Isrc testharness/test_contact_sheet.c \
+ *       src/contact_sheet.c src/png_writer.c -lz -lpthread -o test_contact_sheet
+ */
+
+#define NCUES 40
+
+typedef struct {
+    int w, h;
+    uint8_t *idx;
+    uint32_t pal[16];
+} Cue;
+
+typedef struct {
+    int cue, page, x, y, w, h, pos_x, pos_y;
+    long long start_ms, end_ms;
+} Entry;
+
+static uint32_t be32(const unsigned char *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static unsigned char *slurp(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    assert(f);
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char *buf = malloc((size_t)n + 1);
+    assert(fread(buf, 1, (size_t)n, f) == (size_t)n);
+    buf[n] = 0;
+    fclose(f);
+    *len = (size_t)n;
+    return buf;
+}
+
+/* Decode an unfiltered palette PNG (the writer's default) to an index
+ * plane and an ARGB palette. */
+static uint8_t *decode_page(const char *path, int *w, int *h, uint32_t pal[256]) {
+    size_t len;
+    unsigned char *png = slurp(path, &len);
+    unsigned char *idat = NULL;
+    size_t idat_len = 0, off = 8;
+    int depth = 0, nplte = 0;
+    *w = *h = 0;
+    memset(pal, 0, 256 * sizeof(uint32_t));
+    while (off + 12 <= len) {
+        uint32_t n = be32(png + off);
+        const unsigned char *type = png + off + 4, *data = png + off + 8;
+        if (!memcmp(type, "IHDR", 4)) {
+            *w = (int)be32(data);
+            *h = (int)be32(data + 4);
+            depth = data[8];
+            assert(data[9] == 3);
+        } else if (!memcmp(type, "PLTE", 4)) {
+            nplte = (int)n / 3;
+            for (int i = 0; i < nplte; i++)
+                pal[i] = 0xFF000000u | (uint32_t)data[3 * i] << 16 |
+                         (uint32_t)data[3 * i + 1] << 8 | data[3 * i + 2];
+        } else if (!memcmp(type, "tRNS", 4)) {
+            for (uint32_t i = 0; i < n; i++)
+                pal[i] = (pal[i] & 0x00FFFFFFu) | (uint32_t)data[i] << 24;
+        } else if (!memcmp(type, "IDAT", 4)) {
+            idat = realloc(idat, idat_len + n);
+            memcpy(idat + idat_len, data, n);
+            idat_len += n;
+        }
+        off += 12 + n;
+    }
+    assert(depth > 0 && *w > 0 && *h > 0); /* IHDR parsed */
+    size_t row = ((size_t)*w * depth + 7) / 8;
+    uLongf raw_len = (uLongf)((row + 1) * *h);
+    unsigned char *raw = malloc(raw_len);
+    assert(uncompress(raw, &raw_len, idat, (uLong)idat_len) == Z_OK);
+    uint8_t *out = malloc((size_t)*w * *h);
+    for (int y = 0; y < *h; y++) {
+        const unsigned char *r = raw + (size_t)y * (row + 1);
+        assert(r[0] == 0);
+        for (int x = 0; x < *w; x++) {
+            size_t bit = (size_t)x * depth;
+            unsigned v = r[1 + bit / 8];
+            if (depth < 8) v = (v >> (8 - depth - bit % 8)) & ((1u << depth) - 1);
+            out[(size_t)y * *w + x] = (uint8_t)v;
+        }
+    }
+    free(raw);
+    free(idat);
+    free(png);
+    return out;
+}
+
+int main(void) {
+    char dir[] = "/tmp/contact_sheet_XXXXXX";
+    assert(mkdtemp(dir));
+
+    /* a directory whose file paths would be truncated is refused */
+    static char longdir[5000];
+    memset(longdir, 'a', sizeof(longdir) - 1);
+    assert(contact_sheet_open(longdir, 0, "eng", 0, 0, NULL) == NULL);
+
+    /* Pages of 256x128 so 40 cues need several; each cue has its own
+     * 3-colour palette plus transparent entries. */
+    Cue cues[NCUES];
+    srand(7);
+    ContactSheet *cs = contact_sheet_open(dir, 2, "deu", 256, 128, NULL);
+    assert(cs);
+    for (int i = 0; i < NCUES; i++) {
+        Cue *c = &cues[i];
+        c->w = 20 + rand() % 120;
+        c->h = 10 + rand() % 30;
+        memset(c->pal, 0, sizeof(c->pal));
+        for (int k = 1; k <= 3; k++)
+            c->pal[k] = 0xFF000000u | (uint32_t)(i * 3 + k) * 0x010203u;
+        c->pal[4] = 0x00123456u; /* transparent but not zero */
+        c->idx = malloc((size_t)c->w * c->h);
+        for (int p = 0; p < c->w * c->h; p++)
+            c->idx[p] = (uint8_t)(rand() % 5);
+        char text[64];
+        snprintf(text, sizeof(text), "cue %d \"q\"\\\n\x01", i);
+        assert(contact_sheet_add(cs, i, 1000LL * i, 1000LL * i + 800, text,
+                                 c->idx, c->w, c->h, c->pal, 16, 10 + i, 400) == 0);
+    }
+    /* an empty render is still indexed */
+    assert(contact_sheet_add(cs, NCUES, 99000, 99500, "blank", NULL, 0, 0, NULL, 0, 0, 0) == 0);
+    assert(contact_sheet_close(cs) == 0);
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/sheet_t02.json", dir);
+    size_t jlen;
+    char *json = (char *)slurp(path, &jlen);
+    assert(strstr(json, "\"track\": 2"));
+    assert(strstr(json, "\"lang\": \"deu\""));
+    assert(strstr(json, "\"text\": \"cue 7 \\\"q\\\"\\\\\\n\\u0001\""));
+    assert(strstr(json, "\"cue\": 40, \"page\": -1"));
+
+    Entry e[NCUES];
+    int n = 0, max_page = 0;
+    for (char *p = strstr(json, "{\"cue\": "); p && n < NCUES; p = strstr(p + 1, "{\"cue\": ")) {
+        Entry *x = &e[n];
+        assert(sscanf(p, "{\"cue\": %d, \"page\": %d, \"x\": %d, \"y\": %d, \"w\": %d, \"h\": %d, "
+                         "\"pos_x\": %d, \"pos_y\": %d, \"start_ms\": %lld, \"end_ms\": %lld",
+                      &x->cue, &x->page, &x->x, &x->y, &x->w, &x->h,
+                      &x->pos_x, &x->pos_y, &x->start_ms, &x->end_ms) == 10);
+        assert(x->cue == n && x->page >= 0);
+        assert(x->w == cues[n].w && x->h == cues[n].h);
+        assert(x->pos_x == 10 + n && x->pos_y == 400);
+        assert(x->start_ms == 1000LL * n && x->end_ms == 1000LL * n + 800);
+        if (x->page > max_page) max_page = x->page;
+        n++;
+    }
+    assert(n == NCUES);
+    assert(max_page >= 2);
+    assert(strstr(json, "\"file\": \"sheet_t02_p000.png\""));
+
+    /* no two cues on the same page overlap */
+    for (int a = 0; a < NCUES; a++)
+        for (int b = a + 1; b < NCUES; b++) {
+            if (e[a].page != e[b].page) continue;
+            int sep = e[a].x + e[a].w <= e[b].x || e[b].x + e[b].w <= e[a].x ||
+                      e[a].y + e[a].h <= e[b].y || e[b].y + e[b].h <= e[a].y;
+            assert(sep);
+        }
+
+    /* every cue decodes back to its own colours */
+    for (int pg = 0; pg <= max_page; pg++) {
+        snprintf(path, sizeof(path), "%s/sheet_t02_p%03d.png", dir, pg);
+        int w = 0, h = 0;
+        uint32_t pal[256];
+        uint8_t *plane = decode_page(path, &w, &h, pal);
+        assert(w <= 256 && h <= 128);
+        for (int i = 0; i < NCUES; i++) {
+            if (e[i].page != pg) continue;
+            assert(e[i].x + e[i].w <= w && e[i].y + e[i].h <= h);
+            for (int y = 0; y < e[i].h; y++)
+                for (int x = 0; x < e[i].w; x++) {
+                    uint32_t want = cues[i].pal[cues[i].idx[y * cues[i].w + x]];
+                    uint32_t got = pal[plane[(size_t)(e[i].y + y) * w + e[i].x + x]];
+                    if ((want >> 24) == 0) assert((got >> 24) == 0);
+                    else assert(got == want);
+                }
+        }
+        free(plane);
+        remove(path);
+    }
+    snprintf(path, sizeof(path), "%s/sheet_t02.json", dir);
+    remove(path);
+    free(json);
+    for (int i = 0; i < NCUES; i++) free(cues[i].idx);
+
+    /* Palette break: 100 tiny cues with 3 new colours each fit one page
+     * by area, but only 85 fit in 255 palette slots. */
+    cs = contact_sheet_open(dir, 3, NULL, 1024, 1024, NULL);
+    assert(cs);
+    for (int i = 0; i < 100; i++) {
+        uint32_t pal[4] = { 0, 0xFF000000u | (uint32_t)(3 * i + 1),
+                            0xFF000000u | (uint32_t)(3 * i + 2),
+                            0xFF000000u | (uint32_t)(3 * i + 3) };
+        uint8_t idx[4] = { 0, 1, 2, 3 };
+        assert(contact_sheet_add(cs, i, 0, 1, "", idx, 2, 2, pal, 4, 0, 0) == 0);
+    }
+    assert(contact_sheet_close(cs) == 0);
+    snprintf(path, sizeof(path), "%s/sheet_t03.json", dir);
+    json = (char *)slurp(path, &jlen);
+    assert(strstr(json, "\"cue\": 84, \"page\": 0"));
+    assert(strstr(json, "\"cue\": 85, \"page\": 1"));
+    assert(strstr(json, "\"colors\": 256"));
+    free(json);
+    remove(path);
+    for (int pg = 0; pg < 2; pg++) {
+        snprintf(path, sizeof(path), "%s/sheet_t03_p%03d.png", dir, pg);
+        assert(remove(path) == 0);
+    }
+    rmdir(dir);
+
+    printf("test_contact_sheet: all checks passed\n");
+    return 0;
+}
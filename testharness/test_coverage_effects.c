@@ -0,0 +1,267 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <cairo.h>
+#include "../src/coverage_effects.h"
+
+/*
+ * Morphological effects: mode parsing, the shift helper, layer order of
+ * the single-pass composite, and a tolerance comparison against Cairo:
+ * the derived outline of a filled path must match Cairo's round-join
+ * stroke of the same path, and the full shadow/outline/fill composite
+ * must match Cairo's three-pass drawing, after a 4x box downsample.
+ *
+ * Build:
+ *   gcc -std=gnu11 -Wall -Isrc testharness/test_coverage_effects.c \
+ *       src/coverage_effects.c $(pkg-config --cflags --libs cairo) -lm \
+ *       -o test_coverage_effects
+ */
+
+#define SS 4
+#define W 160
+#define H 160
+
+static void test_parse(void) {
+    RenderEffectsMode m;
+    assert(render_effects_mode_parse("cairo", &m) == 0 && m == RENDER_EFFECTS_CAIRO);
+    assert(render_effects_mode_parse("morph", &m) == 0 && m == RENDER_EFFECTS_MORPH);
+    assert(render_effects_mode_parse("auto", &m) == 0 && m == RENDER_EFFECTS_AUTO);
+    assert(render_effects_mode_parse("Morph", &m) == -1);
+    assert(render_effects_mode_parse("", &m) == -1);
+    assert(render_effects_mode_parse(NULL, &m) == -1);
+}
+
+static void test_shift(void) {
+    uint8_t src[3 * 4] = { 1, 2, 3, 4,  5, 6, 7, 8,  9, 10, 11, 12 };
+    uint8_t dst[3 * 4];
+    coverage_shift(src, 4, 4, 3, 1, 1, dst, 4);
+    const uint8_t want[3 * 4] = { 0, 0, 0, 0,  0, 1, 2, 3,  0, 5, 6, 7 };
+    assert(memcmp(dst, want, sizeof(want)) == 0);
+    coverage_shift(src, 4, 4, 3, -2, -1, dst, 4);
+    const uint8_t want2[3 * 4] = { 7, 8, 0, 0,  11, 12, 0, 0,  0, 0, 0, 0 };
+    assert(memcmp(dst, want2, sizeof(want2)) == 0);
+    coverage_shift(src, 4, 4, 3, 9, 0, dst, 4);
+    for (int i = 0; i < 12; i++) assert(dst[i] == 0);
+}
+
+static void test_compose_layers(void) {
+    /* 16x16 mask with a solid 6x6 square at (4,4). */
+    uint8_t fill[16 * 16] = {0};
+    for (int y = 4; y < 10; y++)
+        memset(fill + y * 16 + 4, 255, 6);
+    uint8_t out[16 * 16];
+    assert(coverage_outline(fill, 16, 16, 16, 2.0, out, 16) == 0);
+    assert(out[0] == 0);            /* far outside */
+    assert(out[7 * 16 + 7] == 0);   /* deep inside */
+    assert(out[7 * 16 + 3] == 255); /* one pixel outside the edge */
+    assert(out[7 * 16 + 4] == 255); /* first pixel inside the edge */
+
+    uint32_t canvas[16 * 16] = {0};
+    assert(coverage_effects_compose(fill, 16, 16, 16, 2.0, 3, 3,
+                                    0xFFFFFFFFu, 0xFF000000u, 0xFF0000FFu,
+                                    (uint8_t *)canvas, 16 * 4) == 0);
+    assert(canvas[7 * 16 + 7] == 0xFFFFFFFFu);   /* fill on top */
+    assert(canvas[7 * 16 + 3] == 0xFF000000u);   /* outline band */
+    assert(canvas[12 * 16 + 12] == 0xFF0000FFu); /* shadow beyond the outline */
+    assert(canvas[0] == 0);
+
+    /* Zero-alpha colours skip their layer. */
+    memset(canvas, 0, sizeof(canvas));
+    assert(coverage_effects_compose(fill, 16, 16, 16, 2.0, 3, 3,
+                                    0xFFFFFFFFu, 0x00000000u, 0x00000000u,
+                                    (uint8_t *)canvas, 16 * 4) == 0);
+    assert(canvas[7 * 16 + 3] == 0 && canvas[12 * 16 + 12] == 0);
+    assert(canvas[7 * 16 + 7] == 0xFFFFFFFFu);
+
+    assert(coverage_effects_compose(NULL, 16, 16, 16, 2.0, 0, 0, 0, 0, 0,
+                                    (uint8_t *)canvas, 64) == -1);
+}
+
+/* Disjoint disc, rectangle and triangle, so a Cairo stroke of the path
+ * never runs through the interior of another shape. */
+static void shapes_path(cairo_t *cr) {
+    cairo_new_path(cr);
+    cairo_arc(cr, 50.3, 49.6, 30.0, 0.0, 6.283185307179586);
+    cairo_close_path(cr);
+    cairo_rectangle(cr, 92.5, 20.25, 50.0, 40.0);
+    cairo_move_to(cr, 20.0, 148.0);
+    cairo_line_to(cr, 140.0, 140.5);
+    cairo_line_to(cr, 60.0, 100.0);
+    cairo_close_path(cr);
+}
+
+static cairo_surface_t *draw_a8(double stroke_w) {
+    cairo_surface_t *s = cairo_image_surface_create(CAIRO_FORMAT_A8, W, H);
+    cairo_t *cr = cairo_create(s);
+    cairo_set_antialias(cr, CAIRO_ANTIALIAS_BEST);
+    cairo_set_source_rgba(cr, 0, 0, 0, 1);
+    shapes_path(cr);
+    if (stroke_w > 0.0) {
+        cairo_set_line_width(cr, stroke_w);
+        cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+        cairo_stroke(cr);
+    } else {
+        cairo_fill(cr);
+    }
+    cairo_destroy(cr);
+    cairo_surface_flush(s);
+    return s;
+}
+
+/* Mean and max absolute difference after a SSxSS box downsample, over
+ * output pixels where either image has coverage. */
+static void downsampled_diff(const uint8_t *a, int as, const uint8_t *b, int bs,
+                             int bpp, double *mean, int *max) {
+    double sum = 0.0;
+    int n = 0;
+    *max = 0;
+    for (int y = 0; y < H / SS; y++) {
+        for (int x = 0; x < W / SS; x++) {
+            for (int c = 0; c < bpp; c++) {
+                int sa = 0, sb = 0;
+                for (int j = 0; j < SS; j++)
+                    for (int i = 0; i < SS; i++) {
+                        sa += a[(y * SS + j) * as + (x * SS + i) * bpp + c];
+                        sb += b[(y * SS + j) * bs + (x * SS + i) * bpp + c];
+                    }
+                sa /= SS * SS;
+                sb /= SS * SS;
+                if (!sa && !sb) continue;
+                int d = abs(sa - sb);
+                sum += d;
+                n++;
+                if (d > *max) *max = d;
+            }
+        }
+    }
+    *mean = n ? sum / n : 0.0;
+}
+
+static void test_outline_vs_cairo(double radius) {
+    cairo_surface_t *fill = draw_a8(0.0);
+    cairo_surface_t *stroke = draw_a8(2.0 * radius);
+    int fs = cairo_image_surface_get_stride(fill);
+    int ss = cairo_image_surface_get_stride(stroke);
+    uint8_t *out = malloc((size_t)W * H);
+    assert(out);
+    assert(coverage_outline(cairo_image_surface_get_data(fill), fs, W, H, radius, out, W) == 0);
+
+    double mean;
+    int max;
+    downsampled_diff(out, W, cairo_image_surface_get_data(stroke), ss, 1, &mean, &max);
+    printf("  outline r=%.1f: mean %.2f max %d (of 255)\n", radius, mean, max);
+    assert(mean <= 6.0);
+    assert(max <= 64);
+
+    free(out);
+    cairo_surface_destroy(fill);
+    cairo_surface_destroy(stroke);
+}
+
+static void test_compose_vs_cairo(void) {
+    const double radius = 5.0, shadow = 6.0;
+    cairo_surface_t *ref = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, W, H);
+    cairo_t *cr = cairo_create(ref);
+    cairo_set_antialias(cr, CAIRO_ANTIALIAS_BEST);
+    cairo_save(cr);
+    cairo_translate(cr, shadow, shadow);
+    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.5);
+    shapes_path(cr);
+    cairo_fill(cr);
+    cairo_restore(cr);
+    cairo_set_source_rgba(cr, 0.1, 0.1, 0.1, 1.0);
+    cairo_set_line_width(cr, 2.0 * radius);
+    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+    shapes_path(cr);
+    cairo_stroke(cr);
+    cairo_set_source_rgba(cr, 1.0, 1.0, 0.0, 1.0);
+    shapes_path(cr);
+    cairo_fill(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(ref);
+
+    cairo_surface_t *fill = draw_a8(0.0);
+    cairo_surface_t *morph = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, W, H);
+    cairo_surface_flush(morph);
+    assert(coverage_effects_compose(cairo_image_surface_get_data(fill),
+                                    cairo_image_surface_get_stride(fill), W, H,
+                                    radius, (int)shadow, (int)shadow,
+                                    0xFFFFFF00u, 0xFF1A1A1Au, 0x80000000u,
+                                    cairo_image_surface_get_data(morph),
+                                    cairo_image_surface_get_stride(morph)) == 0);
+
+    double mean;
+    int max;
+    downsampled_diff(cairo_image_surface_get_data(morph), cairo_image_surface_get_stride(morph),
+                     cairo_image_surface_get_data(ref), cairo_image_surface_get_stride(ref),
+                     4, &mean, &max);
+    printf("  composite: mean %.2f max %d (of 255, per channel)\n", mean, max);
+    assert(mean <= 6.0);
+    assert(max <= 64);
+
+    cairo_surface_destroy(fill);
+    cairo_surface_destroy(morph);
+    cairo_surface_destroy(ref);
+}
+
+int main(void) {
+    test_parse();
+    test_shift();
+    test_compose_layers();
+    test_outline_vs_cairo(1.0);
+    test_outline_vs_cairo(2.5);
+    test_outline_vs_cairo(6.0);
+    test_compose_vs_cairo();
+    printf("test_coverage_effects: all checks passed\n");
+    return 0;
+}
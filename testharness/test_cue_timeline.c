@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_cue_timeline.c
+ * Verifies the struct-of-arrays cue timeline matches the inline
+ * (start_ms + delay) * 90 arithmetic used by the demux loop, and that
+ * snapped cues keep their exact 90 kHz frame boundary.
+ *
+ * Build: gcc -std=gnu11 -Wall -Isrc testharness/test_cue_timeline.c \
+ *        src/cue_timeline.c src/frame_timing.c -lm
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include "cue_timeline.h"
+
+int main(void) {
+    SRTEntry e[3] = {
+        { .start_ms = 0,    .end_ms = 900 },
+        { .start_ms = 1000, .end_ms = 2500 },
+        { .start_ms = 4000, .end_ms = 4100 },
+    };
+    const int64_t delay = -250, origin = 1800000;
+
+    CueTimeline tl = {0};
+    assert(cue_timeline_next_due(&tl, 0) == CUE_TIMELINE_NONE);
+    assert(cue_timeline_build(&tl, NULL, e, 3, delay, origin) == 0);
+    assert(tl.count == 3);
+    for (int i = 0; i < 3; i++) {
+        assert(tl.due90[i] == (e[i].start_ms + delay) * 90);
+        assert(tl.start90[i] == origin + (e[i].start_ms + delay) * 90);
+        assert(tl.end90[i] == origin + (e[i].end_ms + delay) * 90);
+        assert(cue_timeline_next_due(&tl, i) == tl.due90[i]);
+    }
+    assert(cue_timeline_next_due(&tl, 3) == CUE_TIMELINE_NONE);
+
+    /* rebuilding releases the previous block; empty input leaves it empty */
+    assert(cue_timeline_build(&tl, NULL, e, 0, 0, 0) == 0);
+    assert(tl.count == 0 && tl.due90 == NULL);
+
+    /* 23.976 grid: stamps are boundaries, not ms rounded from them */
+    FrameTiming ft = { .grid = { 24000, 1001 }, .mode = FRAME_SNAP_NEAREST };
+    SRTEntry n[2] = {
+        { .start_ms = 1000, .end_ms = 2000 },
+        { .start_ms = 4963, .end_ms = 6000 },
+    };
+    assert(cue_timeline_build(&tl, &ft, n, 2, 0, origin) == 2);
+    for (int i = 0; i < 2; i++) {
+        assert(frame_timing_snap90(&ft, tl.due90[i]) == tl.due90[i]);
+        assert(tl.start90[i] == origin + tl.due90[i]);
+        assert(frame_timing_snap90(&ft, tl.end90[i] - origin) == tl.end90[i] - origin);
+    }
+    assert(tl.due90[0] == 90090); /* frame 24 at 90090 ticks = 1001 ms */
+    assert(tl.due90[1] == 446697); /* frame 119: ceil(446696.25), not 4964 ms */
+    cue_timeline_free(&tl);
+    cue_timeline_free(&tl);
+
+    printf("test_cue_timeline: all checks passed\n");
+    return 0;
+}
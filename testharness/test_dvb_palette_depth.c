@@ -0,0 +1,148 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_dvb_palette_depth.c
+ * Checks the adaptive DVB palette depth: dvb_sub_fit_palette() compacts
+ * the used indices in ascending order, make_subtitle_depth() shrinks
+ * nb_colors (and so the encoder's region depth) to what the cue uses
+ * while every pixel keeps its ARGB colour, and adaptive=0 leaves the
+ * rendered palette untouched.
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_dvb_palette_depth.c src/dvb_sub.c \
+ *        src/clut_cache.c src/alloc_utils.c src/pool_alloc.c -lm $(pkg-config --cflags --libs libavcodec libavutil)
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "dvb_sub.h"
+
+int debug_level = 0;
+
+#define W 64
+#define H 24
+
+static uint32_t pal16[16];
+static uint8_t plane[W * H];
+
+static Bitmap make_bitmap(int ncolors_used) {
+    for (int i = 0; i < 16; i++)
+        pal16[i] = i == 0 ? 0 : 0xFF000000u | (uint32_t)(i * 0x0F0F0F);
+    /* background 0 plus indices spread over the palette */
+    static const uint8_t pick[16] = { 0, 15, 8, 3, 12, 5, 9, 1, 14, 2, 11, 4, 13, 6, 10, 7 };
+    for (int p = 0; p < W * H; p++)
+        plane[p] = pick[(p / 7) % ncolors_used];
+    Bitmap bm = {0};
+    bm.idxbuf = plane;
+    bm.palette = pal16;
+    bm.w = W;
+    bm.h = H;
+    bm.nb_colors = 16;
+    bm.idxbuf_len = sizeof(plane);
+    bm.palette_bytes = sizeof(pal16);
+    return bm;
+}
+
+static void check_colours(const AVSubtitle *sub, const Bitmap *bm) {
+    const AVSubtitleRect *r = sub->rects[0];
+    const uint32_t *pal = (const uint32_t *)r->data[1];
+    for (int p = 0; p < W * H; p++) {
+        assert(r->data[0][p] < r->nb_colors);
+        assert(pal[r->data[0][p]] == bm->palette[bm->idxbuf[p]]);
+    }
+}
+
+int main(void) {
+    assert(dvb_sub_depth_bits(2) == 2 && dvb_sub_depth_bits(4) == 2);
+    assert(dvb_sub_depth_bits(5) == 4 && dvb_sub_depth_bits(16) == 4);
+    assert(dvb_sub_depth_bits(17) == 8 && dvb_sub_depth_bits(256) == 8);
+
+    /* fit: indices {0, 3, 8, 15} -> {0, 1, 2, 3} */
+    Bitmap bm = make_bitmap(4);
+    uint8_t remap[256];
+    uint32_t fitted[256];
+    assert(dvb_sub_fit_palette(bm.idxbuf, W * H, bm.palette, 16, remap, fitted) == 4);
+    assert(remap[0] == 0 && remap[3] == 1 && remap[8] == 2 && remap[15] == 3);
+    assert(fitted[0] == 0 && fitted[1] == pal16[3] && fitted[3] == pal16[15]);
+
+    /* a plain cue becomes a 2-bit region with a 4-entry CLUT */
+    AVSubtitle *sub = make_subtitle_depth(bm, 0, 1000, 1);
+    assert(sub && sub->num_rects == 1);
+    assert(sub->rects[0]->nb_colors == 4);
+    assert(sub->rects[0]->linesize[1] == 16);
+    check_colours(sub, &bm);
+    free_subtitle(&sub);
+
+    /* 9 colours: still 4-bit, but a 9-entry CLUT */
+    bm = make_bitmap(9);
+    sub = make_subtitle_depth(bm, 0, 1000, 1);
+    assert(sub->rects[0]->nb_colors == 9 && dvb_sub_depth_bits(9) == 4);
+    check_colours(sub, &bm);
+    free_subtitle(&sub);
+
+    /* adaptive off: original indices and the full 16-entry palette */
+    bm = make_bitmap(4);
+    sub = make_subtitle_depth(bm, 0, 1000, 0);
+    assert(sub->rects[0]->nb_colors == 16);
+    assert(memcmp(sub->rects[0]->data[0], plane, sizeof(plane)) == 0);
+    free_subtitle(&sub);
+
+    /* process-wide switch drives make_subtitle() */
+    dvb_sub_set_adaptive_depth(0);
+    sub = make_subtitle(bm, 0, 1000);
+    assert(sub->rects[0]->nb_colors == 16);
+    free_subtitle(&sub);
+    dvb_sub_set_adaptive_depth(1);
+    sub = make_subtitle(bm, 0, 1000);
+    assert(sub->rects[0]->nb_colors == 4);
+    free_subtitle(&sub);
+
+    printf("test_dvb_palette_depth: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_dvb_restamp.c
+ * Checks dvb_sub_restamp_versions() against a hand-built DVB subtitle
+ * payload: page, region and object versions are rewritten, CLUT and
+ * end-of-display segments are left alone, and truncated input stops the
+ * walk without touching bytes past the end.
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_dvb_restamp.c src/dvb_sub.c \
+ *        src/clut_cache.c src/alloc_utils.c src/pool_alloc.c -lm $(pkg-config --cflags --libs libavcodec libavutil)
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "dvb_sub.h"
+
+int debug_level = 0;
+
+int main(void) {
+    uint8_t buf[] = {
+        0x20, 0x00,                               /* PES data identifier */
+        0x0f, 0x10, 0x00, 0x01, 0x00, 0x02,       /* page composition */
+        30, (3 << 4) | (2 << 2) | 3,
+        0x0f, 0x11, 0x00, 0x01, 0x00, 0x03,       /* region composition */
+        0x00, (3 << 4) | 0x07, 0xaa,
+        0x0f, 0x12, 0x00, 0x01, 0x00, 0x02,       /* CLUT definition */
+        0x00, 0x0f,
+        0x0f, 0x13, 0x00, 0x01, 0x00, 0x03,       /* object data */
+        0x00, 0x00, (3 << 4) | 0x01,
+        0x0f, 0x80, 0x00, 0x01, 0x00, 0x00,       /* end of display set */
+    };
+    uint8_t orig[sizeof(buf)];
+    memcpy(orig, buf, sizeof(buf));
+
+    assert(dvb_sub_restamp_versions(buf, (int)sizeof(buf), 9) == 3);
+    assert(buf[9] == ((9 << 4) | (2 << 2) | 3));
+    assert(buf[17] == ((9 << 4) | 0x07));
+    assert(buf[26] == 0x0f);                     /* CLUT untouched */
+    assert(buf[35] == ((9 << 4) | 0x01));
+    for (size_t i = 0; i < sizeof(buf); i++)
+        if (i != 9 && i != 17 && i != 35) assert(buf[i] == orig[i]);
+
+    /* Truncated second segment: only the page segment is stamped. */
+    memcpy(buf, orig, sizeof(buf));
+    assert(dvb_sub_restamp_versions(buf, 12, 5) == 1);
+    assert(buf[9] >> 4 == 5);
+    assert(buf[17] == orig[17]);
+
+    assert(dvb_sub_restamp_versions(NULL, 10, 1) == 0);
+    printf("test_dvb_restamp: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+/*
+ * test_engine.c
+ * Checks that two S2DEngine instances run side by side in one process:
+ * each engine, driven from its own thread at the same time as the other,
+ * parses an SRT file against its own display size, renders every cue
+ * synchronously and through its worker pool (when it has one) inside its
+ * own canvas, and counts exactly its own cues in its bench snapshot.
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_engine.c -L.libs -lsrt2dvbsub \
+ *        $(pkg-config --cflags --libs pangocairo fontconfig libavutil) -lpthread
+ */
+
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "srt2dvbsub_engine.h"
+
+static const char *const cues[] = {
+    "Engine test",
+    "<i>Two engines</i>, one process",
+    "First line\nsecond line",
+    "{\\an8}Top of the picture",
+};
+#define NCUES ((int)(sizeof(cues) / sizeof(cues[0])))
+
+typedef struct {
+    int video_w, video_h;
+    int render_threads;
+    const char *srt_path;
+    int parsed;          /* cues parsed by this engine */
+    int rendered;        /* cues this thread rendered */
+    BenchStats bench;    /* the engine's snapshot after its run */
+} EngineRun;
+
+static void check_bitmap(const EngineRun *r, const Bitmap *bm) {
+    assert(bm->w > 0 && bm->h > 0 && bm->idxbuf && bm->palette);
+    assert(bm->x >= 0 && bm->y >= 0);
+    assert(bm->x + bm->w <= r->video_w);
+    assert(bm->y + bm->h <= r->video_h);
+}
+
+/* Poll the engine until (track, cue) is ready; fail after 30 s. */
+static Bitmap wait_cue(S2DEngine *eng, int track, int cue) {
+    for (int i = 0; i < 30000; i++) {
+        Bitmap bm;
+        int rc = s2d_engine_try_get(eng, track, cue, &bm);
+        if (rc == 1) return bm;
+        assert(rc == 0);
+        usleep(1000);
+    }
+    fprintf(stderr, "FAIL: cue (%d,%d) never completed\n", track, cue);
+    exit(1);
+}
+
+static void *engine_thread(void *arg) {
+    EngineRun *r = arg;
+    S2DEngineOptions opts;
+    s2d_engine_options_init(&opts);
+    opts.video_w = r->video_w;
+    opts.video_h = r->video_h;
+    opts.render_threads = r->render_threads;
+    opts.font = "DejaVu Sans";
+    opts.bench_enabled = 1;
+    S2DEngine *eng = s2d_engine_create(&opts);
+    assert(eng);
+
+    SRTEntry *entries = NULL;
+    r->parsed = s2d_engine_parse_srt(eng, r->srt_path, &entries, NULL);
+    assert(r->parsed == 2);
+    for (int i = 0; i < r->parsed; i++) {
+        Bitmap bm = s2d_engine_render_entry(eng, &entries[i]);
+        check_bitmap(r, &bm);
+        /* the parser moved {\an8} into the entry; it must still apply */
+        if (i == 1) assert(bm.y < r->video_h / 2);
+        else assert(bm.y > r->video_h / 2);
+        s2d_engine_free_bitmap(&bm);
+        r->rendered++;
+    }
+    s2d_engine_free_entries(entries, r->parsed);
+
+    int sync_w[NCUES], sync_h[NCUES];
+    for (int i = 0; i < NCUES; i++) {
+        Bitmap bm = s2d_engine_render_cue(eng, cues[i]);
+        check_bitmap(r, &bm);
+        sync_w[i] = bm.w;
+        sync_h[i] = bm.h;
+        s2d_engine_free_bitmap(&bm);
+        r->rendered++;
+    }
+
+    if (r->render_threads > 0) {
+        for (int i = 0; i < NCUES; i++)
+            assert(s2d_engine_submit_cue(eng, 0, i, cues[i]) == 0);
+        for (int i = 0; i < NCUES; i++) {
+            Bitmap bm = wait_cue(eng, 0, i);
+            check_bitmap(r, &bm);
+            assert(bm.w == sync_w[i] && bm.h == sync_h[i]);
+            s2d_engine_free_bitmap(&bm);
+            r->rendered++;
+        }
+    } else {
+        assert(s2d_engine_submit_cue(eng, 0, 0, cues[0]) == -1);
+    }
+
+    s2d_engine_bench(eng, &r->bench);
+    s2d_engine_destroy(eng);
+    return NULL;
+}
+
+int main(void) {
+    char path[] = "/tmp/test_engine_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    FILE *f = fdopen(fd, "w");
+    assert(f);
+    fputs("1\n00:00:01,000 --> 00:00:02,000\nBottom cue\n\n"
+          "2\n00:00:03,000 --> 00:00:04,000\n{\\an8}Top cue\n\n", f);
+    fclose(f);
+
+    /* SD without workers against HD with a pool, run at the same time. */
+    EngineRun runs[2] = {
+        { .video_w = 720, .video_h = 576, .render_threads = 0, .srt_path = path },
+        { .video_w = 1920, .video_h = 1080, .render_threads = 2, .srt_path = path },
+    };
+    pthread_t th[2];
+    for (int i = 0; i < 2; i++)
+        assert(pthread_create(&th[i], NULL, engine_thread, &runs[i]) == 0);
+    for (int i = 0; i < 2; i++)
+        assert(pthread_join(th[i], NULL) == 0);
+
+    for (int i = 0; i < 2; i++) {
+        assert(runs[i].bench.enabled);
+        assert(runs[i].bench.cues_rendered == runs[i].rendered);
+    }
+    /* the SD engine has no pool, so the engines rendered different counts */
+    assert(runs[0].rendered == 2 + NCUES);
+    assert(runs[1].rendered == 2 + 2 * NCUES);
+
+    unlink(path);
+    printf("test_engine: all checks passed\n");
+    return 0;
+}
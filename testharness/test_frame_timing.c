@@ -0,0 +1,181 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * Frame-grid timing checks. Build:
+ *   gcc -std=gnu11 -Isrc testharness/test_frame_timing.c src/frame_timing.c -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "../src/frame_timing.h"
+
+int main(void) {
+    FrameRate fr;
+
+    /* rate parsing and NTSC mapping */
+    assert(frame_rate_parse("25", &fr) == 0 && fr.num == 25 && fr.den == 1);
+    assert(frame_rate_parse("23.976", &fr) == 0 && fr.num == 24000 && fr.den == 1001);
+    assert(frame_rate_parse("30000/1001", &fr) == 0 && fr.num == 30000 && fr.den == 1001);
+    assert(frame_rate_parse("0", &fr) != 0);
+    assert(frame_rate_parse("abc", &fr) != 0);
+
+    FrameRate src, dst;
+    assert(frame_rate_conversion_parse("23.976:25", &src, &dst) == 0);
+    assert(src.num == 24000 && src.den == 1001 && dst.num == 25 && dst.den == 1);
+    assert(frame_rate_conversion_parse("25", &src, &dst) != 0);
+
+    FrameSnapMode m;
+    assert(frame_snap_mode_parse("nearest", &m) == 0 && m == FRAME_SNAP_NEAREST);
+    assert(frame_snap_mode_parse("sideways", &m) != 0);
+
+    /* 25 fps grid: boundaries every 3600 ticks (40 ms) */
+    FrameTiming ft = { .grid = { 25, 1 }, .origin90 = 0, .mode = FRAME_SNAP_NEAREST };
+    assert(frame_timing_snap90(&ft, 1000 * 90) == 1000 * 90);
+    assert(frame_timing_snap90(&ft, 1015 * 90) == 1000 * 90);
+    assert(frame_timing_snap90(&ft, 1025 * 90) == 1040 * 90);
+    ft.mode = FRAME_SNAP_CEIL;
+    assert(frame_timing_snap90(&ft, 1001 * 90) == 1040 * 90);
+    ft.mode = FRAME_SNAP_FLOOR;
+    assert(frame_timing_snap90(&ft, 1039 * 90) == 1000 * 90);
+
+    /* origin offset shifts the grid */
+    ft.origin90 = 900; /* 10 ms */
+    assert(frame_timing_snap90(&ft, 1039 * 90) == 1010 * 90);
+    ft.origin90 = 0;
+
+    /* 23.976 grid: boundaries never precede the exact frame start */
+    FrameTiming ntsc = { .grid = { 24000, 1001 }, .mode = FRAME_SNAP_NEAREST };
+    int64_t b = frame_timing_snap90(&ntsc, 3754);
+    assert(b == 3754); /* frame 1 starts at 3753.75 ticks */
+    b = frame_timing_snap90(&ntsc, 1000LL * 3753 + 10);
+    assert(b == 3753750);
+
+    /* apply(): snapped cues keep the delay and at least one frame */
+    SRTEntry e[3] = {
+        { .start_ms = 1015, .end_ms = 2010 },
+        { .start_ms = 3000, .end_ms = 3005 },
+        { .start_ms = 3940, .end_ms = 4900 },
+    };
+    ft.mode = FRAME_SNAP_NEAREST;
+    int64_t s90[3], e90[3];
+    int changed = frame_timing_apply(&ft, e, 3, 100, s90, e90);
+    assert(changed == 2);
+    assert(e[0].start_ms + 100 == 1120 && e[0].end_ms + 100 == 2120);
+    assert(e[1].end_ms - e[1].start_ms == 40);
+    assert(e[2].start_ms == 3940 && e[2].end_ms == 4900);
+    for (int i = 0; i < 3; i++) {
+        assert(s90[i] == (e[i].start_ms + 100) * 90);
+        assert(e90[i] == (e[i].end_ms + 100) * 90);
+    }
+
+    /* 23.976 -> 25 speed-up shortens the timeline by 24000/25025 */
+    SRTEntry c = { .start_ms = 25025, .end_ms = 50050 };
+    FrameTiming conv = { .conv_src = { 24000, 1001 }, .conv_dst = { 25, 1 } };
+    frame_timing_apply(&conv, &c, 1, 0, NULL, NULL);
+    assert(c.start_ms == 24000 && c.end_ms == 48000);
+
+    /*
+     * 1001-denominator grids with an origin that is not a multiple of 90:
+     * the emitted ticks must sit exactly on a boundary, i.e. share the
+     * origin's phase modulo one frame, for every cue and delay.
+     */
+    static const FrameRate ntsc_grids[] = { { 24000, 1001 }, { 30000, 1001 }, { 60000, 1001 } };
+    static const int64_t origins[] = { 0, 1, 37, 3003, 45091 };
+    static const int64_t delays[] = { 0, 7, -250 };
+    for (size_t g = 0; g < sizeof(ntsc_grids) / sizeof(ntsc_grids[0]); g++) {
+        for (size_t o = 0; o < sizeof(origins) / sizeof(origins[0]); o++) {
+            for (size_t d = 0; d < sizeof(delays) / sizeof(delays[0]); d++) {
+                FrameTiming nt = { .grid = ntsc_grids[g], .origin90 = origins[o],
+                                   .mode = FRAME_SNAP_NEAREST };
+                /* frame length is 90000*den/num ticks; ×num keeps it integral */
+                const int64_t frame90 = 90000LL * nt.grid.den;
+                const int64_t num = nt.grid.num;
+                SRTEntry q[64];
+                for (int i = 0; i < 64; i++) {
+                    q[i].start_ms = 1000 + i * 1237;
+                    q[i].end_ms = q[i].start_ms + 1500 + i;
+                }
+                int64_t due90[64], end90[64];
+                frame_timing_apply(&nt, q, 64, delays[d], due90, end90);
+                for (int i = 0; i < 64; i++) {
+                    assert(due90[i] >= nt.origin90);
+                    assert(frame_timing_snap90(&nt, due90[i]) == due90[i]);
+                    assert(frame_timing_snap90(&nt, end90[i]) == end90[i]);
+                    /*
+                     * Boundary k is origin + ceil(k*frame90/num), the
+                     * rational form of due90 % frame == origin90 % frame.
+                     */
+                    int64_t k = ((due90[i] - nt.origin90) * num) / frame90;
+                    int64_t exact = nt.origin90 + (k * frame90 + num - 1) / num;
+                    assert(due90[i] == exact);
+                    /* the millisecond mirror may not move the stamp */
+                    assert((q[i].start_ms + delays[d]) * 90 - due90[i] < 90);
+                    assert((q[i].start_ms + delays[d]) * 90 >= due90[i]);
+                }
+            }
+        }
+    }
+
+    /* 25 fps with an odd origin: due90 % frame90 == origin90 % frame90 */
+    FrameTiming pal = { .grid = { 25, 1 }, .origin90 = 1237, .mode = FRAME_SNAP_NEAREST };
+    SRTEntry p[8];
+    int64_t pdue[8];
+    for (int i = 0; i < 8; i++) {
+        p[i].start_ms = 333 + i * 777;
+        p[i].end_ms = p[i].start_ms + 900;
+    }
+    frame_timing_apply(&pal, p, 8, 13, pdue, NULL);
+    for (int i = 0; i < 8; i++) assert(pdue[i] % 3600 == pal.origin90 % 3600);
+
+    printf("test_frame_timing: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "../src/glyph_atlas.h"
+
+/*
+ * Glyph atlas: tile cache keyed on (font key, glyph, phase) with stable
+ * tile pointers across table growth and a budget enforced by trim, the
+ * box downsample used to turn supersampled coverage into tile planes,
+ * and premultiplied OVER compositing with canvas clipping.
+ *
+ * Build:
+ *   gcc -std=gnu11 -Wall -Isrc testharness/test_glyph_atlas.c \
+ *       src/glyph_atlas.c -o test_glyph_atlas
+ */
+
+static void test_cache(void) {
+    GlyphAtlas *a = glyph_atlas_create(64);
+    assert(a);
+    uint64_t k1 = glyph_atlas_key_str(0, "DejaVu Sans 32");
+    uint64_t k2 = glyph_atlas_key_str(0, "DejaVu Sans Italic 32");
+    assert(k1 != k2);
+    assert(glyph_atlas_key_mix(k1, 4) != glyph_atlas_key_mix(k1, 3));
+
+    assert(glyph_atlas_find(a, k1, 42, 0) == NULL);
+    GlyphTile *t = glyph_atlas_add(a, k1, 42, 5, 3, 2, -1, -7);
+    assert(t && t->w == 3 && t->h == 2 && t->ox == -1 && t->oy == -7);
+    for (int p = 0; p < GLYPH_PLANE_COUNT; p++)
+        for (int i = 0; i < 6; i++)
+            assert(t->plane[p][i] == 0);
+    t->plane[GLYPH_PLANE_FILL][0] = 200;
+    assert(glyph_atlas_add(a, k1, 42, 5, 3, 2, 0, 0) == NULL); /* duplicate */
+
+    /* Distinct phase and font key are distinct tiles. */
+    assert(glyph_atlas_find(a, k1, 42, 4) == NULL);
+    assert(glyph_atlas_find(a, k2, 42, 5) == NULL);
+
+    /* Grow well past the initial table; the first tile must survive. */
+    for (uint32_t g = 0; g < 60; g++)
+        assert(glyph_atlas_add(a, k2, g, (int)(g % 16), 1, 1, 0, 0));
+    const GlyphTile *f = glyph_atlas_find(a, k1, 42, 5);
+    assert(f == t && f->plane[GLYPH_PLANE_FILL][0] == 200);
+    assert(glyph_atlas_count(a) == 61);
+
+    uint64_t hits = 0, misses = 0;
+    glyph_atlas_stats(a, &hits, &misses);
+    assert(hits == 1 && misses == 3);
+
+    /* Within budget: trim keeps everything; over budget: drops all. */
+    glyph_atlas_trim(a);
+    assert(glyph_atlas_count(a) == 61);
+    for (uint32_t g = 100; g < 110; g++)
+        assert(glyph_atlas_add(a, k2, g, 0, 1, 1, 0, 0));
+    glyph_atlas_trim(a);
+    assert(glyph_atlas_count(a) == 0);
+    assert(glyph_atlas_find(a, k1, 42, 5) == NULL);
+
+    glyph_atlas_destroy(a);
+    glyph_atlas_destroy(NULL);
+}
+
+static void test_downsample(void) {
+    /* 4x supersampled 2x1 image: left block fully covered, right block
+     * a quarter covered. */
+    uint8_t src[4 * 8];
+    memset(src, 0, sizeof(src));
+    for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++)
+            src[y * 8 + x] = 255;
+    for (int y = 0; y < 2; y++)
+        for (int x = 4; x < 6; x++)
+            src[y * 8 + x] = 255;
+    uint8_t dst[2];
+    glyph_coverage_downsample(src, 8, 4, dst, 2, 1);
+    assert(dst[0] == 255);
+    assert(dst[1] == 64);
+}
+
+static void test_composite(void) {
+    uint32_t canvas[4 * 4];
+    memset(canvas, 0, sizeof(canvas));
+    GlyphAtlas *a = glyph_atlas_create(8);
+    GlyphTile *t = glyph_atlas_add(a, 1, 1, 0, 2, 2, -1, -1);
+    memset(t->plane[GLYPH_PLANE_OUTLINE], 255, 4);
+    memset(t->plane[GLYPH_PLANE_FILL], 128, 4);
+
+    /* Opaque black outline then half-coverage white fill at (1,1). */
+    glyph_tile_composite((uint8_t *)canvas, 16, 4, 4, t, GLYPH_PLANE_OUTLINE, 1, 1, 0xFF000000u);
+    glyph_tile_composite((uint8_t *)canvas, 16, 4, 4, t, GLYPH_PLANE_FILL, 1, 1, 0xFFFFFFFFu);
+    assert(canvas[0] == 0xFF808080u);
+    assert(canvas[1 * 4 + 1] == 0xFF808080u);
+    assert(canvas[2] == 0 && canvas[2 * 4 + 2] == 0);
+
+    /* Premultiplied output for a translucent colour on an empty pixel. */
+    glyph_tile_composite((uint8_t *)canvas, 16, 4, 4, t, GLYPH_PLANE_OUTLINE, 3, 3, 0x80FF0000u);
+    assert(canvas[2 * 4 + 2] == 0x80800000u);
+
+    /* Fully transparent colour or zero coverage leaves the canvas alone. */
+    glyph_tile_composite((uint8_t *)canvas, 16, 4, 4, t, GLYPH_PLANE_FILL, 3, 3, 0x00FFFFFFu);
+    glyph_tile_composite((uint8_t *)canvas, 16, 4, 4, t, GLYPH_PLANE_SHADOW, 3, 3, 0xFFFFFFFFu);
+    assert(canvas[2 * 4 + 2] == 0x80800000u);
+
+    /* Tiles hanging off every edge are clipped, not written out of bounds. */
+    glyph_tile_composite((uint8_t *)canvas, 16, 4, 4, t, GLYPH_PLANE_OUTLINE, 0, 0, 0xFF0000FFu);
+    glyph_tile_composite((uint8_t *)canvas, 16, 4, 4, t, GLYPH_PLANE_OUTLINE, 4, 4, 0xFF0000FFu);
+    glyph_tile_composite((uint8_t *)canvas, 16, 4, 4, t, GLYPH_PLANE_OUTLINE, 10, -10, 0xFF0000FFu);
+    assert(canvas[0] == 0xFF0000FFu);
+    assert(canvas[3 * 4 + 3] == 0xFF0000FFu);
+    assert(canvas[1] == 0xFF808080u);
+
+    glyph_atlas_destroy(a);
+}
+
+int main(void) {
+    test_cache();
+    test_downsample();
+    test_composite();
+    printf("test_glyph_atlas: all checks passed\n");
+    return 0;
+}
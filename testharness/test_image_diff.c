@@ -0,0 +1,210 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_image_diff.c
+ * Golden-image comparison building blocks: png_reader must decode what
+ * png_writer produces (every bit depth and filter strategy, tRNS alpha,
+ * band-parallel deflate) and reject damaged input; image_diff must call
+ * identical frames exact, count index changes by reference index, see
+ * through a permuted palette, and rank a one-pixel change above a
+ * shifted cue on SSIM.
+ *
+ * Build:
+ *   gcc -std=gnu11 -Wall -Isrc testharness/test_image_diff.c \
+ *       src/image_diff.c src/png_reader.c src/png_writer.c -lz -lpthread \
+ *       -o test_image_diff
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "png_writer.h"
+#include "png_reader.h"
+#include "image_diff.h"
+
+#define W 203
+#define H 71
+
+static const uint32_t pal16[16] = {
+    0x00000000, 0xFFFFFFFF, 0xFF000000, 0x64000000, 0xFFFF0000, 0xFF00FF00,
+    0xFF0000FF, 0x80FFFFFF, 0xFF808080, 0xFFFFFF00, 0xFF00FFFF, 0xFFFF00FF,
+    0xC0202020, 0x40FFFFFF, 0xFF7F7F7F, 0xFF101010,
+};
+
+/* A cue-like frame: transparent, a text block of fill (1) with an
+ * outline (2) and a shadow (3) starting at (x, y). */
+static void draw_cue(uint8_t *idx, int x, int y) {
+    memset(idx, 0, (size_t)W * H);
+    for (int j = 0; j < 20; j++)
+        for (int i = 0; i < 90; i++) {
+            int edge = j < 2 || j >= 18 || i < 2 || i >= 88;
+            idx[(size_t)(y + j) * W + x + i] = (uint8_t)(edge ? 2 : ((i / 6 + j / 5) % 3 ? 1 : 2));
+            idx[(size_t)(y + j + 2) * W + x + i + 92] = 3;
+        }
+}
+
+static void to_png(const uint8_t *idx, const uint32_t *pal, int ncolors,
+                   const PngWriterOptions *opt, PngIndexed *img) {
+    unsigned char *png = NULL;
+    size_t len = 0;
+    assert(png_encode_indexed(idx, W, H, W, pal, ncolors, opt, &png, &len) == 0);
+    assert(png_decode_indexed(png, len, img) == 0);
+    free(png);
+}
+
+static void test_roundtrip(void) {
+    uint8_t *idx = malloc((size_t)W * H);
+    static const int ncolors[] = { 2, 4, 16, 200 };
+    uint32_t pal[256];
+    for (int i = 0; i < 256; i++)
+        pal[i] = ((uint32_t)(i * 37 & 0xFF) << 24) | (uint32_t)i * 0x010203u;
+    for (int c = 0; c < 4; c++) {
+        for (int i = 0; i < W * H; i++)
+            idx[i] = (uint8_t)((i * 7 + i / W) % ncolors[c]);
+        for (int f = PNG_FILTER_NONE; f <= PNG_FILTER_ADAPTIVE; f++) {
+            for (int threads = 1; threads <= 3; threads += 2) {
+                PngWriterOptions opt = { 6, f, threads };
+                PngIndexed img;
+                to_png(idx, pal, ncolors[c], &opt, &img);
+                assert(img.w == W && img.h == H && img.ncolors == ncolors[c]);
+                assert(memcmp(img.idx, idx, (size_t)W * H) == 0);
+                assert(memcmp(img.palette, pal, sizeof(uint32_t) * (size_t)ncolors[c]) == 0);
+                png_indexed_free(&img);
+            }
+        }
+    }
+    free(idx);
+}
+
+static void test_reject(void) {
+    uint8_t *idx = calloc((size_t)W * H, 1);
+    unsigned char *png = NULL;
+    size_t len = 0;
+    PngIndexed img;
+    assert(png_encode_indexed(idx, W, H, W, pal16, 16, NULL, &png, &len) == 0);
+    assert(png_decode_indexed(png, 7, &img) == -1 && img.idx == NULL);
+    assert(png_decode_indexed(png, len - 12, &img) == -1); /* no IEND */
+    png[42] ^= 0x01; /* inside PLTE: CRC no longer matches */
+    assert(png_decode_indexed(png, len, &img) == -1 && img.idx == NULL);
+    assert(png_read_indexed_file("/nonexistent/golden.png", &img) == -1);
+    free(png);
+    free(idx);
+}
+
+static void test_diff(void) {
+    uint8_t *idx = malloc((size_t)W * H);
+    PngIndexed ref, same, one, moved, perm;
+    draw_cue(idx, 10, 20);
+    to_png(idx, pal16, 16, NULL, &ref);
+    to_png(idx, pal16, 16, NULL, &same);
+
+    ImageDiff d;
+    assert(image_diff_indexed(&ref, &same, &d) == 0);
+    assert(d.exact && d.changed == 0 && d.max_delta == 0 && d.ssim > 0.999999);
+    ImageDiffThresholds exact = image_diff_exact_thresholds();
+    assert(image_diff_passes(&d, &exact));
+    /* content box: cue, shadow and padding, not the whole frame */
+    assert(d.pixels == (long)(90 + 92 + 8) * (22 + 8));
+
+    /* one fill pixel turned into outline */
+    uint8_t was = idx[(size_t)25 * W + 40];
+    idx[(size_t)25 * W + 40] = was == 1 ? 2 : 1;
+    to_png(idx, pal16, 16, NULL, &one);
+    assert(image_diff_indexed(&ref, &one, &d) == 0);
+    assert(!d.exact && d.changed == 1 && d.changed_by_index[was] == 1);
+    assert(d.max_delta == 255 && d.palette_changed == 0);
+    double ssim_one = d.ssim;
+    assert(ssim_one < 1.0 && ssim_one > 0.98);
+    assert(!image_diff_passes(&d, &exact));
+    ImageDiffThresholds loose = { 0.95, 0.1, 255 };
+    assert(image_diff_passes(&d, &loose));
+
+    /* the whole cue shifted by one pixel */
+    draw_cue(idx, 11, 20);
+    to_png(idx, pal16, 16, NULL, &moved);
+    assert(image_diff_indexed(&ref, &moved, &d) == 0);
+    assert(!d.exact && d.changed > 100 && d.ssim < ssim_one);
+    assert(d.changed_by_index[0] > 0 && d.changed_by_index[1] > 0);
+    assert(!image_diff_passes(&d, &loose));
+
+    /* same picture with indices 1 and 2 swapped in data and palette */
+    draw_cue(idx, 10, 20);
+    uint32_t pal_swap[16];
+    memcpy(pal_swap, pal16, sizeof(pal_swap));
+    pal_swap[1] = pal16[2];
+    pal_swap[2] = pal16[1];
+    for (int i = 0; i < W * H; i++)
+        idx[i] = idx[i] == 1 ? 2 : idx[i] == 2 ? 1 : idx[i];
+    to_png(idx, pal_swap, 16, NULL, &perm);
+    assert(image_diff_indexed(&ref, &perm, &d) == 0);
+    assert(!d.exact && d.palette_changed == 2 && d.max_delta == 0 && d.ssim > 0.999999);
+
+    /* size mismatch never passes */
+    PngIndexed small = ref;
+    small.w = W - 1;
+    assert(image_diff_indexed(&ref, &small, &d) == 0);
+    assert(d.size_mismatch && !image_diff_passes(&d, &loose));
+
+    png_indexed_free(&ref);
+    png_indexed_free(&same);
+    png_indexed_free(&one);
+    png_indexed_free(&moved);
+    png_indexed_free(&perm);
+    free(idx);
+}
+
+int main(void) {
+    test_roundtrip();
+    test_reject();
+    test_diff();
+    printf("test_image_diff: all checks passed\n");
+    return 0;
+}
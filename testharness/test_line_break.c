@@ -0,0 +1,212 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_line_break.c
+ * Checks width-aware balanced line breaking: the fewest lines that fit,
+ * with the break points that even out line widths, a lone over-long word
+ * on its own line, the max_lines cap, tag-aware widths with italic runs
+ * measured in their own style, the advance cache, and the parse-time
+ * hook through SRTParserConfig.line_breaker.
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_line_break.c src/line_break.c \
+ *        src/srt_parser.c src/qc.c src/qc_report.c -o test_line_break
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "line_break.h"
+#include "srt_parser.h"
+
+int debug_level = 0;
+int use_ass = 0;
+int video_w = 720;
+int video_h = 576;
+
+static int advance_calls;
+
+/* Fake font: 10 units per character, 5 for a space, italic glyphs 12. */
+static int32_t fake_advance(void *user, uint32_t cp, int style) {
+    (void)user;
+    advance_calls++;
+    if (cp == ' ') return 5;
+    return (style & LINE_BREAK_ITALIC) ? 12 : 10;
+}
+
+static int count_lines(const char *s) {
+    int n = 1;
+    for (; *s; s++) n += *s == '\n';
+    return n;
+}
+
+static void test_balanced(void) {
+    /* 325 units cannot fit on two lines of 160, so three; "40 100"
+     * (145) would leave the middle line nearly empty, so 100 stands alone. */
+    const int32_t w[] = { 40, 40, 40, 40, 40, 100 };
+    unsigned char brk[6];
+    int k = line_break_balanced(w, 6, 5, 160, 0, brk);
+    assert(k == 3 && brk[0] && brk[5]);
+
+    /* Classic case: greedy fills line 1 and leaves a short line 2. */
+    const int32_t w2[] = { 30, 30, 30, 30, 30, 30, 30 };
+    unsigned char b2[7];
+    k = line_break_balanced(w2, 7, 10, 200, 0, b2);
+    assert(k == 2);
+    /* 7 words on 2 lines: balanced split is 4/3 or 3/4, never 5/2 */
+    int first = 0;
+    for (int i = 0; i < 7 && (i == 0 || !b2[i]); i++) first++;
+    assert(first == 3 || first == 4);
+    assert(b2[0] == 1);
+
+    /* Fits on one line: no breaks at all. */
+    k = line_break_balanced(w2, 3, 10, 200, 0, b2);
+    assert(k == 1 && b2[0] == 1 && !b2[1] && !b2[2]);
+
+    /* An over-long word takes a line of its own without breaking others. */
+    const int32_t w3[] = { 20, 500, 20 };
+    unsigned char b3[3];
+    k = line_break_balanced(w3, 3, 5, 100, 0, b3);
+    assert(k == 3 && b3[0] && b3[1] && b3[2]);
+
+    /* The cap wins over fitting: 7 words of 30 at width 50 on 2 lines. */
+    k = line_break_balanced(w2, 7, 10, 50, 2, b2);
+    assert(k == 2);
+}
+
+static void test_wrap(void) {
+    /* 33 ASCII characters: 330 units; 2 lines at width 200. */
+    LineBreaker *lb = line_breaker_create(fake_advance, NULL, NULL, 200);
+    assert(lb);
+    assert(line_breaker_max_width(lb) == 200);
+    char *out = line_breaker_wrap(lb, "one two three four five six seven", 3);
+    assert(out);
+    assert(count_lines(out) == 2);
+    /* greedy would give "one two three four five" + "six seven" */
+    assert(strcmp(out, "one two three four\nfive six seven") == 0);
+    free(out);
+
+    /* Explicit newlines are kept; tags do not count towards width. */
+    out = line_breaker_wrap(lb, "<font color=\"#ffffff\">short</font>\nline", 3);
+    assert(out && strcmp(out, "<font color=\"#ffffff\">short</font>\nline") == 0);
+    free(out);
+
+    /* Line budget: the last allowed line takes the rest. */
+    out = line_breaker_wrap(lb, "aaaaaaaaaaaaaaa bbbbbbbbbbbbbbb ccccccccccccccc ddd", 2);
+    assert(out && count_lines(out) == 2);
+    free(out);
+
+    /* Italic runs are measured in italic and the style carries across words. */
+    int style = 0;
+    int32_t plain = line_breaker_text_width(lb, "abc", 3, &style);
+    assert(plain == 30 && style == 0);
+    int32_t it = line_breaker_text_width(lb, "<i>abc", 6, &style);
+    assert(it == 36 && style == LINE_BREAK_ITALIC);
+    it = line_breaker_text_width(lb, "de</i>", 6, &style);
+    assert(it == 24 && style == 0);
+    style = 0;
+    it = line_breaker_text_width(lb, "{\\i1}ab{\\i0}c", 13, &style);
+    assert(it == 34 && style == 0);
+    /* An unterminated '<' is literal text. */
+    style = 0;
+    assert(line_breaker_text_width(lb, "a<b", 3, &style) == 30);
+    /* UTF-8 counts codepoints, not bytes. */
+    assert(line_breaker_text_width(lb, "\xc3\xa9t\xc3\xa9", 5, &style) == 30);
+
+    /* Every (codepoint, style) is measured once. */
+    advance_calls = 0;
+    out = line_breaker_wrap(lb, "one two three four five six seven", 3);
+    free(out);
+    assert(advance_calls == 0);
+    long hits = 0, misses = 0;
+    line_breaker_stats(lb, &hits, &misses);
+    assert(hits > 0 && misses > 0 && misses < 40);
+    line_breaker_destroy(lb);
+}
+
+static void test_parser_hook(void) {
+    char path[] = "/tmp/test_line_break_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    FILE *f = fdopen(fd, "w");
+    assert(f);
+    fputs("1\n00:00:01,000 --> 00:00:02,000\n"
+          "one two three four five six seven\n\n", f);
+    fclose(f);
+
+    LineBreaker *lb = line_breaker_create(fake_advance, NULL, NULL, 200);
+    SRTParserConfig cfg = { .use_ass = 0, .video_w = 720, .video_h = 576,
+                            .line_breaker = lb };
+    SRTEntry *entries = NULL;
+    int n = parse_srt_cfg(path, &entries, NULL, &cfg);
+    assert(n == 1);
+    assert(strstr(entries[0].text, "one two three four\nfive six seven") != NULL);
+    free(entries[0].text);
+    free(entries);
+
+    /* Without a breaker the character-count wrap is unchanged (37 SD). */
+    cfg.line_breaker = NULL;
+    n = parse_srt_cfg(path, &entries, NULL, &cfg);
+    assert(n == 1);
+    assert(strchr(entries[0].text, '\n') == NULL);
+    free(entries[0].text);
+    free(entries);
+
+    line_breaker_destroy(lb);
+    unlink(path);
+}
+
+int main(void) {
+    test_balanced();
+    test_wrap();
+    test_parser_hook();
+    printf("test_line_break: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,300 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_log_async.c
+ * Checks the asynchronous LOG() backend: every message from several
+ * threads arrives once and in per-thread order through small rings that
+ * wrap and fill up, long messages survive intact, JSON lines carry the
+ * LOG_CONTEXT fields with the message escaped, the per-call-site rate
+ * limit collapses a burst into one "suppressed" line, and the backend
+ * can be restarted after log_async_stop().
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_log_async.c src/log_async.c \
+ *        -lpthread -o test_log_async
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEBUG_MODULE "test"
+#include "debug.h"
+#include "log_async.h"
+
+int debug_level = 1;
+
+#define THREADS 4
+#define PER_THREAD 3000
+
+/* Read the whole stream back as a NUL-terminated string. */
+static char *slurp(FILE *f)
+{
+    fflush(f);
+    long n = ftell(f);
+    rewind(f);
+    char *buf = malloc((size_t)n + 1);
+    assert(buf);
+    assert(fread(buf, 1, (size_t)n, f) == (size_t)n);
+    buf[n] = '\0';
+    return buf;
+}
+
+static void *producer(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < PER_THREAD; i++)
+        LOG(1, "t%d msg %d\n", id, i);
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    FILE *f = tmpfile();
+    assert(f);
+    /* 4 KiB rings wrap every few dozen records and make producers wait. */
+    LogAsyncConfig cfg = { .format = LOG_FORMAT_TEXT, .out = f, .ring_bytes = 4096 };
+    assert(log_async_start(&cfg) == 0);
+    assert(log_async_start(&cfg) == -1);
+    assert(log_async_active());
+
+    pthread_t th[THREADS];
+    for (int t = 0; t < THREADS; t++)
+        assert(pthread_create(&th[t], NULL, producer, (void *)(intptr_t)t) == 0);
+    for (int t = 0; t < THREADS; t++)
+        pthread_join(th[t], NULL);
+    log_async_stop();
+    assert(!log_async_active());
+
+    uint64_t written = 0, suppressed = 0;
+    log_async_stats(&written, &suppressed);
+    assert(written == THREADS * PER_THREAD && suppressed == 0);
+
+    char *out = slurp(f);
+    int next[THREADS] = {0};
+    int lines = 0;
+    for (char *line = strtok(out, "\n"); line; line = strtok(NULL, "\n")) {
+        int t = -1, i = -1;
+        assert(sscanf(line, "[test] t%d msg %d", &t, &i) == 2);
+        assert(t >= 0 && t < THREADS);
+        assert(i == next[t]);
+        next[t]++;
+        lines++;
+    }
+    assert(lines == THREADS * PER_THREAD);
+    free(out);
+    fclose(f);
+}
+
+static void test_long_message(void)
+{
+    FILE *f = tmpfile();
+    assert(f);
+    LogAsyncConfig cfg = { .format = LOG_FORMAT_TEXT, .out = f };
+    assert(log_async_start(&cfg) == 0);
+    char big[3001];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    LOG(1, "%s|\n", big);
+    log_async_flush();
+    log_async_stop();
+
+    char *out = slurp(f);
+    assert(strncmp(out, "[test] ", 7) == 0);
+    assert(strlen(out) == 7 + 3000 + 2);
+    assert(strcmp(out + 7 + 3000, "|\n") == 0);
+    free(out);
+    fclose(f);
+}
+
+static void test_json(void)
+{
+    FILE *f = tmpfile();
+    assert(f);
+    LogAsyncConfig cfg = { .format = LOG_FORMAT_JSON, .out = f };
+    assert(log_async_start(&cfg) == 0);
+    LOG_CONTEXT(3, 7, 900);
+    LOG(1, "say \"%s\"\tnow\n", "hi");
+    LOG_CONTEXT(-1, -1, -1);
+    LOG(2, "filtered by debug_level\n");
+    LOG(1, "no context\n");
+    log_async_stop();
+
+    char *out = slurp(f);
+    char *second = strchr(out, '\n');
+    assert(second);
+    *second++ = '\0';
+    assert(out[0] == '{' && out[strlen(out) - 1] == '}');
+    assert(strstr(out, "\"level\":1,\"module\":\"test\",\"thread\":"));
+    assert(strstr(out, ",\"track\":3,\"cue\":7,\"pts\":900,"));
+    assert(strstr(out, "\"msg\":\"say \\\"hi\\\"\\tnow\"}"));
+    assert(!strstr(second, "\"track\"") && strstr(second, "\"msg\":\"no context\"}\n"));
+    assert(!strstr(second, "filtered"));
+    free(out);
+    fclose(f);
+}
+
+static void test_rate_limit(void)
+{
+    FILE *f = tmpfile();
+    assert(f);
+    LogAsyncConfig cfg = { .format = LOG_FORMAT_TEXT, .rate_per_sec = 10, .out = f };
+    assert(log_async_start(&cfg) == 0);
+    for (int i = 0; i < 1000; i++)
+        LOG(1, "packet %d\n", i);
+    LOG(1, "other call site\n");
+    log_async_stop();
+
+    uint64_t written = 0, suppressed = 0;
+    log_async_stats(&written, &suppressed);
+    /* The burst takes far less than the one-second window. */
+    assert(suppressed == 990);
+
+    char *out = slurp(f);
+    int kept = 0;
+    for (const char *p = out; (p = strstr(p, "[test] packet ")); p++)
+        kept++;
+    assert(kept == 10);
+    assert(strstr(out, "[test] other call site\n"));
+    assert(strstr(out, "[test] (suppressed 990 more like: packet %d)\n"));
+    free(out);
+    fclose(f);
+}
+
+/*
+ * Call sites whose format pointers hash to the same slot (512 bytes
+ * apart) keep separate windows instead of resetting each other's.
+ */
+static void test_rate_collision(void)
+{
+    static char fmts[4 * 512];
+    for (int k = 0; k < 4; k++)
+        snprintf(fmts + k * 512, 512, "site %d %%d\n", k);
+
+    FILE *f = tmpfile();
+    assert(f);
+    LogAsyncConfig cfg = { .format = LOG_FORMAT_TEXT, .rate_per_sec = 3, .out = f };
+    assert(log_async_start(&cfg) == 0);
+    for (int i = 0; i < 50; i++)
+        for (int k = 0; k < 4; k++)
+            LOG(1, fmts + k * 512, i);
+    log_async_stop();
+
+    uint64_t written = 0, suppressed = 0;
+    log_async_stats(&written, &suppressed);
+    assert(suppressed == 4 * 47);
+
+    char *out = slurp(f);
+    for (int k = 0; k < 4; k++) {
+        char want[64];
+        snprintf(want, sizeof(want), "[test] (suppressed 47 more like: site %d %%d)\n", k);
+        assert(strstr(out, want));
+        snprintf(want, sizeof(want), "[test] site %d 3\n", k);
+        assert(!strstr(out, want));
+    }
+    free(out);
+    fclose(f);
+}
+
+/* Rings of threads still alive at stop are freed; a restart gives the
+ * thread a fresh one and a thread exiting afterwards is harmless. */
+static void *late_exit(void *arg)
+{
+    pthread_barrier_t *b = arg;
+    LOG(1, "before stop\n");
+    pthread_barrier_wait(b);    /* main stops the backend */
+    pthread_barrier_wait(b);
+    return NULL;
+}
+
+static void test_restart_frees_rings(void)
+{
+    FILE *f = tmpfile();
+    assert(f);
+    LogAsyncConfig cfg = { .format = LOG_FORMAT_TEXT, .out = f, .ring_bytes = 4096 };
+    pthread_barrier_t b;
+    pthread_barrier_init(&b, NULL, 2);
+    assert(log_async_start(&cfg) == 0);
+    pthread_t th;
+    assert(pthread_create(&th, NULL, late_exit, &b) == 0);
+    LOG(1, "main first\n");
+    pthread_barrier_wait(&b);
+    log_async_stop();
+    pthread_barrier_wait(&b);
+    pthread_join(th, NULL);
+
+    cfg.ring_bytes = 0;
+    assert(log_async_start(&cfg) == 0);
+    LOG(1, "main again\n");
+    log_async_stop();
+    pthread_barrier_destroy(&b);
+
+    char *out = slurp(f);
+    assert(strstr(out, "[test] before stop\n"));
+    assert(strstr(out, "[test] main first\n"));
+    assert(strstr(out, "[test] main again\n"));
+    free(out);
+    fclose(f);
+}
+
+int main(void)
+{
+    test_threads();
+    test_long_message();
+    test_json();
+    test_rate_limit();
+    test_rate_collision();
+    test_restart_frees_rings();
+
+    /* Stopped: LOG() is written directly again. */
+    assert(!log_async_active());
+    printf("test_log_async: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,265 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <zlib.h>
+#include "../src/png_writer.h"
+
+/*
+ * Native palette PNG writer: chunk layout and CRCs, IHDR bit depth by
+ * palette size, PLTE/tRNS contents, and a full decode (inflate, unfilter,
+ * unpack) that must reproduce the index plane for every filter strategy,
+ * with and without band-parallel deflate.
+ *
+ * Build:
+ *   gcc -std=gnu11 -Wall -Isrc testharness/test_png_writer.c \
+ *       src/png_writer.c -lz -lpthread -o test_png_writer
+ */
+
+static uint32_t be32(const unsigned char *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+typedef struct {
+    int w, h, depth, ctype;
+    unsigned char plte[768];
+    int plte_len;
+    unsigned char trns[256];
+    int trns_len;
+    unsigned char *idat;
+    size_t idat_len;
+} Decoded;
+
+/* Walk the chunks, checking each CRC, and collect what we need. */
+static void parse_png(const unsigned char *png, size_t len, Decoded *d) {
+    static const unsigned char sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    memset(d, 0, sizeof(*d));
+    assert(len > 8 && memcmp(png, sig, 8) == 0);
+    size_t off = 8;
+    int seen_iend = 0, first = 1;
+    while (off + 12 <= len) {
+        uint32_t n = be32(png + off);
+        const unsigned char *type = png + off + 4;
+        const unsigned char *data = png + off + 8;
+        assert(off + 12 + n <= len);
+        uLong crc = crc32(crc32(0L, type, 4), data, n);
+        assert(be32(data + n) == (uint32_t)crc);
+        if (first) assert(memcmp(type, "IHDR", 4) == 0);
+        first = 0;
+        if (!memcmp(type, "IHDR", 4)) {
+            d->w = (int)be32(data);
+            d->h = (int)be32(data + 4);
+            d->depth = data[8];
+            d->ctype = data[9];
+        } else if (!memcmp(type, "PLTE", 4)) {
+            memcpy(d->plte, data, n);
+            d->plte_len = (int)n;
+        } else if (!memcmp(type, "tRNS", 4)) {
+            assert(d->plte_len > 0); /* tRNS must follow PLTE */
+            memcpy(d->trns, data, n);
+            d->trns_len = (int)n;
+        } else if (!memcmp(type, "IDAT", 4)) {
+            d->idat = realloc(d->idat, d->idat_len + n);
+            memcpy(d->idat + d->idat_len, data, n);
+            d->idat_len += n;
+        } else if (!memcmp(type, "IEND", 4)) {
+            seen_iend = 1;
+        }
+        off += 12 + n;
+    }
+    assert(seen_iend && off == len);
+}
+
+static unsigned paeth(unsigned a, unsigned b, unsigned c) {
+    int p = (int)a + (int)b - (int)c;
+    int pa = abs(p - (int)a), pb = abs(p - (int)b), pc = abs(p - (int)c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+/* Inflate + unfilter + unpack into a w*h index plane. */
+static uint8_t *decode_indices(const Decoded *d) {
+    size_t row = ((size_t)d->w * d->depth + 7) / 8;
+    size_t raw_len = (row + 1) * d->h;
+    unsigned char *raw = malloc(raw_len);
+    uLongf got = (uLongf)raw_len;
+    assert(uncompress(raw, &got, d->idat, (uLong)d->idat_len) == Z_OK);
+    assert(got == raw_len);
+    uint8_t *idx = malloc((size_t)d->w * d->h);
+    unsigned char *prev = calloc(1, row), *cur = malloc(row);
+    for (int y = 0; y < d->h; y++) {
+        const unsigned char *f = raw + (size_t)y * (row + 1);
+        for (size_t i = 0; i < row; i++) {
+            unsigned a = i ? cur[i - 1] : 0, b = prev[i], c = i ? prev[i - 1] : 0;
+            unsigned v = f[1 + i];
+            switch (f[0]) {
+            case 0: break;
+            case 1: v += a; break;
+            case 2: v += b; break;
+            case 3: v += (a + b) / 2; break;
+            case 4: v += paeth(a, b, c); break;
+            default: assert(!"bad filter type");
+            }
+            cur[i] = (unsigned char)v;
+        }
+        int ppb = 8 / d->depth;
+        for (int x = 0; x < d->w; x++)
+            idx[(size_t)y * d->w + x] =
+                (cur[x / ppb] >> (8 - d->depth * (x % ppb + 1))) & ((1 << d->depth) - 1);
+        memcpy(prev, cur, row);
+    }
+    free(raw);
+    free(prev);
+    free(cur);
+    return idx;
+}
+
+/* Subtitle-like test image: transparent background, "glyph" blocks
+ * using every palette entry, some noise. */
+static void make_image(uint8_t *idx, int w, int h, int stride, int ncolors, unsigned seed) {
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++) {
+            seed = seed * 1103515245u + 12345u;
+            int glyph = ((x / 7) % 3 != 0) && ((y / 9) % 2 == 0);
+            idx[(size_t)y * stride + x] = glyph ? (uint8_t)((x + y) % ncolors)
+                                                : (seed >> 16) % 97 == 0 ? (uint8_t)(ncolors - 1) : 0;
+        }
+}
+
+static void roundtrip(int w, int h, int ncolors, int filter, int threads, int level) {
+    int stride = w + 3;
+    uint8_t *img = malloc((size_t)stride * h);
+    make_image(img, w, h, stride, ncolors, (unsigned)(w * 31 + h));
+    uint32_t pal[256];
+    for (int i = 0; i < ncolors; i++)
+        pal[i] = (i == 0 ? 0x00000000u : i == 1 ? 0x80FF8000u : 0xFF000000u) | (uint32_t)(i * 0x010203);
+
+    PngWriterOptions opt = { level, filter, threads };
+    unsigned char *png = NULL;
+    size_t len = 0;
+    assert(png_encode_indexed(img, w, h, stride, pal, ncolors, &opt, &png, &len) == 0);
+
+    Decoded d;
+    parse_png(png, len, &d);
+    assert(d.w == w && d.h == h && d.ctype == 3);
+    int want_depth = ncolors <= 2 ? 1 : ncolors <= 4 ? 2 : ncolors <= 16 ? 4 : 8;
+    assert(d.depth == want_depth);
+    assert(d.plte_len == ncolors * 3);
+    for (int i = 0; i < ncolors; i++) {
+        assert(d.plte[i * 3] == ((pal[i] >> 16) & 0xFF));
+        assert(d.plte[i * 3 + 2] == (pal[i] & 0xFF));
+    }
+    /* entry 0 transparent, entry 1 half, the rest opaque and omitted */
+    assert(d.trns_len == (ncolors >= 2 ? 2 : 1));
+    assert(d.trns[0] == 0x00);
+    if (ncolors >= 2) assert(d.trns[1] == 0x80);
+
+    uint8_t *dec = decode_indices(&d);
+    for (int y = 0; y < h; y++)
+        assert(memcmp(dec + (size_t)y * w, img + (size_t)y * stride, (size_t)w) == 0);
+    free(dec);
+    free(d.idat);
+    free(png);
+    free(img);
+}
+
+int main(void) {
+    PngFilterStrategy f;
+    assert(png_filter_parse("adaptive", &f) == 0 && f == PNG_FILTER_ADAPTIVE);
+    assert(png_filter_parse("paeth", &f) == 0 && f == PNG_FILTER_PAETH);
+    assert(png_filter_parse("avg", &f) == -1);
+    PngWriterOptions def = png_writer_default_options();
+    assert(def.level == 6 && def.filter == PNG_FILTER_NONE && def.threads == 1);
+
+    for (int filter = PNG_FILTER_NONE; filter <= PNG_FILTER_ADAPTIVE; filter++)
+        for (int threads = 1; threads <= 4; threads += 3) {
+            roundtrip(333, 301, 16, filter, threads, 6);
+            roundtrip(17, 5, 2, filter, threads, 1);
+        }
+    roundtrip(64, 200, 4, PNG_FILTER_UP, 3, 9);
+    roundtrip(129, 260, 200, PNG_FILTER_ADAPTIVE, 8, 0);
+    roundtrip(1, 1, 1, PNG_FILTER_NONE, 1, 6);
+
+    /* Parallel bands must produce a stream that decodes to the same
+     * pixels; compare against the single-threaded encode. */
+    {
+        int w = 720, h = 576;
+        uint8_t *img = malloc((size_t)w * h);
+        make_image(img, w, h, w, 16, 7);
+        uint32_t pal[16] = {0};
+        unsigned char *a = NULL, *b = NULL;
+        size_t al = 0, bl = 0;
+        PngWriterOptions o1 = { 6, PNG_FILTER_NONE, 1 }, o4 = { 6, PNG_FILTER_NONE, 4 };
+        assert(png_encode_indexed(img, w, h, w, pal, 16, &o1, &a, &al) == 0);
+        assert(png_encode_indexed(img, w, h, w, pal, 16, &o4, &b, &bl) == 0);
+        Decoded da, db;
+        parse_png(a, al, &da);
+        parse_png(b, bl, &db);
+        uint8_t *ia = decode_indices(&da), *ib = decode_indices(&db);
+        assert(memcmp(ia, ib, (size_t)w * h) == 0);
+        free(ia); free(ib); free(da.idat); free(db.idat); free(a); free(b); free(img);
+    }
+
+    /* Invalid input: index beyond the palette, bad sizes. */
+    uint8_t bad[4] = { 0, 1, 2, 16 };
+    uint32_t pal[16] = {0};
+    unsigned char *out = (unsigned char *)1;
+    size_t out_len = 1;
+    assert(png_encode_indexed(bad, 4, 1, 4, pal, 16, NULL, &out, &out_len) == -1);
+    assert(out == NULL && out_len == 0);
+    assert(png_encode_indexed(bad, 0, 1, 4, pal, 16, NULL, &out, &out_len) == -1);
+    assert(png_encode_indexed(bad, 4, 1, 3, pal, 16, NULL, &out, &out_len) == -1);
+    assert(png_encode_indexed(bad, 4, 1, 4, pal, 0, NULL, &out, &out_len) == -1);
+
+    printf("test_png_writer: all checks passed\n");
+    return 0;
+}
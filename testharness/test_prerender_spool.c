@@ -0,0 +1,143 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_prerender_spool.c
+ * Round-trips payloads through an anonymous and a named spool, checks
+ * PTS-guarded lookups and that a reopened spool file matches, and that
+ * truncated files are rejected.
+ *
+ * Build: gcc -std=gnu11 -Wall -Isrc testharness/test_prerender_spool.c \
+ *        src/prerender_spool.c -o test_prerender_spool
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "prerender_spool.h"
+
+int debug_level = 0;
+
+static void fill(uint8_t *buf, int n, int seed) {
+    for (int i = 0; i < n; i++)
+        buf[i] = (uint8_t)(seed * 31 + i);
+}
+
+static void check_payload(const PrerenderSpool *sp, int t, int c, int64_t pts90, int n, int seed) {
+    const uint8_t *d = NULL;
+    int sz = 0;
+    uint8_t want[512];
+    fill(want, n, seed);
+    assert(prerender_spool_get(sp, t, c, pts90, &d, &sz) == 1);
+    assert(sz == n && memcmp(d, want, (size_t)n) == 0);
+}
+
+static void round_trip(const char *path) {
+    const int counts[2] = {3, 2};
+    PrerenderSpool *sp = prerender_spool_create(path, 2, counts, 0x5eed5eedcafef00dULL);
+    assert(sp);
+    uint8_t buf[512];
+
+    /* completion order differs from index order */
+    fill(buf, 100, 1); assert(prerender_spool_append(sp, 1, 0, 9000, buf, 100) == 0);
+    fill(buf, 7, 2);   assert(prerender_spool_append(sp, 0, 0, 1000, buf, 7) == 0);
+    fill(buf, 300, 3); assert(prerender_spool_append(sp, 0, 2, 3000, buf, 300) == 0);
+    /* rejected: duplicate slot, out of range, empty */
+    assert(prerender_spool_append(sp, 0, 2, 3000, buf, 300) == -1);
+    assert(prerender_spool_append(sp, 0, 3, 4000, buf, 1) == -1);
+    assert(prerender_spool_append(sp, 2, 0, 4000, buf, 1) == -1);
+    assert(prerender_spool_append(sp, 1, 1, 4000, buf, 0) == -1);
+
+    /* lookups are refused until the spool is mapped */
+    assert(prerender_spool_get(sp, 0, 0, 1000, NULL, NULL) == 0);
+    assert(prerender_spool_finish(sp) == 0);
+    assert(prerender_spool_payload_bytes(sp) == 407);
+    assert(prerender_spool_cue_count(sp, 0) == 3 && prerender_spool_cue_count(sp, 1) == 2);
+    assert(prerender_spool_track_count(sp) == 2);
+
+    check_payload(sp, 0, 0, 1000, 7, 2);
+    check_payload(sp, 0, 2, 3000, 300, 3);
+    check_payload(sp, 1, 0, 9000, 100, 1);
+    assert(prerender_spool_get(sp, 0, 1, 2000, NULL, NULL) == 0);  /* never written */
+    assert(prerender_spool_get(sp, 0, 0, 1001, NULL, NULL) == 0);  /* PTS mismatch */
+    assert(prerender_spool_get(sp, 1, 2, 0, NULL, NULL) == 0);     /* out of range */
+    prerender_spool_close(sp);
+}
+
+int main(void) {
+    round_trip(NULL);
+
+    char path[] = "/tmp/test_spool_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    round_trip(path);
+
+    PrerenderSpool *sp = prerender_spool_open(path);
+    assert(sp);
+    assert(prerender_spool_payload_bytes(sp) == 407);
+    /* the key written at create time survives the round trip */
+    assert(prerender_spool_key(sp) == 0x5eed5eedcafef00dULL);
+    assert(prerender_spool_track_count(sp) == 2 && prerender_spool_cue_count(sp, 0) == 3);
+    check_payload(sp, 0, 0, 1000, 7, 2);
+    check_payload(sp, 0, 2, 3000, 300, 3);
+    check_payload(sp, 1, 0, 9000, 100, 1);
+    assert(prerender_spool_get(sp, 1, 1, 0, NULL, NULL) == 0);
+    prerender_spool_close(sp);
+
+    /* a truncated index must not be accepted */
+    assert(truncate(path, 420) == 0);
+    assert(prerender_spool_open(path) == NULL);
+    unlink(path);
+    assert(prerender_spool_open(path) == NULL);
+
+    printf("test_prerender_spool: all checks passed\n");
+    return 0;
+}
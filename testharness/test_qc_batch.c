@@ -0,0 +1,175 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_qc_batch.c
+ * Checks that qc_check_track() emits exactly what the parser's per-cue
+ * path does (strip tags, qc_check_entry() against the previous cue) on a
+ * generated track covering every check, overlaps, multi-byte and
+ * truncated UTF-8 text: same lines in the same order and the same
+ * qc_error_count, inline and with the text pass split across threads.
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_qc_batch.c src/qc_batch.c \
+ *        src/qc.c src/qc_report.c src/srt_parser.c src/line_break.c \
+ *        -lpthread -o test_qc_batch
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "qc.h"
+#include "qc_batch.h"
+
+int debug_level = 0;
+int video_w = 720;
+int video_h = 576;
+int use_ass = 0;
+
+static const char *texts[] = {
+    "Hello there",
+    "<i>Italic</i> line",
+    "{\\i1}ASS italic{\\i0}",
+    "",
+    "one\ntwo\nthree\nfour",
+    "trailing newline\n",
+    "tab\tis fine",
+    "bell\a here",
+    "Grüße aus Köln, schöne Straße mit Überlänge für SD-Ausgabe hier",
+    "truncated \xE2\x82",
+    "<font color=\"#ff0000\">red</font> and </b> stray",
+    "this line is deliberately written to be long enough to exceed the limit",
+};
+
+#define NTEXTS ((int)(sizeof(texts) / sizeof(texts[0])))
+
+static SRTEntry *make_track(int n)
+{
+    SRTEntry *e = calloc((size_t)n, sizeof(*e));
+    unsigned seed = 7;
+    int64_t t = 0;
+    static char verbose[260];
+    memset(verbose, 'x', sizeof(verbose) - 1);
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = seed >> 8;
+        t += (int64_t)(r % 3000) - 200;             /* occasional overlap */
+        int64_t d = (int64_t)((r >> 12) % 12000) - 100; /* short, long, <= 0 */
+        e[i].start_ms = t;
+        e[i].end_ms = t + d;
+        e[i].text = (char *)((r >> 4) % 50 == 0 ? verbose : texts[(r >> 6) % NTEXTS]);
+    }
+    return e;
+}
+
+/* The parser's per-cue path. */
+static char *run_per_cue(const SRTEntry *e, int n, int *errors)
+{
+    FILE *out = tmpfile();
+    qc_reset_counts();
+    for (int i = 0; i < n; i++) {
+        SRTEntry tmp = e[i];
+        tmp.text = strip_tags(e[i].text);
+        qc_check_entry("t.srt", i, &tmp, i > 0 ? &e[i - 1] : NULL, out);
+        free(tmp.text);
+    }
+    *errors = qc_error_count;
+    long len = ftell(out);
+    char *s = calloc(1, (size_t)len + 1);
+    rewind(out);
+    assert(fread(s, 1, (size_t)len, out) == (size_t)len);
+    fclose(out);
+    return s;
+}
+
+static char *run_batch(const SRTEntry *e, int n, int threads, int *errors)
+{
+    FILE *out = tmpfile();
+    qc_reset_counts();
+    assert(qc_check_track("t.srt", e, n, out, threads) == 0);
+    *errors = qc_error_count;
+    long len = ftell(out);
+    char *s = calloc(1, (size_t)len + 1);
+    rewind(out);
+    assert(fread(s, 1, (size_t)len, out) == (size_t)len);
+    fclose(out);
+    return s;
+}
+
+int main(void)
+{
+    const int n = 20000;
+    SRTEntry *e = make_track(n);
+
+    int want_err = 0, err = 0;
+    char *want = run_per_cue(e, n, &want_err);
+    assert(strstr(want, "OVERLAP") && strstr(want, "control characters"));
+    assert(want_err > 0);
+
+    int thread_counts[] = { 1, 4, 13 };
+    for (size_t k = 0; k < sizeof(thread_counts) / sizeof(thread_counts[0]); k++) {
+        char *got = run_batch(e, n, thread_counts[k], &err);
+        assert(strcmp(got, want) == 0);
+        assert(err == want_err);
+        free(got);
+    }
+
+    /* A short track stays inline and still matches. */
+    free(want);
+    want = run_per_cue(e, 10, &want_err);
+    char *got = run_batch(e, 10, 8, &err);
+    assert(strcmp(got, want) == 0 && err == want_err);
+    free(got);
+    free(want);
+
+    assert(qc_check_track("t.srt", e, 0, NULL, 4) == 0);
+    free(e);
+    printf("test_qc_batch: all checks passed\n");
+    return 0;
+}
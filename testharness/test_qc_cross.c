@@ -0,0 +1,190 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_qc_cross.c
+ * Checks cross-track QC on generated tracks: a shifted translation gets
+ * its offset measured through cue-length jitter and a delay suggestion
+ * that cancels it, a track with a block of cues missing yields an
+ * unmatched region on the other side, a drifting track reports its
+ * drift instead of a delay, existing delays are applied before comparing, large shifts
+ * beyond the cue spacing are still found, and the results do not
+ * depend on the number of worker threads.
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_qc_cross.c src/qc_cross.c \
+ *        -lpthread -lm -o test_qc_cross
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "qc_cross.h"
+
+int debug_level = 0;
+
+#define CUES 600
+
+/* Reference rhythm: irregular gaps and durations. */
+static SRTEntry *make_track(int64_t shift, int skip_lo, int skip_hi,
+                            double drift, unsigned jitter_seed, int *count)
+{
+    SRTEntry *e = calloc(CUES, sizeof(*e));
+    unsigned seed = 12345, js = jitter_seed;
+    int64_t t = 5000;
+    int n = 0;
+    for (int i = 0; i < CUES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int64_t dur = 900 + (seed >> 8) % 3000;
+        int64_t gap = 300 + (seed >> 16) % 2500;
+        int64_t jit = 0;
+        if (jitter_seed) {
+            js = js * 1103515245u + 12345u;
+            jit = (int64_t)((js >> 8) % 121) - 60;
+        }
+        if (i < skip_lo || i > skip_hi) {
+            int64_t s = t + shift + jit + (int64_t)(drift * (double)t);
+            e[n].start_ms = s;
+            e[n].end_ms = s + dur;
+            e[n].text = "x";
+            n++;
+        }
+        t += dur + gap;
+    }
+    *count = n;
+    return e;
+}
+
+static const QCCrossPair *pair(const QCCrossResult *r, int a, int b)
+{
+    for (int k = 0; k < r->npairs; k++)
+        if (r->pairs[k].a == a && r->pairs[k].b == b)
+            return &r->pairs[k];
+    return NULL;
+}
+
+int main(void)
+{
+    QCCrossTrack tr[5] = {0};
+    SRTEntry *e[5];
+    int n[5];
+    e[0] = make_track(0, -1, -1, 0, 0, &n[0]);
+    e[1] = make_track(500, -1, -1, 0, 99, &n[1]);          /* late by 0.5 s */
+    e[2] = make_track(0, 100, 109, 0, 0, &n[2]);            /* 10 cues missing */
+    e[3] = make_track(0, -1, -1, 1.0 / 3600.0, 0, &n[3]);  /* +1 s per hour */
+    e[4] = make_track(7000, -1, -1, 0, 0, &n[4]);          /* 7 s late ... */
+    for (int t = 0; t < 5; t++) {
+        tr[t].name = "t";
+        tr[t].entries = e[t];
+        tr[t].count = n[t];
+    }
+    tr[4].delay_ms = -7000;                                 /* ... and delayed back */
+    tr[1].delay_ms = 120;
+
+    QCCrossResult r1, r4;
+    assert(qc_cross_analyze(tr, 5, 1, &r1) == 0);
+    assert(r1.npairs == 10);
+
+    const QCCrossPair *p01 = pair(&r1, 0, 1);
+    assert(p01->reliable && p01->matched == CUES);
+    assert(llabs(p01->offset_ms - 620) <= 20);
+    assert(p01->spread_ms > 0 && p01->spread_ms <= 60);
+    assert(r1.adjust[1] && llabs(r1.suggested_delay_ms[1] - (120 - 620)) <= 20);
+
+    const QCCrossPair *p02 = pair(&r1, 0, 2);
+    assert(p02->offset_ms == 0 && p02->matched == CUES - 10);
+    assert(p02->unmatched_a == 10 && p02->unmatched_b == 0);
+    assert(p02->nregions == 1);
+    assert(p02->regions[0].track == 0);
+    assert(p02->regions[0].first_cue == 100 && p02->regions[0].last_cue == 109);
+    assert(!r1.adjust[2] && r1.suggested_delay_ms[2] == 0);
+
+    const QCCrossPair *p03 = pair(&r1, 0, 3);
+    assert(p03->drift_ms_per_hour > 800 && p03->drift_ms_per_hour < 1200);
+    assert(p03->drifting && !r1.adjust[3]);
+    assert(!p01->drifting && !p02->drifting);
+
+    const QCCrossPair *p04 = pair(&r1, 0, 4);
+    assert(p04->offset_ms == 0 && p04->matched == CUES && !r1.adjust[4]);
+
+    /* Without its delay the 7 s shift (several cues) is still found. */
+    tr[4].delay_ms = 0;
+    QCCrossResult r2;
+    assert(qc_cross_analyze(tr, 5, 2, &r2) == 0);
+    assert(pair(&r2, 0, 4)->offset_ms == 7000 && r2.suggested_delay_ms[4] == -7000);
+    qc_cross_free(&r2);
+    tr[4].delay_ms = -7000;
+
+    assert(qc_cross_analyze(tr, 5, 4, &r4) == 0);
+    for (int k = 0; k < r1.npairs; k++) {
+        assert(r1.pairs[k].matched == r4.pairs[k].matched);
+        assert(r1.pairs[k].offset_ms == r4.pairs[k].offset_ms);
+        assert(r1.pairs[k].nregions == r4.pairs[k].nregions);
+    }
+
+    FILE *out = tmpfile();
+    qc_cross_print(&r1, tr, out);
+    long len = ftell(out);
+    char *s = calloc(1, (size_t)len + 1);
+    rewind(out);
+    assert(fread(s, 1, (size_t)len, out) == (size_t)len);
+    fclose(out);
+    assert(strstr(s, "cues 100-109"));
+    assert(strstr(s, "--delay 0,"));
+    free(s);
+
+    qc_cross_free(&r1);
+    qc_cross_free(&r4);
+    QCCrossResult none;
+    assert(qc_cross_analyze(tr, 1, 4, &none) == 0 && none.npairs == 0);
+    for (int t = 0; t < 5; t++)
+        free(e[t]);
+    printf("test_qc_cross: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,216 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * test_qc_report.c
+ * Checks the buffered QC report: with a report installed qc_check_entry()
+ * findings go to the report instead of the FILE*, the text format matches
+ * the per-finding lines written without one, CSV/JSONL/SARIF carry the
+ * check ids and timing, more findings than one block are all written,
+ * and the per-check counters feed the summary table.
+ *
+ * Build: gcc -std=gnu11 -Isrc testharness/test_qc_report.c src/qc.c \
+ *        src/qc_report.c -lpthread -o test_qc_report
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "qc.h"
+#include "qc_report.h"
+
+int debug_level = 0;
+int video_w = 1280;
+int video_h = 720;
+
+/* Read the whole stream back as a NUL-terminated string. */
+static char *slurp(FILE *f)
+{
+    fflush(f);
+    long n = ftell(f);
+    char *s = malloc((size_t)n + 1);
+    rewind(f);
+    size_t got = fread(s, 1, (size_t)n, f);
+    s[got] = '\0';
+    return s;
+}
+
+static int count_lines(const char *s)
+{
+    int n = 0;
+    for (; *s; s++)
+        if (*s == '\n')
+            n++;
+    return n;
+}
+
+/* A cue sequence that trips overlap, short, long and line-count checks. */
+static void run_checks(FILE *qc)
+{
+    SRTEntry a = { .start_ms = 1000, .end_ms = 3000, .text = "ok" };
+    SRTEntry b = { .start_ms = 2500, .end_ms = 2600, .text = "short and overlapping" };
+    SRTEntry c = { .start_ms = 4000, .end_ms = 20000, .text = "a\nb\nc\nd" };
+    qc_check_entry("in.srt", 0, &a, NULL, qc);
+    qc_check_entry("in.srt", 1, &b, &a, qc);
+    qc_check_entry("in.srt", 2, &c, &b, qc);
+}
+
+static char *run_format(QCReportFormat fmt, QCReport **keep)
+{
+    FILE *out = tmpfile();
+    QCReport *r = qc_report_create(fmt, out);
+    assert(r);
+    qc_set_report(r);
+    run_checks(NULL);
+    qc_set_report(NULL);
+    assert(qc_report_finish(r) == 0);
+    char *s = slurp(out);
+    fclose(out);
+    if (keep)
+        *keep = r;
+    else
+        qc_report_destroy(r);
+    return s;
+}
+
+static void test_text_matches_legacy(void)
+{
+    FILE *legacy = tmpfile();
+    run_checks(legacy);
+    char *want = slurp(legacy);
+    fclose(legacy);
+
+    QCReport *r = NULL;
+    char *got = run_format(QC_REPORT_TEXT, &r);
+    assert(strcmp(got, want) == 0);
+    assert(strstr(got, "in.srt: cue 1 OVERLAP:"));
+
+    assert(qc_report_count(r, QC_CHECK_OVERLAP) == 1);
+    assert(qc_report_count(r, QC_CHECK_SHORT) == 1);
+    assert(qc_report_count(r, QC_CHECK_LONG) == 1);
+    assert(qc_report_count(r, QC_CHECK_LINE_COUNT) == 1);
+    assert(qc_report_total(r) == count_lines(want));
+
+    FILE *sum = tmpfile();
+    qc_report_summary(r, sum);
+    char *table = slurp(sum);
+    fclose(sum);
+    assert(strstr(table, "overlap"));
+    assert(strstr(table, "TOTAL"));
+    free(table);
+
+    qc_report_destroy(r);
+    free(want);
+    free(got);
+}
+
+static void test_structured_formats(void)
+{
+    char *csv = run_format(QC_REPORT_CSV, NULL);
+    assert(strncmp(csv, "file,cue,severity,check,start_ms,end_ms,message\n", 48) == 0);
+    assert(strstr(csv, "in.srt,1,warn,overlap,2500,2600,"));
+    assert(strstr(csv, ",line_count,4000,20000,"));
+    free(csv);
+
+    char *jl = run_format(QC_REPORT_JSONL, NULL);
+    assert(strstr(jl, "\"check\":\"short_duration\""));
+    assert(strstr(jl, "\"start_ms\":2500"));
+    for (char *line = jl; *line; line = strchr(line, '\n') + 1)
+        assert(line[0] == '{');
+    free(jl);
+
+    char *sarif = run_format(QC_REPORT_SARIF, NULL);
+    assert(strstr(sarif, "\"version\":\"2.1.0\""));
+    assert(strstr(sarif, "\"ruleId\":\"long_duration\""));
+    size_t n = strlen(sarif);
+    while (n && sarif[n - 1] == '\n')
+        n--;
+    assert(n >= 4 && memcmp(sarif + n - 4, "]}]}", 4) == 0);
+    free(sarif);
+}
+
+/* More findings than one block: every record reaches the file once. */
+static void test_many_findings(void)
+{
+    FILE *out = tmpfile();
+    QCReport *r = qc_report_create(QC_REPORT_JSONL, out);
+    enum { N = 10000 };
+    for (int i = 0; i < N; i++) {
+        QCFinding f = { .file = (i & 1) ? "a.srt" : "b.srt", .cue = i,
+                        .check = QC_CHECK_EMPTY, .start_ms = i, .end_ms = i + 1 };
+        assert(qc_report_add(r, &f) == 0);
+    }
+    assert(qc_report_finish(r) == 0);
+    char *s = slurp(out);
+    assert(count_lines(s) == N);
+    assert(strstr(s, "\"cue\":9999"));
+    assert(qc_report_count(r, QC_CHECK_EMPTY) == N);
+    free(s);
+    fclose(out);
+    qc_report_destroy(r);
+}
+
+static void test_format_parse(void)
+{
+    QCReportFormat f;
+    assert(qc_report_format_parse("sarif", &f) == 0 && f == QC_REPORT_SARIF);
+    assert(qc_report_format_parse("csv", &f) == 0 && f == QC_REPORT_CSV);
+    assert(qc_report_format_parse("xml", &f) != 0);
+}
+
+int main(void)
+{
+    test_format_parse();
+    test_text_matches_legacy();
+    test_structured_formats();
+    test_many_findings();
+    printf("test_qc_report: all checks passed\n");
+    return 0;
+}
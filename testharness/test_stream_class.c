@@ -0,0 +1,102 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * Demux stream class checks. Build:
+ *   gcc -std=gnu11 -Isrc testharness/test_stream_class.c src/stream_class.c
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/stream_class.h"
+
+int main(void) {
+    StreamClass sc;
+
+    /* MPEG-TS: identity */
+    stream_class_init(&sc, STREAM_CLASS_CLOCK, 1, 90000);
+    assert(sc.kind == STREAM_CLASS_CLOCK && sc.mul90 == 1 && sc.div90 == 1);
+    assert(stream_class_to90(&sc, 8589934591LL) == 8589934591LL);
+    assert(stream_class_to90(&sc, STREAM_CLASS_NOPTS) == STREAM_CLASS_NOPTS);
+
+    /* Matroska milliseconds: one multiply */
+    stream_class_init(&sc, STREAM_CLASS_PASS, 1, 1000);
+    assert(sc.mul90 == 90 && sc.div90 == 1);
+    assert(stream_class_to90(&sc, -40) == -3600);
+
+    /* 48 kHz audio: 15/8, halves round away from zero like av_rescale_q */
+    stream_class_init(&sc, STREAM_CLASS_PASS, 1, 48000);
+    assert(sc.mul90 == 15 && sc.div90 == 8);
+    assert(stream_class_to90(&sc, 1024) == 1920);
+    assert(stream_class_to90(&sc, 4) == 8);     /* 7.5 -> 8 */
+    assert(stream_class_to90(&sc, -4) == -8);
+    assert(stream_class_to90(&sc, 3) == 6);     /* 5.625 -> 6 */
+    assert(stream_class_to90(&sc, 1) == 2);     /* 1.875 -> 2 */
+
+    /* NTSC frame time base 1001/60000 */
+    stream_class_init(&sc, STREAM_CLASS_CLOCK, 1001, 60000);
+    assert(sc.mul90 == 3003 && sc.div90 == 2);
+    assert(stream_class_to90(&sc, 2) == 3003);
+    assert(stream_class_to90(&sc, 1) == 1502);  /* 1501.5 -> 1502 */
+
+    /* large timestamps do not overflow the intermediate product */
+    stream_class_init(&sc, STREAM_CLASS_CLOCK, 1, 44100);
+    assert(stream_class_to90(&sc, 44100LL * 3600 * 1000) == 90000LL * 3600 * 1000);
+
+    /* a missing time base is treated as 90 kHz */
+    stream_class_init(&sc, STREAM_CLASS_DROP, 0, 0);
+    assert(sc.kind == STREAM_CLASS_DROP && sc.mul90 == 1 && sc.div90 == 1);
+
+    assert(strcmp(stream_class_name(STREAM_CLASS_PASS), "pass") == 0);
+    assert(strcmp(stream_class_name(7), "unknown") == 0);
+
+    printf("test_stream_class: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,318 @@
+/*
+* Copyright (c) 2025 Mark E. Rosche, Capsaworks Project
+* All rights reserved.
+*
+* PERSONAL USE LICENSE - NON-COMMERCIAL ONLY
+* ────────────────────────────────────────────────────────────────
+* This software is provided for personal, educational, and non-commercial
+* use only. You are granted permission to use, copy, and modify this
+* software for your own personal or educational purposes, provided that
+* this copyright and license notice appears in all copies or substantial
+* portions of the software.
+*
+* PERMITTED USES:
+*   ✓ Personal projects and experimentation
+*   ✓ Educational purposes and learning
+*   ✓ Non-commercial testing and evaluation
+*   ✓ Individual hobbyist use
+*
+* PROHIBITED USES:
+*   ✗ Commercial use of any kind
+*   ✗ Incorporation into products or services sold for profit
+*   ✗ Use within organizations or enterprises for revenue-generating activities
+*   ✗ Modification, redistribution, or hosting as part of any commercial offering
+*   ✗ Licensing, selling, or renting this software to others
+*   ✗ Using this software as a foundation for commercial services
+*
+* No commercial license is available. For inquiries regarding any use not
+* explicitly permitted above, contact:
+*   Mark E. Rosche, Capsaworks Project
+*   Email: license@capsaworks-project.de
+*   Website: www.capsaworks-project.de
+*
+* ────────────────────────────────────────────────────────────────
+* DISCLAIMER
+* ────────────────────────────────────────────────────────────────
+* THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+* ────────────────────────────────────────────────────────────────
+* By using this software, you agree to these terms and conditions.
+* ────────────────────────────────────────────────────────────────
+*/
+
+/*
+ * ts_sub_hash.c
+ * Bit-exactness check for --deterministic. Hashes the DVB subtitle PIDs
+ * of one or more MPEG-TS files and, given several, checks that all of
+ * them carry the same subtitle PIDs with identical payloads.
+ *
+ * Subtitle PIDs are taken from the PMT (stream_type 0x06 with a DVB
+ * subtitling descriptor, tag 0x59). The hash (FNV-1a, 64 bit) covers
+ * every TS payload byte of those PIDs in order, i.e. the complete PES
+ * packets including their PTS, so a moved cue is caught as well as a
+ * changed pixel. Continuity counters, PCR and all other PIDs are left
+ * out: they belong to the remux, not to the subtitle pipeline.
+ *
+ * Usage: ts_sub_hash FILE.ts [FILE.ts ...]
+ *   Prints one line per subtitle PID and file. Exit status 0 when all
+ *   files match (or only one was given), 1 on a mismatch, 2 on errors.
+ *   check_deterministic.sh drives it over --render-threads 0, 1 and N.
+ *
+ * Build: make ts_sub_hash (or gcc -std=gnu11 -O2 testharness/ts_sub_hash.c -o ts_sub_hash)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TS_PACKET 188
+#define TS_SYNC 0x47
+#define MAX_PIDS 32
+#define SECTION_MAX 4096
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+typedef struct {
+    int pid;
+    char lang[4];
+    int started;        /* first PES start seen; earlier bytes are skipped */
+    long pes;           /* PES packets */
+    long long bytes;    /* hashed payload bytes */
+    uint64_t hash;
+} SubPid;
+
+/* PSI section being reassembled on one PID. */
+typedef struct {
+    int pid;
+    uint8_t buf[SECTION_MAX];
+    int len;
+} Section;
+
+typedef struct {
+    Section psi[MAX_PIDS]; /* [0] is the PAT, the rest are PMTs */
+    int npsi;
+    SubPid subs[MAX_PIDS];
+    int nsubs;
+    long packets;
+} TsScan;
+
+static SubPid *find_sub(TsScan *s, int pid) {
+    for (int i = 0; i < s->nsubs; i++)
+        if (s->subs[i].pid == pid)
+            return &s->subs[i];
+    return NULL;
+}
+
+static Section *find_psi(TsScan *s, int pid) {
+    for (int i = 0; i < s->npsi; i++)
+        if (s->psi[i].pid == pid)
+            return &s->psi[i];
+    return NULL;
+}
+
+static void parse_pat(TsScan *s, const uint8_t *b, int total) {
+    for (int i = 8; i + 4 <= total - 4; i += 4) {
+        int program = (b[i] << 8) | b[i + 1];
+        int pid = ((b[i + 2] & 0x1f) << 8) | b[i + 3];
+        if (program == 0 || find_psi(s, pid) || s->npsi >= MAX_PIDS)
+            continue;
+        s->psi[s->npsi].pid = pid;
+        s->psi[s->npsi].len = 0;
+        s->npsi++;
+    }
+}
+
+static void parse_pmt(TsScan *s, const uint8_t *b, int total) {
+    if (total < 16)
+        return;
+    int i = 12 + (((b[10] & 0x0f) << 8) | b[11]);
+    while (i + 5 <= total - 4) {
+        int type = b[i];
+        int pid = ((b[i + 1] & 0x1f) << 8) | b[i + 2];
+        int info_len = ((b[i + 3] & 0x0f) << 8) | b[i + 4];
+        int d = i + 5, dend = d + info_len;
+        if (dend > total - 4)
+            break;
+        const uint8_t *sub_desc = NULL;
+        while (d + 2 <= dend && d + 2 + b[d + 1] <= dend) {
+            if (b[d] == 0x59 && b[d + 1] >= 3)
+                sub_desc = &b[d + 2];
+            d += 2 + b[d + 1];
+        }
+        if (type == 0x06 && sub_desc && !find_sub(s, pid) && s->nsubs < MAX_PIDS) {
+            SubPid *sp = &s->subs[s->nsubs++];
+            memset(sp, 0, sizeof(*sp));
+            sp->pid = pid;
+            for (int k = 0; k < 3; k++)
+                sp->lang[k] = (sub_desc[k] >= 0x20 && sub_desc[k] < 0x7f) ? (char)sub_desc[k] : '?';
+            sp->hash = FNV_OFFSET;
+        }
+        i = dend;
+    }
+}
+
+/* Append TS payload to a PSI section; parse it once complete. */
+static void feed_psi(TsScan *s, Section *sec, int pusi, const uint8_t *p, int n) {
+    if (pusi) {
+        int ptr = p[0];
+        if (1 + ptr >= n)
+            return;
+        p += 1 + ptr;
+        n -= 1 + ptr;
+        sec->len = 0;
+    } else if (sec->len == 0) {
+        return; /* continuation of a section we did not see start */
+    }
+    if (sec->len + n > SECTION_MAX)
+        n = SECTION_MAX - sec->len;
+    memcpy(sec->buf + sec->len, p, (size_t)n);
+    sec->len += n;
+    if (sec->len < 3)
+        return;
+    int total = 3 + (((sec->buf[1] & 0x0f) << 8) | sec->buf[2]);
+    if (sec->len < total)
+        return;
+    if (sec->buf[0] == 0x00)
+        parse_pat(s, sec->buf, total);
+    else if (sec->buf[0] == 0x02)
+        parse_pmt(s, sec->buf, total);
+    sec->len = 0;
+}
+
+static void feed_packet(TsScan *s, const uint8_t *p) {
+    int pid = ((p[1] & 0x1f) << 8) | p[2];
+    int pusi = (p[1] & 0x40) != 0;
+    int afc = (p[3] >> 4) & 3;
+    int off = 4;
+    s->packets++;
+    if (!(afc & 1))
+        return;
+    if (afc & 2)
+        off += 1 + p[4];
+    if (off >= TS_PACKET)
+        return;
+
+    SubPid *sp = find_sub(s, pid);
+    if (sp) {
+        if (pusi) {
+            sp->started = 1;
+            sp->pes++;
+        }
+        if (!sp->started)
+            return;
+        uint64_t h = sp->hash;
+        for (int i = off; i < TS_PACKET; i++) {
+            h ^= p[i];
+            h *= FNV_PRIME;
+        }
+        sp->hash = h;
+        sp->bytes += TS_PACKET - off;
+        return;
+    }
+    Section *sec = find_psi(s, pid);
+    if (sec)
+        feed_psi(s, sec, pusi, p + off, TS_PACKET - off);
+}
+
+/* Scan one file; resynchronises on the 0x47 sync byte if needed. */
+static int scan_file(const char *path, TsScan *s) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    memset(s, 0, sizeof(*s));
+    s->psi[0].pid = 0;
+    s->npsi = 1;
+
+    uint8_t pkt[TS_PACKET];
+    size_t have = 0;
+    long resyncs = 0;
+    for (;;) {
+        size_t got = fread(pkt + have, 1, TS_PACKET - have, f);
+        have += got;
+        if (have < TS_PACKET)
+            break;
+        if (pkt[0] != TS_SYNC) {
+            memmove(pkt, pkt + 1, TS_PACKET - 1);
+            have = TS_PACKET - 1;
+            resyncs++;
+            continue;
+        }
+        feed_packet(s, pkt);
+        have = 0;
+    }
+    int err = ferror(f);
+    fclose(f);
+    if (err) {
+        fprintf(stderr, "%s: read error\n", path);
+        return -1;
+    }
+    if (resyncs)
+        fprintf(stderr, "%s: skipped %ld bytes to regain sync\n", path, resyncs);
+    if (s->nsubs == 0) {
+        fprintf(stderr, "%s: no DVB subtitle PIDs found\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static void print_scan(const char *path, const TsScan *s) {
+    for (int i = 0; i < s->nsubs; i++) {
+        const SubPid *sp = &s->subs[i];
+        printf("%s: pid 0x%04x (%s) %ld PES %lld bytes fnv1a64 %016llx\n",
+               path, sp->pid, sp->lang, sp->pes, sp->bytes, (unsigned long long)sp->hash);
+    }
+}
+
+/* 0 when both scans carry the same subtitle PIDs with the same bytes. */
+static int compare_scans(const char *pa, const TsScan *a, const char *pb, const TsScan *b) {
+    int diff = 0;
+    if (a->nsubs != b->nsubs) {
+        printf("MISMATCH: %s has %d subtitle PIDs, %s has %d\n", pb, b->nsubs, pa, a->nsubs);
+        return 1;
+    }
+    for (int i = 0; i < a->nsubs; i++) {
+        const SubPid *x = &a->subs[i], *y = &b->subs[i];
+        if (x->pid != y->pid || x->hash != y->hash || x->pes != y->pes || x->bytes != y->bytes) {
+            printf("MISMATCH: %s pid 0x%04x differs from %s pid 0x%04x\n", pb, y->pid, pa, x->pid);
+            diff = 1;
+        }
+    }
+    return diff;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s FILE.ts [FILE.ts ...]\n", argv[0]);
+        return 2;
+    }
+    TsScan *scans = calloc((size_t)(argc - 1), sizeof(TsScan));
+    if (!scans) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    int status = 0;
+    for (int i = 1; i < argc; i++) {
+        if (scan_file(argv[i], &scans[i - 1]) != 0) {
+            free(scans);
+            return 2;
+        }
+        print_scan(argv[i], &scans[i - 1]);
+    }
+    for (int i = 2; i < argc; i++)
+        if (compare_scans(argv[1], &scans[0], argv[i], &scans[i - 1]))
+            status = 1;
+    if (argc > 2 && status == 0)
+        printf("ts_sub_hash: %d files identical\n", argc - 1);
+    free(scans);
+    return status;
+}